@@ -0,0 +1,58 @@
+#pragma once
+/**
+ * @file AtomicSharedPtr.h
+ * @brief Atomically published std::shared_ptr for read-mostly (RCU-style) tables.
+ *
+ * Writers build a new immutable object and store() it; readers load() a
+ * snapshot and keep using it for as long as they hold the shared_ptr, even
+ * if a writer publishes a replacement in the meantime.
+ *
+ * Uses std::atomic<std::shared_ptr<T>> where the standard library provides
+ * it (MSVC, libstdc++ 12+). Elsewhere (libc++) the pointer copy is guarded by
+ * a mutex that is held only for the copy itself, never while the snapshot
+ * is in use.
+ */
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace CANManager {
+
+template <typename T>
+class AtomicSharedPtr
+{
+public:
+    AtomicSharedPtr() = default;
+    explicit AtomicSharedPtr(std::shared_ptr<T> initial) { store(std::move(initial)); }
+
+    AtomicSharedPtr(const AtomicSharedPtr&) = delete;
+    AtomicSharedPtr& operator=(const AtomicSharedPtr&) = delete;
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::shared_ptr<T> load() const { return m_ptr.load(std::memory_order_acquire); }
+    void store(std::shared_ptr<T> ptr) { m_ptr.store(std::move(ptr), std::memory_order_release); }
+
+private:
+    std::atomic<std::shared_ptr<T>> m_ptr;
+#else
+    std::shared_ptr<T> load() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_ptr;
+    }
+
+    void store(std::shared_ptr<T> ptr)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ptr.swap(ptr);
+        // The previous object (now in ptr) is released after the lock is dropped
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::shared_ptr<T> m_ptr;
+#endif
+};
+
+} // namespace CANManager
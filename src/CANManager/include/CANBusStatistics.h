@@ -0,0 +1,182 @@
+#pragma once
+/**
+ * @file CANBusStatistics.h
+ * @brief Live traffic counters and bus load of one CAN slot.
+ *
+ * CANBusManager keeps one instance per open slot. The RX dispatcher thread
+ * counts every received batch, the TX paths (transmit, cyclic scheduler,
+ * replay) count every frame the driver accepted. Counters are relaxed
+ * atomics and per-ID counts live in a fixed open-addressing table, so
+ * neither path takes a lock.
+ *
+ * Bus load is the wire time of the counted frames (CANManager::frameDurationNs(),
+ * worst-case stuffing, CAN FD data phase at the data bit rate) over elapsed
+ * time. Own frames are counted once, when the driver accepts them; TX
+ * confirmations are only counted against the requests.
+ *
+ * The dispatcher thread calls sampleIfDue() after every driver read (at
+ * least every CANRxDispatcher::POLL_INTERVAL_MS), which turns the counter
+ * deltas into a Sample of per-second rates and keeps the last
+ * HISTORY_SIZE samples for the statistics panel.
+ */
+
+#include "CANInterface.h"
+
+#include <QList>
+#include <QMutex>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace CANManager {
+
+class CANBusStatistics
+{
+public:
+    /// Distinct CAN IDs counted per slot (IDs beyond that are summed as untracked)
+    static constexpr int ID_TABLE_SIZE = 4096;
+
+    /// Sample period
+    static constexpr int SAMPLE_INTERVAL_MS = 250;
+
+    /// Samples kept (one minute)
+    static constexpr int HISTORY_SIZE = 240;
+
+    /** @brief Rates over one sample period. */
+    struct Sample
+    {
+        double timeS              = 0.0;    ///< End of the period, seconds since open / reset
+        double rxFramesPerSecond  = 0.0;    ///< Frames from other nodes
+        double txFramesPerSecond  = 0.0;    ///< Own frames accepted by the driver
+        double bytesPerSecond     = 0.0;    ///< Payload bytes, both directions
+        double errorFramesPerSecond = 0.0;
+        double busLoadPercent     = 0.0;
+    };
+
+    /** @brief Traffic of one CAN ID. */
+    struct IdStats
+    {
+        uint32_t id       = 0;
+        bool     extended = false;
+        uint64_t frames   = 0;              ///< Received and transmitted since open / reset
+        double   framesPerSecond = 0.0;     ///< Over the last sample period
+    };
+
+    /** @brief Counters since open / reset plus the latest sample. */
+    struct Snapshot
+    {
+        int      bitrate     = 0;
+        int      dataBitrate = 0;
+        double   elapsedS    = 0.0;
+
+        uint64_t rxFrames        = 0;       ///< Data and remote frames from other nodes
+        uint64_t rxBytes         = 0;
+        uint64_t txRequests      = 0;       ///< Frames accepted by the driver
+        uint64_t txBytes         = 0;
+        uint64_t txRejected      = 0;       ///< Frames the driver refused
+        uint64_t txConfirmations = 0;       ///< Echoes of own frames seen on the bus
+        uint64_t errorFrames     = 0;
+        uint64_t untrackedFrames = 0;       ///< Frames of IDs beyond ID_TABLE_SIZE
+
+        Sample   current;                   ///< Latest sample period
+        double   meanBusLoadPercent = 0.0;  ///< Over elapsedS
+        double   peakBusLoadPercent = 0.0;  ///< Highest sample since open / reset
+
+        int      rxBatchHighWater   = 0;    ///< Most frames returned by one driver read
+        size_t   rxQueueHighWater   = 0;    ///< Slot receive queue (CANBusManager::receive())
+        size_t   subscriptionHighWater = 0; ///< Fullest subscription queue
+
+        QList<IdStats> ids;                 ///< Busiest first
+    };
+
+    CANBusStatistics(int bitrate, int dataBitrate);
+
+    CANBusStatistics(const CANBusStatistics&) = delete;
+    CANBusStatistics& operator=(const CANBusStatistics&) = delete;
+
+    // === Counting (lock-free) ===
+
+    /** @brief Count a batch read from the driver (dispatcher thread). */
+    void onReceived(const CANMessage* frames, int count);
+
+    /** @brief Count frames handed to the driver; the first accepted were sent. */
+    void onTransmitted(const CANMessage* frames, int count, int accepted);
+
+    /** @brief Raise the queue high-water marks (dispatcher thread). */
+    void updateQueueHighWater(size_t rxQueue, size_t subscription);
+
+    // === Sampling ===
+
+    /** @brief Close the sample period if it has ended (dispatcher thread). */
+    void sampleIfDue();
+
+    /** @brief Counters, latest rates and per-ID traffic. */
+    Snapshot snapshot() const;
+
+    /** @brief The last HISTORY_SIZE samples, oldest first. */
+    QList<Sample> history() const;
+
+    /** @brief Zero all counters, peaks and the history. */
+    void reset();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct IdCounter
+    {
+        std::atomic<uint32_t> key{0};       ///< 0 = free, else keyOf()
+        std::atomic<uint64_t> frames{0};
+        uint64_t lastFrames = 0;            ///< At the previous sample (m_sampleMutex)
+        double   framesPerSecond = 0.0;     ///< m_sampleMutex
+    };
+
+    /// Counter values a sample is computed from
+    struct Totals
+    {
+        uint64_t rxFrames = 0;
+        uint64_t txFrames = 0;
+        uint64_t bytes = 0;
+        uint64_t errorFrames = 0;
+        uint64_t busTimeNs = 0;
+    };
+
+    static uint32_t keyOf(uint32_t id, bool extended);
+    IdCounter* counterFor(uint32_t id, bool extended);
+    void countFrame(const CANMessage& msg);
+    Totals totals() const;
+    static void raise(std::atomic<uint64_t>& highWater, uint64_t value);
+
+    const int m_bitrate;
+    const int m_dataBitrate;
+
+    // Written by the RX and TX paths
+    std::atomic<uint64_t> m_rxFrames{0};
+    std::atomic<uint64_t> m_rxBytes{0};
+    std::atomic<uint64_t> m_txRequests{0};
+    std::atomic<uint64_t> m_txBytes{0};
+    std::atomic<uint64_t> m_txRejected{0};
+    std::atomic<uint64_t> m_txConfirmations{0};
+    std::atomic<uint64_t> m_errorFrames{0};
+    std::atomic<uint64_t> m_untrackedFrames{0};
+    std::atomic<uint64_t> m_busTimeNs{0};
+    std::atomic<uint64_t> m_rxBatchHighWater{0};
+    std::atomic<uint64_t> m_rxQueueHighWater{0};
+    std::atomic<uint64_t> m_subscriptionHighWater{0};
+    std::unique_ptr<IdCounter[]> m_ids;
+
+    // Sampling state
+    mutable QMutex    m_sampleMutex;        ///< Guards everything below
+    Clock::time_point m_start;
+    Clock::time_point m_lastSampleTime;
+    std::atomic<int64_t> m_nextSampleNs{0}; ///< Lets sampleIfDue() skip the lock
+    Totals            m_lastTotals;
+    double            m_peakBusLoad = 0.0;
+    Sample            m_current;
+    std::vector<Sample> m_history;          ///< Ring of HISTORY_SIZE
+    int               m_historyNext  = 0;
+    int               m_historyCount = 0;
+};
+
+} // namespace CANManager
@@ -0,0 +1,174 @@
+#pragma once
+/**
+ * @file CANCyclicScheduler.h
+ * @brief Per-slot scheduler for periodic CAN frames (keep-alives, rest-bus).
+ *
+ * Each frame is identified by its CAN ID and format and repeats with a
+ * period of whole milliseconds. Deadlines are kept on an absolute clock
+ * (tick N is due at epoch + N ms), so a late wake-up never shifts later
+ * cycles; if the thread falls more than a period behind, the missed cycles
+ * are skipped and counted instead of being sent in a burst.
+ *
+ * Jobs sit in a hashed timer wheel of 1 ms buckets. The scheduler thread
+ * sleeps until the next non-empty bucket, collects every frame due in it
+ * and sends them with one ICANDriver::transmitBatch() call under the
+ * slot's TX lock. Payload updates replace the whole frame under the
+ * scheduler lock, so a cycle always sends either the old or the new
+ * payload, never a mix.
+ */
+
+#include "CANBusStatistics.h"
+#include "CANInterface.h"
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace CANManager {
+
+class CANCyclicScheduler
+{
+public:
+    /// Wheel resolution; periods are whole multiples of it
+    static constexpr std::chrono::nanoseconds TICK{std::chrono::milliseconds(1)};
+
+    /// Wheel buckets (power of two); longer periods wrap around the wheel
+    static constexpr int WHEEL_SIZE = 512;
+
+    /**
+     * @brief Achieved timing of one cyclic frame.
+     *
+     * Period statistics are measured between consecutive successful
+     * transmissions (taken just before the driver call); jitter is the
+     * achieved period minus the nominal one.
+     */
+    struct Stats
+    {
+        int      periodMs      = 0;     ///< Nominal period
+        uint64_t sent          = 0;     ///< Frames accepted by the driver
+        uint64_t missed        = 0;     ///< Cycles skipped because the scheduler was late
+        uint64_t errors        = 0;     ///< Cycles the driver rejected
+        double   minPeriodUs   = 0.0;
+        double   maxPeriodUs   = 0.0;
+        double   meanPeriodUs  = 0.0;
+        double   jitterStdDevUs = 0.0;  ///< Standard deviation of the achieved period
+        double   maxAbsJitterUs = 0.0;  ///< Largest |achieved - nominal| period
+        double   maxLatenessUs  = 0.0;  ///< Largest delay of a send after its deadline
+        QString  lastError;             ///< Last driver error, empty if none
+    };
+
+    /** @param statistics Counts the sent frames (optional, must outlive the scheduler) */
+    CANCyclicScheduler(ICANDriver* driver, QMutex* txMutex, const QString& slotName,
+                       CANBusStatistics* statistics = nullptr);
+    ~CANCyclicScheduler();
+
+    CANCyclicScheduler(const CANCyclicScheduler&) = delete;
+    CANCyclicScheduler& operator=(const CANCyclicScheduler&) = delete;
+
+    /**
+     * @brief Start sending msg every periodMs milliseconds, first on the next
+     *        tick plus offsetMs.
+     *
+     * A frame with the same ID and format that is already running is
+     * replaced (new payload and period, statistics reset). Offsets spread
+     * frames of equal period over the wheel instead of sending them all
+     * in the same tick.
+     */
+    CANResult start(const CANMessage& msg, int periodMs, int offsetMs = 0);
+
+    /** @brief Replace the payload (and flags) of the running frame with msg's ID. */
+    CANResult update(const CANMessage& msg);
+
+    /**
+     * @brief Stop one frame; its final statistics are returned in stats if given.
+     *
+     * Waits for a batch already handed to the driver, so nothing is sent
+     * after stop() returns.
+     */
+    CANResult stop(uint32_t id, bool extended, Stats* stats = nullptr);
+
+    /** @brief Stop all frames (waits like stop()). */
+    void stopAll();
+
+    /** @brief Current statistics of a running frame. Returns false if it is not running. */
+    bool stats(uint32_t id, bool extended, Stats& stats) const;
+
+    /** @brief Number of running frames. */
+    int count() const;
+
+    /**
+     * @brief Stop all frames and the scheduler thread.
+     *
+     * Called before the slot's driver is closed; afterwards start() fails.
+     */
+    void shutdown();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job
+    {
+        CANMessage msg;
+        int64_t    periodTicks = 1;
+        int64_t    nextTick    = 0;     ///< Absolute tick of the next cycle
+        uint64_t   generation  = 0;     ///< Changes on restart; drops stale send results
+        Clock::time_point lastSend{};   ///< Previous successful send, epoch if none
+
+        Stats      stats;
+        double     jitterSumUs   = 0.0; ///< Running sums of (period - nominal)
+        double     jitterSqSumUs = 0.0;
+        uint64_t   periodCount   = 0;   ///< Periods measured
+    };
+
+    /// A frame taken off the wheel for the current batch
+    struct Due
+    {
+        uint64_t key;
+        uint64_t generation;
+        int64_t  tick;
+    };
+
+    static uint64_t keyOf(uint32_t id, bool extended)
+    {
+        return (static_cast<uint64_t>(extended) << 32) | id;
+    }
+
+    void run();
+    int64_t tickNow() const;
+    Clock::time_point tickTime(int64_t tick) const;
+
+    // Wheel maintenance (m_mutex held)
+    void    insertLocked(Job* job);
+    void    eraseLocked(Job* job);
+    int64_t nextDueTickLocked() const;
+    void    collectDueLocked(int64_t upToTick, std::vector<Due>& due,
+                             std::vector<CANMessage>& frames);
+    void    waitUntilIdleLocked();
+    void    recordLocked(const std::vector<Due>& due, int sent,
+                         Clock::time_point sendTime, const QString& error);
+    static void finishStats(const Job& job, Stats& stats);
+
+    ICANDriver* m_driver;
+    QMutex*     m_txMutex;          ///< The slot's TX lock, shared with CANBusManager::transmit()
+    CANBusStatistics* m_statistics;
+    QString     m_slotName;
+    const Clock::time_point m_epoch = Clock::now();
+
+    mutable QMutex m_mutex;         ///< Guards everything below
+    QWaitCondition m_wake;          ///< Jobs changed or shutdown requested
+    QWaitCondition m_idle;          ///< A batch finished transmitting
+    bool     m_sending    = false;  ///< Thread is in transmitBatch() without m_mutex
+    std::map<uint64_t, std::unique_ptr<Job>> m_jobs;
+    std::vector<std::vector<Job*>> m_wheel;
+    int64_t  m_lastTick   = 0;      ///< Last tick already processed
+    uint64_t m_generation = 0;
+    bool     m_stopping   = false;
+    QThread* m_thread     = nullptr;
+};
+
+} // namespace CANManager
@@ -0,0 +1,241 @@
+#pragma once
+/**
+ * @file CANGateway.h
+ * @brief One-way CAN gateway: forwards one slot's traffic to another slot
+ *        through a rule table (block, delay, rewrite ID and payload).
+ *
+ * The gateway reads the source slot through its own subscription on its
+ * own thread and forwards with ICANDriver::transmitBatch() on the
+ * destination, one call per received batch. Run two gateways for both
+ * directions; frames a gateway sends only come back as TX confirmations,
+ * which are never forwarded, so gateways cannot loop.
+ *
+ * Rules are checked in order, the first match wins. start() compiles the
+ * list into lookup tables — a 2048-entry table for standard IDs, a hash of
+ * exact extended IDs, and the remaining mask rules for other extended IDs —
+ * so the per-frame cost does not grow with the number of exact-ID rules.
+ *
+ * Rewriting:
+ *   - ID: the frame is forwarded with Rule::newId. The format is kept, so
+ *     start() rejects a newId above 0x7FF on a rule that matches standard
+ *     frames; restrict such a rule to extended frames (CANIdFilter::extended).
+ *   - Payload: bits set in Rule::dataMask are replaced by Rule::dataValue,
+ *     which is how a DBC signal is overwritten (see Rule::signalValues).
+ *
+ * Delayed frames are held in a queue ordered by due time and released by
+ * the gateway thread with millisecond resolution.
+ *
+ * Rule files are JSON:
+ * @code
+ * {
+ *   "default": "forward",
+ *   "rules": [
+ *     { "name": "kill NM", "id": "0x500", "mask": "0x700", "action": "block" },
+ *     { "id": "0x1A0", "delay_ms": 20 },
+ *     { "id": "0x3E9", "new_id": "0x3EA", "data": "00 80", "data_mask": "00 FF" },
+ *     { "id": "0x120", "signals": { "VehicleSpeed": 0 } }
+ *   ]
+ * }
+ * @endcode
+ */
+
+#include "CANInterface.h"
+#include "CANRxDispatcher.h"
+
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QThread>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace CANManager {
+
+class CANGateway
+{
+public:
+    /// Source subscription depth (frames)
+    static constexpr size_t QUEUE_CAPACITY = 8192;
+
+    /// Frames taken from the source and forwarded per pass
+    static constexpr int MAX_BATCH = 64;
+
+    /// Frames held for delay rules; further delayed frames are dropped
+    static constexpr size_t MAX_DELAYED = 4096;
+
+    /// Longest wait for source frames; bounds how long stop() takes
+    static constexpr int POLL_INTERVAL_MS = 100;
+
+    enum class Action { Forward, Block };
+
+    struct Rule
+    {
+        QString     name;                   ///< For statistics and logs (default: the ID filter)
+        CANIdFilter match;
+        Action      action  = Action::Forward;
+        int         delayUs = 0;            ///< Hold forwarded frames this long
+        bool        rewriteId = false;
+        uint32_t    newId     = 0;          ///< Forwarded ID if rewriteId (format kept)
+        QByteArray  dataMask;               ///< Payload bits to replace (empty = payload unchanged)
+        QByteArray  dataValue;              ///< Replacement bits, same length as dataMask
+
+        /// Signal name → physical value to write. Resolved into dataMask /
+        /// dataValue by the caller (needs the DBC); start() rejects leftovers.
+        QMap<QString, double> signalValues;
+    };
+
+    struct Options
+    {
+        QString     source;                 ///< Slot read
+        QString     destination;            ///< Slot written
+        QList<Rule> rules;                  ///< First match wins
+        Action      defaultAction = Action::Forward;    ///< Frames no rule matches
+    };
+
+    struct RuleStats
+    {
+        QString  name;
+        uint64_t matched   = 0;
+        uint64_t forwarded = 0;             ///< Accepted by the destination driver
+        uint64_t dropped   = 0;             ///< Blocked, delay queue full or rejected by the driver
+    };
+
+    struct Stats
+    {
+        bool     running   = false;         ///< False once stopped or the source slot closed
+        QString  source;
+        QString  destination;
+        uint64_t received  = 0;             ///< Data and remote frames read from the source
+        uint64_t forwarded = 0;             ///< Accepted by the destination driver
+        uint64_t blocked   = 0;
+        uint64_t delayed   = 0;             ///< Held by a delay rule (forwarded or dropped later)
+        uint64_t txErrors  = 0;             ///< Rejected by the destination driver
+        uint64_t delayOverflows = 0;        ///< Dropped because MAX_DELAYED frames were held
+        uint64_t overruns  = 0;             ///< Source subscription overruns (gateway too slow)
+        double   meanLatencyUs = 0.0;       ///< Frame read by the source dispatcher → transmit returned
+        double   maxLatencyUs  = 0.0;       ///< (undelayed frames)
+        QList<RuleStats> rules;             ///< In rule order
+        RuleStats defaultRule;              ///< Frames no rule matched
+        QString  lastError;                 ///< Last destination error, empty if none
+    };
+
+    /// Sends a batch on the destination; reports the accepted leading frames in sent
+    using Transmit = std::function<CANResult(std::span<const CANMessage> msgs, int& sent)>;
+
+    /**
+     * @param source   Subscription on the source slot (CANIdFilter::all())
+     * @param transmit Destination TX path
+     */
+    CANGateway(const Options& options, std::shared_ptr<CANRxDispatcher::Subscription> source,
+               Transmit transmit);
+    ~CANGateway();
+
+    CANGateway(const CANGateway&) = delete;
+    CANGateway& operator=(const CANGateway&) = delete;
+
+    /** @brief Compile the rules and start forwarding. Fails on invalid rules. */
+    CANResult start();
+
+    /**
+     * @brief Stop forwarding and join the gateway thread; held frames are discarded.
+     *
+     * Close or unsubscribe the source subscription first to return at once,
+     * otherwise this takes up to POLL_INTERVAL_MS.
+     */
+    void stop();
+
+    Stats stats() const;
+
+    // === Rule files ===
+
+    /**
+     * @brief Parse a JSON rule set (see the file comment) into options.
+     *
+     * Sets options.rules and options.defaultAction; "source" and
+     * "destination" keys, if present, set the slots.
+     */
+    static CANResult parseRules(const QByteArray& json, Options& options);
+
+    /** @brief Read and parse a JSON rule file. */
+    static CANResult loadRules(const QString& path, Options& options);
+
+private:
+    using Clock = CANRxDispatcher::Clock;
+
+    /// Rule as applied per frame
+    struct CompiledRule
+    {
+        Action   action;
+        std::chrono::microseconds delay;
+        bool     rewriteId;
+        uint32_t newId;
+        int      rewriteLength;             ///< Payload bytes covered by mask / value
+        uint8_t  mask[64];
+        uint8_t  value[64];
+    };
+
+    /// Per-rule counters (written by the gateway thread only)
+    struct RuleCounters
+    {
+        std::atomic<uint64_t> matched{0};
+        std::atomic<uint64_t> forwarded{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    struct Delayed
+    {
+        Clock::time_point due;
+        uint64_t   sequence;                ///< Keeps equal due times in arrival order
+        int        rule;
+        CANMessage msg;
+
+        bool operator>(const Delayed& other) const
+        {
+            return due != other.due ? due > other.due : sequence > other.sequence;
+        }
+    };
+
+    CANResult compile();
+    int ruleFor(const CANMessage& msg) const;
+    void run();
+    void send(std::vector<CANMessage>& frames, std::vector<int>& rules,
+              const std::vector<Clock::time_point>& arrivals, size_t undelayedFrom);
+    RuleCounters& countersFor(int rule);
+
+    Options  m_options;
+    std::shared_ptr<CANRxDispatcher::Subscription> m_source;
+    Transmit m_transmit;
+
+    // Compiled rule table; written by start() before the thread runs
+    std::vector<CompiledRule> m_rules;                  ///< Index = position in m_options.rules
+    std::vector<int>          m_standard;               ///< Rule per 11-bit ID, -1 = default
+    std::unordered_map<uint32_t, int> m_extended;       ///< Rule per exact 29-bit ID
+    std::vector<int>          m_extendedMasked;         ///< Rules that may match other 29-bit IDs
+
+    QThread* m_thread = nullptr;
+    std::atomic<bool> m_stopping{false};
+    std::atomic<bool> m_running{false};
+
+    // Counters (gateway thread writes, stats() reads)
+    std::unique_ptr<RuleCounters[]> m_ruleCounters;     ///< One per rule plus the default
+    std::atomic<uint64_t> m_received{0};
+    std::atomic<uint64_t> m_forwarded{0};
+    std::atomic<uint64_t> m_blocked{0};
+    std::atomic<uint64_t> m_delayed{0};
+    std::atomic<uint64_t> m_txErrors{0};
+    std::atomic<uint64_t> m_delayOverflows{0};
+    std::atomic<uint64_t> m_latencySumNs{0};
+    std::atomic<uint64_t> m_latencyCount{0};
+    std::atomic<uint64_t> m_latencyMaxNs{0};
+
+    mutable QMutex m_errorMutex;
+    QString m_lastError;
+};
+
+} // namespace CANManager
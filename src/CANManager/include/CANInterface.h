@@ -11,6 +11,7 @@
 #include <QString>
 #include <QList>
 #include <cstdint>
+#include <span>
 
 namespace CANManager {
 
@@ -69,6 +70,119 @@ struct CANMessage
     int dataLength() const { return isFD ? dlcToLength(dlc) : qMin((int)dlc, 8); }
 };
 
+// ============================================================================
+//  Frame Timing
+// ============================================================================
+
+/// Bits of error flag + error delimiter + intermission that follow a destroyed frame
+inline constexpr int ERROR_FRAME_BITS = 6 + 8 + 3;
+
+/**
+ * @brief Duration of a frame on the wire in nanoseconds.
+ *
+ * Uses worst-case bit stuffing (one stuff bit per four bits of the stuffed
+ * fields; fixed stuff bits in the CAN FD CRC field). CAN FD frames with BRS
+ * transmit the data phase at dataBitrate.
+ */
+inline uint64_t frameDurationNs(const CANMessage& msg, int bitrate, int dataBitrate)
+{
+    if (bitrate <= 0)
+        return 0;
+
+    const int n = msg.isRemote ? 0 : msg.dataLength();
+
+    // CRC delimiter + ACK slot/delimiter + EOF + intermission (never stuffed)
+    constexpr int TRAILER_BITS = 1 + 2 + 7 + 3;
+
+    if (!msg.isFD) {
+        // SOF .. end of CRC: 34 (standard) / 54 (extended) control bits + data
+        const int stuffable = (msg.isExtended ? 54 : 34) + 8 * n;
+        const int bits = stuffable + (stuffable - 1) / 4 + TRAILER_BITS;
+        return static_cast<uint64_t>(bits) * 1000000000ULL / static_cast<uint64_t>(bitrate);
+    }
+
+    // Arbitration phase (SOF .. BRS) runs at the nominal rate
+    const int arbBits = msg.isExtended ? 36 : 17;
+    const int nominalBits = arbBits + (arbBits - 1) / 4 + TRAILER_BITS;
+
+    // Data phase: ESI + DLC + data (dynamic stuffing), stuff count + CRC (fixed stuffing)
+    const int crcBits = (n > 16) ? 21 : 17;
+    const int fieldBits = 1 + 4 + 8 * n;
+    const int dataPhaseBits = fieldBits + fieldBits / 4
+                            + 4 + crcBits + (4 + crcBits + 3) / 4;
+
+    const int dataRate = (msg.isBRS && dataBitrate > 0) ? dataBitrate : bitrate;
+    return static_cast<uint64_t>(nominalBits) * 1000000000ULL / static_cast<uint64_t>(bitrate)
+         + static_cast<uint64_t>(dataPhaseBits) * 1000000000ULL / static_cast<uint64_t>(dataRate);
+}
+
+// ============================================================================
+//  CAN ID Filter
+// ============================================================================
+
+/**
+ * @brief Matches received data frames by identifier and mask.
+ *
+ * A frame matches when (frame.id & mask) == (id & mask). Error frames and
+ * TX confirmations never match. By default both 11-bit and 29-bit frames
+ * are accepted; set anyFormat=false to require the given extended flag.
+ */
+struct CANIdFilter
+{
+    uint32_t id        = 0;
+    uint32_t mask      = 0x1FFFFFFF;   ///< All 29 ID bits significant
+    bool     anyFormat = true;         ///< Ignore the standard/extended flag
+    bool     extended  = false;        ///< Required format when !anyFormat
+
+    bool matches(const CANMessage& msg) const
+    {
+        if (msg.isError || msg.isTxConfirm)
+            return false;
+        return matchesId(msg.id, msg.isExtended);
+    }
+
+    /** Identifier and format check only (frame type is not considered). */
+    bool matchesId(uint32_t frameId, bool frameExtended) const
+    {
+        if (!anyFormat && frameExtended != extended)
+            return false;
+        return (frameId & mask) == (id & mask);
+    }
+
+    /** Human-readable form for log and error messages ("0x7e8", "0x700/0x700", "any ID"). */
+    QString toString() const
+    {
+        if (mask == 0)
+            return QStringLiteral("any ID");
+        if (mask == 0x1FFFFFFF)
+            return QString("0x%1").arg(id, 0, 16);
+        return QString("0x%1/0x%2").arg(id & mask, 0, 16).arg(mask, 0, 16);
+    }
+
+    static CANIdFilter exact(uint32_t id) { return {id, 0x1FFFFFFF, true, false}; }
+    static CANIdFilter exact(uint32_t id, bool extended) { return {id, 0x1FFFFFFF, false, extended}; }
+    static CANIdFilter masked(uint32_t id, uint32_t mask) { return {id, mask, true, false}; }
+    static CANIdFilter all() { return {0, 0, true, false}; }
+};
+
+/**
+ * @brief Acceptance check for drivers that filter received frames in software.
+ *
+ * Same rules as the hardware filters of ICANDriver::setAcceptanceFilters():
+ * error frames always pass; data frames and TX confirmations pass when they
+ * match at least one filter. An empty list accepts everything.
+ */
+inline bool passesAcceptanceFilters(const QList<CANIdFilter>& filters, const CANMessage& msg)
+{
+    if (filters.isEmpty() || msg.isError)
+        return true;
+    for (const CANIdFilter& filter : filters) {
+        if (filter.matchesId(msg.id, msg.isExtended))
+            return true;
+    }
+    return false;
+}
+
 // ============================================================================
 //  CAN Channel Information (detected hardware)
 // ============================================================================
@@ -199,16 +313,78 @@ public:
      */
     virtual CANResult receive(CANMessage& msg, int timeoutMs = 1000) = 0;
 
+    /**
+     * @brief Transmit several messages in order.
+     *
+     * Backends override this with a bulk call (one lock, few driver calls);
+     * the default sends one frame at a time.
+     *
+     * @param[out] sent Number of leading messages accepted by the driver.
+     * @return Failure if not all messages were sent.
+     */
+    virtual CANResult transmitBatch(std::span<const CANMessage> msgs, int& sent)
+    {
+        sent = 0;
+        for (const CANMessage& msg : msgs) {
+            CANResult result = transmit(msg);
+            if (!result.success)
+                return result;
+            ++sent;
+        }
+        return CANResult::Success();
+    }
+
+    /**
+     * @brief Receive up to msgs.size() messages.
+     *
+     * Waits up to timeoutMs for the first message, then returns whatever
+     * else is already queued without waiting again. The default is built on
+     * receive().
+     *
+     * @param[out] received Number of messages stored at the front of msgs.
+     * @return Result (success=true if at least one message was received).
+     */
+    virtual CANResult receiveBatch(std::span<CANMessage> msgs, int& received,
+                                   int timeoutMs = 1000)
+    {
+        received = 0;
+        if (msgs.empty())
+            return CANResult::Success();
+
+        CANResult result = receive(msgs[0], timeoutMs);
+        if (!result.success)
+            return result;
+        received = 1;
+        while (received < static_cast<int>(msgs.size())
+               && receive(msgs[received], 0).success)
+            ++received;
+        return CANResult::Success();
+    }
+
     /** @brief Flush (discard) all messages in the receive queue. */
     virtual CANResult flushReceiveQueue() = 0;
 
+    /**
+     * @brief Accept only frames matching one of filters on the open channel.
+     *
+     * Filtering happens as close to the bus as the backend allows (controller
+     * acceptance registers, kernel socket filter, virtual bus delivery), so
+     * rejected frames never reach receive(). Error frames always pass; TX
+     * confirmations are filtered like received frames. An empty list accepts
+     * everything, which is also the state after openChannel(). Frames queued
+     * before the call may still be delivered.
+     *
+     * The default reports that the backend has no acceptance filtering.
+     */
+    virtual CANResult setAcceptanceFilters(const QList<CANIdFilter>& /*filters*/)
+    {
+        return CANResult::Failure(QString("%1 driver does not support acceptance filters").arg(driverName()));
+    }
+
     /** @brief Last error description from the driver backend. */
     virtual QString lastError() const = 0;
 
 signals:
-    /** @brief Emitted when a message is received (if async receive is active). */
-    void messageReceived(const CANMessage& msg);
-
     /** @brief Emitted when an error occurs. */
     void errorOccurred(const QString& error);
 
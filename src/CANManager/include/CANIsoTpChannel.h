@@ -0,0 +1,136 @@
+#pragma once
+/**
+ * @file CANIsoTpChannel.h
+ * @brief ISO 15765-2 (ISO-TP) transport channel on a CANBusManager slot.
+ *
+ * A channel is one TX / RX identifier pair with normal addressing. It
+ * segments outgoing messages into single / first / consecutive frames and
+ * reassembles incoming ones, with flow control (block size, STmin
+ * including the 100–900 µs values), CAN FD frame sizes (TX_DL up to 64,
+ * escape sequences for long single frames and first frames over 4095
+ * bytes) and optional padding.
+ *
+ * Receiving is event-driven: the channel is a dispatcher tap, so its
+ * state machine runs on the slot's dispatcher thread as frames arrive.
+ * Flow control is answered from there and complete messages are queued
+ * for receive(). No thread polls, so any number of channels — on one slot
+ * or several — run concurrently, each as fast as its peer allows.
+ *
+ * Sending runs on the caller's thread: send() transmits the first frame,
+ * waits for the flow control the dispatcher hands over, then paces the
+ * consecutive frames by the peer's STmin. Frames that may go back to back
+ * (STmin 0) are passed to the driver in batches.
+ *
+ * Timeouts:
+ *   - N_As  a frame must be accepted by the driver within this time
+ *           (a full TX queue is retried until then)
+ *   - N_Bs  flow control must arrive within this time after the first
+ *           frame or the last frame of a block
+ *   - N_Cr  consecutive frames must arrive within this time of each other
+ */
+
+#include "CANInterface.h"
+
+#include <QByteArray>
+#include <QMutex>
+
+#include <atomic>
+#include <memory>
+
+namespace CANManager {
+
+class CANIsoTpChannel
+{
+public:
+    /// Complete messages kept for receive(); further messages are dropped and counted
+    static constexpr int RX_QUEUE_MESSAGES = 64;
+
+    /// Most consecutive frames handed to the driver in one call
+    static constexpr int MAX_TX_BATCH = 32;
+
+    struct Config
+    {
+        QString  slotName    = QStringLiteral("CAN 1");
+        uint32_t txId        = 0x7E0;
+        uint32_t rxId        = 0x7E8;
+        bool     extendedIds = false;   ///< 29-bit TX and RX identifiers
+
+        bool     fd          = false;   ///< Send CAN FD frames
+        bool     brs         = true;    ///< Bit rate switch on FD frames
+        int      frameSize   = 8;       ///< TX_DL: 8, or a CAN FD length 12..64
+
+        bool     padding     = true;    ///< Pad short frames to 8 bytes (FD frames are always padded to a valid length)
+        uint8_t  paddingByte = 0xCC;
+
+        uint8_t  blockSize   = 0;       ///< BS sent in our flow control (0 = whole message)
+        uint8_t  stMin       = 0;       ///< STmin sent in our flow control (raw byte)
+        int      maxWaitFrames  = 10;   ///< N_WFTmax: FC.WAIT frames tolerated in a row
+        uint32_t maxReceiveSize = 1024 * 1024;  ///< Longer incoming messages get FC.OVFLW
+
+        int      nAsMs = 1000;
+        int      nBsMs = 1000;
+        int      nCrMs = 1000;
+    };
+
+    struct Stats
+    {
+        uint64_t messagesSent     = 0;
+        uint64_t messagesReceived = 0;
+        uint64_t framesSent       = 0;
+        uint64_t framesReceived   = 0;
+        uint64_t txErrors         = 0;  ///< Failed send() calls
+        uint64_t rxErrors         = 0;  ///< Aborted receptions, overflows, dropped messages
+        QString  lastError;
+    };
+
+    explicit CANIsoTpChannel(const Config& config);
+    ~CANIsoTpChannel();
+
+    CANIsoTpChannel(const CANIsoTpChannel&) = delete;
+    CANIsoTpChannel& operator=(const CANIsoTpChannel&) = delete;
+
+    /** @brief Validate the configuration and start receiving on the slot. */
+    CANResult open();
+
+    /** @brief Stop receiving; a send() in progress fails. */
+    void close();
+
+    bool isOpen() const;
+    const Config& config() const { return m_config; }
+
+    /**
+     * @brief Send one message, blocking until its last frame has been sent.
+     * Concurrent calls on one channel are serialised.
+     * @param cancel Checked between frames; a cancelled transfer is abandoned.
+     */
+    CANResult send(const QByteArray& payload, const std::atomic<bool>* cancel = nullptr);
+
+    /**
+     * @brief Take the oldest received message, waiting up to timeoutMs.
+     *
+     * Fails with the reason if a reception was aborted (sequence error,
+     * N_Cr timeout, ...) and no complete message is queued.
+     */
+    CANResult receive(QByteArray& payload, int timeoutMs);
+
+    /** @brief Discard queued messages and pending reception errors, then send and receive one message. */
+    CANResult request(const QByteArray& payload, QByteArray& response, int timeoutMs,
+                      const std::atomic<bool>* cancel = nullptr);
+
+    /** @brief Discard queued messages and pending reception errors. */
+    void clearReceived();
+
+    Stats stats() const;
+
+    /** @brief STmin byte → minimum separation in µs (reserved values mean 127 ms). */
+    static int stMinToMicros(uint8_t stMin);
+
+private:
+    class Engine;
+
+    Config m_config;
+    QMutex m_sendMutex;                 ///< Serialises send()
+    std::shared_ptr<Engine> m_engine;   ///< Dispatcher tap; outlives close() while a batch is dispatched
+};
+
+} // namespace CANManager
@@ -7,15 +7,49 @@
  *   - Registration and lifecycle management of CAN driver backends
  *   - Named channel slots (e.g. "CAN 1", "CAN 2") from HWConfigManager
  *   - Unified transmit/receive API across all driver types
+ *   - Per-slot acceptance filters, applied by the driver (hardware if possible)
+ *   - Per-slot RX dispatch through ID-indexed subscriptions
+ *   - Request/response with the response filter armed before transmit
+ *   - ISO-TP channels (CANIsoTpChannel) running as taps on the RX dispatcher
+ *   - Per-slot cyclic transmit scheduler with jitter statistics
+ *   - Per-slot live bus statistics: frame rates per ID, bus load, error frames
+ *   - ASC / BLF trace recording of one or more slots
+ *   - Time-accurate ASC / BLF trace replay onto a slot
+ *   - Gateways between slots with block / delay / rewrite rules
+ *   - Shared UDS clients per slot and ECU address pair
+ *   - AUTOSAR CAN network management for simulated nodes, per slot
  *   - Hardware detection aggregated across all registered drivers
+ *
+ * Threading: slot lookup reads an immutable slot table snapshot without
+ * locking; open/close publish a new table. Each slot has its own TX lock
+ * and its own RX dispatcher thread (the only reader of the slot's driver),
+ * so a blocking receive on one slot never stalls transmit on that slot or
+ * any operation on other slots.
  */
 
+#include "AtomicSharedPtr.h"
+#include "CANBusStatistics.h"
+#include "CANCyclicScheduler.h"
+#include "CANGateway.h"
 #include "CANInterface.h"
+#include "CANNetworkManagement.h"
+#include "CANRxDispatcher.h"
+#include "CANTraceRecorder.h"
+#include "CANTraceReplayer.h"
+#include "UdsClient.h"
+#include "VirtualCANDriver.h"
+
+#ifdef _WIN32
 #include "VectorCANDriver.h"
+#endif
+#ifdef __linux__
+#include "SocketCANDriver.h"
+#endif
 
 #include <QObject>
 #include <QMap>
 #include <QMutex>
+#include <map>
 #include <memory>
 
 namespace CANManager {
@@ -34,8 +68,8 @@ namespace CANManager {
  *       // ... populate UI
  *   }
  *
- *   // Open a slot
- *   can.openSlot("CAN 1", driver, channelInfo, config);
+ *   // Open a slot on its own port
+ *   can.openSlot("CAN 1", can.vectorDriver("CAN 1"), channelInfo, config);
  *   can.transmit("CAN 1", msg);
  *   can.closeSlot("CAN 1");
  * @endcode
@@ -49,10 +83,38 @@ public:
 
     // === Driver access ===
 
-    /** @brief Get the Vector XL driver instance (always created, may not be available). */
+#ifdef _WIN32
+    /** @brief Get the Vector XL driver used for detection (always created, may not be available). */
     VectorCANDriver* vectorDriver() { return m_vectorDriver.get(); }
 
-    /** @brief Get a driver by name (e.g., "Vector XL"). */
+    /**
+     * @brief Get the Vector XL driver instance dedicated to a slot.
+     *
+     * A VectorCANDriver owns one XL port, so every slot gets its own
+     * instance (created on demand, owned by the manager); they share the
+     * loaded XL Library. This lets all CAN channels be open at once.
+     */
+    VectorCANDriver* vectorDriver(const QString& slotName);
+#endif
+
+#ifdef __linux__
+    /** @brief Get the SocketCAN driver used for detection (always created, may not be available). */
+    SocketCANDriver* socketCanDriver() { return m_socketCanDriver.get(); }
+
+    /** @brief Get the SocketCAN driver instance (one socket) dedicated to a slot. */
+    SocketCANDriver* socketCanDriver(const QString& slotName);
+#endif
+
+    /**
+     * @brief Get the virtual CAN driver instance dedicated to a slot.
+     *
+     * Each slot attaches its own node to a virtual bus, so unlike the
+     * hardware drivers there is one instance per slot (created on demand,
+     * owned by the manager).
+     */
+    VirtualCANDriver* virtualDriver(const QString& slotName);
+
+    /** @brief Get a driver by name (e.g., "Vector XL", "SocketCAN", "Virtual"). */
     ICANDriver* driverByName(const QString& name) const;
 
     /** @brief List all registered driver names. */
@@ -71,7 +133,8 @@ public:
     /**
      * @brief Open a named channel slot.
      * @param slotName   Logical name (e.g. "CAN 1")
-     * @param driver     Driver to use
+     * @param driver     Driver to use; one instance per slot, since an
+     *                   instance drives a single channel (vectorDriver(slotName), ...)
      * @param channel    Channel hardware info
      * @param config     Bus configuration
      */
@@ -100,12 +163,226 @@ public:
     /** @brief Transmit a message on a named slot. */
     CANResult transmit(const QString& slotName, const CANMessage& msg);
 
+    /**
+     * @brief Transmit several messages on a named slot under one TX lock.
+     * @param[out] sent Number of leading messages accepted by the driver.
+     */
+    CANResult transmitBatch(const QString& slotName, std::span<const CANMessage> msgs, int& sent);
+
     /** @brief Receive a message from a named slot. */
     CANResult receive(const QString& slotName, CANMessage& msg, int timeoutMs = 1000);
 
     /** @brief Flush receive queue on a named slot. */
     CANResult flushReceiveQueue(const QString& slotName);
 
+    /**
+     * @brief Accept only frames matching filters on a named slot (empty = all).
+     *
+     * Filters are applied by the slot's driver, in hardware where possible,
+     * and affect every reader of the slot: receive(), subscriptions, ISO-TP
+     * and UDS channels, traces. Include the response IDs those rely on.
+     * Filters end with the slot; reopening accepts everything again.
+     */
+    CANResult setAcceptanceFilters(const QString& slotName, const QList<CANIdFilter>& filters);
+
+    /**
+     * @brief Transmit a request and wait for the first frame matching rxFilter.
+     *
+     * The response filter is armed before the request is sent, so a reply
+     * that arrives immediately is never lost. Frames are not consumed: the
+     * response and any unrelated traffic remain available to receive().
+     *
+     * @param[out] rxMsg  Matching frame (valid only on success).
+     * @return Failure with "Transmit failed: ..." if the request could not be
+     *         sent, or a timeout message if no matching frame arrived.
+     */
+    CANResult request(const QString& slotName, const CANMessage& txMsg,
+                      const CANIdFilter& rxFilter, int timeoutMs, CANMessage& rxMsg);
+
+    // === Subscriptions (by slot name) ===
+
+    using Subscription = CANRxDispatcher::Subscription;
+
+    /**
+     * @brief Receive every frame matching filter on a slot into a private queue.
+     *
+     * Subscriptions do not consume frames from receive() or from each other,
+     * so trace recorders, monitors and test steps can share one bus. Read
+     * with Subscription::waitForFrames() / take() from any worker thread.
+     *
+     * @return nullptr if the slot is not open. The subscription is closed
+     *         when the slot closes; subscribe again after reopening.
+     */
+    std::shared_ptr<Subscription> subscribe(const QString& slotName, const CANIdFilter& filter,
+                                            size_t queueCapacity = CANRxDispatcher::DEFAULT_SUBSCRIPTION_CAPACITY);
+
+    /** @brief Remove a subscription (no-op if the slot has closed since). */
+    void unsubscribe(const QString& slotName, const std::shared_ptr<Subscription>& subscription);
+
+    /**
+     * @brief Pass every frame of a slot to tap, on the slot's dispatcher thread.
+     *
+     * Like subscriptions, taps end with the slot; add them again after reopening.
+     * @return false if the slot is not open.
+     */
+    bool addTap(const QString& slotName, const std::shared_ptr<CANRxDispatcher::Tap>& tap);
+
+    /** @brief Remove a tap (no-op if the slot has closed since). */
+    void removeTap(const QString& slotName, const std::shared_ptr<CANRxDispatcher::Tap>& tap);
+
+    // === Cyclic transmission (by slot name) ===
+
+    using CyclicStats = CANCyclicScheduler::Stats;
+
+    /**
+     * @brief Send msg every periodMs milliseconds until stopped or the slot closes.
+     *
+     * Frames are keyed by CAN ID and format; starting an ID that is already
+     * cyclic replaces it. The first frame goes out offsetMs after the next
+     * tick. See CANCyclicScheduler for the timing model.
+     */
+    CANResult startCyclic(const QString& slotName, const CANMessage& msg, int periodMs,
+                          int offsetMs = 0);
+
+    /** @brief Atomically replace the payload of a running cyclic frame (matched by msg.id). */
+    CANResult updateCyclic(const QString& slotName, const CANMessage& msg);
+
+    /** @brief Stop a cyclic frame, optionally returning its timing statistics. */
+    CANResult stopCyclic(const QString& slotName, uint32_t id, bool extended,
+                         CyclicStats* stats = nullptr);
+
+    /** @brief Timing statistics of a running cyclic frame. Returns false if it is not running. */
+    bool cyclicStats(const QString& slotName, uint32_t id, bool extended, CyclicStats& stats) const;
+
+    // === Bus statistics (by slot name) ===
+
+    using BusStatistics = CANBusStatistics::Snapshot;
+    using BusSample     = CANBusStatistics::Sample;
+
+    /**
+     * @brief Traffic counters, bus load and per-ID rates since the slot opened
+     *        or the last resetBusStatistics().
+     *
+     * Rates are refreshed every CANBusStatistics::SAMPLE_INTERVAL_MS.
+     * Returns false if the slot is not open.
+     */
+    bool busStatistics(const QString& slotName, BusStatistics& stats) const;
+
+    /** @brief The slot's recent samples, oldest first (empty if the slot is not open). */
+    QList<BusSample> busStatisticsHistory(const QString& slotName) const;
+
+    /** @brief Zero the slot's counters, peaks and history. */
+    CANResult resetBusStatistics(const QString& slotName);
+
+    // === Trace recording ===
+
+    using TraceOptions = CANTraceRecorder::Options;
+    using TraceStats   = CANTraceRecorder::Stats;
+
+    /**
+     * @brief Record all traffic of the given slots to options.path.
+     *
+     * Slots become trace channels 1..N in list order. Every frame the slot
+     * receives is recorded, including error frames and the driver's TX
+     * confirmations (this is how transmitted frames appear in the trace).
+     * Traces are identified by their file path; several may run at once.
+     * A slot that closes stops contributing, the trace keeps running.
+     */
+    CANResult startTrace(const QStringList& slotNames, const TraceOptions& options);
+
+    /** @brief Stop a trace, flush it to disk and optionally return its statistics. */
+    CANResult stopTrace(const QString& path, TraceStats* stats = nullptr);
+
+    /** @brief Statistics of a running trace. Returns false if no trace records to path. */
+    bool traceStats(const QString& path, TraceStats& stats) const;
+
+    // === Trace replay (by slot name) ===
+
+    using ReplayOptions = CANTraceReplayer::Options;
+    using ReplayStats   = CANTraceReplayer::Stats;
+
+    /**
+     * @brief Replay an ASC / BLF trace onto a slot in the background.
+     *
+     * One replay per slot; it ends after options.loops passes, on
+     * stopReplay() or when the slot closes. See CANTraceReplayer for the
+     * timing model and the timing error statistics.
+     */
+    CANResult startReplay(const QString& slotName, const ReplayOptions& options);
+
+    /** @brief Stop (or collect a finished) replay and optionally return its statistics. */
+    CANResult stopReplay(const QString& slotName, ReplayStats* stats = nullptr);
+
+    /** @brief Wait until the slot's replay has finished. True if none is running. */
+    bool waitForReplay(const QString& slotName, int timeoutMs);
+
+    /** @brief Statistics of the slot's current or last replay. Returns false if the slot is not open. */
+    bool replayStats(const QString& slotName, ReplayStats& stats) const;
+
+    // === Gateways ===
+
+    using GatewayOptions = CANGateway::Options;
+    using GatewayStats   = CANGateway::Stats;
+
+    /**
+     * @brief Forward options.source to options.destination through options.rules.
+     *
+     * Gateways are identified by their source / destination pair; run a
+     * second gateway for the other direction. A gateway whose source slot
+     * closes stops forwarding but keeps its statistics until stopGateway().
+     */
+    CANResult startGateway(const GatewayOptions& options);
+
+    /** @brief Stop a gateway and optionally return its final statistics. */
+    CANResult stopGateway(const QString& source, const QString& destination,
+                          GatewayStats* stats = nullptr);
+
+    /** @brief Statistics of a gateway. Returns false if none runs between the slots. */
+    bool gatewayStats(const QString& source, const QString& destination, GatewayStats& stats) const;
+
+    // === UDS diagnostics ===
+
+    /**
+     * @brief The slot's UDS client for config.transport's TX / RX IDs, opened on first use.
+     *
+     * Clients persist between calls (session timing, background tester
+     * present) and are closed with the slot. Asking with a different
+     * configuration for the same IDs replaces the client.
+     * @return nullptr if the slot is not open or the client fails to open.
+     */
+    std::shared_ptr<UdsClient> udsClient(const UdsClient::Config& config, CANResult* result = nullptr);
+
+    // === Network management (by slot name) ===
+
+    using NmConfig = CANNetworkManagement::Config;
+    using NmStatus = CANNetworkManagement::Status;
+
+    /**
+     * @brief Request the network for config.nodes on config.slotName.
+     *
+     * The slot's NM engine starts on first use and runs until stopNm() or
+     * the slot closes; requesting again with the same configuration wakes
+     * the running engine. A different configuration replaces it (its nodes
+     * stop sending at once).
+     */
+    CANResult startNm(const NmConfig& config);
+
+    /** @brief Release the network for the given local nodes (empty = all). */
+    CANResult releaseNm(const QString& slotName, const QList<uint8_t>& nodes = {});
+
+    /**
+     * @brief Wait until the slot's network is asleep: local nodes in Bus-Sleep
+     *        and no remote NM PDU within the NM timeout.
+     */
+    CANResult waitNmBusSleep(const QString& slotName, int timeoutMs,
+                             const std::atomic<bool>* cancel = nullptr);
+
+    /** @brief State of the slot's NM engine. Returns false if none runs. */
+    bool nmStatus(const QString& slotName, NmStatus& status) const;
+
+    /** @brief Stop the slot's NM engine; its nodes stop sending without the sleep sequence. */
+    CANResult stopNm(const QString& slotName);
+
 signals:
     void slotOpened(const QString& slotName);
     void slotClosed(const QString& slotName);
@@ -118,16 +395,69 @@ private:
     CANBusManager& operator=(const CANBusManager&) = delete;
 
     // Registered drivers
-    std::unique_ptr<VectorCANDriver> m_vectorDriver;
+#ifdef _WIN32
+    std::unique_ptr<VectorCANDriver> m_vectorDriver;       ///< Detection / driverByName()
+    std::map<QString, std::unique_ptr<VectorCANDriver>> m_vectorSlotDrivers;
+#endif
+#ifdef __linux__
+    std::unique_ptr<SocketCANDriver> m_socketCanDriver;    ///< Detection / driverByName()
+    std::map<QString, std::unique_ptr<SocketCANDriver>> m_socketCanSlotDrivers;
+#endif
     // Future: std::unique_ptr<KvaserCANDriver> m_kvaserDriver;
+    std::unique_ptr<VirtualCANDriver> m_virtualDriver;     ///< Detection / driverByName()
+    std::map<QString, std::unique_ptr<VirtualCANDriver>> m_virtualSlotDrivers;
 
-    // Open channel slots: slotName → driver pointer
-    struct SlotInfo {
-        ICANDriver*  driver  = nullptr;
+    // Open channel slot: driver plus independent TX / RX paths
+    struct Slot {
+        ICANDriver*    driver = nullptr;
         CANChannelInfo channel;
+        QMutex         txMutex;     ///< Serialises transmit on this slot
+        std::unique_ptr<CANBusStatistics>   statistics;  ///< Counted by all paths below, outlives them
+        std::unique_ptr<CANRxDispatcher> dispatcher;   ///< Sole reader of the driver
+        std::unique_ptr<CANCyclicScheduler> cyclic;    ///< Periodic frames (uses txMutex)
+        std::unique_ptr<CANTraceReplayer>   replayer;  ///< Trace replay (uses txMutex)
+        QMutex         udsMutex;    ///< Guards udsClients
+        QMap<QString, std::shared_ptr<UdsClient>> udsClients;  ///< By TX / RX ID pair
+        QMutex         nmMutex;     ///< Guards nm
+        std::shared_ptr<CANNetworkManagement> nm;   ///< Network management, a dispatcher tap
     };
-    QMap<QString, SlotInfo> m_slots;
+    using SlotTable = QMap<QString, std::shared_ptr<Slot>>;
+
+    /// Lock-free lookup in the current slot table snapshot
+    std::shared_ptr<Slot> findSlot(const QString& slotName) const;
+
+    /// Remove a slot from the table, stop its NM engine, cyclic frames, replay, UDS clients and dispatcher, close its driver (m_mutex held)
+    bool removeSlotLocked(const QString& slotName);
+
+    /// The slot's running NM engine, or nullptr with the reason in result
+    std::shared_ptr<CANNetworkManagement> nmEngine(const QString& slotName, CANResult* result = nullptr) const;
+
+    // Immutable slot table, replaced as a whole on open/close (RCU-style)
+    AtomicSharedPtr<const SlotTable> m_slotTable{std::make_shared<const SlotTable>()};
+
+    /// Per-slot driver instance from one of the maps above, created on first use (m_mutex held)
+    template <typename Driver>
+    static Driver* slotDriverLocked(std::map<QString, std::unique_ptr<Driver>>& drivers,
+                                    const QString& slotName);
+
+    // Serialises writers (open/close) and the per-slot driver maps
     mutable QMutex m_mutex;
+
+    // Running traces by file path, with the dispatcher tap installed on each slot
+    struct Trace {
+        std::shared_ptr<CANTraceRecorder> recorder;
+        std::vector<std::pair<QString, std::shared_ptr<CANRxDispatcher::Tap>>> taps;
+    };
+    std::map<QString, Trace> m_traces;
+    mutable QMutex m_traceMutex;
+
+    // Gateways, by "source->destination"
+    struct Gateway {
+        std::unique_ptr<CANGateway> gateway;
+        std::shared_ptr<Subscription> subscription;
+    };
+    std::map<QString, Gateway> m_gateways;
+    mutable QMutex m_gatewayMutex;
 };
 
 } // namespace CANManager
@@ -0,0 +1,211 @@
+#pragma once
+/**
+ * @file CANNetworkManagement.h
+ * @brief AUTOSAR CAN network management (CanNm) for simulated nodes on a
+ *        slot — keeps the network awake, releases it with the standard
+ *        timing and observes when the bus goes to sleep.
+ *
+ * Each configured local node runs the CanNm state machine:
+ *
+ *   Bus-Sleep ──request──▶ Repeat Message ──repeatMessageMs──▶ Normal Operation
+ *                              │  (not requested)                  │ release
+ *                              ▼                                   ▼
+ *   Bus-Sleep ◀─waitBusSleepMs─ Prepare Bus-Sleep ◀─timeoutMs─ Ready Sleep
+ *
+ * Nodes send their NM PDU (baseId + node ID) every msgCycleMs in Repeat
+ * Message and Normal Operation through the slot's cyclic scheduler, so the
+ * PDU timing has the scheduler's millisecond accuracy. Every NM PDU from
+ * another node restarts the NM timeout; a Repeat Message Request bit moves
+ * Normal Operation / Ready Sleep back to Repeat Message, and an NM PDU
+ * during Prepare Bus-Sleep restarts the network (Repeat Message). A node in
+ * Bus-Sleep only records the PDU: without a network request it stays asleep.
+ *
+ * Receiving is event-driven: the engine is a dispatcher tap, so remote NM
+ * PDUs are seen on the slot's dispatcher thread as they arrive. One engine
+ * thread sleeps until the next timer (repeat message, NM timeout, wait bus
+ * sleep, remote node timeout) and applies transmit changes. Nothing polls
+ * receive(); waitBusSleep() wakes on the state change itself.
+ *
+ * The network is asleep when every local node is in Bus-Sleep and no remote
+ * node has sent an NM PDU within timeoutMs — the moment a sleep current
+ * measurement can start.
+ *
+ * PDU layout: byte nidPosition holds the source node ID, byte cbvPosition
+ * the control bit vector (bit 0 Repeat Message Request, bit 4 Active
+ * Wakeup), the remaining bytes are userData.
+ */
+
+#include "CANInterface.h"
+#include "CANRxDispatcher.h"
+
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <vector>
+
+namespace CANManager {
+
+class CANNetworkManagement : public CANRxDispatcher::Tap
+{
+public:
+    /// Control bit vector bits
+    static constexpr uint8_t CBV_REPEAT_MESSAGE_REQUEST = 0x01;
+    static constexpr uint8_t CBV_ACTIVE_WAKEUP          = 0x10;
+
+    enum class State { BusSleep, PrepareBusSleep, RepeatMessage, NormalOperation, ReadySleep };
+
+    struct Config
+    {
+        QString  slotName    = QStringLiteral("CAN 1");
+        uint32_t baseId      = 0x500;       ///< NM PDU ID = baseId + node ID
+        uint32_t idMask      = 0x700;       ///< Received IDs matching baseId under this mask are NM PDUs
+        bool     extendedIds = false;
+
+        QList<uint8_t> nodes;               ///< Local (simulated) node IDs
+
+        int      msgCycleMs       = 100;    ///< CanNmMsgCycleTime
+        int      msgCycleOffsetMs = 0;      ///< CanNmMsgCycleOffset: delay of the first PDU
+        int      repeatMessageMs  = 1500;   ///< CanNmRepeatMessageTime
+        int      timeoutMs        = 2000;   ///< CanNmTimeoutTime
+        int      waitBusSleepMs   = 1500;   ///< CanNmWaitBusSleepTime
+        bool     activeWakeupBit  = true;   ///< Set CBV Active Wakeup after waking the network
+
+        int      pduLength   = 8;
+        int      nidPosition = 0;           ///< Byte of the source node ID (-1 = none, taken from the CAN ID)
+        int      cbvPosition = 1;           ///< Byte of the control bit vector (-1 = none)
+        uint8_t  userData    = 0xFF;        ///< Remaining PDU bytes
+
+        bool operator==(const Config&) const = default;
+    };
+
+    struct NodeStatus
+    {
+        uint8_t nodeId    = 0;
+        State   state     = State::BusSleep;
+        bool    requested = false;
+    };
+
+    struct RemoteNode
+    {
+        uint8_t  nodeId   = 0;
+        uint32_t canId    = 0;
+        uint8_t  lastCbv  = 0;
+        uint64_t pdus     = 0;
+        int64_t  lastSeenMsAgo = 0;
+        bool     awake    = false;          ///< Sent an NM PDU within timeoutMs
+    };
+
+    struct Status
+    {
+        bool     running  = false;
+        bool     busSleep = false;          ///< Local nodes asleep and no remote node awake
+        QList<NodeStatus> nodes;            ///< In configuration order
+        QList<RemoteNode> remotes;          ///< By node ID
+        uint64_t pdusReceived  = 0;         ///< NM PDUs from remote nodes
+        int64_t  sinceReleaseMs = -1;       ///< Since the last local node was released (-1 = requested / never)
+        int64_t  sleepAfterReleaseMs = -1;  ///< Release → bus sleep (-1 = not asleep since the release)
+    };
+
+    explicit CANNetworkManagement(const Config& config);
+    ~CANNetworkManagement() override;
+
+    CANNetworkManagement(const CANNetworkManagement&) = delete;
+    CANNetworkManagement& operator=(const CANNetworkManagement&) = delete;
+
+    /**
+     * @brief Validate the configuration and start the engine with all nodes
+     *        in Bus-Sleep. Add the engine as a tap of the slot to receive.
+     */
+    CANResult start();
+
+    /** @brief Stop the engine; local NM PDUs stop at once. */
+    void stop();
+
+    bool isRunning() const;
+    const Config& config() const { return m_config; }
+
+    /** @brief Request the network for the given local nodes (empty = all). */
+    CANResult requestNetwork(const QList<uint8_t>& nodes = {});
+
+    /** @brief Release the network for the given local nodes (empty = all). */
+    CANResult releaseNetwork(const QList<uint8_t>& nodes = {});
+
+    /**
+     * @brief Wait until the network is asleep (see the file comment).
+     * @param cancel Checked while waiting; a cancelled wait fails.
+     * @return Failure naming the nodes still awake on timeout.
+     */
+    CANResult waitBusSleep(int timeoutMs, const std::atomic<bool>* cancel = nullptr);
+
+    Status status() const;
+
+    static QString stateName(State state);
+
+    void onFrames(const CANMessage* frames, int count) override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Node
+    {
+        uint8_t id;
+        State   state = State::BusSleep;
+        bool    requested    = false;
+        bool    activeWakeup = false;       ///< This node woke the network (CBV bit until Network Mode ends)
+        Clock::time_point repeatDeadline{};     ///< Repeat Message → Normal / Ready Sleep
+        Clock::time_point timeoutDeadline{};    ///< Ready Sleep → Prepare Bus-Sleep
+        Clock::time_point sleepDeadline{};      ///< Prepare Bus-Sleep → Bus-Sleep
+
+        // What the cyclic scheduler is sending for this node
+        bool    transmitting = false;
+        uint8_t sentCbv      = 0;
+    };
+
+    struct Remote
+    {
+        uint32_t canId   = 0;
+        uint8_t  lastCbv = 0;
+        uint64_t pdus    = 0;
+        Clock::time_point lastSeen{};
+    };
+
+    CANResult validate() const;
+    CANResult selectNodes(const QList<uint8_t>& ids, std::vector<Node*>& nodes);
+    bool isNmPdu(const CANMessage& msg) const;
+    uint8_t sourceNode(const CANMessage& msg) const;
+    CANMessage pdu(const Node& node, uint8_t cbv) const;
+
+    // State machine (m_mutex held)
+    void enterRepeatMessageLocked(Node& node, Clock::time_point now);
+    void enterReadySleepLocked(Node& node, Clock::time_point now);
+    void onRemotePduLocked(Node& node, uint8_t cbv, Clock::time_point now);
+    void processTimersLocked(Clock::time_point now);
+    Clock::time_point nextDeadlineLocked() const;
+    bool isBusSleepLocked(Clock::time_point now) const;
+    void updateBusSleepLocked(Clock::time_point now);
+    void syncTransmitLocked();
+    void stopTransmitLocked();
+
+    void run();
+
+    const Config m_config;
+
+    mutable QMutex m_mutex;                 ///< Guards everything below
+    QWaitCondition m_wake;                  ///< Engine thread: state or timers changed
+    QWaitCondition m_changed;               ///< waitBusSleep(): bus sleep state may have changed
+    std::vector<Node> m_nodes;
+    std::map<uint8_t, Remote> m_remotes;
+    uint64_t m_pdusReceived = 0;
+    bool     m_busSleep = true;
+    Clock::time_point m_releasedAt{};       ///< Last local node released (epoch = requested / never)
+    Clock::time_point m_sleepAt{};          ///< Network last fell asleep
+    QThread* m_thread = nullptr;
+    bool     m_stopping = false;
+};
+
+} // namespace CANManager
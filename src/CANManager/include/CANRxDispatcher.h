@@ -0,0 +1,273 @@
+#pragma once
+/**
+ * @file CANRxDispatcher.h
+ * @brief Per-slot receive thread that fans incoming frames out to consumers.
+ *
+ * CANBusManager starts one dispatcher for every open slot. The dispatcher
+ * thread is the only reader of the slot's driver; it drains the driver in
+ * batches and offers each frame to
+ *   - subscriptions registered by exact ID, ID/mask or "all"
+ *     (trace recorders, signal monitors, ...),
+ *   - armed response waiters (CANBusManager::request()),
+ *   - taps that see every frame of a batch at once (trace recording), and
+ *   - the slot receive queue read by CANBusManager::receive().
+ *
+ * Routing: exact standard IDs index a 2048-entry table directly, exact
+ * extended IDs go through a hash; only mask and "all" subscriptions are
+ * tested frame by frame. The routing table is immutable and replaced as a
+ * whole on subscribe/unsubscribe, so the dispatcher never locks per frame.
+ *
+ * Delivery: every subscription owns a lock-free SPSC ring. A batch of
+ * frames is pushed first and each subscriber is woken at most once per
+ * batch. A full ring drops the new frame and counts an overrun — a slow
+ * consumer never stalls the bus or other consumers.
+ *
+ * Statistics: with a CANBusStatistics attached, every driver read is counted
+ * and the queue high-water marks are tracked after each batch.
+ */
+
+#include "AtomicSharedPtr.h"
+#include "CANBusStatistics.h"
+#include "CANInterface.h"
+#include "SpscRing.h"
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace CANManager {
+
+class CANRxDispatcher
+{
+public:
+    /// Slot receive queue depth (frames)
+    static constexpr size_t RX_QUEUE_CAPACITY = 8192;
+
+    /// Default per-subscription queue depth (frames)
+    static constexpr size_t DEFAULT_SUBSCRIPTION_CAPACITY = 4096;
+
+    /// Frames requested from ICANDriver::receiveBatch() per dispatch pass
+    static constexpr int MAX_BATCH = 64;
+
+    /// Driver receive() slice; bounds how long stop() takes on drivers that cannot be woken
+    static constexpr int POLL_INTERVAL_MS = 100;
+
+    /// Direct-index routing table size (all 11-bit identifiers)
+    static constexpr uint32_t STANDARD_ID_COUNT = 2048;
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief A consumer's view of the slot traffic matching one filter.
+     *
+     * The dispatcher is the single producer. Consumer calls (take, clear)
+     * are serialised internally, so one subscription may be shared by
+     * several threads, but each frame is handed to only one of them.
+     * A subscription is closed when it is unsubscribed or the slot closes.
+     */
+    class Subscription
+    {
+    public:
+        Subscription(const CANIdFilter& filter, size_t capacity);
+
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+
+        const CANIdFilter& filter() const { return m_filter; }
+
+        /** @brief Move up to maxFrames queued frames into out. Returns the count. */
+        int take(CANMessage* out, int maxFrames);
+
+        /**
+         * @brief As take(), also reporting in arrivals when the dispatcher
+         *        read each frame from the driver.
+         */
+        int take(CANMessage* out, Clock::time_point* arrivals, int maxFrames);
+
+        /** @brief Take a single frame. Returns false if none is queued. */
+        bool take(CANMessage& msg) { return take(&msg, 1) == 1; }
+
+        /**
+         * @brief Block until frames are queued, the subscription closes or
+         *        the timeout expires (-1 = wait forever).
+         * @return true if frames are available.
+         */
+        bool waitForFrames(int timeoutMs);
+
+        /** @brief Discard all queued frames. */
+        void clear();
+
+        bool     isClosed() const { return m_closed.load(std::memory_order_acquire); }
+        uint64_t overruns() const { return m_overruns.load(std::memory_order_relaxed); }
+        size_t   pending() const  { return m_ring.size(); }
+
+    private:
+        friend class CANRxDispatcher;
+
+        struct Entry
+        {
+            CANMessage        msg;
+            Clock::time_point arrival;
+        };
+
+        // Producer side (dispatcher thread only)
+        void push(const CANMessage& msg, Clock::time_point arrival);
+        void notify();
+        void close();
+
+        CANIdFilter           m_filter;
+        SpscRing<Entry>       m_ring;
+        std::atomic<uint64_t> m_overruns{0};
+        std::atomic<bool>     m_closed{false};
+        bool                  m_touched = false;    ///< Dispatcher-only: pushed in current batch
+
+        QMutex                m_consumerMutex;      ///< Serialises consumers of m_ring
+        QMutex                m_waitMutex;
+        QWaitCondition        m_waitCond;
+        std::atomic<int>      m_sleepers{0};
+    };
+
+    /**
+     * @brief Observer of the complete slot traffic, including error frames
+     *        and TX confirmations.
+     *
+     * onFrames() runs on the dispatcher thread once per received batch,
+     * before the frames are routed. It must not block: copy what is needed
+     * and return. A removed tap may still see the batch being dispatched.
+     */
+    class Tap
+    {
+    public:
+        virtual ~Tap() = default;
+        virtual void onFrames(const CANMessage* frames, int count) = 0;
+    };
+
+    /**
+     * @brief A pending response: completed by the first frame matching filter.
+     *
+     * Obtained from arm(); all fields are guarded by the dispatcher's waiter mutex.
+     */
+    struct Waiter
+    {
+        CANIdFilter    filter;
+        CANMessage     msg;
+        bool           done = false;
+        QWaitCondition cond;
+    };
+
+    /** @param statistics Counts the slot traffic (optional, must outlive the dispatcher) */
+    CANRxDispatcher(ICANDriver* driver, const QString& slotName,
+                    CANBusStatistics* statistics = nullptr);
+    ~CANRxDispatcher();
+
+    CANRxDispatcher(const CANRxDispatcher&) = delete;
+    CANRxDispatcher& operator=(const CANRxDispatcher&) = delete;
+
+    // === Lifecycle ===
+
+    /** @brief Start the receive thread. The driver channel must be open. */
+    void start();
+
+    /**
+     * @brief Ask the receive thread to exit and release all blocked consumers.
+     *
+     * Returns immediately; close the driver channel afterwards to interrupt a
+     * blocking driver receive(), then call join().
+     */
+    void requestStop();
+
+    /** @brief Wait for the receive thread to exit (after requestStop()). */
+    void join();
+
+    // === Subscriptions ===
+
+    /** @brief Register a subscription; frames received from now on are routed to it. */
+    std::shared_ptr<Subscription> subscribe(const CANIdFilter& filter,
+                                            size_t capacity = DEFAULT_SUBSCRIPTION_CAPACITY);
+
+    /** @brief Stop routing to a subscription and close it. */
+    void unsubscribe(const std::shared_ptr<Subscription>& subscription);
+
+    // === Taps ===
+
+    /** @brief Start handing every received batch to tap. */
+    void addTap(const std::shared_ptr<Tap>& tap);
+
+    /** @brief Stop calling tap (no-op if it is not registered). */
+    void removeTap(const std::shared_ptr<Tap>& tap);
+
+    // === Slot receive queue (every frame, including error frames) ===
+
+    /** @brief Take the oldest queued frame (-1 = wait forever, 0 = poll). */
+    CANResult receive(CANMessage& msg, int timeoutMs);
+
+    /** @brief Discard all queued frames. */
+    void flush();
+
+    /** @brief Frames dropped because the slot receive queue was full. */
+    uint64_t overruns() const { return m_slotQueue.overruns(); }
+
+    // === Response waiters ===
+
+    /**
+     * @brief Register a waiter for the next frame matching filter.
+     *
+     * Arm before transmitting the request so a response that arrives
+     * immediately cannot be missed.
+     */
+    std::shared_ptr<Waiter> arm(const CANIdFilter& filter);
+
+    /**
+     * @brief Block until the waiter completes, the timeout expires or the
+     *        dispatcher stops. The waiter is disarmed on return.
+     * @return true and the matching frame in msg if it completed.
+     */
+    bool waitForResponse(const std::shared_ptr<Waiter>& waiter, int timeoutMs,
+                         CANMessage& msg);
+
+    /** @brief Remove a waiter without waiting (e.g. the request failed to send). */
+    void disarm(const std::shared_ptr<Waiter>& waiter);
+
+private:
+    // Immutable routing table, rebuilt on every subscribe/unsubscribe
+    struct Routes
+    {
+        std::vector<std::vector<Subscription*>> standard;   ///< Exact 11-bit IDs, indexed by ID
+        std::unordered_map<uint32_t, std::vector<Subscription*>> extended;  ///< Exact 29-bit IDs
+        std::vector<Subscription*> filtered;                ///< Mask and "all" subscriptions
+        std::vector<std::shared_ptr<Subscription>> owners;  ///< Keeps the raw pointers alive
+        std::vector<std::shared_ptr<Tap>> taps;
+    };
+
+    static std::shared_ptr<const Routes> buildRoutes(std::vector<std::shared_ptr<Subscription>> owners,
+                                                     std::vector<std::shared_ptr<Tap>> taps = {});
+
+    void run();
+    void dispatch(const CANMessage* frames, int count, Clock::time_point arrival);
+    void completeWaiters(const CANMessage& msg);
+    void removeWaiterLocked(const std::shared_ptr<Waiter>& waiter);
+
+    ICANDriver* m_driver;
+    QString     m_slotName;
+    CANBusStatistics* m_statistics;
+    QThread*    m_thread = nullptr;
+    std::atomic<bool> m_stopping{false};
+    std::vector<Subscription*> m_batchTouched;      ///< Dispatcher-only scratch list
+
+    Subscription m_slotQueue{CANIdFilter::all(), RX_QUEUE_CAPACITY};
+
+    AtomicSharedPtr<const Routes> m_routes;
+    QMutex m_subscribeMutex;                    ///< Serialises routing table writers (subscriptions, taps)
+
+    QMutex m_waiterMutex;
+    std::vector<std::shared_ptr<Waiter>> m_waiters;
+    std::atomic<int> m_waiterCount{0};          ///< Lets dispatch() skip the lock when idle
+};
+
+} // namespace CANManager
@@ -0,0 +1,99 @@
+#pragma once
+/**
+ * @file CANTraceReader.h
+ * @brief Loads Vector ASC and BLF trace files into a compact frame array.
+ *
+ * The file is memory-mapped and parsed in a single pass. Each frame is kept
+ * as a 24-byte record with its payload appended to one shared byte array,
+ * so a trace of millions of classic frames needs about a third of the
+ * memory a CANMessage per frame would, and replaying it touches memory
+ * sequentially.
+ *
+ * Supported input:
+ *   - ASC: classic and CANFD lines, hex or decimal base, absolute or
+ *     relative timestamps
+ *   - BLF: CAN_MESSAGE, CAN_MESSAGE2, CAN_FD_MESSAGE and CAN_FD_MESSAGE_64
+ *     objects, in zlib or uncompressed containers
+ *
+ * Error frames, events, statistics and unknown records are skipped and
+ * counted. Frames are ordered by timestamp; the first frame is at 0.
+ */
+
+#include "CANInterface.h"
+#include "CANTraceWriter.h"
+
+#include <vector>
+
+namespace CANManager {
+
+class CANTraceReader
+{
+public:
+    /// Frame flag bits
+    enum FrameFlag : uint8_t {
+        Extended = 0x01,
+        FD       = 0x02,
+        BRS      = 0x04,
+        Remote   = 0x08,
+        Tx       = 0x10     ///< Transmitted by the recording node
+    };
+
+    /// One frame of the trace; the payload is stored in the reader
+    struct Frame
+    {
+        uint64_t timestamp  = 0;    ///< ns since the first frame
+        uint32_t id         = 0;
+        uint32_t dataOffset = 0;    ///< Start of the payload in the reader's data array
+        uint16_t channel    = 1;    ///< 1-based trace channel
+        uint8_t  dlc        = 0;
+        uint8_t  flags      = 0;    ///< FrameFlag bits
+
+        int dataLength() const
+        {
+            if (flags & Remote)
+                return 0;
+            return (flags & FD) ? dlcToLength(dlc) : qMin(static_cast<int>(dlc), 8);
+        }
+    };
+
+    /**
+     * @brief Replace the contents with the frames of a trace file.
+     *
+     * The format is taken from the file contents ("LOGG" signature → BLF),
+     * not from the name. Fails if the file cannot be read or holds no frames.
+     */
+    CANResult load(const QString& path);
+
+    void clear();
+
+    const std::vector<Frame>& frames() const { return m_frames; }
+    CANTraceFormat format() const { return m_format; }
+
+    /** @brief Payload bytes of a frame (dataLength() bytes). */
+    const uint8_t* data(const Frame& frame) const { return m_data.data() + frame.dataOffset; }
+
+    /** @brief Frame as a transmittable message (timestamp in ns, direction dropped). */
+    CANMessage message(const Frame& frame) const;
+
+    /** @brief Records that were not frames or could not be parsed. */
+    uint64_t skippedRecords() const { return m_skipped; }
+
+    /** @brief Timestamp of the last frame (ns). */
+    uint64_t duration() const { return m_frames.empty() ? 0 : m_frames.back().timestamp; }
+
+private:
+    void parseAsc(const char* text, qint64 size);
+    CANResult parseBlf(const char* bytes, qint64 size);
+    int  parseBlfObjects(const char* bytes, int size);
+    void parseBlfFrame(uint32_t type, const char* body, int bodySize, uint64_t timestamp);
+    void append(uint64_t timestamp, uint32_t id, uint16_t channel, uint8_t dlc, uint8_t flags,
+                const uint8_t* payload, int length);
+    void finish();
+
+    std::vector<Frame>   m_frames;
+    std::vector<uint8_t> m_data;
+    CANTraceFormat       m_format  = CANTraceFormat::Asc;
+    uint64_t             m_skipped = 0;
+};
+
+} // namespace CANManager
@@ -0,0 +1,139 @@
+#pragma once
+/**
+ * @file CANTraceRecorder.h
+ * @brief Streaming CAN trace recorder (ASC / BLF) with a background writer.
+ *
+ * Frames are copied into a pool of preallocated blocks on the caller's
+ * thread — usually a slot's RX dispatcher via a tap — and written to disk
+ * by a dedicated writer thread. The capture path only takes a short lock
+ * to copy frames; it never waits for the disk and never allocates. If the
+ * disk falls so far behind that every block is queued, new frames are
+ * dropped and counted instead of stalling the bus.
+ *
+ * Several sources can feed one recorder, each under its own trace channel
+ * number (CANBusManager::startTrace() uses 1..N in slot order). Files can
+ * be rotated by size and/or age; rotated files are numbered
+ * "<name>_001.<ext>", "<name>_002.<ext>", ...
+ *
+ * Timestamps: each channel's driver timestamps are shifted so its first
+ * frame lands at the moment it was recorded relative to start(); later
+ * frames keep the driver's own spacing.
+ */
+
+#include "CANRxDispatcher.h"
+#include "CANTraceWriter.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace CANManager {
+
+class CANTraceRecorder : public std::enable_shared_from_this<CANTraceRecorder>
+{
+public:
+    /// Frames per buffer block
+    static constexpr int BLOCK_FRAMES = 2048;
+
+    /// A partly filled block is written after at most this long
+    static constexpr int FLUSH_INTERVAL_MS = 200;
+
+    /// Frames per writer call; file rotation is checked between chunks
+    static constexpr int WRITE_CHUNK = 256;
+
+    struct Options
+    {
+        QString        path;                    ///< Trace file (directories are created)
+        CANTraceFormat format = CANTraceFormat::Asc;
+        qint64         maxFileBytes   = 0;      ///< Rotate after this many bytes (0 = never)
+        int            maxFileSeconds = 0;      ///< Rotate after this long (0 = never)
+        int            bufferBlocks   = 64;     ///< Preallocated blocks of BLOCK_FRAMES frames
+    };
+
+    struct Stats
+    {
+        uint64_t framesRecorded = 0;    ///< Frames copied into the buffer
+        uint64_t framesWritten  = 0;    ///< Frames handed to the file writer
+        uint64_t framesDropped  = 0;    ///< Frames lost: buffer full (disk too slow) or write error
+        qint64   bytesWritten   = 0;    ///< Bytes in all files written so far
+        int      fileCount      = 0;    ///< Files created (> 1 after rotation)
+        QString  currentFile;
+        QString  lastError;             ///< Last file error, empty if none
+    };
+
+    /** Create with std::make_shared (taps keep the recorder alive). */
+    explicit CANTraceRecorder(const Options& options);
+    ~CANTraceRecorder();
+
+    CANTraceRecorder(const CANTraceRecorder&) = delete;
+    CANTraceRecorder& operator=(const CANTraceRecorder&) = delete;
+
+    /** @brief Allocate the buffer, create the first file and start the writer thread. */
+    CANResult start();
+
+    /**
+     * @brief Stop recording, write everything buffered and close the file.
+     * @param[out] stats Final statistics, if given.
+     */
+    CANResult stop(Stats* stats = nullptr);
+
+    bool  isRunning() const;
+    Stats stats() const;
+
+    /**
+     * @brief Copy frames into the buffer under the given trace channel.
+     *
+     * Never blocks on disk; safe to call from several threads. Ignored
+     * unless the recorder is running.
+     */
+    void record(uint16_t channel, const CANMessage* frames, int count);
+
+    /** @brief A dispatcher tap that records a slot's traffic as channel. */
+    std::shared_ptr<CANRxDispatcher::Tap> createTap(uint16_t channel);
+
+    /** @brief File name of rotation part index (1-based): "<name>_NNN.<ext>". */
+    static QString rotatedPath(const QString& path, int index);
+
+private:
+    struct Block
+    {
+        std::unique_ptr<CANTraceFrame[]> frames;
+        int count = 0;
+    };
+
+    void run();
+    void writeBlock(Block& block);
+    CANResult openNextFile();
+    bool rotationDue() const;
+    void setErrorLocked(const QString& error);
+
+    const Options m_options;
+    std::unique_ptr<CANTraceWriter> m_writer;   ///< Writer thread only (after start())
+    QElapsedTimer m_fileAge;                    ///< Writer thread only
+    qint64        m_closedBytes = 0;            ///< Bytes in rotated-out files (writer thread)
+
+    mutable QMutex m_mutex;                     ///< Guards everything below
+    QWaitCondition m_wake;                      ///< Full block queued or stop requested
+    std::vector<Block>  m_blocks;
+    std::vector<Block*> m_free;
+    std::deque<Block*>  m_full;                 ///< Waiting for the writer, oldest first
+    Block*        m_current  = nullptr;         ///< Block being filled
+    bool          m_running  = false;
+    bool          m_stopping = false;
+    bool          m_dropping = false;           ///< Warned about the current drop episode
+    QDateTime     m_startTime;
+    QElapsedTimer m_clock;                      ///< Time since start()
+    QElapsedTimer m_flushTimer;                 ///< Time since the partial block was last written
+    std::vector<int64_t> m_channelOffset;       ///< Per channel: driver ns - trace ns
+    std::vector<bool>    m_channelSeen;
+    Stats         m_stats;
+    QThread*      m_thread = nullptr;
+};
+
+} // namespace CANManager
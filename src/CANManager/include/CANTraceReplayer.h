@@ -0,0 +1,153 @@
+#pragma once
+/**
+ * @file CANTraceReplayer.h
+ * @brief Per-slot, time-accurate replay of ASC / BLF traces.
+ *
+ * start() loads the trace (CANTraceReader), selects the frames to send —
+ * trace channel, include/exclude ID filters, ID remapping — and hands them
+ * to a replay thread. Frame i is due at
+ *
+ *     start + (timestamp[i] + pass * loopLength) / speed
+ *
+ * on the steady clock. The thread sleeps until shortly before each
+ * deadline and spins the last stretch, then sends every frame that is due
+ * with one ICANDriver::transmitBatch() call under the slot's TX lock. A
+ * late thread never drops frames: they go out in order, as soon as
+ * possible, and the lateness shows up in the timing statistics.
+ *
+ * Timing error is the send time (taken just before the driver call) minus
+ * the frame's deadline. Its distribution is kept in a 1 µs histogram, so
+ * percentiles are exact to the microsecond up to HISTOGRAM_RANGE_US.
+ */
+
+#include "CANBusStatistics.h"
+#include "CANInterface.h"
+#include "CANTraceReader.h"
+
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <chrono>
+#include <vector>
+
+namespace CANManager {
+
+class CANTraceReplayer
+{
+public:
+    /// Most frames sent with one driver call (bounds the time the TX lock is held)
+    static constexpr int MAX_BATCH = 64;
+
+    /// Sleep until this long before a deadline, then spin
+    static constexpr std::chrono::microseconds SPIN_MARGIN{300};
+
+    /// Timing errors up to this value are histogrammed in 1 µs buckets
+    static constexpr int HISTOGRAM_RANGE_US = 10000;
+
+    struct Options
+    {
+        QString  path;                      ///< ASC or BLF trace
+        int      channel = 0;               ///< Trace channel to replay, 0 = all channels
+        double   speed   = 1.0;             ///< Time scale: 2.0 replays twice as fast
+        int      loops   = 1;               ///< Passes over the trace, 0 = until stopped
+        QList<CANIdFilter> include;         ///< Replay only matching frames (empty = all)
+        QList<CANIdFilter> exclude;         ///< Never replay matching frames
+        QMap<uint32_t, uint32_t> idMap;     ///< Trace ID → transmitted ID (format kept)
+    };
+
+    struct Stats
+    {
+        bool     running        = false;
+        QString  path;
+        uint64_t framesPerLoop  = 0;        ///< Frames selected from the trace
+        double   loopDurationS  = 0.0;      ///< Length of one pass at speed 1
+        int      loopsCompleted = 0;
+        uint64_t sent           = 0;        ///< Frames accepted by the driver
+        uint64_t errors         = 0;        ///< Frames the driver rejected (not retried)
+
+        // Timing error (send time - deadline) of the frames sent
+        double   meanErrorUs    = 0.0;
+        double   stdDevErrorUs  = 0.0;
+        double   maxErrorUs     = 0.0;
+        double   p50ErrorUs     = 0.0;
+        double   p90ErrorUs     = 0.0;
+        double   p99ErrorUs     = 0.0;
+        double   p999ErrorUs    = 0.0;
+        QString  lastError;                 ///< Last driver error, empty if none
+    };
+
+    /** @param statistics Counts the sent frames (optional, must outlive the replayer) */
+    CANTraceReplayer(ICANDriver* driver, QMutex* txMutex, const QString& slotName,
+                     CANBusStatistics* statistics = nullptr);
+    ~CANTraceReplayer();
+
+    CANTraceReplayer(const CANTraceReplayer&) = delete;
+    CANTraceReplayer& operator=(const CANTraceReplayer&) = delete;
+
+    /**
+     * @brief Load options.path and start replaying it.
+     *
+     * Loading happens on the calling thread, so file and format errors are
+     * returned here. Fails if a replay is already running on the slot.
+     */
+    CANResult start(const Options& options);
+
+    /**
+     * @brief Stop the replay (no-op if it has finished) and return its final statistics.
+     * Nothing is sent after stop() returns.
+     */
+    CANResult stop(Stats* stats = nullptr);
+
+    /** @brief Wait until the replay has sent its last pass. True if not running. */
+    bool waitForFinished(int timeoutMs);
+
+    bool  isRunning() const;
+    Stats stats() const;
+
+    /**
+     * @brief Stop the replay for good.
+     *
+     * Called before the slot's driver is closed; afterwards start() fails.
+     */
+    void shutdown();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void run();
+    Clock::time_point deadline(size_t index, int pass) const;
+    void joinThread();
+    void recordLocked(const std::vector<Clock::time_point>& deadlines, int count, int sent,
+                      Clock::time_point sendTime, const QString& error);
+    void finishStatsLocked(Stats& stats) const;
+
+    ICANDriver* m_driver;
+    QMutex*     m_txMutex;          ///< The slot's TX lock, shared with CANBusManager::transmit()
+    CANBusStatistics* m_statistics;
+    QString     m_slotName;
+
+    // Replay plan; written by start() only while no replay thread runs
+    CANTraceReader m_trace;
+    std::vector<CANTraceReader::Frame> m_schedule;  ///< Selected, remapped frames
+    uint64_t    m_loopLengthNs = 0;
+    double      m_speed = 1.0;
+    int         m_loops = 1;
+    Clock::time_point m_start{};
+
+    mutable QMutex m_mutex;         ///< Guards everything below
+    QWaitCondition m_wake;          ///< Stop requested
+    QWaitCondition m_finished;      ///< Replay thread done
+    bool     m_running  = false;
+    bool     m_stopping = false;
+    bool     m_shutdown = false;
+    Stats    m_stats;
+    double   m_errorSumUs   = 0.0;
+    double   m_errorSqSumUs = 0.0;
+    std::vector<uint64_t> m_histogram;  ///< 1 µs buckets plus one overflow bucket
+    QThread* m_thread = nullptr;
+};
+
+} // namespace CANManager
@@ -0,0 +1,72 @@
+#pragma once
+/**
+ * @file CANTraceWriter.h
+ * @brief Vector ASC (text) and BLF (binary logging format) trace file writers.
+ *
+ * A writer turns recorded frames into one trace file. It does no buffering
+ * of its own beyond what the format needs (BLF packs objects into zlib
+ * compressed containers of up to 128 KiB), so it is meant to run on a
+ * background thread such as the CANTraceRecorder writer.
+ *
+ * Frames are written in the order given. Timestamps handed to a writer are
+ * relative to the file's start time (ns); direction is taken from
+ * CANMessage::isTxConfirm.
+ */
+
+#include "CANInterface.h"
+
+#include <QDateTime>
+#include <QFile>
+
+#include <memory>
+
+namespace CANManager {
+
+enum class CANTraceFormat
+{
+    Asc,    ///< Vector ASCII trace
+    Blf     ///< Vector binary logging format (zlib compressed)
+};
+
+/**
+ * @brief A frame as recorded: the message and the trace channel it was seen on.
+ */
+struct CANTraceFrame
+{
+    CANMessage msg;             ///< timestamp = ns since the trace start
+    uint16_t   channel = 1;     ///< 1-based trace channel
+};
+
+/**
+ * @brief Abstract trace file writer.
+ */
+class CANTraceWriter
+{
+public:
+    virtual ~CANTraceWriter() = default;
+
+    /** @brief Create a writer for the given format. */
+    static std::unique_ptr<CANTraceWriter> create(CANTraceFormat format);
+
+    /** @brief Format implied by a file name (".blf" → BLF, anything else ASC). */
+    static CANTraceFormat formatForPath(const QString& path);
+
+    /**
+     * @brief Create (truncate) path and write the file header.
+     * @param startTime Wall-clock time of timestamp 0
+     */
+    virtual CANResult open(const QString& path, const QDateTime& startTime) = 0;
+
+    /** @brief Append frames to the open file. */
+    virtual CANResult write(const CANTraceFrame* frames, int count) = 0;
+
+    /** @brief Write the trailer (BLF: last container and final header) and close. */
+    virtual CANResult close() = 0;
+
+    virtual bool isOpen() const = 0;
+
+    /** @brief Bytes in the current file so far (compressed size for BLF). */
+    virtual qint64 fileSize() const = 0;
+};
+
+} // namespace CANManager
@@ -0,0 +1,134 @@
+#pragma once
+/**
+ * @file SpscRing.h
+ * @brief Bounded lock-free single-producer / single-consumer ring buffer.
+ *
+ * Used to hand CAN frames from a producer thread (bus or driver RX thread)
+ * to exactly one consumer thread without taking a lock per frame.
+ *
+ * Rules:
+ *   - push() may only be called from one thread at a time (the producer)
+ *   - pop()/popBatch()/clear() may only be called from one thread at a time
+ *     (the consumer)
+ *   - size()/empty() are approximate when called from a third thread
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace CANManager {
+
+template <typename T>
+class SpscRing
+{
+public:
+    /**
+     * @brief Create a ring that can hold at least @p minCapacity elements.
+     * The capacity is rounded up to the next power of two.
+     */
+    explicit SpscRing(size_t minCapacity)
+    {
+        size_t cap = 2;
+        while (cap < minCapacity)
+            cap <<= 1;
+        m_mask   = cap - 1;
+        m_buffer = std::make_unique<T[]>(cap);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    /** @brief Producer: append an element. Returns false if the ring is full. */
+    bool push(const T& value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail > m_mask) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail > m_mask)
+                return false;
+        }
+        m_buffer[head & m_mask] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Consumer: remove the oldest element. Returns false if the ring is empty. */
+    bool pop(T& value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_cachedHead) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail == m_cachedHead)
+                return false;
+        }
+        value = m_buffer[tail & m_mask];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer: remove up to @p maxCount elements into @p out.
+     * Publishes the new read index once for the whole batch.
+     * @return Number of elements removed.
+     */
+    size_t popBatch(T* out, size_t maxCount)
+    {
+        return popBatch(maxCount, [out](size_t i, const T& value) { out[i] = value; });
+    }
+
+    /**
+     * @brief Consumer: remove up to @p maxCount elements, handing each to
+     * @p visit(index, element) in order. Same publishing as popBatch().
+     * @return Number of elements removed.
+     */
+    template <typename Visit>
+    size_t popBatch(size_t maxCount, Visit&& visit)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_cachedHead - tail < maxCount)
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+
+        const size_t available = m_cachedHead - tail;
+        const size_t count = available < maxCount ? available : maxCount;
+        for (size_t i = 0; i < count; ++i)
+            visit(i, m_buffer[(tail + i) & m_mask]);
+        if (count > 0)
+            m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /** @brief Consumer: drop everything currently queued. */
+    void clear()
+    {
+        m_cachedHead = m_head.load(std::memory_order_acquire);
+        m_tail.store(m_cachedHead, std::memory_order_release);
+    }
+
+    size_t size() const
+    {
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    // Producer-owned line: write index + producer's view of the read index
+    alignas(CACHE_LINE) std::atomic<size_t> m_head{0};
+    size_t m_cachedTail = 0;
+
+    // Consumer-owned line: read index + consumer's view of the write index
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail{0};
+    size_t m_cachedHead = 0;
+
+    alignas(CACHE_LINE) size_t m_mask = 0;
+    std::unique_ptr<T[]> m_buffer;
+};
+
+} // namespace CANManager
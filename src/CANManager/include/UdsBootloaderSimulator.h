@@ -0,0 +1,91 @@
+#pragma once
+/**
+ * @file UdsBootloaderSimulator.h
+ * @brief In-process UDS bootloader stand-in for flash tests without an ECU.
+ *
+ * Answers on an ISO-TP channel of its own (normally a second slot on the
+ * same virtual bus as the tester) from a worker thread:
+ *   - 0x10 DiagnosticSessionControl, 0x11 ECUReset, 0x3E TesterPresent
+ *   - 0x31 RoutineControl 0xFF00 eraseMemory
+ *   - 0x34 RequestDownload / 0x36 TransferData / 0x37 RequestTransferExit
+ *
+ * Erase and download are only accepted in the programming session. Transfer
+ * data is checked like a real bootloader does (sequence counter, repeated
+ * blocks, block length, size) and committed to an in-memory flash on 0x37.
+ */
+
+#include "CANIsoTpChannel.h"
+
+#include <QMap>
+#include <QMutex>
+#include <QThread>
+
+#include <atomic>
+
+namespace CANManager {
+
+class UdsBootloaderSimulator
+{
+public:
+    struct Config
+    {
+        CANIsoTpChannel::Config transport;      ///< Server side: txId is the response ID
+        uint32_t maxBlockLength = 4095;         ///< Reported in the 0x34 response
+        uint32_t memoryStart    = 0;            ///< Accepted download range
+        uint32_t memorySize     = 0x04000000;
+        int      busyMs         = 0;            ///< Erase / transfer exit time, bridged with NRC 0x78
+    };
+
+    struct Stats
+    {
+        int      requests         = 0;
+        int      transferBlocks   = 0;
+        int      repeatedBlocks   = 0;          ///< Same sequence counter again, not stored twice
+        int      pendingResponses = 0;
+        int      negativeResponses = 0;
+        uint64_t bytesReceived    = 0;
+    };
+
+    explicit UdsBootloaderSimulator(const Config& config);
+    ~UdsBootloaderSimulator();
+
+    UdsBootloaderSimulator(const UdsBootloaderSimulator&) = delete;
+    UdsBootloaderSimulator& operator=(const UdsBootloaderSimulator&) = delete;
+
+    CANResult start();
+    void stop();
+    bool isRunning() const;
+
+    /** @brief Completed downloads by start address. */
+    QMap<uint32_t, QByteArray> memory() const;
+    Stats stats() const;
+
+private:
+    void run();
+    QByteArray handle(const QByteArray& request);
+    QByteArray requestDownload(const QByteArray& request);
+    QByteArray transferData(const QByteArray& request);
+    QByteArray transferExit(const QByteArray& request);
+    QByteArray eraseMemory(const QByteArray& request);
+    QByteArray negative(uint8_t sid, uint8_t nrc);
+    void       waitBusy(uint8_t sid);
+
+    Config          m_config;
+    CANIsoTpChannel m_channel;
+    QThread*        m_thread = nullptr;
+    std::atomic<bool> m_stop{false};
+
+    // Worker thread only
+    uint8_t  m_session     = 0x01;
+    bool     m_downloading = false;
+    uint32_t m_address     = 0;
+    uint32_t m_size        = 0;
+    uint8_t  m_nextSequence = 1;
+    QByteArray m_download;
+
+    mutable QMutex m_mutex;                     ///< Guards the members below
+    QMap<uint32_t, QByteArray> m_memory;
+    Stats m_stats;
+};
+
+} // namespace CANManager
@@ -0,0 +1,181 @@
+#pragma once
+/**
+ * @file UdsClient.h
+ * @brief UDS (ISO 14229) diagnostic client over an ISO-TP channel.
+ *
+ * One client talks to one server (ECU) through a CANIsoTpChannel, so
+ * requests and responses of any length are segmented by the transport.
+ * request() sends a request and waits P2 for the response; every
+ * "response pending" (NRC 0x78) restarts the wait with P2* without
+ * resending. DiagnosticSessionControl adopts the P2 / P2* values the
+ * server reports.
+ *
+ * Typed helpers cover the common services (0x10, 0x19, 0x22 with several
+ * DIDs per request, 0x27 with a key function hook, 0x2E, 0x31, 0x3E).
+ * Tester present runs from the client's own thread and is only sent when
+ * no other request has kept the session alive for a full period. It is
+ * sent through the channel like any request, so it never interleaves with
+ * the frames of a segmented transfer.
+ *
+ * UDS allows one outstanding request per server; concurrent request()
+ * calls on one client are serialised.
+ */
+
+#include "CANIsoTpChannel.h"
+
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+namespace CANManager {
+
+class UdsClient
+{
+public:
+    /// Negative response code: request received, response pending
+    static constexpr uint8_t NRC_RESPONSE_PENDING = 0x78;
+
+    struct Config
+    {
+        CANIsoTpChannel::Config transport;
+        int p2Ms                = 150;   ///< Response timeout (P2 client)
+        int p2StarMs            = 5000;  ///< Response timeout after NRC 0x78 (P2* client)
+        int timingMarginMs      = 50;    ///< Added to the P2 / P2* a server reports
+        int maxPendingResponses = 100;   ///< NRC 0x78 tolerated per request
+        int maxDidsPerRequest   = 16;    ///< DIDs batched into one ReadDataByIdentifier
+    };
+
+    struct Response
+    {
+        bool       positive     = false;
+        uint8_t    nrc          = 0;     ///< Negative response code, 0 if positive
+        QByteArray data;                 ///< Complete response, service ID first
+        int        pendingCount = 0;     ///< NRC 0x78 responses before the final one
+        double     elapsedMs    = 0.0;   ///< Request sent → final response
+    };
+
+    struct Dtc
+    {
+        uint32_t code   = 0;             ///< 3-byte DTC
+        uint8_t  status = 0;             ///< Status byte (ISO 14229-1 D.2)
+    };
+
+    /// SecurityAccess key hook: seed of the requested level → key
+    using KeyFunction = std::function<QByteArray(uint8_t level, const QByteArray& seed)>;
+
+    explicit UdsClient(const Config& config);
+    ~UdsClient();
+
+    UdsClient(const UdsClient&) = delete;
+    UdsClient& operator=(const UdsClient&) = delete;
+
+    CANResult open();
+    void close();
+    bool isOpen() const;
+    const Config& config() const { return m_config; }
+
+    /**
+     * @brief Send a request and wait for its final response.
+     *
+     * Fails on transport errors, timeouts and negative responses; response
+     * is filled whenever one arrived. Responses to other services (late
+     * answers to an earlier request) are skipped.
+     */
+    CANResult request(const QByteArray& request, Response& response,
+                      const std::atomic<bool>* cancel = nullptr);
+
+    // === Services ===
+
+    /** @brief 0x10; adopts the P2 / P2* the server reports. */
+    CANResult diagnosticSessionControl(uint8_t session, Response* response = nullptr);
+
+    /**
+     * @brief 0x22 for any number of DIDs, maxDidsPerRequest per request.
+     *
+     * A multi-DID response is split with the lengths from setDidLength().
+     * A DID of unknown length extends to the end of its response, so it is
+     * always the last DID of a request.
+     */
+    CANResult readDataByIdentifier(const QList<uint16_t>& dids, QMap<uint16_t, QByteArray>& values,
+                                   const std::atomic<bool>* cancel = nullptr);
+
+    /** @brief As above; @p lengths add to setDidLength()'s for this read only. */
+    CANResult readDataByIdentifier(const QList<uint16_t>& dids, const QMap<uint16_t, int>& lengths,
+                                   QMap<uint16_t, QByteArray>& values,
+                                   const std::atomic<bool>* cancel = nullptr);
+
+    /** @brief 0x2E */
+    CANResult writeDataByIdentifier(uint16_t did, const QByteArray& value);
+
+    /** @brief 0x19 with any sub-function. */
+    CANResult readDtcInformation(uint8_t subFunction, const QByteArray& parameters, Response& response);
+
+    /** @brief 0x19 0x02: DTCs whose status matches mask. */
+    CANResult readDtcsByStatusMask(uint8_t mask, QList<Dtc>& dtcs, uint8_t* availabilityMask = nullptr);
+
+    /** @brief 0x31; response.data holds the routine status record after the routine ID. */
+    CANResult routineControl(uint8_t type, uint16_t routineId, const QByteArray& option, Response& response);
+
+    /**
+     * @brief 0x27: request the seed of an odd level, send computeKey's key.
+     *
+     * A response without seed bytes fails. With @p seedLength set, a seed of
+     * any other length fails too, and an all-zero seed means the level is
+     * already unlocked only when it has that length.
+     */
+    CANResult securityAccess(uint8_t level, const KeyFunction& computeKey, int seedLength = 0);
+
+    /** @brief 0x3E with a positive response. */
+    CANResult testerPresent();
+
+    /** @brief Keep the session alive with 0x3E 0x80 until stopped or closed. */
+    CANResult startTesterPresent(int periodMs);
+    void stopTesterPresent();
+    bool isTesterPresentRunning() const;
+
+    /** @brief Length of a DID's data, for splitting multi-DID responses. */
+    void setDidLength(uint16_t did, int length);
+
+    /** @brief Current response timeouts (changed by DiagnosticSessionControl). */
+    int p2Ms() const     { return m_p2Ms.load(); }
+    int p2StarMs() const { return m_p2StarMs.load(); }
+
+    static QString nrcName(uint8_t nrc);
+
+    /** @brief Make a seed/key algorithm available by name (e.g. to test steps). */
+    static void registerKeyFunction(const QString& name, KeyFunction function);
+
+    /** @brief A registered key function, or an empty one. */
+    static KeyFunction keyFunction(const QString& name);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void runTesterPresent();
+    static CANResult splitDidResponse(const QList<uint16_t>& dids, const QByteArray& data,
+                                      const QMap<uint16_t, int>& lengths,
+                                      QMap<uint16_t, QByteArray>& values);
+
+    Config          m_config;
+    CANIsoTpChannel m_channel;
+    std::atomic<int> m_p2Ms;
+    std::atomic<int> m_p2StarMs;
+
+    QMutex m_requestMutex;              ///< One outstanding request
+
+    mutable QMutex m_mutex;             ///< Guards everything below
+    QMap<uint16_t, int> m_didLengths;
+    Clock::time_point m_lastActivity{}; ///< Last request sent (restarts the server's S3 timer)
+    QWaitCondition m_wake;              ///< Tester present stop requested
+    QThread* m_testerPresentThread = nullptr;
+    bool     m_testerPresentStop   = false;
+    int      m_testerPresentPeriodMs = 0;
+};
+
+} // namespace CANManager
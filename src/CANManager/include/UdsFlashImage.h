@@ -0,0 +1,111 @@
+#pragma once
+/**
+ * @file UdsFlashImage.h
+ * @brief Memory-mapped flash image (Intel HEX, Motorola S-record or raw binary).
+ *
+ * open() maps the file and indexes it in one pass: every data record is
+ * checked (syntax and checksum) and remembered by address and file offset,
+ * but not decoded. Records are sorted by address and contiguous records
+ * form a segment, the unit of one RequestDownload.
+ *
+ * A Reader decodes a segment straight from the mapping, block by block,
+ * so an image is never held in memory twice and decoding can run while
+ * the previous block is on the bus.
+ */
+
+#include "CANInterface.h"
+
+#include <QFile>
+
+#include <vector>
+
+namespace CANManager {
+
+class UdsFlashImage
+{
+public:
+    enum class Format {
+        Auto,       ///< From the contents: ':' → Intel HEX, 'S0'..'S9' → S-record, else raw
+        IntelHex,
+        SRecord,
+        Raw
+    };
+
+    /// Contiguous address range, programmed with one RequestDownload
+    struct Segment
+    {
+        uint32_t address     = 0;
+        uint32_t size        = 0;
+        int      firstRecord = 0;   ///< Index into the record table
+        int      recordCount = 0;
+    };
+
+    /// Streams the bytes of one segment in address order
+    class Reader
+    {
+    public:
+        Reader(const UdsFlashImage& image, int segment);
+
+        /** @brief Decode up to maxLength bytes into out; 0 at the end of the segment. */
+        int read(uint8_t* out, int maxLength);
+
+        uint32_t remaining() const { return m_remaining; }
+
+    private:
+        const UdsFlashImage& m_image;
+        int      m_record;          ///< Current record
+        int      m_lastRecord;      ///< One past the segment's last record
+        uint32_t m_recordOffset = 0;
+        uint32_t m_remaining;
+    };
+
+    UdsFlashImage() = default;
+    ~UdsFlashImage();
+
+    UdsFlashImage(const UdsFlashImage&) = delete;
+    UdsFlashImage& operator=(const UdsFlashImage&) = delete;
+
+    /**
+     * @brief Map and index a flash file.
+     * @param rawAddress Load address of a raw binary (ignored for HEX / S-record)
+     *
+     * Fails on unreadable files, malformed records, bad checksums,
+     * overlapping records and images without data.
+     */
+    CANResult open(const QString& path, Format format = Format::Auto, uint32_t rawAddress = 0);
+    void close();
+
+    Format format() const { return m_format; }
+    const std::vector<Segment>& segments() const { return m_segments; }
+
+    /** @brief Data bytes over all segments. */
+    uint64_t totalSize() const { return m_totalSize; }
+
+    static QString formatName(Format format);
+
+private:
+    /// Data record: its bytes are at fileOffset, as hex text or raw bytes
+    struct Record
+    {
+        uint32_t address    = 0;
+        uint32_t length     = 0;
+        qint64   fileOffset = 0;
+    };
+
+    CANResult indexIntelHex(const char* text, qint64 size);
+    CANResult indexSRecord(const char* text, qint64 size);
+    CANResult buildSegments();
+
+    QFile      m_file;
+    uchar*     m_mapped = nullptr;
+    QByteArray m_contents;           ///< File contents where mapping is not possible
+    const char* m_bytes = nullptr;   ///< Mapping or m_contents
+    qint64     m_size = 0;
+
+    Format m_format = Format::Auto;
+    std::vector<Record>  m_records;
+    std::vector<Segment> m_segments;
+    uint64_t m_totalSize = 0;
+};
+
+} // namespace CANManager
@@ -0,0 +1,90 @@
+#pragma once
+/**
+ * @file UdsFlashProgrammer.h
+ * @brief Downloads a flash image with RequestDownload / TransferData /
+ *        RequestTransferExit (UDS 0x34 / 0x36 / 0x37).
+ *
+ * Per segment:
+ *   - optional erase (RoutineControl 0xFF00 eraseMemory)
+ *   - 0x34 with the segment's address and size; the server's
+ *     maxNumberOfBlockLength, capped at Options::maxBlockLength (4095 by
+ *     default), sets the TransferData size
+ *   - 0x36 blocks as large as the server accepts, each one multi-frame
+ *     ISO-TP transfer paced only by the server's flow control (STmin 0
+ *     servers get back-to-back frames)
+ *   - 0x37
+ *
+ * While a block is on the bus, a reader thread decodes the following
+ * blocks from the image and updates the segment CRC, so file access and
+ * checksumming stay off the transfer's critical path.
+ *
+ * Session, security access and checksum routines are OEM specific and are
+ * left to the caller.
+ */
+
+#include "UdsClient.h"
+#include "UdsFlashImage.h"
+
+namespace CANManager {
+
+class UdsFlashProgrammer
+{
+public:
+    /// Default cap on the server's block length: the largest ISO-TP message
+    /// without the first-frame escape sequence
+    static constexpr int DEFAULT_MAX_BLOCK_LENGTH = 4095;
+
+    struct Options
+    {
+        uint8_t dataFormatIdentifier = 0x00;    ///< Compression / encryption (0x00 = none)
+        int  maxBlockLength  = 0;               ///< Upper limit for the server's block length (0 = DEFAULT_MAX_BLOCK_LENGTH)
+        bool eraseBeforeDownload = false;       ///< RoutineControl 0xFF00 per segment
+        int  prefetchBlocks  = 4;               ///< Blocks decoded ahead of the transfer
+    };
+
+    struct SegmentReport
+    {
+        uint32_t address = 0;
+        uint32_t size    = 0;
+        uint32_t crc32   = 0;                   ///< CRC-32 (IEEE 802.3) of the segment data
+        int      blocks  = 0;
+        int      maxBlockLength = 0;            ///< Negotiated maxNumberOfBlockLength
+    };
+
+    struct Report
+    {
+        uint64_t bytes   = 0;                   ///< Data bytes acknowledged by the server
+        int      blocks  = 0;
+        double   elapsedMs      = 0.0;          ///< First request → last 0x37 response
+        double   bytesPerSecond = 0.0;
+        double   minBlockMs = 0.0;              ///< TransferData request → response
+        double   avgBlockMs = 0.0;
+        double   p95BlockMs = 0.0;
+        double   maxBlockMs = 0.0;
+        QList<SegmentReport> segments;
+    };
+
+    explicit UdsFlashProgrammer(UdsClient& client);
+    UdsFlashProgrammer(UdsClient& client, const Options& options);
+
+    /**
+     * @brief Program every segment of image.
+     *
+     * Stops at the first failed request; report covers what was
+     * transferred up to then.
+     */
+    CANResult program(const UdsFlashImage& image, Report& report,
+                      const std::atomic<bool>* cancel = nullptr);
+
+    /** @brief CRC-32 (IEEE 802.3) continued from crc (0 to start). */
+    static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t length);
+
+private:
+    CANResult programSegment(const UdsFlashImage& image, int segment, Report& report,
+                             QList<double>& latencies, const std::atomic<bool>* cancel);
+
+    UdsClient& m_client;
+    Options    m_options;
+};
+
+} // namespace CANManager
@@ -11,22 +11,16 @@
  *   - Automatic hardware detection and channel enumeration
  *   - Classic CAN (HS) and CAN FD support
  *   - Thread-safe transmit/receive with notification events
+ *   - Acceptance filters in the controller (code/mask, 11-bit ranges)
+ *   - One XL port per instance: open one driver per channel to run several
+ *     channels at once (the DLL and driver handle are shared, see VectorXLLibrary)
  */
 
+#include "AtomicSharedPtr.h"
 #include "CANInterface.h"
+#include "VectorXLLibrary.h"
 
-#include <QLibrary>
 #include <QMutex>
-#include <QThread>
-#include <atomic>
-
-// vxlapi.h uses the Windows HANDLE type
-#include <windows.h>
-
-// Use dynamic loading mode — gives us typedefs for function pointers
-#define DYNAMIC_XLDRIVER_DLL
-#define DO_NOT_DEFINE_EXTERN_DECLARATION
-#include "vxlapi.h"
 
 namespace CANManager {
 
@@ -78,6 +72,23 @@ public:
     CANResult receive(CANMessage& msg, int timeoutMs = 1000) override;
     CANResult flushReceiveQueue() override;
 
+    /** @brief Multi-event xlCanTransmit / xlCanTransmitEx, IO_BATCH_SIZE events per call. */
+    CANResult transmitBatch(std::span<const CANMessage> msgs, int& sent) override;
+
+    /** @brief One notification wait, then drain the XL receive queue (xlReceive / xlCanReceive). */
+    CANResult receiveBatch(std::span<CANMessage> msgs, int& received,
+                           int timeoutMs = 1000) override;
+
+    /**
+     * @brief Program the controller acceptance filter (xlCanSetChannelAcceptance /
+     *        xlCanAddAcceptanceRange).
+     *
+     * The hardware holds one code/mask per ID format plus 11-bit ranges, so
+     * filter lists it cannot express exactly are widened to a superset there
+     * and narrowed in software before frames are handed out.
+     */
+    CANResult setAcceptanceFilters(const QList<CANIdFilter>& filters) override;
+
     QString   lastError() const override;
 
     // === Vector-specific extras ===
@@ -92,39 +103,26 @@ public:
     void setAppName(const QString& appName) { m_appName = appName; }
     QString appName() const { return m_appName; }
 
-    // === Async receive ===
-
-    /** @brief Start a background thread that continuously receives and emits messageReceived(). */
-    void startAsyncReceive();
-
-    /** @brief Stop the async receive thread. */
-    void stopAsyncReceive();
-
-    /** @brief Check if async receive is running. */
-    bool isAsyncReceiving() const { return m_asyncRunning.load(); }
-
 private:
-    // --- DLL loading ---
-    bool loadLibrary();
-    void unloadLibrary();
-    bool resolveFunctions();
-
     // --- Helpers ---
     QString xlStatusToString(XLstatus status) const;
     void    setError(const QString& msg);
     CANResult makeError(const QString& context, XLstatus status);
 
-    // Classic CAN transmit/receive
-    CANResult transmitClassic(const CANMessage& msg);
-    CANResult receiveClassic(CANMessage& msg, int timeoutMs);
+    /// Events passed to the XL Library per transmit/receive call
+    static constexpr int IO_BATCH_SIZE = 64;
 
-    // CAN FD transmit/receive
-    CANResult transmitFD(const CANMessage& msg);
-    CANResult receiveFD(CANMessage& msg, int timeoutMs);
+    // Batched I/O (m_txMutex / m_rxMutex held); sent/received are advanced
+    CANResult transmitClassicEvents(std::span<const CANMessage> msgs, int& sent);
+    CANResult transmitFDEvents(std::span<const CANMessage> msgs, int& sent);
+    CANResult readEvents(std::span<CANMessage> msgs, int& received);
+
+    /// Program one ID format's code/mask (and 11-bit ranges) for filters (m_txMutex held)
+    CANResult applyHardwareAcceptance(const QList<CANIdFilter>& filters, bool extended);
 
     // --- State ---
-    QLibrary     m_xlLib;
-    bool         m_driverOpen   = false;
+    VectorXLLibrary::Functions m_xl;    ///< Entry points, valid while m_driverOpen
+    bool         m_driverOpen   = false;    ///< Holding a VectorXLLibrary reference
     XLportHandle m_portHandle   = XL_INVALID_PORTHANDLE;
     XLaccess     m_channelMask  = 0;
     XLaccess     m_permissionMask = 0;
@@ -132,39 +130,17 @@ private:
     bool         m_isFD         = false;
     QString      m_lastError;
     QString      m_appName      = QStringLiteral("SPYDER_AutoTrace");
-    mutable QMutex m_mutex;
-
-    /// Cached result of isAvailable(): -1 = not yet checked, 0 = false, 1 = true
-    mutable int  m_availableCached = -1;
-
-    // --- Async receive thread ---
-    QThread*           m_rxThread   = nullptr;
-    std::atomic<bool>  m_asyncRunning{false};
-
-    // --- XL Library function pointers ---
-    XLOPENDRIVER                m_xlOpenDriver              = nullptr;
-    XLCLOSEDRIVER               m_xlCloseDriver             = nullptr;
-    XLGETDRIVERCONFIG           m_xlGetDriverConfig         = nullptr;
-    XLGETAPPLCONFIG             m_xlGetApplConfig           = nullptr;
-    XLSETAPPLCONFIG             m_xlSetApplConfig           = nullptr;
-    XLGETCHANNELINDEX           m_xlGetChannelIndex         = nullptr;
-    XLGETCHANNELMASK            m_xlGetChannelMask          = nullptr;
-    XLOPENPORT                  m_xlOpenPort                = nullptr;
-    XLCLOSEPORT                 m_xlClosePort               = nullptr;
-    XLACTIVATECHANNEL           m_xlActivateChannel         = nullptr;
-    XLDEACTIVATECHANNEL         m_xlDeactivateChannel       = nullptr;
-    XLCANSETCHANNELBITRATE      m_xlCanSetChannelBitrate    = nullptr;
-    XLCANSETCHANNELOUTPUT       m_xlCanSetChannelOutput     = nullptr;
-    XLCANSETCHANNELMODE         m_xlCanSetChannelMode       = nullptr;
-    XLCANFDSETCONFIGURATION     m_xlCanFdSetConfiguration   = nullptr;
-    XLCANTRANSMIT               m_xlCanTransmit             = nullptr;
-    XLCANTRANSMITEX             m_xlCanTransmitEx           = nullptr;
-    XLRECEIVE                   m_xlReceive                 = nullptr;
-    XLCANRECEIVE                m_xlCanReceive              = nullptr;
-    XLSETNOTIFICATION           m_xlSetNotification         = nullptr;
-    XLFLUSHRECEIVEQUEUE         m_xlFlushReceiveQueue       = nullptr;
-    XLGETERRORSTRING            m_xlGetErrorString          = nullptr;
-    XLGETEVENTSTRING            m_xlGetEventString          = nullptr;
+
+    /// Exact filter list; readEvents() drops what the hardware superset let through
+    AtomicSharedPtr<const QList<CANIdFilter>> m_acceptanceFilters{std::make_shared<const QList<CANIdFilter>>()};
+
+    // Lock order: m_mutex → m_txMutex → m_rxMutex. Open/close take all three;
+    // transmit and receive only take their own, so a blocking receive never
+    // delays transmit on the same channel. Other ports have their own locks.
+    mutable QMutex m_mutex;         ///< Driver / port lifecycle
+    mutable QMutex m_txMutex;       ///< Transmit path
+    mutable QMutex m_rxMutex;       ///< Receive path (held while waiting)
+    mutable QMutex m_errorMutex;    ///< m_lastError
 };
 
 } // namespace CANManager
@@ -0,0 +1,107 @@
+#pragma once
+/**
+ * @file VectorXLLibrary.h
+ * @brief Process-wide Vector XL Library context shared by all Vector ports.
+ *
+ * The XL Library is one DLL with one driver handle per process, while every
+ * CAN channel is a separate XL port. VectorXLLibrary owns the shared part —
+ * DLL loading, function pointer resolution and xlOpenDriver/xlCloseDriver —
+ * and is reference counted by the VectorCANDriver instances that use it.
+ * Each VectorCANDriver owns one port (handle, channel mask, RX queue and
+ * notification event), so several channels can be open at the same time.
+ */
+
+#include <QLibrary>
+#include <QMutex>
+#include <QString>
+
+// vxlapi.h uses the Windows HANDLE type
+#include <windows.h>
+
+// Use dynamic loading mode — gives us typedefs for function pointers
+#define DYNAMIC_XLDRIVER_DLL
+#define DO_NOT_DEFINE_EXTERN_DECLARATION
+#include "vxlapi.h"
+
+namespace CANManager {
+
+class VectorXLLibrary
+{
+public:
+    /**
+     * @brief Resolved XL Library entry points.
+     *
+     * Valid while the caller holds a reference (acquire() succeeded and
+     * release() has not been called); optional entries may be nullptr.
+     */
+    struct Functions
+    {
+        XLOPENDRIVER                xlOpenDriver              = nullptr;
+        XLCLOSEDRIVER               xlCloseDriver             = nullptr;
+        XLGETDRIVERCONFIG           xlGetDriverConfig         = nullptr;
+        XLGETAPPLCONFIG             xlGetApplConfig           = nullptr;
+        XLSETAPPLCONFIG             xlSetApplConfig           = nullptr;
+        XLGETCHANNELINDEX           xlGetChannelIndex         = nullptr;
+        XLGETCHANNELMASK            xlGetChannelMask          = nullptr;
+        XLOPENPORT                  xlOpenPort                = nullptr;
+        XLCLOSEPORT                 xlClosePort               = nullptr;
+        XLACTIVATECHANNEL           xlActivateChannel         = nullptr;
+        XLDEACTIVATECHANNEL         xlDeactivateChannel       = nullptr;
+        XLCANSETCHANNELBITRATE      xlCanSetChannelBitrate    = nullptr;
+        XLCANSETCHANNELOUTPUT       xlCanSetChannelOutput     = nullptr;
+        XLCANSETCHANNELMODE         xlCanSetChannelMode       = nullptr;
+        XLCANSETCHANNELACCEPTANCE   xlCanSetChannelAcceptance = nullptr;
+        XLCANADDACCEPTANCERANGE     xlCanAddAcceptanceRange   = nullptr;
+        XLCANRESETACCEPTANCE        xlCanResetAcceptance      = nullptr;
+        XLCANFDSETCONFIGURATION     xlCanFdSetConfiguration   = nullptr;
+        XLCANTRANSMIT               xlCanTransmit             = nullptr;
+        XLCANTRANSMITEX             xlCanTransmitEx           = nullptr;
+        XLRECEIVE                   xlReceive                 = nullptr;
+        XLCANRECEIVE                xlCanReceive              = nullptr;
+        XLSETNOTIFICATION           xlSetNotification         = nullptr;
+        XLFLUSHRECEIVEQUEUE         xlFlushReceiveQueue       = nullptr;
+        XLGETERRORSTRING            xlGetErrorString          = nullptr;
+        XLGETEVENTSTRING            xlGetEventString          = nullptr;
+    };
+
+    static VectorXLLibrary& instance();
+
+    /**
+     * @brief Take a reference; the first one loads the DLL and opens the driver.
+     * @param[out] functions Entry points, valid until the matching release().
+     * @param[out] error     Failure description.
+     */
+    bool acquire(Functions& functions, QString& error);
+
+    /** @brief Drop a reference; the last one closes the driver and unloads the DLL. */
+    void release();
+
+    /** @brief Check if the XL Library DLL can be loaded on this system (cached). */
+    bool isAvailable() const;
+
+    /** @brief XL Library DLL version string (e.g. "20.30.14"), empty if not open. */
+    QString dllVersion() const;
+
+    /** @brief Readable form of an XL status code (xlGetErrorString when resolved). */
+    static QString statusToString(const Functions& functions, XLstatus status);
+
+private:
+    VectorXLLibrary() = default;
+    ~VectorXLLibrary();
+    VectorXLLibrary(const VectorXLLibrary&) = delete;
+    VectorXLLibrary& operator=(const VectorXLLibrary&) = delete;
+
+    bool loadLibrary(QString& error);
+    void unloadLibrary();
+    bool resolveFunctions();
+
+    mutable QMutex m_mutex;     ///< Guards everything below
+    QLibrary  m_xlLib;
+    Functions m_fn;
+    int       m_refCount = 0;   ///< Drivers holding the XL driver open
+
+    /// Cached result of isAvailable(): -1 = not yet checked, 0 = false, 1 = true
+    mutable int m_availableCached = -1;
+};
+
+} // namespace CANManager
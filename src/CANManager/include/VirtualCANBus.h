@@ -0,0 +1,237 @@
+#pragma once
+/**
+ * @file VirtualCANBus.h
+ * @brief In-process simulated CAN bus shared by VirtualCANDriver instances.
+ *
+ * A VirtualCANBus is identified by name. Every VirtualCANDriver that opens a
+ * channel with that name attaches a node to the same bus; a frame transmitted
+ * by one node is received by all other nodes.
+ *
+ * The bus models:
+ *   - Arbitration: among the frames waiting at the head of each node's TX
+ *     queue the lowest arbitration field wins (standard before extended
+ *     on equal base ID, data before remote)
+ *   - Frame duration derived from the bit rate (worst-case bit stuffing),
+ *     including the CAN FD data phase at the BRS data bit rate
+ *   - TX confirmations (echo to the sender with isTxConfirm set)
+ *   - Error injection: destroyed frames produce an error frame on every node
+ *     and are retransmitted; a node whose TX error counter exceeds 255 goes
+ *     bus-off
+ *
+ * Timing modes:
+ *   - RealTime:  frames occupy the bus for their wall-clock duration
+ *   - Simulated: bus time only advances by frame durations, with no sleeping,
+ *     so a run is deterministic and executes as fast as the CPU allows
+ *
+ * Received frames are delivered to each node through a lock-free SPSC ring.
+ * Timestamps are nanoseconds of bus time since the bus was created.
+ */
+
+#include "CANInterface.h"
+#include "SpscRing.h"
+
+#include <QMutex>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace CANManager {
+
+class VirtualCANBus
+{
+public:
+    enum class Timing {
+        RealTime,       ///< Pace frames against the wall clock
+        Simulated       ///< Advance bus time only; run as fast as possible
+    };
+
+    /// Per-node RX queue depth (frames)
+    static constexpr size_t RX_QUEUE_CAPACITY = 8192;
+
+    /// Per-node TX queue depth (frames waiting for arbitration)
+    static constexpr int TX_QUEUE_CAPACITY = 1024;
+
+    /**
+     * @brief One attached driver: RX ring plus TX FIFO.
+     *
+     * The bus thread is the only producer of rxQueue; the owning driver is
+     * the only consumer.
+     */
+    struct Node
+    {
+        SpscRing<CANMessage> rxQueue{RX_QUEUE_CAPACITY};
+        std::atomic<uint64_t> rxOverruns{0};
+        std::atomic<bool>     txConfirmations{false};
+        bool                  fdEnabled = false;
+
+        /// Consumer: block until a frame is queued, wake() is called or the timeout expires.
+        bool waitForFrame(int timeoutMs);
+
+        /// Interrupt a waitForFrame() in progress (e.g. when closing).
+        void wake();
+
+    private:
+        friend class VirtualCANBus;
+
+        struct PendingFrame {
+            CANMessage msg;
+            uint64_t   seq = 0;
+        };
+
+        /// Producer (bus thread): enqueue a frame and wake the consumer.
+        void deliver(const CANMessage& msg);
+
+        // Guarded by the bus mutex
+        QList<CANIdFilter> acceptanceFilters;   ///< Applied in deliver() (empty = all)
+        std::deque<PendingFrame> txFifo;
+        int  txErrorCounter = 0;
+        bool busOff = false;
+
+        QMutex            waitMutex;
+        QWaitCondition    waitCond;
+        std::atomic<bool> waiting{false};
+        std::atomic<bool> wakeRequested{false};
+    };
+
+    /**
+     * @brief Get (or create) the bus with the given name, e.g. to configure it
+     * before the first channel opens. The registry keeps the bus until the last
+     * channel attached through acquire() is released.
+     */
+    static std::shared_ptr<VirtualCANBus> bus(const QString& name);
+
+    /**
+     * @brief Get (or create) the named bus and count one more channel on it.
+     * Every acquire() must be paired with a release().
+     */
+    static std::shared_ptr<VirtualCANBus> acquire(const QString& name);
+
+    /**
+     * @brief Drop one channel reference; the last one removes the bus from
+     * the registry, so a later open starts with a fresh bus.
+     */
+    static void release(const QString& name);
+
+    /** @brief Names of all buses created so far. */
+    static QStringList busNames();
+
+    /** @brief Duration of a frame on the wire in nanoseconds (see CANManager::frameDurationNs()). */
+    static uint64_t frameDurationNs(const CANMessage& msg, int bitrate, int dataBitrate);
+
+    explicit VirtualCANBus(const QString& name);
+    ~VirtualCANBus();
+
+    VirtualCANBus(const VirtualCANBus&) = delete;
+    VirtualCANBus& operator=(const VirtualCANBus&) = delete;
+
+    QString name() const { return m_name; }
+
+    // === Node attachment (used by VirtualCANDriver) ===
+
+    /**
+     * @brief Attach a new node. The first node fixes the bus bit rates;
+     * later nodes must use the same rates.
+     */
+    CANResult attach(const CANBusConfig& config, std::shared_ptr<Node>& node);
+
+    /**
+     * @brief Detach a node; frames still waiting in its TX queue are discarded.
+     * Detaching the last node stops the bus thread; the next attach() restarts it.
+     */
+    void detach(const std::shared_ptr<Node>& node);
+
+    /** @brief Queue a frame for arbitration. Returns immediately. */
+    CANResult submit(const std::shared_ptr<Node>& node, const CANMessage& msg);
+
+    /**
+     * @brief Queue several frames under one lock, in order.
+     * @param[out] accepted Frames queued before the TX queue filled up (or all).
+     */
+    CANResult submit(const std::shared_ptr<Node>& node, const CANMessage* msgs, int count,
+                     int& accepted);
+
+    /** @brief Replace a node's acceptance filters; rejected frames are never queued. */
+    void setAcceptanceFilters(const std::shared_ptr<Node>& node, const QList<CANIdFilter>& filters);
+
+    /** @brief Number of attached nodes. */
+    int nodeCount() const;
+
+    // === Configuration ===
+
+    void   setTiming(Timing timing);
+    Timing timing() const;
+
+    /**
+     * @brief Destroy each transmitted frame with the given probability.
+     * @param probability 0.0 (never) … 1.0 (always)
+     * @param seed        PRNG seed, so error patterns are reproducible
+     */
+    void setErrorRate(double probability, uint32_t seed = 1);
+
+    /** @brief Destroy the next @p count frames put on the bus. */
+    void injectErrors(int count);
+
+    /**
+     * @brief Hold arbitration. Frames submitted while paused compete in a
+     * single arbitration round on resume() — useful for deterministic tests.
+     */
+    void pause();
+    void resume();
+
+    // === Statistics ===
+
+    uint64_t framesTransmitted() const { return m_framesTransmitted.load(); }
+    uint64_t errorFrames() const { return m_errorFrames.load(); }
+
+    /** @brief Current bus time in nanoseconds. */
+    uint64_t busTimeNs() const;
+
+    /** @brief True while the bus thread runs (at least one node attached). */
+    bool isRunning() const;
+
+private:
+    void   busThreadMain();
+    void   startThread();
+    void   stopThread();
+    bool   hasPendingFrames() const;
+    std::shared_ptr<Node> arbitrate() const;
+    uint64_t wallClockNs() const;
+
+    static uint64_t arbitrationKey(const CANMessage& msg);
+
+    const QString m_name;
+
+    mutable QMutex   m_mutex;
+    QWaitCondition   m_cond;
+    std::vector<std::shared_ptr<Node>> m_nodes;
+
+    // Bus parameters (fixed by the first attached node)
+    int  m_bitrate     = 500000;
+    int  m_dataBitrate = 2000000;
+
+    Timing   m_timing = Timing::RealTime;
+    bool     m_paused = false;
+    uint64_t m_busTimeNs = 0;
+    uint64_t m_nextSeq = 0;
+    qint64   m_epochNs = 0;     ///< Steady clock at construction (RealTime mode)
+
+    // Error injection
+    double   m_errorRate = 0.0;
+    int      m_forcedErrors = 0;
+    std::mt19937 m_rng;
+
+    std::atomic<uint64_t> m_framesTransmitted{0};
+    std::atomic<uint64_t> m_errorFrames{0};
+
+    QMutex   m_threadMutex;         ///< Serializes thread start/stop; taken before m_mutex
+    QThread* m_thread = nullptr;    ///< Guarded by m_threadMutex
+    bool     m_running = false;     ///< Guarded by m_mutex
+};
+
+} // namespace CANManager
@@ -0,0 +1,278 @@
+/**
+ * @file CANBusStatistics.cpp
+ * @brief Live traffic counters and bus load of one CAN slot — implementation.
+ */
+
+#include "CANBusStatistics.h"
+
+#include <algorithm>
+
+namespace CANManager {
+
+namespace {
+
+constexpr uint32_t KEY_USED     = 0x40000000u;
+constexpr uint32_t KEY_EXTENDED = 0x80000000u;
+
+/// Slots probed before an ID counts as untracked
+constexpr int MAX_PROBES = 32;
+
+int64_t nanosSinceEpoch(std::chrono::steady_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+// ============================================================================
+//  Constructor
+// ============================================================================
+
+CANBusStatistics::CANBusStatistics(int bitrate, int dataBitrate)
+    : m_bitrate(bitrate)
+    , m_dataBitrate(dataBitrate)
+    , m_ids(new IdCounter[ID_TABLE_SIZE])
+    , m_history(HISTORY_SIZE)
+{
+    reset();
+}
+
+// ============================================================================
+//  Counting
+// ============================================================================
+
+uint32_t CANBusStatistics::keyOf(uint32_t id, bool extended)
+{
+    return (id & 0x1FFFFFFF) | KEY_USED | (extended ? KEY_EXTENDED : 0);
+}
+
+CANBusStatistics::IdCounter* CANBusStatistics::counterFor(uint32_t id, bool extended)
+{
+    const uint32_t key = keyOf(id, extended);
+
+    // Standard IDs spread by themselves; extended ones need mixing
+    uint32_t index = extended ? (key * 0x9E3779B1u) >> 20 : id;
+    for (int probe = 0; probe < MAX_PROBES; ++probe, ++index) {
+        IdCounter& counter = m_ids[index & (ID_TABLE_SIZE - 1)];
+        uint32_t current = counter.key.load(std::memory_order_acquire);
+        if (current == key)
+            return &counter;
+        if (current == 0) {
+            if (counter.key.compare_exchange_strong(current, key, std::memory_order_acq_rel))
+                return &counter;
+            if (current == key)         // Claimed for the same ID by the other path
+                return &counter;
+        }
+    }
+    return nullptr;
+}
+
+void CANBusStatistics::countFrame(const CANMessage& msg)
+{
+    m_busTimeNs.fetch_add(frameDurationNs(msg, m_bitrate, m_dataBitrate), std::memory_order_relaxed);
+    if (IdCounter* counter = counterFor(msg.id, msg.isExtended))
+        counter->frames.fetch_add(1, std::memory_order_relaxed);
+    else
+        m_untrackedFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CANBusStatistics::onReceived(const CANMessage* frames, int count)
+{
+    raise(m_rxBatchHighWater, static_cast<uint64_t>(count));
+
+    uint64_t rxFrames = 0, rxBytes = 0, confirmations = 0, errors = 0;
+    for (int i = 0; i < count; ++i) {
+        const CANMessage& msg = frames[i];
+        if (msg.isError) {
+            ++errors;
+        } else if (msg.isTxConfirm) {
+            ++confirmations;            // Already counted as a TX request
+        } else {
+            ++rxFrames;
+            rxBytes += static_cast<uint64_t>(msg.isRemote ? 0 : msg.dataLength());
+            countFrame(msg);
+        }
+    }
+
+    if (rxFrames > 0) {
+        m_rxFrames.fetch_add(rxFrames, std::memory_order_relaxed);
+        m_rxBytes.fetch_add(rxBytes, std::memory_order_relaxed);
+    }
+    if (confirmations > 0)
+        m_txConfirmations.fetch_add(confirmations, std::memory_order_relaxed);
+    if (errors > 0) {
+        m_errorFrames.fetch_add(errors, std::memory_order_relaxed);
+        if (m_bitrate > 0)
+            m_busTimeNs.fetch_add(errors * ERROR_FRAME_BITS * 1000000000ULL / static_cast<uint64_t>(m_bitrate),
+                                  std::memory_order_relaxed);
+    }
+}
+
+void CANBusStatistics::onTransmitted(const CANMessage* frames, int count, int accepted)
+{
+    accepted = std::clamp(accepted, 0, count);
+    uint64_t txBytes = 0;
+    for (int i = 0; i < accepted; ++i) {
+        txBytes += static_cast<uint64_t>(frames[i].isRemote ? 0 : frames[i].dataLength());
+        countFrame(frames[i]);
+    }
+
+    if (accepted > 0) {
+        m_txRequests.fetch_add(static_cast<uint64_t>(accepted), std::memory_order_relaxed);
+        m_txBytes.fetch_add(txBytes, std::memory_order_relaxed);
+    }
+    if (accepted < count)
+        m_txRejected.fetch_add(static_cast<uint64_t>(count - accepted), std::memory_order_relaxed);
+}
+
+void CANBusStatistics::updateQueueHighWater(size_t rxQueue, size_t subscription)
+{
+    raise(m_rxQueueHighWater, rxQueue);
+    raise(m_subscriptionHighWater, subscription);
+}
+
+void CANBusStatistics::raise(std::atomic<uint64_t>& highWater, uint64_t value)
+{
+    uint64_t seen = highWater.load(std::memory_order_relaxed);
+    while (value > seen && !highWater.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+// ============================================================================
+//  Sampling
+// ============================================================================
+
+CANBusStatistics::Totals CANBusStatistics::totals() const
+{
+    Totals t;
+    t.rxFrames    = m_rxFrames.load(std::memory_order_relaxed);
+    t.txFrames    = m_txRequests.load(std::memory_order_relaxed);
+    t.bytes       = m_rxBytes.load(std::memory_order_relaxed) + m_txBytes.load(std::memory_order_relaxed);
+    t.errorFrames = m_errorFrames.load(std::memory_order_relaxed);
+    t.busTimeNs   = m_busTimeNs.load(std::memory_order_relaxed);
+    return t;
+}
+
+void CANBusStatistics::sampleIfDue()
+{
+    const Clock::time_point now = Clock::now();
+    if (nanosSinceEpoch(now) < m_nextSampleNs.load(std::memory_order_relaxed))
+        return;
+
+    QMutexLocker locker(&m_sampleMutex);
+    const double periodS = std::chrono::duration<double>(now - m_lastSampleTime).count();
+    if (periodS <= 0.0)
+        return;
+
+    const Totals t = totals();
+    Sample sample;
+    sample.timeS                = std::chrono::duration<double>(now - m_start).count();
+    sample.rxFramesPerSecond    = (t.rxFrames - m_lastTotals.rxFrames) / periodS;
+    sample.txFramesPerSecond    = (t.txFrames - m_lastTotals.txFrames) / periodS;
+    sample.bytesPerSecond       = (t.bytes - m_lastTotals.bytes) / periodS;
+    sample.errorFramesPerSecond = (t.errorFrames - m_lastTotals.errorFrames) / periodS;
+    sample.busLoadPercent       = (t.busTimeNs - m_lastTotals.busTimeNs) / (periodS * 1e7);
+
+    for (int i = 0; i < ID_TABLE_SIZE; ++i) {
+        IdCounter& counter = m_ids[i];
+        if (counter.key.load(std::memory_order_relaxed) == 0)
+            continue;
+        const uint64_t frames = counter.frames.load(std::memory_order_relaxed);
+        counter.framesPerSecond = (frames - counter.lastFrames) / periodS;
+        counter.lastFrames = frames;
+    }
+
+    m_lastTotals = t;
+    m_lastSampleTime = now;
+    m_peakBusLoad = std::max(m_peakBusLoad, sample.busLoadPercent);
+    m_current = sample;
+    m_history[static_cast<size_t>(m_historyNext)] = sample;
+    m_historyNext = (m_historyNext + 1) % HISTORY_SIZE;
+    m_historyCount = std::min(m_historyCount + 1, HISTORY_SIZE);
+    m_nextSampleNs.store(nanosSinceEpoch(now + std::chrono::milliseconds(SAMPLE_INTERVAL_MS)),
+                         std::memory_order_relaxed);
+}
+
+CANBusStatistics::Snapshot CANBusStatistics::snapshot() const
+{
+    Snapshot s;
+    s.bitrate     = m_bitrate;
+    s.dataBitrate = m_dataBitrate;
+
+    s.rxFrames        = m_rxFrames.load(std::memory_order_relaxed);
+    s.rxBytes         = m_rxBytes.load(std::memory_order_relaxed);
+    s.txRequests      = m_txRequests.load(std::memory_order_relaxed);
+    s.txBytes         = m_txBytes.load(std::memory_order_relaxed);
+    s.txRejected      = m_txRejected.load(std::memory_order_relaxed);
+    s.txConfirmations = m_txConfirmations.load(std::memory_order_relaxed);
+    s.errorFrames     = m_errorFrames.load(std::memory_order_relaxed);
+    s.untrackedFrames = m_untrackedFrames.load(std::memory_order_relaxed);
+
+    s.rxBatchHighWater      = static_cast<int>(m_rxBatchHighWater.load(std::memory_order_relaxed));
+    s.rxQueueHighWater      = static_cast<size_t>(m_rxQueueHighWater.load(std::memory_order_relaxed));
+    s.subscriptionHighWater = static_cast<size_t>(m_subscriptionHighWater.load(std::memory_order_relaxed));
+
+    QMutexLocker locker(&m_sampleMutex);
+    s.elapsedS = std::chrono::duration<double>(Clock::now() - m_start).count();
+    if (s.elapsedS > 0.0)
+        s.meanBusLoadPercent = m_busTimeNs.load(std::memory_order_relaxed) / (s.elapsedS * 1e7);
+    s.current = m_current;
+    s.peakBusLoadPercent = m_peakBusLoad;
+
+    for (int i = 0; i < ID_TABLE_SIZE; ++i) {
+        const IdCounter& counter = m_ids[i];
+        const uint32_t key = counter.key.load(std::memory_order_acquire);
+        const uint64_t frames = counter.frames.load(std::memory_order_relaxed);
+        if (key == 0 || frames == 0)
+            continue;
+        IdStats id;
+        id.id = key & 0x1FFFFFFF;
+        id.extended = (key & KEY_EXTENDED) != 0;
+        id.frames = frames;
+        id.framesPerSecond = counter.framesPerSecond;
+        s.ids.append(id);
+    }
+    std::sort(s.ids.begin(), s.ids.end(), [](const IdStats& a, const IdStats& b) {
+        if (a.framesPerSecond != b.framesPerSecond)
+            return a.framesPerSecond > b.framesPerSecond;
+        return a.frames > b.frames;
+    });
+    return s;
+}
+
+QList<CANBusStatistics::Sample> CANBusStatistics::history() const
+{
+    QMutexLocker locker(&m_sampleMutex);
+    QList<Sample> samples;
+    samples.reserve(m_historyCount);
+    const int first = (m_historyNext - m_historyCount + HISTORY_SIZE) % HISTORY_SIZE;
+    for (int i = 0; i < m_historyCount; ++i)
+        samples.append(m_history[static_cast<size_t>((first + i) % HISTORY_SIZE)]);
+    return samples;
+}
+
+void CANBusStatistics::reset()
+{
+    QMutexLocker locker(&m_sampleMutex);
+
+    // Frames counted concurrently with the reset may land on either side of it
+    for (auto* counter : {&m_rxFrames, &m_rxBytes, &m_txRequests, &m_txBytes, &m_txRejected,
+                          &m_txConfirmations, &m_errorFrames, &m_untrackedFrames, &m_busTimeNs,
+                          &m_rxBatchHighWater, &m_rxQueueHighWater, &m_subscriptionHighWater})
+        counter->store(0, std::memory_order_relaxed);
+    for (int i = 0; i < ID_TABLE_SIZE; ++i) {
+        m_ids[i].frames.store(0, std::memory_order_relaxed);
+        m_ids[i].lastFrames = 0;
+        m_ids[i].framesPerSecond = 0.0;
+    }
+
+    m_start = m_lastSampleTime = Clock::now();
+    m_nextSampleNs.store(nanosSinceEpoch(m_start + std::chrono::milliseconds(SAMPLE_INTERVAL_MS)),
+                         std::memory_order_relaxed);
+    m_lastTotals = Totals{};
+    m_peakBusLoad = 0.0;
+    m_current = Sample{};
+    m_historyNext = 0;
+    m_historyCount = 0;
+}
+
+} // namespace CANManager
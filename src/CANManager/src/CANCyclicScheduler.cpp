@@ -0,0 +1,375 @@
+/**
+ * @file CANCyclicScheduler.cpp
+ * @brief Per-slot periodic transmit scheduler — implementation.
+ */
+
+#include "CANCyclicScheduler.h"
+
+#include <QDeadlineTimer>
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+namespace CANManager {
+
+static double toMicros(std::chrono::steady_clock::duration d)
+{
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+// ============================================================================
+//  Constructor / Destructor
+// ============================================================================
+
+CANCyclicScheduler::CANCyclicScheduler(ICANDriver* driver, QMutex* txMutex, const QString& slotName,
+                                       CANBusStatistics* statistics)
+    : m_driver(driver)
+    , m_txMutex(txMutex)
+    , m_statistics(statistics)
+    , m_slotName(slotName)
+    , m_wheel(WHEEL_SIZE)
+{
+}
+
+CANCyclicScheduler::~CANCyclicScheduler()
+{
+    shutdown();
+}
+
+void CANCyclicScheduler::shutdown()
+{
+    QThread* thread = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_jobs.clear();
+        for (auto& bucket : m_wheel)
+            bucket.clear();
+        m_wake.wakeAll();
+        std::swap(thread, m_thread);
+    }
+
+    // The thread may be finishing a transmit; it exits before touching the driver again
+    if (thread) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+// ============================================================================
+//  Jobs
+// ============================================================================
+
+CANResult CANCyclicScheduler::start(const CANMessage& msg, int periodMs, int offsetMs)
+{
+    if (periodMs < 1)
+        return CANResult::Failure("Cyclic period must be at least 1 ms");
+    if (offsetMs < 0)
+        return CANResult::Failure("Cyclic offset must not be negative");
+
+    QMutexLocker locker(&m_mutex);
+    if (m_stopping)
+        return CANResult::Failure("Slot closed");
+
+    const uint64_t key = keyOf(msg.id, msg.isExtended);
+    auto it = m_jobs.find(key);
+    if (it != m_jobs.end()) {
+        eraseLocked(it->second.get());
+        m_jobs.erase(it);
+    }
+
+    // An idle thread has not advanced m_lastTick; restart the wheel at "now"
+    if (m_jobs.empty())
+        m_lastTick = std::max(m_lastTick, tickNow());
+
+    auto job = std::make_unique<Job>();
+    job->msg            = msg;
+    job->periodTicks    = std::chrono::milliseconds(periodMs) / TICK;
+    job->nextTick       = std::max(tickNow(), m_lastTick) + 1 + std::chrono::milliseconds(offsetMs) / TICK;
+    job->generation     = ++m_generation;
+    job->stats.periodMs = periodMs;
+
+    insertLocked(job.get());
+    m_jobs.emplace(key, std::move(job));
+
+    if (!m_thread) {
+        m_thread = QThread::create([this]() { run(); });
+        m_thread->setObjectName(QStringLiteral("CAN_CYCLIC_%1").arg(m_slotName));
+        m_thread->start(QThread::TimeCriticalPriority);
+    }
+    m_wake.wakeAll();
+
+    qDebug() << "[CANCyclic]" << m_slotName << "started" << CANIdFilter::exact(msg.id).toString()
+             << "every" << periodMs << "ms";
+    return CANResult::Success();
+}
+
+CANResult CANCyclicScheduler::update(const CANMessage& msg)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_jobs.find(keyOf(msg.id, msg.isExtended));
+    if (it == m_jobs.end())
+        return CANResult::Failure(QString("No cyclic frame with CAN ID %1 on slot '%2'")
+                                      .arg(CANIdFilter::exact(msg.id).toString(), m_slotName));
+
+    // The next batch copies the frame under this lock: old or new payload, never torn
+    it->second->msg = msg;
+    return CANResult::Success();
+}
+
+CANResult CANCyclicScheduler::stop(uint32_t id, bool extended, Stats* stats)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // Let a batch on the wire finish and be counted before the final statistics
+    waitUntilIdleLocked();
+
+    auto it = m_jobs.find(keyOf(id, extended));
+    if (it == m_jobs.end())
+        return CANResult::Failure(QString("No cyclic frame with CAN ID %1 on slot '%2'")
+                                      .arg(CANIdFilter::exact(id).toString(), m_slotName));
+
+    if (stats)
+        finishStats(*it->second, *stats);
+    eraseLocked(it->second.get());
+    m_jobs.erase(it);
+    m_wake.wakeAll();
+
+    qDebug() << "[CANCyclic]" << m_slotName << "stopped" << CANIdFilter::exact(id).toString();
+    return CANResult::Success();
+}
+
+void CANCyclicScheduler::stopAll()
+{
+    QMutexLocker locker(&m_mutex);
+    waitUntilIdleLocked();
+    m_jobs.clear();
+    for (auto& bucket : m_wheel)
+        bucket.clear();
+    m_wake.wakeAll();
+}
+
+void CANCyclicScheduler::waitUntilIdleLocked()
+{
+    while (m_sending)
+        m_idle.wait(&m_mutex);
+}
+
+bool CANCyclicScheduler::stats(uint32_t id, bool extended, Stats& stats) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_jobs.find(keyOf(id, extended));
+    if (it == m_jobs.end())
+        return false;
+
+    finishStats(*it->second, stats);
+    return true;
+}
+
+int CANCyclicScheduler::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_jobs.size());
+}
+
+// ============================================================================
+//  Clock
+// ============================================================================
+
+int64_t CANCyclicScheduler::tickNow() const
+{
+    return (Clock::now() - m_epoch) / TICK;
+}
+
+CANCyclicScheduler::Clock::time_point CANCyclicScheduler::tickTime(int64_t tick) const
+{
+    return m_epoch + std::chrono::duration_cast<Clock::duration>(tick * TICK);
+}
+
+// ============================================================================
+//  Timer Wheel
+// ============================================================================
+
+void CANCyclicScheduler::insertLocked(Job* job)
+{
+    m_wheel[job->nextTick & (WHEEL_SIZE - 1)].push_back(job);
+}
+
+void CANCyclicScheduler::eraseLocked(Job* job)
+{
+    auto& bucket = m_wheel[job->nextTick & (WHEEL_SIZE - 1)];
+    bucket.erase(std::remove(bucket.begin(), bucket.end(), job), bucket.end());
+}
+
+int64_t CANCyclicScheduler::nextDueTickLocked() const
+{
+    // Every job is due after m_lastTick; the first bucket holding a job for
+    // its own tick is the next deadline. Nothing within one turn of the
+    // wheel: wake at the end of the turn and look again.
+    for (int64_t tick = m_lastTick + 1; tick <= m_lastTick + WHEEL_SIZE; ++tick) {
+        for (const Job* job : m_wheel[tick & (WHEEL_SIZE - 1)]) {
+            if (job->nextTick == tick)
+                return tick;
+        }
+    }
+    return m_lastTick + WHEEL_SIZE;
+}
+
+void CANCyclicScheduler::collectDueLocked(int64_t upToTick, std::vector<Due>& due,
+                                          std::vector<CANMessage>& frames)
+{
+    due.clear();
+    frames.clear();
+
+    std::vector<Job*> jobs;
+    const int64_t last = std::min(upToTick, m_lastTick + WHEEL_SIZE);
+    for (int64_t tick = m_lastTick + 1; tick <= last; ++tick) {
+        for (Job* job : m_wheel[tick & (WHEEL_SIZE - 1)]) {
+            if (job->nextTick <= upToTick)
+                jobs.push_back(job);
+        }
+    }
+
+    // Oldest deadline first, so a catch-up batch keeps the bus order
+    std::sort(jobs.begin(), jobs.end(), [](const Job* a, const Job* b) {
+        return a->nextTick < b->nextTick;
+    });
+
+    for (Job* job : jobs) {
+        due.push_back({keyOf(job->msg.id, job->msg.isExtended), job->generation, job->nextTick});
+        frames.push_back(job->msg);
+
+        // Advance on the absolute grid; cycles already in the past are skipped
+        eraseLocked(job);
+        job->nextTick += job->periodTicks;
+        if (job->nextTick <= upToTick) {
+            const int64_t behind = (upToTick - job->nextTick) / job->periodTicks + 1;
+            job->nextTick += behind * job->periodTicks;
+            job->stats.missed += static_cast<uint64_t>(behind);
+        }
+        insertLocked(job);
+    }
+}
+
+// ============================================================================
+//  Scheduler Thread
+// ============================================================================
+
+void CANCyclicScheduler::run()
+{
+#ifdef _WIN32
+    // The default 15.6 ms system timer would swamp millisecond periods
+    timeBeginPeriod(1);
+#endif
+
+    std::vector<Due> due;
+    std::vector<CANMessage> frames;
+
+    QMutexLocker locker(&m_mutex);
+    while (!m_stopping) {
+        if (m_jobs.empty()) {
+            m_wake.wait(&m_mutex);
+            continue;
+        }
+
+        // Sleep to the absolute deadline; start/stop wake us to re-plan
+        const int64_t nextTick = nextDueTickLocked();
+        if (tickNow() < nextTick) {
+            m_wake.wait(&m_mutex, QDeadlineTimer(tickTime(nextTick), Qt::PreciseTimer));
+            continue;
+        }
+
+        const int64_t now = tickNow();
+        collectDueLocked(now, due, frames);
+        m_lastTick = now;
+        if (frames.empty())
+            continue;
+
+        m_sending = true;
+        locker.unlock();
+        int sent = 0;
+        CANResult result;
+        Clock::time_point sendTime;
+        {
+            QMutexLocker txLocker(m_txMutex);
+            sendTime = Clock::now();
+            result = m_driver->transmitBatch(frames, sent);
+        }
+        if (m_statistics)
+            m_statistics->onTransmitted(frames.data(), static_cast<int>(frames.size()), sent);
+        locker.relock();
+        m_sending = false;
+        m_idle.wakeAll();
+
+        recordLocked(due, sent, sendTime, result.success ? QString() : result.errorMessage);
+    }
+
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+// ============================================================================
+//  Statistics
+// ============================================================================
+
+void CANCyclicScheduler::recordLocked(const std::vector<Due>& due, int sent,
+                                      Clock::time_point sendTime, const QString& error)
+{
+    for (int i = 0; i < static_cast<int>(due.size()); ++i) {
+        auto it = m_jobs.find(due[i].key);
+        if (it == m_jobs.end() || it->second->generation != due[i].generation)
+            continue;   // Stopped or restarted while the batch was on the wire
+
+        Job& job = *it->second;
+        Stats& stats = job.stats;
+
+        if (i >= sent) {
+            ++stats.errors;
+            stats.lastError = error;
+            job.lastSend = {};     // Don't measure a period across the failed cycle
+            continue;
+        }
+
+        ++stats.sent;
+        stats.maxLatenessUs = std::max(stats.maxLatenessUs,
+                                       toMicros(sendTime - tickTime(due[i].tick)));
+
+        if (job.lastSend != Clock::time_point{}) {
+            const double periodUs = toMicros(sendTime - job.lastSend);
+            const double jitterUs = periodUs - stats.periodMs * 1000.0;
+
+            stats.minPeriodUs = job.periodCount ? std::min(stats.minPeriodUs, periodUs) : periodUs;
+            stats.maxPeriodUs = std::max(stats.maxPeriodUs, periodUs);
+            stats.maxAbsJitterUs = std::max(stats.maxAbsJitterUs, std::abs(jitterUs));
+
+            // Sums of the deviation from nominal keep the variance numerically stable
+            job.jitterSumUs   += jitterUs;
+            job.jitterSqSumUs += jitterUs * jitterUs;
+            ++job.periodCount;
+        }
+        job.lastSend = sendTime;
+    }
+}
+
+void CANCyclicScheduler::finishStats(const Job& job, Stats& stats)
+{
+    stats = job.stats;
+    if (job.periodCount == 0)
+        return;
+
+    const double n = static_cast<double>(job.periodCount);
+    const double meanJitterUs = job.jitterSumUs / n;
+    stats.meanPeriodUs   = stats.periodMs * 1000.0 + meanJitterUs;
+    stats.jitterStdDevUs = std::sqrt(std::max(0.0, job.jitterSqSumUs / n - meanJitterUs * meanJitterUs));
+}
+
+} // namespace CANManager
@@ -0,0 +1,511 @@
+/**
+ * @file CANGateway.cpp
+ * @brief One-way CAN gateway between two slots — implementation.
+ */
+
+#include "CANGateway.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+namespace CANManager {
+
+namespace {
+
+constexpr uint32_t EXACT_MASK = 0x1FFFFFFF;
+
+bool parseHexValue(const QJsonValue& value, uint32_t& out)
+{
+    if (value.isDouble()) {
+        const double number = value.toDouble();
+        if (number < 0 || number > EXACT_MASK || number != std::floor(number))
+            return false;
+        out = static_cast<uint32_t>(number);
+        return true;
+    }
+    QString text = value.toString().trimmed();
+    if (text.startsWith("0x", Qt::CaseInsensitive))
+        text = text.mid(2);
+    bool ok = false;
+    out = text.toUInt(&ok, 16);
+    return ok && out <= EXACT_MASK;
+}
+
+CANResult parseRule(const QJsonObject& object, int index, CANGateway::Rule& rule)
+{
+    auto fail = [index](const QString& message) {
+        return CANResult::Failure(QString("Gateway rule %1: %2").arg(index + 1).arg(message));
+    };
+
+    rule.name = object.value("name").toString();
+    if (!object.contains("id"))
+        return fail("missing \"id\"");
+    if (!parseHexValue(object.value("id"), rule.match.id))
+        return fail("invalid \"id\"");
+    if (object.contains("mask") && !parseHexValue(object.value("mask"), rule.match.mask))
+        return fail("invalid \"mask\"");
+    if (object.contains("extended")) {
+        rule.match.anyFormat = false;
+        rule.match.extended  = object.value("extended").toBool();
+    }
+
+    const QString action = object.value("action").toString("forward").toLower();
+    if (action == "forward")
+        rule.action = CANGateway::Action::Forward;
+    else if (action == "block")
+        rule.action = CANGateway::Action::Block;
+    else
+        return fail(QString("unknown action \"%1\"").arg(action));
+
+    const double delayMs = object.value("delay_ms").toDouble(0.0);
+    if (delayMs < 0)
+        return fail("negative \"delay_ms\"");
+    rule.delayUs = static_cast<int>(std::lround(delayMs * 1000.0));
+
+    if (object.contains("new_id")) {
+        rule.rewriteId = true;
+        if (!parseHexValue(object.value("new_id"), rule.newId))
+            return fail("invalid \"new_id\"");
+    }
+
+    if (object.contains("data")) {
+        rule.dataValue = QByteArray::fromHex(object.value("data").toString().toLatin1());
+        rule.dataMask = object.contains("data_mask")
+                            ? QByteArray::fromHex(object.value("data_mask").toString().toLatin1())
+                            : QByteArray(rule.dataValue.size(), char(0xFF));
+    }
+
+    const QJsonObject signalObject = object.value("signals").toObject();
+    for (const QString& name : signalObject.keys())
+        rule.signalValues.insert(name, signalObject.value(name).toDouble());
+    return CANResult::Success();
+}
+
+} // namespace
+
+// ============================================================================
+//  Lifecycle
+// ============================================================================
+
+CANGateway::CANGateway(const Options& options, std::shared_ptr<CANRxDispatcher::Subscription> source,
+                       Transmit transmit)
+    : m_options(options)
+    , m_source(std::move(source))
+    , m_transmit(std::move(transmit))
+{
+}
+
+CANGateway::~CANGateway()
+{
+    stop();
+}
+
+CANResult CANGateway::start()
+{
+    if (m_thread)
+        return CANResult::Failure("Gateway already started");
+    if (!m_source || !m_transmit)
+        return CANResult::Failure("Gateway has no source or destination");
+
+    CANResult result = compile();
+    if (!result.success)
+        return result;
+
+    m_stopping.store(false);
+    m_running.store(true);
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->setObjectName(QStringLiteral("CAN_GATEWAY_%1_%2").arg(m_options.source, m_options.destination));
+    m_thread->start(QThread::TimeCriticalPriority);
+
+    qDebug() << "[CANGateway]" << m_options.source << "->" << m_options.destination
+             << "started with" << m_options.rules.size() << "rules";
+    return CANResult::Success();
+}
+
+void CANGateway::stop()
+{
+    if (!m_thread)
+        return;
+
+    m_stopping.store(true, std::memory_order_release);
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    m_running.store(false);
+}
+
+// ============================================================================
+//  Rule table
+// ============================================================================
+
+CANResult CANGateway::compile()
+{
+    const int ruleCount = static_cast<int>(m_options.rules.size());
+
+    m_rules.clear();
+    m_rules.reserve(static_cast<size_t>(ruleCount));
+    for (int r = 0; r < ruleCount; ++r) {
+        Rule& rule = m_options.rules[r];
+        if (rule.name.isEmpty())
+            rule.name = rule.match.toString();
+
+        auto fail = [&rule](const QString& message) {
+            return CANResult::Failure(QString("Gateway rule '%1': %2").arg(rule.name, message));
+        };
+        if (!rule.signalValues.isEmpty())
+            return fail("signal values must be resolved to a data mask (DBC) first");
+        if (rule.dataMask.size() != rule.dataValue.size())
+            return fail("data and data mask differ in length");
+        if (rule.dataMask.size() > 64)
+            return fail("payload rewrite longer than 64 bytes");
+        if (rule.delayUs < 0)
+            return fail("negative delay");
+        if (rule.newId > EXACT_MASK)
+            return fail("invalid new ID");
+
+        CompiledRule compiled{};
+        compiled.action        = rule.action;
+        compiled.delay         = std::chrono::microseconds(rule.delayUs);
+        compiled.rewriteId     = rule.rewriteId;
+        compiled.newId         = rule.newId;
+        compiled.rewriteLength = static_cast<int>(rule.dataMask.size());
+        for (int i = 0; i < compiled.rewriteLength; ++i) {
+            compiled.mask[i]  = static_cast<uint8_t>(rule.dataMask[i]);
+            compiled.value[i] = static_cast<uint8_t>(rule.dataValue[i]);
+        }
+        m_rules.push_back(compiled);
+    }
+
+    auto firstMatch = [this, ruleCount](uint32_t id, bool extended) {
+        for (int r = 0; r < ruleCount; ++r) {
+            if (m_options.rules[r].match.matchesId(id, extended))
+                return r;
+        }
+        return -1;
+    };
+
+    m_standard.assign(CANRxDispatcher::STANDARD_ID_COUNT, -1);
+    for (uint32_t id = 0; id < CANRxDispatcher::STANDARD_ID_COUNT; ++id)
+        m_standard[id] = firstMatch(id, false);
+
+    // The rewritten frame keeps its format: a standard frame cannot take a 29-bit ID
+    for (int r : m_standard) {
+        if (r < 0)
+            continue;
+        const Rule& rule = m_options.rules[r];
+        if (rule.rewriteId && rule.newId >= CANRxDispatcher::STANDARD_ID_COUNT)
+            return CANResult::Failure(
+                QString("Gateway rule '%1': new ID 0x%2 does not fit the standard frames it matches")
+                    .arg(rule.name).arg(rule.newId, 0, 16));
+    }
+
+    // Exact extended IDs resolve through the hash, with any earlier mask rule
+    // that also covers the ID taken into account; other extended IDs only
+    // need the mask rules
+    m_extended.clear();
+    m_extendedMasked.clear();
+    for (int r = 0; r < ruleCount; ++r) {
+        const CANIdFilter& match = m_options.rules[r].match;
+        if (!match.anyFormat && !match.extended)
+            continue;
+        if (match.mask == EXACT_MASK)
+            m_extended.try_emplace(match.id, firstMatch(match.id, true));
+        else
+            m_extendedMasked.push_back(r);
+    }
+
+    m_ruleCounters.reset(new RuleCounters[static_cast<size_t>(ruleCount) + 1]);
+    return CANResult::Success();
+}
+
+int CANGateway::ruleFor(const CANMessage& msg) const
+{
+    if (!msg.isExtended) {
+        if (msg.id < CANRxDispatcher::STANDARD_ID_COUNT)
+            return m_standard[msg.id];
+    } else {
+        auto it = m_extended.find(msg.id);
+        if (it != m_extended.end())
+            return it->second;
+        for (int r : m_extendedMasked) {
+            if (m_options.rules[r].match.matchesId(msg.id, true))
+                return r;
+        }
+        return -1;
+    }
+
+    // Out-of-range standard ID (malformed frame): plain scan
+    for (int r = 0; r < static_cast<int>(m_options.rules.size()); ++r) {
+        if (m_options.rules[r].match.matchesId(msg.id, false))
+            return r;
+    }
+    return -1;
+}
+
+CANGateway::RuleCounters& CANGateway::countersFor(int rule)
+{
+    return m_ruleCounters[rule < 0 ? m_options.rules.size() : rule];
+}
+
+// ============================================================================
+//  Forwarding thread
+// ============================================================================
+
+void CANGateway::run()
+{
+#ifdef _WIN32
+    // Delay rules and the source wait need millisecond timer resolution
+    timeBeginPeriod(1);
+#endif
+
+    std::vector<CANMessage> incoming(MAX_BATCH);
+    std::vector<Clock::time_point> arrivals(MAX_BATCH);
+    std::vector<CANMessage> out;
+    std::vector<int> outRules;
+    std::vector<Clock::time_point> outArrivals;
+    out.reserve(2 * MAX_BATCH);
+    outRules.reserve(2 * MAX_BATCH);
+    outArrivals.reserve(2 * MAX_BATCH);
+
+    std::priority_queue<Delayed, std::vector<Delayed>, std::greater<>> held;
+    uint64_t sequence = 0;
+
+    while (!m_stopping.load(std::memory_order_acquire)) {
+        int timeoutMs = POLL_INTERVAL_MS;
+        if (!held.empty()) {
+            const auto untilDue = std::chrono::ceil<std::chrono::milliseconds>(held.top().due - Clock::now());
+            timeoutMs = static_cast<int>(std::clamp<int64_t>(untilDue.count(), 0, POLL_INTERVAL_MS));
+        }
+        if (timeoutMs > 0) {
+            if (!m_source->isClosed()) {
+                m_source->waitForFrames(timeoutMs);
+            } else if (m_source->pending() == 0) {
+                // Source slot closed and drained: release what is held, then end
+                if (held.empty())
+                    break;
+                QThread::msleep(static_cast<unsigned long>(timeoutMs));
+            }
+        }
+
+        const int count = m_source->take(incoming.data(), arrivals.data(), MAX_BATCH);
+        const Clock::time_point now = Clock::now();
+        out.clear();
+        outRules.clear();
+        outArrivals.clear();
+
+        // Held frames that are due go first: they arrived before this batch
+        while (!held.empty() && held.top().due <= now) {
+            out.push_back(held.top().msg);
+            outRules.push_back(held.top().rule);
+            outArrivals.push_back(now);
+            held.pop();
+        }
+        const size_t undelayedFrom = out.size();
+
+        for (int i = 0; i < count; ++i) {
+            CANMessage msg = incoming[static_cast<size_t>(i)];
+            const Clock::time_point arrival = arrivals[static_cast<size_t>(i)];
+            if (msg.isError || msg.isTxConfirm)
+                continue;
+            m_received.fetch_add(1, std::memory_order_relaxed);
+
+            const int r = ruleFor(msg);
+            RuleCounters& counters = countersFor(r);
+            counters.matched.fetch_add(1, std::memory_order_relaxed);
+
+            const CompiledRule* rule = r < 0 ? nullptr : &m_rules[static_cast<size_t>(r)];
+            const Action action = rule ? rule->action : m_options.defaultAction;
+            if (action == Action::Block) {
+                m_blocked.fetch_add(1, std::memory_order_relaxed);
+                counters.dropped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            if (rule) {
+                if (rule->rewriteId)
+                    msg.id = rule->newId;
+                if (!msg.isRemote) {
+                    const int n = std::min(rule->rewriteLength, msg.dataLength());
+                    for (int b = 0; b < n; ++b)
+                        msg.data[b] = static_cast<uint8_t>((msg.data[b] & ~rule->mask[b]) | (rule->value[b] & rule->mask[b]));
+                }
+                if (rule->delay.count() > 0) {
+                    if (held.size() >= MAX_DELAYED) {
+                        m_delayOverflows.fetch_add(1, std::memory_order_relaxed);
+                        counters.dropped.fetch_add(1, std::memory_order_relaxed);
+                    } else {
+                        held.push({arrival + rule->delay, sequence++, r, msg});
+                        m_delayed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    continue;
+                }
+            }
+            out.push_back(msg);
+            outRules.push_back(r);
+            outArrivals.push_back(arrival);
+        }
+
+        if (!out.empty())
+            send(out, outRules, outArrivals, undelayedFrom);
+    }
+
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+    m_running.store(false);
+}
+
+void CANGateway::send(std::vector<CANMessage>& frames, std::vector<int>& rules,
+                      const std::vector<Clock::time_point>& arrivals, size_t undelayedFrom)
+{
+    const int count = static_cast<int>(frames.size());
+    int sent = 0;
+    const CANResult result = m_transmit(frames, sent);
+    const Clock::time_point done = Clock::now();
+    sent = std::clamp(sent, 0, count);
+
+    for (int i = 0; i < count; ++i) {
+        RuleCounters& counters = countersFor(rules[static_cast<size_t>(i)]);
+        if (i < sent)
+            counters.forwarded.fetch_add(1, std::memory_order_relaxed);
+        else
+            counters.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_forwarded.fetch_add(static_cast<uint64_t>(sent), std::memory_order_relaxed);
+
+    // Undelayed frames only: measured from when the source dispatcher read
+    // them, so time spent queued for the gateway thread is included
+    const int undelayedSent = sent - static_cast<int>(undelayedFrom);
+    if (undelayedSent > 0) {
+        uint64_t sumNs = 0;
+        uint64_t maxNs = 0;
+        for (int i = static_cast<int>(undelayedFrom); i < sent; ++i) {
+            const auto latencyNs = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(done - arrivals[static_cast<size_t>(i)]).count());
+            sumNs += latencyNs;
+            maxNs = std::max(maxNs, latencyNs);
+        }
+        m_latencySumNs.fetch_add(sumNs, std::memory_order_relaxed);
+        m_latencyCount.fetch_add(static_cast<uint64_t>(undelayedSent), std::memory_order_relaxed);
+        if (maxNs > m_latencyMaxNs.load(std::memory_order_relaxed))
+            m_latencyMaxNs.store(maxNs, std::memory_order_relaxed);
+    }
+
+    if (sent < count) {
+        m_txErrors.fetch_add(static_cast<uint64_t>(count - sent), std::memory_order_relaxed);
+        QMutexLocker locker(&m_errorMutex);
+        m_lastError = result.success ? QStringLiteral("Destination accepted only part of a batch")
+                                     : result.errorMessage;
+    }
+}
+
+// ============================================================================
+//  Statistics
+// ============================================================================
+
+CANGateway::Stats CANGateway::stats() const
+{
+    Stats s;
+    s.running        = m_running.load();
+    s.source         = m_options.source;
+    s.destination    = m_options.destination;
+    s.received       = m_received.load(std::memory_order_relaxed);
+    s.forwarded      = m_forwarded.load(std::memory_order_relaxed);
+    s.blocked        = m_blocked.load(std::memory_order_relaxed);
+    s.delayed        = m_delayed.load(std::memory_order_relaxed);
+    s.txErrors       = m_txErrors.load(std::memory_order_relaxed);
+    s.delayOverflows = m_delayOverflows.load(std::memory_order_relaxed);
+    s.overruns       = m_source ? m_source->overruns() : 0;
+
+    const uint64_t latencies = m_latencyCount.load(std::memory_order_relaxed);
+    if (latencies > 0)
+        s.meanLatencyUs = m_latencySumNs.load(std::memory_order_relaxed) / 1000.0 / latencies;
+    s.maxLatencyUs = m_latencyMaxNs.load(std::memory_order_relaxed) / 1000.0;
+
+    auto ruleStats = [](const QString& name, const RuleCounters& counters) {
+        RuleStats rs;
+        rs.name      = name;
+        rs.matched   = counters.matched.load(std::memory_order_relaxed);
+        rs.forwarded = counters.forwarded.load(std::memory_order_relaxed);
+        rs.dropped   = counters.dropped.load(std::memory_order_relaxed);
+        return rs;
+    };
+    if (m_ruleCounters) {
+        for (int r = 0; r < m_options.rules.size(); ++r)
+            s.rules.append(ruleStats(m_options.rules[r].name, m_ruleCounters[r]));
+        s.defaultRule = ruleStats(QStringLiteral("default"), m_ruleCounters[m_options.rules.size()]);
+    }
+
+    QMutexLocker locker(&m_errorMutex);
+    s.lastError = m_lastError;
+    return s;
+}
+
+// ============================================================================
+//  Rule files
+// ============================================================================
+
+CANResult CANGateway::parseRules(const QByteArray& json, Options& options)
+{
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+    if (error.error != QJsonParseError::NoError)
+        return CANResult::Failure("Invalid gateway rules: " + error.errorString());
+
+    QJsonArray ruleArray;
+    Action defaultAction = Action::Forward;
+    if (doc.isArray()) {
+        ruleArray = doc.array();
+    } else if (doc.isObject()) {
+        const QJsonObject root = doc.object();
+        const QString fallback = root.value("default").toString("forward").toLower();
+        if (fallback == "block")
+            defaultAction = Action::Block;
+        else if (fallback != "forward")
+            return CANResult::Failure(QString("Invalid gateway rules: unknown default \"%1\"").arg(fallback));
+        if (root.contains("source"))
+            options.source = root.value("source").toString();
+        if (root.contains("destination"))
+            options.destination = root.value("destination").toString();
+        ruleArray = root.value("rules").toArray();
+    } else {
+        return CANResult::Failure("Invalid gateway rules: expected an object or an array");
+    }
+
+    QList<Rule> rules;
+    for (int i = 0; i < ruleArray.size(); ++i) {
+        if (!ruleArray.at(i).isObject())
+            return CANResult::Failure(QString("Gateway rule %1: not an object").arg(i + 1));
+        Rule rule;
+        CANResult result = parseRule(ruleArray.at(i).toObject(), i, rule);
+        if (!result.success)
+            return result;
+        rules.append(rule);
+    }
+
+    options.rules = rules;
+    options.defaultAction = defaultAction;
+    return CANResult::Success();
+}
+
+CANResult CANGateway::loadRules(const QString& path, Options& options)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return CANResult::Failure(QString("Cannot open gateway rule file %1: %2").arg(path, file.errorString()));
+    return parseRules(file.readAll(), options);
+}
+
+} // namespace CANManager
@@ -0,0 +1,653 @@
+/**
+ * @file CANIsoTpChannel.cpp
+ * @brief ISO 15765-2 (ISO-TP) transport channel — implementation.
+ */
+
+#include "CANIsoTpChannel.h"
+#include "CANManager.h"
+
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace CANManager {
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Protocol control information: high nibble of the first byte
+enum PciType : uint8_t { SingleFrame = 0x0, FirstFrame = 0x1, ConsecutiveFrame = 0x2, FlowControl = 0x3 };
+enum FlowStatus : uint8_t { ContinueToSend = 0x0, Wait = 0x1, Overflow = 0x2 };
+
+/// Sleep until shortly before the deadline, then spin (STmin can be 100 µs)
+constexpr std::chrono::microseconds SPIN_MARGIN{300};
+
+/// Retry interval while the driver's TX queue is full
+constexpr std::chrono::microseconds TX_RETRY_INTERVAL{200};
+
+bool isValidFrameSize(int size, bool fd)
+{
+    if (size == 8)
+        return true;
+    return fd && size > 8 && size <= 64 && dlcToLength(lengthToDlc(size)) == size;
+}
+
+} // namespace
+
+// ============================================================================
+//  Engine — state shared by the caller's thread and the dispatcher tap
+// ============================================================================
+
+class CANIsoTpChannel::Engine : public CANRxDispatcher::Tap
+{
+public:
+    explicit Engine(const Config& cfg) : config(cfg) {}
+
+    void onFrames(const CANMessage* frames, int count) override;
+
+    CANMessage frame(const uint8_t* bytes, int length) const;
+    CANMessage flowControlFrame(FlowStatus status) const;
+    CANResult  transmit(std::span<const CANMessage> frames, const std::atomic<bool>* cancel);
+
+    // Receive state machine; runs on the dispatcher thread under mutex
+    void handleSingle(const CANMessage& msg);
+    void handleFirst(const CANMessage& msg, std::vector<CANMessage>& replies);
+    void handleConsecutive(const CANMessage& msg, std::vector<CANMessage>& replies);
+    void handleFlowControl(const CANMessage& msg);
+    void deliverLocked(QByteArray payload);
+    void abortReceptionLocked(const QString& reason);
+    void checkReceiveTimeoutLocked(Clock::time_point now);
+
+    const Config config;
+
+    mutable QMutex mutex;           ///< Guards everything below
+    QWaitCondition received;        ///< Message queued or reception aborted
+    QWaitCondition flowControl;     ///< Flow control frame for the sender arrived
+    bool closed = true;
+
+    // Reception in progress
+    bool       receiving = false;
+    QByteArray rxBuffer;
+    uint32_t   rxLength = 0;        ///< FF_DL of the message being received
+    uint8_t    rxNextSn = 1;
+    int        rxBlockLeft = 0;     ///< CFs until we send the next FC (0 = none)
+    Clock::time_point rxDeadline{}; ///< N_Cr for the next CF
+
+    std::deque<QByteArray> rxQueue;
+    QString    rxError;             ///< Pending reception error for receive()
+
+    // Transmission waiting for flow control
+    bool    fcExpected = false;
+    bool    fcReceived = false;
+    uint8_t fcStatus = 0;
+    uint8_t fcBlockSize = 0;
+    uint8_t fcStMin = 0;
+
+    Stats stats;
+};
+
+// ============================================================================
+//  Frame Construction
+// ============================================================================
+
+CANMessage CANIsoTpChannel::Engine::frame(const uint8_t* bytes, int length) const
+{
+    CANMessage msg;
+    msg.id         = config.txId;
+    msg.isExtended = config.extendedIds;
+    msg.isFD       = config.fd;
+    msg.isBRS      = config.fd && config.brs;
+
+    // Classic frames are padded to 8 when padding is on; FD frames longer
+    // than 8 must be padded up to the next length a DLC can express
+    int frameLength = length;
+    if (config.padding)
+        frameLength = std::max(frameLength, 8);
+    msg.dlc = lengthToDlc(frameLength);
+
+    std::memcpy(msg.data, bytes, static_cast<size_t>(length));
+    std::memset(msg.data + length, config.paddingByte, static_cast<size_t>(msg.dataLength() - length));
+    return msg;
+}
+
+CANMessage CANIsoTpChannel::Engine::flowControlFrame(FlowStatus status) const
+{
+    const uint8_t bytes[3] = {static_cast<uint8_t>((FlowControl << 4) | status), config.blockSize, config.stMin};
+    return frame(bytes, 3);
+}
+
+CANResult CANIsoTpChannel::Engine::transmit(std::span<const CANMessage> frames,
+                                            const std::atomic<bool>* cancel)
+{
+    CANBusManager& can = CANBusManager::instance();
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(config.nAsMs);
+
+    // A full TX queue is not an error until N_As has passed
+    while (!frames.empty()) {
+        int sent = 0;
+        const CANResult result = can.transmitBatch(config.slotName, frames, sent);
+        sent = std::clamp(sent, 0, static_cast<int>(frames.size()));
+        frames = frames.subspan(static_cast<size_t>(sent));
+        {
+            QMutexLocker locker(&mutex);
+            stats.framesSent += static_cast<uint64_t>(sent);
+        }
+        if (frames.empty())
+            break;
+
+        if (!can.isSlotOpen(config.slotName))
+            return CANResult::Failure(QString("Slot '%1' not open").arg(config.slotName));
+        if (cancel && cancel->load())
+            return CANResult::Failure("Cancelled");
+        if (Clock::now() >= deadline)
+            return CANResult::Failure(QString("N_As timeout: %1").arg(
+                result.success ? QStringLiteral("frame not accepted by driver") : result.errorMessage));
+        std::this_thread::sleep_for(TX_RETRY_INTERVAL);
+    }
+    return CANResult::Success();
+}
+
+// ============================================================================
+//  Receive State Machine (dispatcher thread)
+// ============================================================================
+
+void CANIsoTpChannel::Engine::onFrames(const CANMessage* frames, int count)
+{
+    std::vector<CANMessage> replies;
+    {
+        QMutexLocker locker(&mutex);
+        if (closed)
+            return;
+
+        for (int i = 0; i < count; ++i) {
+            const CANMessage& msg = frames[i];
+            if (msg.isError || msg.isTxConfirm || msg.isRemote || msg.id != config.rxId
+                || msg.isExtended != config.extendedIds || msg.dataLength() < 1)
+                continue;
+
+            ++stats.framesReceived;
+            switch (msg.data[0] >> 4) {
+            case SingleFrame:      handleSingle(msg);               break;
+            case FirstFrame:       handleFirst(msg, replies);       break;
+            case ConsecutiveFrame: handleConsecutive(msg, replies); break;
+            case FlowControl:      handleFlowControl(msg);          break;
+            default:               break;  // Unknown PCI: ignored per ISO 15765-2
+            }
+        }
+    }
+
+    // Flow control goes out after the batch: the peer waits for it, so
+    // nothing more for this channel can be in the batch anyway
+    for (const CANMessage& reply : replies) {
+        const CANResult result = CANBusManager::instance().transmit(config.slotName, reply);
+        QMutexLocker locker(&mutex);
+        if (result.success) {
+            ++stats.framesSent;
+        } else if (receiving) {
+            abortReceptionLocked(QString("Flow control not sent: %1").arg(result.errorMessage));
+        }
+    }
+}
+
+void CANIsoTpChannel::Engine::handleSingle(const CANMessage& msg)
+{
+    const int length = msg.dataLength();
+    int payloadLength = msg.data[0] & 0x0F;
+    int offset = 1;
+
+    // CAN FD escape sequence: SF_DL in the second byte
+    if (payloadLength == 0 && length > 8) {
+        payloadLength = msg.data[1];
+        offset = 2;
+    }
+    if (payloadLength == 0 || offset + payloadLength > length)
+        return;
+
+    if (receiving)
+        abortReceptionLocked("Single frame received during segmented reception");
+    deliverLocked(QByteArray(reinterpret_cast<const char*>(msg.data + offset), payloadLength));
+}
+
+void CANIsoTpChannel::Engine::handleFirst(const CANMessage& msg, std::vector<CANMessage>& replies)
+{
+    const int length = msg.dataLength();
+    if (length < 8)
+        return;
+
+    uint32_t messageLength = (static_cast<uint32_t>(msg.data[0] & 0x0F) << 8) | msg.data[1];
+    int offset = 2;
+
+    // Escape sequence for messages over 4095 bytes: FF_DL in bytes 2..5
+    if (messageLength == 0) {
+        messageLength = (static_cast<uint32_t>(msg.data[2]) << 24) | (static_cast<uint32_t>(msg.data[3]) << 16)
+                      | (static_cast<uint32_t>(msg.data[4]) << 8) | msg.data[5];
+        offset = 6;
+    }
+    // A message that fits the first frame is malformed
+    if (messageLength <= static_cast<uint32_t>(length - offset))
+        return;
+
+    if (receiving)
+        abortReceptionLocked("First frame received during segmented reception");
+
+    if (messageLength > config.maxReceiveSize) {
+        ++stats.rxErrors;
+        stats.lastError = QString("Refused %1-byte message (limit %2)").arg(messageLength).arg(config.maxReceiveSize);
+        replies.push_back(flowControlFrame(Overflow));
+        return;
+    }
+
+    receiving   = true;
+    rxLength    = messageLength;
+    rxBuffer.clear();
+    rxBuffer.reserve(static_cast<qsizetype>(messageLength));
+    rxBuffer.append(reinterpret_cast<const char*>(msg.data + offset), length - offset);
+    rxNextSn    = 1;
+    rxBlockLeft = config.blockSize;
+    rxDeadline  = Clock::now() + std::chrono::milliseconds(config.nCrMs);
+    replies.push_back(flowControlFrame(ContinueToSend));
+
+    // A waiting receive() now has an N_Cr deadline to watch
+    received.wakeAll();
+}
+
+void CANIsoTpChannel::Engine::handleConsecutive(const CANMessage& msg, std::vector<CANMessage>& replies)
+{
+    if (!receiving)
+        return;
+
+    const Clock::time_point now = Clock::now();
+    checkReceiveTimeoutLocked(now);
+    if (!receiving)
+        return;
+
+    const uint8_t sn = msg.data[0] & 0x0F;
+    if (sn != rxNextSn) {
+        abortReceptionLocked(QString("Wrong sequence number %1 (expected %2)").arg(sn).arg(rxNextSn));
+        return;
+    }
+
+    const qsizetype remaining = static_cast<qsizetype>(rxLength) - rxBuffer.size();
+    rxBuffer.append(reinterpret_cast<const char*>(msg.data + 1),
+                    std::min<qsizetype>(msg.dataLength() - 1, remaining));
+    rxNextSn = (rxNextSn + 1) & 0x0F;
+
+    if (rxBuffer.size() >= static_cast<qsizetype>(rxLength)) {
+        receiving = false;
+        deliverLocked(std::exchange(rxBuffer, QByteArray()));
+        return;
+    }
+
+    rxDeadline = now + std::chrono::milliseconds(config.nCrMs);
+    if (rxBlockLeft > 0 && --rxBlockLeft == 0) {
+        rxBlockLeft = config.blockSize;
+        replies.push_back(flowControlFrame(ContinueToSend));
+    }
+}
+
+void CANIsoTpChannel::Engine::handleFlowControl(const CANMessage& msg)
+{
+    // Flow control nobody waits for is ignored
+    if (!fcExpected || msg.dataLength() < 3)
+        return;
+
+    fcExpected  = false;
+    fcReceived  = true;
+    fcStatus    = msg.data[0] & 0x0F;
+    fcBlockSize = msg.data[1];
+    fcStMin     = msg.data[2];
+    flowControl.wakeAll();
+}
+
+void CANIsoTpChannel::Engine::deliverLocked(QByteArray payload)
+{
+    if (static_cast<int>(rxQueue.size()) >= RX_QUEUE_MESSAGES) {
+        ++stats.rxErrors;
+        stats.lastError = QStringLiteral("Receive queue full, message dropped");
+        return;
+    }
+    rxQueue.push_back(std::move(payload));
+    ++stats.messagesReceived;
+    received.wakeAll();
+}
+
+void CANIsoTpChannel::Engine::abortReceptionLocked(const QString& reason)
+{
+    receiving = false;
+    rxBuffer.clear();
+    rxError = reason;
+    ++stats.rxErrors;
+    stats.lastError = reason;
+    received.wakeAll();
+}
+
+void CANIsoTpChannel::Engine::checkReceiveTimeoutLocked(Clock::time_point now)
+{
+    if (receiving && now > rxDeadline)
+        abortReceptionLocked(QString("N_Cr timeout: no consecutive frame within %1 ms").arg(config.nCrMs));
+}
+
+// ============================================================================
+//  Constructor / Destructor
+// ============================================================================
+
+CANIsoTpChannel::CANIsoTpChannel(const Config& config)
+    : m_config(config)
+    , m_engine(std::make_shared<Engine>(config))
+{
+}
+
+CANIsoTpChannel::~CANIsoTpChannel()
+{
+    close();
+}
+
+CANResult CANIsoTpChannel::open()
+{
+    if (!isValidFrameSize(m_config.frameSize, m_config.fd))
+        return CANResult::Failure(QString("Invalid ISO-TP frame size %1%2").arg(m_config.frameSize)
+                                      .arg(m_config.fd ? "" : " (more than 8 needs CAN FD)"));
+    if (m_config.nAsMs <= 0 || m_config.nBsMs <= 0 || m_config.nCrMs <= 0)
+        return CANResult::Failure("ISO-TP timeouts must be greater than 0");
+
+    {
+        QMutexLocker locker(&m_engine->mutex);
+        if (!m_engine->closed)
+            return CANResult::Success();
+        m_engine->closed = false;
+    }
+
+    if (!CANBusManager::instance().addTap(m_config.slotName, m_engine)) {
+        QMutexLocker locker(&m_engine->mutex);
+        m_engine->closed = true;
+        return CANResult::Failure(QString("Slot '%1' not open").arg(m_config.slotName));
+    }
+
+    qDebug() << "[ISO-TP]" << m_config.slotName
+             << QString("TX 0x%1 / RX 0x%2").arg(m_config.txId, 0, 16).arg(m_config.rxId, 0, 16)
+             << (m_config.fd ? QString("FD TX_DL %1").arg(m_config.frameSize) : QStringLiteral("classic"));
+    return CANResult::Success();
+}
+
+void CANIsoTpChannel::close()
+{
+    {
+        QMutexLocker locker(&m_engine->mutex);
+        if (m_engine->closed)
+            return;
+        m_engine->closed = true;
+        m_engine->receiving = false;
+        m_engine->flowControl.wakeAll();
+        m_engine->received.wakeAll();
+    }
+    CANBusManager::instance().removeTap(m_config.slotName, m_engine);
+}
+
+bool CANIsoTpChannel::isOpen() const
+{
+    QMutexLocker locker(&m_engine->mutex);
+    return !m_engine->closed;
+}
+
+// ============================================================================
+//  Send
+// ============================================================================
+
+CANResult CANIsoTpChannel::send(const QByteArray& payload, const std::atomic<bool>* cancel)
+{
+    Engine& e = *m_engine;
+    const auto fail = [&e](const QString& reason) {
+        QMutexLocker locker(&e.mutex);
+        e.fcExpected = false;
+        ++e.stats.txErrors;
+        e.stats.lastError = reason;
+        return CANResult::Failure(reason);
+    };
+
+    // One transfer at a time per channel: the peer has one reassembly buffer
+    QMutexLocker sendLocker(&m_sendMutex);
+    if (!isOpen())
+        return fail("ISO-TP channel not open");
+    if (payload.isEmpty())
+        return fail("ISO-TP payload is empty");
+    if (payload.size() > std::numeric_limits<int>::max())
+        return fail("ISO-TP payload too large");
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(payload.constData());
+    const int size = static_cast<int>(payload.size());
+    const int txDl = m_config.frameSize;
+    uint8_t buffer[64];
+
+    // --- Single frame (escape form with SF_DL in byte 1 for CAN FD) ---
+    if (size <= 7 || (txDl > 8 && size <= txDl - 2)) {
+        int offset = 1;
+        if (size <= 7) {
+            buffer[0] = static_cast<uint8_t>(size);
+        } else {
+            buffer[0] = 0x00;
+            buffer[1] = static_cast<uint8_t>(size);
+            offset = 2;
+        }
+        std::memcpy(buffer + offset, bytes, static_cast<size_t>(size));
+        const CANMessage sf = e.frame(buffer, offset + size);
+
+        const CANResult result = e.transmit({&sf, 1}, cancel);
+        if (!result.success)
+            return fail(result.errorMessage);
+        QMutexLocker locker(&e.mutex);
+        ++e.stats.messagesSent;
+        return CANResult::Success();
+    }
+
+    // --- First frame ---
+    int offset = 2;
+    if (size <= 0xFFF) {
+        buffer[0] = static_cast<uint8_t>((FirstFrame << 4) | (size >> 8));
+        buffer[1] = static_cast<uint8_t>(size & 0xFF);
+    } else {
+        buffer[0] = FirstFrame << 4;
+        buffer[1] = 0x00;
+        buffer[2] = static_cast<uint8_t>(size >> 24);
+        buffer[3] = static_cast<uint8_t>(size >> 16);
+        buffer[4] = static_cast<uint8_t>(size >> 8);
+        buffer[5] = static_cast<uint8_t>(size);
+        offset = 6;
+    }
+    int position = txDl - offset;
+    std::memcpy(buffer + offset, bytes, static_cast<size_t>(position));
+    const CANMessage ff = e.frame(buffer, txDl);
+
+    // Armed before sending, so a fast flow control is not missed
+    {
+        QMutexLocker locker(&e.mutex);
+        e.fcExpected = true;
+        e.fcReceived = false;
+    }
+    CANResult result = e.transmit({&ff, 1}, cancel);
+    if (!result.success)
+        return fail(result.errorMessage);
+
+    // --- Consecutive frames, block by block ---
+    uint8_t sn = 1;
+    int waits = 0;
+    std::vector<CANMessage> batch;
+    batch.reserve(MAX_TX_BATCH);
+
+    while (position < size) {
+        uint8_t blockSize = 0;
+        std::chrono::microseconds stMin{0};
+        {
+            QMutexLocker locker(&e.mutex);
+            const QDeadlineTimer deadline(m_config.nBsMs);
+            while (!e.fcReceived && !e.closed) {
+                if (!e.flowControl.wait(&e.mutex, deadline))
+                    break;
+            }
+            if (e.closed) {
+                locker.unlock();
+                return fail("ISO-TP channel closed during transfer");
+            }
+            if (!e.fcReceived) {
+                locker.unlock();
+                return fail(QString("N_Bs timeout: no flow control within %1 ms").arg(m_config.nBsMs));
+            }
+            e.fcReceived = false;
+
+            if (e.fcStatus == Wait) {
+                const bool tooMany = ++waits > m_config.maxWaitFrames;
+                e.fcExpected = !tooMany;
+                locker.unlock();
+                if (tooMany)
+                    return fail(QString("Receiver sent more than %1 FC.WAIT frames").arg(m_config.maxWaitFrames));
+                continue;
+            }
+            if (e.fcStatus == Overflow) {
+                locker.unlock();
+                return fail("Receiver reported buffer overflow (FC.OVFLW)");
+            }
+            if (e.fcStatus != ContinueToSend) {
+                locker.unlock();
+                return fail(QString("Invalid flow status %1").arg(e.fcStatus));
+            }
+            waits     = 0;
+            blockSize = e.fcBlockSize;
+            stMin     = std::chrono::microseconds(stMinToMicros(e.fcStMin));
+        }
+
+        int blockLeft = blockSize;
+        Clock::time_point nextSend = Clock::now();
+        while (position < size) {
+            if (cancel && cancel->load())
+                return fail("Cancelled");
+
+            // Frames without a separation time go out in batches; paced
+            // frames one at a time
+            const int limit = stMin.count() == 0 ? MAX_TX_BATCH : 1;
+            bool lastOfBlock = false;
+            batch.clear();
+            while (static_cast<int>(batch.size()) < limit && position < size) {
+                const int chunk = std::min(txDl - 1, size - position);
+                buffer[0] = static_cast<uint8_t>((ConsecutiveFrame << 4) | sn);
+                std::memcpy(buffer + 1, bytes + position, static_cast<size_t>(chunk));
+                batch.push_back(e.frame(buffer, 1 + chunk));
+                position += chunk;
+                sn = (sn + 1) & 0x0F;
+                if (blockLeft > 0 && --blockLeft == 0) {
+                    lastOfBlock = true;
+                    break;
+                }
+            }
+
+            if (stMin.count() > 0) {
+                if (Clock::now() < nextSend - SPIN_MARGIN)
+                    std::this_thread::sleep_until(nextSend - SPIN_MARGIN);
+                while (Clock::now() < nextSend)
+                    std::this_thread::yield();
+            }
+
+            // The block's flow control may come back before transmit() returns
+            if (lastOfBlock && position < size) {
+                QMutexLocker locker(&e.mutex);
+                e.fcExpected = true;
+                e.fcReceived = false;
+            }
+            result = e.transmit(batch, cancel);
+            if (!result.success)
+                return fail(result.errorMessage);
+            nextSend = Clock::now() + stMin;
+
+            if (lastOfBlock)
+                break;
+        }
+    }
+
+    QMutexLocker locker(&e.mutex);
+    ++e.stats.messagesSent;
+    return CANResult::Success();
+}
+
+// ============================================================================
+//  Receive
+// ============================================================================
+
+CANResult CANIsoTpChannel::receive(QByteArray& payload, int timeoutMs)
+{
+    Engine& e = *m_engine;
+    QMutexLocker locker(&e.mutex);
+    const QDeadlineTimer deadline(timeoutMs);
+
+    for (;;) {
+        // A stalled reception is noticed here: no frame arrives to check N_Cr
+        e.checkReceiveTimeoutLocked(Clock::now());
+
+        if (!e.rxQueue.empty()) {
+            payload = std::move(e.rxQueue.front());
+            e.rxQueue.pop_front();
+            return CANResult::Success();
+        }
+        if (!e.rxError.isEmpty())
+            return CANResult::Failure(std::exchange(e.rxError, QString()));
+        if (e.closed)
+            return CANResult::Failure("ISO-TP channel not open");
+
+        QDeadlineTimer wake = deadline;
+        if (e.receiving) {
+            const auto crLeft = std::chrono::ceil<std::chrono::milliseconds>(e.rxDeadline - Clock::now());
+            if (crLeft.count() + 1 < wake.remainingTime())
+                wake = QDeadlineTimer(crLeft.count() + 1);
+        }
+        e.received.wait(&e.mutex, wake);
+
+        if (deadline.hasExpired() && e.rxQueue.empty() && e.rxError.isEmpty()) {
+            return CANResult::Failure(e.receiving
+                ? QString("ISO-TP receive timeout after %1 ms (%2 of %3 bytes received)")
+                      .arg(timeoutMs).arg(e.rxBuffer.size()).arg(e.rxLength)
+                : QString("ISO-TP receive timeout after %1 ms").arg(timeoutMs));
+        }
+    }
+}
+
+CANResult CANIsoTpChannel::request(const QByteArray& payload, QByteArray& response, int timeoutMs,
+                                   const std::atomic<bool>* cancel)
+{
+    clearReceived();
+    const CANResult result = send(payload, cancel);
+    if (!result.success)
+        return result;
+    return receive(response, timeoutMs);
+}
+
+void CANIsoTpChannel::clearReceived()
+{
+    QMutexLocker locker(&m_engine->mutex);
+    m_engine->rxQueue.clear();
+    m_engine->rxError.clear();
+}
+
+CANIsoTpChannel::Stats CANIsoTpChannel::stats() const
+{
+    QMutexLocker locker(&m_engine->mutex);
+    return m_engine->stats;
+}
+
+int CANIsoTpChannel::stMinToMicros(uint8_t stMin)
+{
+    if (stMin <= 0x7F)
+        return stMin * 1000;
+    if (stMin >= 0xF1 && stMin <= 0xF9)
+        return (stMin - 0xF0) * 100;
+    return 127 * 1000;  // Reserved: use the longest valid separation
+}
+
+} // namespace CANManager
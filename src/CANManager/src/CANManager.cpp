@@ -23,18 +23,57 @@ CANBusManager::CANBusManager()
     : QObject(nullptr)
 {
     // Create driver instances (lazy initialization of actual DLL loading)
+#ifdef _WIN32
     m_vectorDriver = std::make_unique<VectorCANDriver>();
+#endif
+#ifdef __linux__
+    m_socketCanDriver = std::make_unique<SocketCANDriver>();
+#endif
+    m_virtualDriver = std::make_unique<VirtualCANDriver>();
 
     qDebug() << "[CANManager] Initialized";
 }
 
 CANBusManager::~CANBusManager()
 {
+    std::vector<std::pair<QString, QString>> gateways;
+    {
+        QMutexLocker locker(&m_gatewayMutex);
+        for (const auto& [key, gateway] : m_gateways) {
+            const GatewayStats stats = gateway.gateway->stats();
+            gateways.emplace_back(stats.source, stats.destination);
+        }
+    }
+    for (const auto& [source, destination] : gateways)
+        stopGateway(source, destination);
+
+    QStringList tracePaths;
+    {
+        QMutexLocker locker(&m_traceMutex);
+        for (const auto& [path, trace] : m_traces)
+            tracePaths.append(path);
+    }
+    for (const auto& path : tracePaths)
+        stopTrace(path);
+
     closeAllSlots();
 
     // Shutdown drivers
+#ifdef _WIN32
+    for (auto& [slot, driver] : m_vectorSlotDrivers)
+        driver->shutdown();
     if (m_vectorDriver)
         m_vectorDriver->shutdown();
+#endif
+#ifdef __linux__
+    for (auto& [slot, driver] : m_socketCanSlotDrivers)
+        driver->shutdown();
+    if (m_socketCanDriver)
+        m_socketCanDriver->shutdown();
+#endif
+    for (auto& [slot, driver] : m_virtualSlotDrivers)
+        driver->shutdown();
+    m_virtualDriver->shutdown();
 
     qDebug() << "[CANManager] Destroyed";
 }
@@ -45,17 +84,64 @@ CANBusManager::~CANBusManager()
 
 ICANDriver* CANBusManager::driverByName(const QString& name) const
 {
+#ifdef _WIN32
     if (m_vectorDriver && name == m_vectorDriver->driverName())
         return m_vectorDriver.get();
-    // Future: check Kvaser, SocketCAN, etc.
+#endif
+#ifdef __linux__
+    if (m_socketCanDriver && name == m_socketCanDriver->driverName())
+        return m_socketCanDriver.get();
+#endif
+    if (name == m_virtualDriver->driverName())
+        return m_virtualDriver.get();
+    // Future: check Kvaser, etc.
     return nullptr;
 }
 
+template <typename Driver>
+Driver* CANBusManager::slotDriverLocked(std::map<QString, std::unique_ptr<Driver>>& drivers,
+                                        const QString& slotName)
+{
+    auto& driver = drivers[slotName];
+    if (!driver)
+        driver = std::make_unique<Driver>();
+    return driver.get();
+}
+
+VirtualCANDriver* CANBusManager::virtualDriver(const QString& slotName)
+{
+    QMutexLocker locker(&m_mutex);
+    return slotDriverLocked(m_virtualSlotDrivers, slotName);
+}
+
+#ifdef _WIN32
+VectorCANDriver* CANBusManager::vectorDriver(const QString& slotName)
+{
+    QMutexLocker locker(&m_mutex);
+    return slotDriverLocked(m_vectorSlotDrivers, slotName);
+}
+#endif
+
+#ifdef __linux__
+SocketCANDriver* CANBusManager::socketCanDriver(const QString& slotName)
+{
+    QMutexLocker locker(&m_mutex);
+    return slotDriverLocked(m_socketCanSlotDrivers, slotName);
+}
+#endif
+
 QStringList CANBusManager::availableDriverNames() const
 {
     QStringList names;
+#ifdef _WIN32
     if (m_vectorDriver)
         names.append(m_vectorDriver->driverName());
+#endif
+#ifdef __linux__
+    if (m_socketCanDriver)
+        names.append(m_socketCanDriver->driverName());
+#endif
+    names.append(m_virtualDriver->driverName());
     // Future: add other drivers
     return names;
 }
@@ -68,6 +154,7 @@ QMap<QString, QList<CANChannelInfo>> CANBusManager::detectAllChannels()
 {
     QMap<QString, QList<CANChannelInfo>> result;
 
+#ifdef _WIN32
     // Vector
     if (m_vectorDriver) {
         if (!m_vectorDriver->isAvailable()) {
@@ -83,8 +170,26 @@ QMap<QString, QList<CANChannelInfo>> CANBusManager::detectAllChannels()
             }
         }
     }
+#endif
+
+#ifdef __linux__
+    // SocketCAN
+    if (m_socketCanDriver) {
+        if (!m_socketCanDriver->initialize()) {
+            qDebug() << "[CANManager] SocketCAN not available:"
+                     << m_socketCanDriver->lastError();
+        } else {
+            auto channels = m_socketCanDriver->detectChannels();
+            if (!channels.isEmpty())
+                result[m_socketCanDriver->driverName()] = channels;
+        }
+    }
+#endif
+
+    // Virtual buses are always available
+    result[m_virtualDriver->driverName()] = m_virtualDriver->detectChannels();
 
-    // Future: Kvaser, SocketCAN, etc.
+    // Future: Kvaser, etc.
 
     return result;
 }
@@ -93,42 +198,93 @@ QMap<QString, QList<CANChannelInfo>> CANBusManager::detectAllChannels()
 //  Slot Management
 // ============================================================================
 
+std::shared_ptr<CANBusManager::Slot> CANBusManager::findSlot(const QString& slotName) const
+{
+    const auto table = m_slotTable.load();
+    return table->value(slotName);
+}
+
+bool CANBusManager::removeSlotLocked(const QString& slotName)
+{
+    const auto current = m_slotTable.load();
+    auto it = current->find(slotName);
+    if (it == current->end())
+        return false;
+
+    const std::shared_ptr<Slot> slot = it.value();
+
+    // Publish the table without this slot first so no new operation finds it;
+    // operations already holding the slot are released by requestStop() and
+    // closeChannel() (which also interrupts the dispatcher's driver receive).
+    auto next = std::make_shared<SlotTable>(*current);
+    next->remove(slotName);
+    m_slotTable.store(std::move(next));
+
+    {
+        QMutexLocker nmLocker(&slot->nmMutex);
+        if (slot->nm)
+            slot->nm->stop();
+        slot->nm.reset();
+    }
+    slot->cyclic->shutdown();
+    slot->replayer->shutdown();
+    {
+        QMutexLocker udsLocker(&slot->udsMutex);
+        for (const auto& client : std::as_const(slot->udsClients))
+            client->close();
+        slot->udsClients.clear();
+    }
+    slot->dispatcher->requestStop();
+    slot->driver->closeChannel();
+    slot->dispatcher->join();
+
+    qDebug() << "[CANManager] Slot closed:" << slotName;
+    return true;
+}
+
 CANResult CANBusManager::openSlot(const QString& slotName,
                                    ICANDriver* driver,
                                    const CANChannelInfo& channel,
                                    const CANBusConfig& config)
 {
-    QMutexLocker locker(&m_mutex);
-
     if (!driver)
         return CANResult::Failure("No driver specified");
 
-    if (m_slots.contains(slotName)) {
-        // Close existing slot first
-        locker.unlock();
-        closeSlot(slotName);
-        locker.relock();
-    }
+    QMutexLocker locker(&m_mutex);
 
-    // Initialize driver if needed
-    if (!driver->isOpen()) {
-        // Driver may need initialization before opening a channel
-    }
+    // Close existing slot first
+    const bool replaced = removeSlotLocked(slotName);
 
     CANResult result = driver->openChannel(channel, config);
-    if (!result.success)
+    if (!result.success) {
+        locker.unlock();
+        if (replaced)
+            emit slotClosed(slotName);
         return result;
+    }
 
-    SlotInfo info;
-    info.driver  = driver;
-    info.channel = channel;
-    m_slots[slotName] = info;
+    auto slot = std::make_shared<Slot>();
+    slot->driver     = driver;
+    slot->channel    = channel;
+    slot->statistics = std::make_unique<CANBusStatistics>(config.bitrate, config.fdDataBitrate);
+    slot->dispatcher = std::make_unique<CANRxDispatcher>(driver, slotName, slot->statistics.get());
+    slot->dispatcher->start();
+    slot->cyclic     = std::make_unique<CANCyclicScheduler>(driver, &slot->txMutex, slotName,
+                                                            slot->statistics.get());
+    slot->replayer   = std::make_unique<CANTraceReplayer>(driver, &slot->txMutex, slotName,
+                                                          slot->statistics.get());
+
+    auto next = std::make_shared<SlotTable>(*m_slotTable.load());
+    next->insert(slotName, slot);
+    m_slotTable.store(std::move(next));
 
     qDebug() << "[CANManager] Slot opened:" << slotName
              << "via" << driver->driverName()
              << "on" << channel.name;
 
     locker.unlock();
+    if (replaced)
+        emit slotClosed(slotName);
     emit slotOpened(slotName);
 
     return CANResult::Success();
@@ -138,50 +294,33 @@ void CANBusManager::closeSlot(const QString& slotName)
 {
     QMutexLocker locker(&m_mutex);
 
-    auto it = m_slots.find(slotName);
-    if (it == m_slots.end())
+    if (!removeSlotLocked(slotName))
         return;
 
-    auto& info = it.value();
-    if (info.driver)
-        info.driver->closeChannel();
-
-    m_slots.erase(it);
-
-    qDebug() << "[CANManager] Slot closed:" << slotName;
-
     locker.unlock();
     emit slotClosed(slotName);
 }
 
 void CANBusManager::closeAllSlots()
 {
-    QMutexLocker locker(&m_mutex);
-
-    QStringList names = m_slots.keys();
-    locker.unlock();
-
-    for (const auto& name : names)
+    for (const auto& name : openSlotNames())
         closeSlot(name);
 }
 
 bool CANBusManager::isSlotOpen(const QString& slotName) const
 {
-    QMutexLocker locker(&m_mutex);
-    return m_slots.contains(slotName);
+    return m_slotTable.load()->contains(slotName);
 }
 
 ICANDriver* CANBusManager::slotDriver(const QString& slotName) const
 {
-    QMutexLocker locker(&m_mutex);
-    auto it = m_slots.find(slotName);
-    return (it != m_slots.end()) ? it->driver : nullptr;
+    auto slot = findSlot(slotName);
+    return slot ? slot->driver : nullptr;
 }
 
 QStringList CANBusManager::openSlotNames() const
 {
-    QMutexLocker locker(&m_mutex);
-    return m_slots.keys();
+    return m_slotTable.load()->keys();
 }
 
 // ============================================================================
@@ -190,44 +329,534 @@ QStringList CANBusManager::openSlotNames() const
 
 CANResult CANBusManager::transmit(const QString& slotName, const CANMessage& msg)
 {
-    QMutexLocker locker(&m_mutex);
-
-    auto it = m_slots.find(slotName);
-    if (it == m_slots.end())
+    auto slot = findSlot(slotName);
+    if (!slot)
         return CANResult::Failure(QString("Slot '%1' not open").arg(slotName));
 
-    if (!it->driver)
-        return CANResult::Failure("Slot has no driver");
+    QMutexLocker locker(&slot->txMutex);
+    CANResult result = slot->driver->transmit(msg);
+    slot->statistics->onTransmitted(&msg, 1, result.success ? 1 : 0);
+    return result;
+}
 
-    return it->driver->transmit(msg);
+CANResult CANBusManager::transmitBatch(const QString& slotName,
+                                       std::span<const CANMessage> msgs, int& sent)
+{
+    sent = 0;
+    auto slot = findSlot(slotName);
+    if (!slot)
+        return CANResult::Failure(QString("Slot '%1' not open").arg(slotName));
+
+    QMutexLocker locker(&slot->txMutex);
+    CANResult result = slot->driver->transmitBatch(msgs, sent);
+    slot->statistics->onTransmitted(msgs.data(), static_cast<int>(msgs.size()), sent);
+    return result;
 }
 
 CANResult CANBusManager::receive(const QString& slotName, CANMessage& msg, int timeoutMs)
 {
-    QMutexLocker locker(&m_mutex);
+    auto slot = findSlot(slotName);
+    if (!slot)
+        return CANResult::Failure(QString("Slot '%1' not open").arg(slotName));
+
+    return slot->dispatcher->receive(msg, timeoutMs);
+}
 
-    auto it = m_slots.find(slotName);
-    if (it == m_slots.end())
+CANResult CANBusManager::flushReceiveQueue(const QString& slotName)
+{
+    auto slot = findSlot(slotName);
+    if (!slot)
         return CANResult::Failure(QString("Slot '%1' not open").arg(slotName));
 
-    if (!it->driver)
-        return CANResult::Failure("Slot has no driver");
+    slot->dispatcher->flush();
+    return CANResult::Success();
+}
+
+CANResult CANBusManager::setAcceptanceFilters(const QString& slotName, const QList<CANIdFilter>& filters)
+{
+    auto slot = findSlot(slotName);
+    if (!slot)
+        return CANResult::Failure(QString("Slot '%1' not open").arg(slotName));
 
-    return it->driver->receive(msg, timeoutMs);
+    CANResult result = slot->driver->setAcceptanceFilters(filters);
+    if (result.success) {
+        QStringList ids;
+        for (const CANIdFilter& filter : filters)
+            ids.append(filter.toString());
+        qDebug() << "[CANManager] Acceptance filters on" << slotName << ":"
+                 << (ids.isEmpty() ? QStringLiteral("all") : ids.join(", "));
+    }
+    return result;
 }
 
-CANResult CANBusManager::flushReceiveQueue(const QString& slotName)
+CANResult CANBusManager::request(const QString& slotName, const CANMessage& txMsg,
+                                 const CANIdFilter& rxFilter, int timeoutMs,
+                                 CANMessage& rxMsg)
 {
-    QMutexLocker locker(&m_mutex);
+    auto slot = findSlot(slotName);
+    if (!slot)
+        return CANResult::Failure(QString("Slot '%1' not open").arg(slotName));
+
+    // Arm first: the response may arrive before transmit() returns
+    auto waiter = slot->dispatcher->arm(rxFilter);
+
+    CANResult txResult;
+    {
+        QMutexLocker locker(&slot->txMutex);
+        txResult = slot->driver->transmit(txMsg);
+    }
+    slot->statistics->onTransmitted(&txMsg, 1, txResult.success ? 1 : 0);
+    if (!txResult.success) {
+        slot->dispatcher->disarm(waiter);
+        return CANResult::Failure("Transmit failed: " + txResult.errorMessage);
+    }
+
+    if (!slot->dispatcher->waitForResponse(waiter, timeoutMs, rxMsg)) {
+        return CANResult::Failure(
+            QString("No response with CAN ID %1 within %2 ms")
+                .arg(rxFilter.toString()).arg(timeoutMs));
+    }
+    return CANResult::Success();
+}
+
+// ============================================================================
+//  Subscriptions
+// ============================================================================
+
+std::shared_ptr<CANBusManager::Subscription>
+CANBusManager::subscribe(const QString& slotName, const CANIdFilter& filter, size_t queueCapacity)
+{
+    auto slot = findSlot(slotName);
+    if (!slot)
+        return nullptr;
+    return slot->dispatcher->subscribe(filter, queueCapacity);
+}
+
+void CANBusManager::unsubscribe(const QString& slotName,
+                                const std::shared_ptr<Subscription>& subscription)
+{
+    // After the slot closed its subscriptions are already closed
+    auto slot = findSlot(slotName);
+    if (slot)
+        slot->dispatcher->unsubscribe(subscription);
+}
+
+bool CANBusManager::addTap(const QString& slotName, const std::shared_ptr<CANRxDispatcher::Tap>& tap)
+{
+    auto slot = findSlot(slotName);
+    if (!slot)
+        return false;
+    slot->dispatcher->addTap(tap);
+    return true;
+}
+
+void CANBusManager::removeTap(const QString& slotName, const std::shared_ptr<CANRxDispatcher::Tap>& tap)
+{
+    auto slot = findSlot(slotName);
+    if (slot)
+        slot->dispatcher->removeTap(tap);
+}
+
+// ============================================================================
+//  Cyclic Transmission
+// ============================================================================
+
+CANResult CANBusManager::startCyclic(const QString& slotName, const CANMessage& msg, int periodMs,
+                                     int offsetMs)
+{
+    auto slot = findSlot(slotName);
+    if (!slot)
+        return CANResult::Failure(QString("Slot '%1' not open").arg(slotName));
+
+    return slot->cyclic->start(msg, periodMs, offsetMs);
+}
+
+CANResult CANBusManager::updateCyclic(const QString& slotName, const CANMessage& msg)
+{
+    auto slot = findSlot(slotName);
+    if (!slot)
+        return CANResult::Failure(QString("Slot '%1' not open").arg(slotName));
+
+    return slot->cyclic->update(msg);
+}
+
+CANResult CANBusManager::stopCyclic(const QString& slotName, uint32_t id, bool extended,
+                                    CyclicStats* stats)
+{
+    auto slot = findSlot(slotName);
+    if (!slot)
+        return CANResult::Failure(QString("Slot '%1' not open").arg(slotName));
+
+    return slot->cyclic->stop(id, extended, stats);
+}
+
+bool CANBusManager::cyclicStats(const QString& slotName, uint32_t id, bool extended,
+                                CyclicStats& stats) const
+{
+    auto slot = findSlot(slotName);
+    return slot && slot->cyclic->stats(id, extended, stats);
+}
+
+// ============================================================================
+//  Trace Recording
+// ============================================================================
+
+CANResult CANBusManager::startTrace(const QStringList& slotNames, const TraceOptions& options)
+{
+    if (slotNames.isEmpty())
+        return CANResult::Failure("No slots to trace");
+
+    std::vector<std::shared_ptr<Slot>> traced;
+    for (const auto& name : slotNames) {
+        auto slot = findSlot(name);
+        if (!slot)
+            return CANResult::Failure(QString("Slot '%1' not open").arg(name));
+        traced.push_back(std::move(slot));
+    }
+
+    QMutexLocker locker(&m_traceMutex);
+    if (m_traces.count(options.path))
+        return CANResult::Failure(QString("Already recording to %1").arg(options.path));
+
+    auto recorder = std::make_shared<CANTraceRecorder>(options);
+    CANResult result = recorder->start();
+    if (!result.success)
+        return result;
+
+    Trace trace;
+    trace.recorder = recorder;
+    for (size_t i = 0; i < traced.size(); ++i) {
+        auto tap = recorder->createTap(static_cast<uint16_t>(i + 1));
+        traced[i]->dispatcher->addTap(tap);
+        trace.taps.emplace_back(slotNames[static_cast<qsizetype>(i)], std::move(tap));
+    }
+    m_traces.emplace(options.path, std::move(trace));
+
+    qDebug() << "[CANManager] Tracing" << slotNames << "to" << options.path;
+    return CANResult::Success();
+}
+
+CANResult CANBusManager::stopTrace(const QString& path, TraceStats* stats)
+{
+    Trace trace;
+    {
+        QMutexLocker locker(&m_traceMutex);
+        auto it = m_traces.find(path);
+        if (it == m_traces.end())
+            return CANResult::Failure(QString("No trace recording to %1").arg(path));
+        trace = std::move(it->second);
+        m_traces.erase(it);
+    }
+
+    // A slot reopened since has a new dispatcher without this tap: removeTap() is a no-op
+    for (const auto& [slotName, tap] : trace.taps) {
+        auto slot = findSlot(slotName);
+        if (slot)
+            slot->dispatcher->removeTap(tap);
+    }
+    return trace.recorder->stop(stats);
+}
+
+bool CANBusManager::traceStats(const QString& path, TraceStats& stats) const
+{
+    QMutexLocker locker(&m_traceMutex);
+    auto it = m_traces.find(path);
+    if (it == m_traces.end())
+        return false;
+
+    stats = it->second.recorder->stats();
+    return true;
+}
+
+// ============================================================================
+//  Trace Replay
+// ============================================================================
+
+CANResult CANBusManager::startReplay(const QString& slotName, const ReplayOptions& options)
+{
+    auto slot = findSlot(slotName);
+    if (!slot)
+        return CANResult::Failure(QString("Slot '%1' not open").arg(slotName));
+
+    return slot->replayer->start(options);
+}
 
-    auto it = m_slots.find(slotName);
-    if (it == m_slots.end())
+CANResult CANBusManager::stopReplay(const QString& slotName, ReplayStats* stats)
+{
+    auto slot = findSlot(slotName);
+    if (!slot)
         return CANResult::Failure(QString("Slot '%1' not open").arg(slotName));
 
-    if (!it->driver)
-        return CANResult::Failure("Slot has no driver");
+    return slot->replayer->stop(stats);
+}
+
+bool CANBusManager::waitForReplay(const QString& slotName, int timeoutMs)
+{
+    auto slot = findSlot(slotName);
+    return !slot || slot->replayer->waitForFinished(timeoutMs);
+}
+
+bool CANBusManager::replayStats(const QString& slotName, ReplayStats& stats) const
+{
+    auto slot = findSlot(slotName);
+    if (!slot)
+        return false;
+
+    stats = slot->replayer->stats();
+    return true;
+}
+
+// ============================================================================
+//  Bus Statistics
+// ============================================================================
+
+bool CANBusManager::busStatistics(const QString& slotName, BusStatistics& stats) const
+{
+    auto slot = findSlot(slotName);
+    if (!slot)
+        return false;
 
-    return it->driver->flushReceiveQueue();
+    stats = slot->statistics->snapshot();
+    return true;
+}
+
+QList<CANBusManager::BusSample> CANBusManager::busStatisticsHistory(const QString& slotName) const
+{
+    auto slot = findSlot(slotName);
+    return slot ? slot->statistics->history() : QList<BusSample>();
+}
+
+CANResult CANBusManager::resetBusStatistics(const QString& slotName)
+{
+    auto slot = findSlot(slotName);
+    if (!slot)
+        return CANResult::Failure(QString("Slot '%1' not open").arg(slotName));
+
+    slot->statistics->reset();
+    qDebug() << "[CANManager] Bus statistics reset on" << slotName;
+    return CANResult::Success();
+}
+
+// ============================================================================
+//  Gateways
+// ============================================================================
+
+static QString gatewayKey(const QString& source, const QString& destination)
+{
+    return source + "->" + destination;
+}
+
+CANResult CANBusManager::startGateway(const GatewayOptions& options)
+{
+    if (options.source == options.destination)
+        return CANResult::Failure("Gateway source and destination must differ");
+    if (!findSlot(options.destination))
+        return CANResult::Failure(QString("Slot '%1' not open").arg(options.destination));
+
+    const QString key = gatewayKey(options.source, options.destination);
+    QMutexLocker locker(&m_gatewayMutex);
+    if (m_gateways.count(key))
+        return CANResult::Failure(QString("Gateway %1 already running").arg(key));
+
+    auto subscription = subscribe(options.source, CANIdFilter::all(), CANGateway::QUEUE_CAPACITY);
+    if (!subscription)
+        return CANResult::Failure(QString("Slot '%1' not open").arg(options.source));
+
+    const QString destination = options.destination;
+    auto gateway = std::make_unique<CANGateway>(
+        options, subscription,
+        [this, destination](std::span<const CANMessage> msgs, int& sent) {
+            return transmitBatch(destination, msgs, sent);
+        });
+    CANResult result = gateway->start();
+    if (!result.success) {
+        unsubscribe(options.source, subscription);
+        return result;
+    }
+
+    m_gateways.emplace(key, Gateway{std::move(gateway), std::move(subscription)});
+    qDebug() << "[CANManager] Gateway" << key << "started";
+    return CANResult::Success();
+}
+
+CANResult CANBusManager::stopGateway(const QString& source, const QString& destination,
+                                     GatewayStats* stats)
+{
+    const QString key = gatewayKey(source, destination);
+    Gateway gateway;
+    {
+        QMutexLocker locker(&m_gatewayMutex);
+        auto it = m_gateways.find(key);
+        if (it == m_gateways.end())
+            return CANResult::Failure(QString("No gateway %1").arg(key));
+        gateway = std::move(it->second);
+        m_gateways.erase(it);
+    }
+
+    // Closing the subscription wakes the gateway thread at once
+    unsubscribe(source, gateway.subscription);
+    gateway.gateway->stop();
+    if (stats)
+        *stats = gateway.gateway->stats();
+    qDebug() << "[CANManager] Gateway" << key << "stopped";
+    return CANResult::Success();
+}
+
+bool CANBusManager::gatewayStats(const QString& source, const QString& destination,
+                                 GatewayStats& stats) const
+{
+    QMutexLocker locker(&m_gatewayMutex);
+    auto it = m_gateways.find(gatewayKey(source, destination));
+    if (it == m_gateways.end())
+        return false;
+
+    stats = it->second.gateway->stats();
+    return true;
+}
+
+// ============================================================================
+//  UDS Diagnostics
+// ============================================================================
+
+std::shared_ptr<UdsClient> CANBusManager::udsClient(const UdsClient::Config& config, CANResult* result)
+{
+    const CANIsoTpChannel::Config& transport = config.transport;
+    auto slot = findSlot(transport.slotName);
+    if (!slot) {
+        if (result)
+            *result = CANResult::Failure(QString("Slot '%1' not open").arg(transport.slotName));
+        return nullptr;
+    }
+
+    const QString key = QString("%1/%2/%3").arg(transport.txId, 0, 16).arg(transport.rxId, 0, 16)
+                                           .arg(transport.extendedIds ? 'x' : 's');
+    QMutexLocker locker(&slot->udsMutex);
+
+    // removeSlotLocked() unpublishes the slot before it takes udsMutex to close
+    // the clients: if this slot is still current here, any client registered
+    // below is closed with it; otherwise it was (or is being) torn down.
+    if (findSlot(transport.slotName) != slot) {
+        if (result)
+            *result = CANResult::Failure(QString("Slot '%1' not open").arg(transport.slotName));
+        return nullptr;
+    }
+
+    std::shared_ptr<UdsClient> client = slot->udsClients.value(key);
+    if (client) {
+        const UdsClient::Config& current = client->config();
+        const CANIsoTpChannel::Config& open = current.transport;
+        const bool same = open.fd == transport.fd && open.brs == transport.brs
+                       && open.frameSize == transport.frameSize && open.padding == transport.padding
+                       && open.paddingByte == transport.paddingByte && open.blockSize == transport.blockSize
+                       && open.stMin == transport.stMin && current.p2Ms == config.p2Ms
+                       && current.p2StarMs == config.p2StarMs;
+        if (same && client->isOpen()) {
+            if (result)
+                *result = CANResult::Success();
+            return client;
+        }
+        client->close();
+        slot->udsClients.remove(key);
+    }
+
+    client = std::make_shared<UdsClient>(config);
+    const CANResult opened = client->open();
+    if (result)
+        *result = opened;
+    if (!opened.success)
+        return nullptr;
+
+    slot->udsClients.insert(key, client);
+    return client;
+}
+
+// ============================================================================
+//  Network Management
+// ============================================================================
+
+CANResult CANBusManager::startNm(const NmConfig& config)
+{
+    auto slot = findSlot(config.slotName);
+    if (!slot)
+        return CANResult::Failure(QString("Slot '%1' not open").arg(config.slotName));
+
+    QMutexLocker locker(&slot->nmMutex);
+
+    // As in udsClient(): an engine started on a slot that removeSlotLocked()
+    // has already unpublished would never be stopped
+    if (findSlot(config.slotName) != slot)
+        return CANResult::Failure(QString("Slot '%1' not open").arg(config.slotName));
+
+    if (slot->nm && !(slot->nm->config() == config)) {
+        slot->dispatcher->removeTap(slot->nm);
+        slot->nm->stop();
+        slot->nm.reset();
+    }
+    if (!slot->nm) {
+        auto nm = std::make_shared<CANNetworkManagement>(config);
+        const CANResult started = nm->start();
+        if (!started.success)
+            return started;
+        slot->dispatcher->addTap(nm);
+        slot->nm = std::move(nm);
+    }
+    return slot->nm->requestNetwork();
+}
+
+std::shared_ptr<CANNetworkManagement> CANBusManager::nmEngine(const QString& slotName, CANResult* result) const
+{
+    auto slot = findSlot(slotName);
+    if (!slot) {
+        if (result)
+            *result = CANResult::Failure(QString("Slot '%1' not open").arg(slotName));
+        return nullptr;
+    }
+    QMutexLocker locker(&slot->nmMutex);
+    if (!slot->nm && result)
+        *result = CANResult::Failure(QString("No network management on slot '%1'").arg(slotName));
+    return slot->nm;
+}
+
+CANResult CANBusManager::releaseNm(const QString& slotName, const QList<uint8_t>& nodes)
+{
+    CANResult result;
+    auto nm = nmEngine(slotName, &result);
+    return nm ? nm->releaseNetwork(nodes) : result;
+}
+
+CANResult CANBusManager::waitNmBusSleep(const QString& slotName, int timeoutMs,
+                                        const std::atomic<bool>* cancel)
+{
+    CANResult result;
+    auto nm = nmEngine(slotName, &result);
+    return nm ? nm->waitBusSleep(timeoutMs, cancel) : result;
+}
+
+bool CANBusManager::nmStatus(const QString& slotName, NmStatus& status) const
+{
+    auto nm = nmEngine(slotName);
+    if (!nm)
+        return false;
+    status = nm->status();
+    return true;
+}
+
+CANResult CANBusManager::stopNm(const QString& slotName)
+{
+    auto slot = findSlot(slotName);
+    if (!slot)
+        return CANResult::Failure(QString("Slot '%1' not open").arg(slotName));
+
+    std::shared_ptr<CANNetworkManagement> nm;
+    {
+        QMutexLocker locker(&slot->nmMutex);
+        std::swap(nm, slot->nm);
+    }
+    if (!nm)
+        return CANResult::Failure(QString("No network management on slot '%1'").arg(slotName));
+    slot->dispatcher->removeTap(nm);
+    nm->stop();
+    return CANResult::Success();
 }
 
 } // namespace CANManager
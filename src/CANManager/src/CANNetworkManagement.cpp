@@ -0,0 +1,522 @@
+/**
+ * @file CANNetworkManagement.cpp
+ * @brief AUTOSAR CAN network management simulation — implementation.
+ */
+
+#include "CANNetworkManagement.h"
+#include "CANManager.h"
+
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+namespace CANManager {
+
+namespace {
+
+/// How often waitBusSleep() checks its cancel flag
+constexpr std::chrono::milliseconds CANCEL_CHECK_INTERVAL{50};
+
+int64_t elapsedMs(std::chrono::steady_clock::duration d)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+}
+
+} // namespace
+
+CANNetworkManagement::CANNetworkManagement(const Config& config)
+    : m_config(config)
+{
+    for (uint8_t id : m_config.nodes)
+        m_nodes.push_back(Node{id});
+}
+
+CANNetworkManagement::~CANNetworkManagement()
+{
+    stop();
+}
+
+// ============================================================================
+//  Lifecycle
+// ============================================================================
+
+CANResult CANNetworkManagement::validate() const
+{
+    const Config& c = m_config;
+    if (c.nodes.isEmpty())
+        return CANResult::Failure("No local NM nodes configured");
+    for (qsizetype i = 0; i < c.nodes.size(); ++i) {
+        if (c.nodes.indexOf(c.nodes[i]) != i)
+            return CANResult::Failure(QString("NM node 0x%1 configured twice").arg(c.nodes[i], 0, 16));
+    }
+
+    const uint32_t idRange = c.extendedIds ? 0x1FFFFFFF : 0x7FF;
+    for (uint8_t node : c.nodes) {
+        const uint32_t id = c.baseId + node;
+        if (id > idRange || (id & c.idMask) != (c.baseId & c.idMask))
+            return CANResult::Failure(QString("NM PDU ID 0x%1 of node 0x%2 is outside the NM range 0x%3/0x%4")
+                                          .arg(id, 0, 16).arg(node, 0, 16).arg(c.baseId, 0, 16).arg(c.idMask, 0, 16));
+    }
+
+    if (c.msgCycleMs <= 0 || c.msgCycleOffsetMs < 0 || c.repeatMessageMs < 0 || c.waitBusSleepMs < 0)
+        return CANResult::Failure("NM times must not be negative and the message cycle must be positive");
+    if (c.timeoutMs <= c.msgCycleMs)
+        return CANResult::Failure(QString("NM timeout (%1 ms) must be longer than the message cycle (%2 ms)")
+                                      .arg(c.timeoutMs).arg(c.msgCycleMs));
+
+    if (c.pduLength < 1 || c.pduLength > 8)
+        return CANResult::Failure(QString("NM PDU length %1 is not 1..8").arg(c.pduLength));
+    for (int position : {c.nidPosition, c.cbvPosition}) {
+        if (position < -1 || position >= c.pduLength)
+            return CANResult::Failure(QString("NM PDU byte %1 is outside the %2-byte PDU").arg(position).arg(c.pduLength));
+    }
+    if (c.nidPosition >= 0 && c.nidPosition == c.cbvPosition)
+        return CANResult::Failure("Node ID and control bit vector share a PDU byte");
+    return CANResult::Success();
+}
+
+CANResult CANNetworkManagement::start()
+{
+    auto result = validate();
+    if (!result.success)
+        return result;
+
+    QMutexLocker locker(&m_mutex);
+    if (m_thread)
+        return CANResult::Failure("NM engine already running");
+
+    for (Node& node : m_nodes)
+        node = Node{node.id};
+    m_remotes.clear();
+    m_pdusReceived = 0;
+    m_busSleep   = true;
+    m_releasedAt = {};
+    m_sleepAt    = {};
+    m_stopping   = false;
+
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->setObjectName(QStringLiteral("NM_%1").arg(m_config.slotName));
+    m_thread->start();
+
+    qDebug() << "[CanNm]" << m_config.slotName << "started with" << m_nodes.size() << "nodes, cycle"
+             << m_config.msgCycleMs << "ms, timeout" << m_config.timeoutMs << "ms";
+    return CANResult::Success();
+}
+
+void CANNetworkManagement::stop()
+{
+    QThread* thread = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_wake.wakeAll();
+        m_changed.wakeAll();
+        std::swap(thread, m_thread);
+    }
+    if (!thread)
+        return;
+
+    thread->wait();
+    delete thread;
+    qDebug() << "[CanNm]" << m_config.slotName << "stopped";
+}
+
+bool CANNetworkManagement::isRunning() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_thread != nullptr;
+}
+
+// ============================================================================
+//  Network Requests
+// ============================================================================
+
+CANResult CANNetworkManagement::selectNodes(const QList<uint8_t>& ids, std::vector<Node*>& nodes)
+{
+    if (!m_thread)
+        return CANResult::Failure("NM engine not running");
+    for (Node& node : m_nodes) {
+        if (ids.isEmpty() || ids.contains(node.id))
+            nodes.push_back(&node);
+    }
+    for (uint8_t id : ids) {
+        const bool known = std::any_of(m_nodes.cbegin(), m_nodes.cend(),
+                                       [id](const Node& node) { return node.id == id; });
+        if (!known)
+            return CANResult::Failure(QString("NM node 0x%1 is not simulated").arg(id, 0, 16));
+    }
+    return CANResult::Success();
+}
+
+CANResult CANNetworkManagement::requestNetwork(const QList<uint8_t>& ids)
+{
+    QMutexLocker locker(&m_mutex);
+    std::vector<Node*> nodes;
+    auto result = selectNodes(ids, nodes);
+    if (!result.success)
+        return result;
+
+    const Clock::time_point now = Clock::now();
+    for (Node* node : nodes) {
+        node->requested = true;
+        switch (node->state) {
+        case State::BusSleep:
+        case State::PrepareBusSleep:
+            node->activeWakeup = m_config.activeWakeupBit;
+            enterRepeatMessageLocked(*node, now);
+            break;
+        case State::ReadySleep:
+            node->state = State::NormalOperation;
+            break;
+        case State::RepeatMessage:
+        case State::NormalOperation:
+            break;
+        }
+    }
+    m_releasedAt = {};
+    updateBusSleepLocked(now);
+    m_wake.wakeAll();
+    return CANResult::Success();
+}
+
+CANResult CANNetworkManagement::releaseNetwork(const QList<uint8_t>& ids)
+{
+    QMutexLocker locker(&m_mutex);
+    std::vector<Node*> nodes;
+    auto result = selectNodes(ids, nodes);
+    if (!result.success)
+        return result;
+
+    const Clock::time_point now = Clock::now();
+    bool released = false;
+    for (Node* node : nodes) {
+        released |= node->requested;
+        node->requested = false;
+        // Repeat Message is left when its time is up, see processTimersLocked()
+        if (node->state == State::NormalOperation)
+            enterReadySleepLocked(*node, now);
+    }
+
+    const bool anyRequested = std::any_of(m_nodes.cbegin(), m_nodes.cend(),
+                                          [](const Node& node) { return node.requested; });
+    if (released && !anyRequested)
+        m_releasedAt = now;
+    m_wake.wakeAll();
+    return CANResult::Success();
+}
+
+CANResult CANNetworkManagement::waitBusSleep(int timeoutMs, const std::atomic<bool>* cancel)
+{
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    QMutexLocker locker(&m_mutex);
+    while (!m_busSleep) {
+        if (!m_thread || m_stopping)
+            return CANResult::Failure("NM engine stopped");
+        if (cancel && cancel->load())
+            return CANResult::Failure("Cancelled");
+
+        const Clock::time_point now = Clock::now();
+        if (now >= deadline) {
+            QStringList awake;
+            for (const Node& node : m_nodes) {
+                if (node.state != State::BusSleep)
+                    awake << QString("local 0x%1 (%2)").arg(node.id, 2, 16, QChar('0')).arg(stateName(node.state));
+            }
+            const auto timeout = std::chrono::milliseconds(m_config.timeoutMs);
+            for (const auto& [id, remote] : m_remotes) {
+                if (now - remote.lastSeen < timeout)
+                    awake << QString("remote 0x%1").arg(id, 2, 16, QChar('0'));
+            }
+            return CANResult::Failure(QString("Network still awake after %1 ms: %2")
+                                          .arg(timeoutMs).arg(awake.join(", ")));
+        }
+
+        const Clock::time_point until = cancel ? std::min(deadline, now + CANCEL_CHECK_INTERVAL) : deadline;
+        m_changed.wait(&m_mutex, QDeadlineTimer(until));
+    }
+    return CANResult::Success();
+}
+
+// ============================================================================
+//  Status
+// ============================================================================
+
+CANNetworkManagement::Status CANNetworkManagement::status() const
+{
+    QMutexLocker locker(&m_mutex);
+    const Clock::time_point now = Clock::now();
+
+    Status status;
+    status.running  = m_thread != nullptr;
+    status.busSleep = m_busSleep;
+    status.pdusReceived = m_pdusReceived;
+    for (const Node& node : m_nodes)
+        status.nodes.append({node.id, node.state, node.requested});
+
+    const auto timeout = std::chrono::milliseconds(m_config.timeoutMs);
+    for (const auto& [id, remote] : m_remotes) {
+        RemoteNode entry;
+        entry.nodeId  = id;
+        entry.canId   = remote.canId;
+        entry.lastCbv = remote.lastCbv;
+        entry.pdus    = remote.pdus;
+        entry.lastSeenMsAgo = elapsedMs(now - remote.lastSeen);
+        entry.awake   = now - remote.lastSeen < timeout;
+        status.remotes.append(entry);
+    }
+
+    if (m_releasedAt != Clock::time_point{}) {
+        status.sinceReleaseMs = elapsedMs(now - m_releasedAt);
+        if (m_busSleep && m_sleepAt >= m_releasedAt)
+            status.sleepAfterReleaseMs = elapsedMs(m_sleepAt - m_releasedAt);
+    }
+    return status;
+}
+
+QString CANNetworkManagement::stateName(State state)
+{
+    switch (state) {
+    case State::BusSleep:        return QStringLiteral("Bus-Sleep");
+    case State::PrepareBusSleep: return QStringLiteral("Prepare Bus-Sleep");
+    case State::RepeatMessage:   return QStringLiteral("Repeat Message");
+    case State::NormalOperation: return QStringLiteral("Normal Operation");
+    case State::ReadySleep:      return QStringLiteral("Ready Sleep");
+    }
+    return QString();
+}
+
+// ============================================================================
+//  Receive Path (dispatcher thread)
+// ============================================================================
+
+bool CANNetworkManagement::isNmPdu(const CANMessage& msg) const
+{
+    return !msg.isError && !msg.isTxConfirm && !msg.isRemote && msg.isExtended == m_config.extendedIds
+        && (msg.id & m_config.idMask) == (m_config.baseId & m_config.idMask);
+}
+
+uint8_t CANNetworkManagement::sourceNode(const CANMessage& msg) const
+{
+    if (m_config.nidPosition >= 0 && msg.dataLength() > m_config.nidPosition)
+        return msg.data[m_config.nidPosition];
+    return static_cast<uint8_t>(msg.id - m_config.baseId);
+}
+
+void CANNetworkManagement::onFrames(const CANMessage* frames, int count)
+{
+    const Clock::time_point now = Clock::now();
+    QMutexLocker locker(&m_mutex);
+    if (!m_thread)
+        return;
+
+    bool received = false;
+    for (int i = 0; i < count; ++i) {
+        const CANMessage& msg = frames[i];
+        if (!isNmPdu(msg))
+            continue;
+
+        const uint8_t cbv = m_config.cbvPosition >= 0 && msg.dataLength() > m_config.cbvPosition
+                                ? msg.data[m_config.cbvPosition] : 0;
+        Remote& remote  = m_remotes[sourceNode(msg)];
+        remote.canId    = msg.id;
+        remote.lastCbv  = cbv;
+        remote.lastSeen = now;
+        ++remote.pdus;
+        ++m_pdusReceived;
+
+        for (Node& node : m_nodes)
+            onRemotePduLocked(node, cbv, now);
+        received = true;
+    }
+
+    // Transmit changes are left to the engine thread so the dispatcher never waits on TX
+    if (received) {
+        updateBusSleepLocked(now);
+        m_wake.wakeAll();
+    }
+}
+
+// ============================================================================
+//  State Machine
+// ============================================================================
+
+void CANNetworkManagement::enterRepeatMessageLocked(Node& node, Clock::time_point now)
+{
+    node.state = State::RepeatMessage;
+    node.repeatDeadline = now + std::chrono::milliseconds(m_config.repeatMessageMs);
+}
+
+void CANNetworkManagement::enterReadySleepLocked(Node& node, Clock::time_point now)
+{
+    // Our own PDUs stop here, so the NM timeout runs from now
+    node.state = State::ReadySleep;
+    node.timeoutDeadline = now + std::chrono::milliseconds(m_config.timeoutMs);
+}
+
+void CANNetworkManagement::onRemotePduLocked(Node& node, uint8_t cbv, Clock::time_point now)
+{
+    switch (node.state) {
+    case State::BusSleep:
+        break;      // Network start indication only; without a request the node stays asleep
+    case State::PrepareBusSleep:
+        enterRepeatMessageLocked(node, now);
+        break;
+    case State::RepeatMessage:
+        break;
+    case State::NormalOperation:
+    case State::ReadySleep:
+        if (cbv & CBV_REPEAT_MESSAGE_REQUEST)
+            enterRepeatMessageLocked(node, now);
+        else
+            node.timeoutDeadline = now + std::chrono::milliseconds(m_config.timeoutMs);
+        break;
+    }
+}
+
+void CANNetworkManagement::processTimersLocked(Clock::time_point now)
+{
+    for (Node& node : m_nodes) {
+        // In this order a node can pass through several states in one call
+        if (node.state == State::RepeatMessage && now >= node.repeatDeadline) {
+            if (node.requested)
+                node.state = State::NormalOperation;
+            else
+                enterReadySleepLocked(node, node.repeatDeadline);
+        }
+        if (node.state == State::ReadySleep && now >= node.timeoutDeadline) {
+            node.state = State::PrepareBusSleep;
+            node.activeWakeup  = false;     // Network Mode left
+            node.sleepDeadline = node.timeoutDeadline + std::chrono::milliseconds(m_config.waitBusSleepMs);
+        }
+        if (node.state == State::PrepareBusSleep && now >= node.sleepDeadline)
+            node.state = State::BusSleep;
+    }
+    updateBusSleepLocked(now);
+}
+
+CANNetworkManagement::Clock::time_point CANNetworkManagement::nextDeadlineLocked() const
+{
+    Clock::time_point next = Clock::time_point::max();
+    for (const Node& node : m_nodes) {
+        switch (node.state) {
+        case State::RepeatMessage:   next = std::min(next, node.repeatDeadline);  break;
+        case State::ReadySleep:      next = std::min(next, node.timeoutDeadline); break;
+        case State::PrepareBusSleep: next = std::min(next, node.sleepDeadline);   break;
+        default:                     break;
+        }
+    }
+
+    // Remote nodes stop counting as awake one NM timeout after their last PDU
+    const Clock::time_point now = Clock::now();
+    const auto timeout = std::chrono::milliseconds(m_config.timeoutMs);
+    for (const auto& [id, remote] : m_remotes) {
+        if (remote.lastSeen + timeout > now)
+            next = std::min(next, remote.lastSeen + timeout);
+    }
+    return next;
+}
+
+bool CANNetworkManagement::isBusSleepLocked(Clock::time_point now) const
+{
+    const bool localAsleep = std::all_of(m_nodes.cbegin(), m_nodes.cend(),
+                                         [](const Node& node) { return node.state == State::BusSleep; });
+    if (!localAsleep)
+        return false;
+
+    const auto timeout = std::chrono::milliseconds(m_config.timeoutMs);
+    return std::all_of(m_remotes.cbegin(), m_remotes.cend(),
+                       [&](const auto& entry) { return now - entry.second.lastSeen >= timeout; });
+}
+
+void CANNetworkManagement::updateBusSleepLocked(Clock::time_point now)
+{
+    const bool asleep = isBusSleepLocked(now);
+    if (asleep == m_busSleep)
+        return;
+
+    m_busSleep = asleep;
+    if (asleep) {
+        m_sleepAt = now;
+        qDebug() << "[CanNm]" << m_config.slotName << "bus sleep"
+                 << (m_releasedAt != Clock::time_point{}
+                         ? QString("%1 ms after release").arg(elapsedMs(now - m_releasedAt))
+                         : QString());
+    }
+    m_changed.wakeAll();
+}
+
+// ============================================================================
+//  Transmit Path (engine thread)
+// ============================================================================
+
+CANMessage CANNetworkManagement::pdu(const Node& node, uint8_t cbv) const
+{
+    CANMessage msg;
+    msg.id         = m_config.baseId + node.id;
+    msg.isExtended = m_config.extendedIds;
+    msg.dlc        = static_cast<uint8_t>(m_config.pduLength);
+    std::fill_n(msg.data, m_config.pduLength, m_config.userData);
+    if (m_config.nidPosition >= 0)
+        msg.data[m_config.nidPosition] = node.id;
+    if (m_config.cbvPosition >= 0)
+        msg.data[m_config.cbvPosition] = cbv;
+    return msg;
+}
+
+void CANNetworkManagement::syncTransmitLocked()
+{
+    auto& can = CANBusManager::instance();
+    for (Node& node : m_nodes) {
+        const bool send  = node.state == State::RepeatMessage || node.state == State::NormalOperation;
+        const uint8_t cbv = node.activeWakeup ? CBV_ACTIVE_WAKEUP : 0;
+
+        if (send && !node.transmitting) {
+            const auto result = can.startCyclic(m_config.slotName, pdu(node, cbv), m_config.msgCycleMs,
+                                                m_config.msgCycleOffsetMs);
+            if (!result.success) {
+                qWarning() << "[CanNm]" << m_config.slotName << "node" << int(node.id)
+                           << "cannot send NM PDUs:" << result.errorMessage;
+                continue;
+            }
+            node.transmitting = true;
+            node.sentCbv = cbv;
+        } else if (send && cbv != node.sentCbv) {
+            if (can.updateCyclic(m_config.slotName, pdu(node, cbv)).success)
+                node.sentCbv = cbv;
+        } else if (!send && node.transmitting) {
+            can.stopCyclic(m_config.slotName, m_config.baseId + node.id, m_config.extendedIds);
+            node.transmitting = false;
+        }
+    }
+}
+
+void CANNetworkManagement::stopTransmitLocked()
+{
+    auto& can = CANBusManager::instance();
+    for (Node& node : m_nodes) {
+        if (node.transmitting)
+            can.stopCyclic(m_config.slotName, m_config.baseId + node.id, m_config.extendedIds);
+        node.transmitting = false;
+    }
+}
+
+void CANNetworkManagement::run()
+{
+    QMutexLocker locker(&m_mutex);
+    while (!m_stopping) {
+        processTimersLocked(Clock::now());
+        syncTransmitLocked();
+
+        const Clock::time_point next = nextDeadlineLocked();
+        if (next == Clock::time_point::max())
+            m_wake.wait(&m_mutex, QDeadlineTimer(QDeadlineTimer::Forever));
+        else
+            m_wake.wait(&m_mutex, QDeadlineTimer(next));
+    }
+    stopTransmitLocked();
+}
+
+} // namespace CANManager
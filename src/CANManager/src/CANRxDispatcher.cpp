@@ -0,0 +1,423 @@
+/**
+ * @file CANRxDispatcher.cpp
+ * @brief Per-slot receive thread — implementation.
+ */
+
+#include "CANRxDispatcher.h"
+
+#include <QDeadlineTimer>
+
+#include <algorithm>
+
+namespace CANManager {
+
+static QDeadlineTimer deadlineFor(int timeoutMs)
+{
+    return timeoutMs < 0 ? QDeadlineTimer(QDeadlineTimer::Forever)
+                         : QDeadlineTimer(timeoutMs);
+}
+
+// ============================================================================
+//  Subscription
+// ============================================================================
+
+CANRxDispatcher::Subscription::Subscription(const CANIdFilter& filter, size_t capacity)
+    : m_filter(filter)
+    , m_ring(capacity)
+{
+}
+
+int CANRxDispatcher::Subscription::take(CANMessage* out, int maxFrames)
+{
+    if (maxFrames <= 0)
+        return 0;
+
+    QMutexLocker locker(&m_consumerMutex);
+    return static_cast<int>(m_ring.popBatch(static_cast<size_t>(maxFrames),
+                                            [out](size_t i, const Entry& entry) { out[i] = entry.msg; }));
+}
+
+int CANRxDispatcher::Subscription::take(CANMessage* out, Clock::time_point* arrivals, int maxFrames)
+{
+    if (maxFrames <= 0)
+        return 0;
+
+    QMutexLocker locker(&m_consumerMutex);
+    return static_cast<int>(m_ring.popBatch(static_cast<size_t>(maxFrames),
+                                            [out, arrivals](size_t i, const Entry& entry) {
+                                                out[i]      = entry.msg;
+                                                arrivals[i] = entry.arrival;
+                                            }));
+}
+
+bool CANRxDispatcher::Subscription::waitForFrames(int timeoutMs)
+{
+    if (!m_ring.empty())
+        return true;
+    if (timeoutMs == 0 || isClosed())
+        return false;
+
+    QMutexLocker locker(&m_waitMutex);
+    m_sleepers.fetch_add(1);
+    // Pairs with the fence in notify(): either we see the frames, or the
+    // producer sees a sleeper and signals under m_waitMutex.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const QDeadlineTimer deadline = deadlineFor(timeoutMs);
+    while (m_ring.empty() && !isClosed()) {
+        if (!m_waitCond.wait(&m_waitMutex, deadline))
+            break;
+    }
+    m_sleepers.fetch_sub(1);
+    return !m_ring.empty();
+}
+
+void CANRxDispatcher::Subscription::clear()
+{
+    QMutexLocker locker(&m_consumerMutex);
+    m_ring.clear();
+}
+
+void CANRxDispatcher::Subscription::push(const CANMessage& msg, Clock::time_point arrival)
+{
+    if (!m_ring.push({msg, arrival}))
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CANRxDispatcher::Subscription::notify()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_relaxed) > 0) {
+        QMutexLocker locker(&m_waitMutex);
+        m_waitCond.wakeAll();
+    }
+}
+
+void CANRxDispatcher::Subscription::close()
+{
+    m_closed.store(true, std::memory_order_release);
+    QMutexLocker locker(&m_waitMutex);
+    m_waitCond.wakeAll();
+}
+
+// ============================================================================
+//  Constructor / Destructor
+// ============================================================================
+
+CANRxDispatcher::CANRxDispatcher(ICANDriver* driver, const QString& slotName,
+                                 CANBusStatistics* statistics)
+    : m_driver(driver)
+    , m_slotName(slotName)
+    , m_statistics(statistics)
+    , m_routes(buildRoutes({}))
+{
+}
+
+CANRxDispatcher::~CANRxDispatcher()
+{
+    requestStop();
+    join();
+}
+
+// ============================================================================
+//  Lifecycle
+// ============================================================================
+
+void CANRxDispatcher::start()
+{
+    if (m_thread)
+        return;
+
+    m_stopping.store(false);
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->setObjectName(QStringLiteral("CAN_RX_%1").arg(m_slotName));
+    m_thread->start(QThread::HighPriority);
+}
+
+void CANRxDispatcher::requestStop()
+{
+    m_stopping.store(true, std::memory_order_release);
+
+    m_slotQueue.close();
+    {
+        QMutexLocker locker(&m_subscribeMutex);
+        for (const auto& subscription : m_routes.load()->owners)
+            subscription->close();
+    }
+
+    QMutexLocker locker(&m_waiterMutex);
+    for (const auto& waiter : m_waiters)
+        waiter->cond.wakeAll();
+}
+
+void CANRxDispatcher::join()
+{
+    if (!m_thread)
+        return;
+
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+}
+
+void CANRxDispatcher::run()
+{
+    CANMessage batch[MAX_BATCH];
+    while (!m_stopping.load(std::memory_order_acquire)) {
+        int count = 0;
+        CANResult result = m_driver->receiveBatch(batch, count, POLL_INTERVAL_MS);
+        if (count > 0) {
+            if (m_statistics)
+                m_statistics->onReceived(batch, count);
+            dispatch(batch, count, Clock::now());
+        }
+        if (m_statistics)
+            m_statistics->sampleIfDue();
+
+        // Channel closed underneath the slot: don't spin on "Channel not open"
+        if (!result.success && count == 0
+            && !m_stopping.load(std::memory_order_acquire) && !m_driver->isOpen())
+            QThread::msleep(POLL_INTERVAL_MS);
+    }
+}
+
+// ============================================================================
+//  Dispatch
+// ============================================================================
+
+void CANRxDispatcher::dispatch(const CANMessage* frames, int count, Clock::time_point arrival)
+{
+    const auto routes = m_routes.load();
+    std::vector<Subscription*>& touched = m_batchTouched;
+
+    for (const auto& tap : routes->taps)
+        tap->onFrames(frames, count);
+
+    auto deliver = [&touched, arrival](Subscription* subscription, const CANMessage& msg) {
+        if (!subscription->m_filter.matches(msg))
+            return;
+        subscription->push(msg, arrival);
+        if (!subscription->m_touched) {
+            subscription->m_touched = true;
+            touched.push_back(subscription);
+        }
+    };
+
+    for (int i = 0; i < count; ++i) {
+        const CANMessage& msg = frames[i];
+
+        if (msg.isExtended) {
+            auto it = routes->extended.find(msg.id);
+            if (it != routes->extended.end()) {
+                for (Subscription* subscription : it->second)
+                    deliver(subscription, msg);
+            }
+        } else if (msg.id < STANDARD_ID_COUNT) {
+            for (Subscription* subscription : routes->standard[msg.id])
+                deliver(subscription, msg);
+        }
+        for (Subscription* subscription : routes->filtered)
+            deliver(subscription, msg);
+
+        if (m_waiterCount.load(std::memory_order_acquire) > 0)
+            completeWaiters(msg);
+
+        // Last, so a frame seen by receive() has already reached every subscriber
+        m_slotQueue.push(msg, arrival);
+    }
+
+    // One wake-up per consumer per batch
+    size_t fullestSubscription = 0;
+    m_slotQueue.notify();
+    for (Subscription* subscription : touched) {
+        subscription->m_touched = false;
+        fullestSubscription = std::max(fullestSubscription, subscription->pending());
+        subscription->notify();
+    }
+    touched.clear();
+
+    if (m_statistics)
+        m_statistics->updateQueueHighWater(m_slotQueue.pending(), fullestSubscription);
+}
+
+std::shared_ptr<const CANRxDispatcher::Routes>
+CANRxDispatcher::buildRoutes(std::vector<std::shared_ptr<Subscription>> owners,
+                             std::vector<std::shared_ptr<Tap>> taps)
+{
+    auto routes = std::make_shared<Routes>();
+    routes->standard.resize(STANDARD_ID_COUNT);
+
+    for (const auto& owner : owners) {
+        Subscription* subscription = owner.get();
+        const CANIdFilter& filter = subscription->filter();
+
+        if (filter.mask != 0x1FFFFFFF) {
+            routes->filtered.push_back(subscription);
+            continue;
+        }
+
+        // Exact ID: index it under every frame format it can match
+        const bool standard = filter.anyFormat || !filter.extended;
+        const bool extended = filter.anyFormat || filter.extended;
+        if (standard && filter.id < STANDARD_ID_COUNT)
+            routes->standard[filter.id].push_back(subscription);
+        if (extended)
+            routes->extended[filter.id].push_back(subscription);
+    }
+
+    routes->owners = std::move(owners);
+    routes->taps   = std::move(taps);
+    return routes;
+}
+
+// ============================================================================
+//  Subscriptions
+// ============================================================================
+
+std::shared_ptr<CANRxDispatcher::Subscription>
+CANRxDispatcher::subscribe(const CANIdFilter& filter, size_t capacity)
+{
+    auto subscription = std::make_shared<Subscription>(filter, capacity);
+
+    QMutexLocker locker(&m_subscribeMutex);
+    if (m_stopping.load(std::memory_order_acquire)) {
+        subscription->close();
+        return subscription;
+    }
+
+    const auto current = m_routes.load();
+    auto owners = current->owners;
+    owners.push_back(subscription);
+    m_routes.store(buildRoutes(std::move(owners), current->taps));
+    return subscription;
+}
+
+void CANRxDispatcher::unsubscribe(const std::shared_ptr<Subscription>& subscription)
+{
+    if (!subscription)
+        return;
+
+    QMutexLocker locker(&m_subscribeMutex);
+    const auto current = m_routes.load();
+    auto owners = current->owners;
+    auto it = std::find(owners.begin(), owners.end(), subscription);
+    if (it != owners.end()) {
+        owners.erase(it);
+        m_routes.store(buildRoutes(std::move(owners), current->taps));
+    }
+    subscription->close();
+}
+
+// ============================================================================
+//  Taps
+// ============================================================================
+
+void CANRxDispatcher::addTap(const std::shared_ptr<Tap>& tap)
+{
+    if (!tap)
+        return;
+
+    QMutexLocker locker(&m_subscribeMutex);
+    const auto current = m_routes.load();
+    auto taps = current->taps;
+    taps.push_back(tap);
+    m_routes.store(buildRoutes(current->owners, std::move(taps)));
+}
+
+void CANRxDispatcher::removeTap(const std::shared_ptr<Tap>& tap)
+{
+    QMutexLocker locker(&m_subscribeMutex);
+    const auto current = m_routes.load();
+    auto taps = current->taps;
+    auto it = std::find(taps.begin(), taps.end(), tap);
+    if (it == taps.end())
+        return;
+
+    taps.erase(it);
+    m_routes.store(buildRoutes(current->owners, std::move(taps)));
+}
+
+// ============================================================================
+//  Slot Receive Queue
+// ============================================================================
+
+CANResult CANRxDispatcher::receive(CANMessage& msg, int timeoutMs)
+{
+    const QDeadlineTimer deadline = deadlineFor(timeoutMs);
+    for (;;) {
+        if (m_slotQueue.take(msg))
+            return CANResult::Success();
+        if (m_slotQueue.isClosed())
+            return CANResult::Failure("Slot closed");
+        if (timeoutMs == 0 || deadline.hasExpired())
+            return CANResult::Failure("Receive timeout");
+
+        m_slotQueue.waitForFrames(static_cast<int>(deadline.remainingTime()));
+    }
+}
+
+void CANRxDispatcher::flush()
+{
+    m_slotQueue.clear();
+}
+
+// ============================================================================
+//  Response Waiters
+// ============================================================================
+
+std::shared_ptr<CANRxDispatcher::Waiter> CANRxDispatcher::arm(const CANIdFilter& filter)
+{
+    auto waiter = std::make_shared<Waiter>();
+    waiter->filter = filter;
+
+    QMutexLocker locker(&m_waiterMutex);
+    m_waiters.push_back(waiter);
+    m_waiterCount.store(static_cast<int>(m_waiters.size()), std::memory_order_seq_cst);
+    return waiter;
+}
+
+void CANRxDispatcher::completeWaiters(const CANMessage& msg)
+{
+    QMutexLocker locker(&m_waiterMutex);
+    for (const auto& waiter : m_waiters) {
+        if (!waiter->done && waiter->filter.matches(msg)) {
+            waiter->msg  = msg;
+            waiter->done = true;
+            waiter->cond.wakeAll();
+        }
+    }
+}
+
+bool CANRxDispatcher::waitForResponse(const std::shared_ptr<Waiter>& waiter,
+                                      int timeoutMs, CANMessage& msg)
+{
+    QMutexLocker locker(&m_waiterMutex);
+
+    const QDeadlineTimer deadline = deadlineFor(timeoutMs);
+    while (!waiter->done && !m_stopping.load(std::memory_order_acquire)) {
+        if (!waiter->cond.wait(&m_waiterMutex, deadline))
+            break;
+    }
+
+    const bool completed = waiter->done;
+    if (completed)
+        msg = waiter->msg;
+
+    removeWaiterLocked(waiter);
+    return completed;
+}
+
+void CANRxDispatcher::disarm(const std::shared_ptr<Waiter>& waiter)
+{
+    QMutexLocker locker(&m_waiterMutex);
+    removeWaiterLocked(waiter);
+}
+
+void CANRxDispatcher::removeWaiterLocked(const std::shared_ptr<Waiter>& waiter)
+{
+    m_waiters.erase(std::remove(m_waiters.begin(), m_waiters.end(), waiter),
+                    m_waiters.end());
+    m_waiterCount.store(static_cast<int>(m_waiters.size()), std::memory_order_release);
+}
+
+} // namespace CANManager
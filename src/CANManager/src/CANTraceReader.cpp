@@ -0,0 +1,546 @@
+/**
+ * @file CANTraceReader.cpp
+ * @brief ASC and BLF trace file reader — implementation.
+ */
+
+#include "CANTraceReader.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+namespace CANManager {
+
+namespace {
+
+// ============================================================================
+//  ASC Tokens
+// ============================================================================
+
+using Token = std::string_view;
+
+/// Enough for a CANFD line: header, 64 data bytes and the trailing fields
+constexpr int MAX_ASC_TOKENS = 96;
+
+/// CANFD line flags field: extended data length (the frame really is FD)
+constexpr uint32_t ASC_FD_EDL = 0x1000;
+
+int tokenize(const char* begin, const char* end, Token* tokens, int maxTokens)
+{
+    int count = 0;
+    const char* p = begin;
+    while (count < maxTokens) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            ++p;
+        if (p == end)
+            break;
+        const char* start = p;
+        while (p < end && *p != ' ' && *p != '\t' && *p != '\r')
+            ++p;
+        tokens[count++] = Token(start, static_cast<size_t>(p - start));
+    }
+    return count;
+}
+
+bool parseUnsigned(Token token, int base, uint32_t& value)
+{
+    if (token.empty() || token.size() > 10)
+        return false;
+
+    uint64_t result = 0;
+    for (char c : token) {
+        int digit;
+        if (c >= '0' && c <= '9')
+            digit = c - '0';
+        else if (base == 16 && c >= 'a' && c <= 'f')
+            digit = c - 'a' + 10;
+        else if (base == 16 && c >= 'A' && c <= 'F')
+            digit = c - 'A' + 10;
+        else
+            return false;
+        result = result * static_cast<uint64_t>(base) + static_cast<uint64_t>(digit);
+    }
+    if (result > std::numeric_limits<uint32_t>::max())
+        return false;
+    value = static_cast<uint32_t>(result);
+    return true;
+}
+
+/// "12.345678" → ns, without going through floating point
+bool parseTimestamp(Token token, uint64_t& ns)
+{
+    const size_t dot = token.find('.');
+    if (dot == 0 || dot == Token::npos)
+        return false;
+
+    uint64_t seconds = 0;
+    for (size_t i = 0; i < dot; ++i) {
+        if (token[i] < '0' || token[i] > '9')
+            return false;
+        seconds = seconds * 10 + static_cast<uint64_t>(token[i] - '0');
+    }
+
+    uint64_t fraction = 0;
+    int digits = 0;
+    for (size_t i = dot + 1; i < token.size(); ++i) {
+        if (token[i] < '0' || token[i] > '9')
+            return false;
+        if (digits < 9) {
+            fraction = fraction * 10 + static_cast<uint64_t>(token[i] - '0');
+            ++digits;
+        }
+    }
+    for (; digits < 9; ++digits)
+        fraction *= 10;
+
+    ns = seconds * 1000000000u + fraction;
+    return true;
+}
+
+/// "123", "18DAF110x" (extended)
+bool parseId(Token token, int base, uint32_t& id, bool& extended)
+{
+    extended = !token.empty() && (token.back() == 'x' || token.back() == 'X');
+    if (extended)
+        token.remove_suffix(1);
+    return parseUnsigned(token, base, id) && id <= 0x1FFFFFFF;
+}
+
+bool isFlagDigit(Token token)
+{
+    return token == "0" || token == "1";
+}
+
+// ============================================================================
+//  BLF Layout (see CANTraceWriter.cpp)
+// ============================================================================
+
+constexpr int      BLF_OBJ_HEADER_BASE_SIZE  = 16;
+constexpr int      BLF_OBJ_HEADER_MIN_SIZE   = 32;      ///< Base + V1/V2 fields up to the timestamp
+constexpr int      BLF_CONTAINER_DATA_OFFSET = 32;
+
+constexpr uint32_t BLF_CAN_MESSAGE       = 1;
+constexpr uint32_t BLF_LOG_CONTAINER     = 10;
+constexpr uint32_t BLF_CAN_MESSAGE2      = 86;
+constexpr uint32_t BLF_CAN_FD_MESSAGE    = 100;
+constexpr uint32_t BLF_CAN_FD_MESSAGE_64 = 101;
+
+constexpr uint32_t BLF_TIME_TEN_MICS     = 0x00000001;
+constexpr uint16_t BLF_NO_COMPRESSION    = 0;
+constexpr uint16_t BLF_ZLIB_DEFLATE      = 2;
+
+constexpr uint8_t  BLF_DIR_TX            = 0x01;
+constexpr uint8_t  BLF_REMOTE_FLAG       = 0x80;
+constexpr uint32_t BLF_EXTENDED_ID       = 0x80000000u;
+constexpr uint8_t  BLF_FD_EDL            = 0x01;
+constexpr uint8_t  BLF_FD_BRS            = 0x02;
+constexpr uint32_t BLF_FD64_REMOTE       = 0x0010;
+constexpr uint32_t BLF_FD64_EDL          = 0x1000;
+constexpr uint32_t BLF_FD64_BRS          = 0x2000;
+
+template <typename T>
+T get(const char* p)
+{
+    return qFromLittleEndian<T>(p);
+}
+
+/**
+ * Objects are padded to 4 bytes at file level but not inside containers;
+ * the next "LOBJ" is at most a few bytes ahead either way.
+ */
+int findObject(const char* bytes, int pos, int size)
+{
+    for (int k = pos; k + 4 <= size && k < pos + 8; ++k) {
+        if (std::memcmp(bytes + k, "LOBJ", 4) == 0)
+            return k;
+    }
+    return -1;
+}
+
+} // namespace
+
+// ============================================================================
+//  Load
+// ============================================================================
+
+void CANTraceReader::clear()
+{
+    m_frames.clear();
+    m_data.clear();
+    m_format  = CANTraceFormat::Asc;
+    m_skipped = 0;
+}
+
+CANResult CANTraceReader::load(const QString& path)
+{
+    clear();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return CANResult::Failure(QString("Cannot open %1: %2").arg(path, file.errorString()));
+
+    qint64 size = file.size();
+    if (size <= 0)
+        return CANResult::Failure(QString("%1 is empty").arg(path));
+
+    // Map the whole file; read it instead where mapping is not possible
+    QByteArray contents;
+    uchar* mapped = file.map(0, size);
+    const char* bytes = reinterpret_cast<const char*>(mapped);
+    if (!mapped) {
+        contents = file.readAll();
+        bytes = contents.constData();
+        size = contents.size();
+    }
+
+    CANResult result = CANResult::Success();
+    if (size >= 4 && std::memcmp(bytes, "LOGG", 4) == 0) {
+        m_format = CANTraceFormat::Blf;
+        result = parseBlf(bytes, size);
+    } else {
+        m_format = CANTraceFormat::Asc;
+        m_frames.reserve(static_cast<size_t>(size / 64));
+        m_data.reserve(static_cast<size_t>(size / 8));
+        parseAsc(bytes, size);
+    }
+
+    if (mapped)
+        file.unmap(mapped);
+
+    if (!result.success) {
+        clear();
+        return result;
+    }
+    if (m_frames.empty())
+        return CANResult::Failure(QString("No CAN frames in %1").arg(path));
+
+    finish();
+    qDebug() << "[CANTrace] Loaded" << m_frames.size() << "frames from" << path
+             << "(" << m_skipped << "records skipped)";
+    return CANResult::Success();
+}
+
+void CANTraceReader::append(uint64_t timestamp, uint32_t id, uint16_t channel, uint8_t dlc,
+                            uint8_t flags, const uint8_t* payload, int length)
+{
+    if (m_data.size() + 64 > std::numeric_limits<uint32_t>::max()) {
+        ++m_skipped;
+        return;
+    }
+
+    Frame frame;
+    frame.timestamp  = timestamp;
+    frame.id         = id;
+    frame.dataOffset = static_cast<uint32_t>(m_data.size());
+    frame.channel    = channel;
+    frame.dlc        = dlc & 0x0F;
+    frame.flags      = flags;
+
+    // Keep exactly dataLength() bytes; a short record is padded with zeros
+    const int needed = frame.dataLength();
+    const int copied = std::min(needed, std::max(length, 0));
+    m_data.insert(m_data.end(), payload, payload + copied);
+    m_data.resize(m_data.size() + static_cast<size_t>(needed - copied), 0);
+    m_frames.push_back(frame);
+}
+
+void CANTraceReader::finish()
+{
+    const auto byTime = [](const Frame& a, const Frame& b) { return a.timestamp < b.timestamp; };
+    if (!std::is_sorted(m_frames.begin(), m_frames.end(), byTime))
+        std::stable_sort(m_frames.begin(), m_frames.end(), byTime);
+
+    const uint64_t start = m_frames.front().timestamp;
+    for (Frame& frame : m_frames)
+        frame.timestamp -= start;
+}
+
+CANMessage CANTraceReader::message(const Frame& frame) const
+{
+    CANMessage msg;
+    msg.id         = frame.id;
+    msg.dlc        = frame.dlc;
+    msg.isExtended = frame.flags & Extended;
+    msg.isFD       = frame.flags & FD;
+    msg.isBRS      = frame.flags & BRS;
+    msg.isRemote   = frame.flags & Remote;
+    msg.timestamp  = frame.timestamp;
+    std::memcpy(msg.data, data(frame), static_cast<size_t>(frame.dataLength()));
+    return msg;
+}
+
+// ============================================================================
+//  ASC
+// ============================================================================
+
+void CANTraceReader::parseAsc(const char* text, qint64 size)
+{
+    int  base = 16;
+    bool relative = false;
+    uint64_t previous = 0;
+
+    Token tok[MAX_ASC_TOKENS];
+    uint8_t payload[64];
+
+    // Data bytes start at tok[first]; false if the line is too short
+    const auto parseData = [&](int first, int count, int length, int dataBase) {
+        if (first + length > count)
+            return false;
+        for (int i = 0; i < length; ++i) {
+            uint32_t byte;
+            if (!parseUnsigned(tok[first + i], dataBase, byte) || byte > 0xFF)
+                return false;
+            payload[i] = static_cast<uint8_t>(byte);
+        }
+        return true;
+    };
+
+    const char* p   = text;
+    const char* end = text + size;
+    while (p < end) {
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!eol)
+            eol = end;
+        const int n = tokenize(p, eol, tok, MAX_ASC_TOKENS);
+        p = eol + 1;
+        if (n == 0)
+            continue;
+
+        uint64_t timestamp;
+        if (!parseTimestamp(tok[0], timestamp)) {
+            // Header, comment or Begin/End Triggerblock
+            if (tok[0] == "base" && n >= 4) {
+                base     = tok[1] == "dec" ? 10 : 16;
+                relative = tok[3] == "relative";
+            }
+            continue;
+        }
+        if (relative) {
+            timestamp += previous;
+            previous = timestamp;
+        }
+
+        uint32_t channel = 0, id = 0, dlc = 0;
+        bool extended = false;
+
+        if (n >= 9 && tok[1] == "CANFD") {
+            // CANFD <ch> <dir> <id> [<name>] <brs> <esi> <dlc> <length> <data...> <duration> <bits> <flags> ...
+            int i = 5;
+            if (!(isFlagDigit(tok[i]) && isFlagDigit(tok[i + 1])))
+                ++i;                            // Symbolic message name
+            uint32_t length = 0;
+            if (i + 3 >= n
+                || !parseUnsigned(tok[2], 10, channel)
+                || !parseId(tok[4], base, id, extended)
+                || !parseUnsigned(tok[i + 2], 16, dlc) || dlc > 15
+                || !parseUnsigned(tok[i + 3], 10, length) || length > 64
+                || !parseData(i + 4, n, static_cast<int>(length), base)) {
+                ++m_skipped;
+                continue;
+            }
+
+            // A classic frame on an FD channel has the EDL flag clear
+            bool fd = true;
+            const int flagsAt = i + 4 + static_cast<int>(length) + 2;
+            uint32_t lineFlags = 0;
+            if (flagsAt < n && parseUnsigned(tok[flagsAt], 16, lineFlags))
+                fd = lineFlags & ASC_FD_EDL;
+
+            uint8_t flags = (extended ? Extended : 0) | (tok[3] == "Tx" ? Tx : 0);
+            if (fd)
+                flags |= FD | (tok[i] == "1" ? BRS : 0);
+            append(timestamp, id, static_cast<uint16_t>(channel), static_cast<uint8_t>(dlc),
+                   flags, payload, static_cast<int>(length));
+            continue;
+        }
+
+        // <ch> <id> <dir> d|r <dlc> <data...>
+        if (n < 6 || !parseUnsigned(tok[1], 10, channel) || !parseId(tok[2], base, id, extended)
+            || (tok[4] != "d" && tok[4] != "r") || !parseUnsigned(tok[5], base, dlc) || dlc > 15) {
+            ++m_skipped;                        // ErrorFrame, statistics, events
+            continue;
+        }
+
+        const bool remote = tok[4] == "r";
+        const int length = remote ? 0 : static_cast<int>(std::min<uint32_t>(dlc, 8));
+        if (!parseData(6, n, length, base)) {
+            ++m_skipped;
+            continue;
+        }
+
+        const uint8_t flags = (extended ? Extended : 0) | (remote ? Remote : 0)
+                              | (tok[3] == "Tx" ? Tx : 0);
+        append(timestamp, id, static_cast<uint16_t>(channel), static_cast<uint8_t>(dlc),
+               flags, payload, length);
+    }
+}
+
+// ============================================================================
+//  BLF
+// ============================================================================
+
+CANResult CANTraceReader::parseBlf(const char* bytes, qint64 size)
+{
+    if (size < 8)
+        return CANResult::Failure("BLF file header truncated");
+
+    // Decompressed container data not parsed yet: objects may span containers
+    QByteArray pending;
+
+    qint64 pos = get<uint32_t>(bytes + 4);
+    while (pos + BLF_OBJ_HEADER_BASE_SIZE <= size) {
+        const qint64 window = std::min<qint64>(size - pos, 8);
+        const int found = findObject(bytes + pos, 0, static_cast<int>(window));
+        if (found < 0)
+            break;
+        pos += found;
+        if (pos + BLF_OBJ_HEADER_BASE_SIZE > size)
+            break;
+
+        const uint32_t objSize = get<uint32_t>(bytes + pos + 8);
+        const uint32_t type    = get<uint32_t>(bytes + pos + 12);
+        if (objSize < BLF_OBJ_HEADER_BASE_SIZE || pos + objSize > size)
+            break;                              // Truncated, e.g. the recording was cut off
+
+        if (type != BLF_LOG_CONTAINER) {
+            // Object outside a container (older writers)
+            parseBlfObjects(bytes + pos, static_cast<int>(objSize));
+            pos += objSize;
+            continue;
+        }
+
+        if (objSize < BLF_CONTAINER_DATA_OFFSET) {
+            ++m_skipped;
+            pos += objSize;
+            continue;
+        }
+
+        const uint16_t method       = get<uint16_t>(bytes + pos + 16);
+        const uint32_t uncompressed = get<uint32_t>(bytes + pos + 24);
+        const char*    payload      = bytes + pos + BLF_CONTAINER_DATA_OFFSET;
+        const int      length       = static_cast<int>(objSize) - BLF_CONTAINER_DATA_OFFSET;
+
+        if (method == BLF_NO_COMPRESSION) {
+            pending.append(payload, std::min<int>(length, static_cast<int>(uncompressed)));
+        } else if (method == BLF_ZLIB_DEFLATE) {
+            // qUncompress() expects the big-endian output size in front of the zlib stream
+            QByteArray stream;
+            stream.reserve(length + 4);
+            const uint32_t sizeBE = qToBigEndian(uncompressed);
+            stream.append(reinterpret_cast<const char*>(&sizeBE), 4);
+            stream.append(payload, length);
+            const QByteArray inflated = qUncompress(stream);
+            if (inflated.isEmpty())
+                ++m_skipped;
+            pending.append(inflated);
+        } else {
+            ++m_skipped;
+        }
+
+        const int used = parseBlfObjects(pending.constData(), static_cast<int>(pending.size()));
+        pending.remove(0, used);
+        pos += objSize;
+    }
+    return CANResult::Success();
+}
+
+int CANTraceReader::parseBlfObjects(const char* bytes, int size)
+{
+    int pos = 0;
+    for (;;) {
+        const int found = findObject(bytes, pos, size);
+        if (found < 0) {
+            if (size - pos < 8)
+                return pos;                     // Start of an object in the next container
+            ++m_skipped;                        // Garbage: drop the rest
+            return size;
+        }
+        if (found + BLF_OBJ_HEADER_BASE_SIZE > size)
+            return found;
+
+        const uint16_t headerSize = get<uint16_t>(bytes + found + 4);
+        const uint32_t objSize    = get<uint32_t>(bytes + found + 8);
+        const uint32_t type       = get<uint32_t>(bytes + found + 12);
+        if (objSize < headerSize || headerSize < BLF_OBJ_HEADER_BASE_SIZE) {
+            ++m_skipped;
+            return size;
+        }
+        if (objSize > static_cast<uint32_t>(size - found))
+            return found;                       // Continues in the next container
+
+        if (headerSize >= BLF_OBJ_HEADER_MIN_SIZE) {
+            // V1 and V2 headers both hold the flags at 16 and the timestamp at 24
+            const uint32_t timeFlags = get<uint32_t>(bytes + found + 16);
+            uint64_t timestamp = get<uint64_t>(bytes + found + 24);
+            if (timeFlags == BLF_TIME_TEN_MICS)
+                timestamp *= 10000u;
+            parseBlfFrame(type, bytes + found + headerSize, static_cast<int>(objSize - headerSize),
+                          timestamp);
+        } else {
+            ++m_skipped;
+        }
+        pos = found + static_cast<int>(objSize);
+    }
+}
+
+void CANTraceReader::parseBlfFrame(uint32_t type, const char* body, int bodySize, uint64_t timestamp)
+{
+    const auto* bytes = reinterpret_cast<const uint8_t*>(body);
+
+    switch (type) {
+    case BLF_CAN_MESSAGE:
+    case BLF_CAN_MESSAGE2: {
+        // channel u16, flags u8, dlc u8, id u32, data[8]
+        if (bodySize < 16)
+            break;
+        const uint32_t id = get<uint32_t>(body + 4);
+        const uint8_t flags = ((id & BLF_EXTENDED_ID) ? Extended : 0)
+                              | ((bytes[2] & BLF_DIR_TX) ? Tx : 0)
+                              | ((bytes[2] & BLF_REMOTE_FLAG) ? Remote : 0);
+        append(timestamp, id & 0x1FFFFFFF, get<uint16_t>(body), bytes[3], flags, bytes + 8, 8);
+        return;
+    }
+    case BLF_CAN_FD_MESSAGE: {
+        // channel u16, flags u8, dlc u8, id u32, frame length u32, bit count u8,
+        // FD flags u8, valid bytes u8, reserved[5], data[64]
+        if (bodySize < 20)
+            break;
+        const uint32_t id = get<uint32_t>(body + 4);
+        uint8_t flags = ((id & BLF_EXTENDED_ID) ? Extended : 0)
+                        | ((bytes[2] & BLF_DIR_TX) ? Tx : 0);
+        if (bytes[13] & BLF_FD_EDL)
+            flags |= FD | ((bytes[13] & BLF_FD_BRS) ? BRS : 0);
+        else if (bytes[2] & BLF_REMOTE_FLAG)
+            flags |= Remote;
+        append(timestamp, id & 0x1FFFFFFF, get<uint16_t>(body), bytes[3], flags, bytes + 20,
+               std::min<int>(bodySize - 20, bytes[14]));
+        return;
+    }
+    case BLF_CAN_FD_MESSAGE_64: {
+        // channel u8, dlc u8, valid bytes u8, tx count u8, id u32, frame length u32,
+        // flags u32, 4 x timing u32, bit count u16, dir u8, ext offset u8, crc u32, data[]
+        if (bodySize < 40)
+            break;
+        const uint32_t id = get<uint32_t>(body + 4);
+        const uint32_t fdFlags = get<uint32_t>(body + 12);
+        uint8_t flags = ((id & BLF_EXTENDED_ID) ? Extended : 0) | (bytes[34] == 1 ? Tx : 0);
+        if (fdFlags & BLF_FD64_EDL)
+            flags |= FD | ((fdFlags & BLF_FD64_BRS) ? BRS : 0);
+        else if (fdFlags & BLF_FD64_REMOTE)
+            flags |= Remote;
+        append(timestamp, id & 0x1FFFFFFF, bytes[0], bytes[1], flags, bytes + 40,
+               std::min<int>(bodySize - 40, bytes[2]));
+        return;
+    }
+    default:
+        break;
+    }
+    ++m_skipped;
+}
+
+} // namespace CANManager
@@ -0,0 +1,347 @@
+/**
+ * @file CANTraceRecorder.cpp
+ * @brief Streaming CAN trace recorder — implementation.
+ */
+
+#include "CANTraceRecorder.h"
+
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+
+namespace CANManager {
+
+namespace {
+
+/// Records one slot's dispatcher batches under a fixed trace channel
+class RecorderTap : public CANRxDispatcher::Tap
+{
+public:
+    RecorderTap(std::shared_ptr<CANTraceRecorder> recorder, uint16_t channel)
+        : m_recorder(std::move(recorder))
+        , m_channel(channel)
+    {
+    }
+
+    void onFrames(const CANMessage* frames, int count) override
+    {
+        m_recorder->record(m_channel, frames, count);
+    }
+
+private:
+    std::shared_ptr<CANTraceRecorder> m_recorder;
+    uint16_t m_channel;
+};
+
+} // namespace
+
+// ============================================================================
+//  Constructor / Destructor
+// ============================================================================
+
+CANTraceRecorder::CANTraceRecorder(const Options& options)
+    : m_options(options)
+{
+}
+
+CANTraceRecorder::~CANTraceRecorder()
+{
+    stop();
+}
+
+QString CANTraceRecorder::rotatedPath(const QString& path, int index)
+{
+    const QFileInfo info(path);
+    QString name = QString("%1_%2").arg(info.completeBaseName()).arg(index, 3, 10, QChar('0'));
+    if (!info.suffix().isEmpty())
+        name += QLatin1Char('.') + info.suffix();
+    return QDir(info.path()).filePath(name);
+}
+
+// ============================================================================
+//  Lifecycle
+// ============================================================================
+
+CANResult CANTraceRecorder::start()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_running || m_thread)
+        return CANResult::Failure("Trace recorder already running");
+    if (m_options.path.isEmpty())
+        return CANResult::Failure("No trace file given");
+
+    const QFileInfo info(m_options.path);
+    if (!QDir().mkpath(info.absolutePath()))
+        return CANResult::Failure(QString("Cannot create directory %1").arg(info.absolutePath()));
+
+    m_blocks.resize(static_cast<size_t>(qMax(2, m_options.bufferBlocks)));
+    m_free.clear();
+    for (Block& block : m_blocks) {
+        block.frames = std::make_unique<CANTraceFrame[]>(BLOCK_FRAMES);
+        block.count  = 0;
+        m_free.push_back(&block);
+    }
+    m_full.clear();
+    m_current = nullptr;
+    m_channelOffset.clear();
+    m_channelSeen.clear();
+    m_stats     = Stats{};
+    m_startTime = QDateTime::currentDateTime();
+    m_clock.start();
+    m_flushTimer.start();
+
+    // The writer thread is not running yet, so the first file is opened here
+    // and a bad path fails start() instead of showing up later in stats
+    m_writer = CANTraceWriter::create(m_options.format);
+    m_closedBytes = 0;
+    locker.unlock();
+    CANResult result = openNextFile();
+    locker.relock();
+    if (!result.success) {
+        m_writer.reset();
+        m_blocks.clear();
+        m_free.clear();
+        return result;
+    }
+
+    m_running  = true;
+    m_stopping = false;
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->setObjectName(QStringLiteral("CAN_TRACE_WRITER"));
+    m_thread->start();
+
+    qDebug() << "[CANTrace] Recording to" << m_stats.currentFile;
+    return CANResult::Success();
+}
+
+CANResult CANTraceRecorder::stop(Stats* stats)
+{
+    QThread* thread = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_running  = false;
+        m_stopping = true;
+        m_wake.wakeAll();
+        std::swap(thread, m_thread);
+    }
+
+    // The writer drains every queued and partial block before it exits
+    if (thread) {
+        thread->wait();
+        delete thread;
+    }
+
+    CANResult result = CANResult::Success();
+    if (m_writer) {
+        result = m_writer->close();
+        const qint64 bytes = m_closedBytes + m_writer->fileSize();   // Includes the trailer
+        m_writer.reset();
+
+        QMutexLocker locker(&m_mutex);
+        m_stats.bytesWritten = bytes;
+        if (!result.success)
+            setErrorLocked(result.errorMessage);
+        m_blocks.clear();
+        m_free.clear();
+        m_full.clear();
+        m_current = nullptr;
+
+        qDebug() << "[CANTrace] Stopped:" << m_stats.framesWritten << "frames written,"
+                 << m_stats.framesDropped << "dropped," << m_stats.fileCount << "file(s)";
+    }
+
+    if (stats)
+        *stats = this->stats();
+    return result;
+}
+
+bool CANTraceRecorder::isRunning() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_running;
+}
+
+CANTraceRecorder::Stats CANTraceRecorder::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+// ============================================================================
+//  Capture
+// ============================================================================
+
+void CANTraceRecorder::record(uint16_t channel, const CANMessage* frames, int count)
+{
+    if (count <= 0)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_running)
+        return;
+
+    // First frame of a channel: map its driver clock onto the trace clock
+    if (channel >= m_channelSeen.size()) {
+        m_channelSeen.resize(channel + 1u, false);
+        m_channelOffset.resize(channel + 1u, 0);
+    }
+    if (!m_channelSeen[channel]) {
+        m_channelSeen[channel]   = true;
+        m_channelOffset[channel] = static_cast<int64_t>(frames[0].timestamp) - m_clock.nsecsElapsed();
+    }
+    const int64_t offset = m_channelOffset[channel];
+
+    bool queued = false;
+    for (int i = 0; i < count; ++i) {
+        if (!m_current) {
+            if (m_free.empty()) {
+                m_stats.framesDropped += static_cast<uint64_t>(count - i);
+                if (!m_dropping) {
+                    m_dropping = true;
+                    qWarning() << "[CANTrace] Buffer full — disk is not keeping up, dropping frames";
+                }
+                break;
+            }
+            m_current = m_free.back();
+            m_free.pop_back();
+        }
+
+        CANTraceFrame& frame = m_current->frames[m_current->count++];
+        frame.msg     = frames[i];
+        frame.channel = channel;
+        const int64_t ts = static_cast<int64_t>(frames[i].timestamp) - offset;
+        frame.msg.timestamp = ts > 0 ? static_cast<uint64_t>(ts) : 0;
+        ++m_stats.framesRecorded;
+
+        if (m_current->count == BLOCK_FRAMES) {
+            m_full.push_back(m_current);
+            m_current = nullptr;
+            queued = true;
+        }
+    }
+
+    if (queued)
+        m_wake.wakeOne();
+}
+
+std::shared_ptr<CANRxDispatcher::Tap> CANTraceRecorder::createTap(uint16_t channel)
+{
+    return std::make_shared<RecorderTap>(shared_from_this(), channel);
+}
+
+// ============================================================================
+//  Writer Thread
+// ============================================================================
+
+void CANTraceRecorder::run()
+{
+    std::vector<Block*> work;
+
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        if (m_full.empty() && !m_stopping)
+            m_wake.wait(&m_mutex, QDeadlineTimer(FLUSH_INTERVAL_MS));
+
+        work.assign(m_full.begin(), m_full.end());
+        m_full.clear();
+
+        // Keep the file current: also take a partly filled block now and then
+        if (m_current && m_current->count > 0
+            && (m_stopping || m_flushTimer.hasExpired(FLUSH_INTERVAL_MS))) {
+            work.push_back(m_current);
+            m_current = nullptr;
+            m_flushTimer.restart();
+        }
+
+        const bool last = m_stopping;
+        if (!work.empty()) {
+            locker.unlock();
+            for (Block* block : work)
+                writeBlock(*block);
+            locker.relock();
+
+            for (Block* block : work) {
+                block->count = 0;
+                m_free.push_back(block);
+            }
+            m_dropping = false;
+            work.clear();
+        }
+
+        // A stop request is only seen after everything queued before it
+        if (last && m_full.empty() && (!m_current || m_current->count == 0))
+            break;
+    }
+}
+
+void CANTraceRecorder::writeBlock(Block& block)
+{
+    for (int offset = 0; offset < block.count; offset += WRITE_CHUNK) {
+        const int chunk = qMin(WRITE_CHUNK, block.count - offset);
+
+        CANResult result = CANResult::Success();
+        if (rotationDue())
+            result = openNextFile();
+        if (result.success)
+            result = m_writer->write(block.frames.get() + offset, chunk);
+
+        QMutexLocker locker(&m_mutex);
+        if (result.success) {
+            m_stats.framesWritten += static_cast<uint64_t>(chunk);
+            m_stats.bytesWritten   = m_closedBytes + m_writer->fileSize();
+        } else {
+            m_stats.framesDropped += static_cast<uint64_t>(chunk);
+            setErrorLocked(result.errorMessage);
+        }
+    }
+}
+
+bool CANTraceRecorder::rotationDue() const
+{
+    if (!m_writer->isOpen())
+        return true;
+    if (m_options.maxFileBytes > 0 && m_writer->fileSize() >= m_options.maxFileBytes)
+        return true;
+    return m_options.maxFileSeconds > 0
+           && m_fileAge.hasExpired(static_cast<qint64>(m_options.maxFileSeconds) * 1000);
+}
+
+CANResult CANTraceRecorder::openNextFile()
+{
+    if (m_writer->isOpen()) {
+        CANResult result = m_writer->close();
+        m_closedBytes += m_writer->fileSize();      // Includes the trailer
+        if (!result.success)
+            return result;
+    }
+
+    QString path;
+    QDateTime startTime;
+    {
+        QMutexLocker locker(&m_mutex);
+        const bool rotating = m_options.maxFileBytes > 0 || m_options.maxFileSeconds > 0;
+        path = rotating ? rotatedPath(m_options.path, m_stats.fileCount + 1) : m_options.path;
+        startTime = m_startTime;
+    }
+
+    // Rotated files continue the measurement clock
+    CANResult result = m_writer->open(path, startTime);
+    if (!result.success)
+        return result;
+    m_fileAge.start();
+
+    QMutexLocker locker(&m_mutex);
+    ++m_stats.fileCount;
+    m_stats.currentFile = path;
+    return result;
+}
+
+void CANTraceRecorder::setErrorLocked(const QString& error)
+{
+    if (m_stats.lastError != error)
+        qWarning() << "[CANTrace]" << error;
+    m_stats.lastError = error;
+}
+
+} // namespace CANManager
@@ -0,0 +1,355 @@
+/**
+ * @file CANTraceReplayer.cpp
+ * @brief Per-slot ASC / BLF trace replay — implementation.
+ */
+
+#include "CANTraceReplayer.h"
+
+#include <QDeadlineTimer>
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+namespace CANManager {
+
+static double toMicros(std::chrono::steady_clock::duration d)
+{
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+// ============================================================================
+//  Constructor / Destructor
+// ============================================================================
+
+CANTraceReplayer::CANTraceReplayer(ICANDriver* driver, QMutex* txMutex, const QString& slotName,
+                                   CANBusStatistics* statistics)
+    : m_driver(driver)
+    , m_txMutex(txMutex)
+    , m_statistics(statistics)
+    , m_slotName(slotName)
+{
+}
+
+CANTraceReplayer::~CANTraceReplayer()
+{
+    shutdown();
+}
+
+void CANTraceReplayer::shutdown()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_shutdown = true;
+        m_stopping = true;
+        m_wake.wakeAll();
+    }
+    joinThread();
+}
+
+void CANTraceReplayer::joinThread()
+{
+    QThread* thread = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        std::swap(thread, m_thread);
+    }
+    if (thread) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+// ============================================================================
+//  Control
+// ============================================================================
+
+CANResult CANTraceReplayer::start(const Options& options)
+{
+    if (!(options.speed > 0.0))
+        return CANResult::Failure("Replay speed must be greater than 0");
+    if (options.loops < 0)
+        return CANResult::Failure("Replay loop count must not be negative");
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_shutdown)
+            return CANResult::Failure("Slot closed");
+        if (m_running)
+            return CANResult::Failure(QString("A replay is already running on slot '%1'").arg(m_slotName));
+    }
+
+    CANTraceReader trace;
+    CANResult result = trace.load(options.path);
+    if (!result.success)
+        return result;
+
+    // Select and remap once, so the replay thread only walks an array
+    std::vector<CANTraceReader::Frame> schedule;
+    schedule.reserve(trace.frames().size());
+    for (const CANTraceReader::Frame& frame : trace.frames()) {
+        if (options.channel > 0 && frame.channel != options.channel)
+            continue;
+
+        const CANMessage msg = trace.message(frame);
+        const auto matches = [&msg](const CANIdFilter& filter) { return filter.matches(msg); };
+        if (!options.include.isEmpty() && std::none_of(options.include.begin(), options.include.end(), matches))
+            continue;
+        if (std::any_of(options.exclude.begin(), options.exclude.end(), matches))
+            continue;
+
+        CANTraceReader::Frame selected = frame;
+        selected.id = options.idMap.value(frame.id, frame.id);
+        schedule.push_back(selected);
+    }
+    if (schedule.empty())
+        return CANResult::Failure(QString("No frames of %1 match the replay selection").arg(options.path));
+
+    const uint64_t first = schedule.front().timestamp;
+    for (CANTraceReader::Frame& frame : schedule)
+        frame.timestamp -= first;
+
+    // The next pass starts one mean frame interval after the last frame,
+    // so a periodic trace loops without a gap or a burst
+    const uint64_t span = schedule.back().timestamp;
+    const uint64_t loopLength = schedule.size() > 1 ? span + span / (schedule.size() - 1)
+                                                    : std::chrono::nanoseconds(std::chrono::milliseconds(1)).count();
+
+    QMutexLocker locker(&m_mutex);
+    if (m_shutdown)
+        return CANResult::Failure("Slot closed");
+    if (m_running)
+        return CANResult::Failure(QString("A replay is already running on slot '%1'").arg(m_slotName));
+
+    // The previous replay has finished; its thread no longer needs the lock
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+
+    m_trace        = std::move(trace);
+    m_schedule     = std::move(schedule);
+    m_loopLengthNs = loopLength;
+    m_speed        = options.speed;
+    m_loops        = options.loops;
+
+    m_stats               = Stats{};
+    m_stats.path          = options.path;
+    m_stats.framesPerLoop = m_schedule.size();
+    m_stats.loopDurationS = static_cast<double>(loopLength) / 1e9;
+    m_errorSumUs   = 0.0;
+    m_errorSqSumUs = 0.0;
+    m_histogram.assign(HISTOGRAM_RANGE_US + 1, 0);
+
+    m_running  = true;
+    m_stopping = false;
+    m_start    = Clock::now();
+
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->setObjectName(QStringLiteral("CAN_REPLAY_%1").arg(m_slotName));
+    m_thread->start(QThread::TimeCriticalPriority);
+
+    qDebug() << "[CANReplay]" << m_slotName << "replaying" << m_schedule.size() << "frames of"
+             << options.path << "at speed" << options.speed
+             << "loops" << (options.loops ? QString::number(options.loops) : QStringLiteral("endless"));
+    return CANResult::Success();
+}
+
+CANResult CANTraceReplayer::stop(Stats* stats)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_stats.path.isEmpty())
+            return CANResult::Failure(QString("No replay on slot '%1'").arg(m_slotName));
+        m_stopping = true;
+        m_wake.wakeAll();
+    }
+    joinThread();
+
+    QMutexLocker locker(&m_mutex);
+    if (stats)
+        finishStatsLocked(*stats);
+
+    qDebug() << "[CANReplay]" << m_slotName << "stopped:" << m_stats.sent << "frames sent,"
+             << m_stats.errors << "errors";
+    return CANResult::Success();
+}
+
+bool CANTraceReplayer::waitForFinished(int timeoutMs)
+{
+    QMutexLocker locker(&m_mutex);
+    const QDeadlineTimer deadline(timeoutMs);
+    while (m_running) {
+        if (!m_finished.wait(&m_mutex, deadline))
+            return !m_running;
+    }
+    return true;
+}
+
+bool CANTraceReplayer::isRunning() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_running;
+}
+
+CANTraceReplayer::Stats CANTraceReplayer::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats stats;
+    finishStatsLocked(stats);
+    return stats;
+}
+
+// ============================================================================
+//  Replay Thread
+// ============================================================================
+
+CANTraceReplayer::Clock::time_point CANTraceReplayer::deadline(size_t index, int pass) const
+{
+    const double offsetNs = (static_cast<double>(m_schedule[index].timestamp)
+                             + static_cast<double>(pass) * static_cast<double>(m_loopLengthNs)) / m_speed;
+    return m_start + std::chrono::duration_cast<Clock::duration>(
+                         std::chrono::duration<double, std::nano>(offsetNs));
+}
+
+void CANTraceReplayer::run()
+{
+#ifdef _WIN32
+    // The default 15.6 ms system timer would make every sleep overshoot
+    timeBeginPeriod(1);
+#endif
+
+    std::vector<CANMessage> batch;
+    std::vector<Clock::time_point> deadlines;
+    batch.reserve(MAX_BATCH);
+    deadlines.reserve(MAX_BATCH);
+
+    size_t next = 0;
+    int pass = 0;
+
+    // m_schedule and m_trace are not modified while the thread runs
+    QMutexLocker locker(&m_mutex);
+    while (!m_stopping) {
+        if (next == m_schedule.size()) {
+            next = 0;
+            ++pass;
+            ++m_stats.loopsCompleted;
+            if (m_loops > 0 && pass >= m_loops)
+                break;
+        }
+
+        // Sleep to just before the deadline; stop() wakes us early
+        const Clock::time_point due = deadline(next, pass);
+        if (Clock::now() < due - SPIN_MARGIN) {
+            m_wake.wait(&m_mutex, QDeadlineTimer(due - SPIN_MARGIN, Qt::PreciseTimer));
+            continue;
+        }
+        locker.unlock();
+
+        // Timer wake-ups are too coarse for the last few hundred microseconds
+        while (Clock::now() < due)
+            std::this_thread::yield();
+
+        // Everything due by now goes out in one driver call, in trace order
+        const Clock::time_point now = Clock::now();
+        batch.clear();
+        deadlines.clear();
+        while (static_cast<int>(batch.size()) < MAX_BATCH && next < m_schedule.size()) {
+            const Clock::time_point frameDue = deadline(next, pass);
+            if (frameDue > now)
+                break;
+            CANMessage msg = m_trace.message(m_schedule[next]);
+            msg.timestamp = 0;
+            batch.push_back(msg);
+            deadlines.push_back(frameDue);
+            ++next;
+        }
+
+        int sent = 0;
+        CANResult result;
+        Clock::time_point sendTime;
+        {
+            QMutexLocker txLocker(m_txMutex);
+            sendTime = Clock::now();
+            result = m_driver->transmitBatch(batch, sent);
+        }
+
+        locker.relock();
+        const int count = static_cast<int>(batch.size());
+        sent = std::clamp(sent, 0, count);
+        if (m_statistics)   // Only the first unsent frame is skipped, see below
+            m_statistics->onTransmitted(batch.data(), std::min(count, sent + 1), sent);
+        recordLocked(deadlines, count, sent, sendTime, result.success ? QString() : result.errorMessage);
+
+        // The rejected frame is skipped; the frames behind it are sent again next round
+        if (sent < count)
+            next -= static_cast<size_t>(count - sent - 1);
+    }
+
+    m_running = false;
+    m_finished.wakeAll();
+    locker.unlock();
+
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+// ============================================================================
+//  Statistics
+// ============================================================================
+
+void CANTraceReplayer::recordLocked(const std::vector<Clock::time_point>& deadlines, int count,
+                                    int sent, Clock::time_point sendTime, const QString& error)
+{
+    for (int i = 0; i < sent; ++i) {
+        const double errorUs = std::max(0.0, toMicros(sendTime - deadlines[i]));
+        m_errorSumUs   += errorUs;
+        m_errorSqSumUs += errorUs * errorUs;
+        m_stats.maxErrorUs = std::max(m_stats.maxErrorUs, errorUs);
+        ++m_histogram[std::min(static_cast<int>(errorUs), HISTOGRAM_RANGE_US)];
+    }
+    m_stats.sent += static_cast<uint64_t>(sent);
+
+    if (sent < count) {
+        ++m_stats.errors;
+        m_stats.lastError = error.isEmpty() ? QStringLiteral("Frame rejected by driver") : error;
+    }
+}
+
+void CANTraceReplayer::finishStatsLocked(Stats& stats) const
+{
+    stats = m_stats;
+    stats.running = m_running;
+    if (m_stats.sent == 0)
+        return;
+
+    const double n = static_cast<double>(m_stats.sent);
+    stats.meanErrorUs   = m_errorSumUs / n;
+    stats.stdDevErrorUs = std::sqrt(std::max(0.0, m_errorSqSumUs / n - stats.meanErrorUs * stats.meanErrorUs));
+
+    // Upper edge of the bucket holding the q-quantile
+    const auto percentile = [&](double q) {
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * n)));
+        uint64_t seen = 0;
+        for (int bucket = 0; bucket < HISTOGRAM_RANGE_US; ++bucket) {
+            seen += m_histogram[bucket];
+            if (seen >= rank)
+                return std::min(bucket + 1.0, m_stats.maxErrorUs);
+        }
+        return m_stats.maxErrorUs;
+    };
+    stats.p50ErrorUs  = percentile(0.50);
+    stats.p90ErrorUs  = percentile(0.90);
+    stats.p99ErrorUs  = percentile(0.99);
+    stats.p999ErrorUs = percentile(0.999);
+}
+
+} // namespace CANManager
@@ -0,0 +1,409 @@
+/**
+ * @file CANTraceWriter.cpp
+ * @brief ASC and BLF trace file writers — implementation.
+ */
+
+#include "CANTraceWriter.h"
+
+#include <QFileInfo>
+#include <QLocale>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+namespace CANManager {
+
+namespace {
+
+// ============================================================================
+//  ASC
+// ============================================================================
+
+/**
+ * Vector ASCII trace, as written by CANoe/CANalyzer with absolute
+ * timestamps and hex identifiers:
+ *
+ *    0.001234 1  123             Rx   d 8 01 02 03 04 05 06 07 08
+ *    0.002345 CANFD   1 Tx   18DAF110x  ... 1 0 d 32 <data> ...
+ */
+class AscTraceWriter : public CANTraceWriter
+{
+public:
+    ~AscTraceWriter() override { close(); }
+
+    CANResult open(const QString& path, const QDateTime& startTime) override
+    {
+        close();
+
+        m_file.setFileName(path);
+        if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            return CANResult::Failure(QString("Cannot create %1: %2").arg(path, m_file.errorString()));
+
+        const QString date = QLocale::c().toString(startTime, QStringLiteral("ddd MMM dd hh:mm:ss.zzz ap yyyy"));
+        QByteArray header;
+        header += "date " + date.toLatin1() + "\n";
+        header += "base hex  timestamps absolute\n";
+        header += "internal events logged\n";
+        header += "// version 9.0.0\n";
+        header += "Begin Triggerblock " + date.toLatin1() + "\n";
+        header += "   0.000000 Start of measurement\n";
+        m_bytes = 0;
+        return append(header);
+    }
+
+    CANResult write(const CANTraceFrame* frames, int count) override
+    {
+        if (!m_file.isOpen())
+            return CANResult::Failure("Trace file not open");
+
+        m_line.clear();
+        for (int i = 0; i < count; ++i)
+            formatFrame(frames[i]);
+        return append(m_line);
+    }
+
+    CANResult close() override
+    {
+        if (!m_file.isOpen())
+            return CANResult::Success();
+
+        CANResult result = append("End TriggerBlock\n");
+        if (!m_file.flush() && result.success)
+            result = CANResult::Failure(m_file.errorString());
+        m_file.close();
+        return result;
+    }
+
+    bool isOpen() const override { return m_file.isOpen(); }
+    qint64 fileSize() const override { return m_bytes; }
+
+private:
+    CANResult append(const QByteArray& bytes)
+    {
+        if (m_file.write(bytes) != bytes.size())
+            return CANResult::Failure(QString("Write to %1 failed: %2")
+                                          .arg(m_file.fileName(), m_file.errorString()));
+        m_bytes += bytes.size();
+        return CANResult::Success();
+    }
+
+    void formatFrame(const CANTraceFrame& frame)
+    {
+        const CANMessage& msg = frame.msg;
+        char buf[512];
+        int n = std::snprintf(buf, sizeof(buf), "%4" PRIu64 ".%06" PRIu64 " ",
+                              msg.timestamp / 1000000000u, (msg.timestamp / 1000u) % 1000000u);
+
+        if (msg.isError) {
+            n += std::snprintf(buf + n, sizeof(buf) - n, "%u  ErrorFrame\n", frame.channel);
+            m_line.append(buf, n);
+            return;
+        }
+
+        char id[16];
+        std::snprintf(id, sizeof(id), msg.isExtended ? "%Xx" : "%X", msg.id);
+        const char* dir = msg.isTxConfirm ? "Tx" : "Rx";
+        const int length = msg.isRemote ? 0 : msg.dataLength();
+
+        if (msg.isFD) {
+            n += std::snprintf(buf + n, sizeof(buf) - n, "CANFD %3u %-4s %8s  %32s %d 0 %x %2d",
+                               frame.channel, dir, id, "", msg.isBRS ? 1 : 0, msg.dlc, length);
+        } else {
+            n += std::snprintf(buf + n, sizeof(buf) - n, "%u  %-15s %-4s %c %x",
+                               frame.channel, id, dir, msg.isRemote ? 'r' : 'd', msg.dlc);
+        }
+
+        static constexpr char HEX[] = "0123456789ABCDEF";
+        for (int b = 0; b < length; ++b) {
+            buf[n++] = ' ';
+            buf[n++] = HEX[msg.data[b] >> 4];
+            buf[n++] = HEX[msg.data[b] & 0x0F];
+        }
+
+        if (msg.isFD) {
+            // Duration, length, flags (EDL, BRS), CRC and bit timings are not known
+            const unsigned flags = 0x1000u | (msg.isBRS ? 0x2000u : 0u);
+            n += std::snprintf(buf + n, sizeof(buf) - n, " %8d %4d %8X %8d %8d %8d %8d %8d",
+                               0, 0, flags, 0, 0, 0, 0, 0);
+        }
+        buf[n++] = '\n';
+        m_line.append(buf, n);
+    }
+
+    QFile      m_file;
+    QByteArray m_line;          ///< Formatted lines of the current write() call
+    qint64     m_bytes = 0;
+};
+
+// ============================================================================
+//  BLF
+// ============================================================================
+
+// Layout as documented for the Vector binlog library (all little-endian)
+constexpr int      BLF_FILE_HEADER_SIZE     = 144;
+constexpr int      BLF_OBJ_HEADER_BASE_SIZE = 16;
+constexpr int      BLF_OBJ_HEADER_V1_SIZE   = 16;
+constexpr int      BLF_CONTAINER_HEADER_SIZE = 16;
+constexpr int      BLF_MAX_CONTAINER_SIZE   = 128 * 1024;
+
+constexpr uint32_t BLF_CAN_MESSAGE      = 1;
+constexpr uint32_t BLF_LOG_CONTAINER    = 10;
+constexpr uint32_t BLF_CAN_ERROR_EXT    = 73;
+constexpr uint32_t BLF_CAN_FD_MESSAGE   = 100;
+
+constexpr uint32_t BLF_TIME_ONE_NANS    = 0x00000002;
+constexpr uint16_t BLF_ZLIB_DEFLATE     = 2;
+
+constexpr uint8_t  BLF_DIR_TX           = 0x01;
+constexpr uint8_t  BLF_REMOTE_FLAG      = 0x80;
+constexpr uint32_t BLF_EXTENDED_ID      = 0x80000000u;
+constexpr uint8_t  BLF_FD_EDL           = 0x01;
+constexpr uint8_t  BLF_FD_BRS           = 0x02;
+
+template <typename T>
+void put(QByteArray& out, T value)
+{
+    value = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void putZeros(QByteArray& out, int count)
+{
+    out.append(count, '\0');
+}
+
+/// Windows SYSTEMTIME, as stored in the BLF file header
+void putSystemTime(QByteArray& out, const QDateTime& time)
+{
+    const QDate date = time.date();
+    const QTime clock = time.time();
+    put<uint16_t>(out, static_cast<uint16_t>(date.year()));
+    put<uint16_t>(out, static_cast<uint16_t>(date.month()));
+    put<uint16_t>(out, static_cast<uint16_t>(date.dayOfWeek() % 7));   // Sunday = 0
+    put<uint16_t>(out, static_cast<uint16_t>(date.day()));
+    put<uint16_t>(out, static_cast<uint16_t>(clock.hour()));
+    put<uint16_t>(out, static_cast<uint16_t>(clock.minute()));
+    put<uint16_t>(out, static_cast<uint16_t>(clock.second()));
+    put<uint16_t>(out, static_cast<uint16_t>(clock.msec()));
+}
+
+/**
+ * Binary logging format: a 144-byte file header followed by LOG_CONTAINER
+ * objects, each holding a zlib-compressed run of CAN_MESSAGE,
+ * CAN_FD_MESSAGE and CAN_ERROR_EXT objects with nanosecond timestamps.
+ * The header is rewritten on close() with the final sizes and counts.
+ */
+class BlfTraceWriter : public CANTraceWriter
+{
+public:
+    ~BlfTraceWriter() override { close(); }
+
+    CANResult open(const QString& path, const QDateTime& startTime) override
+    {
+        close();
+
+        m_file.setFileName(path);
+        if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            return CANResult::Failure(QString("Cannot create %1: %2").arg(path, m_file.errorString()));
+
+        m_startTime        = startTime;
+        m_lastTimestamp    = 0;
+        m_objectCount      = 0;
+        m_bytes            = 0;
+        m_uncompressedSize = BLF_FILE_HEADER_SIZE;
+        m_container.clear();
+        m_container.reserve(BLF_MAX_CONTAINER_SIZE + 256);
+
+        // Placeholder; the real counts are only known on close()
+        const QByteArray header = fileHeader();
+        if (m_file.write(header) != header.size())
+            return writeFailure();
+        m_bytes = header.size();
+        return CANResult::Success();
+    }
+
+    CANResult write(const CANTraceFrame* frames, int count) override
+    {
+        if (!m_file.isOpen())
+            return CANResult::Failure("Trace file not open");
+
+        for (int i = 0; i < count; ++i) {
+            appendFrame(frames[i]);
+            if (m_container.size() >= BLF_MAX_CONTAINER_SIZE) {
+                CANResult result = flushContainer();
+                if (!result.success)
+                    return result;
+            }
+        }
+        return CANResult::Success();
+    }
+
+    CANResult close() override
+    {
+        if (!m_file.isOpen())
+            return CANResult::Success();
+
+        CANResult result = flushContainer();
+        if (result.success) {
+            const QByteArray header = fileHeader();
+            if (!m_file.seek(0) || m_file.write(header) != header.size() || !m_file.flush())
+                result = writeFailure();
+        }
+        m_file.close();
+        return result;
+    }
+
+    bool isOpen() const override { return m_file.isOpen(); }
+    qint64 fileSize() const override { return m_bytes; }
+
+private:
+    CANResult writeFailure() const
+    {
+        return CANResult::Failure(QString("Write to %1 failed: %2")
+                                      .arg(m_file.fileName(), m_file.errorString()));
+    }
+
+    QByteArray fileHeader() const
+    {
+        QByteArray header;
+        header.reserve(BLF_FILE_HEADER_SIZE);
+        header.append("LOGG", 4);
+        put<uint32_t>(header, BLF_FILE_HEADER_SIZE);
+        put<uint8_t>(header, 0);        // Application ID, version (unknown)
+        put<uint8_t>(header, 0);
+        put<uint8_t>(header, 0);
+        put<uint8_t>(header, 0);
+        put<uint8_t>(header, 2);        // Binlog library version 2.6.8.1
+        put<uint8_t>(header, 6);
+        put<uint8_t>(header, 8);
+        put<uint8_t>(header, 1);
+        put<uint64_t>(header, static_cast<uint64_t>(m_bytes));
+        put<uint64_t>(header, static_cast<uint64_t>(m_uncompressedSize));
+        put<uint32_t>(header, m_objectCount);
+        put<uint32_t>(header, 0);       // Objects read
+        putSystemTime(header, m_startTime);
+        putSystemTime(header, m_startTime.addMSecs(static_cast<qint64>(m_lastTimestamp / 1000000u)));
+        putZeros(header, BLF_FILE_HEADER_SIZE - static_cast<int>(header.size()));
+        return header;
+    }
+
+    void appendObjectHeader(uint32_t type, int dataSize, uint64_t timestamp)
+    {
+        m_container.append("LOBJ", 4);
+        put<uint16_t>(m_container, BLF_OBJ_HEADER_BASE_SIZE + BLF_OBJ_HEADER_V1_SIZE);
+        put<uint16_t>(m_container, 1);
+        put<uint32_t>(m_container, BLF_OBJ_HEADER_BASE_SIZE + BLF_OBJ_HEADER_V1_SIZE + dataSize);
+        put<uint32_t>(m_container, type);
+        put<uint32_t>(m_container, BLF_TIME_ONE_NANS);
+        put<uint16_t>(m_container, 0);  // Client index
+        put<uint16_t>(m_container, 0);  // Object version
+        put<uint64_t>(m_container, timestamp);
+    }
+
+    void appendFrame(const CANTraceFrame& frame)
+    {
+        const CANMessage& msg = frame.msg;
+        const uint32_t id = msg.id | (msg.isExtended ? BLF_EXTENDED_ID : 0u);
+        const uint8_t flags = (msg.isTxConfirm ? BLF_DIR_TX : 0) | (msg.isRemote ? BLF_REMOTE_FLAG : 0);
+        m_lastTimestamp = std::max(m_lastTimestamp, msg.timestamp);
+        ++m_objectCount;
+
+        if (msg.isError) {
+            constexpr int size = 32;
+            appendObjectHeader(BLF_CAN_ERROR_EXT, size, msg.timestamp);
+            put<uint16_t>(m_container, frame.channel);
+            putZeros(m_container, 2 + 4 + 1 + 1);     // Length, flags, ECC, position
+            put<uint8_t>(m_container, 0);             // DLC
+            putZeros(m_container, 1 + 4);             // Reserved, frame length
+            put<uint32_t>(m_container, id);
+            putZeros(m_container, 2 + 2 + 8);         // Extended flags, reserved, data
+        } else if (msg.isFD) {
+            constexpr int size = 84;
+            const int length = msg.isRemote ? 0 : msg.dataLength();
+            appendObjectHeader(BLF_CAN_FD_MESSAGE, size, msg.timestamp);
+            put<uint16_t>(m_container, frame.channel);
+            put<uint8_t>(m_container, flags);
+            put<uint8_t>(m_container, msg.dlc);
+            put<uint32_t>(m_container, id);
+            put<uint32_t>(m_container, 0);            // Frame length (ns)
+            put<uint8_t>(m_container, 0);             // Bit count
+            put<uint8_t>(m_container, BLF_FD_EDL | (msg.isBRS ? BLF_FD_BRS : 0));
+            put<uint8_t>(m_container, static_cast<uint8_t>(length));
+            putZeros(m_container, 5);
+            m_container.append(reinterpret_cast<const char*>(msg.data), 64);
+        } else {
+            constexpr int size = 16;
+            appendObjectHeader(BLF_CAN_MESSAGE, size, msg.timestamp);
+            put<uint16_t>(m_container, frame.channel);
+            put<uint8_t>(m_container, flags);
+            put<uint8_t>(m_container, msg.dlc);
+            put<uint32_t>(m_container, id);
+            m_container.append(reinterpret_cast<const char*>(msg.data), 8);
+        }
+    }
+
+    CANResult flushContainer()
+    {
+        if (m_container.isEmpty())
+            return CANResult::Success();
+
+        // qCompress() prefixes the zlib stream with the big-endian input size
+        const QByteArray compressed = qCompress(m_container).mid(4);
+        const uint32_t objSize = BLF_OBJ_HEADER_BASE_SIZE + BLF_CONTAINER_HEADER_SIZE
+                                 + static_cast<uint32_t>(compressed.size());
+
+        QByteArray object;
+        object.reserve(static_cast<qsizetype>(objSize) + 4);
+        object.append("LOBJ", 4);
+        put<uint16_t>(object, BLF_OBJ_HEADER_BASE_SIZE);
+        put<uint16_t>(object, 1);
+        put<uint32_t>(object, objSize);
+        put<uint32_t>(object, BLF_LOG_CONTAINER);
+        put<uint16_t>(object, BLF_ZLIB_DEFLATE);
+        putZeros(object, 6);
+        put<uint32_t>(object, static_cast<uint32_t>(m_container.size()));
+        putZeros(object, 4);
+        object.append(compressed);
+        putZeros(object, static_cast<int>(objSize % 4));
+
+        if (m_file.write(object) != object.size())
+            return writeFailure();
+
+        m_bytes += object.size();
+        m_uncompressedSize += BLF_OBJ_HEADER_BASE_SIZE + BLF_CONTAINER_HEADER_SIZE + m_container.size();
+        m_container.clear();
+        return CANResult::Success();
+    }
+
+    QFile      m_file;
+    QDateTime  m_startTime;
+    QByteArray m_container;         ///< Uncompressed objects of the open container
+    uint64_t   m_lastTimestamp    = 0;
+    uint32_t   m_objectCount      = 0;
+    qint64     m_bytes            = 0;
+    qint64     m_uncompressedSize = 0;
+};
+
+} // namespace
+
+// ============================================================================
+//  Factory
+// ============================================================================
+
+std::unique_ptr<CANTraceWriter> CANTraceWriter::create(CANTraceFormat format)
+{
+    if (format == CANTraceFormat::Blf)
+        return std::make_unique<BlfTraceWriter>();
+    return std::make_unique<AscTraceWriter>();
+}
+
+CANTraceFormat CANTraceWriter::formatForPath(const QString& path)
+{
+    return QFileInfo(path).suffix().compare(QLatin1String("blf"), Qt::CaseInsensitive) == 0
+               ? CANTraceFormat::Blf
+               : CANTraceFormat::Asc;
+}
+
+} // namespace CANManager
@@ -0,0 +1,689 @@
+/**
+ * @file SocketCANDriver.cpp
+ * @brief Linux SocketCAN driver — full implementation.
+ *
+ * Uses CAN_RAW sockets with recvmmsg()/sendmmsg() batching and an epoll wait
+ * that also watches an eventfd, so close/stop can interrupt a blocking receive.
+ */
+
+#include "SocketCANDriver.h"
+
+#include <QDebug>
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include <fcntl.h>
+#include <net/if.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <linux/can.h>
+#include <linux/can/error.h>
+#include <linux/can/raw.h>
+
+namespace CANManager {
+
+// ============================================================================
+//  RX batch buffers
+// ============================================================================
+
+/**
+ * @brief Storage for one recvmmsg() call.
+ *
+ * Every slot has its own frame, iovec and control buffer (for the
+ * SCM_TIMESTAMPNS ancillary message). receive() hands out frames from
+ * [pos, count) before going back to the kernel.
+ */
+struct SocketCANDriver::RxBatch
+{
+    static constexpr size_t CMSG_BUF_SIZE = CMSG_SPACE(sizeof(struct timespec));
+
+    struct canfd_frame frames[IO_BATCH_SIZE];
+    struct iovec       iov[IO_BATCH_SIZE];
+    struct mmsghdr     hdrs[IO_BATCH_SIZE];
+    alignas(struct cmsghdr) char control[IO_BATCH_SIZE][CMSG_BUF_SIZE];
+
+    int count = 0;  ///< Frames returned by the last recvmmsg()
+    int pos   = 0;  ///< Next frame to hand out
+
+    void reset()
+    {
+        count = 0;
+        pos   = 0;
+    }
+
+    /// Re-arm the iovec/msghdr array before each recvmmsg() call
+    void prepare()
+    {
+        std::memset(hdrs, 0, sizeof(hdrs));
+        for (int i = 0; i < IO_BATCH_SIZE; ++i) {
+            iov[i].iov_base = &frames[i];
+            iov[i].iov_len  = sizeof(frames[i]);
+            hdrs[i].msg_hdr.msg_iov        = &iov[i];
+            hdrs[i].msg_hdr.msg_iovlen     = 1;
+            hdrs[i].msg_hdr.msg_control    = control[i];
+            hdrs[i].msg_hdr.msg_controllen = CMSG_BUF_SIZE;
+        }
+    }
+};
+
+// ============================================================================
+//  Frame conversion helpers
+// ============================================================================
+
+namespace {
+
+/// Extract the SO_TIMESTAMPNS receive time (ns) from a received msghdr.
+uint64_t kernelTimestampNs(const struct msghdr& hdr)
+{
+    for (auto* cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(const_cast<struct msghdr*>(&hdr), cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            struct timespec ts;
+            std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL
+                 + static_cast<uint64_t>(ts.tv_nsec);
+        }
+    }
+    return 0;
+}
+
+/// Convert a kernel frame (CAN_MTU or CANFD_MTU bytes) into a CANMessage.
+void frameToMessage(const struct canfd_frame& frame, size_t nbytes,
+                    const struct msghdr& hdr, CANMessage& msg)
+{
+    msg = CANMessage{};
+
+    const canid_t canId = frame.can_id;
+    msg.isError    = (canId & CAN_ERR_FLAG) != 0;
+    msg.isExtended = (canId & CAN_EFF_FLAG) != 0;
+    msg.isRemote   = (canId & CAN_RTR_FLAG) != 0;
+    if (msg.isError)
+        msg.id = canId & CAN_ERR_MASK;
+    else
+        msg.id = canId & (msg.isExtended ? CAN_EFF_MASK : CAN_SFF_MASK);
+
+    msg.isFD  = (nbytes == CANFD_MTU);
+    msg.isBRS = msg.isFD && (frame.flags & CANFD_BRS);
+    msg.isTxConfirm = (hdr.msg_flags & MSG_CONFIRM) != 0;
+
+    const int len = qMin(static_cast<int>(frame.len), msg.isFD ? CANFD_MAX_DLEN : CAN_MAX_DLEN);
+    msg.dlc = msg.isFD ? lengthToDlc(len) : static_cast<uint8_t>(len);
+    std::memcpy(msg.data, frame.data, static_cast<size_t>(len));
+
+    msg.timestamp = kernelTimestampNs(hdr);
+}
+
+/// Convert a CANMessage into a kernel frame. Returns the number of bytes to send.
+/// FD frames only reach here on FD channels (transmitBatch() rejects the rest).
+size_t messageToFrame(const CANMessage& msg, struct canfd_frame& frame)
+{
+    std::memset(&frame, 0, sizeof(frame));
+
+    frame.can_id = msg.isExtended ? ((msg.id & CAN_EFF_MASK) | CAN_EFF_FLAG)
+                                  : (msg.id & CAN_SFF_MASK);
+    if (msg.isRemote)
+        frame.can_id |= CAN_RTR_FLAG;
+
+    if (msg.isFD) {
+        const int len = dlcToLength(msg.dlc);
+        frame.len = static_cast<__u8>(len);
+        if (msg.isBRS)
+            frame.flags |= CANFD_BRS;
+        std::memcpy(frame.data, msg.data, static_cast<size_t>(len));
+        return CANFD_MTU;
+    }
+
+    const int len = qMin(static_cast<int>(msg.dlc), CAN_MAX_DLEN);
+    frame.len = static_cast<__u8>(len);
+    std::memcpy(frame.data, msg.data, static_cast<size_t>(len));
+    return CAN_MTU;
+}
+
+/// Query interface flags / MTU through a throw-away CAN socket.
+bool queryInterface(const QByteArray& ifName, int& ifIndex, bool& isUp, bool& supportsFD)
+{
+    int fd = ::socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC, CAN_RAW);
+    if (fd < 0)
+        return false;
+
+    struct ifreq ifr;
+    std::memset(&ifr, 0, sizeof(ifr));
+    std::strncpy(ifr.ifr_name, ifName.constData(), IFNAMSIZ - 1);
+
+    bool ok = (::ioctl(fd, SIOCGIFINDEX, &ifr) == 0);
+    if (ok) {
+        ifIndex = ifr.ifr_ifindex;
+        isUp = (::ioctl(fd, SIOCGIFFLAGS, &ifr) == 0) && (ifr.ifr_flags & IFF_UP);
+        supportsFD = (::ioctl(fd, SIOCGIFMTU, &ifr) == 0) && (ifr.ifr_mtu == CANFD_MTU);
+    }
+
+    ::close(fd);
+    return ok;
+}
+
+} // namespace
+
+// ============================================================================
+//  Constructor / Destructor
+// ============================================================================
+
+SocketCANDriver::SocketCANDriver(QObject* parent)
+    : ICANDriver(parent)
+    , m_rx(std::make_unique<RxBatch>())
+{
+}
+
+SocketCANDriver::~SocketCANDriver()
+{
+    shutdown();
+}
+
+// ============================================================================
+//  ICANDriver — Lifecycle
+// ============================================================================
+
+bool SocketCANDriver::initialize()
+{
+    if (m_initialized)
+        return true;
+
+    if (!isAvailable()) {
+        setError("SocketCAN not available (PF_CAN sockets not supported by this kernel)");
+        return false;
+    }
+
+    m_initialized = true;
+    qDebug() << "[SocketCAN] Driver initialized";
+    return true;
+}
+
+void SocketCANDriver::shutdown()
+{
+    closeChannel();
+    m_initialized = false;
+}
+
+bool SocketCANDriver::isAvailable() const
+{
+    if (m_availableCached >= 0)
+        return m_availableCached == 1;
+
+    int fd = ::socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC, CAN_RAW);
+    m_availableCached = (fd >= 0) ? 1 : 0;
+    if (fd >= 0)
+        ::close(fd);
+    return m_availableCached == 1;
+}
+
+// ============================================================================
+//  Hardware Detection
+// ============================================================================
+
+QList<CANChannelInfo> SocketCANDriver::detectChannels()
+{
+    QList<CANChannelInfo> channels;
+
+    struct if_nameindex* ifList = ::if_nameindex();
+    if (!ifList) {
+        makeErrnoError("if_nameindex", errno);
+        return channels;
+    }
+
+    int hwChannel = 0;
+    for (auto* it = ifList; it->if_index != 0 && it->if_name; ++it) {
+        const QByteArray ifName(it->if_name);
+        const bool isVirtual = ifName.startsWith("vcan");
+        if (!ifName.startsWith("can") && !isVirtual)
+            continue;
+
+        int  ifIndex = 0;
+        bool isUp = false;
+        bool supportsFD = false;
+        if (!queryInterface(ifName, ifIndex, isUp, supportsFD))
+            continue;
+
+        CANChannelInfo info;
+        info.name         = QString::fromLatin1(ifName);
+        info.hwTypeName   = isVirtual ? QStringLiteral("Virtual CAN") : QStringLiteral("SocketCAN");
+        info.hwChannel    = hwChannel++;
+        info.channelIndex = ifIndex;
+        info.supportsFD   = supportsFD;
+        info.isOnBus      = isUp;
+
+        qDebug() << "[SocketCAN]  If" << info.name
+                 << "index:" << ifIndex
+                 << "up:" << isUp
+                 << "FD:" << supportsFD;
+
+        channels.append(info);
+    }
+
+    ::if_freenameindex(ifList);
+    return channels;
+}
+
+// ============================================================================
+//  Channel Open / Close
+// ============================================================================
+
+CANResult SocketCANDriver::openChannel(const CANChannelInfo& channel,
+                                        const CANBusConfig& config)
+{
+    QMutexLocker txLocker(&m_txMutex);
+    QMutexLocker rxLocker(&m_rxMutex);
+
+    if (m_socket >= 0)
+        return CANResult::Failure("A channel is already open — close it first");
+
+    const QByteArray ifName = channel.name.toLatin1();
+    if (ifName.isEmpty() || ifName.size() >= IFNAMSIZ)
+        return CANResult::Failure(QString("Invalid SocketCAN interface name '%1'").arg(channel.name));
+
+    int  ifIndex = 0;
+    bool isUp = false;
+    bool supportsFD = false;
+    if (!queryInterface(ifName, ifIndex, isUp, supportsFD))
+        return CANResult::Failure(QString("SocketCAN interface '%1' not found").arg(channel.name));
+
+    if (!isUp) {
+        return CANResult::Failure(
+            QString("SocketCAN interface '%1' is down — bring it up with "
+                    "'ip link set %1 up type can bitrate %2'")
+                .arg(channel.name).arg(config.bitrate));
+    }
+
+    int fd = ::socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC, CAN_RAW);
+    if (fd < 0)
+        return makeErrnoError("socket(PF_CAN)", errno);
+
+    // CAN FD frames (only if the link MTU allows it)
+    bool isFD = false;
+    if (config.fdEnabled) {
+        const int enable = 1;
+        if (supportsFD &&
+            ::setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enable, sizeof(enable)) == 0) {
+            isFD = true;
+        } else {
+            qWarning() << "[SocketCAN] FD requested but" << channel.name
+                       << "is not configured for CAN FD (mtu != 72) — using classic CAN";
+        }
+    }
+
+    // Deliver controller error frames (bus-off, error passive, ...) as isError messages
+    const can_err_mask_t errMask = CAN_ERR_MASK;
+    ::setsockopt(fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &errMask, sizeof(errMask));
+
+    // Loop own frames back (flagged MSG_CONFIRM) like Vector TX events, so
+    // traces see transmitted frames with kernel timestamps
+    const int recvOwn = 1;
+    ::setsockopt(fd, SOL_CAN_RAW, CAN_RAW_RECV_OWN_MSGS, &recvOwn, sizeof(recvOwn));
+
+    // Kernel receive timestamps in nanoseconds
+    const int enableTs = 1;
+    if (::setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &enableTs, sizeof(enableTs)) != 0)
+        qWarning() << "[SocketCAN] SO_TIMESTAMPNS not supported — timestamps will be 0";
+
+    // Generous socket buffer so bursts at full bus load are absorbed by the kernel
+    const int rcvBuf = 1 << 20;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof(rcvBuf));
+
+    if (config.listenOnly)
+        qWarning() << "[SocketCAN] Listen-only must be configured on the link "
+                      "('ip link set" << channel.name << "type can listen-only on')";
+
+    struct sockaddr_can addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.can_family  = AF_CAN;
+    addr.can_ifindex = ifIndex;
+    if (::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+        const int err = errno;
+        ::close(fd);
+        return makeErrnoError(QString("bind(%1)").arg(channel.name), err);
+    }
+
+    // epoll set: the CAN socket plus an eventfd to interrupt blocking waits
+    int epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    int wakeFd  = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) {
+        const int err = errno;
+        if (epollFd >= 0) ::close(epollFd);
+        if (wakeFd >= 0)  ::close(wakeFd);
+        ::close(fd);
+        return makeErrnoError("epoll/eventfd", err);
+    }
+
+    struct epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events  = EPOLLIN;
+    ev.data.fd = fd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    ev.data.fd = wakeFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+
+    m_socket  = fd;
+    m_epollFd = epollFd;
+    m_wakeFd  = wakeFd;
+    m_isFD    = isFD;
+    m_ifName  = channel.name;
+    m_rx->reset();
+
+    qDebug() << "[SocketCAN] Channel opened:" << m_ifName
+             << "FD:" << m_isFD
+             << "(bitrate is taken from the link configuration)";
+
+    rxLocker.unlock();
+    txLocker.unlock();
+    emit channelOpened();
+
+    return CANResult::Success();
+}
+
+void SocketCANDriver::closeChannel()
+{
+    QMutexLocker txLocker(&m_txMutex);
+    if (m_socket < 0)
+        return;
+
+    // Kick any receive() blocked in epoll_wait so we can take the RX lock
+    wakeReceiver();
+    QMutexLocker rxLocker(&m_rxMutex);
+
+    ::close(m_socket);
+    ::close(m_epollFd);
+    ::close(m_wakeFd);
+
+    qDebug() << "[SocketCAN] Channel closed:" << m_ifName;
+
+    m_socket  = -1;
+    m_epollFd = -1;
+    m_wakeFd  = -1;
+    m_isFD    = false;
+    m_ifName.clear();
+    m_rx->reset();
+
+    rxLocker.unlock();
+    txLocker.unlock();
+    emit channelClosed();
+}
+
+bool SocketCANDriver::isOpen() const
+{
+    QMutexLocker locker(&m_txMutex);
+    return m_socket >= 0;
+}
+
+QString SocketCANDriver::interfaceName() const
+{
+    QMutexLocker locker(&m_txMutex);
+    return m_ifName;
+}
+
+// ============================================================================
+//  Transmit
+// ============================================================================
+
+CANResult SocketCANDriver::transmit(const CANMessage& msg)
+{
+    int sent = 0;
+    return transmitBatch(std::span<const CANMessage>(&msg, 1), sent);
+}
+
+CANResult SocketCANDriver::transmitBatch(std::span<const CANMessage> msgs, int& sent)
+{
+    sent = 0;
+    const int count = static_cast<int>(msgs.size());
+    QMutexLocker locker(&m_txMutex);
+
+    if (m_socket < 0)
+        return CANResult::Failure("Channel not open");
+
+    if (!m_isFD) {
+        for (const CANMessage& msg : msgs) {
+            if (msg.isFD)
+                return CANResult::Failure("CAN FD frame on a channel opened without FD");
+        }
+    }
+
+    struct canfd_frame frames[IO_BATCH_SIZE];
+    struct iovec       iov[IO_BATCH_SIZE];
+    struct mmsghdr     hdrs[IO_BATCH_SIZE];
+
+    // The netdev TX queue reports ENOBUFS when full; give it a short grace period
+    constexpr int kMaxQueueFullRetries = 50;
+    int queueFullRetries = 0;
+
+    while (sent < count) {
+        const int chunk = qMin(count - sent, IO_BATCH_SIZE);
+        std::memset(hdrs, 0, sizeof(hdrs[0]) * static_cast<size_t>(chunk));
+        for (int i = 0; i < chunk; ++i) {
+            iov[i].iov_base = &frames[i];
+            iov[i].iov_len  = messageToFrame(msgs[sent + i], frames[i]);
+            hdrs[i].msg_hdr.msg_iov    = &iov[i];
+            hdrs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        const int n = ::sendmmsg(m_socket, hdrs, static_cast<unsigned int>(chunk), 0);
+        if (n < 0) {
+            const int err = errno;
+            if (err == EINTR)
+                continue;
+            if ((err == ENOBUFS || err == EAGAIN) && queueFullRetries++ < kMaxQueueFullRetries) {
+                QThread::usleep(200);
+                continue;
+            }
+            return makeErrnoError(QString("sendmmsg(%1)").arg(m_ifName), err);
+        }
+        sent += n;
+        queueFullRetries = 0;
+    }
+
+    return CANResult::Success();
+}
+
+// ============================================================================
+//  Receive
+// ============================================================================
+
+int SocketCANDriver::fillRxBatch(int timeoutMs)
+{
+    // Fast path: frames already queued in the socket — no wait needed
+    m_rx->prepare();
+    int n = ::recvmmsg(m_socket, m_rx->hdrs, IO_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+    if (n > 0) {
+        m_rx->count = n;
+        m_rx->pos   = 0;
+        return n;
+    }
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        return -1;
+
+    if (timeoutMs == 0)
+        return 0;
+
+    struct epoll_event events[2];
+    int ready;
+    do {
+        ready = ::epoll_wait(m_epollFd, events, 2, timeoutMs < 0 ? -1 : timeoutMs);
+    } while (ready < 0 && errno == EINTR);
+
+    if (ready <= 0)
+        return ready;   // 0 = timeout, -1 = error
+
+    bool socketReady = false;
+    for (int i = 0; i < ready; ++i) {
+        if (events[i].data.fd == m_wakeFd) {
+            uint64_t counter;
+            [[maybe_unused]] auto r = ::read(m_wakeFd, &counter, sizeof(counter));
+        } else if (events[i].data.fd == m_socket) {
+            socketReady = true;
+        }
+    }
+    if (!socketReady)
+        return 0;       // woken up by close/stop
+
+    m_rx->prepare();
+    n = ::recvmmsg(m_socket, m_rx->hdrs, IO_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+    if (n < 0)
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+
+    m_rx->count = n;
+    m_rx->pos   = 0;
+    return n;
+}
+
+CANResult SocketCANDriver::receive(CANMessage& msg, int timeoutMs)
+{
+    QMutexLocker locker(&m_rxMutex);
+
+    if (m_socket < 0)
+        return CANResult::Failure("Channel not open");
+
+    if (m_rx->pos >= m_rx->count) {
+        m_rx->reset();
+        const int n = fillRxBatch(timeoutMs);
+        if (n < 0)
+            return makeErrnoError(QString("recvmmsg(%1)").arg(m_ifName), errno);
+        if (n == 0)
+            return CANResult::Failure("Receive timeout");
+    }
+
+    const int i = m_rx->pos++;
+    frameToMessage(m_rx->frames[i], m_rx->hdrs[i].msg_len, m_rx->hdrs[i].msg_hdr, msg);
+    return CANResult::Success();
+}
+
+CANResult SocketCANDriver::receiveBatch(std::span<CANMessage> msgs, int& received, int timeoutMs)
+{
+    received = 0;
+    QMutexLocker locker(&m_rxMutex);
+
+    if (m_socket < 0)
+        return CANResult::Failure("Channel not open");
+
+    const int capacity = static_cast<int>(msgs.size());
+    while (received < capacity) {
+        if (m_rx->pos >= m_rx->count) {
+            m_rx->reset();
+            // Wait only for the first frame; afterwards take what is already queued
+            const int n = fillRxBatch(received == 0 ? timeoutMs : 0);
+            if (n < 0 && received == 0)
+                return makeErrnoError(QString("recvmmsg(%1)").arg(m_ifName), errno);
+            if (n <= 0)
+                break;
+        }
+
+        const int i = m_rx->pos++;
+        frameToMessage(m_rx->frames[i], m_rx->hdrs[i].msg_len, m_rx->hdrs[i].msg_hdr,
+                       msgs[received++]);
+    }
+
+    if (received == 0 && capacity > 0)
+        return CANResult::Failure("Receive timeout");
+    return CANResult::Success();
+}
+
+void SocketCANDriver::wakeReceiver()
+{
+    if (m_wakeFd >= 0) {
+        const uint64_t one = 1;
+        [[maybe_unused]] auto r = ::write(m_wakeFd, &one, sizeof(one));
+    }
+}
+
+// ============================================================================
+//  Flush
+// ============================================================================
+
+CANResult SocketCANDriver::flushReceiveQueue()
+{
+    QMutexLocker locker(&m_rxMutex);
+
+    if (m_socket < 0)
+        return CANResult::Failure("Channel not open");
+
+    // Drop frames already fetched, then drain the socket without blocking
+    m_rx->reset();
+    while (fillRxBatch(0) > 0)
+        m_rx->reset();
+
+    return CANResult::Success();
+}
+
+// ============================================================================
+//  Acceptance Filters
+// ============================================================================
+
+CANResult SocketCANDriver::setAcceptanceFilters(const QList<CANIdFilter>& filters)
+{
+    // m_socket only changes with both locks held; the RX path may keep
+    // reading while the kernel swaps the filter
+    QMutexLocker locker(&m_txMutex);
+
+    if (m_socket < 0)
+        return CANResult::Failure("Channel not open");
+    if (filters.size() > CAN_RAW_FILTER_MAX)
+        return CANResult::Failure(QString("Too many acceptance filters (%1, kernel limit %2)")
+                                      .arg(filters.size()).arg(CAN_RAW_FILTER_MAX));
+
+    // The kernel matches (can_id & mask) == (filter.can_id & mask) on the raw
+    // can_id, flags included: leaving CAN_EFF_FLAG out of the mask accepts
+    // both formats. Error frames are governed by CAN_RAW_ERR_FILTER only.
+    std::vector<struct can_filter> rawFilters;
+    rawFilters.reserve(static_cast<size_t>(qMax<qsizetype>(filters.size(), 1)));
+    for (const CANIdFilter& filter : filters) {
+        struct can_filter raw;
+        raw.can_mask = filter.mask & CAN_EFF_MASK;
+        raw.can_id   = filter.id & raw.can_mask;
+        if (!filter.anyFormat) {
+            raw.can_mask |= CAN_EFF_FLAG;
+            if (filter.extended)
+                raw.can_id |= CAN_EFF_FLAG;
+        }
+        rawFilters.push_back(raw);
+    }
+    if (rawFilters.empty())
+        rawFilters.push_back({0, 0});      // No filters at all would mean "receive nothing"
+
+    if (::setsockopt(m_socket, SOL_CAN_RAW, CAN_RAW_FILTER, rawFilters.data(),
+                     static_cast<socklen_t>(rawFilters.size() * sizeof(struct can_filter))) != 0)
+        return makeErrnoError(QString("setsockopt(%1, CAN_RAW_FILTER)").arg(m_ifName), errno);
+
+    qDebug() << "[SocketCAN] Acceptance filters on" << m_ifName << ":"
+             << (filters.isEmpty() ? QStringLiteral("all") : QString::number(filters.size()));
+    return CANResult::Success();
+}
+
+// ============================================================================
+//  Error Handling Helpers
+// ============================================================================
+
+QString SocketCANDriver::lastError() const
+{
+    QMutexLocker locker(&m_errorMutex);
+    return m_lastError;
+}
+
+void SocketCANDriver::setError(const QString& msg)
+{
+    {
+        QMutexLocker locker(&m_errorMutex);
+        m_lastError = msg;
+    }
+    qWarning() << "[SocketCAN]" << msg;
+}
+
+CANResult SocketCANDriver::makeErrnoError(const QString& context, int err)
+{
+    QString msg = QString("%1 failed: %2").arg(context, QString::fromLocal8Bit(std::strerror(err)));
+    setError(msg);
+    emit errorOccurred(msg);
+    return CANResult::Failure(msg);
+}
+
+} // namespace CANManager
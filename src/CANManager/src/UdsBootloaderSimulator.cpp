@@ -0,0 +1,325 @@
+/**
+ * @file UdsBootloaderSimulator.cpp
+ * @brief In-process UDS bootloader stand-in — implementation.
+ */
+
+#include "UdsBootloaderSimulator.h"
+
+#include <QDebug>
+
+namespace CANManager {
+
+namespace {
+
+enum ServiceId : uint8_t {
+    DiagnosticSessionControl = 0x10,
+    EcuReset                 = 0x11,
+    RoutineControl           = 0x31,
+    RequestDownload          = 0x34,
+    TransferData             = 0x36,
+    RequestTransferExit      = 0x37,
+    TesterPresent            = 0x3E,
+    NegativeResponse         = 0x7F
+};
+
+enum ResponseCode : uint8_t {
+    ServiceNotSupported             = 0x11,
+    SubFunctionNotSupported         = 0x12,
+    IncorrectMessageLength          = 0x13,
+    ConditionsNotCorrect            = 0x22,
+    RequestSequenceError            = 0x24,
+    RequestOutOfRange               = 0x31,
+    TransferDataSuspended           = 0x71,
+    WrongBlockSequenceCounter       = 0x73,
+    ResponsePending                 = 0x78,
+    ServiceNotSupportedInSession    = 0x7F
+};
+
+constexpr uint8_t  PROGRAMMING_SESSION  = 0x02;
+constexpr uint16_t ERASE_MEMORY_ROUTINE = 0xFF00;
+constexpr uint8_t  POSITIVE_RESPONSE_OFFSET = 0x40;
+
+/// Big-endian number of length bytes at offset
+uint32_t readNumber(const QByteArray& bytes, int offset, int length)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < length; ++i)
+        value = (value << 8) | static_cast<uint8_t>(bytes[offset + i]);
+    return value;
+}
+
+/// Address and size after an addressAndLengthFormatIdentifier at offset; false if malformed
+bool readAddressAndSize(const QByteArray& bytes, int offset, uint32_t& address, uint32_t& size)
+{
+    if (bytes.size() <= offset)
+        return false;
+    const uint8_t format = static_cast<uint8_t>(bytes[offset]);
+    const int addressLength = format & 0x0F;
+    const int sizeLength = format >> 4;
+    if (addressLength < 1 || addressLength > 4 || sizeLength < 1 || sizeLength > 4
+        || bytes.size() != offset + 1 + addressLength + sizeLength)
+        return false;
+    address = readNumber(bytes, offset + 1, addressLength);
+    size = readNumber(bytes, offset + 1 + addressLength, sizeLength);
+    return true;
+}
+
+QByteArray positive(uint8_t sid, const QByteArray& parameters = {})
+{
+    QByteArray response(1, static_cast<char>(sid + POSITIVE_RESPONSE_OFFSET));
+    response.append(parameters);
+    return response;
+}
+
+} // namespace
+
+// ============================================================================
+//  Constructor / Destructor
+// ============================================================================
+
+UdsBootloaderSimulator::UdsBootloaderSimulator(const Config& config)
+    : m_config(config)
+    , m_channel(config.transport)
+{
+}
+
+UdsBootloaderSimulator::~UdsBootloaderSimulator()
+{
+    stop();
+}
+
+CANResult UdsBootloaderSimulator::start()
+{
+    if (m_thread)
+        return CANResult::Success();
+    if (m_config.maxBlockLength < 3)
+        return CANResult::Failure("Bootloader block length must be at least 3");
+
+    CANResult result = m_channel.open();
+    if (!result.success)
+        return result;
+
+    m_session = 0x01;
+    m_downloading = false;
+    m_stop.store(false);
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->start();
+    qDebug() << "[UdsBootloader] Simulating bootloader on" << m_config.transport.slotName;
+    return CANResult::Success();
+}
+
+void UdsBootloaderSimulator::stop()
+{
+    if (!m_thread)
+        return;
+    m_stop.store(true);
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    m_channel.close();
+}
+
+bool UdsBootloaderSimulator::isRunning() const
+{
+    return m_thread != nullptr;
+}
+
+QMap<uint32_t, QByteArray> UdsBootloaderSimulator::memory() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_memory;
+}
+
+UdsBootloaderSimulator::Stats UdsBootloaderSimulator::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+// ============================================================================
+//  Request Handling (worker thread)
+// ============================================================================
+
+void UdsBootloaderSimulator::run()
+{
+    while (!m_stop.load()) {
+        QByteArray request;
+        if (!m_channel.receive(request, 20).success || request.isEmpty())
+            continue;
+        {
+            QMutexLocker locker(&m_mutex);
+            ++m_stats.requests;
+        }
+        const QByteArray response = handle(request);
+        if (!response.isEmpty())
+            m_channel.send(response, &m_stop);
+    }
+}
+
+QByteArray UdsBootloaderSimulator::handle(const QByteArray& request)
+{
+    const uint8_t sid = static_cast<uint8_t>(request[0]);
+    switch (sid) {
+    case DiagnosticSessionControl: {
+        if (request.size() != 2)
+            return negative(sid, IncorrectMessageLength);
+        const uint8_t session = static_cast<uint8_t>(request[1]) & 0x7F;
+        if (session < 0x01 || session > 0x03)
+            return negative(sid, SubFunctionNotSupported);
+        m_session = session;
+        if (session != PROGRAMMING_SESSION)
+            m_downloading = false;
+        QByteArray timing(1, static_cast<char>(session));
+        timing.append(QByteArray::fromHex("003201f4"));      // P2 50 ms, P2* 5000 ms
+        return positive(sid, timing);
+    }
+    case EcuReset:
+        if (request.size() != 2)
+            return negative(sid, IncorrectMessageLength);
+        m_session = 0x01;
+        m_downloading = false;
+        return positive(sid, request.mid(1, 1));
+    case TesterPresent:
+        if (request.size() != 2)
+            return negative(sid, IncorrectMessageLength);
+        if (static_cast<uint8_t>(request[1]) & 0x80)
+            return {};
+        return positive(sid, QByteArray(1, '\0'));
+    case RoutineControl:
+        if (request.size() >= 4 && request[1] == 0x01 && readNumber(request, 2, 2) == ERASE_MEMORY_ROUTINE)
+            return eraseMemory(request);
+        return negative(sid, RequestOutOfRange);
+    case RequestDownload:
+        return requestDownload(request);
+    case TransferData:
+        return transferData(request);
+    case RequestTransferExit:
+        return transferExit(request);
+    default:
+        return negative(sid, ServiceNotSupported);
+    }
+}
+
+QByteArray UdsBootloaderSimulator::eraseMemory(const QByteArray& request)
+{
+    if (m_session != PROGRAMMING_SESSION)
+        return negative(RoutineControl, ServiceNotSupportedInSession);
+    uint32_t address = 0, size = 0;
+    if (!readAddressAndSize(request, 4, address, size))
+        return negative(RoutineControl, IncorrectMessageLength);
+
+    waitBusy(RoutineControl);
+    {
+        QMutexLocker locker(&m_mutex);
+        for (auto it = m_memory.begin(); it != m_memory.end();) {
+            if (it.key() >= address && uint64_t(it.key()) < uint64_t(address) + size)
+                it = m_memory.erase(it);
+            else
+                ++it;
+        }
+    }
+    QByteArray status = request.mid(1, 3);
+    status.append('\0');                                    // Routine status: correct result
+    return positive(RoutineControl, status);
+}
+
+QByteArray UdsBootloaderSimulator::requestDownload(const QByteArray& request)
+{
+    if (m_session != PROGRAMMING_SESSION)
+        return negative(RequestDownload, ServiceNotSupportedInSession);
+    uint32_t address = 0, size = 0;
+    if (request.size() < 3 || !readAddressAndSize(request, 2, address, size))
+        return negative(RequestDownload, IncorrectMessageLength);
+    if (m_downloading)
+        return negative(RequestDownload, ConditionsNotCorrect);
+    if (request[1] != 0x00 || size == 0 || address < m_config.memoryStart
+        || uint64_t(address) + size > uint64_t(m_config.memoryStart) + m_config.memorySize)
+        return negative(RequestDownload, RequestOutOfRange);
+
+    m_downloading  = true;
+    m_address      = address;
+    m_size         = size;
+    m_nextSequence = 1;
+    m_download.clear();
+    m_download.reserve(size);
+
+    // lengthFormatIdentifier: byte count of maxNumberOfBlockLength in the high nibble
+    const int lengthBytes = m_config.maxBlockLength > 0xFFFF ? 4 : 2;
+    QByteArray parameters(1, static_cast<char>(lengthBytes << 4));
+    for (int shift = 8 * (lengthBytes - 1); shift >= 0; shift -= 8)
+        parameters.append(static_cast<char>((m_config.maxBlockLength >> shift) & 0xFF));
+    return positive(RequestDownload, parameters);
+}
+
+QByteArray UdsBootloaderSimulator::transferData(const QByteArray& request)
+{
+    if (!m_downloading)
+        return negative(TransferData, RequestSequenceError);
+    if (request.size() < 2 || uint32_t(request.size()) > m_config.maxBlockLength)
+        return negative(TransferData, IncorrectMessageLength);
+
+    const uint8_t sequence = static_cast<uint8_t>(request[1]);
+    if (sequence == m_nextSequence) {
+        const qsizetype length = request.size() - 2;
+        if (m_download.size() + length > qsizetype(m_size))
+            return negative(TransferData, TransferDataSuspended);
+        m_download.append(request.constData() + 2, length);
+        ++m_nextSequence;
+        QMutexLocker locker(&m_mutex);
+        ++m_stats.transferBlocks;
+        m_stats.bytesReceived += length;
+    } else if (sequence == static_cast<uint8_t>(m_nextSequence - 1) && !m_download.isEmpty()) {
+        // The client repeated a block whose response it missed
+        QMutexLocker locker(&m_mutex);
+        ++m_stats.repeatedBlocks;
+    } else {
+        return negative(TransferData, WrongBlockSequenceCounter);
+    }
+    return positive(TransferData, request.mid(1, 1));
+}
+
+QByteArray UdsBootloaderSimulator::transferExit(const QByteArray& request)
+{
+    if (request.size() != 1)
+        return negative(RequestTransferExit, IncorrectMessageLength);
+    if (!m_downloading || m_download.size() != qsizetype(m_size))
+        return negative(RequestTransferExit, RequestSequenceError);
+
+    waitBusy(RequestTransferExit);
+    m_downloading = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_memory[m_address] = m_download;
+    }
+    m_download.clear();
+    return positive(RequestTransferExit);
+}
+
+QByteArray UdsBootloaderSimulator::negative(uint8_t sid, uint8_t nrc)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        ++m_stats.negativeResponses;
+    }
+    QByteArray response(1, static_cast<char>(NegativeResponse));
+    response.append(static_cast<char>(sid));
+    response.append(static_cast<char>(nrc));
+    return response;
+}
+
+void UdsBootloaderSimulator::waitBusy(uint8_t sid)
+{
+    if (m_config.busyMs <= 0)
+        return;
+    QByteArray pending(1, static_cast<char>(NegativeResponse));
+    pending.append(static_cast<char>(sid));
+    pending.append(static_cast<char>(ResponsePending));
+    m_channel.send(pending, &m_stop);
+    {
+        QMutexLocker locker(&m_mutex);
+        ++m_stats.pendingResponses;
+    }
+    QThread::msleep(m_config.busyMs);
+}
+
+} // namespace CANManager
@@ -0,0 +1,488 @@
+/**
+ * @file UdsClient.cpp
+ * @brief UDS (ISO 14229) diagnostic client — implementation.
+ */
+
+#include "UdsClient.h"
+
+#include <QDeadlineTimer>
+#include <QDebug>
+
+#include <algorithm>
+
+namespace CANManager {
+
+namespace {
+
+enum ServiceId : uint8_t {
+    DiagnosticSessionControl = 0x10,
+    ReadDtcInformation       = 0x19,
+    ReadDataByIdentifier     = 0x22,
+    SecurityAccess           = 0x27,
+    WriteDataByIdentifier    = 0x2E,
+    RoutineControl           = 0x31,
+    TesterPresent            = 0x3E,
+    NegativeResponse         = 0x7F
+};
+
+constexpr uint8_t POSITIVE_RESPONSE_OFFSET = 0x40;
+constexpr uint8_t SUPPRESS_POSITIVE_RESPONSE = 0x80;
+
+/// receive() slice, so cancellation is noticed while waiting for a response
+constexpr int CANCEL_POLL_MS = 100;
+
+QByteArray message(std::initializer_list<uint8_t> bytes)
+{
+    QByteArray result;
+    for (uint8_t byte : bytes)
+        result.append(static_cast<char>(byte));
+    return result;
+}
+
+void appendU16(QByteArray& bytes, uint16_t value)
+{
+    bytes.append(static_cast<char>(value >> 8));
+    bytes.append(static_cast<char>(value & 0xFF));
+}
+
+struct KeyFunctionRegistry
+{
+    QMutex mutex;
+    QMap<QString, UdsClient::KeyFunction> functions;
+};
+
+KeyFunctionRegistry& keyFunctions()
+{
+    static KeyFunctionRegistry registry;
+    return registry;
+}
+
+uint16_t readU16(const QByteArray& bytes, qsizetype offset)
+{
+    return static_cast<uint16_t>((static_cast<uint8_t>(bytes[offset]) << 8) | static_cast<uint8_t>(bytes[offset + 1]));
+}
+
+} // namespace
+
+// ============================================================================
+//  Constructor / Destructor
+// ============================================================================
+
+UdsClient::UdsClient(const Config& config)
+    : m_config(config)
+    , m_channel(config.transport)
+    , m_p2Ms(config.p2Ms)
+    , m_p2StarMs(config.p2StarMs)
+{
+}
+
+UdsClient::~UdsClient()
+{
+    close();
+}
+
+CANResult UdsClient::open()
+{
+    if (m_config.p2Ms <= 0 || m_config.p2StarMs <= 0)
+        return CANResult::Failure("UDS P2 and P2* must be greater than 0");
+    if (m_config.maxDidsPerRequest < 1)
+        return CANResult::Failure("UDS DIDs per request must be at least 1");
+    return m_channel.open();
+}
+
+void UdsClient::close()
+{
+    stopTesterPresent();
+    m_channel.close();
+}
+
+bool UdsClient::isOpen() const
+{
+    return m_channel.isOpen();
+}
+
+// ============================================================================
+//  Request / Response
+// ============================================================================
+
+CANResult UdsClient::request(const QByteArray& request, Response& response, const std::atomic<bool>* cancel)
+{
+    response = Response{};
+    if (request.isEmpty())
+        return CANResult::Failure("UDS request is empty");
+
+    const uint8_t sid = static_cast<uint8_t>(request[0]);
+    QMutexLocker requestLocker(&m_requestMutex);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_lastActivity = Clock::now();
+    }
+
+    m_channel.clearReceived();
+    CANResult result = m_channel.send(request, cancel);
+    if (!result.success)
+        return result;
+    const Clock::time_point sent = Clock::now();
+
+    // P2 runs from the end of the request; each NRC 0x78 restarts it as P2*
+    int timeoutMs = m_p2Ms.load();
+    QDeadlineTimer deadline(timeoutMs);
+    for (;;) {
+        if (cancel && cancel->load())
+            return CANResult::Failure("Cancelled");
+
+        QByteArray received;
+        const int sliceMs = static_cast<int>(std::min<qint64>(deadline.remainingTime(), CANCEL_POLL_MS));
+        result = m_channel.receive(received, sliceMs);
+        if (!result.success) {
+            if (!deadline.hasExpired())
+                continue;
+            return CANResult::Failure(QString("No response to service 0x%1 within %2 ms%3")
+                .arg(sid, 2, 16, QChar('0')).arg(timeoutMs)
+                .arg(response.pendingCount ? QString(" after %1 × response pending").arg(response.pendingCount)
+                                           : QString()));
+        }
+        if (received.isEmpty())
+            continue;
+
+        const uint8_t first = static_cast<uint8_t>(received[0]);
+        if (first == NegativeResponse && received.size() >= 3 && static_cast<uint8_t>(received[1]) == sid) {
+            const uint8_t nrc = static_cast<uint8_t>(received[2]);
+            if (nrc == NRC_RESPONSE_PENDING) {
+                if (++response.pendingCount > m_config.maxPendingResponses)
+                    return CANResult::Failure(QString("Service 0x%1: more than %2 response pending")
+                        .arg(sid, 2, 16, QChar('0')).arg(m_config.maxPendingResponses));
+                timeoutMs = m_p2StarMs.load();
+                deadline = QDeadlineTimer(timeoutMs);
+                continue;
+            }
+            response.data      = received;
+            response.nrc       = nrc;
+            response.elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - sent).count();
+            return CANResult::Failure(QString("Negative response to service 0x%1: NRC 0x%2 (%3)")
+                .arg(sid, 2, 16, QChar('0')).arg(nrc, 2, 16, QChar('0')).arg(nrcName(nrc)));
+        }
+        if (first == static_cast<uint8_t>(sid + POSITIVE_RESPONSE_OFFSET)) {
+            response.data      = received;
+            response.positive  = true;
+            response.elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - sent).count();
+            return CANResult::Success();
+        }
+        // Answer to another service: a late response to an earlier request
+    }
+}
+
+// ============================================================================
+//  Services
+// ============================================================================
+
+CANResult UdsClient::diagnosticSessionControl(uint8_t session, Response* response)
+{
+    Response local;
+    Response& resp = response ? *response : local;
+    const QByteArray req = message({DiagnosticSessionControl, session});
+    const CANResult result = request(req, resp);
+    if (!result.success)
+        return result;
+
+    // Session parameter record: P2server_max (1 ms) and P2*server_max (10 ms)
+    if (resp.data.size() >= 6) {
+        m_p2Ms.store(readU16(resp.data, 2) + m_config.timingMarginMs);
+        m_p2StarMs.store(readU16(resp.data, 4) * 10 + m_config.timingMarginMs);
+    }
+    return result;
+}
+
+CANResult UdsClient::readDataByIdentifier(const QList<uint16_t>& dids, QMap<uint16_t, QByteArray>& values,
+                                          const std::atomic<bool>* cancel)
+{
+    return readDataByIdentifier(dids, {}, values, cancel);
+}
+
+CANResult UdsClient::readDataByIdentifier(const QList<uint16_t>& dids, const QMap<uint16_t, int>& requestLengths,
+                                          QMap<uint16_t, QByteArray>& values,
+                                          const std::atomic<bool>* cancel)
+{
+    if (dids.isEmpty())
+        return CANResult::Failure("No DIDs to read");
+
+    QMap<uint16_t, int> lengths;
+    {
+        QMutexLocker locker(&m_mutex);
+        lengths = m_didLengths;
+    }
+    for (auto it = requestLengths.cbegin(); it != requestLengths.cend(); ++it) {
+        if (it.value() > 0)
+            lengths.insert(it.key(), it.value());
+    }
+
+    // Values are only delimited by their known lengths: a DID of unknown
+    // length ends the request, since its data runs to the end of the response
+    const qsizetype maxPerRequest = qMax(1, m_config.maxDidsPerRequest);
+    for (qsizetype first = 0; first < dids.size();) {
+        qsizetype end = first;
+        while (end < dids.size() && end - first < maxPerRequest) {
+            if (!lengths.contains(dids[end++]))
+                break;
+        }
+        const QList<uint16_t> chunk = dids.mid(first, end - first);
+        first = end;
+
+        QByteArray req(1, static_cast<char>(ReadDataByIdentifier));
+        for (uint16_t did : chunk)
+            appendU16(req, did);
+
+        Response resp;
+        CANResult result = request(req, resp, cancel);
+        if (!result.success)
+            return result;
+        result = splitDidResponse(chunk, resp.data, lengths, values);
+        if (!result.success)
+            return result;
+    }
+    return CANResult::Success();
+}
+
+CANResult UdsClient::splitDidResponse(const QList<uint16_t>& dids, const QByteArray& data,
+                                      const QMap<uint16_t, int>& lengths,
+                                      QMap<uint16_t, QByteArray>& values)
+{
+    qsizetype pos = 1;
+    for (qsizetype i = 0; i < dids.size(); ++i) {
+        const uint16_t did = dids[i];
+        if (pos + 2 > data.size() || readU16(data, pos) != did)
+            return CANResult::Failure(QString("DID 0x%1 missing from response").arg(did, 4, 16, QChar('0')));
+        pos += 2;
+
+        qsizetype end = data.size();
+        if (lengths.contains(did)) {
+            end = pos + lengths.value(did);
+            if (end > data.size())
+                return CANResult::Failure(QString("DID 0x%1 response shorter than %2 bytes")
+                    .arg(did, 4, 16, QChar('0')).arg(lengths.value(did)));
+        } else if (i + 1 < dids.size()) {
+            return CANResult::Failure(QString("DID 0x%1 has no length to split the response at")
+                .arg(did, 4, 16, QChar('0')));
+        }
+        values.insert(did, data.mid(pos, end - pos));
+        pos = end;
+    }
+    return CANResult::Success();
+}
+
+CANResult UdsClient::writeDataByIdentifier(uint16_t did, const QByteArray& value)
+{
+    QByteArray req(1, static_cast<char>(WriteDataByIdentifier));
+    appendU16(req, did);
+    req.append(value);
+    Response resp;
+    return request(req, resp);
+}
+
+CANResult UdsClient::readDtcInformation(uint8_t subFunction, const QByteArray& parameters, Response& response)
+{
+    QByteArray req = message({ReadDtcInformation, subFunction});
+    req.append(parameters);
+    return request(req, response);
+}
+
+CANResult UdsClient::readDtcsByStatusMask(uint8_t mask, QList<Dtc>& dtcs, uint8_t* availabilityMask)
+{
+    Response resp;
+    const CANResult result = readDtcInformation(0x02, QByteArray(1, static_cast<char>(mask)), resp);
+    if (!result.success)
+        return result;
+    if (resp.data.size() < 3)
+        return CANResult::Failure("ReadDTCInformation response too short");
+
+    if (availabilityMask)
+        *availabilityMask = static_cast<uint8_t>(resp.data[2]);
+    dtcs.clear();
+    for (qsizetype pos = 3; pos + 4 <= resp.data.size(); pos += 4) {
+        Dtc dtc;
+        dtc.code = (static_cast<uint32_t>(static_cast<uint8_t>(resp.data[pos])) << 16)
+                 | (static_cast<uint32_t>(static_cast<uint8_t>(resp.data[pos + 1])) << 8)
+                 | static_cast<uint8_t>(resp.data[pos + 2]);
+        dtc.status = static_cast<uint8_t>(resp.data[pos + 3]);
+        dtcs.append(dtc);
+    }
+    return result;
+}
+
+CANResult UdsClient::routineControl(uint8_t type, uint16_t routineId, const QByteArray& option, Response& response)
+{
+    QByteArray req = message({RoutineControl, type});
+    appendU16(req, routineId);
+    req.append(option);
+    return request(req, response);
+}
+
+CANResult UdsClient::securityAccess(uint8_t level, const KeyFunction& computeKey, int seedLength)
+{
+    if (level % 2 == 0 || level > 0x7D)
+        return CANResult::Failure(QString("Invalid security access level 0x%1 (must be an odd seed request)")
+                                      .arg(level, 2, 16, QChar('0')));
+
+    Response resp;
+    CANResult result = request(message({SecurityAccess, level}), resp);
+    if (!result.success)
+        return result;
+
+    const QByteArray seed = resp.data.mid(2);
+    if (seed.isEmpty())
+        return CANResult::Failure(QString("No seed in the response to security level 0x%1")
+                                      .arg(level, 2, 16, QChar('0')));
+    if (seedLength > 0 && seed.size() != seedLength)
+        return CANResult::Failure(QString("Seed of %1 bytes for security level 0x%2, expected %3")
+                                      .arg(seed.size()).arg(level, 2, 16, QChar('0')).arg(seedLength));
+    if (std::all_of(seed.begin(), seed.end(), [](char byte) { return byte == 0; }))
+        return CANResult::Success();   // Already unlocked
+
+    const QByteArray key = computeKey ? computeKey(level, seed) : QByteArray();
+    if (key.isEmpty())
+        return CANResult::Failure(QString("No key for security level 0x%1").arg(level, 2, 16, QChar('0')));
+
+    QByteArray req = message({SecurityAccess, static_cast<uint8_t>(level + 1)});
+    req.append(key);
+    return request(req, resp);
+}
+
+CANResult UdsClient::testerPresent()
+{
+    Response resp;
+    return request(message({TesterPresent, 0x00}), resp);
+}
+
+// ============================================================================
+//  Background Tester Present
+// ============================================================================
+
+CANResult UdsClient::startTesterPresent(int periodMs)
+{
+    if (periodMs <= 0)
+        return CANResult::Failure("Tester present period must be greater than 0");
+    if (!isOpen())
+        return CANResult::Failure("UDS client not open");
+
+    QMutexLocker locker(&m_mutex);
+    m_testerPresentPeriodMs = periodMs;
+    if (m_testerPresentThread)
+        return CANResult::Success();   // New period applies from the next wake-up
+
+    m_testerPresentStop = false;
+    m_testerPresentThread = QThread::create([this]() { runTesterPresent(); });
+    m_testerPresentThread->setObjectName(QStringLiteral("UDS_TP_%1").arg(m_config.transport.slotName));
+    m_testerPresentThread->start();
+    return CANResult::Success();
+}
+
+void UdsClient::stopTesterPresent()
+{
+    QThread* thread = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_testerPresentStop = true;
+        m_wake.wakeAll();
+        std::swap(thread, m_testerPresentThread);
+    }
+    if (thread) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+bool UdsClient::isTesterPresentRunning() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_testerPresentThread != nullptr;
+}
+
+void UdsClient::runTesterPresent()
+{
+    static const QByteArray request = message({TesterPresent, SUPPRESS_POSITIVE_RESPONSE});
+
+    QMutexLocker locker(&m_mutex);
+    while (!m_testerPresentStop) {
+        // Any request restarts the server's S3 timer, so only idle periods need one
+        const Clock::time_point due = m_lastActivity + std::chrono::milliseconds(m_testerPresentPeriodMs);
+        if (Clock::now() < due) {
+            m_wake.wait(&m_mutex, QDeadlineTimer(due));
+            continue;
+        }
+        locker.unlock();
+
+        // A request in progress keeps the session alive by itself
+        CANResult result = CANResult::Success();
+        const bool idle = m_requestMutex.tryLock();
+        if (idle) {
+            result = m_channel.send(request);
+            m_requestMutex.unlock();
+        }
+
+        locker.relock();
+        m_lastActivity = Clock::now();
+        if (!result.success) {
+            qWarning() << "[UDS]" << m_config.transport.slotName << "tester present failed:" << result.errorMessage;
+            if (!m_channel.isOpen())
+                break;
+        }
+    }
+}
+
+// ============================================================================
+//  Helpers
+// ============================================================================
+
+void UdsClient::setDidLength(uint16_t did, int length)
+{
+    QMutexLocker locker(&m_mutex);
+    if (length > 0)
+        m_didLengths.insert(did, length);
+    else
+        m_didLengths.remove(did);
+}
+
+QString UdsClient::nrcName(uint8_t nrc)
+{
+    switch (nrc) {
+    case 0x10: return QStringLiteral("generalReject");
+    case 0x11: return QStringLiteral("serviceNotSupported");
+    case 0x12: return QStringLiteral("subFunctionNotSupported");
+    case 0x13: return QStringLiteral("incorrectMessageLengthOrInvalidFormat");
+    case 0x14: return QStringLiteral("responseTooLong");
+    case 0x21: return QStringLiteral("busyRepeatRequest");
+    case 0x22: return QStringLiteral("conditionsNotCorrect");
+    case 0x24: return QStringLiteral("requestSequenceError");
+    case 0x25: return QStringLiteral("noResponseFromSubnetComponent");
+    case 0x26: return QStringLiteral("failurePreventsExecutionOfRequestedAction");
+    case 0x31: return QStringLiteral("requestOutOfRange");
+    case 0x33: return QStringLiteral("securityAccessDenied");
+    case 0x35: return QStringLiteral("invalidKey");
+    case 0x36: return QStringLiteral("exceedNumberOfAttempts");
+    case 0x37: return QStringLiteral("requiredTimeDelayNotExpired");
+    case 0x70: return QStringLiteral("uploadDownloadNotAccepted");
+    case 0x71: return QStringLiteral("transferDataSuspended");
+    case 0x72: return QStringLiteral("generalProgrammingFailure");
+    case 0x73: return QStringLiteral("wrongBlockSequenceCounter");
+    case 0x78: return QStringLiteral("requestCorrectlyReceived-ResponsePending");
+    case 0x7E: return QStringLiteral("subFunctionNotSupportedInActiveSession");
+    case 0x7F: return QStringLiteral("serviceNotSupportedInActiveSession");
+    default:   return QStringLiteral("unknown");
+    }
+}
+
+void UdsClient::registerKeyFunction(const QString& name, KeyFunction function)
+{
+    KeyFunctionRegistry& registry = keyFunctions();
+    QMutexLocker locker(&registry.mutex);
+    registry.functions.insert(name, std::move(function));
+}
+
+UdsClient::KeyFunction UdsClient::keyFunction(const QString& name)
+{
+    KeyFunctionRegistry& registry = keyFunctions();
+    QMutexLocker locker(&registry.mutex);
+    return registry.functions.value(name);
+}
+
+} // namespace CANManager
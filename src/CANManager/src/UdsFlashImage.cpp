@@ -0,0 +1,375 @@
+/**
+ * @file UdsFlashImage.cpp
+ * @brief Memory-mapped flash image — indexing and streaming decode.
+ */
+
+#include "UdsFlashImage.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace CANManager {
+
+namespace {
+
+/// Hex digit value, or -1
+constexpr std::array<int8_t, 256> HEX_DIGITS = []() {
+    std::array<int8_t, 256> table{};
+    table.fill(-1);
+    for (int i = 0; i < 10; ++i)
+        table['0' + i] = static_cast<int8_t>(i);
+    for (int i = 0; i < 6; ++i) {
+        table['A' + i] = static_cast<int8_t>(10 + i);
+        table['a' + i] = static_cast<int8_t>(10 + i);
+    }
+    return table;
+}();
+
+/// Decode the two hex digits at text; false if either is not a hex digit
+inline bool hexByte(const char* text, uint8_t& value)
+{
+    const int high = HEX_DIGITS[static_cast<uint8_t>(text[0])];
+    const int low  = HEX_DIGITS[static_cast<uint8_t>(text[1])];
+    value = static_cast<uint8_t>((high << 4) | low);
+    return (high | low) >= 0;
+}
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/// Line-oriented cursor over a text image
+struct LineCursor
+{
+    const char* text;
+    qint64 size;
+    qint64 pos  = 0;
+    int    line = 0;
+
+    /** @brief Skip blank space up to the next record; false at the end. */
+    bool nextRecord()
+    {
+        while (pos < size && isSpace(text[pos])) {
+            if (text[pos] == '\n')
+                ++line;
+            ++pos;
+        }
+        return pos < size;
+    }
+
+    /** @brief Only blank space may follow a record on its line. */
+    bool atLineEnd() const
+    {
+        for (qint64 i = pos; i < size && text[i] != '\n'; ++i) {
+            if (!isSpace(text[i]))
+                return false;
+        }
+        return true;
+    }
+};
+
+CANResult recordError(const LineCursor& cursor, const QString& what)
+{
+    return CANResult::Failure(QString("Line %1: %2").arg(cursor.line + 1).arg(what));
+}
+
+} // namespace
+
+// ============================================================================
+//  Reader
+// ============================================================================
+
+UdsFlashImage::Reader::Reader(const UdsFlashImage& image, int segment)
+    : m_image(image)
+    , m_record(image.m_segments[segment].firstRecord)
+    , m_lastRecord(m_record + image.m_segments[segment].recordCount)
+    , m_remaining(image.m_segments[segment].size)
+{
+}
+
+int UdsFlashImage::Reader::read(uint8_t* out, int maxLength)
+{
+    int written = 0;
+    while (written < maxLength && m_record < m_lastRecord) {
+        const Record& record = m_image.m_records[m_record];
+        const int count = static_cast<int>(std::min<uint32_t>(record.length - m_recordOffset,
+                                                              static_cast<uint32_t>(maxLength - written)));
+        if (m_image.m_format == Format::Raw) {
+            std::memcpy(out + written, m_image.m_bytes + record.fileOffset + m_recordOffset, count);
+        } else {
+            // Validated while indexing; the digits are known to be hex
+            const char* text = m_image.m_bytes + record.fileOffset + 2 * qint64(m_recordOffset);
+            for (int i = 0; i < count; ++i)
+                hexByte(text + 2 * i, out[written + i]);
+        }
+        written += count;
+        m_recordOffset += count;
+        if (m_recordOffset == record.length) {
+            ++m_record;
+            m_recordOffset = 0;
+        }
+    }
+    m_remaining -= written;
+    return written;
+}
+
+// ============================================================================
+//  Open / Close
+// ============================================================================
+
+UdsFlashImage::~UdsFlashImage()
+{
+    close();
+}
+
+void UdsFlashImage::close()
+{
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+    }
+    m_file.close();
+    m_contents.clear();
+    m_bytes = nullptr;
+    m_size = 0;
+    m_format = Format::Auto;
+    m_records.clear();
+    m_segments.clear();
+    m_totalSize = 0;
+}
+
+CANResult UdsFlashImage::open(const QString& path, Format format, uint32_t rawAddress)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return CANResult::Failure(QString("Cannot open %1: %2").arg(path, m_file.errorString()));
+
+    m_size = m_file.size();
+    if (m_size <= 0) {
+        close();
+        return CANResult::Failure(QString("%1 is empty").arg(path));
+    }
+
+    // Map the whole file; read it instead where mapping is not possible
+    m_mapped = m_file.map(0, m_size);
+    m_bytes = reinterpret_cast<const char*>(m_mapped);
+    if (!m_mapped) {
+        m_contents = m_file.readAll();
+        m_bytes = m_contents.constData();
+        m_size = m_contents.size();
+    }
+
+    if (format == Format::Auto) {
+        LineCursor cursor{m_bytes, m_size};
+        cursor.nextRecord();
+        const char first = cursor.pos < m_size ? m_bytes[cursor.pos] : '\0';
+        const char second = cursor.pos + 1 < m_size ? m_bytes[cursor.pos + 1] : '\0';
+        if (first == ':')
+            format = Format::IntelHex;
+        else if (first == 'S' && second >= '0' && second <= '9')
+            format = Format::SRecord;
+        else
+            format = Format::Raw;
+    }
+    m_format = format;
+
+    CANResult result = CANResult::Success();
+    switch (format) {
+    case Format::IntelHex:
+        result = indexIntelHex(m_bytes, m_size);
+        break;
+    case Format::SRecord:
+        result = indexSRecord(m_bytes, m_size);
+        break;
+    default:
+        if (uint64_t(rawAddress) + uint64_t(m_size) > 0x100000000ULL)
+            result = CANResult::Failure("Raw image does not fit the 32-bit address space");
+        else
+            m_records.push_back({rawAddress, static_cast<uint32_t>(m_size), 0});
+        break;
+    }
+    if (result.success)
+        result = buildSegments();
+
+    if (!result.success) {
+        close();
+        return CANResult::Failure(QString("%1: %2").arg(path, result.errorMessage));
+    }
+
+    qDebug() << "[UdsFlash] Loaded" << formatName(m_format) << "image" << path << "-"
+             << m_totalSize << "bytes in" << m_segments.size() << "segments";
+    return CANResult::Success();
+}
+
+QString UdsFlashImage::formatName(Format format)
+{
+    switch (format) {
+    case Format::IntelHex: return "Intel HEX";
+    case Format::SRecord:  return "S-record";
+    case Format::Raw:      return "raw";
+    default:               return "auto";
+    }
+}
+
+// ============================================================================
+//  Indexing
+// ============================================================================
+
+CANResult UdsFlashImage::indexIntelHex(const char* text, qint64 size)
+{
+    enum RecordType : uint8_t {
+        Data = 0x00, EndOfFile = 0x01, ExtendedSegmentAddress = 0x02,
+        StartSegmentAddress = 0x03, ExtendedLinearAddress = 0x04, StartLinearAddress = 0x05
+    };
+
+    LineCursor cursor{text, size};
+    uint32_t base = 0;
+    while (cursor.nextRecord()) {
+        // :LLAAAATT<data>CC
+        const char* line = text + cursor.pos;
+        uint8_t header[4];
+        if (line[0] != ':' || size - cursor.pos < 11)
+            return recordError(cursor, "Not an Intel HEX record");
+        for (int i = 0; i < 4; ++i) {
+            if (!hexByte(line + 1 + 2 * i, header[i]))
+                return recordError(cursor, "Invalid hex digit");
+        }
+        const int length = header[0];
+        if (size - cursor.pos < 11 + 2 * qint64(length))
+            return recordError(cursor, "Record truncated");
+
+        uint8_t sum = header[0] + header[1] + header[2] + header[3];
+        for (int i = 0; i <= length; ++i) {
+            uint8_t byte = 0;
+            if (!hexByte(line + 9 + 2 * i, byte))
+                return recordError(cursor, "Invalid hex digit");
+            sum += byte;
+        }
+        if (sum != 0)
+            return recordError(cursor, "Checksum mismatch");
+
+        const uint32_t offset = (uint32_t(header[1]) << 8) | header[2];
+        const auto value16 = [&]() {
+            uint8_t high = 0, low = 0;
+            hexByte(line + 9, high);
+            hexByte(line + 11, low);
+            return (uint32_t(high) << 8) | low;
+        };
+        bool end = false;
+        switch (header[3]) {
+        case Data:
+            if (length > 0)
+                m_records.push_back({base + offset, uint32_t(length), cursor.pos + 9});
+            break;
+        case EndOfFile:
+            end = true;
+            break;
+        case ExtendedSegmentAddress:
+        case ExtendedLinearAddress:
+            if (length != 2)
+                return recordError(cursor, "Address record must hold 2 bytes");
+            base = header[3] == ExtendedLinearAddress ? value16() << 16 : value16() << 4;
+            break;
+        case StartSegmentAddress:
+        case StartLinearAddress:
+            break;
+        default:
+            return recordError(cursor, QString("Unknown record type %1").arg(header[3]));
+        }
+
+        cursor.pos += 11 + 2 * qint64(length);
+        if (!cursor.atLineEnd())
+            return recordError(cursor, "Trailing characters after record");
+        if (end)
+            break;
+    }
+    return CANResult::Success();
+}
+
+CANResult UdsFlashImage::indexSRecord(const char* text, qint64 size)
+{
+    LineCursor cursor{text, size};
+    while (cursor.nextRecord()) {
+        // S<type><count><address><data><checksum>; count covers address, data and checksum
+        const char* line = text + cursor.pos;
+        if (line[0] != 'S' || size - cursor.pos < 4 || line[1] < '0' || line[1] > '9')
+            return recordError(cursor, "Not an S-record");
+        const int type = line[1] - '0';
+        uint8_t count = 0;
+        if (!hexByte(line + 2, count))
+            return recordError(cursor, "Invalid hex digit");
+        if (size - cursor.pos < 4 + 2 * qint64(count))
+            return recordError(cursor, "Record truncated");
+
+        static constexpr int ADDRESS_BYTES[10] = {2, 2, 3, 4, 0, 2, 3, 4, 3, 2};
+        const int addressBytes = ADDRESS_BYTES[type];
+        if (type == 4 || count < addressBytes + 1)
+            return recordError(cursor, QString("Invalid S%1 record").arg(type));
+
+        uint8_t sum = count;
+        uint32_t address = 0;
+        for (int i = 0; i < count; ++i) {
+            uint8_t byte = 0;
+            if (!hexByte(line + 4 + 2 * i, byte))
+                return recordError(cursor, "Invalid hex digit");
+            sum += byte;
+            if (i < addressBytes)
+                address = (address << 8) | byte;
+        }
+        if (sum != 0xFF)
+            return recordError(cursor, "Checksum mismatch");
+
+        const uint32_t length = uint32_t(count - addressBytes - 1);
+        if (type >= 1 && type <= 3 && length > 0)
+            m_records.push_back({address, length, cursor.pos + 4 + 2 * addressBytes});
+
+        cursor.pos += 4 + 2 * qint64(count);
+        if (!cursor.atLineEnd())
+            return recordError(cursor, "Trailing characters after record");
+        if (type >= 7)
+            break;                                  // Termination record
+    }
+    return CANResult::Success();
+}
+
+CANResult UdsFlashImage::buildSegments()
+{
+    if (m_records.empty())
+        return CANResult::Failure("No data records");
+
+    // Files are usually in address order already; stable keeps record order on ties
+    std::stable_sort(m_records.begin(), m_records.end(),
+                     [](const Record& a, const Record& b) { return a.address < b.address; });
+
+    for (int i = 0; i < static_cast<int>(m_records.size()); ++i) {
+        const Record& record = m_records[i];
+        if (uint64_t(record.address) + record.length > 0x100000000ULL)
+            return CANResult::Failure(QString("Record at 0x%1 exceeds the 32-bit address space")
+                                          .arg(record.address, 8, 16, QChar('0')));
+
+        if (!m_segments.empty()) {
+            Segment& last = m_segments.back();
+            const uint64_t end = uint64_t(last.address) + last.size;
+            if (record.address < end)
+                return CANResult::Failure(QString("Overlapping data at 0x%1")
+                                              .arg(record.address, 8, 16, QChar('0')));
+            if (record.address == end) {
+                last.size += record.length;
+                ++last.recordCount;
+                m_totalSize += record.length;
+                continue;
+            }
+        }
+        m_segments.push_back({record.address, record.length, i, 1});
+        m_totalSize += record.length;
+    }
+    return CANResult::Success();
+}
+
+} // namespace CANManager
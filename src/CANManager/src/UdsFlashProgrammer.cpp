@@ -0,0 +1,271 @@
+/**
+ * @file UdsFlashProgrammer.cpp
+ * @brief UDS flash download (0x34 / 0x36 / 0x37) — implementation.
+ */
+
+#include "UdsFlashProgrammer.h"
+
+#include <QDebug>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+
+namespace CANManager {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum ServiceId : uint8_t {
+    RequestDownload     = 0x34,
+    TransferData        = 0x36,
+    RequestTransferExit = 0x37
+};
+
+constexpr uint16_t ERASE_MEMORY_ROUTINE = 0xFF00;
+
+/// 4-byte address, 4-byte size
+constexpr uint8_t ADDRESS_AND_LENGTH_FORMAT = 0x44;
+
+constexpr std::array<uint32_t, 256> CRC32_TABLE = []() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        table[i] = crc;
+    }
+    return table;
+}();
+
+void appendU32(QByteArray& bytes, uint32_t value)
+{
+    for (int shift = 24; shift >= 0; shift -= 8)
+        bytes.append(static_cast<char>((value >> shift) & 0xFF));
+}
+
+double msSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/// TransferData requests decoded ahead of the transfer
+struct BlockQueue
+{
+    QMutex mutex;
+    QWaitCondition changed;
+    std::deque<QByteArray> blocks;
+    bool     finished = false;          ///< Reader reached the end of the segment
+    bool     stopped  = false;          ///< Transfer ended early
+    uint32_t crc      = 0;              ///< Segment CRC, valid once finished
+};
+
+/// Reader thread, stopped and joined when it goes out of scope
+class BlockReader
+{
+public:
+    BlockReader(const UdsFlashImage& image, int segment, int payloadLength, int prefetch, BlockQueue& queue)
+        : m_queue(queue)
+    {
+        m_thread = QThread::create([&image, segment, payloadLength, prefetch, &queue]() {
+            UdsFlashImage::Reader reader(image, segment);
+            uint8_t sequence = 1;               // Wraps from 0xFF to 0x00
+            uint32_t crc = 0;
+            while (reader.remaining() > 0) {
+                QByteArray block;
+                block.resize(2 + static_cast<qsizetype>(std::min<uint32_t>(payloadLength, reader.remaining())));
+                block[0] = static_cast<char>(TransferData);
+                block[1] = static_cast<char>(sequence++);
+                uint8_t* data = reinterpret_cast<uint8_t*>(block.data()) + 2;
+                const int length = reader.read(data, static_cast<int>(block.size() - 2));
+                crc = UdsFlashProgrammer::crc32(crc, data, length);
+
+                QMutexLocker locker(&queue.mutex);
+                while (static_cast<int>(queue.blocks.size()) >= prefetch && !queue.stopped)
+                    queue.changed.wait(&queue.mutex);
+                if (queue.stopped)
+                    return;
+                queue.blocks.push_back(std::move(block));
+                queue.changed.wakeAll();
+            }
+            QMutexLocker locker(&queue.mutex);
+            queue.crc = crc;
+            queue.finished = true;
+            queue.changed.wakeAll();
+        });
+        m_thread->start();
+    }
+
+    ~BlockReader()
+    {
+        {
+            QMutexLocker locker(&m_queue.mutex);
+            m_queue.stopped = true;
+            m_queue.changed.wakeAll();
+        }
+        m_thread->wait();
+        delete m_thread;
+    }
+
+    /** @brief Next block; empty once the segment is complete. */
+    QByteArray next()
+    {
+        QMutexLocker locker(&m_queue.mutex);
+        while (m_queue.blocks.empty() && !m_queue.finished)
+            m_queue.changed.wait(&m_queue.mutex);
+        if (m_queue.blocks.empty())
+            return {};
+        QByteArray block = std::move(m_queue.blocks.front());
+        m_queue.blocks.pop_front();
+        m_queue.changed.wakeAll();
+        return block;
+    }
+
+private:
+    BlockQueue& m_queue;
+    QThread*    m_thread = nullptr;
+};
+
+} // namespace
+
+// ============================================================================
+//  Constructor
+// ============================================================================
+
+UdsFlashProgrammer::UdsFlashProgrammer(UdsClient& client)
+    : UdsFlashProgrammer(client, Options{})
+{
+}
+
+UdsFlashProgrammer::UdsFlashProgrammer(UdsClient& client, const Options& options)
+    : m_client(client)
+    , m_options(options)
+{
+}
+
+uint32_t UdsFlashProgrammer::crc32(uint32_t crc, const uint8_t* data, size_t length)
+{
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i)
+        crc = CRC32_TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// ============================================================================
+//  Programming
+// ============================================================================
+
+CANResult UdsFlashProgrammer::program(const UdsFlashImage& image, Report& report, const std::atomic<bool>* cancel)
+{
+    report = Report{};
+    if (image.segments().empty())
+        return CANResult::Failure("Flash image is empty");
+
+    QList<double> latencies;
+    const Clock::time_point start = Clock::now();
+    CANResult result = CANResult::Success();
+    for (int i = 0; i < static_cast<int>(image.segments().size()) && result.success; ++i)
+        result = programSegment(image, i, report, latencies, cancel);
+
+    report.elapsedMs = msSince(start);
+    if (report.elapsedMs > 0.0)
+        report.bytesPerSecond = report.bytes * 1000.0 / report.elapsedMs;
+    if (!latencies.isEmpty()) {
+        std::sort(latencies.begin(), latencies.end());
+        double sum = 0.0;
+        for (double latency : latencies)
+            sum += latency;
+        report.minBlockMs = latencies.first();
+        report.maxBlockMs = latencies.last();
+        report.avgBlockMs = sum / latencies.size();
+        report.p95BlockMs = latencies[static_cast<qsizetype>((latencies.size() - 1) * 0.95)];
+    }
+
+    qDebug() << "[UdsFlash]" << (result.success ? "Programmed" : "Aborted after") << report.bytes
+             << "bytes in" << report.blocks << "blocks," << report.elapsedMs << "ms,"
+             << report.bytesPerSecond / 1024.0 << "KiB/s";
+    return result;
+}
+
+CANResult UdsFlashProgrammer::programSegment(const UdsFlashImage& image, int segment, Report& report,
+                                             QList<double>& latencies, const std::atomic<bool>* cancel)
+{
+    const UdsFlashImage::Segment& range = image.segments()[segment];
+    const QString where = QString("Segment 0x%1").arg(range.address, 8, 16, QChar('0'));
+    SegmentReport segmentReport;
+    segmentReport.address = range.address;
+    segmentReport.size    = range.size;
+
+    QByteArray addressAndSize;
+    appendU32(addressAndSize, range.address);
+    appendU32(addressAndSize, range.size);
+
+    UdsClient::Response response;
+    CANResult result = CANResult::Success();
+    if (m_options.eraseBeforeDownload) {
+        QByteArray option(1, static_cast<char>(ADDRESS_AND_LENGTH_FORMAT));
+        option.append(addressAndSize);
+        result = m_client.routineControl(0x01, ERASE_MEMORY_ROUTINE, option, response);
+        if (!result.success)
+            return CANResult::Failure(QString("%1 erase: %2").arg(where, result.errorMessage));
+    }
+
+    // RequestDownload → lengthFormatIdentifier (high nibble: byte count) + maxNumberOfBlockLength
+    QByteArray requestDownload;
+    requestDownload.append(static_cast<char>(RequestDownload));
+    requestDownload.append(static_cast<char>(m_options.dataFormatIdentifier));
+    requestDownload.append(static_cast<char>(ADDRESS_AND_LENGTH_FORMAT));
+    requestDownload.append(addressAndSize);
+    result = m_client.request(requestDownload, response, cancel);
+    if (!result.success)
+        return CANResult::Failure(QString("%1 RequestDownload: %2").arg(where, result.errorMessage));
+
+    const int lengthBytes = response.data.size() >= 2 ? static_cast<uint8_t>(response.data[1]) >> 4 : 0;
+    if (lengthBytes < 1 || lengthBytes > 4 || response.data.size() < 2 + lengthBytes)
+        return CANResult::Failure(QString("%1 RequestDownload: malformed response").arg(where));
+    uint32_t maxBlockLength = 0;
+    for (int i = 0; i < lengthBytes; ++i)
+        maxBlockLength = (maxBlockLength << 8) | static_cast<uint8_t>(response.data[2 + i]);
+    // A server may report anything up to 0xFFFFFFFF; never build blocks larger
+    // than the transport (or the caller) allows
+    const int limit = m_options.maxBlockLength > 0 ? m_options.maxBlockLength : DEFAULT_MAX_BLOCK_LENGTH;
+    maxBlockLength = std::min<uint32_t>(maxBlockLength, static_cast<uint32_t>(limit));
+    if (maxBlockLength < 3)
+        return CANResult::Failure(QString("%1: block length %2 leaves no room for data").arg(where).arg(maxBlockLength));
+    segmentReport.maxBlockLength = static_cast<int>(maxBlockLength);
+
+    // The block length counts the service ID and the sequence counter
+    BlockQueue queue;
+    {
+        BlockReader reader(image, segment, static_cast<int>(maxBlockLength - 2),
+                           std::max(1, m_options.prefetchBlocks), queue);
+        for (QByteArray block = reader.next(); !block.isEmpty(); block = reader.next()) {
+            const Clock::time_point sent = Clock::now();
+            result = m_client.request(block, response, cancel);
+            if (!result.success)
+                return CANResult::Failure(QString("%1 TransferData block %2: %3")
+                                              .arg(where).arg(segmentReport.blocks + 1).arg(result.errorMessage));
+            if (response.data.size() < 2 || response.data[1] != block[1])
+                return CANResult::Failure(QString("%1 TransferData block %2: sequence counter not confirmed")
+                                              .arg(where).arg(segmentReport.blocks + 1));
+            latencies.append(msSince(sent));
+            ++segmentReport.blocks;
+            ++report.blocks;
+            report.bytes += block.size() - 2;
+        }
+    }
+    segmentReport.crc32 = queue.crc;
+
+    result = m_client.request(QByteArray(1, static_cast<char>(RequestTransferExit)), response, cancel);
+    if (!result.success)
+        return CANResult::Failure(QString("%1 RequestTransferExit: %2").arg(where, result.errorMessage));
+
+    report.segments.append(segmentReport);
+    return CANResult::Success();
+}
+
+} // namespace CANManager
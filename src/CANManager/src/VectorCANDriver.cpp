@@ -2,14 +2,13 @@
  * @file VectorCANDriver.cpp
  * @brief Vector XL Library CAN driver — full implementation.
  *
- * Runtime-loads vxlapi64.dll / vxlapi.dll and provides complete CAN HS + FD
- * communication through Vector hardware.
+ * Provides complete CAN HS + FD communication on one Vector channel (XL
+ * port); the shared vxlapi64.dll / vxlapi.dll is loaded by VectorXLLibrary.
  */
 
 #include "VectorCANDriver.h"
 
 #include <QDebug>
-#include <QCoreApplication>
 #include <QElapsedTimer>
 #include <cstring>
 
@@ -66,127 +65,6 @@ VectorCANDriver::~VectorCANDriver()
     shutdown();
 }
 
-// ============================================================================
-//  DLL Loading
-// ============================================================================
-
-bool VectorCANDriver::loadLibrary()
-{
-    if (m_xlLib.isLoaded())
-        return true;
-
-    // Try 64-bit DLL first (common on modern systems), then 32-bit
-    static const QStringList dllNames = {
-        QStringLiteral("vxlapi64"),
-        QStringLiteral("vxlapi")
-    };
-
-    for (const auto& name : dllNames) {
-        m_xlLib.setFileName(name);
-        if (m_xlLib.load()) {
-            qDebug() << "[VectorCAN] Loaded" << m_xlLib.fileName();
-            return true;
-        }
-    }
-
-    // Try from third_party folder
-    QString appDir = QCoreApplication::applicationDirPath();
-    for (const auto& name : dllNames) {
-        m_xlLib.setFileName(appDir + "/../../third_party/vector_xl/bin/" + name);
-        if (m_xlLib.load()) {
-            qDebug() << "[VectorCAN] Loaded from third_party:" << m_xlLib.fileName();
-            return true;
-        }
-    }
-
-    setError(QString("Failed to load Vector XL Library: %1").arg(m_xlLib.errorString()));
-    return false;
-}
-
-void VectorCANDriver::unloadLibrary()
-{
-    if (m_xlLib.isLoaded()) {
-        m_xlLib.unload();
-        qDebug() << "[VectorCAN] Library unloaded";
-    }
-
-    // Clear all function pointers
-    m_xlOpenDriver = nullptr;
-    m_xlCloseDriver = nullptr;
-    m_xlGetDriverConfig = nullptr;
-    m_xlGetApplConfig = nullptr;
-    m_xlSetApplConfig = nullptr;
-    m_xlGetChannelIndex = nullptr;
-    m_xlGetChannelMask = nullptr;
-    m_xlOpenPort = nullptr;
-    m_xlClosePort = nullptr;
-    m_xlActivateChannel = nullptr;
-    m_xlDeactivateChannel = nullptr;
-    m_xlCanSetChannelBitrate = nullptr;
-    m_xlCanSetChannelOutput = nullptr;
-    m_xlCanSetChannelMode = nullptr;
-    m_xlCanFdSetConfiguration = nullptr;
-    m_xlCanTransmit = nullptr;
-    m_xlCanTransmitEx = nullptr;
-    m_xlReceive = nullptr;
-    m_xlCanReceive = nullptr;
-    m_xlSetNotification = nullptr;
-    m_xlFlushReceiveQueue = nullptr;
-    m_xlGetErrorString = nullptr;
-    m_xlGetEventString = nullptr;
-}
-
-bool VectorCANDriver::resolveFunctions()
-{
-    if (!m_xlLib.isLoaded())
-        return false;
-
-    // Helper macro for resolving functions
-    #define RESOLVE_XL(funcName, typeName) \
-        m_##funcName = reinterpret_cast<typeName>(m_xlLib.resolve(#funcName)); \
-        if (!m_##funcName) { \
-            qWarning() << "[VectorCAN] Failed to resolve:" << #funcName; \
-            return false; \
-        }
-
-    RESOLVE_XL(xlOpenDriver,            XLOPENDRIVER)
-    RESOLVE_XL(xlCloseDriver,           XLCLOSEDRIVER)
-    RESOLVE_XL(xlGetDriverConfig,       XLGETDRIVERCONFIG)
-    RESOLVE_XL(xlOpenPort,              XLOPENPORT)
-    RESOLVE_XL(xlClosePort,             XLCLOSEPORT)
-    RESOLVE_XL(xlActivateChannel,       XLACTIVATECHANNEL)
-    RESOLVE_XL(xlDeactivateChannel,     XLDEACTIVATECHANNEL)
-    RESOLVE_XL(xlCanSetChannelBitrate,  XLCANSETCHANNELBITRATE)
-    RESOLVE_XL(xlCanSetChannelOutput,   XLCANSETCHANNELOUTPUT)
-    RESOLVE_XL(xlSetNotification,       XLSETNOTIFICATION)
-    RESOLVE_XL(xlFlushReceiveQueue,     XLFLUSHRECEIVEQUEUE)
-    RESOLVE_XL(xlCanTransmit,           XLCANTRANSMIT)
-    RESOLVE_XL(xlReceive,               XLRECEIVE)
-
-    // Optional functions (may not exist in older DLL versions)
-    #define RESOLVE_XL_OPTIONAL(funcName, typeName) \
-        m_##funcName = reinterpret_cast<typeName>(m_xlLib.resolve(#funcName)); \
-        if (!m_##funcName) { \
-            qDebug() << "[VectorCAN] Optional function not found:" << #funcName; \
-        }
-
-    RESOLVE_XL_OPTIONAL(xlGetApplConfig,          XLGETAPPLCONFIG)
-    RESOLVE_XL_OPTIONAL(xlSetApplConfig,           XLSETAPPLCONFIG)
-    RESOLVE_XL_OPTIONAL(xlGetChannelIndex,         XLGETCHANNELINDEX)
-    RESOLVE_XL_OPTIONAL(xlGetChannelMask,          XLGETCHANNELMASK)
-    RESOLVE_XL_OPTIONAL(xlCanSetChannelMode,       XLCANSETCHANNELMODE)
-    RESOLVE_XL_OPTIONAL(xlCanFdSetConfiguration,   XLCANFDSETCONFIGURATION)
-    RESOLVE_XL_OPTIONAL(xlCanTransmitEx,           XLCANTRANSMITEX)
-    RESOLVE_XL_OPTIONAL(xlCanReceive,              XLCANRECEIVE)
-    RESOLVE_XL_OPTIONAL(xlGetErrorString,          XLGETERRORSTRING)
-    RESOLVE_XL_OPTIONAL(xlGetEventString,          XLGETEVENTSTRING)
-
-    #undef RESOLVE_XL
-    #undef RESOLVE_XL_OPTIONAL
-
-    return true;
-}
-
 // ============================================================================
 //  ICANDriver — Lifecycle
 // ============================================================================
@@ -198,84 +76,39 @@ bool VectorCANDriver::initialize()
     if (m_driverOpen)
         return true;
 
-    if (!loadLibrary())
-        return false;
-
-    if (!resolveFunctions()) {
-        unloadLibrary();
-        return false;
-    }
-
-    XLstatus status = m_xlOpenDriver();
-    if (status != XL_SUCCESS) {
-        setError(QString("xlOpenDriver failed: %1").arg(xlStatusToString(status)));
-        unloadLibrary();
+    QString error;
+    if (!VectorXLLibrary::instance().acquire(m_xl, error)) {
+        setError(error);
         return false;
     }
 
     m_driverOpen = true;
-    qDebug() << "[VectorCAN] Driver initialized. DLL version:" << xlDllVersion();
     return true;
 }
 
 void VectorCANDriver::shutdown()
 {
-    // Stop async receive before anything else
-    stopAsyncReceive();
+    closeChannel();
 
     QMutexLocker locker(&m_mutex);
+    QMutexLocker txLocker(&m_txMutex);
+    QMutexLocker rxLocker(&m_rxMutex);
+    if (!m_driverOpen)
+        return;
 
-    if (m_portHandle != XL_INVALID_PORTHANDLE) {
-        locker.unlock();
-        closeChannel();
-        locker.relock();
-    }
-
-    if (m_driverOpen && m_xlCloseDriver) {
-        m_xlCloseDriver();
-        m_driverOpen = false;
-        qDebug() << "[VectorCAN] Driver closed";
-    }
-
-    unloadLibrary();
+    m_xl = VectorXLLibrary::Functions{};
+    m_driverOpen = false;
+    VectorXLLibrary::instance().release();
 }
 
 bool VectorCANDriver::isAvailable() const
 {
-    if (m_availableCached >= 0)
-        return m_availableCached == 1;
-
-    // Quick check: try loading the library without keeping it
-    QLibrary testLib;
-    for (const auto& name : {QStringLiteral("vxlapi64"), QStringLiteral("vxlapi")}) {
-        testLib.setFileName(name);
-        if (testLib.load()) {
-            testLib.unload();
-            m_availableCached = 1;
-            return true;
-        }
-    }
-    m_availableCached = 0;
-    return false;
+    return VectorXLLibrary::instance().isAvailable();
 }
 
 QString VectorCANDriver::xlDllVersion() const
 {
-    QMutexLocker locker(&m_mutex);
-    if (!m_driverOpen || !m_xlGetDriverConfig)
-        return {};
-
-    XLdriverConfig drvConfig;
-    memset(&drvConfig, 0, sizeof(drvConfig));
-    XLstatus status = m_xlGetDriverConfig(&drvConfig);
-    if (status != XL_SUCCESS)
-        return {};
-
-    unsigned int ver = drvConfig.dllVersion;
-    return QString("%1.%2.%3")
-        .arg((ver >> 24) & 0xFF)
-        .arg((ver >> 16) & 0xFF)
-        .arg(ver & 0xFFFF);
+    return VectorXLLibrary::instance().dllVersion();
 }
 
 // ============================================================================
@@ -287,14 +120,14 @@ QList<CANChannelInfo> VectorCANDriver::detectChannels()
     QMutexLocker locker(&m_mutex);
     QList<CANChannelInfo> channels;
 
-    if (!m_driverOpen || !m_xlGetDriverConfig) {
+    if (!m_driverOpen) {
         setError("Driver not initialized");
         return channels;
     }
 
     XLdriverConfig drvConfig;
     memset(&drvConfig, 0, sizeof(drvConfig));
-    XLstatus status = m_xlGetDriverConfig(&drvConfig);
+    XLstatus status = m_xl.xlGetDriverConfig(&drvConfig);
     if (status != XL_SUCCESS) {
         setError(QString("xlGetDriverConfig failed: %1").arg(xlStatusToString(status)));
         return channels;
@@ -345,6 +178,8 @@ CANResult VectorCANDriver::openChannel(const CANChannelInfo& channel,
                                         const CANBusConfig& config)
 {
     QMutexLocker locker(&m_mutex);
+    QMutexLocker txLocker(&m_txMutex);
+    QMutexLocker rxLocker(&m_rxMutex);
 
     if (!m_driverOpen)
         return CANResult::Failure("Driver not initialized");
@@ -362,7 +197,7 @@ CANResult VectorCANDriver::openChannel(const CANChannelInfo& channel,
 
     // Open port
     QByteArray appNameUtf8 = m_appName.toUtf8();
-    XLstatus status = m_xlOpenPort(
+    XLstatus status = m_xl.xlOpenPort(
         &m_portHandle,
         appNameUtf8.data(),
         m_channelMask,
@@ -390,7 +225,7 @@ CANResult VectorCANDriver::openChannel(const CANChannelInfo& channel,
     if (m_permissionMask & m_channelMask) {
         if (m_isFD) {
             // CAN FD configuration
-            if (m_xlCanFdSetConfiguration) {
+            if (m_xl.xlCanFdSetConfiguration) {
                 XLcanFdConf fdConf;
                 memset(&fdConf, 0, sizeof(fdConf));
                 fdConf.arbitrationBitRate = static_cast<unsigned int>(config.bitrate);
@@ -406,14 +241,14 @@ CANResult VectorCANDriver::openChannel(const CANChannelInfo& channel,
                 fdConf.tseg1Dbr = 0;
                 fdConf.tseg2Dbr = 0;
 
-                status = m_xlCanFdSetConfiguration(m_portHandle, m_channelMask, &fdConf);
+                status = m_xl.xlCanFdSetConfiguration(m_portHandle, m_channelMask, &fdConf);
                 if (status != XL_SUCCESS) {
                     qWarning() << "[VectorCAN] xlCanFdSetConfiguration failed:"
                                << xlStatusToString(status)
                                << "- falling back to classic CAN";
                     m_isFD = false;
                     // Try classic bitrate instead
-                    status = m_xlCanSetChannelBitrate(m_portHandle, m_channelMask,
+                    status = m_xl.xlCanSetChannelBitrate(m_portHandle, m_channelMask,
                                                       static_cast<unsigned long>(config.bitrate));
                     if (status != XL_SUCCESS) {
                         qWarning() << "[VectorCAN] xlCanSetChannelBitrate also failed:"
@@ -428,7 +263,7 @@ CANResult VectorCANDriver::openChannel(const CANChannelInfo& channel,
 
         if (!m_isFD) {
             // Classic CAN bitrate configuration
-            status = m_xlCanSetChannelBitrate(m_portHandle, m_channelMask,
+            status = m_xl.xlCanSetChannelBitrate(m_portHandle, m_channelMask,
                                               static_cast<unsigned long>(config.bitrate));
             if (status != XL_SUCCESS) {
                 qWarning() << "[VectorCAN] xlCanSetChannelBitrate warning:"
@@ -439,37 +274,46 @@ CANResult VectorCANDriver::openChannel(const CANChannelInfo& channel,
 
         // Set normal output mode (unless listen-only requested)
         int outputMode = config.listenOnly ? XL_OUTPUT_MODE_SILENT : XL_OUTPUT_MODE_NORMAL;
-        m_xlCanSetChannelOutput(m_portHandle, m_channelMask, outputMode);
+        m_xl.xlCanSetChannelOutput(m_portHandle, m_channelMask, outputMode);
+
+        // Start with open acceptance filters, whatever the last user left behind
+        if (m_xl.xlCanResetAcceptance) {
+            m_xl.xlCanResetAcceptance(m_portHandle, m_channelMask, XL_CAN_STD);
+            m_xl.xlCanResetAcceptance(m_portHandle, m_channelMask, XL_CAN_EXT);
+        }
     }
+    m_acceptanceFilters.store(std::make_shared<const QList<CANIdFilter>>());
 
     // Set up notification event for receive
     m_notifyEvent = nullptr;
-    status = m_xlSetNotification(m_portHandle, &m_notifyEvent, 1);
+    status = m_xl.xlSetNotification(m_portHandle, &m_notifyEvent, 1);
     if (status != XL_SUCCESS) {
         qWarning() << "[VectorCAN] xlSetNotification warning:" << xlStatusToString(status);
         // Non-fatal: receive with polling will still work (less efficient)
     }
 
     // Activate channel (go on-bus)
-    status = m_xlActivateChannel(m_portHandle, m_channelMask,
+    status = m_xl.xlActivateChannel(m_portHandle, m_channelMask,
                                   XL_BUS_TYPE_CAN, XL_ACTIVATE_RESET_CLOCK);
     if (status != XL_SUCCESS) {
         auto err = makeError("xlActivateChannel", status);
         // Clean up
-        m_xlClosePort(m_portHandle);
+        m_xl.xlClosePort(m_portHandle);
         m_portHandle = XL_INVALID_PORTHANDLE;
         m_notifyEvent = nullptr;
         return err;
     }
 
     // Flush any stale messages
-    m_xlFlushReceiveQueue(m_portHandle);
+    m_xl.xlFlushReceiveQueue(m_portHandle);
 
     qDebug() << "[VectorCAN] Channel activated."
              << "FD:" << m_isFD
              << "Bitrate:" << config.bitrate
              << (m_isFD ? QString(" FD Data BR: %1").arg(config.fdDataBitrate) : QString());
 
+    rxLocker.unlock();
+    txLocker.unlock();
     locker.unlock();
     emit channelOpened();
 
@@ -478,21 +322,24 @@ CANResult VectorCANDriver::openChannel(const CANChannelInfo& channel,
 
 void VectorCANDriver::closeChannel()
 {
-    // Stop async receive first
-    stopAsyncReceive();
-
     QMutexLocker locker(&m_mutex);
+    QMutexLocker txLocker(&m_txMutex);
 
     if (m_portHandle == XL_INVALID_PORTHANDLE)
         return;
 
+    // Wake a receive() blocked on the notification event so the RX lock is released
+    if (m_notifyEvent)
+        SetEvent(m_notifyEvent);
+    QMutexLocker rxLocker(&m_rxMutex);
+
     // Deactivate channel (go off-bus)
-    if (m_xlDeactivateChannel)
-        m_xlDeactivateChannel(m_portHandle, m_channelMask);
+    if (m_xl.xlDeactivateChannel)
+        m_xl.xlDeactivateChannel(m_portHandle, m_channelMask);
 
     // Close port
-    if (m_xlClosePort)
-        m_xlClosePort(m_portHandle);
+    if (m_xl.xlClosePort)
+        m_xl.xlClosePort(m_portHandle);
 
     qDebug() << "[VectorCAN] Channel closed. Handle was:" << m_portHandle;
 
@@ -502,6 +349,8 @@ void VectorCANDriver::closeChannel()
     m_notifyEvent = nullptr;
     m_isFD = false;
 
+    rxLocker.unlock();
+    txLocker.unlock();
     locker.unlock();
     emit channelClosed();
 }
@@ -513,29 +362,11 @@ bool VectorCANDriver::isOpen() const
 }
 
 // ============================================================================
-//  Transmit
+//  Event Conversion
 // ============================================================================
 
-CANResult VectorCANDriver::transmit(const CANMessage& msg)
+static void toClassicTxEvent(const CANMessage& msg, XLevent& xlEvent)
 {
-    QMutexLocker locker(&m_mutex);
-
-    if (m_portHandle == XL_INVALID_PORTHANDLE)
-        return CANResult::Failure("Channel not open");
-
-    if (!(m_permissionMask & m_channelMask))
-        return CANResult::Failure("No transmit access (channel opened by another application)");
-
-    if (msg.isFD && m_isFD) {
-        return transmitFD(msg);
-    }
-    return transmitClassic(msg);
-}
-
-CANResult VectorCANDriver::transmitClassic(const CANMessage& msg)
-{
-    // Build classic CAN event
-    XLevent xlEvent;
     memset(&xlEvent, 0, sizeof(xlEvent));
 
     xlEvent.tag = XL_TRANSMIT_MSG;
@@ -550,22 +381,10 @@ CANResult VectorCANDriver::transmitClassic(const CANMessage& msg)
         xlEvent.tagData.msg.flags |= XL_CAN_MSG_FLAG_REMOTE_FRAME;
 
     memcpy(xlEvent.tagData.msg.data, msg.data, qMin((int)msg.dlc, 8));
-
-    unsigned int msgCount = 1;
-    XLstatus status = m_xlCanTransmit(m_portHandle, m_channelMask, &msgCount, &xlEvent);
-
-    if (status != XL_SUCCESS)
-        return makeError("xlCanTransmit", status);
-
-    return CANResult::Success();
 }
 
-CANResult VectorCANDriver::transmitFD(const CANMessage& msg)
+static void toFDTxEvent(const CANMessage& msg, XLcanTxEvent& txEvent)
 {
-    if (!m_xlCanTransmitEx)
-        return CANResult::Failure("CAN FD transmit not available (xlCanTransmitEx missing)");
-
-    XLcanTxEvent txEvent;
     memset(&txEvent, 0, sizeof(txEvent));
 
     txEvent.tag = XL_CAN_EV_TAG_TX_MSG;
@@ -588,91 +407,159 @@ CANResult VectorCANDriver::transmitFD(const CANMessage& msg)
 
     int dataLen = msg.isFD ? dlcToLength(msg.dlc) : qMin((int)msg.dlc, 8);
     memcpy(txEvent.tagData.canMsg.data, msg.data, dataLen);
+}
 
-    unsigned int msgCntSent = 0;
-    XLstatus status = m_xlCanTransmitEx(m_portHandle, m_channelMask,
-                                         1, &msgCntSent, &txEvent);
+/// Convert a classic receive event; returns false for non-CAN events.
+static bool fromClassicEvent(const XLevent& xlEvent, CANMessage& msg)
+{
+    if (xlEvent.tag != XL_RECEIVE_MSG)
+        return false;
 
-    if (status != XL_SUCCESS)
-        return makeError("xlCanTransmitEx", status);
+    msg.id         = xlEvent.tagData.msg.id & ~XL_CAN_EXT_MSG_ID;
+    msg.isExtended = (xlEvent.tagData.msg.id & XL_CAN_EXT_MSG_ID) != 0;
+    msg.dlc        = static_cast<uint8_t>(qMin((unsigned short)xlEvent.tagData.msg.dlc,
+                                                (unsigned short)8));
+    msg.isFD       = false;
+    msg.isBRS      = false;
+    msg.isRemote   = (xlEvent.tagData.msg.flags & XL_CAN_MSG_FLAG_REMOTE_FRAME) != 0;
+    msg.isError    = (xlEvent.tagData.msg.flags & XL_CAN_MSG_FLAG_ERROR_FRAME) != 0;
+    msg.isTxConfirm = (xlEvent.tagData.msg.flags & XL_CAN_MSG_FLAG_TX_COMPLETED) != 0;
+    msg.timestamp  = xlEvent.timeStamp;
 
-    if (msgCntSent == 0)
-        return CANResult::Failure("Message was not sent (queue full?)");
+    memcpy(msg.data, xlEvent.tagData.msg.data, msg.dlc);
+    return true;
+}
 
-    return CANResult::Success();
+/// Convert an FD receive event; returns false for chip state / error events.
+static bool fromFDEvent(const XLcanRxEvent& rxEvent, CANMessage& msg)
+{
+    if (rxEvent.tag != XL_CAN_EV_TAG_RX_OK && rxEvent.tag != XL_CAN_EV_TAG_TX_OK)
+        return false;
+
+    const auto& rxMsg = rxEvent.tagData.canRxOkMsg;
+
+    msg.id         = rxMsg.canId & ~XL_CAN_EXT_MSG_ID;
+    msg.isExtended = (rxMsg.canId & XL_CAN_EXT_MSG_ID) != 0;
+    msg.dlc        = rxMsg.dlc;
+    msg.isFD       = (rxMsg.msgFlags & XL_CAN_RXMSG_FLAG_EDL) != 0;
+    msg.isBRS      = (rxMsg.msgFlags & XL_CAN_RXMSG_FLAG_BRS) != 0;
+    msg.isRemote   = (rxMsg.msgFlags & XL_CAN_RXMSG_FLAG_RTR) != 0;
+    msg.isError    = (rxMsg.msgFlags & XL_CAN_RXMSG_FLAG_EF) != 0;
+    msg.isTxConfirm = (rxEvent.tag == XL_CAN_EV_TAG_TX_OK);
+    msg.timestamp  = rxEvent.timeStampSync;
+
+    int dataLen = msg.isFD ? dlcToLength(msg.dlc) : qMin((int)msg.dlc, 8);
+    memcpy(msg.data, rxMsg.data, dataLen);
+    return true;
 }
 
 // ============================================================================
-//  Receive
+//  Transmit
 // ============================================================================
 
-CANResult VectorCANDriver::receive(CANMessage& msg, int timeoutMs)
+CANResult VectorCANDriver::transmit(const CANMessage& msg)
 {
-    QMutexLocker locker(&m_mutex);
+    int sent = 0;
+    return transmitBatch(std::span<const CANMessage>(&msg, 1), sent);
+}
+
+CANResult VectorCANDriver::transmitBatch(std::span<const CANMessage> msgs, int& sent)
+{
+    sent = 0;
+    QMutexLocker locker(&m_txMutex);
 
     if (m_portHandle == XL_INVALID_PORTHANDLE)
         return CANResult::Failure("Channel not open");
 
-    if (m_isFD && m_xlCanReceive)
-        return receiveFD(msg, timeoutMs);
+    if (!(m_permissionMask & m_channelMask))
+        return CANResult::Failure("No transmit access (channel opened by another application)");
 
-    return receiveClassic(msg, timeoutMs);
-}
+    if (m_isFD && !m_xl.xlCanTransmitEx)
+        return CANResult::Failure("CAN FD transmit not available (xlCanTransmitEx missing)");
 
-CANResult VectorCANDriver::receiveClassic(CANMessage& msg, int timeoutMs)
-{
-#ifdef _WIN32
-    // Wait for notification event
-    if (m_notifyEvent) {
-        DWORD waitMs = (timeoutMs < 0) ? INFINITE : static_cast<DWORD>(timeoutMs);
-        DWORD waitResult = WaitForSingleObject(m_notifyEvent, waitMs);
-        if (waitResult == WAIT_TIMEOUT)
-            return CANResult::Failure("Receive timeout");
-        if (waitResult != WAIT_OBJECT_0)
-            return CANResult::Failure("Wait error");
+    const int count = static_cast<int>(msgs.size());
+    while (sent < count) {
+        const int chunk = qMin(count - sent, IO_BATCH_SIZE);
+        CANResult result = m_isFD ? transmitFDEvents(msgs.subspan(sent, chunk), sent)
+                                  : transmitClassicEvents(msgs.subspan(sent, chunk), sent);
+        if (!result.success)
+            return result;
     }
-#else
-    Q_UNUSED(timeoutMs);
-#endif
+    return CANResult::Success();
+}
 
-    XLevent xlEvent;
-    unsigned int eventCount = 1;
-    XLstatus status = m_xlReceive(m_portHandle, &eventCount, &xlEvent);
+CANResult VectorCANDriver::transmitClassicEvents(std::span<const CANMessage> msgs, int& sent)
+{
+    XLevent xlEvents[IO_BATCH_SIZE];
+    for (size_t i = 0; i < msgs.size(); ++i)
+        toClassicTxEvent(msgs[i], xlEvents[i]);
 
-    if (status == XL_ERR_QUEUE_IS_EMPTY)
-        return CANResult::Failure("No message available");
+    // On return msgCount holds the number of events actually queued
+    unsigned int msgCount = static_cast<unsigned int>(msgs.size());
+    XLstatus status = m_xl.xlCanTransmit(m_portHandle, m_channelMask, &msgCount, xlEvents);
+    sent += static_cast<int>(msgCount);
 
     if (status != XL_SUCCESS)
-        return makeError("xlReceive", status);
+        return makeError("xlCanTransmit", status);
+    if (msgCount < msgs.size())
+        return CANResult::Failure("Message was not sent (queue full?)");
 
-    // Parse only CAN receive messages
-    if (xlEvent.tag != XL_RECEIVE_MSG)
-        return CANResult::Failure("Non-CAN event received");
+    return CANResult::Success();
+}
 
-    // Skip TX confirmation echoes unless flagged
-    if (xlEvent.tagData.msg.flags & XL_CAN_MSG_FLAG_TX_COMPLETED) {
-        msg.isTxConfirm = true;
-    }
+CANResult VectorCANDriver::transmitFDEvents(std::span<const CANMessage> msgs, int& sent)
+{
+    // An FD (V4) port sends every frame through xlCanTransmitEx; EDL is set per frame
+    XLcanTxEvent txEvents[IO_BATCH_SIZE];
+    for (size_t i = 0; i < msgs.size(); ++i)
+        toFDTxEvent(msgs[i], txEvents[i]);
 
-    msg.id         = xlEvent.tagData.msg.id & ~XL_CAN_EXT_MSG_ID;
-    msg.isExtended = (xlEvent.tagData.msg.id & XL_CAN_EXT_MSG_ID) != 0;
-    msg.dlc        = static_cast<uint8_t>(qMin((unsigned short)xlEvent.tagData.msg.dlc,
-                                                (unsigned short)8));
-    msg.isFD       = false;
-    msg.isBRS      = false;
-    msg.isRemote   = (xlEvent.tagData.msg.flags & XL_CAN_MSG_FLAG_REMOTE_FRAME) != 0;
-    msg.isError    = (xlEvent.tagData.msg.flags & XL_CAN_MSG_FLAG_ERROR_FRAME) != 0;
-    msg.timestamp  = xlEvent.timeStamp;
+    unsigned int msgCntSent = 0;
+    XLstatus status = m_xl.xlCanTransmitEx(m_portHandle, m_channelMask,
+                                         static_cast<unsigned int>(msgs.size()),
+                                         &msgCntSent, txEvents);
+    sent += static_cast<int>(msgCntSent);
 
-    memcpy(msg.data, xlEvent.tagData.msg.data, msg.dlc);
+    if (status != XL_SUCCESS)
+        return makeError("xlCanTransmitEx", status);
+    if (msgCntSent < msgs.size())
+        return CANResult::Failure("Message was not sent (queue full?)");
 
     return CANResult::Success();
 }
 
-CANResult VectorCANDriver::receiveFD(CANMessage& msg, int timeoutMs)
+// ============================================================================
+//  Receive
+// ============================================================================
+
+CANResult VectorCANDriver::receive(CANMessage& msg, int timeoutMs)
+{
+    int received = 0;
+    return receiveBatch(std::span<CANMessage>(&msg, 1), received, timeoutMs);
+}
+
+CANResult VectorCANDriver::receiveBatch(std::span<CANMessage> msgs, int& received, int timeoutMs)
 {
+    received = 0;
+
+    // Only the RX lock is held while waiting — transmit stays available
+    QMutexLocker locker(&m_rxMutex);
+
+    if (m_portHandle == XL_INVALID_PORTHANDLE)
+        return CANResult::Failure("Channel not open");
+    if (msgs.empty())
+        return CANResult::Success();
+
+    // The notification event only signals that the queue became non-empty,
+    // so read what is already queued before waiting on it.
+    CANResult result = readEvents(msgs, received);
+    if (!result.success || received > 0)
+        return result;
+
+    if (timeoutMs == 0)
+        return CANResult::Failure("Receive timeout");
+
 #ifdef _WIN32
-    // Wait for notification event
     if (m_notifyEvent) {
         DWORD waitMs = (timeoutMs < 0) ? INFINITE : static_cast<DWORD>(timeoutMs);
         DWORD waitResult = WaitForSingleObject(m_notifyEvent, waitMs);
@@ -681,115 +568,152 @@ CANResult VectorCANDriver::receiveFD(CANMessage& msg, int timeoutMs)
         if (waitResult != WAIT_OBJECT_0)
             return CANResult::Failure("Wait error");
     }
-#else
-    Q_UNUSED(timeoutMs);
 #endif
 
-    XLcanRxEvent rxEvent;
-    memset(&rxEvent, 0, sizeof(rxEvent));
-    XLstatus status = m_xlCanReceive(m_portHandle, &rxEvent);
-
-    if (status == XL_ERR_QUEUE_IS_EMPTY)
-        return CANResult::Failure("No message available");
-
-    if (status != XL_SUCCESS)
-        return makeError("xlCanReceive", status);
-
-    // Handle different event tags
-    switch (rxEvent.tag) {
-    case XL_CAN_EV_TAG_RX_OK:
-    case XL_CAN_EV_TAG_TX_OK:
-    {
-        const auto& rxMsg = rxEvent.tagData.canRxOkMsg;
-
-        msg.id         = rxMsg.canId & ~XL_CAN_EXT_MSG_ID;
-        msg.isExtended = (rxMsg.canId & XL_CAN_EXT_MSG_ID) != 0;
-        msg.dlc        = rxMsg.dlc;
-        msg.isFD       = (rxMsg.msgFlags & XL_CAN_RXMSG_FLAG_EDL) != 0;
-        msg.isBRS      = (rxMsg.msgFlags & XL_CAN_RXMSG_FLAG_BRS) != 0;
-        msg.isRemote   = (rxMsg.msgFlags & XL_CAN_RXMSG_FLAG_RTR) != 0;
-        msg.isError    = (rxMsg.msgFlags & XL_CAN_RXMSG_FLAG_EF) != 0;
-        msg.isTxConfirm = (rxEvent.tag == XL_CAN_EV_TAG_TX_OK);
-        msg.timestamp  = rxEvent.timeStampSync;
-
-        int dataLen = msg.isFD ? dlcToLength(msg.dlc) : qMin((int)msg.dlc, 8);
-        memcpy(msg.data, rxMsg.data, dataLen);
+    result = readEvents(msgs, received);
+    if (result.success && received == 0)
+        return CANResult::Failure("Receive timeout");
+    return result;
+}
 
+CANResult VectorCANDriver::readEvents(std::span<CANMessage> msgs, int& received)
+{
+    const int capacity = static_cast<int>(msgs.size());
+    const std::shared_ptr<const QList<CANIdFilter>> filters = m_acceptanceFilters.load();
+
+    if (m_isFD && m_xl.xlCanReceive) {
+        // The FD API has no multi-event receive; drain one event per call
+        // under the single RX lock and wait taken by receiveBatch().
+        while (received < capacity) {
+            XLcanRxEvent rxEvent;
+            memset(&rxEvent, 0, sizeof(rxEvent));
+            XLstatus status = m_xl.xlCanReceive(m_portHandle, &rxEvent);
+            if (status == XL_ERR_QUEUE_IS_EMPTY)
+                break;
+            if (status != XL_SUCCESS)
+                return received > 0 ? CANResult::Success() : makeError("xlCanReceive", status);
+
+            if (fromFDEvent(rxEvent, msgs[received]) && passesAcceptanceFilters(*filters, msgs[received]))
+                ++received;
+        }
         return CANResult::Success();
     }
 
-    case XL_CAN_EV_TAG_CHIP_STATE:
-        return CANResult::Failure("Chip state event (not a message)");
-
-    case XL_CAN_EV_TAG_TX_ERROR:
-    case XL_CAN_EV_TAG_RX_ERROR:
-        return CANResult::Failure("CAN error event received");
-
-    default:
-        return CANResult::Failure(QString("Unknown FD event tag: 0x%1")
-                                      .arg(rxEvent.tag, 4, 16, QChar('0')));
+    XLevent xlEvents[IO_BATCH_SIZE];
+    while (received < capacity) {
+        unsigned int eventCount = static_cast<unsigned int>(qMin(capacity - received, IO_BATCH_SIZE));
+        XLstatus status = m_xl.xlReceive(m_portHandle, &eventCount, xlEvents);
+        if (status == XL_ERR_QUEUE_IS_EMPTY || eventCount == 0)
+            break;
+        if (status != XL_SUCCESS)
+            return received > 0 ? CANResult::Success() : makeError("xlReceive", status);
+
+        // Non-CAN events (chip state, timer, ...) are skipped
+        for (unsigned int i = 0; i < eventCount; ++i) {
+            if (fromClassicEvent(xlEvents[i], msgs[received])
+                && passesAcceptanceFilters(*filters, msgs[received]))
+                ++received;
+        }
     }
+    return CANResult::Success();
 }
 
 // ============================================================================
-//  Async Receive Thread
+//  Flush
 // ============================================================================
 
-void VectorCANDriver::startAsyncReceive()
+CANResult VectorCANDriver::flushReceiveQueue()
 {
-    if (m_asyncRunning.load())
-        return;
+    QMutexLocker locker(&m_rxMutex);
 
-    if (!isOpen()) {
-        qWarning() << "[VectorCAN] Cannot start async receive \u2014 channel not open";
-        return;
-    }
-
-    m_asyncRunning = true;
-    m_rxThread = QThread::create([this]() {
-        qDebug() << "[VectorCAN] Async receive thread started";
-        while (m_asyncRunning.load()) {
-            CANMessage msg;
-            CANResult result = receive(msg, 100);  // 100ms poll
-            if (result.success && !msg.isError) {
-                emit messageReceived(msg);
-            }
-            // On timeout or empty queue, just loop
-        }
-        qDebug() << "[VectorCAN] Async receive thread stopped";
-    });
-    m_rxThread->setObjectName(QStringLiteral("VectorCAN_RxThread"));
-    m_rxThread->start();
-}
+    if (m_portHandle == XL_INVALID_PORTHANDLE)
+        return CANResult::Failure("Channel not open");
 
-void VectorCANDriver::stopAsyncReceive()
-{
-    if (!m_asyncRunning.load())
-        return;
+    XLstatus status = m_xl.xlFlushReceiveQueue(m_portHandle);
+    if (status != XL_SUCCESS)
+        return makeError("xlFlushReceiveQueue", status);
 
-    m_asyncRunning = false;
-    if (m_rxThread) {
-        m_rxThread->wait(3000);
-        delete m_rxThread;
-        m_rxThread = nullptr;
-    }
+    return CANResult::Success();
 }
 
 // ============================================================================
-//  Flush
+//  Acceptance Filters
 // ============================================================================
 
-CANResult VectorCANDriver::flushReceiveQueue()
+CANResult VectorCANDriver::setAcceptanceFilters(const QList<CANIdFilter>& filters)
 {
-    QMutexLocker locker(&m_mutex);
+    // The port only changes with all locks held; the RX path keeps reading
+    QMutexLocker locker(&m_txMutex);
 
     if (m_portHandle == XL_INVALID_PORTHANDLE)
         return CANResult::Failure("Channel not open");
 
-    XLstatus status = m_xlFlushReceiveQueue(m_portHandle);
+    // Without the hardware filter every frame still crosses the driver
+    // queue, but receive() returns the same frames
+    CANResult result = CANResult::Failure("xlCanSetChannelAcceptance not available");
+    if (m_xl.xlCanSetChannelAcceptance && m_xl.xlCanResetAcceptance) {
+        result = applyHardwareAcceptance(filters, false);
+        if (result.success)
+            result = applyHardwareAcceptance(filters, true);
+    }
+    if (!result.success)
+        qWarning() << "[VectorCAN]" << result.errorMessage << "— filtering in software only";
+
+    m_acceptanceFilters.store(std::make_shared<const QList<CANIdFilter>>(filters));
+    return CANResult::Success();
+}
+
+CANResult VectorCANDriver::applyHardwareAcceptance(const QList<CANIdFilter>& filters, bool extended)
+{
+    const unsigned int idRange = extended ? XL_CAN_EXT : XL_CAN_STD;
+    const uint32_t idBits = extended ? 0x1FFFFFFF : 0x7FF;
+
+    XLstatus status = m_xl.xlCanResetAcceptance(m_portHandle, m_channelMask, idRange);
     if (status != XL_SUCCESS)
-        return makeError("xlFlushReceiveQueue", status);
+        return CANResult::Failure("xlCanResetAcceptance failed: " + xlStatusToString(status));
+    if (filters.isEmpty())
+        return CANResult::Success();
+
+    // Filters that can match a frame of this format at all
+    QList<CANIdFilter> relevant;
+    for (const CANIdFilter& filter : filters) {
+        if (!filter.anyFormat && filter.extended != extended)
+            continue;
+        if (filter.id & filter.mask & ~idBits)
+            continue;
+        relevant.append(filter);
+    }
 
+    // Several 11-bit filters that are each a contiguous ID range are exact as
+    // acceptance ranges; anything else becomes the narrowest common code/mask
+    bool useRanges = !extended && relevant.size() > 1 && m_xl.xlCanAddAcceptanceRange;
+    for (const CANIdFilter& filter : relevant) {
+        const uint32_t freeBits = ~filter.mask & idBits;
+        useRanges = useRanges && (freeBits & (freeBits + 1)) == 0;
+    }
+
+    // mask: 1 = relevant bit; code == mask == all ones closes the filter
+    uint32_t code = extended ? 0xFFFFFFFF : 0xFFFF;
+    uint32_t mask = code;
+    if (!relevant.isEmpty() && !useRanges) {
+        mask = idBits;
+        for (const CANIdFilter& filter : relevant)
+            mask &= filter.mask & ~(filter.id ^ relevant.first().id);
+        code = relevant.first().id & mask;
+    }
+
+    status = m_xl.xlCanSetChannelAcceptance(m_portHandle, m_channelMask, code, mask, idRange);
+    if (status != XL_SUCCESS)
+        return CANResult::Failure("xlCanSetChannelAcceptance failed: " + xlStatusToString(status));
+
+    if (useRanges) {
+        for (const CANIdFilter& filter : relevant) {
+            const uint32_t first = filter.id & filter.mask & idBits;
+            status = m_xl.xlCanAddAcceptanceRange(m_portHandle, m_channelMask, first, first | (~filter.mask & idBits));
+            if (status != XL_SUCCESS)
+                return CANResult::Failure("xlCanAddAcceptanceRange failed: " + xlStatusToString(status));
+        }
+    }
     return CANResult::Success();
 }
 
@@ -799,41 +723,21 @@ CANResult VectorCANDriver::flushReceiveQueue()
 
 QString VectorCANDriver::lastError() const
 {
-    QMutexLocker locker(&m_mutex);
+    QMutexLocker locker(&m_errorMutex);
     return m_lastError;
 }
 
 QString VectorCANDriver::xlStatusToString(XLstatus status) const
 {
-    if (m_xlGetErrorString) {
-        const char* str = m_xlGetErrorString(status);
-        if (str)
-            return QString::fromLatin1(str);
-    }
-
-    // Fallback: numeric code
-    switch (status) {
-    case XL_SUCCESS:              return QStringLiteral("XL_SUCCESS");
-    case XL_ERR_QUEUE_IS_EMPTY:   return QStringLiteral("XL_ERR_QUEUE_IS_EMPTY");
-    case XL_ERR_QUEUE_IS_FULL:    return QStringLiteral("XL_ERR_QUEUE_IS_FULL");
-    case XL_ERR_TX_NOT_POSSIBLE:  return QStringLiteral("XL_ERR_TX_NOT_POSSIBLE");
-    case XL_ERR_NO_LICENSE:       return QStringLiteral("XL_ERR_NO_LICENSE");
-    case XL_ERR_WRONG_PARAMETER:  return QStringLiteral("XL_ERR_WRONG_PARAMETER");
-    case XL_ERR_INVALID_CHAN_INDEX:return QStringLiteral("XL_ERR_INVALID_CHAN_INDEX");
-    case XL_ERR_INVALID_ACCESS:   return QStringLiteral("XL_ERR_INVALID_ACCESS");
-    case XL_ERR_PORT_IS_OFFLINE:  return QStringLiteral("XL_ERR_PORT_IS_OFFLINE");
-    case XL_ERR_HW_NOT_PRESENT:   return QStringLiteral("XL_ERR_HW_NOT_PRESENT");
-    case XL_ERR_CANNOT_OPEN_DRIVER: return QStringLiteral("XL_ERR_CANNOT_OPEN_DRIVER");
-    case XL_ERR_WRONG_BUS_TYPE:   return QStringLiteral("XL_ERR_WRONG_BUS_TYPE");
-    case XL_ERR_DLL_NOT_FOUND:    return QStringLiteral("XL_ERR_DLL_NOT_FOUND");
-    default:
-        return QString("XL_ERR_%1 (0x%2)").arg(status).arg((unsigned short)status, 4, 16, QChar('0'));
-    }
+    return VectorXLLibrary::statusToString(m_xl, status);
 }
 
 void VectorCANDriver::setError(const QString& msg)
 {
-    m_lastError = msg;
+    {
+        QMutexLocker locker(&m_errorMutex);
+        m_lastError = msg;
+    }
     qWarning() << "[VectorCAN]" << msg;
 }
 
@@ -0,0 +1,260 @@
+/**
+ * @file VectorXLLibrary.cpp
+ * @brief Shared Vector XL Library context — implementation.
+ */
+
+#include "VectorXLLibrary.h"
+
+#include <QDebug>
+#include <QCoreApplication>
+#include <cstring>
+
+namespace CANManager {
+
+// ============================================================================
+//  Singleton
+// ============================================================================
+
+VectorXLLibrary& VectorXLLibrary::instance()
+{
+    static VectorXLLibrary inst;
+    return inst;
+}
+
+VectorXLLibrary::~VectorXLLibrary()
+{
+    // Drivers release their reference on shutdown; this only covers leaks
+    QMutexLocker locker(&m_mutex);
+    if (m_refCount > 0 && m_fn.xlCloseDriver)
+        m_fn.xlCloseDriver();
+    unloadLibrary();
+}
+
+// ============================================================================
+//  Reference Counting
+// ============================================================================
+
+bool VectorXLLibrary::acquire(Functions& functions, QString& error)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_refCount == 0) {
+        if (!loadLibrary(error))
+            return false;
+
+        if (!resolveFunctions()) {
+            error = QStringLiteral("Vector XL Library is missing required functions");
+            unloadLibrary();
+            return false;
+        }
+
+        XLstatus status = m_fn.xlOpenDriver();
+        if (status != XL_SUCCESS) {
+            error = QString("xlOpenDriver failed: %1").arg(statusToString(m_fn, status));
+            unloadLibrary();
+            return false;
+        }
+    }
+
+    const bool opened = (++m_refCount == 1);
+    functions = m_fn;
+
+    locker.unlock();
+    if (opened)
+        qDebug() << "[VectorCAN] Driver initialized. DLL version:" << dllVersion();
+    return true;
+}
+
+void VectorXLLibrary::release()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_refCount == 0 || --m_refCount > 0)
+        return;
+
+    if (m_fn.xlCloseDriver) {
+        m_fn.xlCloseDriver();
+        qDebug() << "[VectorCAN] Driver closed";
+    }
+    unloadLibrary();
+}
+
+// ============================================================================
+//  DLL Loading
+// ============================================================================
+
+bool VectorXLLibrary::loadLibrary(QString& error)
+{
+    if (m_xlLib.isLoaded())
+        return true;
+
+    // Try 64-bit DLL first (common on modern systems), then 32-bit
+    static const QStringList dllNames = {
+        QStringLiteral("vxlapi64"),
+        QStringLiteral("vxlapi")
+    };
+
+    for (const auto& name : dllNames) {
+        m_xlLib.setFileName(name);
+        if (m_xlLib.load()) {
+            qDebug() << "[VectorCAN] Loaded" << m_xlLib.fileName();
+            return true;
+        }
+    }
+
+    // Try from third_party folder
+    QString appDir = QCoreApplication::applicationDirPath();
+    for (const auto& name : dllNames) {
+        m_xlLib.setFileName(appDir + "/../../third_party/vector_xl/bin/" + name);
+        if (m_xlLib.load()) {
+            qDebug() << "[VectorCAN] Loaded from third_party:" << m_xlLib.fileName();
+            return true;
+        }
+    }
+
+    error = QString("Failed to load Vector XL Library: %1").arg(m_xlLib.errorString());
+    return false;
+}
+
+void VectorXLLibrary::unloadLibrary()
+{
+    if (m_xlLib.isLoaded()) {
+        m_xlLib.unload();
+        qDebug() << "[VectorCAN] Library unloaded";
+    }
+
+    // Clear all function pointers
+    m_fn = Functions{};
+}
+
+bool VectorXLLibrary::resolveFunctions()
+{
+    if (!m_xlLib.isLoaded())
+        return false;
+
+    // Helper macro for resolving functions
+    #define RESOLVE_XL(funcName, typeName) \
+        m_fn.funcName = reinterpret_cast<typeName>(m_xlLib.resolve(#funcName)); \
+        if (!m_fn.funcName) { \
+            qWarning() << "[VectorCAN] Failed to resolve:" << #funcName; \
+            return false; \
+        }
+
+    RESOLVE_XL(xlOpenDriver,            XLOPENDRIVER)
+    RESOLVE_XL(xlCloseDriver,           XLCLOSEDRIVER)
+    RESOLVE_XL(xlGetDriverConfig,       XLGETDRIVERCONFIG)
+    RESOLVE_XL(xlOpenPort,              XLOPENPORT)
+    RESOLVE_XL(xlClosePort,             XLCLOSEPORT)
+    RESOLVE_XL(xlActivateChannel,       XLACTIVATECHANNEL)
+    RESOLVE_XL(xlDeactivateChannel,     XLDEACTIVATECHANNEL)
+    RESOLVE_XL(xlCanSetChannelBitrate,  XLCANSETCHANNELBITRATE)
+    RESOLVE_XL(xlCanSetChannelOutput,   XLCANSETCHANNELOUTPUT)
+    RESOLVE_XL(xlSetNotification,       XLSETNOTIFICATION)
+    RESOLVE_XL(xlFlushReceiveQueue,     XLFLUSHRECEIVEQUEUE)
+    RESOLVE_XL(xlCanTransmit,           XLCANTRANSMIT)
+    RESOLVE_XL(xlReceive,               XLRECEIVE)
+
+    // Optional functions (may not exist in older DLL versions)
+    #define RESOLVE_XL_OPTIONAL(funcName, typeName) \
+        m_fn.funcName = reinterpret_cast<typeName>(m_xlLib.resolve(#funcName)); \
+        if (!m_fn.funcName) { \
+            qDebug() << "[VectorCAN] Optional function not found:" << #funcName; \
+        }
+
+    RESOLVE_XL_OPTIONAL(xlGetApplConfig,          XLGETAPPLCONFIG)
+    RESOLVE_XL_OPTIONAL(xlSetApplConfig,           XLSETAPPLCONFIG)
+    RESOLVE_XL_OPTIONAL(xlGetChannelIndex,         XLGETCHANNELINDEX)
+    RESOLVE_XL_OPTIONAL(xlGetChannelMask,          XLGETCHANNELMASK)
+    RESOLVE_XL_OPTIONAL(xlCanSetChannelMode,       XLCANSETCHANNELMODE)
+    RESOLVE_XL_OPTIONAL(xlCanSetChannelAcceptance, XLCANSETCHANNELACCEPTANCE)
+    RESOLVE_XL_OPTIONAL(xlCanAddAcceptanceRange,   XLCANADDACCEPTANCERANGE)
+    RESOLVE_XL_OPTIONAL(xlCanResetAcceptance,      XLCANRESETACCEPTANCE)
+    RESOLVE_XL_OPTIONAL(xlCanFdSetConfiguration,   XLCANFDSETCONFIGURATION)
+    RESOLVE_XL_OPTIONAL(xlCanTransmitEx,           XLCANTRANSMITEX)
+    RESOLVE_XL_OPTIONAL(xlCanReceive,              XLCANRECEIVE)
+    RESOLVE_XL_OPTIONAL(xlGetErrorString,          XLGETERRORSTRING)
+    RESOLVE_XL_OPTIONAL(xlGetEventString,          XLGETEVENTSTRING)
+
+    #undef RESOLVE_XL
+    #undef RESOLVE_XL_OPTIONAL
+
+    return true;
+}
+
+// ============================================================================
+//  Queries
+// ============================================================================
+
+bool VectorXLLibrary::isAvailable() const
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_availableCached >= 0)
+        return m_availableCached == 1;
+
+    if (m_xlLib.isLoaded()) {
+        m_availableCached = 1;
+        return true;
+    }
+
+    // Quick check: try loading the library without keeping it
+    QLibrary testLib;
+    for (const auto& name : {QStringLiteral("vxlapi64"), QStringLiteral("vxlapi")}) {
+        testLib.setFileName(name);
+        if (testLib.load()) {
+            testLib.unload();
+            m_availableCached = 1;
+            return true;
+        }
+    }
+    m_availableCached = 0;
+    return false;
+}
+
+QString VectorXLLibrary::dllVersion() const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_fn.xlGetDriverConfig)
+        return {};
+
+    XLdriverConfig drvConfig;
+    memset(&drvConfig, 0, sizeof(drvConfig));
+    XLstatus status = m_fn.xlGetDriverConfig(&drvConfig);
+    if (status != XL_SUCCESS)
+        return {};
+
+    unsigned int ver = drvConfig.dllVersion;
+    return QString("%1.%2.%3")
+        .arg((ver >> 24) & 0xFF)
+        .arg((ver >> 16) & 0xFF)
+        .arg(ver & 0xFFFF);
+}
+
+QString VectorXLLibrary::statusToString(const Functions& functions, XLstatus status)
+{
+    if (functions.xlGetErrorString) {
+        const char* str = functions.xlGetErrorString(status);
+        if (str)
+            return QString::fromLatin1(str);
+    }
+
+    // Fallback: numeric code
+    switch (status) {
+    case XL_SUCCESS:              return QStringLiteral("XL_SUCCESS");
+    case XL_ERR_QUEUE_IS_EMPTY:   return QStringLiteral("XL_ERR_QUEUE_IS_EMPTY");
+    case XL_ERR_QUEUE_IS_FULL:    return QStringLiteral("XL_ERR_QUEUE_IS_FULL");
+    case XL_ERR_TX_NOT_POSSIBLE:  return QStringLiteral("XL_ERR_TX_NOT_POSSIBLE");
+    case XL_ERR_NO_LICENSE:       return QStringLiteral("XL_ERR_NO_LICENSE");
+    case XL_ERR_WRONG_PARAMETER:  return QStringLiteral("XL_ERR_WRONG_PARAMETER");
+    case XL_ERR_INVALID_CHAN_INDEX:return QStringLiteral("XL_ERR_INVALID_CHAN_INDEX");
+    case XL_ERR_INVALID_ACCESS:   return QStringLiteral("XL_ERR_INVALID_ACCESS");
+    case XL_ERR_PORT_IS_OFFLINE:  return QStringLiteral("XL_ERR_PORT_IS_OFFLINE");
+    case XL_ERR_HW_NOT_PRESENT:   return QStringLiteral("XL_ERR_HW_NOT_PRESENT");
+    case XL_ERR_CANNOT_OPEN_DRIVER: return QStringLiteral("XL_ERR_CANNOT_OPEN_DRIVER");
+    case XL_ERR_WRONG_BUS_TYPE:   return QStringLiteral("XL_ERR_WRONG_BUS_TYPE");
+    case XL_ERR_DLL_NOT_FOUND:    return QStringLiteral("XL_ERR_DLL_NOT_FOUND");
+    default:
+        return QString("XL_ERR_%1 (0x%2)").arg(status).arg((unsigned short)status, 4, 16, QChar('0'));
+    }
+}
+
+} // namespace CANManager
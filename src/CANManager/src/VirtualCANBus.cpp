@@ -0,0 +1,501 @@
+/**
+ * @file VirtualCANBus.cpp
+ * @brief In-process simulated CAN bus — arbitration, timing, error injection.
+ */
+
+#include "VirtualCANBus.h"
+
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QMap>
+
+#include <chrono>
+
+namespace CANManager {
+
+// ============================================================================
+//  Bus registry
+// ============================================================================
+
+namespace {
+
+struct BusRegistry
+{
+    struct Entry {
+        std::shared_ptr<VirtualCANBus> bus;
+        int channels = 0;       ///< acquire() calls not yet released
+    };
+
+    QMutex mutex;
+    QMap<QString, Entry> buses;
+
+    /// Called with mutex held
+    Entry& entry(const QString& name)
+    {
+        auto it = buses.find(name);
+        if (it == buses.end())
+            it = buses.insert(name, Entry{std::make_shared<VirtualCANBus>(name), 0});
+        return it.value();
+    }
+};
+
+BusRegistry& registry()
+{
+    static BusRegistry reg;
+    return reg;
+}
+
+/// TX error counter limit (ISO 11898-1): above this the node goes bus-off
+constexpr int BUS_OFF_LIMIT = 255;
+
+} // namespace
+
+std::shared_ptr<VirtualCANBus> VirtualCANBus::bus(const QString& name)
+{
+    auto& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    return reg.entry(name).bus;
+}
+
+std::shared_ptr<VirtualCANBus> VirtualCANBus::acquire(const QString& name)
+{
+    auto& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    auto& entry = reg.entry(name);
+    ++entry.channels;
+    return entry.bus;
+}
+
+void VirtualCANBus::release(const QString& name)
+{
+    auto& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    auto it = reg.buses.find(name);
+    if (it == reg.buses.end())
+        return;
+    if (--it.value().channels <= 0) {
+        reg.buses.erase(it);
+        qDebug() << "[VirtualCAN] Bus released:" << name;
+    }
+}
+
+QStringList VirtualCANBus::busNames()
+{
+    auto& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    return reg.buses.keys();
+}
+
+// ============================================================================
+//  Frame timing
+// ============================================================================
+
+uint64_t VirtualCANBus::frameDurationNs(const CANMessage& msg, int bitrate, int dataBitrate)
+{
+    return CANManager::frameDurationNs(msg, bitrate, dataBitrate);
+}
+
+uint64_t VirtualCANBus::arbitrationKey(const CANMessage& msg)
+{
+    // Bit layout follows the order of the arbitration field on the wire;
+    // lower value = more dominant bits = wins arbitration.
+    const uint64_t rtr = msg.isRemote ? 1 : 0;
+    if (!msg.isExtended)
+        return (static_cast<uint64_t>(msg.id & 0x7FF) << 21) | (rtr << 20);
+
+    const uint64_t base = (msg.id >> 18) & 0x7FF;
+    const uint64_t ext  = msg.id & 0x3FFFF;
+    return (base << 21) | (1ULL << 20) /* SRR */ | (1ULL << 19) /* IDE */ | (ext << 1) | rtr;
+}
+
+// ============================================================================
+//  Node
+// ============================================================================
+
+bool VirtualCANBus::Node::waitForFrame(int timeoutMs)
+{
+    if (!rxQueue.empty())
+        return true;
+
+    QMutexLocker locker(&waitMutex);
+    waiting.store(true);
+    // Pairs with the fence in deliver(): either we see the frame, or the
+    // producer sees waiting == true and signals under waitMutex.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    QDeadlineTimer deadline = (timeoutMs < 0) ? QDeadlineTimer(QDeadlineTimer::Forever)
+                                              : QDeadlineTimer(timeoutMs);
+    while (rxQueue.empty() && !wakeRequested.exchange(false)) {
+        if (!waitCond.wait(&waitMutex, deadline))
+            break;
+    }
+    waiting.store(false);
+
+    return !rxQueue.empty();
+}
+
+void VirtualCANBus::Node::wake()
+{
+    wakeRequested.store(true);
+    QMutexLocker locker(&waitMutex);
+    waitCond.wakeAll();
+}
+
+void VirtualCANBus::Node::deliver(const CANMessage& msg)
+{
+    if (!passesAcceptanceFilters(acceptanceFilters, msg))
+        return;
+
+    if (!rxQueue.push(msg)) {
+        rxOverruns.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting.load()) {
+        QMutexLocker locker(&waitMutex);
+        waitCond.wakeOne();
+    }
+}
+
+// ============================================================================
+//  Constructor / Destructor
+// ============================================================================
+
+VirtualCANBus::VirtualCANBus(const QString& name)
+    : m_name(name)
+    , m_rng(1)
+{
+    m_epochNs = static_cast<qint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+VirtualCANBus::~VirtualCANBus()
+{
+    QMutexLocker threadLocker(&m_threadMutex);
+    stopThread();
+}
+
+uint64_t VirtualCANBus::wallClockNs() const
+{
+    const qint64 now = static_cast<qint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    return static_cast<uint64_t>(now - m_epochNs);
+}
+
+// ============================================================================
+//  Node attachment
+// ============================================================================
+
+CANResult VirtualCANBus::attach(const CANBusConfig& config, std::shared_ptr<Node>& node)
+{
+    QMutexLocker threadLocker(&m_threadMutex);
+    QMutexLocker locker(&m_mutex);
+
+    if (config.bitrate <= 0)
+        return CANResult::Failure(QString("Invalid bitrate %1").arg(config.bitrate));
+
+    if (m_nodes.empty()) {
+        m_bitrate     = config.bitrate;
+        m_dataBitrate = config.fdEnabled ? config.fdDataBitrate : config.bitrate;
+    } else if (config.bitrate != m_bitrate ||
+               (config.fdEnabled && config.fdDataBitrate != m_dataBitrate)) {
+        return CANResult::Failure(
+            QString("Bit rate mismatch on virtual bus '%1' (bus: %2/%3, requested: %4/%5)")
+                .arg(m_name).arg(m_bitrate).arg(m_dataBitrate)
+                .arg(config.bitrate).arg(config.fdDataBitrate));
+    }
+
+    node = std::make_shared<Node>();
+    node->fdEnabled = config.fdEnabled;
+    m_nodes.push_back(node);
+
+    if (!m_thread)
+        startThread();
+
+    qDebug() << "[VirtualCAN] Node attached to" << m_name
+             << "nodes:" << m_nodes.size();
+    return CANResult::Success();
+}
+
+void VirtualCANBus::detach(const std::shared_ptr<Node>& node)
+{
+    QMutexLocker threadLocker(&m_threadMutex);
+    QMutexLocker locker(&m_mutex);
+
+    auto it = std::find(m_nodes.begin(), m_nodes.end(), node);
+    if (it == m_nodes.end())
+        return;
+
+    (*it)->txFifo.clear();
+    m_nodes.erase(it);
+
+    qDebug() << "[VirtualCAN] Node detached from" << m_name
+             << "nodes:" << m_nodes.size();
+
+    // No node left to deliver to: park the bus until the next attach()
+    if (m_nodes.empty()) {
+        locker.unlock();
+        stopThread();
+    }
+}
+
+int VirtualCANBus::nodeCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_nodes.size());
+}
+
+CANResult VirtualCANBus::submit(const std::shared_ptr<Node>& node, const CANMessage& msg)
+{
+    int accepted = 0;
+    return submit(node, &msg, 1, accepted);
+}
+
+CANResult VirtualCANBus::submit(const std::shared_ptr<Node>& node, const CANMessage* msgs,
+                                int count, int& accepted)
+{
+    accepted = 0;
+    QMutexLocker locker(&m_mutex);
+
+    if (node->busOff)
+        return CANResult::Failure("Node is bus-off (TX error counter exceeded 255)");
+
+    for (; accepted < count; ++accepted) {
+        if (static_cast<int>(node->txFifo.size()) >= TX_QUEUE_CAPACITY)
+            break;
+
+        Node::PendingFrame pending;
+        pending.msg = msgs[accepted];
+        pending.msg.isTxConfirm = false;
+        pending.msg.isError = false;
+        pending.seq = m_nextSeq++;
+        node->txFifo.push_back(pending);
+    }
+
+    if (accepted > 0)
+        m_cond.wakeAll();
+    if (accepted < count)
+        return CANResult::Failure("Transmit queue full");
+    return CANResult::Success();
+}
+
+void VirtualCANBus::setAcceptanceFilters(const std::shared_ptr<Node>& node,
+                                         const QList<CANIdFilter>& filters)
+{
+    QMutexLocker locker(&m_mutex);
+    node->acceptanceFilters = filters;
+}
+
+// ============================================================================
+//  Configuration
+// ============================================================================
+
+void VirtualCANBus::setTiming(Timing timing)
+{
+    QMutexLocker locker(&m_mutex);
+    m_timing = timing;
+    if (timing == Timing::RealTime)
+        m_busTimeNs = qMax(m_busTimeNs, wallClockNs());
+    m_cond.wakeAll();
+}
+
+VirtualCANBus::Timing VirtualCANBus::timing() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_timing;
+}
+
+void VirtualCANBus::setErrorRate(double probability, uint32_t seed)
+{
+    QMutexLocker locker(&m_mutex);
+    m_errorRate = qBound(0.0, probability, 1.0);
+    m_rng.seed(seed);
+}
+
+void VirtualCANBus::injectErrors(int count)
+{
+    QMutexLocker locker(&m_mutex);
+    m_forcedErrors += qMax(0, count);
+}
+
+void VirtualCANBus::pause()
+{
+    QMutexLocker locker(&m_mutex);
+    m_paused = true;
+}
+
+void VirtualCANBus::resume()
+{
+    QMutexLocker locker(&m_mutex);
+    m_paused = false;
+    m_cond.wakeAll();
+}
+
+uint64_t VirtualCANBus::busTimeNs() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_busTimeNs;
+}
+
+bool VirtualCANBus::isRunning() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_running;
+}
+
+// ============================================================================
+//  Bus thread
+// ============================================================================
+
+void VirtualCANBus::startThread()
+{
+    // Called with m_threadMutex and m_mutex held
+    m_running = true;
+    m_thread = QThread::create([this]() { busThreadMain(); });
+    m_thread->setObjectName(QStringLiteral("VirtualCAN_Bus_%1").arg(m_name));
+    m_thread->start();
+}
+
+void VirtualCANBus::stopThread()
+{
+    // Called with m_threadMutex held, so attach() cannot start a new thread
+    // before this one has exited
+    {
+        QMutexLocker locker(&m_mutex);
+        m_running = false;
+        m_cond.wakeAll();
+    }
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+}
+
+bool VirtualCANBus::hasPendingFrames() const
+{
+    for (const auto& node : m_nodes) {
+        if (!node->txFifo.empty())
+            return true;
+    }
+    return false;
+}
+
+std::shared_ptr<VirtualCANBus::Node> VirtualCANBus::arbitrate() const
+{
+    // Each node competes with the frame at the head of its TX FIFO.
+    // Identical arbitration fields are resolved in submission order.
+    std::shared_ptr<Node> winner;
+    uint64_t bestKey = 0;
+    uint64_t bestSeq = 0;
+
+    for (const auto& node : m_nodes) {
+        if (node->txFifo.empty())
+            continue;
+        const auto& head = node->txFifo.front();
+        const uint64_t key = arbitrationKey(head.msg);
+        if (!winner || key < bestKey || (key == bestKey && head.seq < bestSeq)) {
+            winner  = node;
+            bestKey = key;
+            bestSeq = head.seq;
+        }
+    }
+    return winner;
+}
+
+void VirtualCANBus::busThreadMain()
+{
+    QMutexLocker locker(&m_mutex);
+
+    while (m_running) {
+        if (m_paused || !hasPendingFrames()) {
+            m_cond.wait(&m_mutex);
+            continue;
+        }
+
+        auto winner = arbitrate();
+        const Node::PendingFrame pending = winner->txFifo.front();
+        const uint64_t duration = frameDurationNs(pending.msg, m_bitrate, m_dataBitrate);
+
+        uint64_t start = m_busTimeNs;
+        if (m_timing == Timing::RealTime)
+            start = qMax(start, wallClockNs());
+
+        bool destroyed = false;
+        if (m_forcedErrors > 0) {
+            --m_forcedErrors;
+            destroyed = true;
+        } else if (m_errorRate > 0.0) {
+            destroyed = std::uniform_real_distribution<double>(0.0, 1.0)(m_rng) < m_errorRate;
+        }
+
+        // A destroyed frame is aborted part-way and followed by an error frame
+        uint64_t end = start + duration;
+        if (destroyed) {
+            end = start + duration / 2
+                + static_cast<uint64_t>(ERROR_FRAME_BITS) * 1000000000ULL
+                      / static_cast<uint64_t>(m_bitrate);
+        }
+
+        if (m_timing == Timing::RealTime) {
+            // Hold the bus for the frame duration; the mutex is released while
+            // waiting so nodes can keep queueing frames.
+            while (m_running) {
+                const uint64_t now = wallClockNs();
+                if (now >= end)
+                    break;
+                m_cond.wait(&m_mutex, QDeadlineTimer(std::chrono::nanoseconds(end - now),
+                                                     Qt::PreciseTimer));
+            }
+            if (!m_running)
+                break;
+        }
+
+        m_busTimeNs = end;
+
+        if (destroyed) {
+            m_errorFrames.fetch_add(1, std::memory_order_relaxed);
+
+            CANMessage errorFrame;
+            errorFrame.isError   = true;
+            errorFrame.timestamp = end;
+            for (const auto& node : m_nodes)
+                node->deliver(errorFrame);
+
+            // The frame stays queued for automatic retransmission unless the
+            // transmitter's error counter pushes it bus-off.
+            winner->txErrorCounter += 8;
+            if (winner->txErrorCounter > BUS_OFF_LIMIT && !winner->busOff) {
+                winner->busOff = true;
+                winner->txFifo.clear();
+                qWarning() << "[VirtualCAN] Node went bus-off on" << m_name;
+            }
+            continue;
+        }
+
+        // The winner may have detached or flushed while the frame was on the wire
+        if (!winner->txFifo.empty() && winner->txFifo.front().seq == pending.seq)
+            winner->txFifo.pop_front();
+        winner->txErrorCounter = qMax(0, winner->txErrorCounter - 1);
+
+        m_framesTransmitted.fetch_add(1, std::memory_order_relaxed);
+
+        CANMessage rxMsg = pending.msg;
+        rxMsg.timestamp = end;
+        for (const auto& node : m_nodes) {
+            if (node == winner) {
+                if (node->txConfirmations.load(std::memory_order_relaxed)) {
+                    CANMessage echo = rxMsg;
+                    echo.isTxConfirm = true;
+                    node->deliver(echo);
+                }
+            } else {
+                node->deliver(rxMsg);
+            }
+        }
+    }
+}
+
+} // namespace CANManager
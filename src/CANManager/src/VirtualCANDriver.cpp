@@ -0,0 +1,257 @@
+/**
+ * @file VirtualCANDriver.cpp
+ * @brief In-process virtual CAN driver — full implementation.
+ */
+
+#include "VirtualCANDriver.h"
+
+#include <QDebug>
+
+namespace CANManager {
+
+// ============================================================================
+//  Constructor / Destructor
+// ============================================================================
+
+VirtualCANDriver::VirtualCANDriver(QObject* parent)
+    : ICANDriver(parent)
+{
+}
+
+VirtualCANDriver::~VirtualCANDriver()
+{
+    shutdown();
+}
+
+void VirtualCANDriver::shutdown()
+{
+    closeChannel();
+}
+
+// ============================================================================
+//  Hardware Detection
+// ============================================================================
+
+QList<CANChannelInfo> VirtualCANDriver::detectChannels()
+{
+    QStringList names;
+    for (int i = 0; i < DEFAULT_CHANNEL_COUNT; ++i)
+        names.append(QStringLiteral("vbus%1").arg(i));
+    for (const auto& name : VirtualCANBus::busNames()) {
+        if (!names.contains(name))
+            names.append(name);
+    }
+
+    QList<CANChannelInfo> channels;
+    for (int i = 0; i < names.size(); ++i) {
+        CANChannelInfo info;
+        info.name         = names[i];
+        info.hwTypeName   = QStringLiteral("Virtual");
+        info.hwChannel    = i;
+        info.channelIndex = i;
+        info.supportsFD   = true;
+        channels.append(info);
+    }
+    return channels;
+}
+
+// ============================================================================
+//  Channel Open / Close
+// ============================================================================
+
+CANResult VirtualCANDriver::openChannel(const CANChannelInfo& channel,
+                                         const CANBusConfig& config)
+{
+    QMutexLocker txLocker(&m_txMutex);
+    QMutexLocker rxLocker(&m_rxMutex);
+
+    if (m_node)
+        return CANResult::Failure("A channel is already open — close it first");
+
+    if (channel.name.isEmpty())
+        return CANResult::Failure("Virtual bus name is empty");
+
+    auto bus = VirtualCANBus::acquire(channel.name);
+    std::shared_ptr<VirtualCANBus::Node> node;
+    CANResult result = bus->attach(config, node);
+    if (!result.success) {
+        VirtualCANBus::release(channel.name);
+        setError(result.errorMessage);
+        return result;
+    }
+
+    node->txConfirmations.store(m_txConfirmations);
+    m_bus  = bus;
+    m_node = node;
+
+    qDebug() << "[VirtualCAN] Channel opened:" << channel.name
+             << "bitrate:" << config.bitrate
+             << "FD:" << config.fdEnabled;
+
+    rxLocker.unlock();
+    txLocker.unlock();
+    emit channelOpened();
+
+    return CANResult::Success();
+}
+
+void VirtualCANDriver::closeChannel()
+{
+    QMutexLocker txLocker(&m_txMutex);
+    if (!m_node)
+        return;
+
+    // Release any receive() blocked on the node before taking the RX lock
+    m_node->wake();
+    QMutexLocker rxLocker(&m_rxMutex);
+
+    m_bus->detach(m_node);
+    VirtualCANBus::release(m_bus->name());
+    qDebug() << "[VirtualCAN] Channel closed:" << m_bus->name();
+
+    m_node.reset();
+    m_bus.reset();
+
+    rxLocker.unlock();
+    txLocker.unlock();
+    emit channelClosed();
+}
+
+bool VirtualCANDriver::isOpen() const
+{
+    QMutexLocker locker(&m_txMutex);
+    return m_node != nullptr;
+}
+
+std::shared_ptr<VirtualCANBus> VirtualCANDriver::bus() const
+{
+    QMutexLocker locker(&m_txMutex);
+    return m_bus;
+}
+
+void VirtualCANDriver::setTxConfirmations(bool enabled)
+{
+    QMutexLocker locker(&m_txMutex);
+    m_txConfirmations = enabled;
+    if (m_node)
+        m_node->txConfirmations.store(enabled);
+}
+
+uint64_t VirtualCANDriver::rxOverruns() const
+{
+    QMutexLocker locker(&m_txMutex);
+    return m_node ? m_node->rxOverruns.load() : 0;
+}
+
+// ============================================================================
+//  Transmit / Receive
+// ============================================================================
+
+CANResult VirtualCANDriver::transmit(const CANMessage& msg)
+{
+    QMutexLocker locker(&m_txMutex);
+
+    if (!m_node)
+        return CANResult::Failure("Channel not open");
+
+    if (msg.isFD && !m_node->fdEnabled)
+        return CANResult::Failure("CAN FD frame on a channel opened without FD");
+
+    return m_bus->submit(m_node, msg);
+}
+
+CANResult VirtualCANDriver::receive(CANMessage& msg, int timeoutMs)
+{
+    QMutexLocker locker(&m_rxMutex);
+
+    // m_node only changes with both locks held, so it is stable here
+    if (!m_node)
+        return CANResult::Failure("Channel not open");
+
+    if (m_node->rxQueue.pop(msg))
+        return CANResult::Success();
+
+    if (timeoutMs != 0 && m_node->waitForFrame(timeoutMs) && m_node->rxQueue.pop(msg))
+        return CANResult::Success();
+
+    return CANResult::Failure("Receive timeout");
+}
+
+CANResult VirtualCANDriver::transmitBatch(std::span<const CANMessage> msgs, int& sent)
+{
+    sent = 0;
+    QMutexLocker locker(&m_txMutex);
+
+    if (!m_node)
+        return CANResult::Failure("Channel not open");
+
+    if (!m_node->fdEnabled) {
+        for (const CANMessage& msg : msgs) {
+            if (msg.isFD)
+                return CANResult::Failure("CAN FD frame on a channel opened without FD");
+        }
+    }
+
+    return m_bus->submit(m_node, msgs.data(), static_cast<int>(msgs.size()), sent);
+}
+
+CANResult VirtualCANDriver::receiveBatch(std::span<CANMessage> msgs, int& received,
+                                         int timeoutMs)
+{
+    received = 0;
+    QMutexLocker locker(&m_rxMutex);
+
+    if (!m_node)
+        return CANResult::Failure("Channel not open");
+    if (msgs.empty())
+        return CANResult::Success();
+
+    received = static_cast<int>(m_node->rxQueue.popBatch(msgs.data(), msgs.size()));
+    if (received == 0 && timeoutMs != 0 && m_node->waitForFrame(timeoutMs))
+        received = static_cast<int>(m_node->rxQueue.popBatch(msgs.data(), msgs.size()));
+
+    return received > 0 ? CANResult::Success() : CANResult::Failure("Receive timeout");
+}
+
+CANResult VirtualCANDriver::flushReceiveQueue()
+{
+    QMutexLocker locker(&m_rxMutex);
+
+    if (!m_node)
+        return CANResult::Failure("Channel not open");
+
+    m_node->rxQueue.clear();
+    return CANResult::Success();
+}
+
+CANResult VirtualCANDriver::setAcceptanceFilters(const QList<CANIdFilter>& filters)
+{
+    QMutexLocker locker(&m_txMutex);
+
+    if (!m_node)
+        return CANResult::Failure("Channel not open");
+
+    m_bus->setAcceptanceFilters(m_node, filters);
+    return CANResult::Success();
+}
+
+// ============================================================================
+//  Error Handling
+// ============================================================================
+
+QString VirtualCANDriver::lastError() const
+{
+    QMutexLocker locker(&m_errorMutex);
+    return m_lastError;
+}
+
+void VirtualCANDriver::setError(const QString& msg)
+{
+    {
+        QMutexLocker locker(&m_errorMutex);
+        m_lastError = msg;
+    }
+    qWarning() << "[VirtualCAN]" << msg;
+}
+
+} // namespace CANManager
@@ -0,0 +1,95 @@
+#pragma once
+/**
+ * @file DBCCache.h
+ * @brief Binary images of parsed DBC databases, keyed by the DBC content,
+ *        so unchanged DBC files are not parsed again at every start.
+ *
+ * After a successful parse the whole database — messages, signals with their
+ * compiled plans, comments, value tables — is written as one flat image to
+ * <directory>/<key>.dbcimg, the key being the SHA-1 of the DBC file
+ * content. Loading maps the image, validates it (magic, format version,
+ * key, sizes; every read is bounds-checked) and rebuilds the database and
+ * its ID / name index without touching the DBC text.
+ *
+ * The image holds no pointers: integers are little-endian, strings and
+ * lists length-prefixed, so it can be copied or moved anywhere. Editing the
+ * DBC changes the key; changing the image layout, or what DBCParser or
+ * DBCSignal::compile() produce for the same DBC, must bump FORMAT_VERSION.
+ * An image that is missing or fails validation is a miss: the caller
+ * parses the DBC and stores a fresh image.
+ *
+ * Usage:
+ * @code
+ * DBCCache cache;
+ * const QByteArray key = DBCCache::fileKey(path);
+ * DBCDatabase db;
+ * if (!cache.load(key, db)) {
+ *     db = parser.parseFile(path);
+ *     cache.store(key, db);
+ * }
+ * @endcode
+ */
+
+#include "DBCParser.h"
+
+#include <QByteArray>
+#include <QString>
+
+namespace DBCManager {
+
+//=============================================================================
+// DBCCache — Content-keyed binary database images
+//=============================================================================
+
+class DBCCache
+{
+public:
+    /// Image layout and parser output version: bump it whenever either
+    /// changes, otherwise images written by an older build keep loading
+    static constexpr uint32_t FORMAT_VERSION = 2;
+    static constexpr int      MAX_IMAGES     = 16;  ///< Older images beyond this are removed by store()
+
+    /**
+     * @param directory Image directory (created by store())
+     */
+    explicit DBCCache(const QString& directory = defaultDirectory());
+
+    /**
+     * @brief <user cache location>/dbc
+     */
+    static QString defaultDirectory();
+
+    QString directory() const { return m_directory; }
+
+    /**
+     * @brief Key of a DBC file's current content (hex SHA-1)
+     * @return Empty if the file cannot be read
+     */
+    static QByteArray fileKey(const QString& dbcPath);
+    static QByteArray contentKey(const char* data, qsizetype size);
+
+    /**
+     * @brief Load the image stored for key
+     * @return false if there is none or it is not valid (db is then empty)
+     */
+    bool load(const QByteArray& key, DBCDatabase& db) const;
+
+    /**
+     * @brief Write db as the image for key (atomically) and remove the
+     *        oldest images beyond MAX_IMAGES
+     */
+    bool store(const QByteArray& key, const DBCDatabase& db) const;
+
+    /**
+     * @brief The image format itself, independent of files
+     */
+    static QByteArray serialize(const DBCDatabase& db, const QByteArray& key);
+    static bool deserialize(const char* image, qsizetype size, const QByteArray& key, DBCDatabase& db);
+
+private:
+    QString imagePath(const QByteArray& key) const;
+
+    QString m_directory;
+};
+
+} // namespace DBCManager
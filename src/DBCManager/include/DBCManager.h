@@ -6,7 +6,8 @@
  * This is the main public API for the DBCManager library.
  *
  * Features:
- * - Load and parse DBC files in a background thread
+ * - Load and parse DBC files in background threads, channels concurrently
+ * - Reuse cached binary images of unchanged DBC files (DBCCache)
  * - Associate DBC databases with specific CAN channels
  * - Persist DBC file paths per channel via QSettings
  * - Auto-load saved DBC files on startup
@@ -29,7 +30,7 @@ namespace DBCManager {
 
 /**
  * @brief Worker object for background DBC file parsing.
- * Runs on a dedicated QThread to avoid blocking the UI.
+ * Each channel has one, on its own QThread, to avoid blocking the UI.
  */
 class DBCLoadWorker : public QObject
 {
@@ -237,9 +238,9 @@ private:
     std::array<ChannelData, MAX_CHANNELS> m_channels;
     mutable QMutex m_mutex;
 
-    // Background worker
-    QThread*        m_workerThread = nullptr;
-    DBCLoadWorker*  m_worker       = nullptr;
+    // Background workers, one per channel
+    std::array<QThread*, MAX_CHANNELS>       m_workerThreads = {};
+    std::array<DBCLoadWorker*, MAX_CHANNELS> m_workers       = {};
 };
 
 } // namespace DBCManager
@@ -41,6 +41,59 @@ enum class ValueType {
     Float64  = 3
 };
 
+/**
+ * @brief Instruction set of DBCMessage::decodeBatch()
+ */
+enum class DBCSimd {
+    Scalar = 0,
+    SSE41  = 1,     ///< 2 frames per instruction
+    AVX2   = 2      ///< 4 frames per instruction
+};
+
+//=============================================================================
+// DBCSignalPlan — Compiled decode / encode layout of a signal
+//=============================================================================
+
+/**
+ * @brief A signal's bit layout reduced to word operations.
+ *
+ * Built by DBCSignal::compile() from the layout fields. Decoding loads the
+ * 8 frame bytes starting at firstByte as one little- or big-endian word
+ * (a single unaligned load plus a byte swap for Motorola signals), shifts
+ * and masks it, sign-extends and scales with the signal's factor and
+ * offset. Signals of 58..64 bits that straddle a ninth byte take one extra
+ * byte load.
+ *
+ * The plan keeps the layout it was compiled from, so a signal edited after
+ * compile() is detected and decoded bit by bit instead (see
+ * DBCSignal::hasCurrentPlan()).
+ */
+struct DBCSignalPlan
+{
+    enum class Kind : uint8_t {
+        None,       ///< Not compiled: decode / encode bit by bit
+        Empty,      ///< No bits (length 0 or over 64): raw value 0
+        Byte,       ///< One whole byte
+        Window,     ///< Within the 8 bytes from firstByte
+        Wide        ///< Window plus the byte after it
+    };
+    enum class Value : uint8_t { Unsigned, Signed, Float32, Float64 };
+
+    Kind     kind      = Kind::None;
+    Value    value     = Value::Unsigned;
+    bool     bigEndian = false;
+    uint8_t  shift     = 0;     ///< Right shift of the window (Wide: extra bits from the ninth byte)
+    uint8_t  byteCount = 0;     ///< Frame bytes touched from firstByte (at most 9)
+    uint16_t firstByte = 0;
+    uint64_t mask      = 0;     ///< Raw value bits, right-aligned
+    uint64_t signBit   = 0;     ///< Sign bit of a Signed value, 0 otherwise
+
+    // Layout the plan was compiled from
+    uint32_t  startBit  = 0;
+    uint32_t  bitLength = 0;
+    ValueType valueType = ValueType::Unsigned;
+};
+
 //=============================================================================
 // DBCSignal — Individual signal within a CAN message
 //=============================================================================
@@ -62,7 +115,7 @@ struct DBCSignal
     QString   unit;                 ///< Unit string (e.g., "km/h", "degC")
     QStringList receivers;          ///< Receiving node names
     QString   comment;              ///< Signal comment
-    double    initialValue = 0.0;   ///< Initial/default value
+    double    initialValue = 0.0;   ///< Physical start value (GenSigStartValue, raw in the file)
 
     /// Value descriptions (e.g., 0="Off", 1="On")
     QMap<int64_t, QString> valueDescriptions;
@@ -71,6 +124,26 @@ struct DBCSignal
     QString   muxIndicator;
     int       muxValue = -1;        ///< Mux switch value (if multiplexed signal)
 
+    /// Compiled layout used by decode / encode. DBCDatabase::buildIndex()
+    /// compiles every signal; after changing startBit, bitLength, byteOrder
+    /// or valueType the signal decodes bit by bit until compile() runs again.
+    DBCSignalPlan plan;
+
+    /**
+     * @brief Build plan from the layout fields.
+     */
+    void compile();
+
+    /**
+     * @brief True if plan was compiled from the current layout fields.
+     */
+    bool hasCurrentPlan() const
+    {
+        return plan.kind != DBCSignalPlan::Kind::None && plan.startBit == startBit
+               && plan.bitLength == bitLength && plan.valueType == valueType
+               && plan.bigEndian == (byteOrder == ByteOrder::BigEndian);
+    }
+
     /**
      * @brief Decode raw bits to physical value
      */
@@ -107,6 +180,21 @@ struct DBCSignal
     QString valueToString(double physicalValue) const;
 };
 
+//=============================================================================
+// DBCSignalColumns — Batch decode output
+//=============================================================================
+
+/**
+ * @brief Values of many frames of one message, one contiguous array per
+ *        signal (in DBCMessage::signalList order).
+ */
+struct DBCSignalColumns
+{
+    int frameCount = 0;
+    QVector<QVector<double>>  physical;     ///< physical[signal][frame]
+    QVector<QVector<int64_t>> raw;          ///< raw[signal][frame] (empty unless requested)
+};
+
 //=============================================================================
 // DBCMessage — CAN message definition
 //=============================================================================
@@ -122,6 +210,7 @@ struct DBCMessage
     QString   sender;               ///< Transmitting node name
     QString   comment;              ///< Message comment
     bool      isExtended = false;   ///< 29-bit extended ID
+    int       cycleTimeMs = 0;      ///< Transmission period (GenMsgCycleTime), 0 = not cyclic
 
     /// Signals in this message (ordered by start bit)
     QVector<DBCSignal> signalList;
@@ -151,6 +240,27 @@ struct DBCMessage
      */
     void encodeAll(const QMap<QString, double>& signalValues, uint8_t* data, int dataLength) const;
 
+    /**
+     * @brief Decode many frames of this message into per-signal columns
+     *
+     * Frame i starts at frames + i * stride, e.g. &trace[0].data[0] with
+     * stride sizeof(CANMessage). Values equal decode() / rawValue() frame by
+     * frame. Integer signals of up to 51 bits are decoded several frames per
+     * instruction with SSE4.1 or AVX2 when the CPU has them; the others frame
+     * by frame.
+     *
+     * @param withRaw Also fill columns.raw
+     * @param simd    Highest instruction set to use (capped at supportedSimd())
+     */
+    void decodeBatch(const uint8_t* frames, int count, int stride, int dataLength,
+                     DBCSignalColumns& columns, bool withRaw = false,
+                     DBCSimd simd = DBCSimd::AVX2) const;
+
+    /**
+     * @brief Best instruction set of this CPU for decodeBatch()
+     */
+    static DBCSimd supportedSimd();
+
     /**
      * @brief Display string: "0xID MsgName"
      */
@@ -183,8 +293,8 @@ struct DBCDatabase
     QMap<QString, QMap<int64_t, QString>> valueTables;  ///< Named value tables (VAL_TABLE_)
 
     /**
-     * @brief Rebuild the internal ID→index hash after messages are modified.
-     * Called automatically by DBCParser after parsing.
+     * @brief Rebuild the internal ID→index hash and compile every signal
+     * after messages are modified. Called automatically by DBCParser after parsing.
      */
     void buildIndex();
 
@@ -256,11 +366,26 @@ struct DBCParseError
 /**
  * @brief Parser for Vector DBC (*.dbc) files.
  *
+ * A single pass over the raw bytes (the memory-mapped file for parseFile())
+ * with a hand-written tokenizer: tokens are views into the input, only the
+ * stored names and texts become QStrings. Strings are UTF-8, or Latin-1
+ * (Windows code page files) when not valid UTF-8.
+ *
+ * Large inputs are split into chunks at lines starting with BO_, CM_, VAL_
+ * or BA_ and the chunks are parsed on the global QThreadPool. Statements
+ * referring to messages, signals or nodes (CM_, VAL_, SIG_VALTYPE_, BA_)
+ * are parsed in their chunk and applied in file order after the chunks are
+ * merged, so the result — errors and their line numbers included — is the
+ * same as parsing with one thread. A chunk whose start turns out to lie
+ * inside a statement of the chunk before (a multi-line comment) is parsed
+ * again from where that statement ended.
+ *
  * Supports:
  * - VERSION, NS_, BS_, BU_ (nodes)
  * - BO_ (messages), SG_ (signals)
  * - CM_ (comments for messages and signals)
- * - BA_DEF_, BA_ (attribute definitions and values)
+ * - BA_DEF_DEF_, BA_ (GenMsgCycleTime and GenSigStartValue; other
+ *   attributes are skipped)
  * - VAL_TABLE_, VAL_ (value descriptions)
  * - SIG_VALTYPE_ (signal value types: float/double)
  * - Multiplexed signals (M, m<N>)
@@ -276,8 +401,23 @@ struct DBCParseError
 class DBCParser
 {
 public:
+    static constexpr qsizetype DEFAULT_MIN_CHUNK_SIZE = 128 * 1024;
+
     DBCParser() = default;
 
+    /**
+     * @brief Threads used for large inputs
+     * @param count 0 = QThread::idealThreadCount() (default), 1 = no chunks
+     */
+    void setThreadCount(int count) { m_threadCount = count; }
+    int threadCount() const { return m_threadCount; }
+
+    /**
+     * @brief Smallest input part worth a chunk of its own
+     */
+    void setMinChunkSize(qsizetype bytes) { m_minChunkSize = bytes > 0 ? bytes : 1; }
+    qsizetype minChunkSize() const { return m_minChunkSize; }
+
     /**
      * @brief Parse a DBC file
      * @param filePath Path to the .dbc file
@@ -301,21 +441,31 @@ public:
     QVector<DBCParseError> errors() const { return m_errors; }
 
 private:
-    void parse(const QString& content, DBCDatabase& db);
-    void parseVersion(const QString& line, DBCDatabase& db);
-    void parseNodes(const QString& line, DBCDatabase& db);
-    void parseMessage(const QStringList& lines, int& index, DBCDatabase& db);
-    void parseSignal(const QString& line, DBCMessage& msg);
-    void parseComment(const QStringList& lines, int& index, DBCDatabase& db);
-    void parseValueDescriptions(const QStringList& lines, int& index, DBCDatabase& db);
-    void parseValueTable(const QStringList& lines, int& index, DBCDatabase& db);
-    void parseSignalValueType(const QString& line, DBCDatabase& db);
-    void parseAttributeDefinition(const QString& line, DBCDatabase& db);
-    void parseAttributeValue(const QString& line, DBCDatabase& db);
+    struct Cursor;      ///< Token cursor over the raw DBC bytes
+    struct Reference;   ///< CM_ / VAL_ / SIG_VALTYPE_ / BA_ statement, applied after the merge
+    struct Chunk;       ///< Statements starting in one part of the input
+
+    void parse(const char* data, qsizetype size, DBCDatabase& db);
+    static void parseChunk(Chunk& chunk, const char* inputEnd);
+    static void parseVersion(Cursor& in, Chunk& chunk);
+    static void parseNodes(Cursor& in, Chunk& chunk);
+    static void parseMessage(Cursor& in, Chunk& chunk);
+    static void parseSignal(Cursor& in, DBCMessage& msg);
+    static void parseComment(Cursor& in, Chunk& chunk);
+    static void parseValueDescriptions(Cursor& in, Chunk& chunk);
+    static void parseValueTable(Cursor& in, Chunk& chunk);
+    static void parseSignalValueType(Cursor& in, Chunk& chunk);
+    static void parseAttributeDefinition(Cursor& in, Chunk& chunk);
+    static void parseAttributeValue(Cursor& in, Chunk& chunk);
+    static void applyReference(Reference& ref, DBCDatabase& db);
+    void applyAttributeDefaults(DBCDatabase& db);
 
     void addError(int line, const QString& msg);
 
     QVector<DBCParseError> m_errors;
+    QHash<QString, QString> m_attributeDefaults;    ///< BA_DEF_DEF_ name → value
+    int       m_threadCount  = 0;
+    qsizetype m_minChunkSize = DEFAULT_MIN_CHUNK_SIZE;
 };
 
 } // namespace DBCManager
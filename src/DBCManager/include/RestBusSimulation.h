@@ -0,0 +1,174 @@
+#pragma once
+/**
+ * @file RestBusSimulation.h
+ * @brief DBC-driven rest-bus simulation — transmits the messages of nodes
+ *        that are not on the bench, so the DUT sees a complete network.
+ *
+ * start() compiles every message sent by the selected nodes into a payload
+ * template holding the DBC start values (GenSigStartValue) and schedules it
+ * on the slot's cyclic scheduler with its DBC cycle time (GenMsgCycleTime).
+ * The scheduler is a 1 ms timer wheel that sends all frames due in a tick
+ * with one batched driver call; first transmissions are staggered over the
+ * period so messages with equal cycle times do not all land in one tick.
+ *
+ * Signal overrides encode only the changed signals into the template and
+ * swap the frame in the scheduler, which sends it from the next cycle on.
+ *
+ * Usage:
+ * @code
+ * RestBusSimulation::Options options;
+ * options.slot  = "CAN 1";
+ * options.nodes = {"BCM", "ESC"};
+ * RestBusManager::instance().start(options, DBCDatabaseManager::instance().database(0));
+ * RestBusManager::instance().simulation("CAN 1")->setSignal("ESC_Speed", "VehicleSpeed", 50.0);
+ * @endcode
+ */
+
+#include "DBCParser.h"
+
+#include <CANInterface.h>
+
+#include <QHash>
+#include <QMutex>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace DBCManager {
+
+//=============================================================================
+// RestBusSimulation — one simulated network on one CAN slot
+//=============================================================================
+
+class RestBusSimulation
+{
+public:
+    struct Options
+    {
+        QString     slot;                   ///< CAN slot to transmit on
+        QStringList nodes;                  ///< Sender nodes to simulate (empty = every named sender)
+        QStringList excludedMessages;       ///< Message names not to send (e.g. the DUT's own)
+        int         defaultCycleMs = 0;     ///< Period for messages without a cycle time (0 = skip them)
+    };
+
+    struct MessageStats
+    {
+        QString  name;
+        uint32_t id       = 0;
+        bool     extended = false;
+        int      periodMs = 0;
+        uint64_t sent     = 0;              ///< Frames accepted by the driver
+        uint64_t missed   = 0;              ///< Cycles skipped because the scheduler was late
+        uint64_t errors   = 0;              ///< Cycles the driver rejected
+        double   maxAbsJitterUs = 0.0;
+    };
+
+    struct Stats
+    {
+        QString  slot;
+        bool     running  = false;
+        int      messages = 0;              ///< Messages being sent
+        int      skipped  = 0;              ///< Selected messages without a cycle time
+        uint64_t sent     = 0;
+        uint64_t missed   = 0;
+        uint64_t errors   = 0;
+        uint64_t signalUpdates = 0;         ///< Signals written by setSignal() / setSignals()
+        double   maxAbsJitterUs = 0.0;      ///< Worst over all messages
+        QList<MessageStats> messageStats;   ///< In DBC order
+    };
+
+    /** @param database Kept alive while the simulation exists */
+    RestBusSimulation(std::shared_ptr<const DBCDatabase> database, const Options& options);
+    ~RestBusSimulation();
+
+    RestBusSimulation(const RestBusSimulation&) = delete;
+    RestBusSimulation& operator=(const RestBusSimulation&) = delete;
+
+    /** @brief Compile the payload templates and start all messages. */
+    CANManager::CANResult start();
+
+    /** @brief Stop all messages; their final statistics are returned in stats if given. */
+    void stop(Stats* stats = nullptr);
+
+    /**
+     * @brief Override one signal from the next cycle on.
+     *
+     * Setting a multiplexed signal also switches the multiplexor to its page.
+     */
+    CANManager::CANResult setSignal(const QString& message, const QString& signal, double value);
+
+    /** @brief Override several signals of one message with a single payload swap. */
+    CANManager::CANResult setSignals(const QString& message, const QMap<QString, double>& values);
+
+    /** @brief Restore a message's start values (all messages if message is empty). */
+    CANManager::CANResult resetSignals(const QString& message = QString());
+
+    /** @brief Current frame of a simulated message. Returns false if it is not simulated. */
+    bool frame(const QString& message, CANManager::CANMessage& frame) const;
+
+    /** @brief Names of the simulated messages, in DBC order. */
+    QStringList messageNames() const;
+
+    Stats stats() const;
+
+private:
+    /// A message as scheduled: payload template plus a name → signal index
+    struct CompiledMessage
+    {
+        const DBCMessage*       message;
+        CANManager::CANMessage  frame;      ///< Start values plus overrides
+        CANManager::CANMessage  initial;    ///< Start values only
+        int                     periodMs;
+        const DBCSignal*        multiplexor = nullptr;
+        QHash<QString, const DBCSignal*> signalIndex;
+    };
+
+    CANManager::CANResult compile();
+    CANManager::CANResult applyLocked(CompiledMessage& compiled, const QMap<QString, double>& values);
+    void collectStatsLocked(Stats& stats) const;
+
+    std::shared_ptr<const DBCDatabase> m_database;
+    Options m_options;
+
+    mutable QMutex m_mutex;                 ///< Guards everything below
+    std::vector<CompiledMessage> m_messages;
+    QHash<QString, int> m_messageIndex;     ///< Name → m_messages index
+    int      m_skipped = 0;
+    uint64_t m_signalUpdates = 0;
+    bool     m_running = false;
+};
+
+//=============================================================================
+// RestBusManager — running simulations by slot
+//=============================================================================
+
+class RestBusManager
+{
+public:
+    static RestBusManager& instance();
+
+    /** @brief Start a simulation on options.slot (one per slot). */
+    CANManager::CANResult start(const RestBusSimulation::Options& options,
+                                std::shared_ptr<const DBCDatabase> database);
+
+    /** @brief Stop a slot's simulation, optionally returning its final statistics. */
+    CANManager::CANResult stop(const QString& slot, RestBusSimulation::Stats* stats = nullptr);
+
+    /** @brief Stop every simulation. */
+    void stopAll();
+
+    /** @brief Running simulation of a slot, or nullptr. */
+    std::shared_ptr<RestBusSimulation> simulation(const QString& slot) const;
+
+private:
+    RestBusManager() = default;
+    ~RestBusManager();
+    RestBusManager(const RestBusManager&) = delete;
+    RestBusManager& operator=(const RestBusManager&) = delete;
+
+    mutable QMutex m_mutex;
+    std::map<QString, std::shared_ptr<RestBusSimulation>> m_simulations;
+};
+
+} // namespace DBCManager
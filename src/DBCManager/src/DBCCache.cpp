@@ -0,0 +1,447 @@
+/**
+ * @file DBCCache.cpp
+ * @brief Implementation of the content-keyed DBC database image cache.
+ */
+
+#include "DBCCache.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+
+#include <cstring>
+#include <type_traits>
+
+namespace DBCManager {
+
+namespace {
+
+constexpr char IMAGE_MAGIC[8] = {'S', 'P', 'Y', 'D', 'B', 'C', 'I', '\0'};
+const QString IMAGE_SUFFIX = QStringLiteral(".dbcimg");
+
+//=============================================================================
+// Image writer / reader
+//=============================================================================
+
+class ImageWriter
+{
+public:
+    template <typename T>
+    void put(T value)
+    {
+        if constexpr (std::is_floating_point_v<T>) {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            put(bits);
+        } else if constexpr (std::is_enum_v<T>) {
+            put(static_cast<uint8_t>(value));
+        } else {
+            char bytes[sizeof(T)];
+            qToLittleEndian<T>(value, bytes);
+            m_image.append(bytes, sizeof(T));
+        }
+    }
+
+    void put(bool value) { put(static_cast<uint8_t>(value)); }
+
+    void put(const QString& text)
+    {
+        const QByteArray utf8 = text.toUtf8();
+        put(static_cast<uint32_t>(utf8.size()));
+        m_image.append(utf8);
+    }
+
+    QByteArray& image() { return m_image; }
+
+private:
+    QByteArray m_image;
+};
+
+/**
+ * @brief Bounds-checked reads; after the first failure every read returns
+ *        a default value and ok() stays false.
+ */
+class ImageReader
+{
+public:
+    ImageReader(const char* data, qsizetype size) : m_pos(data), m_end(data + size) {}
+
+    template <typename T>
+    T get()
+    {
+        if constexpr (std::is_same_v<T, double>) {
+            const uint64_t bits = get<uint64_t>();
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        } else {
+            if (!take(sizeof(T)))
+                return T();
+            return qFromLittleEndian<T>(m_pos - sizeof(T));
+        }
+    }
+
+    /// Enumerator up to last
+    template <typename E>
+    E getEnum(E last)
+    {
+        const uint8_t value = get<uint8_t>();
+        if (value > static_cast<uint8_t>(last))
+            m_ok = false;
+        return m_ok ? static_cast<E>(value) : E();
+    }
+
+    QString getString()
+    {
+        const uint32_t size = get<uint32_t>();
+        if (!take(size))
+            return {};
+        return QString::fromUtf8(m_pos - size, static_cast<qsizetype>(size));
+    }
+
+    /// Element count of a list whose elements take at least minSize bytes each
+    uint32_t getCount(size_t minSize)
+    {
+        const uint32_t count = get<uint32_t>();
+        if (count > static_cast<size_t>(m_end - m_pos) / minSize)
+            m_ok = false;
+        return m_ok ? count : 0;
+    }
+
+    void invalidate() { m_ok = false; }
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_pos == m_end; }
+
+private:
+    bool take(size_t size)
+    {
+        if (!m_ok || static_cast<size_t>(m_end - m_pos) < size) {
+            m_ok = false;
+            return false;
+        }
+        m_pos += size;
+        return true;
+    }
+
+    const char* m_pos;
+    const char* m_end;
+    bool        m_ok = true;
+};
+
+//=============================================================================
+// Database layout
+//=============================================================================
+
+void writeSignal(ImageWriter& out, const DBCSignal& sig)
+{
+    out.put(sig.name);
+    out.put(sig.startBit);
+    out.put(sig.bitLength);
+    out.put(sig.byteOrder);
+    out.put(sig.valueType);
+    out.put(sig.factor);
+    out.put(sig.offset);
+    out.put(sig.minimum);
+    out.put(sig.maximum);
+    out.put(sig.initialValue);
+    out.put(sig.unit);
+    out.put(sig.comment);
+    out.put(sig.muxIndicator);
+    out.put(static_cast<int32_t>(sig.muxValue));
+
+    out.put(static_cast<uint32_t>(sig.receivers.size()));
+    for (const QString& receiver : sig.receivers)
+        out.put(receiver);
+    out.put(static_cast<uint32_t>(sig.valueDescriptions.size()));
+    for (auto it = sig.valueDescriptions.cbegin(); it != sig.valueDescriptions.cend(); ++it) {
+        out.put(static_cast<int64_t>(it.key()));
+        out.put(it.value());
+    }
+
+    const DBCSignalPlan& plan = sig.plan;
+    out.put(plan.kind);
+    out.put(plan.value);
+    out.put(plan.bigEndian);
+    out.put(plan.shift);
+    out.put(plan.byteCount);
+    out.put(plan.firstByte);
+    out.put(plan.mask);
+    out.put(plan.signBit);
+    out.put(plan.startBit);
+    out.put(plan.bitLength);
+    out.put(plan.valueType);
+}
+
+void readSignal(ImageReader& in, DBCSignal& sig)
+{
+    sig.name         = in.getString();
+    sig.startBit     = in.get<uint32_t>();
+    sig.bitLength    = in.get<uint32_t>();
+    sig.byteOrder    = in.getEnum(ByteOrder::BigEndian);
+    sig.valueType    = in.getEnum(ValueType::Float64);
+    sig.factor       = in.get<double>();
+    sig.offset       = in.get<double>();
+    sig.minimum      = in.get<double>();
+    sig.maximum      = in.get<double>();
+    sig.initialValue = in.get<double>();
+    sig.unit         = in.getString();
+    sig.comment      = in.getString();
+    sig.muxIndicator = in.getString();
+    sig.muxValue     = in.get<int32_t>();
+
+    const uint32_t receivers = in.getCount(sizeof(uint32_t));
+    sig.receivers.reserve(receivers);
+    for (uint32_t i = 0; i < receivers; ++i)
+        sig.receivers.append(in.getString());
+    const uint32_t descriptions = in.getCount(sizeof(int64_t) + sizeof(uint32_t));
+    for (uint32_t i = 0; i < descriptions; ++i) {
+        const int64_t value = in.get<int64_t>();
+        sig.valueDescriptions.insert(value, in.getString());
+    }
+
+    DBCSignalPlan& plan = sig.plan;
+    plan.kind      = in.getEnum(DBCSignalPlan::Kind::Wide);
+    plan.value     = in.getEnum(DBCSignalPlan::Value::Float64);
+    plan.bigEndian = in.get<uint8_t>() != 0;
+    plan.shift     = in.get<uint8_t>();
+    plan.byteCount = in.get<uint8_t>();
+    plan.firstByte = in.get<uint16_t>();
+    plan.mask      = in.get<uint64_t>();
+    plan.signBit   = in.get<uint64_t>();
+    plan.startBit  = in.get<uint32_t>();
+    plan.bitLength = in.get<uint32_t>();
+    plan.valueType = in.getEnum(ValueType::Float64);
+
+    // Shifts decode relies on; frame bounds are checked at decode time
+    const bool wide = plan.kind == DBCSignalPlan::Kind::Wide;
+    if (plan.byteCount > 9 || plan.shift >= (wide ? 8 : 64) || (wide && plan.shift == 0))
+        in.invalidate();
+}
+
+} // namespace
+
+//=============================================================================
+// DBCCache
+//=============================================================================
+
+DBCCache::DBCCache(const QString& directory)
+    : m_directory(directory)
+{
+}
+
+QString DBCCache::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/dbc");
+}
+
+QByteArray DBCCache::fileKey(const QString& dbcPath)
+{
+    QFile file(dbcPath);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    const qint64 size = file.size();
+    if (uchar* mapped = size > 0 ? file.map(0, size) : nullptr) {
+        const QByteArray key = contentKey(reinterpret_cast<const char*>(mapped), static_cast<qsizetype>(size));
+        file.unmap(mapped);
+        return key;
+    }
+    const QByteArray content = file.readAll();
+    return contentKey(content.constData(), content.size());
+}
+
+QByteArray DBCCache::contentKey(const char* data, qsizetype size)
+{
+    // Identifies content for the cache only; not a security boundary
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::fromRawData(data, size));
+    return hash.result().toHex();
+}
+
+QString DBCCache::imagePath(const QByteArray& key) const
+{
+    return m_directory + QLatin1Char('/') + QString::fromLatin1(key) + IMAGE_SUFFIX;
+}
+
+bool DBCCache::load(const QByteArray& key, DBCDatabase& db) const
+{
+    db = DBCDatabase();
+    if (key.isEmpty())
+        return false;
+
+    QFile file(imagePath(key));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    bool valid = false;
+    const qint64 size = file.size();
+    if (uchar* mapped = size > 0 ? file.map(0, size) : nullptr) {
+        valid = deserialize(reinterpret_cast<const char*>(mapped), static_cast<qsizetype>(size), key, db);
+        file.unmap(mapped);
+    } else {
+        const QByteArray image = file.readAll();
+        valid = deserialize(image.constData(), image.size(), key, db);
+    }
+
+    if (!valid)
+        qWarning() << "[DBCCache] Ignoring invalid image" << file.fileName();
+    return valid;
+}
+
+bool DBCCache::store(const QByteArray& key, const DBCDatabase& db) const
+{
+    if (key.isEmpty())
+        return false;
+    if (!QDir().mkpath(m_directory)) {
+        qWarning() << "[DBCCache] Cannot create" << m_directory;
+        return false;
+    }
+
+    QSaveFile file(imagePath(key));
+    const QByteArray image = serialize(db, key);
+    if (!file.open(QIODevice::WriteOnly) || file.write(image) != image.size() || !file.commit()) {
+        qWarning() << "[DBCCache] Cannot write" << imagePath(key) << ":" << file.errorString();
+        return false;
+    }
+
+    // Newest first
+    const QFileInfoList images = QDir(m_directory).entryInfoList({QLatin1Char('*') + IMAGE_SUFFIX},
+                                                                 QDir::Files, QDir::Time);
+    for (qsizetype i = MAX_IMAGES; i < images.size(); ++i)
+        QFile::remove(images[i].absoluteFilePath());
+    return true;
+}
+
+//=============================================================================
+// Image format
+//=============================================================================
+//
+//   "SPYDBCI\0"  u32 FORMAT_VERSION  u32 key size  key  u64 payload size
+//   payload: version, nodes, value tables, messages (with their signals)
+
+QByteArray DBCCache::serialize(const DBCDatabase& db, const QByteArray& key)
+{
+    ImageWriter out;
+    out.image().append(IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    out.put(FORMAT_VERSION);
+    out.put(static_cast<uint32_t>(key.size()));
+    out.image().append(key);
+    const qsizetype payloadSizeAt = out.image().size();
+    out.put(uint64_t(0));
+    const qsizetype payloadStart = out.image().size();
+
+    out.put(db.version);
+
+    out.put(static_cast<uint32_t>(db.nodes.size()));
+    for (const DBCNode& node : db.nodes) {
+        out.put(node.name);
+        out.put(node.comment);
+    }
+
+    out.put(static_cast<uint32_t>(db.valueTables.size()));
+    for (auto table = db.valueTables.cbegin(); table != db.valueTables.cend(); ++table) {
+        out.put(table.key());
+        out.put(static_cast<uint32_t>(table.value().size()));
+        for (auto it = table.value().cbegin(); it != table.value().cend(); ++it) {
+            out.put(static_cast<int64_t>(it.key()));
+            out.put(it.value());
+        }
+    }
+
+    out.put(static_cast<uint32_t>(db.messages.size()));
+    for (const DBCMessage& msg : db.messages) {
+        out.put(msg.id);
+        out.put(msg.isExtended);
+        out.put(msg.dlc);
+        out.put(static_cast<int32_t>(msg.cycleTimeMs));
+        out.put(msg.name);
+        out.put(msg.sender);
+        out.put(msg.comment);
+        out.put(static_cast<uint32_t>(msg.signalList.size()));
+        for (const DBCSignal& sig : msg.signalList)
+            writeSignal(out, sig);
+    }
+
+    QByteArray& image = out.image();
+    qToLittleEndian<uint64_t>(static_cast<uint64_t>(image.size() - payloadStart), image.data() + payloadSizeAt);
+    return image;
+}
+
+bool DBCCache::deserialize(const char* image, qsizetype size, const QByteArray& key, DBCDatabase& db)
+{
+    db = DBCDatabase();
+
+    // Header
+    if (size < static_cast<qsizetype>(sizeof(IMAGE_MAGIC))
+        || std::memcmp(image, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0)
+        return false;
+    ImageReader in(image + sizeof(IMAGE_MAGIC), size - static_cast<qsizetype>(sizeof(IMAGE_MAGIC)));
+    if (in.get<uint32_t>() != FORMAT_VERSION)
+        return false;
+    if (in.get<uint32_t>() != static_cast<uint32_t>(key.size()))
+        return false;
+    for (const char c : key) {
+        if (in.get<char>() != c)
+            return false;
+    }
+    const qsizetype headerSize = sizeof(IMAGE_MAGIC) + 2 * sizeof(uint32_t) + key.size() + sizeof(uint64_t);
+    if (!in.ok() || in.get<uint64_t>() != static_cast<uint64_t>(size - headerSize))
+        return false;
+
+    // Payload
+    db.version = in.getString();
+
+    const uint32_t nodes = in.getCount(2 * sizeof(uint32_t));
+    db.nodes.reserve(nodes);
+    for (uint32_t i = 0; i < nodes; ++i) {
+        DBCNode node;
+        node.name    = in.getString();
+        node.comment = in.getString();
+        db.nodes.append(node);
+    }
+
+    const uint32_t tables = in.getCount(2 * sizeof(uint32_t));
+    for (uint32_t i = 0; i < tables && in.ok(); ++i) {
+        QMap<int64_t, QString>& table = db.valueTables[in.getString()];
+        const uint32_t entries = in.getCount(sizeof(int64_t) + sizeof(uint32_t));
+        for (uint32_t k = 0; k < entries; ++k) {
+            const int64_t value = in.get<int64_t>();
+            table.insert(value, in.getString());
+        }
+    }
+
+    const uint32_t messages = in.getCount(4 * sizeof(uint32_t));
+    db.messages.reserve(messages);
+    for (uint32_t i = 0; i < messages && in.ok(); ++i) {
+        DBCMessage msg;
+        msg.id          = in.get<uint32_t>();
+        msg.isExtended  = in.get<uint8_t>() != 0;
+        msg.dlc         = in.get<uint32_t>();
+        msg.cycleTimeMs = in.get<int32_t>();
+        msg.name        = in.getString();
+        msg.sender      = in.getString();
+        msg.comment     = in.getString();
+
+        const uint32_t signalCount = in.getCount(8 * sizeof(uint32_t));
+        msg.signalList.resize(signalCount);
+        for (DBCSignal& sig : msg.signalList)
+            readSignal(in, sig);
+
+        // Plans come from the image: index only, no recompile
+        db.messages.append(msg);
+        db.indexLastMessage();
+    }
+
+    if (!in.ok() || !in.atEnd()) {
+        db = DBCDatabase();
+        return false;
+    }
+    return true;
+}
+
+} // namespace DBCManager
@@ -4,6 +4,7 @@
  */
 
 #include "DBCManager.h"
+#include "DBCCache.h"
 #include <QSettings>
 #include <QFileInfo>
 #include <QMutexLocker>
@@ -18,10 +19,23 @@ namespace DBCManager {
 
 void DBCLoadWorker::process(int channelIndex, const QString& filePath)
 {
+    // Unchanged DBC content: take the parsed image
+    DBCCache cache;
+    const QByteArray key = DBCCache::fileKey(filePath);
+    auto db = std::make_shared<DBCDatabase>();
+    if (cache.load(key, *db)) {
+        db->filename = filePath;
+        emit progress(channelIndex, QString("Loaded %1 messages, %2 signals from cache")
+                                        .arg(db->messages.size())
+                                        .arg(db->totalSignalCount()));
+        emit finished(channelIndex, db, QString());
+        return;
+    }
+
     emit progress(channelIndex, QString("Parsing DBC: %1").arg(QFileInfo(filePath).fileName()));
 
     DBCParser parser;
-    auto db = std::make_shared<DBCDatabase>(parser.parseFile(filePath));
+    *db = parser.parseFile(filePath);
 
     QString errorMsg;
     if (parser.hasErrors()) {
@@ -35,6 +49,10 @@ void DBCLoadWorker::process(int channelIndex, const QString& filePath)
         errorMsg = "DBC file contains no messages";
     }
 
+    // Only clean parses of a file that did not change meanwhile are cached
+    if (errorMsg.isEmpty() && DBCCache::fileKey(filePath) == key)
+        cache.store(key, *db);
+
     emit progress(channelIndex, db->isEmpty()
                   ? "Parsing failed"
                   : QString("Parsed %1 messages, %2 signals")
@@ -56,25 +74,31 @@ DBCDatabaseManager& DBCDatabaseManager::instance()
 
 DBCDatabaseManager::DBCDatabaseManager()
 {
-    // Create background worker thread
-    m_workerThread = new QThread(this);
-    m_worker = new DBCLoadWorker;  // no parent — will be moved to thread
-    m_worker->moveToThread(m_workerThread);
-
-    // Connect worker signals
-    connect(m_worker, &DBCLoadWorker::finished,
-            this, &DBCDatabaseManager::onWorkerFinished, Qt::QueuedConnection);
-    connect(m_worker, &DBCLoadWorker::progress,
-            this, &DBCDatabaseManager::loadProgress, Qt::QueuedConnection);
-
-    m_workerThread->start();
+    // One background worker thread per channel: channels load concurrently,
+    // loads of one channel finish in the order they were requested
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        m_workerThreads[i] = new QThread(this);
+        m_workers[i] = new DBCLoadWorker;  // no parent — will be moved to thread
+        m_workers[i]->moveToThread(m_workerThreads[i]);
+
+        // Connect worker signals
+        connect(m_workers[i], &DBCLoadWorker::finished,
+                this, &DBCDatabaseManager::onWorkerFinished, Qt::QueuedConnection);
+        connect(m_workers[i], &DBCLoadWorker::progress,
+                this, &DBCDatabaseManager::loadProgress, Qt::QueuedConnection);
+
+        m_workerThreads[i]->start();
+    }
 }
 
 DBCDatabaseManager::~DBCDatabaseManager()
 {
-    m_workerThread->quit();
-    m_workerThread->wait(3000);
-    delete m_worker;
+    for (QThread* thread : m_workerThreads)
+        thread->quit();
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        m_workerThreads[i]->wait(3000);
+        delete m_workers[i];
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -100,8 +124,8 @@ void DBCDatabaseManager::loadDBCFile(int channelIndex, const QString& filePath)
 
     emit loadStarted(channelIndex, filePath);
 
-    // Invoke worker on background thread
-    QMetaObject::invokeMethod(m_worker, "process", Qt::QueuedConnection,
+    // Invoke the channel's worker on its background thread
+    QMetaObject::invokeMethod(m_workers[channelIndex], "process", Qt::QueuedConnection,
                               Q_ARG(int, channelIndex),
                               Q_ARG(QString, filePath));
 }
@@ -5,12 +5,27 @@
 
 #include "DBCParser.h"
 #include <QFile>
-#include <QTextStream>
-#include <QRegularExpression>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
 #include <QDebug>
+#include <QtEndian>
 #include <cmath>
 #include <cstring>
 #include <algorithm>
+#include <charconv>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define DBC_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define DBC_TARGET(isa)                 // MSVC compiles any intrinsic without flags
+#  else
+#    define DBC_TARGET(isa) __attribute__((target(isa)))
+#  endif
+#endif
 
 namespace DBCManager {
 
@@ -106,13 +121,181 @@ static void placeBitsBE(uint8_t* data, int dataLen, uint32_t startBit, uint32_t
     }
 }
 
+//=============================================================================
+// Compiled plan helpers
+//=============================================================================
+
+/**
+ * @brief The 8 frame bytes from first as a little- or big-endian word.
+ * Bytes past the frame read as 0, like the bit-by-bit helpers above.
+ */
+template <bool BigEndian>
+static inline uint64_t loadWindow(const uint8_t* data, int dataLen, int first)
+{
+    if (first + 8 <= dataLen)
+        return BigEndian ? qFromBigEndian<quint64>(data + first) : qFromLittleEndian<quint64>(data + first);
+
+    // Near the end: load the frame's last 8 bytes and shift the missing ones in as 0
+    if (first < dataLen && dataLen >= 8) {
+        const int skip = 8 * (first - (dataLen - 8));
+        return BigEndian ? qFromBigEndian<quint64>(data + dataLen - 8) << skip
+                         : qFromLittleEndian<quint64>(data + dataLen - 8) >> skip;
+    }
+
+    uint8_t tail[8] = {};
+    if (first < dataLen)
+        std::memcpy(tail, data + first, static_cast<size_t>(dataLen - first));
+    return BigEndian ? qFromBigEndian<quint64>(tail) : qFromLittleEndian<quint64>(tail);
+}
+
+/**
+ * @brief Write the first count bytes of word (in the given byte order) back from first.
+ */
+template <bool BigEndian>
+static inline void storeWindow(uint8_t* data, int dataLen, int first, int count, uint64_t word)
+{
+    uint8_t bytes[8];
+    if (BigEndian)
+        qToBigEndian<quint64>(word, bytes);
+    else
+        qToLittleEndian<quint64>(word, bytes);
+    const int n = std::min(count, dataLen - first);
+    if (n > 0)
+        std::memcpy(data + first, bytes, static_cast<size_t>(n));
+}
+
+static inline uint8_t loadByte(const uint8_t* data, int dataLen, int index)
+{
+    return index < dataLen ? data[index] : 0;
+}
+
+/**
+ * @brief Raw (unsigned, masked) bits of a compiled signal.
+ */
+static inline uint64_t extractPlanned(const DBCSignalPlan& plan, const uint8_t* data, int dataLen)
+{
+    const int first = plan.firstByte;
+    switch (plan.kind) {
+    case DBCSignalPlan::Kind::Byte:
+        return loadByte(data, dataLen, first);
+    case DBCSignalPlan::Kind::Window:
+        return plan.bigEndian ? (loadWindow<true>(data, dataLen, first) >> plan.shift) & plan.mask
+                              : (loadWindow<false>(data, dataLen, first) >> plan.shift) & plan.mask;
+    case DBCSignalPlan::Kind::Wide: {
+        const uint64_t high = loadByte(data, dataLen, first + 8);
+        if (plan.bigEndian)
+            return ((loadWindow<true>(data, dataLen, first) << plan.shift) | (high >> (8 - plan.shift))) & plan.mask;
+        return ((loadWindow<false>(data, dataLen, first) >> plan.shift) | (high << (64 - plan.shift))) & plan.mask;
+    }
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Replace the bits of a compiled signal with value (already masked).
+ */
+static inline void placePlanned(const DBCSignalPlan& plan, uint8_t* data, int dataLen, uint64_t value)
+{
+    const int first = plan.firstByte;
+    switch (plan.kind) {
+    case DBCSignalPlan::Kind::Byte:
+        if (first < dataLen)
+            data[first] = static_cast<uint8_t>(value);
+        break;
+    case DBCSignalPlan::Kind::Window:
+        if (plan.bigEndian) {
+            const uint64_t word = loadWindow<true>(data, dataLen, first);
+            storeWindow<true>(data, dataLen, first, plan.byteCount,
+                              (word & ~(plan.mask << plan.shift)) | (value << plan.shift));
+        } else {
+            const uint64_t word = loadWindow<false>(data, dataLen, first);
+            storeWindow<false>(data, dataLen, first, plan.byteCount,
+                               (word & ~(plan.mask << plan.shift)) | (value << plan.shift));
+        }
+        break;
+    case DBCSignalPlan::Kind::Wide:
+        if (first + 8 < dataLen) {
+            uint8_t& high = data[first + 8];
+            if (plan.bigEndian) {
+                const uint8_t highMask = static_cast<uint8_t>(0xFF << (8 - plan.shift));
+                high = static_cast<uint8_t>((high & ~highMask) | (value << (8 - plan.shift)));
+            } else {
+                const uint64_t highBits = plan.mask >> (64 - plan.shift);
+                high = static_cast<uint8_t>((high & ~highBits) | (value >> (64 - plan.shift)));
+            }
+        }
+        if (plan.bigEndian) {
+            const uint64_t word = loadWindow<true>(data, dataLen, first);
+            storeWindow<true>(data, dataLen, first, 8,
+                              (word & ~(plan.mask >> plan.shift)) | (value >> plan.shift));
+        } else {
+            const uint64_t word = loadWindow<false>(data, dataLen, first);
+            storeWindow<false>(data, dataLen, first, 8,
+                               (word & ~(plan.mask << plan.shift)) | (value << plan.shift));
+        }
+        break;
+    default:
+        break;
+    }
+}
+
 //=============================================================================
 // DBCSignal implementation
 //=============================================================================
 
+void DBCSignal::compile()
+{
+    DBCSignalPlan p;
+    p.startBit  = startBit;
+    p.bitLength = bitLength;
+    p.valueType = valueType;
+    p.bigEndian = byteOrder == ByteOrder::BigEndian;
+    if (valueType == ValueType::Float32 && bitLength == 32)
+        p.value = DBCSignalPlan::Value::Float32;
+    else if (valueType == ValueType::Float64 && bitLength == 64)
+        p.value = DBCSignalPlan::Value::Float64;
+    else if (valueType == ValueType::Signed)
+        p.value = DBCSignalPlan::Value::Signed;
+
+    if (bitLength == 0 || bitLength > 64 || startBit / 8 > 0xFFFF) {
+        p.kind = DBCSignalPlan::Kind::Empty;
+        plan = p;
+        return;
+    }
+
+    p.mask = bitLength == 64 ? ~0ULL : (1ULL << bitLength) - 1;
+    if (p.value == DBCSignalPlan::Value::Signed && bitLength < 64)
+        p.signBit = 1ULL << (bitLength - 1);
+    p.firstByte = static_cast<uint16_t>(startBit / 8);
+
+    // Bits from the window start (LSB of firstByte for Intel, MSB for Motorola)
+    // to the end of the signal
+    const uint32_t lead = p.bigEndian ? 7 - startBit % 8 : startBit % 8;
+    const uint32_t end  = lead + bitLength;
+    p.byteCount = static_cast<uint8_t>((end + 7) / 8);
+
+    if (bitLength == 8 && lead == 0) {
+        p.kind = DBCSignalPlan::Kind::Byte;
+    } else if (end <= 64) {
+        p.kind  = DBCSignalPlan::Kind::Window;
+        p.shift = static_cast<uint8_t>(p.bigEndian ? 64 - end : lead);
+    } else {
+        p.kind  = DBCSignalPlan::Kind::Wide;
+        p.shift = static_cast<uint8_t>(p.bigEndian ? end - 64 : lead);
+    }
+    plan = p;
+}
+
 int64_t DBCSignal::rawValue(const uint8_t* data, int dataLength) const
 {
     uint64_t raw;
+    if (hasCurrentPlan()) {
+        // Branch-free sign extension (signBit is 0 for unsigned values)
+        raw = extractPlanned(plan, data, dataLength);
+        return static_cast<int64_t>((raw ^ plan.signBit) - plan.signBit);
+    }
+
     if (byteOrder == ByteOrder::LittleEndian)
         raw = extractBitsLE(data, dataLength, startBit, bitLength);
     else
@@ -131,6 +314,11 @@ int64_t DBCSignal::rawValue(const uint8_t* data, int dataLength) const
 
 void DBCSignal::setRawValue(int64_t raw, uint8_t* data, int dataLength) const
 {
+    if (hasCurrentPlan()) {
+        placePlanned(plan, data, dataLength, static_cast<uint64_t>(raw) & plan.mask);
+        return;
+    }
+
     uint64_t uraw = static_cast<uint64_t>(raw);
     if (bitLength < 64)
         uraw &= (1ULL << bitLength) - 1;  // mask to bit length
@@ -155,6 +343,26 @@ int64_t DBCSignal::physicalToRaw(double physical) const
 
 double DBCSignal::decode(const uint8_t* data, int dataLength) const
 {
+    if (hasCurrentPlan()) {
+        const uint64_t raw = extractPlanned(plan, data, dataLength);
+        switch (plan.value) {
+        case DBCSignalPlan::Value::Float32: {
+            const uint32_t u32 = static_cast<uint32_t>(raw);
+            float f;
+            std::memcpy(&f, &u32, sizeof(f));
+            return static_cast<double>(f) * factor + offset;
+        }
+        case DBCSignalPlan::Value::Float64: {
+            double d;
+            std::memcpy(&d, &raw, sizeof(d));
+            return d * factor + offset;
+        }
+        default:
+            return static_cast<double>(static_cast<int64_t>((raw ^ plan.signBit) - plan.signBit))
+                   * factor + offset;
+        }
+    }
+
     // Float32 / Float64 signals: extract raw bits and reinterpret as IEEE754
     if (valueType == ValueType::Float32 && bitLength == 32) {
         uint64_t raw;
@@ -192,7 +400,9 @@ void DBCSignal::encode(double physicalValue, uint8_t* data, int dataLength) cons
         uint32_t u32;
         std::memcpy(&u32, &f, sizeof(u32));
         uint64_t raw64 = u32;
-        if (byteOrder == ByteOrder::LittleEndian)
+        if (hasCurrentPlan())
+            placePlanned(plan, data, dataLength, raw64);
+        else if (byteOrder == ByteOrder::LittleEndian)
             placeBitsLE(data, dataLength, startBit, 32, raw64);
         else
             placeBitsBE(data, dataLength, startBit, 32, raw64);
@@ -202,7 +412,9 @@ void DBCSignal::encode(double physicalValue, uint8_t* data, int dataLength) cons
         double d = (physicalValue - offset) / factor;
         uint64_t raw64;
         std::memcpy(&raw64, &d, sizeof(raw64));
-        if (byteOrder == ByteOrder::LittleEndian)
+        if (hasCurrentPlan())
+            placePlanned(plan, data, dataLength, raw64);
+        else if (byteOrder == ByteOrder::LittleEndian)
             placeBitsLE(data, dataLength, startBit, 64, raw64);
         else
             placeBitsBE(data, dataLength, startBit, 64, raw64);
@@ -273,6 +485,242 @@ void DBCMessage::encodeAll(const QMap<QString, double>& signalValues, uint8_t* d
     }
 }
 
+//=============================================================================
+// Batch decode kernels
+//=============================================================================
+
+namespace {
+
+/// How a batch kernel reads a signal's bits from one frame
+enum class BatchLoad { Byte, WindowLE, WindowBE };
+
+/**
+ * @brief One integer signal over a run of frames, decoded to columns.
+ */
+struct BatchJob
+{
+    const uint8_t* frames;
+    int      stride;
+    int      dataLength;
+    int      count;
+    int      firstByte;
+    int      shift;
+    uint64_t mask;
+    uint64_t signBit;
+    double   factor;
+    double   offset;
+    double*  physical;
+    int64_t* raw;           ///< nullptr = not requested
+};
+
+template <BatchLoad Load>
+inline uint64_t batchWord(const BatchJob& job, int frame)
+{
+    const uint8_t* data = job.frames + static_cast<ptrdiff_t>(frame) * job.stride;
+    if constexpr (Load == BatchLoad::Byte)
+        return loadByte(data, job.dataLength, job.firstByte);
+    else
+        return loadWindow<Load == BatchLoad::WindowBE>(data, job.dataLength, job.firstByte);
+}
+
+template <BatchLoad Load>
+void batchScalar(const BatchJob& job, int from)
+{
+    for (int f = from; f < job.count; ++f) {
+        const uint64_t bits = (batchWord<Load>(job, f) >> job.shift) & job.mask;
+        const int64_t raw = static_cast<int64_t>((bits ^ job.signBit) - job.signBit);
+        if (job.raw)
+            job.raw[f] = raw;
+        job.physical[f] = static_cast<double>(raw) * job.factor + job.offset;
+    }
+}
+
+#ifdef DBC_X86
+
+// The SIMD kernels need the whole window inside every frame
+// (firstByte + 8 <= dataLength); they load it straight from the frames.
+
+// int64 → double for |x| < 2^51: add the bits of 1.5 * 2^52, subtract it as a double
+constexpr int64_t kMagicBits   = 0x4338000000000000LL;
+constexpr double  kMagicDouble = 6755399441055744.0;
+
+/// Two frames' windows as the 64-bit lanes of one register
+template <bool BigEndian>
+DBC_TARGET("sse4.1") inline __m128i loadWindows2(const uint8_t* lo, const uint8_t* hi)
+{
+    const __m128i v = _mm_castpd_si128(_mm_loadh_pd(
+        _mm_castsi128_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(lo))),
+        reinterpret_cast<const double*>(hi)));
+    if constexpr (BigEndian)
+        return _mm_shuffle_epi8(v, _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7));
+    else
+        return v;
+}
+
+template <bool BigEndian>
+DBC_TARGET("sse4.1") void batchSse41(const BatchJob& job)
+{
+    const __m128i shift  = _mm_cvtsi32_si128(job.shift);
+    const __m128i mask   = _mm_set1_epi64x(static_cast<int64_t>(job.mask));
+    const __m128i sign   = _mm_set1_epi64x(static_cast<int64_t>(job.signBit));
+    const __m128i magic  = _mm_set1_epi64x(kMagicBits);
+    const __m128d magicD = _mm_set1_pd(kMagicDouble);
+    const __m128d factor = _mm_set1_pd(job.factor);
+    const __m128d offset = _mm_set1_pd(job.offset);
+
+    const uint8_t* p = job.frames + job.firstByte;
+    int f = 0;
+    for (; f + 2 <= job.count; f += 2, p += 2 * job.stride) {
+        __m128i v = loadWindows2<BigEndian>(p, p + job.stride);
+        v = _mm_and_si128(_mm_srl_epi64(v, shift), mask);
+        v = _mm_sub_epi64(_mm_xor_si128(v, sign), sign);
+        if (job.raw)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(job.raw + f), v);
+        const __m128d d = _mm_sub_pd(_mm_castsi128_pd(_mm_add_epi64(v, magic)), magicD);
+        _mm_storeu_pd(job.physical + f, _mm_add_pd(_mm_mul_pd(d, factor), offset));
+    }
+    batchScalar<BigEndian ? BatchLoad::WindowBE : BatchLoad::WindowLE>(job, f);
+}
+
+template <bool BigEndian>
+DBC_TARGET("avx2") void batchAvx2(const BatchJob& job)
+{
+    const __m128i shift  = _mm_cvtsi32_si128(job.shift);
+    const __m256i mask   = _mm256_set1_epi64x(static_cast<int64_t>(job.mask));
+    const __m256i sign   = _mm256_set1_epi64x(static_cast<int64_t>(job.signBit));
+    const __m256i magic  = _mm256_set1_epi64x(kMagicBits);
+    const __m256d magicD = _mm256_set1_pd(kMagicDouble);
+    const __m256d factor = _mm256_set1_pd(job.factor);
+    const __m256d offset = _mm256_set1_pd(job.offset);
+
+    const uint8_t* p = job.frames + job.firstByte;
+    const ptrdiff_t stride = job.stride;
+    int f = 0;
+    for (; f + 4 <= job.count; f += 4, p += 4 * stride) {
+        __m256i v = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(loadWindows2<BigEndian>(p, p + stride)),
+            loadWindows2<BigEndian>(p + 2 * stride, p + 3 * stride), 1);
+        v = _mm256_and_si256(_mm256_srl_epi64(v, shift), mask);
+        v = _mm256_sub_epi64(_mm256_xor_si256(v, sign), sign);
+        if (job.raw)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(job.raw + f), v);
+        const __m256d d = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(v, magic)), magicD);
+        _mm256_storeu_pd(job.physical + f, _mm256_add_pd(_mm256_mul_pd(d, factor), offset));
+    }
+    batchScalar<BigEndian ? BatchLoad::WindowBE : BatchLoad::WindowLE>(job, f);
+}
+
+#endif // DBC_X86
+
+/**
+ * @brief Run a job with the best kernel allowed; load selects the frame by
+ *        frame kernel (windows past the frame end, or no SIMD).
+ */
+void runBatch(const BatchJob& job, BatchLoad load, DBCSimd simd)
+{
+#ifdef DBC_X86
+    // A byte signal is the low byte of its little-endian window
+    if (simd != DBCSimd::Scalar && job.firstByte + 8 <= job.dataLength) {
+        const bool bigEndian = load == BatchLoad::WindowBE;
+        if (simd == DBCSimd::AVX2)
+            return bigEndian ? batchAvx2<true>(job) : batchAvx2<false>(job);
+        return bigEndian ? batchSse41<true>(job) : batchSse41<false>(job);
+    }
+#else
+    Q_UNUSED(simd);
+#endif
+    switch (load) {
+    case BatchLoad::Byte:     return batchScalar<BatchLoad::Byte>(job, 0);
+    case BatchLoad::WindowLE: return batchScalar<BatchLoad::WindowLE>(job, 0);
+    case BatchLoad::WindowBE: return batchScalar<BatchLoad::WindowBE>(job, 0);
+    }
+}
+
+} // namespace
+
+DBCSimd DBCMessage::supportedSimd()
+{
+#ifdef DBC_X86
+    static const DBCSimd level = [] {
+#  if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        __cpuid(info, 1);
+        const bool sse41 = info[2] & (1 << 19);
+        const bool osAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28))
+                           && (_xgetbv(0) & 0x6) == 0x6;
+        bool avx2 = false;
+        if (osAvx && maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            avx2 = info[1] & (1 << 5);
+        }
+#  else
+        __builtin_cpu_init();
+        const bool sse41 = __builtin_cpu_supports("sse4.1");
+        const bool avx2  = __builtin_cpu_supports("avx2");
+#  endif
+        return avx2 ? DBCSimd::AVX2 : sse41 ? DBCSimd::SSE41 : DBCSimd::Scalar;
+    }();
+    return level;
+#else
+    return DBCSimd::Scalar;
+#endif
+}
+
+void DBCMessage::decodeBatch(const uint8_t* frames, int count, int stride, int dataLength,
+                             DBCSignalColumns& columns, bool withRaw, DBCSimd simd) const
+{
+    count = qMax(count, 0);
+    simd = qMin(simd, supportedSimd());
+
+    const int signalCount = signalList.size();
+    columns.frameCount = count;
+    columns.physical.resize(signalCount);
+    columns.raw.resize(withRaw ? signalCount : 0);
+    for (int s = 0; s < signalCount; ++s) {
+        columns.physical[s].resize(count);
+        if (withRaw)
+            columns.raw[s].resize(count);
+    }
+
+    // Blocks of frames stay in cache while every signal reads them
+    constexpr int kBlock = 512;
+    for (int first = 0; first < count; first += kBlock) {
+        const int n = qMin(kBlock, count - first);
+        const uint8_t* block = frames + static_cast<ptrdiff_t>(first) * stride;
+
+        for (int s = 0; s < signalCount; ++s) {
+            const DBCSignal& sig = signalList[s];
+            const DBCSignalPlan& plan = sig.plan;
+            double* physical = columns.physical[s].data() + first;
+            int64_t* raw = withRaw ? columns.raw[s].data() + first : nullptr;
+
+            const bool integer = plan.value == DBCSignalPlan::Value::Unsigned
+                                 || plan.value == DBCSignalPlan::Value::Signed;
+            const bool vector = integer && sig.bitLength <= 51 && sig.hasCurrentPlan()
+                                && (plan.kind == DBCSignalPlan::Kind::Byte
+                                    || plan.kind == DBCSignalPlan::Kind::Window);
+            if (!vector) {
+                for (int f = 0; f < n; ++f) {
+                    const uint8_t* data = block + static_cast<ptrdiff_t>(f) * stride;
+                    physical[f] = sig.decode(data, dataLength);
+                    if (raw)
+                        raw[f] = sig.rawValue(data, dataLength);
+                }
+                continue;
+            }
+
+            const BatchJob job{block, stride, dataLength, n, plan.firstByte, plan.shift,
+                               plan.mask, plan.signBit, sig.factor, sig.offset, physical, raw};
+            const BatchLoad load = plan.kind == DBCSignalPlan::Kind::Byte ? BatchLoad::Byte
+                                   : plan.bigEndian                        ? BatchLoad::WindowBE
+                                                                           : BatchLoad::WindowLE;
+            runBatch(job, load, simd);
+        }
+    }
+}
+
 QString DBCMessage::displayString() const
 {
     QString idStr = QString("%1").arg(id, 3, 16, QChar('0')).toUpper();
@@ -294,6 +742,8 @@ void DBCDatabase::buildIndex()
         m_idIndex.insert(key, i);
         if (!messages[i].name.isEmpty())
             m_nameIndex.insert(messages[i].name, i);
+        for (auto& sig : messages[i].signalList)
+            sig.compile();
     }
 }
 
@@ -393,6 +843,339 @@ int DBCDatabase::totalSignalCount() const
     return count;
 }
 
+//=============================================================================
+// DBCParser — tokenizer
+//=============================================================================
+
+/**
+ * @brief Cursor over the raw DBC bytes, handing out tokens as views.
+ *
+ * A statement is read up to limit: the end of its line, or the input end
+ * after toStatementEnd() for statements that span lines (CM_, VAL_, ...).
+ * Whitespace between tokens includes newlines only there, so a malformed
+ * single-line statement never reads into the next one.
+ */
+struct DBCParser::Cursor
+{
+    const char* pos       = nullptr;
+    const char* limit     = nullptr;
+    const char* end       = nullptr;    ///< End of the input
+    const char* lineStart = nullptr;    ///< Line of the statement
+    const char* lineEnd   = nullptr;
+    int         line      = 1;          ///< Line number of pos
+
+    void startLine(const char* start)
+    {
+        pos = lineStart = start;
+        const void* nl = std::memchr(start, '\n', static_cast<size_t>(end - start));
+        limit = lineEnd = nl ? static_cast<const char*>(nl) : end;
+    }
+
+    /// Move to the line after the one pos is on; false at the end of the input
+    bool nextLine()
+    {
+        const void* nl = std::memchr(pos, '\n', static_cast<size_t>(end - pos));
+        if (!nl)
+            return false;
+        ++line;
+        startLine(static_cast<const char*>(nl) + 1);
+        return true;
+    }
+
+    void toStatementEnd() { limit = end; }
+
+    /// The statement's first line without surrounding whitespace
+    std::string_view lineText() const
+    {
+        const char* b = lineStart;
+        const char* e = lineEnd;
+        while (b < e && isSpace(*b))
+            ++b;
+        while (e > b && isSpace(e[-1]))
+            --e;
+        return {b, static_cast<size_t>(e - b)};
+    }
+
+    void skipSpace()
+    {
+        for (; pos < limit; ++pos) {
+            if (*pos == '\n')
+                ++line;
+            else if (!isSpace(*pos))
+                break;
+        }
+    }
+
+    bool atLimit()
+    {
+        skipSpace();
+        return pos >= limit;
+    }
+
+    bool consume(char c)
+    {
+        skipSpace();
+        if (pos < limit && *pos == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    /// Next character without skipping whitespace (0 at the limit)
+    char get() { return pos < limit ? *pos++ : '\0'; }
+
+    /// [A-Za-z0-9_]+ (empty if none)
+    std::string_view identifier()
+    {
+        skipSpace();
+        const char* b = pos;
+        while (pos < limit && isIdentifierChar(*pos))
+            ++pos;
+        return {b, static_cast<size_t>(pos - b)};
+    }
+
+    /// Bare word up to whitespace or punctuation: numbers, node names
+    std::string_view word()
+    {
+        skipSpace();
+        const char* b = pos;
+        while (pos < limit && !isSpace(*pos) && !isPunctuation(*pos))
+            ++pos;
+        return {b, static_cast<size_t>(pos - b)};
+    }
+
+    /// "..." with \" and \\ escapes; out is the raw text between the quotes
+    bool string(std::string_view& out)
+    {
+        skipSpace();
+        if (pos >= limit || *pos != '"')
+            return false;
+        const char* b = ++pos;
+        for (; pos < limit && *pos != '"'; ++pos) {
+            if (*pos == '\\' && pos + 1 < limit)
+                ++pos;
+            if (*pos == '\n')
+                ++line;
+        }
+        if (pos >= limit)
+            return false;
+        out = {b, static_cast<size_t>(pos++ - b)};
+        return true;
+    }
+
+    /// Skip past the statement's ';' (outside strings)
+    void skipStatement()
+    {
+        std::string_view text;
+        while (pos < limit) {
+            if (*pos == '"') {
+                if (!string(text))
+                    return;
+            } else if (*pos++ == ';') {
+                return;
+            } else if (pos[-1] == '\n') {
+                ++line;
+            }
+        }
+    }
+
+    static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+    static bool isIdentifierChar(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+    static bool isPunctuation(char c)
+    {
+        switch (c) {
+        case ':': case ';': case ',': case '|': case '@':
+        case '(': case ')': case '[': case ']': case '"':
+            return true;
+        default:
+            return false;
+        }
+    }
+};
+
+template <typename T>
+static bool toNumber(std::string_view text, T& value)
+{
+    if (!text.empty() && text.front() == '+')
+        text.remove_prefix(1);
+    const char* last = text.data() + text.size();
+    const auto result = std::from_chars(text.data(), last, value);
+    return result.ec == std::errc() && result.ptr == last;
+}
+
+static QString toName(std::string_view text)
+{
+    return QString::fromLatin1(text.data(), static_cast<qsizetype>(text.size()));
+}
+
+static bool sameName(const QString& name, std::string_view text)
+{
+    return name.size() == static_cast<qsizetype>(text.size())
+           && name == QLatin1String(text.data(), static_cast<qsizetype>(text.size()));
+}
+
+static bool isValidUtf8(std::string_view text)
+{
+    for (size_t i = 0; i < text.size();) {
+        const uint8_t c = static_cast<uint8_t>(text[i]);
+        const size_t n = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+        if (n == 0 || i + n > text.size())
+            return false;
+        for (size_t k = 1; k < n; ++k) {
+            if ((static_cast<uint8_t>(text[i + k]) & 0xC0) != 0x80)
+                return false;
+        }
+        i += n;
+    }
+    return true;
+}
+
+/**
+ * @brief Text of a string token: escapes resolved, CRs dropped, decoded as
+ *        UTF-8 or, when that is not valid, Latin-1.
+ */
+static QString toText(std::string_view text)
+{
+    std::string unescaped;
+    if (text.find_first_of("\\\r") != std::string_view::npos) {
+        unescaped.reserve(text.size());
+        for (size_t i = 0; i < text.size(); ++i) {
+            char c = text[i];
+            if (c == '\r')
+                continue;
+            if (c == '\\' && i + 1 < text.size() && (text[i + 1] == '"' || text[i + 1] == '\\'))
+                c = text[++i];
+            unescaped.push_back(c);
+        }
+        text = unescaped;
+    }
+
+    const auto size = static_cast<qsizetype>(text.size());
+    if (std::all_of(text.begin(), text.end(), [](char c) { return static_cast<uint8_t>(c) < 0x80; })
+        || !isValidUtf8(text))
+        return QString::fromLatin1(text.data(), size);
+    return QString::fromUtf8(text.data(), size);
+}
+
+/// DBC message ID (bit 31 = extended) → messageById() key
+static uint32_t messageKey(uint32_t rawId)
+{
+    return (rawId & 0x80000000u) ? (rawId & 0x1FFFFFFFu) : (rawId & 0x7FFu);
+}
+
+/**
+ * @brief The message with rawId among the first defined messages, i.e. the
+ *        one a statement after them refers to.
+ */
+static DBCMessage* messageBefore(DBCDatabase& db, uint32_t rawId, int defined)
+{
+    DBCMessage* msg = db.messageById(messageKey(rawId));
+    if (!msg || msg - db.messages.data() < defined)
+        return msg;
+
+    // The indexed message comes later: an earlier one with the same ID, if any
+    const uint32_t key = msg->id & 0x7FFFFFFF;
+    for (int i = defined - 1; i >= 0; --i) {
+        if ((db.messages[i].id & 0x7FFFFFFF) == key)
+            return &db.messages[i];
+    }
+    return nullptr;
+}
+
+static DBCSignal* findSignal(DBCMessage* msg, std::string_view name)
+{
+    if (!msg)
+        return nullptr;
+    for (auto& sig : msg->signalList) {
+        if (sameName(sig.name, name))
+            return &sig;
+    }
+    return nullptr;
+}
+
+/// Lines starting with these may start a chunk
+static bool isChunkStart(const char* line, const char* end)
+{
+    for (const std::string_view keyword : {"BO_ ", "CM_ ", "VAL_ ", "BA_ "}) {
+        if (static_cast<size_t>(end - line) >= keyword.size()
+            && std::memcmp(line, keyword.data(), keyword.size()) == 0)
+            return true;
+    }
+    return false;
+}
+
+/// First chunk start line from the line start at or after from on (end if none)
+static const char* chunkBoundary(const char* begin, const char* from, const char* end)
+{
+    const char* line = from;
+    if (line > begin && line[-1] != '\n') {
+        const void* nl = std::memchr(line, '\n', static_cast<size_t>(end - line));
+        line = nl ? static_cast<const char*>(nl) + 1 : end;
+    }
+    while (line < end && !isChunkStart(line, end)) {
+        const void* nl = std::memchr(line, '\n', static_cast<size_t>(end - line));
+        line = nl ? static_cast<const char*>(nl) + 1 : end;
+    }
+    return line;
+}
+
+//=============================================================================
+// DBCParser — chunks
+//=============================================================================
+
+/**
+ * @brief A statement referring to a message, signal or node, parsed in its
+ *        chunk and applied once all chunks are merged.
+ */
+struct DBCParser::Reference
+{
+    enum class Kind : uint8_t {
+        MessageComment,
+        SignalComment,
+        NodeComment,
+        ValueDescriptions,
+        SignalValueType,
+        CycleTime,          ///< BA_: applied after the attribute defaults
+        StartValue          ///< BA_
+    };
+
+    Kind             kind     = Kind::MessageComment;
+    uint32_t         rawId    = 0;
+    std::string_view name;              ///< Signal or node (view into the input)
+    int              messages = 0;      ///< Messages defined before the statement
+    int              nodes    = 0;      ///< Nodes defined before the statement
+    QString          text;
+    double           value    = 0.0;    ///< Attribute value or SIG_VALTYPE_ type
+    std::vector<std::pair<int64_t, QString>> descriptions;
+
+    bool isAttribute() const { return kind == Kind::CycleTime || kind == Kind::StartValue; }
+};
+
+struct DBCParser::Chunk
+{
+    const char* begin = nullptr;        ///< Start of the chunk's first line
+    const char* end   = nullptr;        ///< Statements starting before end belong to the chunk
+    const char* stop  = nullptr;        ///< Line after the last statement (past end if it ran over)
+    int         lines = 0;              ///< Newlines from begin to stop
+
+    DBCDatabase db;                     ///< VERSION, BU_, BO_, VAL_TABLE_ (not indexed)
+    bool        hasVersion = false;
+    QHash<QString, QString> attributeDefaults;
+    std::vector<Reference> references;
+    QVector<DBCParseError> errors;      ///< Lines counted from begin
+
+    void addReference(Reference&& ref)
+    {
+        ref.messages = db.messages.size();
+        ref.nodes    = db.nodes.size();
+        references.push_back(std::move(ref));
+    }
+};
+
 //=============================================================================
 // DBCParser implementation
 //=============================================================================
@@ -402,18 +1185,24 @@ DBCDatabase DBCParser::parseFile(const QString& filePath)
     m_errors.clear();
 
     QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!file.open(QIODevice::ReadOnly)) {
         addError(0, QString("Cannot open file: %1").arg(filePath));
         return {};
     }
 
-    QTextStream stream(&file);
-    QString content = stream.readAll();
-    file.close();
-
     DBCDatabase db;
     db.filename = filePath;
-    parse(content, db);
+
+    // Parse straight from the mapped file; read it when it cannot be mapped
+    const qint64 size = file.size();
+    if (uchar* mapped = size > 0 ? file.map(0, size) : nullptr) {
+        parse(reinterpret_cast<const char*>(mapped), static_cast<qsizetype>(size), db);
+        file.unmap(mapped);
+    } else {
+        const QByteArray content = file.readAll();
+        parse(content.constData(), content.size(), db);
+    }
+    file.close();
     return db;
 }
 
@@ -421,7 +1210,8 @@ DBCDatabase DBCParser::parseString(const QString& content)
 {
     m_errors.clear();
     DBCDatabase db;
-    parse(content, db);
+    const QByteArray utf8 = content.toUtf8();
+    parse(utf8.constData(), utf8.size(), db);
     return db;
 }
 
@@ -431,116 +1221,175 @@ void DBCParser::addError(int line, const QString& msg)
     qWarning() << "[DBCParser] Line" << line << ":" << msg;
 }
 
-void DBCParser::parse(const QString& content, DBCDatabase& db)
+void DBCParser::parse(const char* data, qsizetype size, DBCDatabase& db)
 {
-    // Split into lines
-    QStringList lines = content.split('\n');
+    m_attributeDefaults.clear();
+
+    const char* const end = data + size;
+    if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0)
+        data += 3;                          // UTF-8 BOM
+
+    // One chunk per thread, each starting at the first chunk start line of
+    // its share of the input
+    const int threads = m_threadCount > 0 ? m_threadCount : QThread::idealThreadCount();
+    const qsizetype chunkCount = std::clamp<qsizetype>((end - data) / m_minChunkSize, 1, std::max(threads, 1));
+    std::vector<Chunk> chunks(static_cast<size_t>(chunkCount));
+    const char* begin = data;
+    for (qsizetype i = 0; i < chunkCount; ++i) {
+        chunks[i].begin = begin;
+        if (i + 1 < chunkCount)
+            begin = chunkBoundary(data, std::max(begin, data + (end - data) * (i + 1) / chunkCount), end);
+        else
+            begin = end;
+        chunks[i].end = begin;
+    }
 
-    for (int i = 0; i < lines.size(); ++i) {
-        QString line = lines[i].trimmed();
+    if (chunks.size() == 1)
+        parseChunk(chunks.front(), end);
+    else
+        QtConcurrent::blockingMap(chunks, [end](Chunk& chunk) { parseChunk(chunk, end); });
+
+    // Merge in file order
+    int lineOffset = 0;
+    const char* expected = data;
+    for (Chunk& chunk : chunks) {
+        if (chunk.begin != expected) {
+            // The chunk before ran past its end: parse from where it stopped
+            Chunk rest;
+            rest.begin = expected;
+            rest.end   = std::max(chunk.end, expected);
+            parseChunk(rest, end);
+            chunk = std::move(rest);
+        }
+        expected = chunk.stop;
 
-        if (line.isEmpty() || line.startsWith("//"))
-            continue;
+        for (const DBCParseError& error : chunk.errors)
+            addError(lineOffset + error.line, error.message);
+        lineOffset += chunk.lines;
 
-        // VERSION
-        if (line.startsWith("VERSION")) {
-            parseVersion(line, db);
-        }
-        // NS_ (new symbols) — skip
-        else if (line.startsWith("NS_")) {
-            // Skip until next top-level keyword
-            while (i + 1 < lines.size()) {
-                QString nextLine = lines[i + 1].trimmed();
-                if (nextLine.isEmpty() || nextLine.startsWith("BS_") ||
-                    nextLine.startsWith("BU_") || nextLine.startsWith("BO_") ||
-                    nextLine.startsWith("CM_") || nextLine.startsWith("BA_") ||
-                    nextLine.startsWith("VAL_") || nextLine.startsWith("SIG_"))
-                    break;
-                ++i;
-            }
+        for (Reference& ref : chunk.references) {
+            ref.messages += db.messages.size();
+            ref.nodes    += db.nodes.size();
         }
-        // BS_ (bus speed) — skip
-        else if (line.startsWith("BS_")) {
-            // nothing to parse
+        if (chunk.hasVersion)
+            db.version = chunk.db.version;
+        db.nodes.append(chunk.db.nodes);
+        for (DBCMessage& msg : chunk.db.messages) {
+            db.messages.append(std::move(msg));
+            db.indexLastMessage();
         }
-        // BU_ (nodes)
-        else if (line.startsWith("BU_")) {
-            parseNodes(line, db);
-        }
-        // BO_ (message definition)
-        else if (line.startsWith("BO_ ")) {
-            parseMessage(lines, i, db);
-        }
-        // CM_ (comment)
-        else if (line.startsWith("CM_ ")) {
-            parseComment(lines, i, db);
-        }
-        // VAL_TABLE_
-        else if (line.startsWith("VAL_TABLE_ ")) {
-            parseValueTable(lines, i, db);
-        }
-        // VAL_ (value descriptions for signals)
-        else if (line.startsWith("VAL_ ")) {
-            parseValueDescriptions(lines, i, db);
-        }
-        // SIG_VALTYPE_
-        else if (line.startsWith("SIG_VALTYPE_ ")) {
-            parseSignalValueType(line, db);
-        }
-        // BA_DEF_
-        else if (line.startsWith("BA_DEF_ ") || line.startsWith("BA_DEF_DEF_ ")) {
-            parseAttributeDefinition(line, db);
-        }
-        // BA_
-        else if (line.startsWith("BA_ ")) {
-            parseAttributeValue(line, db);
+        for (auto table = chunk.db.valueTables.cbegin(); table != chunk.db.valueTables.cend(); ++table)
+            db.valueTables.insert(table.key(), table.value());
+        for (auto it = chunk.attributeDefaults.cbegin(); it != chunk.attributeDefaults.cend(); ++it)
+            m_attributeDefaults.insert(it.key(), it.value());
+    }
+
+    // Comments, value descriptions and types refer to what was defined before them
+    for (Chunk& chunk : chunks) {
+        for (Reference& ref : chunk.references) {
+            if (!ref.isAttribute())
+                applyReference(ref, db);
         }
     }
 
     // Build the ID->index hash for O(1) lookups
     db.buildIndex();
+
+    // BA_ statements, once all objects and defaults are known
+    applyAttributeDefaults(db);
+    for (Chunk& chunk : chunks) {
+        for (Reference& ref : chunk.references) {
+            if (ref.isAttribute())
+                applyReference(ref, db);
+        }
+    }
 }
 
-void DBCParser::parseVersion(const QString& line, DBCDatabase& db)
+void DBCParser::parseChunk(Chunk& chunk, const char* inputEnd)
+{
+    Cursor in;
+    in.end = inputEnd;
+    in.startLine(chunk.begin);
+    chunk.stop = inputEnd;
+
+    do {
+        if (in.lineStart >= chunk.end) {
+            chunk.stop = in.lineStart;
+            break;
+        }
+
+        // Statements start with their keyword; other lines ("//" comments,
+        // blank lines, unsupported sections) are skipped
+        const std::string_view keyword = in.identifier();
+        if (keyword.empty())
+            continue;
+
+        if (keyword == "BO_") {
+            parseMessage(in, chunk);
+        } else if (keyword == "CM_") {
+            parseComment(in, chunk);
+        } else if (keyword == "BA_") {
+            parseAttributeValue(in, chunk);
+        } else if (keyword == "VAL_") {
+            parseValueDescriptions(in, chunk);
+        } else if (keyword == "VAL_TABLE_") {
+            parseValueTable(in, chunk);
+        } else if (keyword == "SIG_VALTYPE_") {
+            parseSignalValueType(in, chunk);
+        } else if (keyword == "BA_DEF_DEF_") {
+            parseAttributeDefinition(in, chunk);
+        } else if (keyword == "BU_") {
+            parseNodes(in, chunk);
+        } else if (keyword == "VERSION") {
+            parseVersion(in, chunk);
+        } else if (keyword == "NS_") {
+            // New symbols: indented keyword list up to the first unindented line
+            Cursor next = in;
+            while (next.nextLine() && next.pos < next.limit && Cursor::isSpace(*next.pos)
+                   && !next.identifier().empty())
+                in = next;
+        }
+        // BS_, BA_DEF_ (types and ranges), BO_TX_BU_, ... are not needed
+    } while (in.nextLine());
+
+    chunk.lines = in.line - 1;
+}
+
+void DBCParser::parseVersion(Cursor& in, Chunk& chunk)
 {
     // VERSION "1.0"
-    static QRegularExpression re(R"re(VERSION\s+"([^"]*)")re");
-    auto match = re.match(line);
-    if (match.hasMatch()) {
-        db.version = match.captured(1);
+    std::string_view version;
+    if (in.string(version)) {
+        chunk.db.version = toText(version);
+        chunk.hasVersion = true;
     }
 }
 
-void DBCParser::parseNodes(const QString& line, DBCDatabase& db)
+void DBCParser::parseNodes(Cursor& in, Chunk& chunk)
 {
     // BU_ : Node1 Node2 Node3
-    QString rest = line.mid(4).trimmed(); // after "BU_ "
-    if (rest.startsWith(':'))
-        rest = rest.mid(1).trimmed();
-
-    QStringList nodeNames = rest.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-    for (const QString& name : nodeNames) {
+    in.consume(':');
+    for (std::string_view name = in.word(); !name.empty(); name = in.word()) {
         DBCNode node;
-        node.name = name;
-        db.nodes.append(node);
+        node.name = toName(name);
+        chunk.db.nodes.append(node);
     }
 }
 
-void DBCParser::parseMessage(const QStringList& lines, int& index, DBCDatabase& db)
+void DBCParser::parseMessage(Cursor& in, Chunk& chunk)
 {
     // BO_ <CAN-ID> <MessageName>: <MessageLength> <SendingNode>
     // e.g.: BO_ 2024 OBD2: 8 Vector__XXX
-    QString line = lines[index].trimmed();
-
-    static QRegularExpression re(R"(BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+(\w+))");
-    auto match = re.match(line);
-    if (!match.hasMatch()) {
-        addError(index + 1, "Invalid message definition: " + line);
+    uint32_t rawId = 0;
+    uint32_t length = 0;
+    std::string_view name, sender;
+    if (!toNumber(in.word(), rawId) || (name = in.identifier()).empty() || !in.consume(':')
+        || !toNumber(in.word(), length) || (sender = in.identifier()).empty()) {
+        chunk.errors.append({in.line, "Invalid message definition: " + toText(in.lineText())});
         return;
     }
 
     DBCMessage msg;
-    uint32_t rawId = match.captured(1).toUInt();
 
     // In DBC, if bit 31 is set, it's an extended (29-bit) ID
     if (rawId & 0x80000000u) {
@@ -551,26 +1400,18 @@ void DBCParser::parseMessage(const QStringList& lines, int& index, DBCDatabase&
         msg.id = rawId & 0x7FFu;  // standard 11-bit
     }
 
-    msg.name   = match.captured(2);
-    msg.dlc    = match.captured(3).toUInt();
-    msg.sender = match.captured(4);
+    msg.name   = toName(name);
+    msg.dlc    = length;
+    msg.sender = toName(sender);
 
     // Parse signal lines that follow (indented with SG_)
-    while (index + 1 < lines.size()) {
-        QString nextLine = lines[index + 1].trimmed();
-        if (nextLine.startsWith("SG_ ")) {
-            ++index;
-            parseSignal(nextLine, msg);
-        } else {
-            break;
-        }
-    }
+    for (Cursor next = in; next.nextLine() && next.identifier() == "SG_"; in = next)
+        parseSignal(next, msg);
 
-    db.messages.append(msg);
-    db.indexLastMessage();
+    chunk.db.messages.append(msg);
 }
 
-void DBCParser::parseSignal(const QString& line, DBCMessage& msg)
+void DBCParser::parseSignal(Cursor& in, DBCMessage& msg)
 {
     // SG_ <SignalName> [<MuxIndicator>] : <StartBit>|<Length>@<ByteOrder><ValueType>
     //     (<Factor>,<Offset>) [<Min>|<Max>] "<Unit>" <ReceivingNodes>
@@ -579,238 +1420,250 @@ void DBCParser::parseSignal(const QString& line, DBCMessage& msg)
     // SG_ EngineSpeed : 24|16@1+ (0.25,0) [0|16383.75] "rpm" Vector__XXX
     // SG_ MuxSignal M : 0|4@1+ (1,0) [0|15] "" Vector__XXX
     // SG_ MuxedSig m2 : 8|8@1+ (1,0) [0|255] "" Vector__XXX
-
-    static QRegularExpression re(
-        R"(SG_\s+(\w+)\s*)"                           // Signal name
-        R"(([Mm]\d*\s+)?)"                              // Optional mux indicator
-        R"(:\s*(\d+)\|(\d+)@([01])([+-]))"             // start|len@byteorder±
-        R"(\s*\(\s*([^,]+)\s*,\s*([^)]+)\s*\))"        // (factor,offset)
-        R"(\s*\[\s*([^|]+)\|([^\]]+)\s*\])"            // [min|max]
-        R"re(\s*"([^"]*)")re"                             // "unit"
-        R"(\s*(.*))"                                     // receivers
-    );
-
-    auto match = re.match(line);
-    if (!match.hasMatch()) {
-        // Could be a different format, skip silently
-        return;
-    }
+    //
+    // Lines in any other format are skipped silently.
 
     DBCSignal sig;
-    sig.name = match.captured(1);
-
-    // Mux indicator
-    QString muxStr = match.captured(2).trimmed();
-    if (!muxStr.isEmpty()) {
-        sig.muxIndicator = muxStr;
-        if (muxStr == "M") {
-            // This is the multiplexer signal
-        } else if (muxStr.startsWith('m') || muxStr.startsWith('M')) {
-            bool ok;
-            sig.muxValue = muxStr.mid(1).toInt(&ok);
-        }
+    const std::string_view name = in.identifier();
+    if (name.empty())
+        return;
+    sig.name = toName(name);
+
+    // Mux indicator: M (multiplexer), m<N> (multiplexed), m<N>M (both)
+    if (!in.consume(':')) {
+        const std::string_view mux = in.identifier();
+        if ((mux.empty() || (mux.front() != 'M' && mux.front() != 'm')) || !in.consume(':'))
+            return;
+        std::string_view value = mux.substr(1);
+        if (mux.front() == 'm' && value.size() > 1 && value.back() == 'M')
+            value.remove_suffix(1);
+        int muxValue = 0;
+        if (!value.empty() && !toNumber(value, muxValue))
+            return;
+        sig.muxIndicator = toName(mux);
+        if (mux != "M")
+            sig.muxValue = muxValue;
     }
 
-    sig.startBit  = match.captured(3).toUInt();
-    sig.bitLength = match.captured(4).toUInt();
-
-    sig.byteOrder = (match.captured(5) == "0") ? ByteOrder::BigEndian : ByteOrder::LittleEndian;
-    sig.valueType = (match.captured(6) == "-") ? ValueType::Signed : ValueType::Unsigned;
+    if (!toNumber(in.word(), sig.startBit) || !in.consume('|') || !toNumber(in.word(), sig.bitLength)
+        || !in.consume('@'))
+        return;
 
-    sig.factor  = match.captured(7).toDouble();
-    sig.offset  = match.captured(8).toDouble();
-    sig.minimum = match.captured(9).toDouble();
-    sig.maximum = match.captured(10).toDouble();
-    sig.unit    = match.captured(11);
+    const char byteOrder = in.get();
+    const char sign = in.get();
+    if ((byteOrder != '0' && byteOrder != '1') || (sign != '+' && sign != '-'))
+        return;
+    sig.byteOrder = byteOrder == '0' ? ByteOrder::BigEndian : ByteOrder::LittleEndian;
+    sig.valueType = sign == '-' ? ValueType::Signed : ValueType::Unsigned;
+
+    std::string_view unit;
+    if (!in.consume('(') || !toNumber(in.word(), sig.factor) || !in.consume(',')
+        || !toNumber(in.word(), sig.offset) || !in.consume(')')
+        || !in.consume('[') || !toNumber(in.word(), sig.minimum) || !in.consume('|')
+        || !toNumber(in.word(), sig.maximum) || !in.consume(']')
+        || !in.string(unit))
+        return;
+    sig.unit = toText(unit);
 
-    // Receivers
-    QString receiversStr = match.captured(12).trimmed();
-    if (!receiversStr.isEmpty()) {
-        sig.receivers = receiversStr.split(QRegularExpression("[,\\s]+"), Qt::SkipEmptyParts);
+    // Receivers, separated by commas and/or whitespace
+    for (in.consume(','); !in.atLimit(); in.consume(',')) {
+        const std::string_view receiver = in.word();
+        if (receiver.empty())
+            break;
+        sig.receivers.append(toName(receiver));
     }
 
     msg.signalList.append(sig);
 }
 
-void DBCParser::parseComment(const QStringList& lines, int& index, DBCDatabase& db)
+void DBCParser::parseComment(Cursor& in, Chunk& chunk)
 {
-    // CM_ <type> <id> "comment";
-    // Comments can span multiple lines ending with ";
-    QString fullLine = lines[index].trimmed();
-
-    // Accumulate multi-line comment
-    while (!fullLine.endsWith(';') && index + 1 < lines.size()) {
-        ++index;
-        fullLine += "\n" + lines[index];
-    }
-
-    // Remove trailing semicolon
-    if (fullLine.endsWith(';'))
-        fullLine.chop(1);
-
-    // CM_ SG_ <msgId> <sigName> "comment"
-    static QRegularExpression reSig(R"re(CM_\s+SG_\s+(\d+)\s+(\w+)\s+"(.*)")re",
-                                     QRegularExpression::DotMatchesEverythingOption);
-    auto matchSig = reSig.match(fullLine);
-    if (matchSig.hasMatch()) {
-        uint32_t msgId = matchSig.captured(1).toUInt();
-        QString sigName = matchSig.captured(2);
-        QString comment = matchSig.captured(3);
-        // Remove closing quote if present
-        if (comment.endsWith('"'))
-            comment.chop(1);
-
-        // Handle extended ID bit
-        uint32_t lookupId = (msgId & 0x80000000u) ? (msgId & 0x1FFFFFFFu) : (msgId & 0x7FFu);
-        auto* msg = db.messageById(lookupId);
-        if (msg) {
-            auto* sig = msg->signal(sigName);
-            if (sig)
-                sig->comment = comment;
+    // CM_ SG_ <msgId> <sigName> "comment";
+    // CM_ BO_ <msgId> "comment";
+    // CM_ BU_ <nodeName> "comment";
+    // Comments can span multiple lines; network and environment variable
+    // comments are skipped.
+    in.toStatementEnd();
+    const std::string_view object = in.identifier();
+    Reference ref;
+    std::string_view text;
+
+    if (object == "SG_") {
+        ref.kind = Reference::Kind::SignalComment;
+        if (toNumber(in.word(), ref.rawId) && !(ref.name = in.identifier()).empty() && in.string(text)) {
+            ref.text = toText(text);
+            chunk.addReference(std::move(ref));
         }
-        return;
-    }
-
-    // CM_ BO_ <msgId> "comment"
-    static QRegularExpression reMsg(R"re(CM_\s+BO_\s+(\d+)\s+"(.*)")re",
-                                     QRegularExpression::DotMatchesEverythingOption);
-    auto matchMsg = reMsg.match(fullLine);
-    if (matchMsg.hasMatch()) {
-        uint32_t msgId = matchMsg.captured(1).toUInt();
-        QString comment = matchMsg.captured(2);
-        if (comment.endsWith('"'))
-            comment.chop(1);
-
-        uint32_t lookupId = (msgId & 0x80000000u) ? (msgId & 0x1FFFFFFFu) : (msgId & 0x7FFu);
-        auto* msg = db.messageById(lookupId);
-        if (msg)
-            msg->comment = comment;
-        return;
-    }
-
-    // CM_ BU_ <nodeName> "comment"
-    static QRegularExpression reNode(R"re(CM_\s+BU_\s+(\w+)\s+"(.*)")re",
-                                      QRegularExpression::DotMatchesEverythingOption);
-    auto matchNode = reNode.match(fullLine);
-    if (matchNode.hasMatch()) {
-        QString nodeName = matchNode.captured(1);
-        QString comment = matchNode.captured(2);
-        if (comment.endsWith('"'))
-            comment.chop(1);
-        for (auto& node : db.nodes) {
-            if (node.name == nodeName) {
-                node.comment = comment;
-                break;
-            }
+    } else if (object == "BO_") {
+        ref.kind = Reference::Kind::MessageComment;
+        if (toNumber(in.word(), ref.rawId) && in.string(text)) {
+            ref.text = toText(text);
+            chunk.addReference(std::move(ref));
+        }
+    } else if (object == "BU_") {
+        ref.kind = Reference::Kind::NodeComment;
+        if (!(ref.name = in.identifier()).empty() && in.string(text)) {
+            ref.text = toText(text);
+            chunk.addReference(std::move(ref));
         }
-        return;
     }
+    in.skipStatement();
 }
 
-void DBCParser::parseValueDescriptions(const QStringList& lines, int& index, DBCDatabase& db)
+void DBCParser::parseValueDescriptions(Cursor& in, Chunk& chunk)
 {
     // VAL_ <msgId> <sigName> <value> "desc" <value> "desc" ... ;
-    QString fullLine = lines[index].trimmed();
-    while (!fullLine.endsWith(';') && index + 1 < lines.size()) {
-        ++index;
-        fullLine += " " + lines[index].trimmed();
+    // Environment variable descriptions (VAL_ <envVar> ...) are skipped.
+    in.toStatementEnd();
+    Reference ref;
+    ref.kind = Reference::Kind::ValueDescriptions;
+    if (toNumber(in.word(), ref.rawId)) {
+        ref.name = in.identifier();
+        int64_t value = 0;
+        std::string_view text;
+        while (toNumber(in.word(), value) && in.string(text))
+            ref.descriptions.emplace_back(value, toText(text));
+        chunk.addReference(std::move(ref));
     }
-    if (fullLine.endsWith(';'))
-        fullLine.chop(1);
-
-    static QRegularExpression reHead(R"(VAL_\s+(\d+)\s+(\w+)\s+(.*))");
-    auto match = reHead.match(fullLine);
-    if (!match.hasMatch())
-        return;
+    in.skipStatement();
+}
 
-    uint32_t msgId = match.captured(1).toUInt();
-    QString sigName = match.captured(2);
-    QString rest = match.captured(3).trimmed();
+void DBCParser::parseValueTable(Cursor& in, Chunk& chunk)
+{
+    // VAL_TABLE_ <name> <value> "desc" ... ;
+    in.toStatementEnd();
+    const std::string_view name = in.identifier();
+    if (!name.empty()) {
+        QMap<int64_t, QString> table;
+        int64_t value = 0;
+        std::string_view text;
+        while (toNumber(in.word(), value) && in.string(text))
+            table[value] = toText(text);
+        chunk.db.valueTables[toName(name)] = table;
+    }
+    in.skipStatement();
+}
 
-    uint32_t lookupId = (msgId & 0x80000000u) ? (msgId & 0x1FFFFFFFu) : (msgId & 0x7FFu);
-    auto* msg = db.messageById(lookupId);
-    if (!msg)
-        return;
-    auto* sig = msg->signal(sigName);
-    if (!sig)
+void DBCParser::parseSignalValueType(Cursor& in, Chunk& chunk)
+{
+    // SIG_VALTYPE_ <msgId> <sigName> : <type>;
+    // type: 1 = float32, 2 = float64
+    Reference ref;
+    ref.kind = Reference::Kind::SignalValueType;
+    int type = 0;
+    if (!toNumber(in.word(), ref.rawId) || (ref.name = in.identifier()).empty() || !in.consume(':')
+        || !toNumber(in.word(), type) || !in.consume(';'))
         return;
 
-    // Parse value-description pairs: <integer> "string" ...
-    static QRegularExpression rePair(R"re((-?\d+)\s+"([^"]*)")re");
-    auto it = rePair.globalMatch(rest);
-    while (it.hasNext()) {
-        auto m = it.next();
-        int64_t val = m.captured(1).toLongLong();
-        QString desc = m.captured(2);
-        sig->valueDescriptions[val] = desc;
+    if (type == 1 || type == 2) {
+        ref.value = type;
+        chunk.addReference(std::move(ref));
     }
 }
 
-void DBCParser::parseValueTable(const QStringList& lines, int& index, DBCDatabase& db)
+void DBCParser::parseAttributeDefinition(Cursor& in, Chunk& chunk)
 {
-    // VAL_TABLE_ <name> <value> "desc" ... ;
-    QString fullLine = lines[index].trimmed();
-    while (!fullLine.endsWith(';') && index + 1 < lines.size()) {
-        ++index;
-        fullLine += " " + lines[index].trimmed();
-    }
-    if (fullLine.endsWith(';'))
-        fullLine.chop(1);
-
-    static QRegularExpression reHead(R"(VAL_TABLE_\s+(\w+)\s+(.*))");
-    auto match = reHead.match(fullLine);
-    if (!match.hasMatch())
+    // BA_DEF_DEF_ "GenMsgCycleTime" 100;
+    // BA_DEF_ lines (types and ranges) are not needed and skipped.
+    std::string_view name, value;
+    if (!in.string(name))
         return;
+    const bool quoted = in.string(value);
+    if (!quoted)
+        value = in.word();
+    if (in.consume(';'))
+        chunk.attributeDefaults.insert(toName(name), quoted ? toText(value) : toName(value));
+}
 
-    QString tableName = match.captured(1);
-    QString rest = match.captured(2).trimmed();
-
-    QMap<int64_t, QString> table;
-    static QRegularExpression rePair(R"re((-?\d+)\s+"([^"]*)")re");
-    auto it = rePair.globalMatch(rest);
-    while (it.hasNext()) {
-        auto m = it.next();
-        table[m.captured(1).toLongLong()] = m.captured(2);
+void DBCParser::applyAttributeDefaults(DBCDatabase& db)
+{
+    bool ok = false;
+    const int cycleTime = m_attributeDefaults.value("GenMsgCycleTime").toInt(&ok);
+    if (ok) {
+        for (auto& msg : db.messages)
+            msg.cycleTimeMs = cycleTime;
     }
 
-    db.valueTables[tableName] = table;
+    const double startValue = m_attributeDefaults.value("GenSigStartValue").toDouble(&ok);
+    if (ok) {
+        for (auto& msg : db.messages) {
+            for (auto& sig : msg.signalList)
+                sig.initialValue = sig.rawToPhysical(static_cast<int64_t>(startValue));
+        }
+    }
 }
 
-void DBCParser::parseSignalValueType(const QString& line, DBCDatabase& db)
+void DBCParser::parseAttributeValue(Cursor& in, Chunk& chunk)
 {
-    // SIG_VALTYPE_ <msgId> <sigName> : <type>;
-    // type: 1 = float32, 2 = float64
-    static QRegularExpression re(R"(SIG_VALTYPE_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s*;)");
-    auto match = re.match(line);
-    if (!match.hasMatch())
+    // BA_ "GenMsgCycleTime" BO_ 256 100;
+    // BA_ "GenSigStartValue" SG_ 256 EngineSpeed 3200;
+    // Other attributes, and network, node and environment attributes, are skipped.
+    std::string_view name;
+    if (!in.string(name))
+        return;
+    const bool cycleTime = name == "GenMsgCycleTime";
+    if (!cycleTime && name != "GenSigStartValue")
         return;
 
-    uint32_t msgId = match.captured(1).toUInt();
-    QString sigName = match.captured(2);
-    int type = match.captured(3).toInt();
-
-    uint32_t lookupId = (msgId & 0x80000000u) ? (msgId & 0x1FFFFFFFu) : (msgId & 0x7FFu);
-    auto* msg = db.messageById(lookupId);
-    if (!msg) return;
-    auto* sig = msg->signal(sigName);
-    if (!sig) return;
+    Reference ref;
+    ref.kind = cycleTime ? Reference::Kind::CycleTime : Reference::Kind::StartValue;
+    const std::string_view object = in.identifier();
+    if (object != (cycleTime ? "BO_" : "SG_") || !toNumber(in.word(), ref.rawId))
+        return;
+    if (!cycleTime)
+        ref.name = in.identifier();
 
-    if (type == 1)
-        sig->valueType = ValueType::Float32;
-    else if (type == 2)
-        sig->valueType = ValueType::Float64;
+    if (!toNumber(in.word(), ref.value) || !in.consume(';'))
+        return;
+    chunk.addReference(std::move(ref));
 }
 
-void DBCParser::parseAttributeDefinition(const QString& /*line*/, DBCDatabase& /*db*/)
+void DBCParser::applyReference(Reference& ref, DBCDatabase& db)
 {
-    // BA_DEF_ and BA_DEF_DEF_ — store for potential future use
-    // Commonly used for GenMsgCycleTime, GenSigStartValue, etc.
-    // For now, we skip attribute definitions.
-}
+    using Kind = Reference::Kind;
 
-void DBCParser::parseAttributeValue(const QString& /*line*/, DBCDatabase& /*db*/)
-{
-    // BA_ — attribute values; skip for now
+    if (ref.kind == Kind::NodeComment) {
+        for (int i = 0; i < ref.nodes; ++i) {
+            if (sameName(db.nodes[i].name, ref.name)) {
+                db.nodes[i].comment = std::move(ref.text);
+                break;
+            }
+        }
+        return;
+    }
+
+    // Attributes refer to every message, the others to those before them
+    DBCMessage* msg = messageBefore(db, ref.rawId, ref.isAttribute() ? db.messages.size() : ref.messages);
+    if (ref.kind == Kind::MessageComment || ref.kind == Kind::CycleTime) {
+        if (!msg)
+            return;
+        if (ref.kind == Kind::MessageComment)
+            msg->comment = std::move(ref.text);
+        else
+            msg->cycleTimeMs = static_cast<int>(ref.value);
+        return;
+    }
+
+    DBCSignal* sig = findSignal(msg, ref.name);
+    if (!sig)
+        return;
+    switch (ref.kind) {
+    case Kind::SignalComment:
+        sig->comment = std::move(ref.text);
+        break;
+    case Kind::ValueDescriptions:
+        for (auto& [value, text] : ref.descriptions)
+            sig->valueDescriptions[value] = std::move(text);
+        break;
+    case Kind::SignalValueType:
+        sig->valueType = ref.value == 1 ? ValueType::Float32 : ValueType::Float64;
+        break;
+    case Kind::StartValue:
+        sig->initialValue = sig->rawToPhysical(static_cast<int64_t>(ref.value));
+        break;
+    default:
+        break;
+    }
 }
 
 } // namespace DBCManager
@@ -0,0 +1,355 @@
+/**
+ * @file RestBusSimulation.cpp
+ * @brief Implementation of the DBC-driven rest-bus simulation.
+ */
+
+#include "RestBusSimulation.h"
+
+#include <CANManager.h>
+
+#include <QDebug>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+using CANManager::CANBusManager;
+using CANManager::CANMessage;
+using CANManager::CANResult;
+
+namespace DBCManager {
+
+namespace {
+
+/// Sender placeholder used by DBC editors for messages without a node
+const QString NO_SENDER = QStringLiteral("Vector__XXX");
+
+RestBusSimulation::MessageStats messageStats(const DBCMessage& message, int periodMs,
+                                             const CANBusManager::CyclicStats& cyclic)
+{
+    RestBusSimulation::MessageStats stats;
+    stats.name           = message.name;
+    stats.id             = message.id;
+    stats.extended       = message.isExtended;
+    stats.periodMs       = periodMs;
+    stats.sent           = cyclic.sent;
+    stats.missed         = cyclic.missed;
+    stats.errors         = cyclic.errors;
+    stats.maxAbsJitterUs = cyclic.maxAbsJitterUs;
+    return stats;
+}
+
+void addMessage(RestBusSimulation::Stats& stats, const RestBusSimulation::MessageStats& message)
+{
+    stats.sent   += message.sent;
+    stats.missed += message.missed;
+    stats.errors += message.errors;
+    stats.maxAbsJitterUs = std::max(stats.maxAbsJitterUs, message.maxAbsJitterUs);
+    stats.messageStats.append(message);
+}
+
+} // namespace
+
+//=============================================================================
+// RestBusSimulation
+//=============================================================================
+
+RestBusSimulation::RestBusSimulation(std::shared_ptr<const DBCDatabase> database, const Options& options)
+    : m_database(std::move(database))
+    , m_options(options)
+{
+}
+
+RestBusSimulation::~RestBusSimulation()
+{
+    stop();
+}
+
+CANResult RestBusSimulation::compile()
+{
+    m_messages.clear();
+    m_messageIndex.clear();
+    m_skipped = 0;
+
+    for (const QString& node : m_options.nodes) {
+        const bool known = std::any_of(m_database->nodes.cbegin(), m_database->nodes.cend(),
+                                       [&node](const DBCNode& n) { return n.name == node; });
+        if (!known)
+            return CANResult::Failure(QString("Node '%1' is not in the DBC").arg(node));
+    }
+
+    for (const DBCMessage& message : m_database->messages) {
+        if (m_options.nodes.isEmpty() ? (message.sender.isEmpty() || message.sender == NO_SENDER)
+                                      : !m_options.nodes.contains(message.sender))
+            continue;
+        if (m_options.excludedMessages.contains(message.name))
+            continue;
+
+        const int periodMs = message.cycleTimeMs > 0 ? message.cycleTimeMs : m_options.defaultCycleMs;
+        if (periodMs <= 0) {
+            ++m_skipped;
+            continue;
+        }
+
+        CompiledMessage compiled;
+        compiled.message  = &message;
+        compiled.periodMs = periodMs;
+
+        CANMessage& frame = compiled.frame;
+        const int length  = std::min<int>(static_cast<int>(message.dlc), 64);
+        frame.id         = message.id;
+        frame.isExtended = message.isExtended;
+        frame.isFD       = length > 8;
+        frame.isBRS      = frame.isFD;
+        frame.dlc        = CANManager::lengthToDlc(length);
+
+        for (const DBCSignal& sig : message.signalList) {
+            compiled.signalIndex.insert(sig.name, &sig);
+            if (sig.muxIndicator == "M")
+                compiled.multiplexor = &sig;
+        }
+
+        // Start values; multiplexed signals only for the multiplexor's start page
+        const int64_t page = compiled.multiplexor
+                                 ? compiled.multiplexor->physicalToRaw(compiled.multiplexor->initialValue)
+                                 : -1;
+        for (const DBCSignal& sig : message.signalList) {
+            if (sig.muxValue < 0 || sig.muxValue == page)
+                sig.encode(sig.initialValue, frame.data, frame.dataLength());
+        }
+        compiled.initial = frame;
+
+        m_messageIndex.insert(message.name, static_cast<int>(m_messages.size()));
+        m_messages.push_back(std::move(compiled));
+    }
+
+    if (m_messages.empty())
+        return CANResult::Failure(m_skipped > 0
+                                      ? QString("None of the %1 selected messages has a cycle time").arg(m_skipped)
+                                      : QString("No messages sent by the selected nodes"));
+    return CANResult::Success();
+}
+
+CANResult RestBusSimulation::start()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_running)
+        return CANResult::Failure("Rest-bus simulation already running");
+
+    auto result = compile();
+    if (!result.success)
+        return result;
+
+    auto& can = CANBusManager::instance();
+    for (size_t i = 0; i < m_messages.size(); ++i) {
+        const CompiledMessage& compiled = m_messages[i];
+
+        // Stagger first transmissions so equal periods spread over the wheel
+        const int offsetMs = static_cast<int>(i % static_cast<size_t>(compiled.periodMs));
+        result = can.startCyclic(m_options.slot, compiled.frame, compiled.periodMs, offsetMs);
+        if (!result.success) {
+            for (size_t j = 0; j < i; ++j)
+                can.stopCyclic(m_options.slot, m_messages[j].frame.id, m_messages[j].frame.isExtended);
+            return CANResult::Failure(QString("%1: %2").arg(compiled.message->name, result.errorMessage));
+        }
+    }
+    m_running = true;
+
+    qDebug() << "[RestBus]" << m_options.slot << "simulating" << m_messages.size() << "messages"
+             << "of" << (m_options.nodes.isEmpty() ? QStringList{"all nodes"} : m_options.nodes)
+             << "(" << m_skipped << "without cycle time skipped)";
+    return CANResult::Success();
+}
+
+void RestBusSimulation::stop(Stats* stats)
+{
+    QMutexLocker locker(&m_mutex);
+    if (stats) {
+        *stats = Stats{};
+        stats->slot     = m_options.slot;
+        stats->messages = static_cast<int>(m_messages.size());
+        stats->skipped  = m_skipped;
+        stats->signalUpdates = m_signalUpdates;
+    }
+    if (!m_running)
+        return;
+
+    auto& can = CANBusManager::instance();
+    for (const CompiledMessage& compiled : m_messages) {
+        CANBusManager::CyclicStats cyclic;
+        can.stopCyclic(m_options.slot, compiled.frame.id, compiled.frame.isExtended, &cyclic);
+        if (stats)
+            addMessage(*stats, messageStats(*compiled.message, compiled.periodMs, cyclic));
+    }
+    m_running = false;
+
+    qDebug() << "[RestBus]" << m_options.slot << "stopped";
+}
+
+CANResult RestBusSimulation::setSignal(const QString& message, const QString& signal, double value)
+{
+    return setSignals(message, {{signal, value}});
+}
+
+CANResult RestBusSimulation::setSignals(const QString& message, const QMap<QString, double>& values)
+{
+    QMutexLocker locker(&m_mutex);
+    const int index = m_messageIndex.value(message, -1);
+    if (index < 0)
+        return CANResult::Failure(QString("Message '%1' is not simulated").arg(message));
+    return applyLocked(m_messages[index], values);
+}
+
+CANResult RestBusSimulation::applyLocked(CompiledMessage& compiled, const QMap<QString, double>& values)
+{
+    // Check every name first so a typo leaves the payload untouched
+    for (auto it = values.cbegin(); it != values.cend(); ++it) {
+        if (!compiled.signalIndex.contains(it.key()))
+            return CANResult::Failure(QString("Signal '%1' is not in %2").arg(it.key(), compiled.message->name));
+    }
+
+    CANMessage& frame = compiled.frame;
+    const int length = frame.dataLength();
+    for (auto it = values.cbegin(); it != values.cend(); ++it) {
+        const DBCSignal* sig = compiled.signalIndex.value(it.key());
+        sig->encode(it.value(), frame.data, length);
+        if (sig->muxValue >= 0 && compiled.multiplexor)
+            compiled.multiplexor->setRawValue(sig->muxValue, frame.data, length);
+    }
+    m_signalUpdates += static_cast<uint64_t>(values.size());
+
+    return m_running ? CANBusManager::instance().updateCyclic(m_options.slot, frame)
+                     : CANResult::Success();
+}
+
+CANResult RestBusSimulation::resetSignals(const QString& message)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!message.isEmpty() && !m_messageIndex.contains(message))
+        return CANResult::Failure(QString("Message '%1' is not simulated").arg(message));
+
+    for (CompiledMessage& compiled : m_messages) {
+        if (!message.isEmpty() && compiled.message->name != message)
+            continue;
+        compiled.frame = compiled.initial;
+        if (m_running) {
+            auto result = CANBusManager::instance().updateCyclic(m_options.slot, compiled.frame);
+            if (!result.success)
+                return result;
+        }
+    }
+    return CANResult::Success();
+}
+
+bool RestBusSimulation::frame(const QString& message, CANMessage& frame) const
+{
+    QMutexLocker locker(&m_mutex);
+    const int index = m_messageIndex.value(message, -1);
+    if (index < 0)
+        return false;
+    frame = m_messages[index].frame;
+    return true;
+}
+
+QStringList RestBusSimulation::messageNames() const
+{
+    QMutexLocker locker(&m_mutex);
+    QStringList names;
+    for (const CompiledMessage& compiled : m_messages)
+        names.append(compiled.message->name);
+    return names;
+}
+
+RestBusSimulation::Stats RestBusSimulation::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats stats;
+    collectStatsLocked(stats);
+    return stats;
+}
+
+void RestBusSimulation::collectStatsLocked(Stats& stats) const
+{
+    stats.slot     = m_options.slot;
+    stats.running  = m_running;
+    stats.messages = static_cast<int>(m_messages.size());
+    stats.skipped  = m_skipped;
+    stats.signalUpdates = m_signalUpdates;
+    if (!m_running)
+        return;
+
+    const auto& can = CANBusManager::instance();
+    for (const CompiledMessage& compiled : m_messages) {
+        CANBusManager::CyclicStats cyclic;
+        can.cyclicStats(m_options.slot, compiled.frame.id, compiled.frame.isExtended, cyclic);
+        addMessage(stats, messageStats(*compiled.message, compiled.periodMs, cyclic));
+    }
+}
+
+//=============================================================================
+// RestBusManager
+//=============================================================================
+
+RestBusManager& RestBusManager::instance()
+{
+    // Construct the CAN manager first so it is destroyed after the simulations
+    CANBusManager::instance();
+    static RestBusManager inst;
+    return inst;
+}
+
+RestBusManager::~RestBusManager()
+{
+    stopAll();
+}
+
+CANResult RestBusManager::start(const RestBusSimulation::Options& options,
+                                std::shared_ptr<const DBCDatabase> database)
+{
+    if (!database || database->isEmpty())
+        return CANResult::Failure("No DBC loaded");
+
+    QMutexLocker locker(&m_mutex);
+    if (m_simulations.count(options.slot))
+        return CANResult::Failure(QString("Rest-bus simulation already running on '%1'").arg(options.slot));
+
+    auto simulation = std::make_shared<RestBusSimulation>(std::move(database), options);
+    auto result = simulation->start();
+    if (result.success)
+        m_simulations.emplace(options.slot, std::move(simulation));
+    return result;
+}
+
+CANResult RestBusManager::stop(const QString& slot, RestBusSimulation::Stats* stats)
+{
+    std::shared_ptr<RestBusSimulation> simulation;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_simulations.find(slot);
+        if (it == m_simulations.end())
+            return CANResult::Failure(QString("No rest-bus simulation on '%1'").arg(slot));
+        simulation = std::move(it->second);
+        m_simulations.erase(it);
+    }
+    simulation->stop(stats);
+    return CANResult::Success();
+}
+
+void RestBusManager::stopAll()
+{
+    std::map<QString, std::shared_ptr<RestBusSimulation>> simulations;
+    {
+        QMutexLocker locker(&m_mutex);
+        simulations.swap(m_simulations);
+    }
+    for (auto& [slot, simulation] : simulations)
+        simulation->stop();
+}
+
+std::shared_ptr<RestBusSimulation> RestBusManager::simulation(const QString& slot) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_simulations.find(slot);
+    return it != m_simulations.end() ? it->second : nullptr;
+}
+
+} // namespace DBCManager
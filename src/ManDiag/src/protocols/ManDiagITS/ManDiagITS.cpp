@@ -5,6 +5,7 @@
 
 #include "protocols/ManDiagITS/ManDiagITS.h"
 #include "CommandRegistry.h"
+#include "Station.h"
 #include <SerialManager.h>
 #include <QDebug>
 #include <QElapsedTimer>
@@ -26,7 +27,8 @@ struct VariableExpectation {
 
 ITSResult sendAndReceiveSerial(const QByteArray& requestBytes, const ITSConfig& config)
 {
-    auto& serial = SerialPortManager::instance();
+    // The ports of the station whose step is running on this thread
+    auto& serial = TestExecutor::Station::current().serial();
 
     if (!serial.isPortOpen(config.portName)) {
         const SerialResult openResult = serial.openPort(config.portName);
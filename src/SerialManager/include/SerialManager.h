@@ -110,10 +110,16 @@ class SerialPortManager : public QObject
 
 public:
     /**
-     * @brief Get the singleton instance
+     * @brief Get the singleton instance (the default test station's ports)
      */
     static SerialPortManager& instance();
 
+    /**
+     * @brief Separate manager, e.g. for an additional test station
+     */
+    SerialPortManager();
+    ~SerialPortManager() override;
+
     // === Port Configuration ===
     
     /**
@@ -281,8 +287,6 @@ signals:
     void errorOccurred(const QString& portName, const QString& error);
 
 private:
-    SerialPortManager();
-    ~SerialPortManager() override;
     SerialPortManager(const SerialPortManager&) = delete;
     SerialPortManager& operator=(const SerialPortManager&) = delete;
 
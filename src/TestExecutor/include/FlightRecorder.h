@@ -0,0 +1,180 @@
+#pragma once
+/**
+ * @file FlightRecorder.h
+ * @brief Pre-trigger capture of CAN and serial traffic around step failures.
+ *
+ * While running, the FlightRecorder keeps the most recent traffic of every
+ * open CAN slot and every serial port in fixed-size rings (FlightRing), so
+ * memory stays bounded however long a run lasts. Capturing is lock-free:
+ * CAN frames are copied on the slot's dispatcher thread through a tap,
+ * serial bytes on the thread that sent or read them.
+ *
+ * trigger() (called by TestExecutorEngine when a step fails) returns a
+ * folder name at once and dumps the window from preTriggerMs before to
+ * postTriggerMs after the trigger into it in the background:
+ *   - "<slot>.asc"  one Vector ASC file per CAN slot
+ *   - "<port>.log"  one text log per serial port
+ *
+ * How far back a dump reaches is limited by the ring size: a busy bus may
+ * overwrite the start of the window before the dump runs.
+ *
+ * The recorder is shared by every station. Sessions use acquire()/release()
+ * so one station never stops or restarts it under another one's run.
+ */
+
+#include "FlightRing.h"
+
+#include <AtomicSharedPtr.h>
+#include <CANInterface.h>
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <deque>
+#include <map>
+#include <memory>
+
+namespace TestExecutor {
+
+class FlightRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Serial bytes stored per ring entry; longer transfers take several entries
+    static constexpr int SERIAL_CHUNK_BYTES = 64;
+
+    struct Options
+    {
+        int preTriggerMs  = 10000;          ///< Window before the trigger
+        int postTriggerMs = 2000;           ///< Window after the trigger
+        int canFramesPerSlot     = 65536;   ///< Ring size per CAN slot (~6 MB)
+        int serialChunksPerPort  = 16384;   ///< Ring size per serial port (~1.3 MB)
+    };
+
+    static FlightRecorder& instance();
+
+    /**
+     * @brief Start capturing every open CAN slot and any slot opened later.
+     * Restarting with new options discards what was captured so far.
+     */
+    void start(const Options& options);
+
+    /** @brief Write pending dumps with what is available, then free all rings. */
+    void stop();
+
+    /**
+     * @brief Use the recorder for a session (start it if needed).
+     *
+     * @p options only apply while no other session uses the recorder:
+     * restarting would discard its history and flush its pending dumps.
+     */
+    void acquire(const Options& options);
+
+    /** @brief End a session's use; capturing continues for the next session. */
+    void release();
+
+    /** @brief stop() unless a session uses the recorder or a dump is pending. */
+    void stopIfUnused();
+
+    bool    isRunning() const;
+    Options options() const;
+
+    /**
+     * @brief Dump the window around now into outputDir (created if needed).
+     *
+     * Returns immediately; files appear once postTriggerMs has passed.
+     * @return outputDir, or an empty string if not running.
+     */
+    QString trigger(const QString& outputDir);
+
+    /** @brief Wait until every triggered dump has been written. */
+    bool waitForDumps(int timeoutMs = -1);
+
+    /** @brief Wait until the dumps into @p outputDirs have been written. */
+    bool waitForDumps(const QStringList& outputDirs, int timeoutMs = -1);
+
+    // === Capture ===
+
+    /** @brief Record serial traffic (ignored unless running). */
+    void recordSerial(const QString& portName, bool transmitted, const QByteArray& data);
+
+    /** @brief Start capturing a CAN slot (done automatically for slots opened while running). */
+    void attachSlot(const QString& slotName);
+
+    /** @brief Detach from a closed slot; what it captured stays available for dumps. */
+    void detachSlot(const QString& slotName);
+
+private:
+    struct CanEntry
+    {
+        qint64 captureNs = 0;           ///< Recorder clock when the batch was tapped
+        CANManager::CANMessage msg;
+    };
+
+    struct SerialEntry
+    {
+        qint64  captureNs = 0;
+        bool    transmitted = false;
+        uint8_t length = 0;
+        char    data[SERIAL_CHUNK_BYTES];
+    };
+
+    using CanRing     = FlightRing<CanEntry>;
+    using SerialRing  = FlightRing<SerialEntry>;
+    using SerialTable = std::map<QString, std::shared_ptr<SerialRing>>;
+
+    class SlotTap;
+
+    struct Dump
+    {
+        QString outputDir;
+        qint64  triggerNs = 0;
+    };
+
+    FlightRecorder();
+    ~FlightRecorder() override;
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    bool dumpPendingLocked(const QStringList& outputDirs) const;
+    void run();
+    void writeDump(const Dump& dump);
+    void writeCanDump(const QString& path, const QString& slotName, CanRing& ring,
+                      qint64 fromNs, qint64 toNs);
+    void writeSerialDump(const QString& path, const QString& portName, SerialRing& ring,
+                         qint64 fromNs, qint64 toNs);
+    std::shared_ptr<SerialRing> serialRing(const QString& portName);
+    static QString fileNameFor(const QString& sourceName, const QString& suffix);
+
+    QElapsedTimer m_clock;              ///< Capture clock (started once, read lock-free)
+    QDateTime     m_clockStart;         ///< Wall-clock time of m_clock == 0
+
+    /// Port name → ring, read without locking by recordSerial(); null while stopped
+    CANManager::AtomicSharedPtr<const SerialTable> m_serialTable;
+
+    mutable QMutex m_mutex;             ///< Guards everything below; never taken per frame
+    QWaitCondition m_wake;              ///< Dump queued or stop requested
+    QWaitCondition m_idle;              ///< A dump written or the queue drained
+    Options m_options;
+    bool    m_running  = false;
+    bool    m_stopping = false;
+    bool    m_writing  = false;         ///< A dump is being written
+    QString m_writingDir;               ///< Its output folder
+    std::map<QString, std::shared_ptr<CanRing>>    m_canRings;
+    std::map<QString, std::shared_ptr<SlotTap>>    m_taps;
+    std::deque<Dump> m_pending;
+    QThread* m_thread = nullptr;
+
+    QMutex m_useMutex;                  ///< Serializes acquire() / release() / stopIfUnused()
+    int    m_users = 0;                 ///< Sessions between acquire() and release()
+};
+
+} // namespace TestExecutor
@@ -0,0 +1,110 @@
+#pragma once
+/**
+ * @file FlightRing.h
+ * @brief Fixed-size, lock-free, overwrite-oldest ring for the flight recorder.
+ *
+ * Unlike CANManager::SpscRing this ring never refuses a write: once full,
+ * every new entry replaces the oldest one, so it always holds the most
+ * recent capacity() entries and its memory never grows.
+ *
+ * Rules:
+ *   - write() is wait-free and may be called from several threads; entries
+ *     from concurrent writers are interleaved, never torn, as long as fewer
+ *     than capacity() entries are in flight at once
+ *   - snapshot() may only be called from one thread at a time. It freezes
+ *     the ring for the duration of one copy; writes arriving meanwhile are
+ *     dropped and counted in missed()
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace TestExecutor {
+
+template <typename T>
+class FlightRing
+{
+public:
+    /**
+     * @brief Create a ring holding at least @p minCapacity entries.
+     * The capacity is rounded up to the next power of two.
+     */
+    explicit FlightRing(size_t minCapacity)
+    {
+        size_t cap = 2;
+        while (cap < minCapacity)
+            cap <<= 1;
+        m_mask   = cap - 1;
+        m_buffer = std::make_unique<T[]>(cap);
+    }
+
+    FlightRing(const FlightRing&) = delete;
+    FlightRing& operator=(const FlightRing&) = delete;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    /**
+     * @brief Append count entries; fill(entry, i) fills the i-th one in place.
+     * Only the last capacity() entries of an oversized write are kept.
+     */
+    template <typename Fill>
+    void write(size_t count, Fill&& fill)
+    {
+        if (count == 0)
+            return;
+
+        // Announce the writer before checking the freeze flag (pairs with snapshot())
+        m_writers.fetch_add(1, std::memory_order_seq_cst);
+        if (m_frozen.load(std::memory_order_seq_cst)) {
+            m_missed.fetch_add(count, std::memory_order_relaxed);
+            m_writers.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+
+        const size_t first = count > capacity() ? count - capacity() : 0;
+        const size_t head  = m_head.fetch_add(count - first, std::memory_order_relaxed);
+        for (size_t i = first; i < count; ++i)
+            fill(m_buffer[(head + i - first) & m_mask], i);
+
+        m_writers.fetch_sub(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copy the ring contents, oldest first, into @p out (replaced).
+     * @return Total number of entries ever written (out.size() is at most capacity()).
+     */
+    size_t snapshot(std::vector<T>& out)
+    {
+        m_frozen.store(true, std::memory_order_seq_cst);
+        while (m_writers.load(std::memory_order_seq_cst) != 0)
+            std::this_thread::yield();
+
+        const size_t head  = m_head.load(std::memory_order_relaxed);
+        const size_t count = head < capacity() ? head : capacity();
+        out.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            out[i] = m_buffer[(head - count + i) & m_mask];
+
+        m_frozen.store(false, std::memory_order_release);
+        return head;
+    }
+
+    /** @brief Entries dropped because they arrived during a snapshot. */
+    size_t missed() const { return m_missed.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    alignas(CACHE_LINE) std::atomic<size_t> m_head{0};
+    alignas(CACHE_LINE) std::atomic<int>    m_writers{0};
+    std::atomic<bool>   m_frozen{false};
+    std::atomic<size_t> m_missed{0};
+
+    alignas(CACHE_LINE) size_t m_mask = 0;
+    std::unique_ptr<T[]> m_buffer;
+};
+
+} // namespace TestExecutor
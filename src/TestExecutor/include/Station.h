@@ -0,0 +1,183 @@
+#pragma once
+/**
+ * @file Station.h
+ * @brief Test stations: one DUT each, several per process.
+ *
+ * A Station bundles what one fixture needs to run its own test session:
+ * - TestExecutorEngine (own worker thread, own session and report)
+ * - HWConfigManager (own QSettings group)
+ * - SerialPortManager (own open ports)
+ * - CAN slots, namespaced on the process-wide CANBusManager
+ *
+ * The default station wraps the existing singletons, so single-DUT setups
+ * and settings are unchanged. The command registry, test repository, DBC
+ * databases and flight recorder are shared by all stations.
+ */
+
+#include <QObject>
+#include <QMutex>
+#include <QStringList>
+#include <memory>
+#include <vector>
+
+class HWConfigManager;
+
+namespace SerialManager {
+class SerialPortManager;
+}
+
+namespace TestExecutor {
+
+class TestExecutorEngine;
+
+//=============================================================================
+// Station
+//=============================================================================
+
+/**
+ * @brief One test station.
+ *
+ * Command handlers reach the station they run for through Station::current():
+ * @code
+ * auto& serial = Station::current().serial();
+ * QString slot = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+ * @endcode
+ */
+class Station
+{
+public:
+    /// Name of the station built on the process-wide singletons
+    static const QString DEFAULT_NAME;
+
+    ~Station();
+
+    Station(const Station&) = delete;
+    Station& operator=(const Station&) = delete;
+
+    QString name() const { return m_name; }
+    bool isDefault() const { return !m_engine; }
+
+    TestExecutorEngine& engine() const;
+    HWConfigManager& hwConfig() const;
+    SerialManager::SerialPortManager& serial() const;
+
+    /**
+     * @brief Process-wide name of one of this station's resources.
+     *
+     * "CAN 1" on "Station 2" is "Station 2/CAN 1"; the default station's
+     * names are used unchanged.
+     */
+    QString qualifiedName(const QString& localName) const;
+
+    /** @brief CANBusManager slot name of one of this station's CAN slots. */
+    QString canSlot(const QString& localName) const { return qualifiedName(localName); }
+
+    /** @brief Open CAN slots of this station, by local name. */
+    QStringList openCanSlots() const;
+
+    /** @brief Close this station's CAN slots and serial ports. */
+    void closeHardware();
+
+    /**
+     * @brief Station whose test step runs on the calling thread.
+     *
+     * The default station on threads outside a Scope.
+     */
+    static Station& current();
+
+    /**
+     * @brief Makes a station current on this thread for the scope's lifetime.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(Station& station);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Station* m_previous;
+    };
+
+private:
+    friend class StationManager;
+
+    /// Default station
+    Station();
+    /// Station with hardware and engine of its own
+    explicit Station(const QString& name);
+
+    QString m_name;
+    std::unique_ptr<SerialManager::SerialPortManager> m_serial;
+    std::unique_ptr<HWConfigManager> m_hwConfig;
+    std::unique_ptr<TestExecutorEngine> m_engine;   ///< Destroyed first
+};
+
+//=============================================================================
+// StationManager
+//=============================================================================
+
+/**
+ * @brief Owns the stations and tracks the one shown in the UI.
+ *
+ * Station names are persisted in QSettings ("Stations/names"); each
+ * station's hardware config lives under "Stations/<name>/HWConfig".
+ */
+class StationManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    static StationManager& instance();
+
+    Station& defaultStation() { return *m_default; }
+
+    /**
+     * @brief Create a station and load its hardware config.
+     * @return nullptr if the name is empty, contains '/' or is taken
+     */
+    Station* addStation(const QString& name);
+
+    /**
+     * @brief Close and delete a station.
+     * @return false for the default station, unknown names and running stations
+     */
+    bool removeStation(const QString& name);
+
+    /** @brief Station by name, nullptr if unknown. */
+    Station* station(const QString& name);
+
+    /** @brief All station names, default station first. */
+    QStringList stationNames() const;
+
+    // === UI Selection ===
+
+    Station& selectedStation();
+    void selectStation(const QString& name);
+
+    // === Persistence ===
+
+    /** @brief Recreate the stations saved by save(). */
+    void load();
+    void save() const;
+
+signals:
+    void stationAdded(const QString& name);
+    void stationRemoved(const QString& name);
+    void selectedStationChanged(const QString& name);
+
+private:
+    StationManager();
+    ~StationManager() override;
+    StationManager(const StationManager&) = delete;
+    StationManager& operator=(const StationManager&) = delete;
+
+    std::unique_ptr<Station> m_default;
+    std::vector<std::unique_ptr<Station>> m_stations;   ///< Additional stations, in creation order
+    QString m_selected;
+    mutable QMutex m_mutex;                             ///< Guards m_stations and m_selected
+};
+
+} // namespace TestExecutor
@@ -95,6 +95,7 @@ struct TestStep
     QString resultMessage;          ///< Result/error message
     qint64 durationMs = 0;          ///< Execution duration in milliseconds
     QVariantMap responseData;       ///< Data returned by the command
+    QString flightRecordPath;       ///< Flight recorder capture folder (failed steps only)
     
     // Serialization
     QJsonObject toJson() const;
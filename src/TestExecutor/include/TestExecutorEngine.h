@@ -7,7 +7,10 @@
  * - Runs test cases sequentially or selectively
  * - Emits signals for UI updates (progress, step completion)
  * - Manages communication interfaces (Serial, CAN)
+ * - Dumps the flight recorder's CAN/serial capture when a step fails
  * - Handles test flow control (stop, pause, resume)
+ *
+ * Each Station has its own engine; instance() is the default station's.
  */
 
 #include "TestDataModels.h"
@@ -21,6 +24,8 @@
 
 namespace TestExecutor {
 
+class Station;
+
 //=============================================================================
 // ExecutorState
 //=============================================================================
@@ -78,6 +83,11 @@ struct TestConfiguration
     QString reportTemplate = "default";
     bool autoGenerateReport = true;
     
+    // Flight Recorder Settings (CAN/serial capture dumped on step failure)
+    bool flightRecorderEnabled = true;
+    int flightRecorderPreTriggerS = 10;
+    int flightRecorderPostTriggerS = 2;
+    
     // Convert to/from QVariantMap for command handlers
     QVariantMap toVariantMap() const;
     static TestConfiguration fromVariantMap(const QVariantMap& map);
@@ -114,10 +124,21 @@ class TestExecutorEngine : public QObject
 
 public:
     /**
-     * @brief Get the singleton instance
+     * @brief Get the default station's engine
      */
     static TestExecutorEngine& instance();
 
+    /**
+     * @brief Engine of an additional station (see StationManager)
+     */
+    explicit TestExecutorEngine(Station& station);
+    ~TestExecutorEngine() override;
+
+    /**
+     * @brief Station this engine runs tests for
+     */
+    Station& station() const;
+
     // === Configuration ===
     
     /**
@@ -145,12 +166,16 @@ public:
     /**
      * @brief Get current engine state
      */
-    ExecutorState state() const { return m_state; }
+    ExecutorState state() const { return m_state.load(); }
     
     /**
      * @brief Check if engine is running
      */
-    bool isRunning() const { return m_state == ExecutorState::Running || m_state == ExecutorState::Paused; }
+    bool isRunning() const
+    {
+        const ExecutorState state = m_state.load();
+        return state == ExecutorState::Running || state == ExecutorState::Paused;
+    }
     
     /**
      * @brief Get current session (may be null)
@@ -264,21 +289,29 @@ private slots:
 
 private:
     TestExecutorEngine();
-    ~TestExecutorEngine() override;
     TestExecutorEngine(const TestExecutorEngine&) = delete;
     TestExecutorEngine& operator=(const TestExecutorEngine&) = delete;
 
     void setState(ExecutorState state);
     TestResult executeTestCase(const TestCase& testCase);
     TestStep executeStep(const TestStep& step, int stepIndex, const QString& testCaseId);
+    void startFlightRecorder();
+    void releaseFlightRecorder();
+    void captureFailure(TestStep& stepResult, int stepIndex, const QString& testCaseId);
+    QString sessionOutputDir();
     void initializeCommunication();
     void cleanupCommunication();
     void syncFromHWConfig();
+    void connectSerialCapture();
 
+    Station* m_station = nullptr;   ///< nullptr for the default station
     TestConfiguration m_config;
-    ExecutorState m_state = ExecutorState::Idle;
+    std::atomic<ExecutorState> m_state{ExecutorState::Idle};  ///< Written by the worker, read by the UI
     std::unique_ptr<TestSession> m_currentSession;
     QStringList m_pendingTestIds;
+    QString m_sessionOutputDir;     ///< Folder for files captured during the session
+    QStringList m_flightRecordPaths;    ///< Dumps triggered during the session
+    std::atomic<bool> m_flightRecorderAcquired{false};  ///< Holds a FlightRecorder::acquire()
     
     QThread* m_workerThread = nullptr;
     QMutex m_mutex;
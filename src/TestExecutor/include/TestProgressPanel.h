@@ -9,6 +9,7 @@
  * - Export results to HTML report
  * - Live log viewer
  * - Execution controls (Run, Pause, Stop)
+ * - Station selector (shows the engine of the selected test station)
  */
 
 #include "TestDataModels.h"
@@ -18,6 +19,7 @@
 #include <QPlainTextEdit>
 #include <QProgressBar>
 #include <QPushButton>
+#include <QComboBox>
 #include <QLabel>
 #include <QSplitter>
 #include <QTimer>
@@ -26,6 +28,7 @@
 namespace TestExecutor {
 
 enum class ExecutorState : int;
+class TestExecutorEngine;
 
 //=============================================================================
 // TestProgressPanel
@@ -108,11 +111,15 @@ private slots:
     void onClearClicked();
     void onResultTableDoubleClicked(int row, int column);
     void updateElapsedTime();
+    void onStationSelected(int index);
+    void onSelectedStationChanged(const QString& name);
+    void refreshStations();
 
 private:
     void setupUi();
     void setupConnections();
     void connectToEngine();
+    void disconnectFromEngine();
     void updateSummary();
     void setRowStatus(int row, TestStatus status);
     int findRowByTestId(const QString& testCaseId) const;
@@ -133,8 +140,11 @@ private:
     QPushButton* m_btnStop = nullptr;
     QPushButton* m_btnExport = nullptr;
     QPushButton* m_btnClear = nullptr;
+    QLabel* m_stationLabel = nullptr;
+    QComboBox* m_stationCombo = nullptr;
     
     // === State ===
+    TestExecutorEngine* m_engine = nullptr;     ///< Engine of the selected station
     TestSession m_session;
     QTimer* m_elapsedTimer = nullptr;
     QElapsedTimer m_elapsed;
@@ -8,6 +8,7 @@
  * - Detailed results table with all columns
  * - Collapsible test details
  * - Requirement and JIRA links
+ * - Links to flight recorder captures of failing steps
  * - Execution timestamps and durations
  * - Styling consistent with automotive industry standards
  */
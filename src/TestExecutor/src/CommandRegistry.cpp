@@ -13,14 +13,19 @@
  */
 
 #include "CommandRegistry.h"
+#include "Station.h"
 #include <SerialManager.h>
 #include <CANManager.h>
 #include <CANInterface.h>
+#include <CANIsoTpChannel.h>
+#include <DBCManager.h>
+#include <RestBusSimulation.h>
+#include <UdsFlashImage.h>
+#include <UdsFlashProgrammer.h>
 #include <QDateTime>
 #include <QDebug>
 #include <QThread>
 #include <QRegularExpression>
-#include <QElapsedTimer>
 
 using namespace SerialManager;
 
@@ -445,7 +450,7 @@ void CommandRegistry::registerSerialCommands()
             qDebug() << "Serial Send - Port:" << port << "Data:" << dataString;
             
             // Get SerialManager singleton - uses existing connection if port is open
-            auto& serialMgr = SerialPortManager::instance();
+            auto& serialMgr = Station::current().serial();
             
             // Send data - SerialManager will auto-open port using stored config if not open
             SerialResult result = serialMgr.send(port, dataString);
@@ -518,7 +523,7 @@ void CommandRegistry::registerSerialCommands()
                      << "Timeout:" << timeoutMs << "ms";
             
             // Get SerialManager singleton - uses existing connection if port is open
-            auto& serialMgr = SerialPortManager::instance();
+            auto& serialMgr = Station::current().serial();
             
             // Send data and wait for matching response
             SerialResult result = serialMgr.sendAndMatchResponse(
@@ -577,35 +582,6 @@ static CANManager::CANMessage buildCANMessage(const QVariantMap& params, bool is
     return msg;
 }
 
-/**
- * @brief Helper: Receive a CAN response matching a specific ID within timeout.
- * Flushes the RX queue first, then polls until a matching frame arrives.
- */
-static CANManager::CANResult receiveMatchingId(const QString& slotName,
-                                                uint32_t targetId,
-                                                CANManager::CANMessage& rxMsg,
-                                                int timeoutMs)
-{
-    auto& can = CANManager::CANBusManager::instance();
-    can.flushReceiveQueue(slotName);
-
-    QElapsedTimer timer;
-    timer.start();
-
-    while (!timer.hasExpired(timeoutMs)) {
-        int remaining = timeoutMs - static_cast<int>(timer.elapsed());
-        if (remaining <= 0) break;
-
-        auto result = can.receive(slotName, rxMsg, qMin(remaining, 100));
-        if (result.success && rxMsg.id == targetId) {
-            return CANManager::CANResult::Success();
-        }
-    }
-    return CANManager::CANResult::Failure(
-        QString("No response with CAN ID 0x%1 within %2 ms")
-            .arg(targetId, 0, 16).arg(timeoutMs));
-}
-
 void CommandRegistry::registerCANCommands()
 {
     // =========================================================================
@@ -742,7 +718,7 @@ void CommandRegistry::registerCANCommands()
     auto canTxHandler = [](bool isFD) -> CommandHandler {
         return [isFD](const QVariantMap& params, const QVariantMap& /*config*/,
                       const std::atomic<bool>* /*cancel*/) -> CommandResult {
-            QString slot = params.value("slot", "CAN 1").toString();
+            QString slot = Station::current().canSlot(params.value("slot", "CAN 1").toString());
             auto& can = CANManager::CANBusManager::instance();
             if (!can.isSlotOpen(slot))
                 return CommandResult::Failure("CAN slot '" + slot + "' is not open");
@@ -769,20 +745,17 @@ void CommandRegistry::registerCANCommands()
         return [isFD, parseRxCanId, buildTxRxResponse](
                    const QVariantMap& params, const QVariantMap& /*config*/,
                    const std::atomic<bool>* /*cancel*/) -> CommandResult {
-            QString slot = params.value("slot", "CAN 1").toString();
+            QString slot = Station::current().canSlot(params.value("slot", "CAN 1").toString());
             int timeoutMs = params.value("timeout_ms", 5000).toInt();
             auto& can = CANManager::CANBusManager::instance();
             if (!can.isSlotOpen(slot))
                 return CommandResult::Failure("CAN slot '" + slot + "' is not open");
 
             CANManager::CANMessage txMsg = buildCANMessage(params, isFD);
-            auto txResult = can.transmit(slot, txMsg);
-            if (!txResult.success)
-                return CommandResult::Failure("Transmit failed: " + txResult.errorMessage);
-
             uint32_t rxId = parseRxCanId(params);
             CANManager::CANMessage rxMsg{};
-            auto rxResult = receiveMatchingId(slot, rxId, rxMsg, timeoutMs);
+            auto rxResult = can.request(slot, txMsg, CANManager::CANIdFilter::exact(rxId),
+                                        timeoutMs, rxMsg);
 
             QVariantMap resp = buildTxRxResponse(txMsg, rxMsg, isFD);
             return rxResult.success
@@ -798,20 +771,17 @@ void CommandRegistry::registerCANCommands()
         return [isFD, parseRxCanId, buildTxRxResponse, matchExpectedPayload](
                    const QVariantMap& params, const QVariantMap& /*config*/,
                    const std::atomic<bool>* /*cancel*/) -> CommandResult {
-            QString slot = params.value("slot", "CAN 1").toString();
+            QString slot = Station::current().canSlot(params.value("slot", "CAN 1").toString());
             int timeoutMs = params.value("timeout_ms", 5000).toInt();
             auto& can = CANManager::CANBusManager::instance();
             if (!can.isSlotOpen(slot))
                 return CommandResult::Failure("CAN slot '" + slot + "' is not open");
 
             CANManager::CANMessage txMsg = buildCANMessage(params, isFD);
-            auto txResult = can.transmit(slot, txMsg);
-            if (!txResult.success)
-                return CommandResult::Failure("Transmit failed: " + txResult.errorMessage);
-
             uint32_t rxId = parseRxCanId(params);
             CANManager::CANMessage rxMsg{};
-            auto rxResult = receiveMatchingId(slot, rxId, rxMsg, timeoutMs);
+            auto rxResult = can.request(slot, txMsg, CANManager::CANIdFilter::exact(rxId),
+                                        timeoutMs, rxMsg);
 
             QVariantMap resp = buildTxRxResponse(txMsg, rxMsg, isFD);
 
@@ -834,7 +804,1196 @@ void CommandRegistry::registerCANCommands()
     };
 
     // =========================================================================
-    // Assemble parameter lists and register all 6 CAN commands
+    // Cyclic transmission (per-slot scheduler in CANManager)
+    // =========================================================================
+    auto periodParam = []() -> ParameterDef {
+        return {
+            .name = "period_ms",
+            .displayName = "Period",
+            .description = "Transmit period; deadlines are absolute, so the period does not drift",
+            .type = ParameterType::Duration,
+            .defaultValue = 100,
+            .required = true,
+            .minValue = 1,
+            .maxValue = 60000,
+            .unit = "ms"
+        };
+    };
+
+    auto fdParam = []() -> ParameterDef {
+        return {
+            .name = "fd",
+            .displayName = "CAN FD",
+            .description = "Send as CAN FD frame (up to 64 bytes, bit rate switch)",
+            .type = ParameterType::Boolean,
+            .defaultValue = false,
+            .required = false
+        };
+    };
+
+    auto cyclicStatsResponse = [](const CANManager::CANBusManager::CyclicStats& stats) -> QVariantMap {
+        QVariantMap resp;
+        resp["period_ms"]         = stats.periodMs;
+        resp["sent"]              = static_cast<qulonglong>(stats.sent);
+        resp["missed"]            = static_cast<qulonglong>(stats.missed);
+        resp["errors"]            = static_cast<qulonglong>(stats.errors);
+        resp["min_period_us"]     = stats.minPeriodUs;
+        resp["max_period_us"]     = stats.maxPeriodUs;
+        resp["mean_period_us"]    = stats.meanPeriodUs;
+        resp["jitter_stddev_us"]  = stats.jitterStdDevUs;
+        resp["max_abs_jitter_us"] = stats.maxAbsJitterUs;
+        resp["max_lateness_us"]   = stats.maxLatenessUs;
+        if (!stats.lastError.isEmpty())
+            resp["last_error"] = stats.lastError;
+        return resp;
+    };
+
+    auto canCyclicStartHandler = [](const QVariantMap& params, const QVariantMap& /*config*/,
+                                    const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        QString slot = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        int periodMs = params.value("period_ms", 100).toInt();
+        auto& can = CANManager::CANBusManager::instance();
+        if (!can.isSlotOpen(slot))
+            return CommandResult::Failure("CAN slot '" + slot + "' is not open");
+
+        CANManager::CANMessage msg = buildCANMessage(params, params.value("fd", false).toBool());
+        auto result = can.startCyclic(slot, msg, periodMs);
+
+        QVariantMap resp;
+        resp["can_id"]    = QString("0x%1").arg(msg.id, 0, 16).toUpper();
+        resp["data"]      = bytesToHexString(QByteArray(reinterpret_cast<const char*>(msg.data), msg.dataLength()));
+        resp["period_ms"] = periodMs;
+
+        return result.success
+            ? CommandResult::Success(QString("Cyclic transmission started (%1 ms)").arg(periodMs), resp)
+            : CommandResult::Failure("Cyclic start failed: " + result.errorMessage);
+    };
+
+    auto canCyclicUpdateHandler = [cyclicStatsResponse](
+                                      const QVariantMap& params, const QVariantMap& /*config*/,
+                                      const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        QString slot = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        auto& can = CANManager::CANBusManager::instance();
+
+        CANManager::CANMessage msg = buildCANMessage(params, params.value("fd", false).toBool());
+        auto result = can.updateCyclic(slot, msg);
+        if (!result.success)
+            return CommandResult::Failure("Cyclic update failed: " + result.errorMessage);
+
+        CANManager::CANBusManager::CyclicStats stats;
+        can.cyclicStats(slot, msg.id, msg.isExtended, stats);
+        QVariantMap resp = cyclicStatsResponse(stats);
+        resp["can_id"] = QString("0x%1").arg(msg.id, 0, 16).toUpper();
+        resp["data"]   = bytesToHexString(QByteArray(reinterpret_cast<const char*>(msg.data), msg.dataLength()));
+        return CommandResult::Success("Cyclic payload updated", resp);
+    };
+
+    auto canCyclicStopHandler = [cyclicStatsResponse](
+                                    const QVariantMap& params, const QVariantMap& /*config*/,
+                                    const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        QString slot = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        auto& can = CANManager::CANBusManager::instance();
+
+        CANManager::CANMessage msg = buildCANMessage(params, false);
+        CANManager::CANBusManager::CyclicStats stats;
+        auto result = can.stopCyclic(slot, msg.id, msg.isExtended, &stats);
+        if (!result.success)
+            return CommandResult::Failure("Cyclic stop failed: " + result.errorMessage);
+
+        QVariantMap resp = cyclicStatsResponse(stats);
+        resp["can_id"] = QString("0x%1").arg(msg.id, 0, 16).toUpper();
+        return CommandResult::Success(
+            QString("Cyclic transmission stopped: %1 sent, %2 missed, jitter %3 us (std dev)")
+                .arg(stats.sent).arg(stats.missed).arg(stats.jitterStdDevUs, 0, 'f', 1),
+            resp);
+    };
+
+    // =========================================================================
+    // Trace recording (ASC / BLF, background writer in CANManager)
+    // =========================================================================
+    auto traceFileParam = []() -> ParameterDef {
+        return {
+            .name = "file",
+            .displayName = "Trace File",
+            .description = "Trace file; '.blf' writes compressed BLF, anything else Vector ASC",
+            .type = ParameterType::FilePath,
+            .defaultValue = "trace.asc",
+            .required = true
+        };
+    };
+
+    auto traceStatsResponse = [](const CANManager::CANBusManager::TraceStats& stats) -> QVariantMap {
+        QVariantMap resp;
+        resp["frames_recorded"] = static_cast<qulonglong>(stats.framesRecorded);
+        resp["frames_written"]  = static_cast<qulonglong>(stats.framesWritten);
+        resp["frames_dropped"]  = static_cast<qulonglong>(stats.framesDropped);
+        resp["bytes_written"]   = static_cast<qlonglong>(stats.bytesWritten);
+        resp["file_count"]      = stats.fileCount;
+        resp["current_file"]    = stats.currentFile;
+        if (!stats.lastError.isEmpty())
+            resp["last_error"] = stats.lastError;
+        return resp;
+    };
+
+    auto canTraceStartHandler = [](const QVariantMap& params, const QVariantMap& /*config*/,
+                                   const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        QStringList slotNames;
+        for (const QString& name : params.value("slots", "CAN 1").toString().split(',', Qt::SkipEmptyParts))
+            slotNames.append(Station::current().canSlot(name.trimmed()));
+
+        CANManager::CANBusManager::TraceOptions options;
+        options.path           = params.value("file").toString().trimmed();
+        options.format         = CANManager::CANTraceWriter::formatForPath(options.path);
+        options.maxFileBytes   = params.value("rotate_mb", 0).toLongLong() * 1024 * 1024;
+        options.maxFileSeconds = params.value("rotate_s", 0).toInt();
+
+        auto result = CANManager::CANBusManager::instance().startTrace(slotNames, options);
+
+        QVariantMap resp;
+        resp["file"]  = options.path;
+        resp["slots"] = slotNames.join(", ");
+        return result.success
+            ? CommandResult::Success(QString("Recording %1 to %2").arg(slotNames.join(", "), options.path), resp)
+            : CommandResult::Failure("Trace start failed: " + result.errorMessage);
+    };
+
+    auto canTraceStopHandler = [traceStatsResponse](
+                                   const QVariantMap& params, const QVariantMap& /*config*/,
+                                   const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        const QString path = params.value("file").toString().trimmed();
+        CANManager::CANBusManager::TraceStats stats;
+        auto result = CANManager::CANBusManager::instance().stopTrace(path, &stats);
+        QVariantMap resp = traceStatsResponse(stats);
+        if (!result.success)
+            return CommandResult::Failure("Trace stop failed: " + result.errorMessage);
+
+        // Frames lost because the disk could not keep up make the trace incomplete
+        const QString summary = QString("Trace stopped: %1 frames in %2 file(s), %3 dropped")
+                                    .arg(stats.framesWritten).arg(stats.fileCount).arg(stats.framesDropped);
+        if (stats.framesDropped == 0)
+            return CommandResult::Success(summary, resp);
+
+        CommandResult failed = CommandResult::Failure(summary);
+        failed.responseData = resp;
+        return failed;
+    };
+
+    // =========================================================================
+    // Trace replay (per-slot replayer in CANManager)
+    // =========================================================================
+
+    // CAN IDs are hex with or without "0x", as everywhere else in the CAN commands
+    auto parseHexId = [](QString text, bool* ok) -> uint32_t {
+        text = text.trimmed();
+        if (text.startsWith("0x", Qt::CaseInsensitive))
+            text = text.mid(2);
+        return text.toUInt(ok, 16);
+    };
+
+    // "0x100, 0x7E0/0x7F0" → exact or masked ID filters; false on a bad entry
+    auto parseIdFilters = [parseHexId](const QString& text, QList<CANManager::CANIdFilter>& filters,
+                             QString& error) -> bool {
+        for (const QString& entry : text.split(',', Qt::SkipEmptyParts)) {
+            const QStringList parts = entry.trimmed().split('/');
+            bool idOk = false, maskOk = true;
+            const uint32_t id = parseHexId(parts[0], &idOk);
+            const uint32_t mask = parts.size() > 1 ? parseHexId(parts[1], &maskOk) : 0x1FFFFFFF;
+            if (!idOk || !maskOk || parts.size() > 2) {
+                error = "Invalid CAN ID filter: " + entry.trimmed();
+                return false;
+            }
+            filters.append(CANManager::CANIdFilter::masked(id, mask));
+        }
+        return true;
+    };
+
+    // "0x100=0x101, 0x200=0x201" → trace ID to transmitted ID
+    auto parseIdMap = [parseHexId](const QString& text, QMap<uint32_t, uint32_t>& idMap, QString& error) -> bool {
+        for (const QString& entry : text.split(',', Qt::SkipEmptyParts)) {
+            const QStringList parts = entry.trimmed().split('=');
+            bool fromOk = false, toOk = false;
+            if (parts.size() == 2) {
+                const uint32_t from = parseHexId(parts[0], &fromOk);
+                const uint32_t to   = parseHexId(parts[1], &toOk);
+                idMap.insert(from, to);
+            }
+            if (!fromOk || !toOk) {
+                error = "Invalid CAN ID mapping: " + entry.trimmed();
+                return false;
+            }
+        }
+        return true;
+    };
+
+    auto replayStatsResponse = [](const CANManager::CANBusManager::ReplayStats& stats) -> QVariantMap {
+        QVariantMap resp;
+        resp["file"]            = stats.path;
+        resp["frames_per_loop"] = static_cast<qulonglong>(stats.framesPerLoop);
+        resp["loop_duration_s"] = stats.loopDurationS;
+        resp["loops_completed"] = stats.loopsCompleted;
+        resp["sent"]            = static_cast<qulonglong>(stats.sent);
+        resp["errors"]          = static_cast<qulonglong>(stats.errors);
+        resp["mean_error_us"]   = stats.meanErrorUs;
+        resp["stddev_error_us"] = stats.stdDevErrorUs;
+        resp["p50_error_us"]    = stats.p50ErrorUs;
+        resp["p90_error_us"]    = stats.p90ErrorUs;
+        resp["p99_error_us"]    = stats.p99ErrorUs;
+        resp["p999_error_us"]   = stats.p999ErrorUs;
+        resp["max_error_us"]    = stats.maxErrorUs;
+        if (!stats.lastError.isEmpty())
+            resp["last_error"] = stats.lastError;
+        return resp;
+    };
+
+    // Rejected frames make the replay incomplete
+    auto replayResult = [replayStatsResponse](const CANManager::CANBusManager::ReplayStats& stats) -> CommandResult {
+        QVariantMap resp = replayStatsResponse(stats);
+        const QString summary = QString("Replayed %1 frames (%2 rejected), timing error p99 %3 us, max %4 us")
+                                    .arg(stats.sent).arg(stats.errors)
+                                    .arg(stats.p99ErrorUs, 0, 'f', 0).arg(stats.maxErrorUs, 0, 'f', 0);
+        if (stats.errors == 0)
+            return CommandResult::Success(summary, resp);
+
+        CommandResult failed = CommandResult::Failure(summary);
+        failed.responseData = resp;
+        return failed;
+    };
+
+    auto canReplayHandler = [parseIdFilters, parseIdMap, replayResult](
+                                const QVariantMap& params, const QVariantMap& /*config*/,
+                                const std::atomic<bool>* cancel) -> CommandResult {
+        QString slot = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        auto& can = CANManager::CANBusManager::instance();
+        if (!can.isSlotOpen(slot))
+            return CommandResult::Failure("CAN slot '" + slot + "' is not open");
+
+        CANManager::CANBusManager::ReplayOptions options;
+        options.path    = params.value("file").toString().trimmed();
+        options.channel = params.value("channel", 0).toInt();
+        options.speed   = params.value("speed", 1.0).toDouble();
+        options.loops   = params.value("loops", 1).toInt();
+
+        QString error;
+        if (!parseIdFilters(params.value("ids").toString(), options.include, error)
+            || !parseIdFilters(params.value("exclude_ids").toString(), options.exclude, error)
+            || !parseIdMap(params.value("remap").toString(), options.idMap, error))
+            return CommandResult::Failure(error);
+
+        auto result = can.startReplay(slot, options);
+        if (!result.success)
+            return CommandResult::Failure("Replay start failed: " + result.errorMessage);
+
+        if (!params.value("wait", true).toBool()) {
+            QVariantMap resp;
+            resp["file"] = options.path;
+            resp["slot"] = slot;
+            return CommandResult::Success(QString("Replaying %1 on %2").arg(options.path, slot), resp);
+        }
+
+        // Poll so a cancelled test stops the replay promptly
+        while (!can.waitForReplay(slot, 100)) {
+            if (cancel && cancel->load()) {
+                can.stopReplay(slot);
+                return CommandResult::Failure("Replay cancelled");
+            }
+        }
+
+        CANManager::CANBusManager::ReplayStats stats;
+        can.stopReplay(slot, &stats);
+        return replayResult(stats);
+    };
+
+    auto canReplayStopHandler = [replayResult](const QVariantMap& params, const QVariantMap& /*config*/,
+                                               const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        QString slot = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        CANManager::CANBusManager::ReplayStats stats;
+        auto result = CANManager::CANBusManager::instance().stopReplay(slot, &stats);
+        if (!result.success)
+            return CommandResult::Failure("Replay stop failed: " + result.errorMessage);
+        return replayResult(stats);
+    };
+
+    // =========================================================================
+    // Acceptance filters (driver / hardware level, per slot)
+    // =========================================================================
+    auto canSetFilterHandler = [parseIdFilters](const QVariantMap& params, const QVariantMap& /*config*/,
+                                                const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        QString slot = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        QList<CANManager::CANIdFilter> filters;
+        QString error;
+        if (!parseIdFilters(params.value("ids").toString(), filters, error))
+            return CommandResult::Failure(error);
+
+        auto result = CANManager::CANBusManager::instance().setAcceptanceFilters(slot, filters);
+        if (!result.success)
+            return CommandResult::Failure("Setting acceptance filters failed: " + result.errorMessage);
+
+        QStringList ids;
+        for (const auto& filter : filters)
+            ids.append(filter.toString());
+        QVariantMap resp;
+        resp["slot"]    = slot;
+        resp["filters"] = ids;
+        return CommandResult::Success(filters.isEmpty()
+                                          ? QString("%1 accepts all IDs").arg(slot)
+                                          : QString("%1 accepts %2").arg(slot, ids.join(", ")), resp);
+    };
+
+    // =========================================================================
+    // Bus statistics (per-slot counters kept by CANManager)
+    // =========================================================================
+    auto canGetStatisticsHandler = [](const QVariantMap& params, const QVariantMap& /*config*/,
+                                      const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        QString slot = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        const int topIds = params.value("top_ids", 10).toInt();
+        const double maxLoad = params.value("max_bus_load_pct", 0.0).toDouble();
+        auto& can = CANManager::CANBusManager::instance();
+
+        CANManager::CANBusManager::BusStatistics stats;
+        if (!can.busStatistics(slot, stats))
+            return CommandResult::Failure("CAN slot '" + slot + "' is not open");
+        if (params.value("reset", false).toBool())
+            can.resetBusStatistics(slot);
+
+        QVariantMap resp;
+        resp["elapsed_s"]          = stats.elapsedS;
+        resp["bus_load_pct"]       = stats.current.busLoadPercent;
+        resp["mean_bus_load_pct"]  = stats.meanBusLoadPercent;
+        resp["peak_bus_load_pct"]  = stats.peakBusLoadPercent;
+        resp["rx_fps"]             = stats.current.rxFramesPerSecond;
+        resp["tx_fps"]             = stats.current.txFramesPerSecond;
+        resp["bytes_per_s"]        = stats.current.bytesPerSecond;
+        resp["error_fps"]          = stats.current.errorFramesPerSecond;
+        resp["rx_frames"]          = static_cast<qulonglong>(stats.rxFrames);
+        resp["rx_bytes"]           = static_cast<qulonglong>(stats.rxBytes);
+        resp["tx_requests"]        = static_cast<qulonglong>(stats.txRequests);
+        resp["tx_bytes"]           = static_cast<qulonglong>(stats.txBytes);
+        resp["tx_confirmations"]   = static_cast<qulonglong>(stats.txConfirmations);
+        resp["tx_rejected"]        = static_cast<qulonglong>(stats.txRejected);
+        resp["error_frames"]       = static_cast<qulonglong>(stats.errorFrames);
+        resp["rx_batch_high_water"]     = stats.rxBatchHighWater;
+        resp["rx_queue_high_water"]     = static_cast<qulonglong>(stats.rxQueueHighWater);
+        resp["subscription_high_water"] = static_cast<qulonglong>(stats.subscriptionHighWater);
+
+        QVariantList ids;
+        for (int i = 0; i < stats.ids.size() && i < topIds; ++i) {
+            const auto& id = stats.ids[i];
+            QVariantMap entry;
+            entry["can_id"]   = QString("0x%1").arg(id.id, 0, 16).toUpper();
+            entry["extended"] = id.extended;
+            entry["fps"]      = id.framesPerSecond;
+            entry["frames"]   = static_cast<qulonglong>(id.frames);
+            ids.append(entry);
+        }
+        resp["ids"] = ids;
+
+        const QString summary = QString("%1: %2 % load (peak %3 %), %4 RX / %5 TX frames, %6 error frames")
+                                    .arg(slot)
+                                    .arg(stats.current.busLoadPercent, 0, 'f', 1)
+                                    .arg(stats.peakBusLoadPercent, 0, 'f', 1)
+                                    .arg(stats.rxFrames).arg(stats.txRequests).arg(stats.errorFrames);
+        if (maxLoad > 0.0 && stats.peakBusLoadPercent > maxLoad) {
+            CommandResult failed = CommandResult::Failure(
+                QString("Peak bus load %1 % exceeds %2 %").arg(stats.peakBusLoadPercent, 0, 'f', 1)
+                                                         .arg(maxLoad, 0, 'f', 1));
+            failed.responseData = resp;
+            return failed;
+        }
+        return CommandResult::Success(summary, resp);
+    };
+
+    // =========================================================================
+    // Gateway (forward one slot to another through block / delay / rewrite rules)
+    // =========================================================================
+    auto gatewaySlots = [](const QVariantMap& params, const QString& source, const QString& destination) {
+        return std::make_pair(Station::current().canSlot(params.value("source", source.isEmpty() ? "CAN 1" : source).toString()),
+                         Station::current().canSlot(params.value("destination", destination.isEmpty() ? "CAN 2" : destination).toString()));
+    };
+
+    auto gatewayResult = [](const CANManager::CANBusManager::GatewayStats& stats) {
+        auto ruleEntry = [](const CANManager::CANGateway::RuleStats& rule) {
+            QVariantMap entry;
+            entry["name"]      = rule.name;
+            entry["matched"]   = static_cast<qulonglong>(rule.matched);
+            entry["forwarded"] = static_cast<qulonglong>(rule.forwarded);
+            entry["dropped"]   = static_cast<qulonglong>(rule.dropped);
+            return entry;
+        };
+
+        QVariantMap resp;
+        resp["running"]          = stats.running;
+        resp["source"]           = stats.source;
+        resp["destination"]      = stats.destination;
+        resp["received"]         = static_cast<qulonglong>(stats.received);
+        resp["forwarded"]        = static_cast<qulonglong>(stats.forwarded);
+        resp["blocked"]          = static_cast<qulonglong>(stats.blocked);
+        resp["delayed"]          = static_cast<qulonglong>(stats.delayed);
+        resp["tx_errors"]        = static_cast<qulonglong>(stats.txErrors);
+        resp["delay_overflows"]  = static_cast<qulonglong>(stats.delayOverflows);
+        resp["overruns"]         = static_cast<qulonglong>(stats.overruns);
+        resp["mean_latency_us"]  = stats.meanLatencyUs;
+        resp["max_latency_us"]   = stats.maxLatencyUs;
+        QVariantList rules;
+        for (const auto& rule : stats.rules)
+            rules.append(ruleEntry(rule));
+        resp["rules"]        = rules;
+        resp["default_rule"] = ruleEntry(stats.defaultRule);
+        if (!stats.lastError.isEmpty())
+            resp["last_error"] = stats.lastError;
+        return resp;
+    };
+
+    auto gatewaySummary = [](const CANManager::CANBusManager::GatewayStats& stats) {
+        return QString("%1 -> %2: %3 received, %4 forwarded, %5 blocked, %6 TX errors, "
+                       "latency %7 us mean / %8 us max")
+            .arg(stats.source, stats.destination)
+            .arg(stats.received).arg(stats.forwarded).arg(stats.blocked).arg(stats.txErrors)
+            .arg(stats.meanLatencyUs, 0, 'f', 1).arg(stats.maxLatencyUs, 0, 'f', 1);
+    };
+
+    auto canGatewayStartHandler = [gatewaySlots](const QVariantMap& params, const QVariantMap& /*config*/,
+                                                 const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        CANManager::CANGateway::Options options;
+        const QString ruleFile = params.value("rule_file").toString();
+        const QString rules = params.value("rules").toString();
+        CANManager::CANResult parsed = CANManager::CANResult::Success();
+        if (!ruleFile.isEmpty())
+            parsed = CANManager::CANGateway::loadRules(ruleFile, options);
+        else if (!rules.trimmed().isEmpty())
+            parsed = CANManager::CANGateway::parseRules(rules.toUtf8(), options);
+        if (!parsed.success)
+            return CommandResult::Failure("Gateway rules: " + parsed.errorMessage);
+
+        // Step parameters override the slots and default action of the rule set
+        const auto slotPair = gatewaySlots(params, options.source, options.destination);
+        options.source      = slotPair.first;
+        options.destination = slotPair.second;
+        const QString defaultAction = params.value("default_action", "as_rules").toString();
+        if (defaultAction == "forward")
+            options.defaultAction = CANManager::CANGateway::Action::Forward;
+        else if (defaultAction == "block")
+            options.defaultAction = CANManager::CANGateway::Action::Block;
+
+        // Signal rewrites: resolve through the DBC into payload mask / value bytes
+        const int dbcChannel = params.value("dbc_channel", 1).toInt() - 1;
+        for (auto& rule : options.rules) {
+            if (rule.signalValues.isEmpty())
+                continue;
+            auto db = DBCManager::DBCDatabaseManager::instance().database(dbcChannel);
+            if (!db)
+                return CommandResult::Failure(QString("Gateway rule '%1': no DBC loaded on channel %2")
+                                                  .arg(rule.name).arg(dbcChannel + 1));
+            const auto* msg = db->messageById(rule.match.id);
+            if (!msg)
+                return CommandResult::Failure(QString("Gateway rule '%1': message 0x%2 not in the DBC")
+                                                  .arg(rule.name).arg(rule.match.id, 0, 16));
+
+            const int length = qBound(static_cast<int>(rule.dataMask.size()), static_cast<int>(msg->dlc), 64);
+            QByteArray mask  = rule.dataMask + QByteArray(length - rule.dataMask.size(), '\0');
+            QByteArray value = rule.dataValue + QByteArray(length - rule.dataValue.size(), '\0');
+            for (auto it = rule.signalValues.cbegin(); it != rule.signalValues.cend(); ++it) {
+                const auto* sig = msg->signal(it.key());
+                if (!sig)
+                    return CommandResult::Failure(QString("Gateway rule '%1': signal '%2' not in %3")
+                                                      .arg(rule.name, it.key(), msg->name));
+                sig->setRawValue(-1, reinterpret_cast<uint8_t*>(mask.data()), length);
+                sig->encode(it.value(), reinterpret_cast<uint8_t*>(value.data()), length);
+            }
+            rule.dataMask  = mask;
+            rule.dataValue = value;
+            rule.signalValues.clear();
+        }
+
+        auto result = CANManager::CANBusManager::instance().startGateway(options);
+        if (!result.success)
+            return CommandResult::Failure("Gateway start failed: " + result.errorMessage);
+
+        QVariantMap resp;
+        resp["source"]      = options.source;
+        resp["destination"] = options.destination;
+        resp["rules"]       = static_cast<int>(options.rules.size());
+        return CommandResult::Success(QString("Gateway %1 -> %2 forwarding with %3 rules")
+                                          .arg(options.source, options.destination)
+                                          .arg(options.rules.size()), resp);
+    };
+
+    auto canGatewayStopHandler = [gatewaySlots, gatewayResult, gatewaySummary](
+                                     const QVariantMap& params, const QVariantMap& /*config*/,
+                                     const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        const auto slotPair = gatewaySlots(params, QString(), QString());
+        CANManager::CANBusManager::GatewayStats stats;
+        auto result = CANManager::CANBusManager::instance().stopGateway(slotPair.first, slotPair.second, &stats);
+        if (!result.success)
+            return CommandResult::Failure("Gateway stop failed: " + result.errorMessage);
+        return CommandResult::Success(gatewaySummary(stats), gatewayResult(stats));
+    };
+
+    auto canGatewayStatsHandler = [gatewaySlots, gatewayResult, gatewaySummary](
+                                      const QVariantMap& params, const QVariantMap& /*config*/,
+                                      const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        const auto slotPair = gatewaySlots(params, QString(), QString());
+        const double maxLatency = params.value("max_latency_us", 0.0).toDouble();
+        CANManager::CANBusManager::GatewayStats stats;
+        if (!CANManager::CANBusManager::instance().gatewayStats(slotPair.first, slotPair.second, stats))
+            return CommandResult::Failure(QString("No gateway %1 -> %2").arg(slotPair.first, slotPair.second));
+
+        const QVariantMap resp = gatewayResult(stats);
+        QString failure;
+        if (maxLatency > 0.0 && stats.maxLatencyUs > maxLatency)
+            failure = QString("Max forwarding latency %1 us exceeds %2 us")
+                          .arg(stats.maxLatencyUs, 0, 'f', 1).arg(maxLatency, 0, 'f', 1);
+        else if (stats.overruns > 0 || stats.delayOverflows > 0)
+            failure = QString("Gateway lost frames: %1 overruns, %2 delay queue overflows")
+                          .arg(stats.overruns).arg(stats.delayOverflows);
+        if (!failure.isEmpty()) {
+            CommandResult failed = CommandResult::Failure(failure);
+            failed.responseData = resp;
+            return failed;
+        }
+        return CommandResult::Success(gatewaySummary(stats), resp);
+    };
+
+    // =========================================================================
+    // Rest-bus simulation (DBC nodes not on the bench, RestBusSimulation)
+    // =========================================================================
+    auto restBusResult = [](const DBCManager::RestBusSimulation::Stats& stats) {
+        QVariantMap resp;
+        resp["slot"]             = stats.slot;
+        resp["messages"]         = stats.messages;
+        resp["skipped"]          = stats.skipped;
+        resp["sent"]             = static_cast<qulonglong>(stats.sent);
+        resp["missed"]           = static_cast<qulonglong>(stats.missed);
+        resp["errors"]           = static_cast<qulonglong>(stats.errors);
+        resp["signal_updates"]   = static_cast<qulonglong>(stats.signalUpdates);
+        resp["max_abs_jitter_us"] = stats.maxAbsJitterUs;
+        QVariantList messages;
+        for (const auto& message : stats.messageStats) {
+            QVariantMap entry;
+            entry["name"]      = message.name;
+            entry["can_id"]    = QString("0x%1").arg(message.id, 0, 16).toUpper();
+            entry["period_ms"] = message.periodMs;
+            entry["sent"]      = static_cast<qulonglong>(message.sent);
+            entry["missed"]    = static_cast<qulonglong>(message.missed);
+            entry["errors"]    = static_cast<qulonglong>(message.errors);
+            messages.append(entry);
+        }
+        resp["message_stats"] = messages;
+        return resp;
+    };
+
+    auto restBusStartHandler = [](const QVariantMap& params, const QVariantMap& /*config*/,
+                                  const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        DBCManager::RestBusSimulation::Options options;
+        options.slot             = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        options.nodes            = params.value("nodes").toString().split(',', Qt::SkipEmptyParts);
+        options.excludedMessages = params.value("exclude").toString().split(',', Qt::SkipEmptyParts);
+        options.defaultCycleMs   = params.value("default_cycle_ms", 0).toInt();
+        for (auto* list : {&options.nodes, &options.excludedMessages}) {
+            for (QString& name : *list)
+                name = name.trimmed();
+        }
+
+        const int dbcChannel = params.value("dbc_channel", 1).toInt() - 1;
+        auto db = DBCManager::DBCDatabaseManager::instance().database(dbcChannel);
+        auto& restBus = DBCManager::RestBusManager::instance();
+        auto result = restBus.start(options, db);
+        if (!result.success)
+            return CommandResult::Failure("Rest-bus start failed: " + result.errorMessage);
+
+        auto simulation  = restBus.simulation(options.slot);
+        const auto stats = simulation->stats();
+        QVariantMap resp;
+        resp["slot"]     = options.slot;
+        resp["messages"] = simulation->messageNames();
+        resp["skipped"]  = stats.skipped;
+        return CommandResult::Success(QString("Simulating %1 messages on %2 (%3 without cycle time skipped)")
+                                          .arg(stats.messages).arg(options.slot).arg(stats.skipped), resp);
+    };
+
+    auto restBusSetSignalHandler = [](const QVariantMap& params, const QVariantMap& /*config*/,
+                                      const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        const QString slot    = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        const QString message = params.value("message").toString().trimmed();
+        auto simulation = DBCManager::RestBusManager::instance().simulation(slot);
+        if (!simulation)
+            return CommandResult::Failure("No rest-bus simulation on " + slot);
+
+        // "Signal=value, Signal=value"
+        QMap<QString, double> values;
+        for (const QString& item : params.value("signals").toString().split(',', Qt::SkipEmptyParts)) {
+            const QStringList pair = item.split('=');
+            bool ok = false;
+            const double value = pair.size() == 2 ? pair[1].trimmed().toDouble(&ok) : 0.0;
+            if (!ok)
+                return CommandResult::Failure("Invalid signal assignment '" + item.trimmed() + "', expected Name=value");
+            values.insert(pair[0].trimmed(), value);
+        }
+
+        if (params.value("reset", false).toBool()) {
+            auto reset = simulation->resetSignals(message);
+            if (!reset.success)
+                return CommandResult::Failure("Rest-bus reset failed: " + reset.errorMessage);
+        }
+        if (!values.isEmpty()) {
+            auto result = simulation->setSignals(message, values);
+            if (!result.success)
+                return CommandResult::Failure("Rest-bus signal update failed: " + result.errorMessage);
+        }
+
+        QVariantMap resp;
+        CANManager::CANMessage frame;
+        if (simulation->frame(message, frame))
+            resp["data"] = bytesToHexString(QByteArray(reinterpret_cast<const char*>(frame.data),
+                                                       frame.dataLength()));
+        return CommandResult::Success(QString("%1: %2 signals set").arg(message).arg(values.size()), resp);
+    };
+
+    auto restBusStopHandler = [restBusResult](const QVariantMap& params, const QVariantMap& /*config*/,
+                                              const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        const QString slot = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        DBCManager::RestBusSimulation::Stats stats;
+        auto result = DBCManager::RestBusManager::instance().stop(slot, &stats);
+        if (!result.success)
+            return CommandResult::Failure("Rest-bus stop failed: " + result.errorMessage);
+        return CommandResult::Success(QString("Rest-bus on %1 stopped: %2 messages, %3 frames sent, "
+                                              "%4 cycles missed, %5 errors")
+                                          .arg(slot).arg(stats.messages).arg(stats.sent)
+                                          .arg(stats.missed).arg(stats.errors), restBusResult(stats));
+    };
+
+    // =========================================================================
+    // Network management (AUTOSAR CanNm per slot, CANNetworkManagement)
+    // =========================================================================
+
+    // "0x10, 0x11" → NM node IDs; false on a bad entry
+    auto parseNmNodes = [parseHexId](const QString& text, QList<uint8_t>& nodes, QString& error) -> bool {
+        for (const QString& entry : text.split(',', Qt::SkipEmptyParts)) {
+            bool ok = false;
+            const uint32_t node = parseHexId(entry, &ok);
+            if (!ok || node > 0xFF) {
+                error = "Invalid NM node ID '" + entry.trimmed() + "'";
+                return false;
+            }
+            nodes.append(static_cast<uint8_t>(node));
+        }
+        return true;
+    };
+
+    auto nmResult = [](const CANManager::CANBusManager::NmStatus& status) {
+        QVariantMap resp;
+        resp["bus_sleep"]              = status.busSleep;
+        resp["since_release_ms"]       = static_cast<qlonglong>(status.sinceReleaseMs);
+        resp["sleep_after_release_ms"] = static_cast<qlonglong>(status.sleepAfterReleaseMs);
+        resp["pdus_received"]          = static_cast<qulonglong>(status.pdusReceived);
+        QVariantList nodes;
+        for (const auto& node : status.nodes) {
+            QVariantMap entry;
+            entry["node_id"]   = QString("0x%1").arg(node.nodeId, 2, 16, QChar('0')).toUpper();
+            entry["state"]     = CANManager::CANNetworkManagement::stateName(node.state);
+            entry["requested"] = node.requested;
+            nodes.append(entry);
+        }
+        resp["nodes"] = nodes;
+        QVariantList remotes;
+        QStringList awake;
+        for (const auto& remote : status.remotes) {
+            const QString id = QString("0x%1").arg(remote.nodeId, 2, 16, QChar('0')).toUpper();
+            QVariantMap entry;
+            entry["node_id"]          = id;
+            entry["can_id"]           = QString("0x%1").arg(remote.canId, 0, 16).toUpper();
+            entry["awake"]            = remote.awake;
+            entry["last_seen_ms_ago"] = static_cast<qlonglong>(remote.lastSeenMsAgo);
+            entry["pdus"]             = static_cast<qulonglong>(remote.pdus);
+            remotes.append(entry);
+            if (remote.awake)
+                awake.append(id);
+        }
+        resp["remotes"]       = remotes;
+        resp["remotes_awake"] = awake;
+        return resp;
+    };
+
+    auto nmStartHandler = [parseHexId, parseNmNodes](const QVariantMap& params, const QVariantMap& /*config*/,
+                                                     const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        CANManager::CANBusManager::NmConfig nm;
+        QString error;
+        bool baseOk = false, maskOk = false;
+        nm.slotName         = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        nm.baseId           = parseHexId(params.value("base_id", "0x500").toString(), &baseOk);
+        nm.idMask           = parseHexId(params.value("id_mask", "0x700").toString(), &maskOk);
+        nm.extendedIds      = params.value("extended_id", false).toBool();
+        nm.msgCycleMs       = params.value("cycle_ms", 100).toInt();
+        nm.repeatMessageMs  = params.value("repeat_message_ms", 1500).toInt();
+        nm.timeoutMs        = params.value("timeout_ms", 2000).toInt();
+        nm.waitBusSleepMs   = params.value("wait_bus_sleep_ms", 1500).toInt();
+        nm.activeWakeupBit  = params.value("active_wakeup", true).toBool();
+        nm.pduLength        = params.value("pdu_length", 8).toInt();
+        if (!baseOk || !maskOk)
+            return CommandResult::Failure("Invalid NM base ID or ID mask");
+        if (!parseNmNodes(params.value("nodes").toString(), nm.nodes, error))
+            return CommandResult::Failure(error);
+
+        auto result = CANManager::CANBusManager::instance().startNm(nm);
+        if (!result.success)
+            return CommandResult::Failure("NM start failed: " + result.errorMessage);
+
+        QVariantMap resp;
+        resp["slot"]  = nm.slotName;
+        resp["nodes"] = params.value("nodes").toString();
+        return CommandResult::Success(QString("Network requested on %1 for %2 NM nodes")
+                                          .arg(nm.slotName).arg(nm.nodes.size()), resp);
+    };
+
+    auto nmReleaseHandler = [parseNmNodes](const QVariantMap& params, const QVariantMap& /*config*/,
+                                           const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        const QString slot = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        QList<uint8_t> nodes;
+        QString error;
+        if (!parseNmNodes(params.value("nodes").toString(), nodes, error))
+            return CommandResult::Failure(error);
+
+        auto result = CANManager::CANBusManager::instance().releaseNm(slot, nodes);
+        if (!result.success)
+            return CommandResult::Failure("NM release failed: " + result.errorMessage);
+        return CommandResult::Success(QString("Network released on %1 for %2")
+                                          .arg(slot, nodes.isEmpty() ? QString("all NM nodes")
+                                                                     : QString("%1 NM nodes").arg(nodes.size())));
+    };
+
+    auto nmWaitBusSleepHandler = [nmResult](const QVariantMap& params, const QVariantMap& /*config*/,
+                                            const std::atomic<bool>* cancel) -> CommandResult {
+        const QString slot      = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        const int timeoutMs     = params.value("timeout_ms", 10000).toInt();
+        const int maxSleepMs    = params.value("max_sleep_ms", 0).toInt();
+        auto& can = CANManager::CANBusManager::instance();
+
+        const auto result = can.waitNmBusSleep(slot, timeoutMs, cancel);
+        CANManager::CANBusManager::NmStatus status;
+        if (!can.nmStatus(slot, status))
+            return CommandResult::Failure(result.success ? QString("No network management on " + slot)
+                                                         : result.errorMessage);
+
+        const QVariantMap resp = nmResult(status);
+        QString failure = result.success ? QString() : result.errorMessage;
+        if (failure.isEmpty() && maxSleepMs > 0 && status.sleepAfterReleaseMs > maxSleepMs)
+            failure = QString("Bus sleep %1 ms after release exceeds %2 ms")
+                          .arg(status.sleepAfterReleaseMs).arg(maxSleepMs);
+        if (!failure.isEmpty()) {
+            CommandResult failed = CommandResult::Failure(failure);
+            failed.responseData = resp;
+            return failed;
+        }
+        return CommandResult::Success(status.sleepAfterReleaseMs >= 0
+                                          ? QString("%1 asleep %2 ms after release").arg(slot).arg(status.sleepAfterReleaseMs)
+                                          : QString("%1 asleep").arg(slot), resp);
+    };
+
+    // =========================================================================
+    // ISO-TP request/response (segmented payloads, CANIsoTpChannel)
+    // =========================================================================
+    auto canIsoTpTxRxHandler = [parseRxCanId, matchExpectedPayload](
+                                   const QVariantMap& params, const QVariantMap& /*config*/,
+                                   const std::atomic<bool>* cancel) -> CommandResult {
+        CANManager::CANIsoTpChannel::Config config;
+        config.slotName    = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        config.txId        = buildCANMessage(params, false).id;
+        config.rxId        = parseRxCanId(params);
+        config.extendedIds = params.value("extended_id", false).toBool();
+        config.fd          = params.value("fd", false).toBool();
+        config.frameSize   = config.fd ? 64 : 8;
+        config.padding     = params.value("padding", true).toBool();
+        config.stMin       = static_cast<uint8_t>(params.value("st_min", 0).toUInt());
+
+        if (!CANManager::CANBusManager::instance().isSlotOpen(config.slotName))
+            return CommandResult::Failure("CAN slot '" + config.slotName + "' is not open");
+
+        CANManager::CANIsoTpChannel channel(config);
+        CANManager::CANResult result = channel.open();
+        if (!result.success)
+            return CommandResult::Failure(result.errorMessage);
+
+        const QByteArray request = hexStringToBytes(params.value("data").toString());
+        const QString expectedHex = params.value("expected_response").toString().trimmed();
+        const int timeoutMs = params.value("timeout_ms", 5000).toInt();
+
+        QVariantMap resp;
+        resp["tx_can_id"] = QString("0x%1").arg(config.txId, 0, 16).toUpper();
+        resp["tx_data"]   = bytesToHexString(request);
+        resp["rx_can_id"] = QString("0x%1").arg(config.rxId, 0, 16).toUpper();
+
+        QByteArray response;
+        result = channel.request(request, response, timeoutMs, cancel);
+        const auto stats = channel.stats();
+        resp["frames_sent"]     = static_cast<qulonglong>(stats.framesSent);
+        resp["frames_received"] = static_cast<qulonglong>(stats.framesReceived);
+        if (!result.success) {
+            CommandResult failed = CommandResult::Failure("ISO-TP request failed: " + result.errorMessage);
+            failed.responseData = resp;
+            return failed;
+        }
+
+        resp["rx_data"]   = bytesToHexString(response);
+        resp["rx_length"] = response.size();
+        if (expectedHex.isEmpty())
+            return CommandResult::Success(QString("ISO-TP response received (%1 bytes)").arg(response.size()), resp);
+
+        auto [matched, detail] = matchExpectedPayload(response, expectedHex);
+        resp["expected_data"] = expectedHex;
+        resp["match"]         = matched;
+        if (matched)
+            return CommandResult::Success("ISO-TP response matches expected", resp);
+
+        CommandResult failed = CommandResult::Failure("ISO-TP response mismatch – " + detail);
+        failed.responseData = resp;
+        return failed;
+    };
+
+    // =========================================================================
+    // UDS diagnostics (shared UdsClient per slot and ECU, see CANBusManager)
+    // =========================================================================
+    auto udsParams = [baseTxParams, rxParams, fdParam]() -> QVector<ParameterDef> {
+        const QVector<ParameterDef> base = baseTxParams({});
+        QVector<ParameterDef> params = { base[0], base[1], rxParams().first(), base[3], fdParam() };
+        params[1].description  = "Physical request ID of the ECU in hex (e.g. '0x7E0')";
+        params[1].defaultValue = "0x7E0";
+        params[2].description  = "Response ID of the ECU in hex (e.g. '0x7E8')";
+        params[4].description  = "Use CAN FD frames (up to 64 bytes per frame)";
+        return params;
+    };
+
+    auto stringParam = [](const QString& name, const QString& displayName, const QString& description,
+                          const QString& defaultValue, bool required = true) -> ParameterDef {
+        return {
+            .name = name,
+            .displayName = displayName,
+            .description = description,
+            .type = ParameterType::String,
+            .defaultValue = defaultValue,
+            .required = required
+        };
+    };
+
+    // Client for the slot / IDs in params; opened on first use, kept by CANBusManager
+    auto udsClientFor = [parseHexId](const QVariantMap& params, QString& error)
+        -> std::shared_ptr<CANManager::UdsClient>
+    {
+        CANManager::UdsClient::Config config;
+        bool txOk = false, rxOk = false;
+        config.transport.slotName    = Station::current().canSlot(params.value("slot", "CAN 1").toString());
+        config.transport.txId        = parseHexId(params.value("can_id", "0x7E0").toString(), &txOk);
+        config.transport.rxId        = parseHexId(params.value("rx_can_id", "0x7E8").toString(), &rxOk);
+        config.transport.extendedIds = params.value("extended_id", false).toBool();
+        config.transport.fd          = params.value("fd", false).toBool();
+        config.transport.frameSize   = config.transport.fd ? 64 : 8;
+        if (!txOk || !rxOk) {
+            error = "Invalid UDS request or response ID";
+            return nullptr;
+        }
+
+        CANManager::CANResult result;
+        auto client = CANManager::CANBusManager::instance().udsClient(config, &result);
+        if (!client)
+            error = result.errorMessage;
+        return client;
+    };
+
+    auto udsResponse = [](const CANManager::UdsClient::Response& response) -> QVariantMap {
+        QVariantMap resp;
+        resp["response"]      = bytesToHexString(response.data);
+        resp["positive"]      = response.positive;
+        resp["pending_count"] = response.pendingCount;
+        resp["elapsed_ms"]    = response.elapsedMs;
+        if (response.nrc) {
+            resp["nrc"]      = QString("0x%1").arg(response.nrc, 2, 16, QChar('0')).toUpper();
+            resp["nrc_name"] = CANManager::UdsClient::nrcName(response.nrc);
+        }
+        return resp;
+    };
+
+    // Success / failure of a UDS call, keeping the response data on failure
+    auto udsResult = [](const CANManager::CANResult& result, const QString& summary,
+                        const QVariantMap& resp) -> CommandResult {
+        if (result.success)
+            return CommandResult::Success(summary, resp);
+        CommandResult failed = CommandResult::Failure(result.errorMessage);
+        failed.responseData = resp;
+        return failed;
+    };
+
+    auto udsRequestHandler = [udsClientFor, udsResponse, udsResult, matchExpectedPayload](
+                                 const QVariantMap& params, const QVariantMap& /*config*/,
+                                 const std::atomic<bool>* cancel) -> CommandResult {
+        QString error;
+        auto client = udsClientFor(params, error);
+        if (!client)
+            return CommandResult::Failure(error);
+
+        CANManager::UdsClient::Response response;
+        const auto result = client->request(hexStringToBytes(params.value("data").toString()), response, cancel);
+        QVariantMap resp = udsResponse(response);
+        const QString expectedHex = params.value("expected_response").toString().trimmed();
+        if (!result.success || expectedHex.isEmpty())
+            return udsResult(result, "UDS response received", resp);
+
+        auto [matched, detail] = matchExpectedPayload(response.data, expectedHex);
+        resp["expected_data"] = expectedHex;
+        resp["match"]         = matched;
+        return udsResult(matched ? result : CANManager::CANResult::Failure("UDS response mismatch – " + detail),
+                         "UDS response matches expected", resp);
+    };
+
+    auto udsSessionHandler = [udsClientFor, udsResponse, udsResult, parseHexId](
+                                 const QVariantMap& params, const QVariantMap& /*config*/,
+                                 const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        QString error;
+        auto client = udsClientFor(params, error);
+        if (!client)
+            return CommandResult::Failure(error);
+
+        bool ok = false;
+        const uint32_t session = parseHexId(params.value("session", "0x03").toString(), &ok);
+        if (!ok || session > 0xFF)
+            return CommandResult::Failure("Invalid session: " + params.value("session").toString());
+
+        CANManager::UdsClient::Response response;
+        const auto result = client->diagnosticSessionControl(static_cast<uint8_t>(session), &response);
+        QVariantMap resp = udsResponse(response);
+        resp["p2_ms"]      = client->p2Ms();
+        resp["p2_star_ms"] = client->p2StarMs();
+        return udsResult(result, QString("Session 0x%1 active").arg(session, 2, 16, QChar('0')), resp);
+    };
+
+    auto udsReadDidHandler = [udsClientFor, udsResult, parseHexId](
+                                 const QVariantMap& params, const QVariantMap& /*config*/,
+                                 const std::atomic<bool>* cancel) -> CommandResult {
+        QString error;
+        auto client = udsClientFor(params, error);
+        if (!client)
+            return CommandResult::Failure(error);
+
+        QList<uint16_t> dids;
+        for (const QString& entry : params.value("dids").toString().split(',', Qt::SkipEmptyParts)) {
+            bool ok = false;
+            const uint32_t did = parseHexId(entry, &ok);
+            if (!ok || did > 0xFFFF)
+                return CommandResult::Failure("Invalid DID: " + entry.trimmed());
+            dids.append(static_cast<uint16_t>(did));
+        }
+        // For this step only: the client is shared by every step on the slot
+        QMap<uint16_t, int> lengths;
+        for (const QString& entry : params.value("lengths").toString().split(',', Qt::SkipEmptyParts)) {
+            const QStringList parts = entry.split('=');
+            bool didOk = false, lengthOk = false;
+            const uint32_t did = parseHexId(parts[0], &didOk);
+            const int length = parts.size() == 2 ? parts[1].trimmed().toInt(&lengthOk) : 0;
+            if (!didOk || !lengthOk || did > 0xFFFF)
+                return CommandResult::Failure("Invalid DID length: " + entry.trimmed());
+            lengths.insert(static_cast<uint16_t>(did), length);
+        }
+
+        QMap<uint16_t, QByteArray> values;
+        const auto result = client->readDataByIdentifier(dids, lengths, values, cancel);
+        QVariantMap resp;
+        for (auto it = values.cbegin(); it != values.cend(); ++it)
+            resp[QString("0x%1").arg(it.key(), 4, 16, QChar('0')).toUpper()] = bytesToHexString(it.value());
+        return udsResult(result, QString("%1 DIDs read").arg(values.size()), resp);
+    };
+
+    auto udsWriteDidHandler = [udsClientFor, udsResult, parseHexId](
+                                  const QVariantMap& params, const QVariantMap& /*config*/,
+                                  const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        QString error;
+        auto client = udsClientFor(params, error);
+        if (!client)
+            return CommandResult::Failure(error);
+
+        bool ok = false;
+        const uint32_t did = parseHexId(params.value("did").toString(), &ok);
+        if (!ok || did > 0xFFFF)
+            return CommandResult::Failure("Invalid DID: " + params.value("did").toString());
+
+        const QByteArray value = hexStringToBytes(params.value("data").toString());
+        const auto result = client->writeDataByIdentifier(static_cast<uint16_t>(did), value);
+        QVariantMap resp;
+        resp["did"]  = QString("0x%1").arg(did, 4, 16, QChar('0')).toUpper();
+        resp["data"] = bytesToHexString(value);
+        return udsResult(result, "DID written", resp);
+    };
+
+    auto udsReadDtcHandler = [udsClientFor, udsResult, parseHexId](
+                                 const QVariantMap& params, const QVariantMap& /*config*/,
+                                 const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        QString error;
+        auto client = udsClientFor(params, error);
+        if (!client)
+            return CommandResult::Failure(error);
+
+        bool ok = false;
+        const uint32_t mask = parseHexId(params.value("status_mask", "0xFF").toString(), &ok);
+        if (!ok || mask > 0xFF)
+            return CommandResult::Failure("Invalid DTC status mask: " + params.value("status_mask").toString());
+
+        QList<CANManager::UdsClient::Dtc> dtcs;
+        uint8_t availability = 0;
+        const auto result = client->readDtcsByStatusMask(static_cast<uint8_t>(mask), dtcs, &availability);
+        QVariantMap resp;
+        QVariantList list;
+        for (const auto& dtc : dtcs) {
+            QVariantMap entry;
+            entry["dtc"]    = QString("%1").arg(dtc.code, 6, 16, QChar('0')).toUpper();
+            entry["status"] = QString("0x%1").arg(dtc.status, 2, 16, QChar('0')).toUpper();
+            list.append(entry);
+        }
+        resp["dtcs"]              = list;
+        resp["count"]             = dtcs.size();
+        resp["availability_mask"] = QString("0x%1").arg(availability, 2, 16, QChar('0')).toUpper();
+        return udsResult(result, QString("%1 DTCs match status mask").arg(dtcs.size()), resp);
+    };
+
+    auto udsRoutineHandler = [udsClientFor, udsResponse, udsResult, parseHexId](
+                                 const QVariantMap& params, const QVariantMap& /*config*/,
+                                 const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        QString error;
+        auto client = udsClientFor(params, error);
+        if (!client)
+            return CommandResult::Failure(error);
+
+        static const QMap<QString, uint8_t> controlTypes = {
+            {"start", 0x01}, {"stop", 0x02}, {"results", 0x03}
+        };
+        const QString action = params.value("action", "start").toString().trimmed().toLower();
+        bool ok = false;
+        const uint32_t routineId = parseHexId(params.value("routine_id").toString(), &ok);
+        if (!controlTypes.contains(action))
+            return CommandResult::Failure("Invalid routine action (start, stop or results): " + action);
+        if (!ok || routineId > 0xFFFF)
+            return CommandResult::Failure("Invalid routine ID: " + params.value("routine_id").toString());
+
+        CANManager::UdsClient::Response response;
+        const auto result = client->routineControl(controlTypes.value(action), static_cast<uint16_t>(routineId),
+                                                   hexStringToBytes(params.value("data").toString()), response);
+        QVariantMap resp = udsResponse(response);
+        resp["status_record"] = bytesToHexString(response.data.mid(4));
+        return udsResult(result, QString("Routine 0x%1 %2 done").arg(routineId, 4, 16, QChar('0')).arg(action), resp);
+    };
+
+    auto udsSecurityHandler = [udsClientFor, udsResult, parseHexId](
+                                  const QVariantMap& params, const QVariantMap& /*config*/,
+                                  const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        QString error;
+        auto client = udsClientFor(params, error);
+        if (!client)
+            return CommandResult::Failure(error);
+
+        bool ok = false;
+        const uint32_t level = parseHexId(params.value("level", "0x01").toString(), &ok);
+        if (!ok || level > 0xFF)
+            return CommandResult::Failure("Invalid security level: " + params.value("level").toString());
+
+        // A registered seed/key algorithm, or a fixed key
+        const QString algorithm = params.value("algorithm").toString().trimmed();
+        CANManager::UdsClient::KeyFunction computeKey;
+        if (!algorithm.isEmpty()) {
+            computeKey = CANManager::UdsClient::keyFunction(algorithm);
+            if (!computeKey)
+                return CommandResult::Failure("Unknown key algorithm: " + algorithm);
+        } else {
+            const QByteArray key = hexStringToBytes(params.value("key").toString());
+            computeKey = [key](uint8_t, const QByteArray&) { return key; };
+        }
+
+        const int seedLength = params.value("seed_length", 0).toInt();
+        const auto result = client->securityAccess(static_cast<uint8_t>(level), computeKey, seedLength);
+        QVariantMap resp;
+        resp["level"] = QString("0x%1").arg(level, 2, 16, QChar('0')).toUpper();
+        return udsResult(result, "Security access granted", resp);
+    };
+
+    auto udsTesterPresentHandler = [udsClientFor](const QVariantMap& params, const QVariantMap& /*config*/,
+                                                  const std::atomic<bool>* /*cancel*/) -> CommandResult {
+        QString error;
+        auto client = udsClientFor(params, error);
+        if (!client)
+            return CommandResult::Failure(error);
+
+        if (!params.value("enable", true).toBool()) {
+            client->stopTesterPresent();
+            return CommandResult::Success("Tester present stopped");
+        }
+        const int periodMs = params.value("period_ms", 2000).toInt();
+        const auto result = client->startTesterPresent(periodMs);
+        return result.success
+            ? CommandResult::Success(QString("Tester present every %1 ms while idle").arg(periodMs))
+            : CommandResult::Failure(result.errorMessage);
+    };
+
+    auto udsFlashHandler = [udsClientFor, parseHexId](const QVariantMap& params, const QVariantMap& /*config*/,
+                                                      const std::atomic<bool>* cancel) -> CommandResult {
+        static const QMap<QString, CANManager::UdsFlashImage::Format> formats = {
+            {"auto", CANManager::UdsFlashImage::Format::Auto},
+            {"hex",  CANManager::UdsFlashImage::Format::IntelHex},
+            {"srec", CANManager::UdsFlashImage::Format::SRecord},
+            {"raw",  CANManager::UdsFlashImage::Format::Raw}
+        };
+        const QString formatName = params.value("format", "auto").toString().trimmed().toLower();
+        if (!formats.contains(formatName))
+            return CommandResult::Failure("Invalid image format (auto, hex, srec or raw): " + formatName);
+        bool ok = false;
+        const uint32_t address = parseHexId(params.value("address", "0x0").toString(), &ok);
+        if (!ok)
+            return CommandResult::Failure("Invalid load address: " + params.value("address").toString());
+
+        CANManager::UdsFlashImage image;
+        const QString path = params.value("file").toString().trimmed();
+        CANManager::CANResult result = image.open(path, formats.value(formatName), address);
+        if (!result.success)
+            return CommandResult::Failure(result.errorMessage);
+
+        QString error;
+        auto client = udsClientFor(params, error);
+        if (!client)
+            return CommandResult::Failure(error);
+
+        CANManager::UdsFlashProgrammer::Options options;
+        options.eraseBeforeDownload = params.value("erase", false).toBool();
+        options.maxBlockLength      = params.value("max_block_length", 0).toInt();
+        CANManager::UdsFlashProgrammer::Report report;
+        result = CANManager::UdsFlashProgrammer(*client, options).program(image, report, cancel);
+
+        QVariantMap resp;
+        QVariantList segments;
+        for (const auto& segment : report.segments) {
+            QVariantMap entry;
+            entry["address"]          = QString("0x%1").arg(segment.address, 8, 16, QChar('0')).toUpper();
+            entry["size"]             = segment.size;
+            entry["crc32"]            = QString("0x%1").arg(segment.crc32, 8, 16, QChar('0')).toUpper();
+            entry["blocks"]           = segment.blocks;
+            entry["max_block_length"] = segment.maxBlockLength;
+            segments.append(entry);
+        }
+        resp["file"]             = path;
+        resp["format"]           = CANManager::UdsFlashImage::formatName(image.format());
+        resp["image_bytes"]      = static_cast<qulonglong>(image.totalSize());
+        resp["bytes"]            = static_cast<qulonglong>(report.bytes);
+        resp["blocks"]           = report.blocks;
+        resp["segments"]         = segments;
+        resp["elapsed_ms"]       = report.elapsedMs;
+        resp["bytes_per_second"] = report.bytesPerSecond;
+        resp["block_min_ms"]     = report.minBlockMs;
+        resp["block_avg_ms"]     = report.avgBlockMs;
+        resp["block_p95_ms"]     = report.p95BlockMs;
+        resp["block_max_ms"]     = report.maxBlockMs;
+        if (!result.success) {
+            CommandResult failed = CommandResult::Failure(result.errorMessage);
+            failed.responseData = resp;
+            return failed;
+        }
+        return CommandResult::Success(QString("%1 bytes programmed at %2 KiB/s")
+                                          .arg(report.bytes).arg(report.bytesPerSecond / 1024.0, 0, 'f', 1), resp);
+    };
+
+    // =========================================================================
+    // Assemble parameter lists and register all CAN commands
     // =========================================================================
 
     // 1. CANHS_Tx
@@ -914,6 +2073,873 @@ void CommandRegistry::registerCANCommands()
             .handler = canTxRxMatchHandler(/*isFD=*/true)
         });
     }
+
+    // 7. CAN_Cyclic_Start
+    {
+        auto params = baseTxParams("Payload bytes in hex (max 8 bytes, up to 64 with CAN FD)");
+        params.append(periodParam());
+        params.append(fdParam());
+        registerCommand({
+            .id = "can_cyclic_start",
+            .name = "CAN_Cyclic_Start",
+            .description = "Start transmitting a CAN message periodically in the background "
+                           "(replaces a running cyclic message with the same ID)",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = canCyclicStartHandler
+        });
+    }
+
+    // 8. CAN_Cyclic_Update
+    {
+        auto params = baseTxParams("New payload bytes in hex");
+        params.append(fdParam());
+        registerCommand({
+            .id = "can_cyclic_update",
+            .name = "CAN_Cyclic_Update",
+            .description = "Replace the payload of a running cyclic message; the next cycle sends it",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = canCyclicUpdateHandler
+        });
+    }
+
+    // 9. CAN_Cyclic_Stop
+    {
+        auto params = baseTxParams({});
+        params.removeIf([](const ParameterDef& p) { return p.name == "data"; });
+        registerCommand({
+            .id = "can_cyclic_stop",
+            .name = "CAN_Cyclic_Stop",
+            .description = "Stop a cyclic message and report its achieved period and jitter",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = canCyclicStopHandler
+        });
+    }
+
+    // 10. CAN_Trace_Start
+    registerCommand({
+        .id = "can_trace_start",
+        .name = "CAN_Trace_Start",
+        .description = "Start recording all traffic of one or more CAN slots to an ASC or BLF trace file",
+        .category = CommandCategory::CAN,
+        .parameters = {
+            {
+                .name = "slots",
+                .displayName = "CAN Slots",
+                .description = "Comma-separated slot names; they become trace channels 1, 2, ... in this order",
+                .type = ParameterType::String,
+                .defaultValue = "CAN 1",
+                .required = true
+            },
+            traceFileParam(),
+            {
+                .name = "rotate_mb",
+                .displayName = "Rotate Size",
+                .description = "Start a new numbered file after this size (0 = single file)",
+                .type = ParameterType::Integer,
+                .defaultValue = 0,
+                .required = false,
+                .minValue = 0,
+                .maxValue = 65536,
+                .unit = "MB"
+            },
+            {
+                .name = "rotate_s",
+                .displayName = "Rotate Interval",
+                .description = "Start a new numbered file after this long (0 = single file)",
+                .type = ParameterType::Integer,
+                .defaultValue = 0,
+                .required = false,
+                .minValue = 0,
+                .maxValue = 86400,
+                .unit = "s"
+            }
+        },
+        .handler = canTraceStartHandler
+    });
+
+    // 11. CAN_Trace_Stop
+    registerCommand({
+        .id = "can_trace_stop",
+        .name = "CAN_Trace_Stop",
+        .description = "Stop a trace recording, flush it to disk and report written and dropped frames",
+        .category = CommandCategory::CAN,
+        .parameters = { traceFileParam() },
+        .handler = canTraceStopHandler
+    });
+
+    // 12. CAN_Replay
+    registerCommand({
+        .id = "can_replay",
+        .name = "CAN_Replay",
+        .description = "Replay an ASC or BLF trace onto a CAN slot with the original timing "
+                       "and report the timing error distribution",
+        .category = CommandCategory::CAN,
+        .parameters = {
+            baseTxParams({}).first(),
+            {
+                .name = "file",
+                .displayName = "Trace File",
+                .description = "Vector ASC or BLF trace to replay",
+                .type = ParameterType::FilePath,
+                .defaultValue = "trace.asc",
+                .required = true
+            },
+            {
+                .name = "channel",
+                .displayName = "Trace Channel",
+                .description = "Replay only frames of this trace channel (0 = all channels)",
+                .type = ParameterType::Integer,
+                .defaultValue = 0,
+                .required = false,
+                .minValue = 0,
+                .maxValue = 64
+            },
+            {
+                .name = "speed",
+                .displayName = "Speed",
+                .description = "Time scale (2 = twice as fast, 0.5 = half speed)",
+                .type = ParameterType::Double,
+                .defaultValue = 1.0,
+                .required = false,
+                .minValue = 0.01,
+                .maxValue = 100.0
+            },
+            {
+                .name = "loops",
+                .displayName = "Loops",
+                .description = "Passes over the trace (0 = until CAN_Replay_Stop)",
+                .type = ParameterType::Integer,
+                .defaultValue = 1,
+                .required = false,
+                .minValue = 0,
+                .maxValue = 1000000
+            },
+            {
+                .name = "ids",
+                .displayName = "Include IDs",
+                .description = "Replay only these hex IDs, comma-separated, 'id' or 'id/mask' (empty = all)",
+                .type = ParameterType::String,
+                .defaultValue = "",
+                .required = false
+            },
+            {
+                .name = "exclude_ids",
+                .displayName = "Exclude IDs",
+                .description = "Never replay these IDs, e.g. the DUT's own messages ('id' or 'id/mask')",
+                .type = ParameterType::String,
+                .defaultValue = "",
+                .required = false
+            },
+            {
+                .name = "remap",
+                .displayName = "ID Remap",
+                .description = "Send trace IDs under other IDs, e.g. '0x100=0x101, 0x200=0x201'",
+                .type = ParameterType::String,
+                .defaultValue = "",
+                .required = false
+            },
+            {
+                .name = "wait",
+                .displayName = "Wait",
+                .description = "Wait for the replay to finish and report its timing; "
+                               "otherwise it runs in the background",
+                .type = ParameterType::Boolean,
+                .defaultValue = true,
+                .required = false
+            }
+        },
+        .handler = canReplayHandler
+    });
+
+    // 13. CAN_Replay_Stop
+    registerCommand({
+        .id = "can_replay_stop",
+        .name = "CAN_Replay_Stop",
+        .description = "Stop a background replay and report sent frames and timing error",
+        .category = CommandCategory::CAN,
+        .parameters = { baseTxParams({}).first() },
+        .handler = canReplayStopHandler
+    });
+
+    // 14. CAN_IsoTp_TxRx
+    {
+        auto params = baseTxParams("Request payload in hex; longer than one frame is segmented (ISO 15765-2)");
+        params += rxParams();
+        params.append(fdParam());
+        params.append({
+            .name = "padding",
+            .displayName = "Padding",
+            .description = "Pad frames to 8 bytes with 0xCC",
+            .type = ParameterType::Boolean,
+            .defaultValue = true,
+            .required = false
+        });
+        params.append({
+            .name = "st_min",
+            .displayName = "STmin",
+            .description = "Separation time requested from the ECU for its consecutive frames "
+                           "(raw byte: 0-127 ms, 0xF1-0xF9 = 100-900 µs)",
+            .type = ParameterType::Integer,
+            .defaultValue = 0,
+            .required = false,
+            .minValue = 0,
+            .maxValue = 255
+        });
+        ParameterDef expected = expectedResponseParam();
+        expected.description += " Leave empty to accept any response.";
+        expected.required = false;
+        params.append(expected);
+        registerCommand({
+            .id = "can_isotp_txrx",
+            .name = "CAN_IsoTp_TxRx",
+            .description = "Send a diagnostic request over ISO-TP and collect the (multi-frame) response",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = canIsoTpTxRxHandler
+        });
+    }
+
+    // 15. UDS_Request
+    {
+        auto params = udsParams();
+        params.append(baseTxParams("Request bytes in hex, service ID first (e.g. '22 F1 90')")[2]);
+        params.last().defaultValue = "3E 00";
+        ParameterDef expected = expectedResponseParam();
+        expected.description += " Leave empty to accept any positive response.";
+        expected.required = false;
+        params.append(expected);
+        registerCommand({
+            .id = "uds_request",
+            .name = "UDS_Request",
+            .description = "Send a raw UDS request and wait for the final response (NRC 0x78 extends the timeout)",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = udsRequestHandler
+        });
+    }
+
+    // 16. UDS_Session
+    {
+        auto params = udsParams();
+        params.append(stringParam("session", "Session", "Diagnostic session in hex: 0x01 default, "
+                                  "0x02 programming, 0x03 extended", "0x03"));
+        registerCommand({
+            .id = "uds_session",
+            .name = "UDS_Session",
+            .description = "DiagnosticSessionControl (0x10); adopts the P2/P2* timing the ECU reports",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = udsSessionHandler
+        });
+    }
+
+    // 17. UDS_Read_DID
+    {
+        auto params = udsParams();
+        params.append(stringParam("dids", "DIDs", "Data identifiers in hex, comma-separated; "
+                                  "several are read per request", "0xF190"));
+        params.append(stringParam("lengths", "DID Lengths", "Data lengths for splitting multi-DID responses, "
+                                  "e.g. '0xF190=17' (optional)", "", false));
+        registerCommand({
+            .id = "uds_read_did",
+            .name = "UDS_Read_DID",
+            .description = "ReadDataByIdentifier (0x22) for any number of DIDs",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = udsReadDidHandler
+        });
+    }
+
+    // 18. UDS_Write_DID
+    {
+        auto params = udsParams();
+        params.append(stringParam("did", "DID", "Data identifier in hex", "0xF190"));
+        params.append(baseTxParams("Data record in hex")[2]);
+        registerCommand({
+            .id = "uds_write_did",
+            .name = "UDS_Write_DID",
+            .description = "WriteDataByIdentifier (0x2E)",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = udsWriteDidHandler
+        });
+    }
+
+    // 19. UDS_Read_DTC
+    {
+        auto params = udsParams();
+        params.append(stringParam("status_mask", "Status Mask", "DTC status mask in hex", "0xFF"));
+        registerCommand({
+            .id = "uds_read_dtc",
+            .name = "UDS_Read_DTC",
+            .description = "ReadDTCInformation (0x19 0x02): DTCs matching a status mask",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = udsReadDtcHandler
+        });
+    }
+
+    // 20. UDS_Routine
+    {
+        auto params = udsParams();
+        params.append(stringParam("routine_id", "Routine ID", "Routine identifier in hex", "0xFF00"));
+        params.append(stringParam("action", "Action", "start, stop or results", "start"));
+        params.append(baseTxParams("Routine control option record in hex (optional)")[2]);
+        params.last().defaultValue = "";
+        params.last().required = false;
+        registerCommand({
+            .id = "uds_routine",
+            .name = "UDS_Routine",
+            .description = "RoutineControl (0x31): start, stop or request results of a routine",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = udsRoutineHandler
+        });
+    }
+
+    // 21. UDS_Security_Access
+    {
+        auto params = udsParams();
+        params.append(stringParam("level", "Level", "Seed request level in hex (odd: 0x01, 0x03, ...)", "0x01"));
+        params.append(stringParam("algorithm", "Key Algorithm", "Name of a registered seed/key algorithm "
+                                  "(empty = send the fixed key)", "", false));
+        params.append(stringParam("key", "Key (Hex)", "Fixed key when no algorithm is given", "", false));
+        params.append({
+            .name = "seed_length",
+            .displayName = "Seed Length",
+            .description = "Expected seed length; other lengths fail (0 = any non-empty seed)",
+            .type = ParameterType::Integer,
+            .defaultValue = 0,
+            .required = false,
+            .minValue = 0,
+            .maxValue = 0xFFF,
+            .unit = "bytes"
+        });
+        registerCommand({
+            .id = "uds_security_access",
+            .name = "UDS_Security_Access",
+            .description = "SecurityAccess (0x27): request a seed and send the computed key",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = udsSecurityHandler
+        });
+    }
+
+    // 22. UDS_Tester_Present
+    {
+        auto params = udsParams();
+        params.append({
+            .name = "enable",
+            .displayName = "Enable",
+            .description = "Start (true) or stop (false) the background tester present",
+            .type = ParameterType::Boolean,
+            .defaultValue = true,
+            .required = false
+        });
+        params.append({
+            .name = "period_ms",
+            .displayName = "Period",
+            .description = "Send 0x3E 0x80 when no request was sent for this long",
+            .type = ParameterType::Duration,
+            .defaultValue = 2000,
+            .required = false,
+            .minValue = 50,
+            .maxValue = 60000,
+            .unit = "ms"
+        });
+        registerCommand({
+            .id = "uds_tester_present",
+            .name = "UDS_Tester_Present",
+            .description = "Keep the diagnostic session alive from a background timer until stopped or the slot closes",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = udsTesterPresentHandler
+        });
+    }
+
+    // 23. UDS_Flash
+    {
+        auto params = udsParams();
+        params.append({
+            .name = "file",
+            .displayName = "Image File",
+            .description = "Intel HEX, S-record or raw binary image",
+            .type = ParameterType::FilePath,
+            .defaultValue = "firmware.hex",
+            .required = true
+        });
+        params.append({
+            .name = "format",
+            .displayName = "Format",
+            .description = "Image format; auto detects HEX and S-record from the contents",
+            .type = ParameterType::Enum,
+            .defaultValue = "auto",
+            .required = false,
+            .enumValues = {"auto", "hex", "srec", "raw"}
+        });
+        params.append(stringParam("address", "Load Address", "Start address of a raw image in hex", "0x0", false));
+        params.append({
+            .name = "erase",
+            .displayName = "Erase",
+            .description = "Erase each segment first (RoutineControl 0xFF00)",
+            .type = ParameterType::Boolean,
+            .defaultValue = false,
+            .required = false
+        });
+        params.append({
+            .name = "max_block_length",
+            .displayName = "Max Block Length",
+            .description = "Upper limit for the ECU's TransferData block length (0 = as reported by the ECU, at most 4095)",
+            .type = ParameterType::Integer,
+            .defaultValue = 0,
+            .required = false,
+            .minValue = 0,
+            .maxValue = 0xFFFFFF,
+            .unit = "bytes"
+        });
+        registerCommand({
+            .id = "uds_flash",
+            .name = "UDS_Flash",
+            .description = "Download an image with RequestDownload / TransferData / RequestTransferExit "
+                           "and report throughput and per-block latency",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = udsFlashHandler
+        });
+    }
+
+    // 24. CAN_Set_Filter
+    registerCommand({
+        .id = "can_set_filter",
+        .name = "CAN_Set_Filter",
+        .description = "Accept only the given IDs on a CAN slot, filtered by the driver or controller "
+                       "before frames reach the application (applies to every reader of the slot)",
+        .category = CommandCategory::CAN,
+        .parameters = {
+            baseTxParams({}).first(),
+            {
+                .name = "ids",
+                .displayName = "Accepted IDs",
+                .description = "Hex IDs, comma-separated, 'id' or 'id/mask' (empty = accept all). "
+                               "Include response IDs used by TxRx, ISO-TP and UDS steps.",
+                .type = ParameterType::String,
+                .defaultValue = "",
+                .required = false
+            }
+        },
+        .handler = canSetFilterHandler
+    });
+
+    // 25. CAN_Get_Statistics
+    registerCommand({
+        .id = "can_get_statistics",
+        .name = "CAN_Get_Statistics",
+        .description = "Report bus load, frame rates, error frames, TX requests vs confirmations, "
+                       "queue high-water marks and the busiest IDs of a CAN slot",
+        .category = CommandCategory::CAN,
+        .parameters = {
+            baseTxParams({}).first(),
+            {
+                .name = "top_ids",
+                .displayName = "Top IDs",
+                .description = "Number of busiest CAN IDs to report",
+                .type = ParameterType::Integer,
+                .defaultValue = 10,
+                .required = false,
+                .minValue = 0,
+                .maxValue = 4096
+            },
+            {
+                .name = "max_bus_load_pct",
+                .displayName = "Max Bus Load",
+                .description = "Fail if the peak bus load exceeds this (0 = report only)",
+                .type = ParameterType::Double,
+                .defaultValue = 0.0,
+                .required = false,
+                .minValue = 0,
+                .maxValue = 100,
+                .unit = "%"
+            },
+            {
+                .name = "reset",
+                .displayName = "Reset",
+                .description = "Zero counters, peaks and history after reporting",
+                .type = ParameterType::Boolean,
+                .defaultValue = false,
+                .required = false
+            }
+        },
+        .handler = canGetStatisticsHandler
+    });
+
+    // Source / destination slots shared by the gateway commands
+    const QVector<ParameterDef> gatewaySlotParams = {
+        {
+            .name = "source",
+            .displayName = "Source Slot",
+            .description = "CAN slot whose received traffic is forwarded",
+            .type = ParameterType::String,
+            .defaultValue = "CAN 1",
+            .required = true
+        },
+        {
+            .name = "destination",
+            .displayName = "Destination Slot",
+            .description = "CAN slot the traffic is transmitted on",
+            .type = ParameterType::String,
+            .defaultValue = "CAN 2",
+            .required = true
+        }
+    };
+
+    // 26. CAN_Gateway_Start
+    {
+        QVector<ParameterDef> params = gatewaySlotParams;
+        params.append({
+            .name = "rules",
+            .displayName = "Rules",
+            .description = "JSON rule list, e.g. [{\"id\": \"0x500\", \"mask\": \"0x700\", \"action\": \"block\"}, "
+                           "{\"id\": \"0x1A0\", \"delay_ms\": 20}, {\"id\": \"0x3E9\", \"new_id\": \"0x3EA\"}, "
+                           "{\"id\": \"0x120\", \"signals\": {\"VehicleSpeed\": 0}}]",
+            .type = ParameterType::String,
+            .defaultValue = "",
+            .required = false
+        });
+        params.append({
+            .name = "rule_file",
+            .displayName = "Rule File",
+            .description = "JSON rule file (used instead of Rules when set)",
+            .type = ParameterType::FilePath,
+            .defaultValue = "",
+            .required = false
+        });
+        params.append({
+            .name = "default_action",
+            .displayName = "Default Action",
+            .description = "Frames no rule matches; as_rules keeps the rule set's \"default\" (forward if absent)",
+            .type = ParameterType::Enum,
+            .defaultValue = "as_rules",
+            .required = false,
+            .enumValues = {"as_rules", "forward", "block"}
+        });
+        params.append({
+            .name = "dbc_channel",
+            .displayName = "DBC Channel",
+            .description = "DBC used to resolve signal rewrites",
+            .type = ParameterType::Integer,
+            .defaultValue = 1,
+            .required = false,
+            .minValue = 1,
+            .maxValue = DBCManager::DBCDatabaseManager::MAX_CHANNELS
+        });
+        registerCommand({
+            .id = "can_gateway_start",
+            .name = "CAN_Gateway_Start",
+            .description = "Forward one CAN slot's traffic to another, blocking, delaying or rewriting "
+                           "IDs and signals by rule (first match wins); runs until CAN_Gateway_Stop",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = canGatewayStartHandler
+        });
+    }
+
+    // 27. CAN_Gateway_Stop
+    registerCommand({
+        .id = "can_gateway_stop",
+        .name = "CAN_Gateway_Stop",
+        .description = "Stop a gateway and report its forwarding counters, per-rule counters and latency",
+        .category = CommandCategory::CAN,
+        .parameters = gatewaySlotParams,
+        .handler = canGatewayStopHandler
+    });
+
+    // 28. CAN_Gateway_Stats
+    {
+        QVector<ParameterDef> params = gatewaySlotParams;
+        params.append({
+            .name = "max_latency_us",
+            .displayName = "Max Latency",
+            .description = "Fail if the longest forwarding latency exceeds this (0 = report only)",
+            .type = ParameterType::Double,
+            .defaultValue = 0.0,
+            .required = false,
+            .minValue = 0,
+            .maxValue = 1000000,
+            .unit = "us"
+        });
+        registerCommand({
+            .id = "can_gateway_stats",
+            .name = "CAN_Gateway_Stats",
+            .description = "Report a running gateway's counters, per-rule counters and latency; "
+                           "fails on lost frames or when the latency limit is exceeded",
+            .category = CommandCategory::CAN,
+            .parameters = params,
+            .handler = canGatewayStatsHandler
+        });
+    }
+
+    // 29. RestBus_Start
+    registerCommand({
+        .id = "restbus_start",
+        .name = "RestBus_Start",
+        .description = "Simulate DBC nodes that are not on the bench: send their messages cyclically "
+                       "with the DBC cycle times and start values until RestBus_Stop",
+        .category = CommandCategory::CAN,
+        .parameters = {
+            baseTxParams({}).first(),
+            {
+                .name = "nodes",
+                .displayName = "Nodes",
+                .description = "Sender nodes to simulate, comma-separated (empty = every sender in the DBC)",
+                .type = ParameterType::String,
+                .defaultValue = "",
+                .required = false
+            },
+            {
+                .name = "exclude",
+                .displayName = "Excluded Messages",
+                .description = "Message names not to send, comma-separated",
+                .type = ParameterType::String,
+                .defaultValue = "",
+                .required = false
+            },
+            {
+                .name = "default_cycle_ms",
+                .displayName = "Default Cycle",
+                .description = "Period for messages without GenMsgCycleTime (0 = do not send them)",
+                .type = ParameterType::Integer,
+                .defaultValue = 0,
+                .required = false,
+                .minValue = 0,
+                .maxValue = 60000,
+                .unit = "ms"
+            },
+            {
+                .name = "dbc_channel",
+                .displayName = "DBC Channel",
+                .description = "DBC describing the network",
+                .type = ParameterType::Integer,
+                .defaultValue = 1,
+                .required = false,
+                .minValue = 1,
+                .maxValue = DBCManager::DBCDatabaseManager::MAX_CHANNELS
+            }
+        },
+        .handler = restBusStartHandler
+    });
+
+    // 30. RestBus_Set_Signal
+    registerCommand({
+        .id = "restbus_set_signal",
+        .name = "RestBus_Set_Signal",
+        .description = "Override signals of a simulated message; the next cycle sends the new values",
+        .category = CommandCategory::CAN,
+        .parameters = {
+            baseTxParams({}).first(),
+            {
+                .name = "message",
+                .displayName = "Message",
+                .description = "DBC message name",
+                .type = ParameterType::String,
+                .defaultValue = "",
+                .required = true
+            },
+            {
+                .name = "signals",
+                .displayName = "Signals",
+                .description = "Physical values, e.g. VehicleSpeed=50, Gear=3",
+                .type = ParameterType::String,
+                .defaultValue = "",
+                .required = false
+            },
+            {
+                .name = "reset",
+                .displayName = "Reset First",
+                .description = "Restore the DBC start values before applying the signals",
+                .type = ParameterType::Boolean,
+                .defaultValue = false,
+                .required = false
+            }
+        },
+        .handler = restBusSetSignalHandler
+    });
+
+    // 31. RestBus_Stop
+    registerCommand({
+        .id = "restbus_stop",
+        .name = "RestBus_Stop",
+        .description = "Stop the rest-bus simulation of a slot and report frames sent, missed cycles and errors",
+        .category = CommandCategory::CAN,
+        .parameters = { baseTxParams({}).first() },
+        .handler = restBusStopHandler
+    });
+
+    // 32. NM_Start
+    registerCommand({
+        .id = "nm_start",
+        .name = "NM_Start",
+        .description = "Request the network for simulated AUTOSAR CanNm nodes: they send NM PDUs "
+                       "(Repeat Message, then Normal Operation) and keep the bus awake until NM_Release",
+        .category = CommandCategory::CAN,
+        .parameters = {
+            baseTxParams({}).first(),
+            {
+                .name = "nodes",
+                .displayName = "NM Nodes",
+                .description = "Simulated node IDs, hex, comma-separated (NM PDU ID = base ID + node ID)",
+                .type = ParameterType::String,
+                .defaultValue = "0x10",
+                .required = true
+            },
+            {
+                .name = "base_id",
+                .displayName = "NM Base ID",
+                .description = "First NM PDU ID (hex)",
+                .type = ParameterType::String,
+                .defaultValue = "0x500",
+                .required = false
+            },
+            {
+                .name = "id_mask",
+                .displayName = "NM ID Mask",
+                .description = "Received IDs equal to the base ID under this mask are NM PDUs (hex)",
+                .type = ParameterType::String,
+                .defaultValue = "0x700",
+                .required = false
+            },
+            {
+                .name = "extended_id",
+                .displayName = "Extended IDs",
+                .description = "NM PDUs use 29-bit identifiers",
+                .type = ParameterType::Boolean,
+                .defaultValue = false,
+                .required = false
+            },
+            {
+                .name = "cycle_ms",
+                .displayName = "Message Cycle",
+                .description = "CanNmMsgCycleTime",
+                .type = ParameterType::Integer,
+                .defaultValue = 100,
+                .required = false,
+                .minValue = 1,
+                .maxValue = 10000,
+                .unit = "ms"
+            },
+            {
+                .name = "repeat_message_ms",
+                .displayName = "Repeat Message Time",
+                .description = "CanNmRepeatMessageTime",
+                .type = ParameterType::Integer,
+                .defaultValue = 1500,
+                .required = false,
+                .minValue = 0,
+                .maxValue = 60000,
+                .unit = "ms"
+            },
+            {
+                .name = "timeout_ms",
+                .displayName = "NM Timeout",
+                .description = "CanNmTimeoutTime",
+                .type = ParameterType::Integer,
+                .defaultValue = 2000,
+                .required = false,
+                .minValue = 1,
+                .maxValue = 60000,
+                .unit = "ms"
+            },
+            {
+                .name = "wait_bus_sleep_ms",
+                .displayName = "Wait Bus-Sleep Time",
+                .description = "CanNmWaitBusSleepTime",
+                .type = ParameterType::Integer,
+                .defaultValue = 1500,
+                .required = false,
+                .minValue = 0,
+                .maxValue = 60000,
+                .unit = "ms"
+            },
+            {
+                .name = "active_wakeup",
+                .displayName = "Active Wakeup Bit",
+                .description = "Set the CBV Active Wakeup bit after waking the network",
+                .type = ParameterType::Boolean,
+                .defaultValue = true,
+                .required = false
+            },
+            {
+                .name = "pdu_length",
+                .displayName = "PDU Length",
+                .description = "NM PDU length (byte 0 node ID, byte 1 control bit vector, rest 0xFF)",
+                .type = ParameterType::Integer,
+                .defaultValue = 8,
+                .required = false,
+                .minValue = 2,
+                .maxValue = 8,
+                .unit = "bytes"
+            }
+        },
+        .handler = nmStartHandler
+    });
+
+    // 33. NM_Release
+    registerCommand({
+        .id = "nm_release",
+        .name = "NM_Release",
+        .description = "Release the network for simulated CanNm nodes: they stop sending and go to "
+                       "Bus-Sleep once no NM PDU was seen for the NM timeout plus the wait bus-sleep time",
+        .category = CommandCategory::CAN,
+        .parameters = {
+            baseTxParams({}).first(),
+            {
+                .name = "nodes",
+                .displayName = "NM Nodes",
+                .description = "Node IDs to release, hex, comma-separated (empty = all)",
+                .type = ParameterType::String,
+                .defaultValue = "",
+                .required = false
+            }
+        },
+        .handler = nmReleaseHandler
+    });
+
+    // 34. NM_Wait_Bus_Sleep
+    registerCommand({
+        .id = "nm_wait_bus_sleep",
+        .name = "NM_Wait_Bus_Sleep",
+        .description = "Wait until the simulated nodes are in Bus-Sleep and no remote node sends NM PDUs; "
+                       "reports the release-to-sleep time and the remote nodes still awake",
+        .category = CommandCategory::CAN,
+        .parameters = {
+            baseTxParams({}).first(),
+            {
+                .name = "timeout_ms",
+                .displayName = "Timeout",
+                .description = "Fail if the network is still awake after this",
+                .type = ParameterType::Integer,
+                .defaultValue = 10000,
+                .required = false,
+                .minValue = 0,
+                .maxValue = 3600000,
+                .unit = "ms"
+            },
+            {
+                .name = "max_sleep_ms",
+                .displayName = "Max Release-to-Sleep",
+                .description = "Fail if bus sleep came later than this after the release (0 = report only)",
+                .type = ParameterType::Integer,
+                .defaultValue = 0,
+                .required = false,
+                .minValue = 0,
+                .maxValue = 3600000,
+                .unit = "ms"
+            }
+        },
+        .handler = nmWaitBusSleepHandler
+    });
 }
 
 //=============================================================================
@@ -0,0 +1,490 @@
+/**
+ * @file FlightRecorder.cpp
+ * @brief Pre-trigger CAN / serial flight recorder — implementation.
+ */
+
+#include "FlightRecorder.h"
+
+#include <CANManager.h>
+#include <CANTraceWriter.h>
+
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace CANManager;
+
+namespace TestExecutor {
+
+namespace {
+
+/// A capture/driver clock difference that jumps by more than this means the
+/// slot was reopened (new driver clock) within the window
+constexpr qint64 CLOCK_JUMP_NS = 1000000000;
+
+constexpr qint64 NS_PER_MS = 1000000;
+
+} // namespace
+
+/// Copies a slot's dispatcher batches into its ring
+class FlightRecorder::SlotTap : public CANRxDispatcher::Tap
+{
+public:
+    SlotTap(std::shared_ptr<CanRing> ring, const QElapsedTimer& clock)
+        : m_ring(std::move(ring))
+        , m_clock(clock)
+    {
+    }
+
+    void onFrames(const CANMessage* frames, int count) override
+    {
+        const qint64 now = m_clock.nsecsElapsed();
+        m_ring->write(static_cast<size_t>(count), [&](CanEntry& entry, size_t i) {
+            entry.captureNs = now;
+            entry.msg       = frames[i];
+        });
+    }
+
+private:
+    std::shared_ptr<CanRing> m_ring;
+    const QElapsedTimer&     m_clock;
+};
+
+// ============================================================================
+//  Singleton
+// ============================================================================
+
+FlightRecorder& FlightRecorder::instance()
+{
+    static FlightRecorder instance;
+    return instance;
+}
+
+FlightRecorder::FlightRecorder()
+{
+    m_clockStart = QDateTime::currentDateTime();
+    m_clock.start();
+
+    // Follow slots opened and closed during a run
+    auto& can = CANBusManager::instance();
+    connect(&can, &CANBusManager::slotOpened, this, &FlightRecorder::attachSlot, Qt::DirectConnection);
+    connect(&can, &CANBusManager::slotClosed, this, &FlightRecorder::detachSlot, Qt::DirectConnection);
+}
+
+FlightRecorder::~FlightRecorder()
+{
+    stop();
+}
+
+// ============================================================================
+//  Lifecycle
+// ============================================================================
+
+void FlightRecorder::start(const Options& options)
+{
+    stop();
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_options  = options;
+        m_running  = true;
+        m_stopping = false;
+        m_serialTable.store(std::make_shared<const SerialTable>());
+
+        m_thread = QThread::create([this]() { run(); });
+        m_thread->setObjectName(QStringLiteral("FLIGHT_RECORDER"));
+        m_thread->start();
+    }
+
+    for (const QString& slotName : CANBusManager::instance().openSlotNames())
+        attachSlot(slotName);
+
+    qDebug() << "[FlightRecorder] Capturing" << options.preTriggerMs << "ms before /"
+             << options.postTriggerMs << "ms after each trigger";
+}
+
+void FlightRecorder::stop()
+{
+    QThread* thread = nullptr;
+    std::map<QString, std::shared_ptr<SlotTap>> taps;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_running  = false;
+        m_stopping = true;
+        m_wake.wakeAll();
+        std::swap(thread, m_thread);
+        taps.swap(m_taps);
+    }
+
+    for (const auto& [slotName, tap] : taps)
+        CANBusManager::instance().removeTap(slotName, tap);
+
+    // Pending dumps are written right away with whatever the rings hold
+    if (thread) {
+        thread->wait();
+        delete thread;
+    }
+
+    m_serialTable.store(nullptr);
+    QMutexLocker locker(&m_mutex);
+    m_canRings.clear();
+    m_pending.clear();
+    m_idle.wakeAll();
+}
+
+void FlightRecorder::acquire(const Options& options)
+{
+    QMutexLocker useLocker(&m_useMutex);
+    const bool running = isRunning();
+    const Options current = this->options();
+    const bool same = current.preTriggerMs == options.preTriggerMs
+                   && current.postTriggerMs == options.postTriggerMs
+                   && current.canFramesPerSlot == options.canFramesPerSlot
+                   && current.serialChunksPerPort == options.serialChunksPerPort;
+
+    if (!running || (m_users == 0 && !same))
+        start(options);
+    else if (!same)
+        qWarning() << "[FlightRecorder] In use by another session, keeping"
+                   << current.preTriggerMs << "ms before /" << current.postTriggerMs << "ms after";
+    ++m_users;
+}
+
+void FlightRecorder::release()
+{
+    QMutexLocker useLocker(&m_useMutex);
+    if (m_users > 0)
+        --m_users;
+}
+
+void FlightRecorder::stopIfUnused()
+{
+    QMutexLocker useLocker(&m_useMutex);
+    if (m_users > 0)
+        return;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_pending.empty() || m_writing)
+            return;
+    }
+    stop();
+}
+
+bool FlightRecorder::isRunning() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_running;
+}
+
+FlightRecorder::Options FlightRecorder::options() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_options;
+}
+
+// ============================================================================
+//  Trigger
+// ============================================================================
+
+QString FlightRecorder::trigger(const QString& outputDir)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_running)
+        return QString();
+
+    m_pending.push_back({outputDir, m_clock.nsecsElapsed()});
+    m_wake.wakeAll();
+
+    qDebug() << "[FlightRecorder] Triggered, dumping to" << outputDir;
+    return outputDir;
+}
+
+bool FlightRecorder::waitForDumps(int timeoutMs)
+{
+    const QDeadlineTimer deadline(timeoutMs);      // Negative: no timeout
+
+    QMutexLocker locker(&m_mutex);
+    while (!m_pending.empty() || m_writing) {
+        if (!m_idle.wait(&m_mutex, deadline))
+            return false;
+    }
+    return true;
+}
+
+bool FlightRecorder::waitForDumps(const QStringList& outputDirs, int timeoutMs)
+{
+    const QDeadlineTimer deadline(timeoutMs);
+
+    QMutexLocker locker(&m_mutex);
+    while (dumpPendingLocked(outputDirs)) {
+        if (!m_idle.wait(&m_mutex, deadline))
+            return false;
+    }
+    return true;
+}
+
+bool FlightRecorder::dumpPendingLocked(const QStringList& outputDirs) const
+{
+    if (m_writing && outputDirs.contains(m_writingDir))
+        return true;
+    return std::any_of(m_pending.begin(), m_pending.end(),
+                       [&](const Dump& dump) { return outputDirs.contains(dump.outputDir); });
+}
+
+// ============================================================================
+//  Capture
+// ============================================================================
+
+void FlightRecorder::recordSerial(const QString& portName, bool transmitted, const QByteArray& data)
+{
+    if (data.isEmpty())
+        return;
+
+    const auto table = m_serialTable.load();
+    if (!table)
+        return;
+
+    std::shared_ptr<SerialRing> ring;
+    auto it = table->find(portName);
+    if (it != table->end())
+        ring = it->second;
+    else if (!(ring = serialRing(portName)))
+        return;
+
+    const qint64 now = m_clock.nsecsElapsed();
+    const size_t size = static_cast<size_t>(data.size());
+    const size_t chunks = (size + SERIAL_CHUNK_BYTES - 1) / SERIAL_CHUNK_BYTES;
+    ring->write(chunks, [&](SerialEntry& entry, size_t i) {
+        const size_t offset = i * SERIAL_CHUNK_BYTES;
+        entry.captureNs   = now;
+        entry.transmitted = transmitted;
+        entry.length      = static_cast<uint8_t>(std::min<size_t>(SERIAL_CHUNK_BYTES, size - offset));
+        std::memcpy(entry.data, data.constData() + offset, entry.length);
+    });
+}
+
+std::shared_ptr<FlightRecorder::SerialRing> FlightRecorder::serialRing(const QString& portName)
+{
+    // First traffic on a port: publish a table with a new ring (once per port)
+    QMutexLocker locker(&m_mutex);
+    const auto table = m_serialTable.load();
+    if (!m_running || !table)
+        return nullptr;
+
+    auto it = table->find(portName);
+    if (it != table->end())
+        return it->second;
+
+    auto next = std::make_shared<SerialTable>(*table);
+    auto ring = std::make_shared<SerialRing>(static_cast<size_t>(qMax(2, m_options.serialChunksPerPort)));
+    next->emplace(portName, ring);
+    m_serialTable.store(std::move(next));
+    return ring;
+}
+
+void FlightRecorder::attachSlot(const QString& slotName)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_running || m_taps.count(slotName))
+        return;
+
+    // A reopened slot continues in the ring it had before
+    auto& ring = m_canRings[slotName];
+    if (!ring)
+        ring = std::make_shared<CanRing>(static_cast<size_t>(qMax(2, m_options.canFramesPerSlot)));
+
+    auto tap = std::make_shared<SlotTap>(ring, m_clock);
+    if (CANBusManager::instance().addTap(slotName, tap))
+        m_taps.emplace(slotName, std::move(tap));
+}
+
+void FlightRecorder::detachSlot(const QString& slotName)
+{
+    // The slot's dispatcher, and the tap with it, is already gone
+    QMutexLocker locker(&m_mutex);
+    m_taps.erase(slotName);
+}
+
+// ============================================================================
+//  Dump Thread
+// ============================================================================
+
+void FlightRecorder::run()
+{
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        if (m_pending.empty()) {
+            if (m_stopping)
+                break;
+            m_wake.wait(&m_mutex);
+            continue;
+        }
+
+        // Dumps are due in trigger order once their post-trigger time has passed
+        const Dump dump = m_pending.front();
+        const qint64 due = dump.triggerNs + static_cast<qint64>(m_options.postTriggerMs) * NS_PER_MS;
+        const qint64 now = m_clock.nsecsElapsed();
+        if (!m_stopping && now < due) {
+            m_wake.wait(&m_mutex, QDeadlineTimer((due - now) / NS_PER_MS + 1));
+            continue;
+        }
+
+        m_pending.pop_front();
+        m_writing = true;
+        m_writingDir = dump.outputDir;
+        locker.unlock();
+        writeDump(dump);
+        locker.relock();
+        m_writing = false;
+        m_writingDir.clear();
+        m_idle.wakeAll();           // Also wakes waiters for this dump alone
+    }
+    m_idle.wakeAll();
+}
+
+void FlightRecorder::writeDump(const Dump& dump)
+{
+    std::map<QString, std::shared_ptr<CanRing>> canRings;
+    Options options;
+    {
+        QMutexLocker locker(&m_mutex);
+        canRings = m_canRings;
+        options  = m_options;
+    }
+    const auto serialTable = m_serialTable.load();
+
+    if (!QDir().mkpath(dump.outputDir)) {
+        qWarning() << "[FlightRecorder] Cannot create" << dump.outputDir;
+        return;
+    }
+
+    const qint64 fromNs = qMax<qint64>(0, dump.triggerNs - static_cast<qint64>(options.preTriggerMs) * NS_PER_MS);
+    const qint64 toNs   = dump.triggerNs + static_cast<qint64>(options.postTriggerMs) * NS_PER_MS;
+    const QDir dir(dump.outputDir);
+
+    for (const auto& [slotName, ring] : canRings)
+        writeCanDump(dir.filePath(fileNameFor(slotName, "asc")), slotName, *ring, fromNs, toNs);
+    if (serialTable) {
+        for (const auto& [portName, ring] : *serialTable)
+            writeSerialDump(dir.filePath(fileNameFor(portName, "log")), portName, *ring, fromNs, toNs);
+    }
+
+    qDebug() << "[FlightRecorder] Wrote" << canRings.size() << "CAN and"
+             << (serialTable ? serialTable->size() : 0) << "serial capture(s) to" << dump.outputDir;
+}
+
+void FlightRecorder::writeCanDump(const QString& path, const QString& slotName, CanRing& ring,
+                                  qint64 fromNs, qint64 toNs)
+{
+    std::vector<CanEntry> entries;
+    const size_t total = ring.snapshot(entries);
+    if (total > entries.size() && !entries.empty() && entries.front().captureNs > fromNs) {
+        qWarning() << "[FlightRecorder]" << slotName << "ring overwrote the first"
+                   << (entries.front().captureNs - fromNs) / NS_PER_MS << "ms of the window";
+    }
+
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [&](const CanEntry& e) { return e.captureNs < fromNs || e.captureNs > toNs; }),
+                  entries.end());
+
+    // Driver timestamps keep the exact frame spacing; map them onto the
+    // capture clock with the smallest capture - driver difference (least
+    // dispatch latency) of each run of frames from the same driver clock
+    std::vector<qint64> offsets(entries.size());
+    size_t runStart = 0;
+    qint64 best = 0;
+    for (size_t i = 0; i <= entries.size(); ++i) {
+        const bool end = i == entries.size();
+        const qint64 diff = end ? 0 : entries[i].captureNs - static_cast<qint64>(entries[i].msg.timestamp);
+        if (i > runStart && (end || std::abs(diff - best) > CLOCK_JUMP_NS)) {
+            std::fill(offsets.begin() + static_cast<qsizetype>(runStart),
+                      offsets.begin() + static_cast<qsizetype>(i), best);
+            runStart = i;
+        }
+        if (!end)
+            best = i == runStart ? diff : qMin(best, diff);
+    }
+
+    std::vector<CANTraceFrame> frames(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        frames[i].msg = entries[i].msg;
+        const qint64 ts = static_cast<qint64>(entries[i].msg.timestamp) + offsets[i] - fromNs;
+        frames[i].msg.timestamp = ts > 0 ? static_cast<uint64_t>(ts) : 0;
+    }
+
+    auto writer = CANTraceWriter::create(CANTraceFormat::Asc);
+    CANResult result = writer->open(path, m_clockStart.addMSecs(fromNs / NS_PER_MS));
+    if (result.success)
+        result = writer->write(frames.data(), static_cast<int>(frames.size()));
+    const CANResult closed = writer->close();
+    if (!result.success || !closed.success)
+        qWarning() << "[FlightRecorder]" << path << (result.success ? closed : result).errorMessage;
+}
+
+void FlightRecorder::writeSerialDump(const QString& path, const QString& portName, SerialRing& ring,
+                                     qint64 fromNs, qint64 toNs)
+{
+    std::vector<SerialEntry> entries;
+    ring.snapshot(entries);
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "[FlightRecorder] Cannot create" << path << file.errorString();
+        return;
+    }
+
+    QByteArray out;
+    out += "// Serial capture of " + portName.toUtf8() + ", t = 0 at "
+         + m_clockStart.addMSecs(fromNs / NS_PER_MS).toString(Qt::ISODateWithMs).toLatin1() + "\n";
+    out += "// time [s]  dir  bytes\n";
+
+    // Chunks of one transfer share a timestamp and direction: one line each
+    for (size_t i = 0; i < entries.size();) {
+        const SerialEntry& head = entries[i];
+        QByteArray bytes;
+        for (; i < entries.size() && entries[i].captureNs == head.captureNs
+               && entries[i].transmitted == head.transmitted; ++i)
+            bytes.append(entries[i].data, entries[i].length);
+        if (head.captureNs < fromNs || head.captureNs > toNs)
+            continue;
+
+        const qint64 ts = head.captureNs - fromNs;
+        char prefix[48];
+        const int n = std::snprintf(prefix, sizeof(prefix), "%4" PRId64 ".%06" PRId64 " %s  ",
+                                    ts / 1000000000, (ts / 1000) % 1000000, head.transmitted ? "Tx" : "Rx");
+        out.append(prefix, n);
+        out += bytes.toHex(' ').toUpper();
+        out += "  \"";
+        for (char c : bytes) {
+            if (c == '\r')
+                out += "\\r";
+            else if (c == '\n')
+                out += "\\n";
+            else if (c >= 0x20 && c < 0x7F)
+                out += c;
+            else
+                out += '.';
+        }
+        out += "\"\n";
+    }
+
+    if (file.write(out) != out.size())
+        qWarning() << "[FlightRecorder] Write to" << path << "failed:" << file.errorString();
+}
+
+QString FlightRecorder::fileNameFor(const QString& sourceName, const QString& suffix)
+{
+    QString name;
+    for (QChar c : sourceName)
+        name += (c.isLetterOrNumber() || c == '-' || c == '.') ? c : QChar('_');
+    return name + '.' + suffix;
+}
+
+} // namespace TestExecutor
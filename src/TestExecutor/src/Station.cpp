@@ -0,0 +1,235 @@
+/**
+ * @file Station.cpp
+ * @brief Implementation of test stations.
+ */
+
+#include "Station.h"
+#include "TestExecutorEngine.h"
+#include "HWConfigManager.h"
+#include <SerialManager.h>
+#include <CANManager.h>
+#include <QSettings>
+#include <QDebug>
+#include <algorithm>
+
+using namespace SerialManager;
+
+namespace TestExecutor {
+
+namespace {
+
+/// Station set by the innermost Scope on this thread
+thread_local Station* t_currentStation = nullptr;
+
+} // namespace
+
+//=============================================================================
+// Station Implementation
+//=============================================================================
+
+const QString Station::DEFAULT_NAME = QStringLiteral("Station 1");
+
+Station::Station()
+    : m_name(DEFAULT_NAME)
+{
+}
+
+Station::Station(const QString& name)
+    : m_name(name)
+    , m_serial(std::make_unique<SerialPortManager>())
+    , m_hwConfig(std::make_unique<HWConfigManager>(QString("Stations/%1/HWConfig").arg(name)))
+{
+    m_hwConfig->applyToSerialManager(*m_serial);
+    m_engine = std::make_unique<TestExecutorEngine>(*this);
+}
+
+Station::~Station() = default;
+
+TestExecutorEngine& Station::engine() const
+{
+    return m_engine ? *m_engine : TestExecutorEngine::instance();
+}
+
+HWConfigManager& Station::hwConfig() const
+{
+    return m_hwConfig ? *m_hwConfig : HWConfigManager::instance();
+}
+
+SerialPortManager& Station::serial() const
+{
+    return m_serial ? *m_serial : SerialPortManager::instance();
+}
+
+QString Station::qualifiedName(const QString& localName) const
+{
+    return isDefault() ? localName : m_name + '/' + localName;
+}
+
+QStringList Station::openCanSlots() const
+{
+    const QString prefix = qualifiedName(QString());
+    QStringList names;
+    for (const QString& slotName : CANManager::CANBusManager::instance().openSlotNames()) {
+        if (isDefault() ? !slotName.contains('/') : slotName.startsWith(prefix))
+            names.append(slotName.mid(prefix.size()));
+    }
+    return names;
+}
+
+void Station::closeHardware()
+{
+    for (const QString& localName : openCanSlots())
+        CANManager::CANBusManager::instance().closeSlot(canSlot(localName));
+    serial().closeAllPorts();
+}
+
+Station& Station::current()
+{
+    return t_currentStation ? *t_currentStation : StationManager::instance().defaultStation();
+}
+
+Station::Scope::Scope(Station& station)
+    : m_previous(t_currentStation)
+{
+    t_currentStation = &station;
+}
+
+Station::Scope::~Scope()
+{
+    t_currentStation = m_previous;
+}
+
+//=============================================================================
+// StationManager Implementation
+//=============================================================================
+
+StationManager& StationManager::instance()
+{
+    static StationManager instance;
+    return instance;
+}
+
+StationManager::StationManager()
+    : m_default(new Station())
+    , m_selected(Station::DEFAULT_NAME)
+{
+}
+
+StationManager::~StationManager() = default;
+
+Station* StationManager::addStation(const QString& name)
+{
+    const QString trimmed = name.trimmed();
+    if (trimmed.isEmpty() || trimmed.contains('/') || trimmed == Station::DEFAULT_NAME) {
+        qWarning() << "[Station] Cannot add station" << name;
+        return nullptr;
+    }
+
+    // Built outside the lock: loads settings and applies serial configs. The
+    // duplicate check and the insert share one lock, so of two concurrent
+    // adds with the same name only one station is kept
+    std::unique_ptr<Station> created(new Station(trimmed));
+    Station* added = created.get();
+    {
+        QMutexLocker locker(&m_mutex);
+        const bool taken = std::any_of(m_stations.begin(), m_stations.end(),
+                                       [&trimmed](const auto& s) { return s->name() == trimmed; });
+        if (!taken)
+            m_stations.push_back(std::move(created));
+    }
+    if (created) {
+        qWarning() << "[Station] Cannot add station" << name;
+        return nullptr;
+    }
+    qDebug() << "[Station] Added" << trimmed;
+    emit stationAdded(trimmed);
+    return added;
+}
+
+bool StationManager::removeStation(const QString& name)
+{
+    std::unique_ptr<Station> removed;
+    bool wasSelected = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = std::find_if(m_stations.begin(), m_stations.end(),
+                               [&name](const auto& s) { return s->name() == name; });
+        if (it == m_stations.end() || (*it)->engine().isRunning())
+            return false;
+        removed = std::move(*it);
+        m_stations.erase(it);
+        wasSelected = m_selected == name;
+    }
+
+    if (wasSelected)
+        selectStation(Station::DEFAULT_NAME);
+    removed->closeHardware();
+    removed.reset();
+    qDebug() << "[Station] Removed" << name;
+    emit stationRemoved(name);
+    return true;
+}
+
+Station* StationManager::station(const QString& name)
+{
+    if (name == Station::DEFAULT_NAME)
+        return m_default.get();
+    QMutexLocker locker(&m_mutex);
+    for (const auto& s : m_stations) {
+        if (s->name() == name)
+            return s.get();
+    }
+    return nullptr;
+}
+
+QStringList StationManager::stationNames() const
+{
+    QMutexLocker locker(&m_mutex);
+    QStringList names{Station::DEFAULT_NAME};
+    for (const auto& s : m_stations)
+        names.append(s->name());
+    return names;
+}
+
+Station& StationManager::selectedStation()
+{
+    QString selected;
+    {
+        QMutexLocker locker(&m_mutex);
+        selected = m_selected;
+    }
+    Station* s = station(selected);
+    return s ? *s : *m_default;
+}
+
+void StationManager::selectStation(const QString& name)
+{
+    if (!station(name))
+        return;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_selected == name)
+            return;
+        m_selected = name;
+    }
+    emit selectedStationChanged(name);
+}
+
+void StationManager::load()
+{
+    QSettings s;
+    for (const QString& name : s.value("Stations/names").toStringList()) {
+        if (!station(name))
+            addStation(name);
+    }
+}
+
+void StationManager::save() const
+{
+    QStringList names = stationNames();
+    names.removeFirst();
+    QSettings s;
+    s.setValue("Stations/names", names);
+}
+
+} // namespace TestExecutor
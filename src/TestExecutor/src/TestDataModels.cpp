@@ -238,6 +238,9 @@ QJsonObject TestResult::toJson() const
         stepObj["resultMessage"] = step.resultMessage;
         stepObj["durationMs"] = step.durationMs;
         stepObj["responseData"] = QJsonObject::fromVariantMap(step.responseData);
+        if (!step.flightRecordPath.isEmpty()) {
+            stepObj["flightRecordPath"] = step.flightRecordPath;
+        }
         stepsArray.append(stepObj);
     }
     obj["stepResults"] = stepsArray;
@@ -274,6 +277,7 @@ TestResult TestResult::fromJson(const QJsonObject& json)
         step.resultMessage = stepObj["resultMessage"].toString();
         step.durationMs = stepObj["durationMs"].toInteger();
         step.responseData = stepObj["responseData"].toObject().toVariantMap();
+        step.flightRecordPath = stepObj["flightRecordPath"].toString();
         result.stepResults.append(step);
     }
     
@@ -6,9 +6,13 @@
 #include "TestExecutorEngine.h"
 #include "TestRepository.h"
 #include "CommandRegistry.h"
+#include "FlightRecorder.h"
+#include "Station.h"
 #include <SerialManager.h>
 #include "HWConfigManager.h"
+#include <QDir>
 #include <QFile>
+#include <QRegularExpression>
 #include <QJsonDocument>
 #include <QDebug>
 #include <QTimer>
@@ -57,6 +61,10 @@ QVariantMap TestConfiguration::toVariantMap() const
     map["reportTemplate"] = reportTemplate;
     map["autoGenerateReport"] = autoGenerateReport;
     
+    map["flightRecorderEnabled"] = flightRecorderEnabled;
+    map["flightRecorderPreTriggerS"] = flightRecorderPreTriggerS;
+    map["flightRecorderPostTriggerS"] = flightRecorderPostTriggerS;
+    
     return map;
 }
 
@@ -95,6 +103,10 @@ TestConfiguration TestConfiguration::fromVariantMap(const QVariantMap& map)
     config.reportTemplate = map.value("reportTemplate", "default").toString();
     config.autoGenerateReport = map.value("autoGenerateReport", true).toBool();
     
+    config.flightRecorderEnabled = map.value("flightRecorderEnabled", true).toBool();
+    config.flightRecorderPreTriggerS = map.value("flightRecorderPreTriggerS", 10).toInt();
+    config.flightRecorderPostTriggerS = map.value("flightRecorderPostTriggerS", 2).toInt();
+    
     return config;
 }
 
@@ -120,8 +132,17 @@ TestExecutorEngine& TestExecutorEngine::instance()
 
 TestExecutorEngine::TestExecutorEngine()
 {
-    // Initialize command registry
+    // Initialize command registry (shared by all stations)
     CommandRegistry::instance().registerBuiltinCommands();
+    connectSerialCapture();
+}
+
+TestExecutorEngine::TestExecutorEngine(Station& station)
+    : m_station(&station)
+{
+    // The default engine registers the builtin commands
+    instance();
+    connectSerialCapture();
 }
 
 TestExecutorEngine::~TestExecutorEngine()
@@ -132,6 +153,28 @@ TestExecutorEngine::~TestExecutorEngine()
         m_workerThread->quit();
         m_workerThread->wait(5000);
     }
+    delete m_workerThread;
+}
+
+Station& TestExecutorEngine::station() const
+{
+    return m_station ? *m_station : StationManager::instance().defaultStation();
+}
+
+void TestExecutorEngine::connectSerialCapture()
+{
+    // Feed serial traffic into the flight recorder on the sending/reading thread,
+    // under station-qualified port names so stations sharing a recorder stay apart
+    auto& serialMgr = station().serial();
+    Station* s = &station();
+    connect(&serialMgr, &SerialPortManager::dataSent, this,
+            [s](const QString& portName, const QByteArray& data) {
+                FlightRecorder::instance().recordSerial(s->qualifiedName(portName), true, data);
+            }, Qt::DirectConnection);
+    connect(&serialMgr, &SerialPortManager::dataReceived, this,
+            [s](const QString& portName, const QByteArray& data) {
+                FlightRecorder::instance().recordSerial(s->qualifiedName(portName), false, data);
+            }, Qt::DirectConnection);
 }
 
 void TestExecutorEngine::setConfiguration(const TestConfiguration& config)
@@ -194,6 +237,10 @@ void TestExecutorEngine::runTests(const QStringList& testCaseIds)
     m_currentSession->configuration = m_config.toVariantMap();
     m_currentSession->startTime = QDateTime::currentDateTime();
     
+    m_sessionOutputDir.clear();
+    m_flightRecordPaths.clear();
+    startFlightRecorder();
+    
     setState(ExecutorState::Running);
     emit sessionStarted(m_currentSession->id, testCaseIds.size());
     
@@ -208,7 +255,10 @@ void TestExecutorEngine::runTests(const QStringList& testCaseIds)
     }
 
     // Execute tests in a worker thread
-    m_workerThread = QThread::create([this]() { executeTests(); });
+    m_workerThread = QThread::create([this]() {
+        Station::Scope scope(station());
+        executeTests();
+    });
     m_workerThread->start();
 }
 
@@ -241,8 +291,15 @@ void TestExecutorEngine::runSingleStep(const QString& testCaseId, int stepIndex)
     TestStep step = tc->steps[stepIndex];
     emit stepStarted(testCaseId, stepIndex, step.description);
     
+    const bool inSession = m_flightRecorderAcquired;
+    startFlightRecorder();
     m_stepTimer.start();
     TestStep result = executeStep(step, stepIndex, testCaseId);
+    if (result.status == TestStatus::Failed || result.status == TestStatus::Error) {
+        captureFailure(result, stepIndex, testCaseId);
+    }
+    if (!inSession)
+        releaseFlightRecorder();
     
     emit stepCompleted(testCaseId, stepIndex, result);
 }
@@ -293,8 +350,7 @@ void TestExecutorEngine::emergencyStop()
 
 void TestExecutorEngine::setState(ExecutorState state)
 {
-    if (m_state != state) {
-        m_state = state;
+    if (m_state.exchange(state) != state) {
         emit stateChanged(state);
     }
 }
@@ -388,6 +444,15 @@ void TestExecutorEngine::executeTests()
         }
     }
     
+    // Let this session's flight recorder dumps finish so the report can link
+    // them; other stations' dumps are theirs to wait for
+    auto& recorder = FlightRecorder::instance();
+    const int dumpTimeoutMs = recorder.options().postTriggerMs + 30000;
+    if (!recorder.waitForDumps(m_flightRecordPaths, dumpTimeoutMs)) {
+        emit logMessage("WARNING", "Flight recorder dumps still being written");
+    }
+    releaseFlightRecorder();
+    
     // Finalize session
     m_currentSession->endTime = QDateTime::currentDateTime();
     m_currentSession->durationMs = m_sessionTimer.elapsed();
@@ -436,6 +501,9 @@ TestResult TestExecutorEngine::executeTestCase(const TestCase& testCase)
         // Execute the step
         m_stepTimer.start();
         TestStep stepResult = executeStep(step, stepIndex, testCase.id);
+        if (stepResult.status == TestStatus::Failed || stepResult.status == TestStatus::Error) {
+            captureFailure(stepResult, stepIndex, testCase.id);
+        }
         
         result.stepResults.append(stepResult);
         
@@ -518,6 +586,8 @@ TestStep TestExecutorEngine::executeStep(const TestStep& step, int stepIndex, co
         // We expose a local atomic that executeStep polls; the lambda bridges both flags.
         std::atomic<bool> cancelToken{false};
         auto future = QtConcurrent::run([&]() -> CommandResult {
+            // Handlers find this station's serial ports and CAN slots through Station::current()
+            Station::Scope scope(station());
             // The registry handler reads *cancel periodically; we keep it in sync.
             return registry.execute(step.command, step.parameters, configMap, &cancelToken);
         });
@@ -568,10 +638,75 @@ TestStep TestExecutorEngine::executeStep(const TestStep& step, int stepIndex, co
     return result;
 }
 
+void TestExecutorEngine::startFlightRecorder()
+{
+    // The recorder is shared by all stations: a disabled station only stops
+    // it when no other session is capturing
+    auto& recorder = FlightRecorder::instance();
+    if (!m_config.flightRecorderEnabled) {
+        recorder.stopIfUnused();
+        return;
+    }
+    if (m_flightRecorderAcquired)
+        return;
+
+    FlightRecorder::Options options;
+    options.preTriggerMs = qMax(0, m_config.flightRecorderPreTriggerS) * 1000;
+    options.postTriggerMs = qMax(0, m_config.flightRecorderPostTriggerS) * 1000;
+
+    // Keep capturing across sessions: a failure early in a run still gets
+    // the traffic from before the run started
+    recorder.acquire(options);
+    m_flightRecorderAcquired = true;
+}
+
+void TestExecutorEngine::releaseFlightRecorder()
+{
+    if (m_flightRecorderAcquired.exchange(false))
+        FlightRecorder::instance().release();
+}
+
+void TestExecutorEngine::captureFailure(TestStep& stepResult, int stepIndex, const QString& testCaseId)
+{
+    QString name = testCaseId;
+    name.replace(QRegularExpression("[^A-Za-z0-9_.-]"), "_");
+    const QString dir = QString("%1/flight_recorder/%2_step%3_%4")
+                            .arg(sessionOutputDir())
+                            .arg(name)
+                            .arg(stepIndex + 1)
+                            .arg(QDateTime::currentDateTime().toString("HHmmss_zzz"));
+    
+    stepResult.flightRecordPath = FlightRecorder::instance().trigger(dir);
+    if (!stepResult.flightRecordPath.isEmpty()) {
+        m_flightRecordPaths.append(stepResult.flightRecordPath);
+        emit logMessage("INFO", QString("Flight recorder capture of step %1: %2")
+                                .arg(stepIndex + 1)
+                                .arg(stepResult.flightRecordPath));
+    }
+}
+
+QString TestExecutorEngine::sessionOutputDir()
+{
+    if (m_sessionOutputDir.isEmpty()) {
+        const QString base = m_config.reportOutputPath.isEmpty() ? QDir::currentPath()
+                                                                 : m_config.reportOutputPath;
+        const QDateTime started = m_currentSession ? m_currentSession->startTime
+                                                   : QDateTime::currentDateTime();
+        QString name = "session_" + started.toString("yyyyMMdd_HHmmss");
+        if (!station().isDefault()) {
+            // Stations started in the same second must not share a folder
+            name += "_" + station().name();
+            name.replace(QRegularExpression("[^A-Za-z0-9_.-]"), "_");
+        }
+        m_sessionOutputDir = QDir(base).absoluteFilePath(name);
+    }
+    return m_sessionOutputDir;
+}
+
 void TestExecutorEngine::initializeCommunication()
 {
     // Initialize serial port from configuration
-    auto& serialMgr = SerialPortManager::instance();
+    auto& serialMgr = station().serial();
     
     // Configure serial port from TestConfiguration
     SerialPortConfig serialConfig;
@@ -597,7 +732,7 @@ void TestExecutorEngine::initializeCommunication()
 
 void TestExecutorEngine::syncFromHWConfig()
 {
-    auto& hwConfig = HWConfigManager::instance();
+    auto& hwConfig = station().hwConfig();
 
     // Sync primary serial port (Debug Port 1) into TestConfiguration
     auto serialCfg = hwConfig.serialDebugPort(0);
@@ -619,13 +754,13 @@ void TestExecutorEngine::syncFromHWConfig()
     }
 
     // Also push to SerialPortManager so connections use latest settings
-    hwConfig.applyToSerialManager();
+    hwConfig.applyToSerialManager(station().serial());
 }
 
 void TestExecutorEngine::cleanupCommunication()
 {
     // Close serial ports
-    auto& serialMgr = SerialPortManager::instance();
+    auto& serialMgr = station().serial();
     serialMgr.closeAllPorts();
     
     emit logMessage("INFO", "Serial ports closed");
@@ -7,6 +7,7 @@
 #include "TestEditorPanel.h"
 #include "TestRepository.h"
 #include "TestExecutorEngine.h"
+#include "Station.h"
 #include "IconManager.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -602,8 +603,8 @@ void TestExplorerPanel::onRunSelectedClicked()
 
     emit runSelectedRequested(ids);
 
-    // Start execution
-    TestExecutorEngine::instance().runTests(ids);
+    // Start execution on the station shown in the UI
+    StationManager::instance().selectedStation().engine().runTests(ids);
 }
 
 void TestExplorerPanel::onSourceModelAboutToBeReset()
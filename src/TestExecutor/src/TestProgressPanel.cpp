@@ -6,6 +6,7 @@
 #include "TestProgressPanel.h"
 #include "TestExecutorEngine.h"
 #include "TestReportGenerator.h"
+#include "Station.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QSplitter>
@@ -93,7 +94,7 @@ void TestProgressPanel::onSessionCompleted(const TestSession& session)
     appendLog("INFO", QString("═══════════════════════════════════════════"));
     
     // Auto-export if configured
-    auto& engine = TestExecutorEngine::instance();
+    auto& engine = *m_engine;
     if (engine.configuration().autoGenerateReport) {
         QString filename = TestReportGenerator::defaultFilename(ReportFormat::HTML);
         QString outputPath = engine.configuration().reportOutputPath;
@@ -234,7 +235,7 @@ void TestProgressPanel::onRunClicked()
 
 void TestProgressPanel::onPauseClicked()
 {
-    auto& engine = TestExecutorEngine::instance();
+    auto& engine = *m_engine;
     
     if (engine.state() == ExecutorState::Paused) {
         engine.resume();
@@ -249,7 +250,7 @@ void TestProgressPanel::onPauseClicked()
 
 void TestProgressPanel::onStopClicked()
 {
-    auto& engine = TestExecutorEngine::instance();
+    auto& engine = *m_engine;
     engine.stop();
     emit stopRequested();
 }
@@ -332,6 +333,12 @@ void TestProgressPanel::setupUi()
     controlBar->addWidget(m_btnClear);
     controlBar->addStretch();
     
+    // Only shown once there is more than one station
+    m_stationLabel = new QLabel("Station:", this);
+    m_stationCombo = new QComboBox(this);
+    controlBar->addWidget(m_stationLabel);
+    controlBar->addWidget(m_stationCombo);
+    
     mainLayout->addLayout(controlBar);
     
     // === Progress Bar ===
@@ -406,11 +413,67 @@ void TestProgressPanel::setupConnections()
             this, &TestProgressPanel::onResultTableDoubleClicked);
     
     connect(m_elapsedTimer, &QTimer::timeout, this, &TestProgressPanel::updateElapsedTime);
+    
+    auto& stations = StationManager::instance();
+    connect(&stations, &StationManager::stationAdded, this, &TestProgressPanel::refreshStations);
+    connect(&stations, &StationManager::stationRemoved, this, &TestProgressPanel::refreshStations);
+    connect(&stations, &StationManager::selectedStationChanged,
+            this, &TestProgressPanel::onSelectedStationChanged);
+    connect(m_stationCombo, &QComboBox::currentIndexChanged, this, &TestProgressPanel::onStationSelected);
+    refreshStations();
+}
+
+void TestProgressPanel::refreshStations()
+{
+    auto& stations = StationManager::instance();
+    const QStringList names = stations.stationNames();
+    
+    m_stationCombo->blockSignals(true);
+    m_stationCombo->clear();
+    m_stationCombo->addItems(names);
+    m_stationCombo->setCurrentIndex(names.indexOf(stations.selectedStation().name()));
+    m_stationCombo->blockSignals(false);
+    
+    m_stationLabel->setVisible(names.size() > 1);
+    m_stationCombo->setVisible(names.size() > 1);
+}
+
+void TestProgressPanel::onStationSelected(int index)
+{
+    if (index >= 0) {
+        StationManager::instance().selectStation(m_stationCombo->itemText(index));
+    }
+}
+
+void TestProgressPanel::onSelectedStationChanged(const QString& name)
+{
+    m_stationCombo->blockSignals(true);
+    m_stationCombo->setCurrentIndex(m_stationCombo->findText(name));
+    m_stationCombo->blockSignals(false);
+    
+    // Follow the selected station's engine; its earlier output is not replayed
+    disconnectFromEngine();
+    m_elapsedTimer->stop();
+    clear();
+    m_isRunning = false;
+    connectToEngine();
+    m_btnPause->setText("Pause");
+    onStateChanged(m_engine->state());
+    appendLog("INFO", QString("Showing %1").arg(name));
+}
+
+void TestProgressPanel::disconnectFromEngine()
+{
+    if (m_engine) {
+        disconnect(m_engine, nullptr, this, nullptr);
+        m_engine = nullptr;
+    }
 }
 
 void TestProgressPanel::connectToEngine()
 {
-    auto& engine = TestExecutorEngine::instance();
+    m_engine = &StationManager::instance().selectedStation().engine();
+    auto& engine = *m_engine;
     
     connect(&engine, &TestExecutorEngine::sessionStarted, 
             this, &TestProgressPanel::onSessionStarted);
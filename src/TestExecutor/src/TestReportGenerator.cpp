@@ -10,6 +10,7 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDir>
+#include <QFileInfo>
 #include <QDateTime>
 #include <QApplication>
 
@@ -170,6 +171,7 @@ bool TestReportGenerator::generateHtmlReport(const TestSession& session,
     out << "                </thead>\n";
     out << "                <tbody>\n";
     
+    const QDir reportDir = QFileInfo(filePath).absoluteDir();
     int index = 1;
     for (const auto& result : session.results) {
         QString statusClass = TestResult::statusToString(result.status).toLower();
@@ -209,7 +211,18 @@ bool TestReportGenerator::generateHtmlReport(const TestSession& session,
         }
         out << "</td>\n";
         
-        out << "                        <td>" << result.statusMessage.toHtmlEscaped() << "</td>\n";
+        out << "                        <td>" << result.statusMessage.toHtmlEscaped();
+        
+        // Flight recorder captures of failing steps, relative to the report
+        for (const auto& step : result.stepResults) {
+            if (step.flightRecordPath.isEmpty()) {
+                continue;
+            }
+            const QString link = reportDir.relativeFilePath(step.flightRecordPath);
+            out << "<br><a href=\"" << link.toHtmlEscaped() << "\" target=\"_blank\">Step "
+                << step.order << " bus/serial capture</a>";
+        }
+        out << "</td>\n";
         out << "                    </tr>\n";
     }
     
@@ -310,6 +323,9 @@ bool TestReportGenerator::generateJsonReport(const TestSession& session,
             stepObj["status"] = TestResult::statusToString(step.status);
             stepObj["durationMs"] = step.durationMs;
             stepObj["resultMessage"] = step.resultMessage;
+            if (!step.flightRecordPath.isEmpty()) {
+                stepObj["flightRecordPath"] = step.flightRecordPath;
+            }
             
             QJsonObject paramsObj;
             for (auto it = step.parameters.begin(); it != step.parameters.end(); ++it) {
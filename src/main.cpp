@@ -4,10 +4,13 @@
 #include "SamplePanels.h"
 #include "TestExecutorPanels.h"
 #include "TestRepository.h"
+#include "Station.h"
 #include <ManDiag.h>
 #include <DBCManager.h>
 #include <QApplication>
 #include <QMenuBar>
+#include <QInputDialog>
+#include <QMessageBox>
 #include <QSplashScreen>
 #include <QPainter>
 #include <QElapsedTimer>
@@ -78,6 +81,10 @@ int main(int argc, char *argv[])
     // Initialize HW configuration (loads saved settings)
     HWConfigManager::instance().applyToSerialManager();
 
+    // Additional test stations (each with its own engine, HW config and ports)
+    auto& stations = TestExecutor::StationManager::instance();
+    stations.load();
+
     showStatus("Loading DBC databases...");
     // Auto-load saved DBC files for CAN channels (background parsing)
     DBCManager::DBCDatabaseManager::instance().loadSavedPaths();
@@ -122,10 +129,40 @@ int main(int argc, char *argv[])
     // Add Tools menu with HW Configuration dialog
     // Insert before the last menu (Help) - find the Perspectives menu position
     auto* toolsMenu = new QMenu(QObject::tr("&Tools"), &window);
-    toolsMenu->addAction(QObject::tr("HW Configuration..."), &window, [&window]() {
-        HWConfigDialog dlg(&window);
+    toolsMenu->addAction(QObject::tr("HW Configuration..."), &window, [&window, &stations]() {
+        auto& station = stations.selectedStation();
+        HWConfigDialog dlg(station.hwConfig(), station.serial(), station.qualifiedName(QString()), &window);
+        if (stations.stationNames().size() > 1)
+            dlg.setWindowTitle(QObject::tr("Hardware Configuration - %1").arg(station.name()));
         dlg.exec();
     });
+    toolsMenu->addSeparator();
+    toolsMenu->addAction(QObject::tr("Add Station..."), &window, [&window, &stations]() {
+        const QString name = QInputDialog::getText(&window, QObject::tr("Add Station"),
+            QObject::tr("Station name:"), QLineEdit::Normal,
+            QObject::tr("Station %1").arg(stations.stationNames().size() + 1));
+        if (name.isEmpty())
+            return;
+        if (auto* station = stations.addStation(name)) {
+            stations.save();
+            stations.selectStation(station->name());
+        } else {
+            QMessageBox::warning(&window, QObject::tr("Add Station"),
+                QObject::tr("A station named \"%1\" cannot be added.").arg(name));
+        }
+    });
+    toolsMenu->addAction(QObject::tr("Remove Station"), &window, [&window, &stations]() {
+        const QString name = stations.selectedStation().name();
+        if (stations.selectedStation().isDefault()) {
+            QMessageBox::information(&window, QObject::tr("Remove Station"),
+                QObject::tr("%1 is the default station and cannot be removed.").arg(name));
+        } else if (!stations.removeStation(name)) {
+            QMessageBox::warning(&window, QObject::tr("Remove Station"),
+                QObject::tr("%1 is still running tests.").arg(name));
+        } else {
+            stations.save();
+        }
+    });
     // Insert Tools menu before the Help menu (last menu)
     auto* menuBar = window.appMenuBar();
     auto actions = menuBar->actions();
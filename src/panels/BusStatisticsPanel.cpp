@@ -0,0 +1,164 @@
+#include "BusStatisticsPanel.h"
+
+#include <CANManager.h>
+
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+using CANManager::CANBusManager;
+
+namespace {
+
+/// Display refresh; the statistics themselves are sampled every 250 ms
+constexpr int REFRESH_INTERVAL_MS = 500;
+
+QString formatRate(double perSecond)
+{
+    return perSecond >= 10000.0 ? QString::number(perSecond / 1000.0, 'f', 1) + "k"
+                                : QString::number(perSecond, 'f', 0);
+}
+
+} // namespace
+
+// ===========================================================================
+// BusStatisticsPanel
+// ===========================================================================
+
+BusStatisticsPanel::BusStatisticsPanel(QWidget* parent)
+    : QWidget(parent)
+{
+    auto* layout = new QVBoxLayout(this);
+
+    // ----- Slot selection -----
+    auto* slotRow = new QHBoxLayout;
+    m_slotCombo = new QComboBox;
+    m_slotCombo->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+    m_resetButton = new QPushButton(tr("Reset"));
+    m_resetButton->setToolTip(tr("Zero counters, peaks and history of the selected slot"));
+    slotRow->addWidget(new QLabel(tr("Slot:")));
+    slotRow->addWidget(m_slotCombo, 1);
+    slotRow->addWidget(m_resetButton);
+    layout->addLayout(slotRow);
+
+    // ----- Summary -----
+    auto* form = new QFormLayout;
+    m_busLoadBar = new QProgressBar;
+    m_busLoadBar->setRange(0, 100);
+    m_busLoadBar->setFormat("%p %");
+    form->addRow(tr("Bus load:"), m_busLoadBar);
+    m_busLoadLabel = new QLabel;
+    form->addRow(QString(), m_busLoadLabel);
+    m_trafficLabel = new QLabel;
+    form->addRow(tr("Traffic:"), m_trafficLabel);
+    m_txLabel = new QLabel;
+    form->addRow(tr("Transmit:"), m_txLabel);
+    m_queueLabel = new QLabel;
+    form->addRow(tr("Queues:"), m_queueLabel);
+    layout->addLayout(form);
+
+    // ----- Busiest IDs -----
+    m_idTable = new QTableWidget(0, 3);
+    m_idTable->setHorizontalHeaderLabels({tr("CAN ID"), tr("Frames/s"), tr("Frames")});
+    m_idTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_idTable->verticalHeader()->setVisible(false);
+    m_idTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_idTable->setSelectionMode(QAbstractItemView::NoSelection);
+    layout->addWidget(m_idTable, 1);
+
+    auto& can = CANBusManager::instance();
+    connect(&can, &CANBusManager::slotOpened, this, &BusStatisticsPanel::refreshSlots);
+    connect(&can, &CANBusManager::slotClosed, this, &BusStatisticsPanel::refreshSlots);
+    connect(m_slotCombo, &QComboBox::currentTextChanged, this, &BusStatisticsPanel::refresh);
+    connect(m_resetButton, &QPushButton::clicked, this, &BusStatisticsPanel::resetStatistics);
+
+    m_timer = new QTimer(this);
+    connect(m_timer, &QTimer::timeout, this, &BusStatisticsPanel::refresh);
+    m_timer->start(REFRESH_INTERVAL_MS);
+
+    refreshSlots();
+}
+
+void BusStatisticsPanel::refreshSlots()
+{
+    const QString selected = m_slotCombo->currentText();
+    QStringList names = CANBusManager::instance().openSlotNames();
+    names.sort();
+
+    m_slotCombo->blockSignals(true);
+    m_slotCombo->clear();
+    m_slotCombo->addItems(names);
+    if (names.contains(selected))
+        m_slotCombo->setCurrentText(selected);
+    m_slotCombo->blockSignals(false);
+
+    refresh();
+}
+
+void BusStatisticsPanel::refresh()
+{
+    // Skip the work while the dock is hidden or tabbed away
+    if (!isVisible())
+        return;
+
+    CANBusManager::BusStatistics stats;
+    const bool open = CANBusManager::instance().busStatistics(m_slotCombo->currentText(), stats);
+    m_resetButton->setEnabled(open);
+    if (!open) {
+        m_busLoadBar->setValue(0);
+        m_busLoadLabel->setText(tr("No slot open"));
+        m_trafficLabel->clear();
+        m_txLabel->clear();
+        m_queueLabel->clear();
+        m_idTable->setRowCount(0);
+        return;
+    }
+
+    const auto& current = stats.current;
+    m_busLoadBar->setValue(qBound(0, qRound(current.busLoadPercent), 100));
+    m_busLoadLabel->setText(tr("%1 % now, %2 % mean, %3 % peak at %4 kbit/s")
+                                .arg(current.busLoadPercent, 0, 'f', 1)
+                                .arg(stats.meanBusLoadPercent, 0, 'f', 1)
+                                .arg(stats.peakBusLoadPercent, 0, 'f', 1)
+                                .arg(stats.bitrate / 1000));
+    m_trafficLabel->setText(tr("RX %1 fps, TX %2 fps, %3 B/s, %4 error frames/s (%5 total)")
+                                .arg(formatRate(current.rxFramesPerSecond))
+                                .arg(formatRate(current.txFramesPerSecond))
+                                .arg(formatRate(current.bytesPerSecond))
+                                .arg(formatRate(current.errorFramesPerSecond))
+                                .arg(stats.errorFrames));
+    m_txLabel->setText(tr("%1 requested, %2 confirmed, %3 rejected")
+                           .arg(stats.txRequests)
+                           .arg(stats.txConfirmations)
+                           .arg(stats.txRejected));
+    m_queueLabel->setText(tr("RX batch %1, slot queue %2, subscription %3 (high-water)")
+                              .arg(stats.rxBatchHighWater)
+                              .arg(stats.rxQueueHighWater)
+                              .arg(stats.subscriptionHighWater));
+
+    const int rows = static_cast<int>(qMin<qsizetype>(stats.ids.size(), MAX_ID_ROWS));
+    m_idTable->setRowCount(rows);
+    for (int row = 0; row < rows; ++row) {
+        const auto& id = stats.ids[row];
+        const QString idText = "0x" + QString::number(id.id, 16).toUpper()
+                                          .rightJustified(id.extended ? 8 : 3, '0')
+                               + (id.extended ? "x" : "");
+        const QStringList cells{idText, QString::number(id.framesPerSecond, 'f', 1),
+                                QString::number(id.frames)};
+        for (int column = 0; column < cells.size(); ++column) {
+            QTableWidgetItem* item = m_idTable->item(row, column);
+            if (!item) {
+                item = new QTableWidgetItem;
+                m_idTable->setItem(row, column, item);
+            }
+            item->setText(cells[column]);
+        }
+    }
+}
+
+void BusStatisticsPanel::resetStatistics()
+{
+    CANBusManager::instance().resetBusStatistics(m_slotCombo->currentText());
+    refresh();
+}
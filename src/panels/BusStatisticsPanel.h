@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QWidget>
+#include <QComboBox>
+#include <QLabel>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTimer>
+
+/**
+ * @brief Live CAN bus statistics of one open slot.
+ *
+ * Shows bus load (current, mean, peak), frame and error rates, TX requests
+ * against confirmations, queue high-water marks and the busiest CAN IDs.
+ * Polls CANBusManager::busStatistics() on a timer; the counting itself
+ * happens on the slot's RX and TX paths.
+ */
+class BusStatisticsPanel : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit BusStatisticsPanel(QWidget* parent = nullptr);
+
+private slots:
+    void refreshSlots();
+    void refresh();
+    void resetStatistics();
+
+private:
+    /// Rows of the per-ID table
+    static constexpr int MAX_ID_ROWS = 64;
+
+    QComboBox*    m_slotCombo     = nullptr;
+    QPushButton*  m_resetButton   = nullptr;
+    QProgressBar* m_busLoadBar    = nullptr;
+    QLabel*       m_busLoadLabel  = nullptr;
+    QLabel*       m_trafficLabel  = nullptr;
+    QLabel*       m_txLabel       = nullptr;
+    QLabel*       m_queueLabel    = nullptr;
+    QTableWidget* m_idTable       = nullptr;
+    QTimer*       m_timer         = nullptr;
+};
@@ -1,7 +1,9 @@
 #include "CANConfigWidget.h"
 
 #include <CANManager.h>
+#ifdef _WIN32
 #include <VectorCANDriver.h>
+#endif
 #include <DBCManager.h>
 
 #include <QFileDialog>
@@ -28,7 +30,7 @@ CANConfigWidget::CANConfigWidget(QWidget* parent)
 
     // Interface Type
     m_interfaceTypeCombo = new QComboBox;
-    m_interfaceTypeCombo->addItems({"Vector", "PEAK PCAN", "SocketCAN", "Custom"});
+    m_interfaceTypeCombo->addItems({"Vector", "PEAK PCAN", "SocketCAN", "Virtual", "Custom"});
     form->addRow(tr("Interface Type:"), m_interfaceTypeCombo);
 
     // ----- Vector Channel Mapping (shown when Vector is selected) -----
@@ -49,7 +51,7 @@ CANConfigWidget::CANConfigWidget(QWidget* parent)
     auto* deviceLayout = new QHBoxLayout(m_deviceRow);
     deviceLayout->setContentsMargins(0, 0, 0, 0);
     m_deviceEdit = new QLineEdit("PCAN_USBBUS1");
-    m_deviceEdit->setPlaceholderText(tr("e.g., PCAN_USBBUS1, can0"));
+    m_deviceEdit->setPlaceholderText(tr("e.g., PCAN_USBBUS1, can0, vbus0"));
     deviceLayout->addWidget(m_deviceEdit);
     form->addRow(tr("Device:"), m_deviceRow);
 
@@ -258,6 +260,7 @@ CANConfigWidget::VectorDetectionResult CANConfigWidget::detectVectorChannelsInWo
 {
     VectorDetectionResult result;
 
+#ifdef _WIN32
     // Use a temporary driver instance so stalled vendor APIs do not block
     // the main CAN manager driver used for active communication.
     CANManager::VectorCANDriver driver;
@@ -276,6 +279,9 @@ CANConfigWidget::VectorDetectionResult CANConfigWidget::detectVectorChannelsInWo
     }
 
     driver.shutdown();
+#else
+    result.errorMessage = QStringLiteral("Vector XL Library is only available on Windows");
+#endif
     return result;
 }
 
@@ -1,7 +1,9 @@
 #include "HWConfigDialog.h"
 
 #include <CANManager.h>
+#ifdef _WIN32
 #include <VectorCANDriver.h>
+#endif
 #include <DBCManager.h>
 #include <QDialogButtonBox>
 #include <QVBoxLayout>
@@ -19,7 +21,17 @@
 // ===========================================================================
 
 HWConfigDialog::HWConfigDialog(QWidget* parent)
+    : HWConfigDialog(HWConfigManager::instance(), SerialManager::SerialPortManager::instance(),
+                     QString(), parent)
+{
+}
+
+HWConfigDialog::HWConfigDialog(HWConfigManager& config, SerialManager::SerialPortManager& serial,
+                               const QString& canSlotPrefix, QWidget* parent)
     : QDialog(parent)
+    , m_config(config)
+    , m_serial(serial)
+    , m_canSlotPrefix(canSlotPrefix)
 {
     setWindowTitle(tr("Hardware Configuration"));
     setObjectName(QStringLiteral("hwConfigDialog"));
@@ -91,7 +103,7 @@ void HWConfigDialog::setupSerialDebugTab(QTabWidget* parent)
         connect(m_serialDebugTabs[i].connectBtn, &QPushButton::clicked, this, [this, i]() {
             auto cfg = m_serialDebugTabs[i].serialConfig->config();
             if (cfg.portName.isEmpty()) return;
-            auto& serial = SerialManager::SerialPortManager::instance();
+            auto& serial = m_serial;
             serial.setPortConfig(cfg.portName, cfg);
             auto result = serial.openPort(cfg.portName);
             bool connected = result.success;
@@ -104,7 +116,7 @@ void HWConfigDialog::setupSerialDebugTab(QTabWidget* parent)
         // Disconnect handler
         connect(m_serialDebugTabs[i].disconnectBtn, &QPushButton::clicked, this, [this, i]() {
             auto cfg = m_serialDebugTabs[i].serialConfig->config();
-            SerialManager::SerialPortManager::instance().closePort(cfg.portName);
+            m_serial.closePort(cfg.portName);
             m_serialDebugTabs[i].connectBtn->setEnabled(true);
             m_serialDebugTabs[i].disconnectBtn->setEnabled(false);
             m_serialDebugTabs[i].statusLabel->setText(tr("Disconnected"));
@@ -129,11 +141,17 @@ void HWConfigDialog::setupCANTab(QTabWidget* parent)
         // Connect handler (CAN bus connection via CANManager)
         connect(m_canTabs[i], &CANConfigWidget::connectRequested, this, [this, i]() {
             auto cfg = m_canTabs[i]->config();
-            QString slotName = QString("CAN %1").arg(i + 1);
+            QString slotName = canSlotName(i);
 
             auto& canMgr = CANManager::CANBusManager::instance();
 
+            CANManager::CANBusConfig busConfig;
+            busConfig.bitrate       = cfg.bitrate;
+            busConfig.fdEnabled     = cfg.fdEnabled;
+            busConfig.fdDataBitrate = cfg.fdDataBitrate;
+
             if (cfg.interfaceType == "Vector") {
+#ifdef _WIN32
                 if (cfg.vectorChannelIdx < 0 || cfg.vectorChannelMask == 0) {
                     m_canTabs[i]->setConnectionStatus(
                         false,
@@ -141,7 +159,7 @@ void HWConfigDialog::setupCANTab(QTabWidget* parent)
                     return;
                 }
 
-                auto* vectorDrv = canMgr.vectorDriver();
+                auto* vectorDrv = canMgr.vectorDriver(slotName);
                 if (!vectorDrv || !vectorDrv->initialize()) {
                     m_canTabs[i]->setConnectionStatus(false, tr("Vector driver not available"));
                     return;
@@ -156,26 +174,62 @@ void HWConfigDialog::setupCANTab(QTabWidget* parent)
                 chInfo.channelMask  = cfg.vectorChannelMask;
                 chInfo.name         = cfg.device;
 
-                CANManager::CANBusConfig busConfig;
-                busConfig.bitrate       = cfg.bitrate;
-                busConfig.fdEnabled     = cfg.fdEnabled;
-                busConfig.fdDataBitrate = cfg.fdDataBitrate;
-
                 auto result = canMgr.openSlot(slotName, vectorDrv, chInfo, busConfig);
                 if (result.success) {
                     m_canTabs[i]->setConnectionStatus(true);
                 } else {
                     m_canTabs[i]->setConnectionStatus(false, result.errorMessage);
                 }
+#else
+                m_canTabs[i]->setConnectionStatus(false, tr("Vector XL Library is only available on Windows"));
+#endif
+            } else if (cfg.interfaceType == "SocketCAN") {
+#ifdef __linux__
+                auto* socketDrv = canMgr.socketCanDriver(slotName);
+                if (!socketDrv || !socketDrv->initialize()) {
+                    m_canTabs[i]->setConnectionStatus(false, tr("SocketCAN not available"));
+                    return;
+                }
+
+                // The device field holds the network interface name (can0, vcan0, ...)
+                CANManager::CANChannelInfo chInfo;
+                chInfo.name = cfg.device.trimmed();
+                if (chInfo.name.isEmpty()) {
+                    m_canTabs[i]->setConnectionStatus(false, tr("No SocketCAN interface specified (e.g. can0)"));
+                    return;
+                }
+
+                auto result = canMgr.openSlot(slotName, socketDrv, chInfo, busConfig);
+                if (result.success) {
+                    m_canTabs[i]->setConnectionStatus(true);
+                } else {
+                    m_canTabs[i]->setConnectionStatus(false, result.errorMessage);
+                }
+#else
+                m_canTabs[i]->setConnectionStatus(false, tr("SocketCAN is only available on Linux"));
+#endif
+            } else if (cfg.interfaceType == "Virtual") {
+                // The device field names the virtual bus; slots using the same name share it
+                CANManager::CANChannelInfo chInfo;
+                chInfo.name = cfg.device.trimmed();
+                if (chInfo.name.isEmpty())
+                    chInfo.name = QStringLiteral("vbus0");
+
+                auto result = canMgr.openSlot(slotName, canMgr.virtualDriver(slotName), chInfo, busConfig);
+                if (result.success) {
+                    m_canTabs[i]->setConnectionStatus(true);
+                } else {
+                    m_canTabs[i]->setConnectionStatus(false, result.errorMessage);
+                }
             } else {
-                // Non-Vector: placeholder for PEAK/SocketCAN/Custom
+                // Placeholder for PEAK/Custom
                 m_canTabs[i]->setConnectionStatus(false, tr("Driver not implemented yet"));
             }
         });
 
         // Disconnect handler
         connect(m_canTabs[i], &CANConfigWidget::disconnectRequested, this, [this, i]() {
-            QString slotName = QString("CAN %1").arg(i + 1);
+            QString slotName = canSlotName(i);
             CANManager::CANBusManager::instance().closeSlot(slotName);
             m_canTabs[i]->setConnectionStatus(false);
         });
@@ -223,7 +277,7 @@ void HWConfigDialog::setupPowerSupplyTab(QTabWidget* parent)
     connect(m_powerSupplyConnectBtn, &QPushButton::clicked, this, [this]() {
         auto cfg = m_powerSupplySerial->config();
         if (cfg.portName.isEmpty()) return;
-        auto& serial = SerialManager::SerialPortManager::instance();
+        auto& serial = m_serial;
         serial.setPortConfig(cfg.portName, cfg);
         auto result = serial.openPort(cfg.portName);
         bool connected = result.success;
@@ -236,7 +290,7 @@ void HWConfigDialog::setupPowerSupplyTab(QTabWidget* parent)
     // Disconnect handler
     connect(m_powerSupplyDisconnectBtn, &QPushButton::clicked, this, [this]() {
         auto cfg = m_powerSupplySerial->config();
-        SerialManager::SerialPortManager::instance().closePort(cfg.portName);
+        m_serial.closePort(cfg.portName);
         m_powerSupplyConnectBtn->setEnabled(true);
         m_powerSupplyDisconnectBtn->setEnabled(false);
         m_powerSupplyStatusLabel->setText(tr("Disconnected"));
@@ -292,7 +346,7 @@ void HWConfigDialog::setupModbusTab(QTabWidget* parent)
     connect(m_modbusConnectBtn, &QPushButton::clicked, this, [this]() {
         auto cfg = m_modbusSerial->config();
         if (cfg.portName.isEmpty()) return;
-        auto& serial = SerialManager::SerialPortManager::instance();
+        auto& serial = m_serial;
         serial.setPortConfig(cfg.portName, cfg);
         auto result = serial.openPort(cfg.portName);
         bool connected = result.success;
@@ -305,7 +359,7 @@ void HWConfigDialog::setupModbusTab(QTabWidget* parent)
     // Disconnect handler
     connect(m_modbusDisconnectBtn, &QPushButton::clicked, this, [this]() {
         auto cfg = m_modbusSerial->config();
-        SerialManager::SerialPortManager::instance().closePort(cfg.portName);
+        m_serial.closePort(cfg.portName);
         m_modbusConnectBtn->setEnabled(true);
         m_modbusDisconnectBtn->setEnabled(false);
         m_modbusStatusLabel->setText(tr("Disconnected"));
@@ -314,7 +368,7 @@ void HWConfigDialog::setupModbusTab(QTabWidget* parent)
 
 void HWConfigDialog::loadFromManager()
 {
-    auto& mgr = HWConfigManager::instance();
+    auto& mgr = m_config;
 
     // Serial Debug Ports
     for (int i = 0; i < HWConfigManager::SERIAL_PORT_COUNT; ++i) {
@@ -342,7 +396,7 @@ void HWConfigDialog::loadFromManager()
 
 void HWConfigDialog::saveToManager()
 {
-    auto& mgr = HWConfigManager::instance();
+    auto& mgr = m_config;
 
     // Serial Debug Ports
     for (int i = 0; i < HWConfigManager::SERIAL_PORT_COUNT; ++i) {
@@ -371,7 +425,12 @@ void HWConfigDialog::saveToManager()
     mgr.setModbusRelay(mbCfg);
 
     mgr.save();
-    mgr.applyToSerialManager();
+    mgr.applyToSerialManager(m_serial);
+}
+
+QString HWConfigDialog::canSlotName(int index) const
+{
+    return m_canSlotPrefix + QString("CAN %1").arg(index + 1);
 }
 
 void HWConfigDialog::onApply()
@@ -22,6 +22,13 @@ class HWConfigDialog : public QDialog
 public:
     explicit HWConfigDialog(QWidget* parent = nullptr);
 
+    /**
+     * @brief Dialog for one test station's hardware.
+     * @param canSlotPrefix Prepended to the "CAN n" slot names (empty for the default station)
+     */
+    HWConfigDialog(HWConfigManager& config, SerialManager::SerialPortManager& serial,
+                   const QString& canSlotPrefix, QWidget* parent = nullptr);
+
 private slots:
     void onApply();
     void onOk();
@@ -34,6 +41,11 @@ private:
 
     void loadFromManager();
     void saveToManager();
+    QString canSlotName(int index) const;
+
+    HWConfigManager& m_config;
+    SerialManager::SerialPortManager& m_serial;
+    QString m_canSlotPrefix;
 
     // Serial Debug: 4 sub-tabs, each has customName + SerialConfigWidget
     struct SerialDebugTab {
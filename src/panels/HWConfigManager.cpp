@@ -9,6 +9,12 @@ HWConfigManager& HWConfigManager::instance()
 }
 
 HWConfigManager::HWConfigManager()
+    : HWConfigManager(QStringLiteral("HWConfig"))
+{
+}
+
+HWConfigManager::HWConfigManager(const QString& settingsGroup)
+    : m_settingsGroup(settingsGroup)
 {
     // Set default custom names
     m_serialDebugPorts[0].customName = "Debug Port 1";
@@ -236,7 +242,7 @@ void HWConfigManager::save()
 {
     QMutexLocker locker(&m_mutex);
     QSettings s;
-    s.beginGroup("HWConfig");
+    s.beginGroup(m_settingsGroup);
 
     // Write schema version first
     s.setValue("schemaVersion", CONFIG_SCHEMA_VERSION);
@@ -283,7 +289,7 @@ void HWConfigManager::load()
 {
     QMutexLocker locker(&m_mutex);
     QSettings s;
-    s.beginGroup("HWConfig");
+    s.beginGroup(m_settingsGroup);
 
     // Read and validate schema version.
     // If the stored version is newer than what we understand, skip loading
@@ -344,9 +350,13 @@ void HWConfigManager::load()
 }
 
 void HWConfigManager::applyToSerialManager()
+{
+    applyToSerialManager(SerialManager::SerialPortManager::instance());
+}
+
+void HWConfigManager::applyToSerialManager(SerialManager::SerialPortManager& serial)
 {
     QMutexLocker locker(&m_mutex);
-    auto& serial = SerialManager::SerialPortManager::instance();
     for (int i = 0; i < SERIAL_PORT_COUNT; ++i) {
         const auto& p = m_serialDebugPorts[i];
         if (!p.serial.portName.isEmpty())
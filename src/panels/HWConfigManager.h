@@ -23,7 +23,7 @@ struct SerialDebugPortConfig
 struct CANPortConfig
 {
     QString customName;                         ///< User-defined alias (e.g., "Vehicle CAN")
-    QString interfaceType = "Vector";           ///< Vector, PEAK PCAN, SocketCAN, Custom
+    QString interfaceType = "Vector";           ///< Vector, PEAK PCAN, SocketCAN, Virtual, Custom
     QString device = "PCAN_USBBUS1";            ///< Device identifier
     int channel = 1;                            ///< Hardware channel number
     int bitrate = 500000;                       ///< Nominal bitrate (bps)
@@ -65,6 +65,7 @@ struct ModbusRelayConfig
  *
  * Provides access to serial debug port configs (with custom aliases),
  * CAN port configs, power supply config, and Modbus relay config.
+ * Additional test stations each own an instance with a settings group of its own.
  */
 class HWConfigManager : public QObject
 {
@@ -79,6 +80,11 @@ public:
 
     static HWConfigManager& instance();
 
+    /** @brief Configuration persisted under settingsGroup instead of "HWConfig" */
+    explicit HWConfigManager(const QString& settingsGroup);
+
+    QString settingsGroup() const { return m_settingsGroup; }
+
     // --- Serial Debug Ports ---
     SerialDebugPortConfig serialDebugPort(int index) const;
     void setSerialDebugPort(int index, const SerialDebugPortConfig& config);
@@ -114,6 +120,7 @@ public:
 
     /** @brief Push serial configs to SerialPortManager */
     void applyToSerialManager();
+    void applyToSerialManager(SerialManager::SerialPortManager& serial);
 
 signals:
     void configChanged();
@@ -129,5 +136,6 @@ private:
     std::array<CANPortConfig, CAN_PORT_COUNT> m_canPorts;
     PowerSupplyConfig m_powerSupply;
     ModbusRelayConfig m_modbusRelay;
+    QString m_settingsGroup;
     mutable QMutex m_mutex;  ///< Protects all config data for cross-thread access
 };
@@ -1,5 +1,6 @@
 #include "SamplePanels.h"
 
+#include "BusStatisticsPanel.h"
 #include "IconManager.h"
 #include "PanelRegistry.h"
 #include <QIcon>
@@ -57,6 +58,17 @@ bool registerSamplePanels()
         .icon = DockManager::Icons::icon(DockManager::Icons::Id::ActivitySettings)
     });
 
+    success &= registry.registerPanel({
+        .id = "can_bus_statistics",
+        .title = "Bus Statistics",
+        .category = "CANalyzer",
+        .defaultArea = ads::RightDockWidgetArea,
+        .factory = [](QWidget* parent) -> QWidget* {
+            return new BusStatisticsPanel(parent);
+        },
+        .icon = DockManager::Icons::icon(DockManager::Icons::Id::ActivityCanalyzer)
+    });
+
     return success;
 }
 
@@ -8,6 +8,9 @@ namespace SamplePanels {
  * Current placeholders:
  * - can_trace
  * - ig_block
+ *
+ * Functional panels:
+ * - can_bus_statistics (BusStatisticsPanel)
  */
 bool registerSamplePanels();
 
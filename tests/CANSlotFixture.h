@@ -0,0 +1,61 @@
+#pragma once
+/**
+ * @file CANSlotFixture.h
+ * @brief Shared gtest fixture for tests that talk over CANBusManager slots.
+ *
+ * openSlots() opens virtual slots on a bus named after the running test, so
+ * bus state never leaks between tests; every slot opened this way is closed
+ * again in TearDown(). Fixtures that override TearDown() release their own
+ * objects first and then call CANSlotFixture::TearDown().
+ */
+
+#include <gtest/gtest.h>
+#include "CANManager.h"
+
+#include <QStringList>
+
+#include <initializer_list>
+
+class CANSlotFixture : public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        for (const QString& slot : m_openSlots)
+            can().closeSlot(slot);
+        m_openSlots.clear();
+    }
+
+    static CANManager::CANBusManager& can() { return CANManager::CANBusManager::instance(); }
+
+    /// "<prefix>_<test name>" — unique per test
+    static QString testBusName(const QString& prefix)
+    {
+        return prefix + QLatin1Char('_') + QString::fromLatin1(
+            ::testing::UnitTest::GetInstance()->current_test_info()->name());
+    }
+
+    static CANManager::CANChannelInfo channel(const QString& name)
+    {
+        CANManager::CANChannelInfo ch;
+        ch.name = name;
+        return ch;
+    }
+
+    /**
+     * @brief Open each slot on its own virtual driver, all on the bus
+     * testBusName(@p busPrefix). Use with ASSERT_NO_FATAL_FAILURE().
+     */
+    void openSlots(const QString& busPrefix, std::initializer_list<const char*> slotNames,
+                   const CANManager::CANBusConfig& config = CANManager::CANBusConfig{})
+    {
+        const CANManager::CANChannelInfo ch = channel(testBusName(busPrefix));
+        for (const char* slot : slotNames) {
+            ASSERT_TRUE(can().openSlot(slot, can().virtualDriver(slot), ch, config).success) << slot;
+            m_openSlots.append(QString::fromLatin1(slot));
+        }
+    }
+
+private:
+    QStringList m_openSlots;
+};
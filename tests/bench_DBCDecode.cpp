@@ -0,0 +1,114 @@
+/**
+ * @file bench_DBCDecode.cpp
+ * @brief Decode time of the signals of a DBC file (default:
+ *        resources/dbc/MIBCAN.dbc).
+ *
+ * Usage: bench_DBCDecode [file.dbc] [repetitions]
+ * Decodes every signal of every message from random frames, once through
+ * the compiled plans and once bit by bit (extractBitsLE / extractBitsBE),
+ * the path decode() took before signals were compiled and still takes for
+ * a signal without a current plan. Prints the best and mean time per
+ * signal of both.
+ *
+ * The exit code is 2 when the compiled decode is less than MIN_SPEEDUP
+ * times faster than the bit-by-bit one, 1 when the two disagree.
+ */
+
+#include "DBCParser.h"
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+using namespace DBCManager;
+
+static constexpr double MIN_SPEEDUP = 10.0;
+
+/// Random payloads decoded by every message
+static constexpr int FRAME_COUNT = 256;
+static constexpr int FRAME_BYTES = 64;
+
+/// Returns the best time (ns)
+static qint64 measure(const char* label, int repetitions, qint64 decodes, const std::function<double()>& decode)
+{
+    qint64 best = -1, total = 0;
+    double sink = 0.0;
+    for (int i = 0; i < repetitions; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        sink += decode();
+        const qint64 ns = timer.nsecsElapsed();
+        best = best < 0 ? ns : std::min(best, ns);
+        total += ns;
+    }
+    std::printf("%-12s best %7.2f ns  mean %7.2f ns per signal  (checksum %g)\n", label,
+                static_cast<double>(best) / decodes, static_cast<double>(total) / decodes / repetitions, sink);
+    return best;
+}
+
+/// Decodes every signal of @p messages from every frame; returns the sum of the values
+static double decodeAll(const QVector<DBCMessage>& messages, const std::vector<uint8_t>& frames)
+{
+    double sum = 0.0;
+    for (const DBCMessage& msg : messages) {
+        const int length = std::clamp(static_cast<int>(msg.dlc), 1, FRAME_BYTES);
+        for (int f = 0; f < FRAME_COUNT; ++f) {
+            const uint8_t* data = frames.data() + f * FRAME_BYTES;
+            for (const DBCSignal& sig : msg.signalList)
+                sum += sig.decode(data, length);
+        }
+    }
+    return sum;
+}
+
+int main(int argc, char** argv)
+{
+    const QString path = argc > 1 ? QString::fromLocal8Bit(argv[1])
+                                  : QStringLiteral(DBC_RESOURCE_DIR "/MIBCAN.dbc");
+    const int repetitions = argc > 2 ? std::max(1, std::atoi(argv[2])) : 20;
+
+    DBCParser parser;
+    const DBCDatabase db = parser.parseFile(path);
+    if (db.messages.isEmpty()) {
+        std::fprintf(stderr, "No messages in %s\n", qPrintable(path));
+        return 1;
+    }
+
+    // parseFile() compiles every signal; the copy decodes bit by bit
+    QVector<DBCMessage> compiled = db.messages;
+    QVector<DBCMessage> bitByBit = db.messages;
+    for (DBCMessage& msg : bitByBit) {
+        for (DBCSignal& sig : msg.signalList)
+            sig.plan = DBCSignalPlan();
+    }
+
+    std::vector<uint8_t> frames(static_cast<size_t>(FRAME_COUNT) * FRAME_BYTES);
+    std::mt19937 rng(1);
+    for (uint8_t& byte : frames)
+        byte = static_cast<uint8_t>(rng());
+
+    const qint64 decodes = static_cast<qint64>(db.totalSignalCount()) * FRAME_COUNT;
+    std::printf("%s: %d messages, %d signals, %d frames each\n", qPrintable(path),
+                static_cast<int>(db.messages.size()), db.totalSignalCount(), FRAME_COUNT);
+
+    if (decodeAll(compiled, frames) != decodeAll(bitByBit, frames)) {
+        std::fprintf(stderr, "Compiled and bit-by-bit decode disagree\n");
+        return 1;
+    }
+
+    const qint64 planned = measure("compiled", repetitions, decodes, [&] { return decodeAll(compiled, frames); });
+    const qint64 bits = measure("bit by bit", repetitions, decodes, [&] { return decodeAll(bitByBit, frames); });
+
+    const double speedup = static_cast<double>(bits) / static_cast<double>(std::max<qint64>(planned, 1));
+    std::printf("speed-up     %.1fx (minimum %.0fx)\n", speedup, MIN_SPEEDUP);
+    if (speedup < MIN_SPEEDUP) {
+        std::fprintf(stderr, "decode() is only %.1fx faster than the bit-by-bit path\n", speedup);
+        return 2;
+    }
+    return 0;
+}
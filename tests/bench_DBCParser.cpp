@@ -0,0 +1,88 @@
+/**
+ * @file bench_DBCParser.cpp
+ * @brief Parse time of a DBC file (default: resources/dbc/MIBCAN.dbc).
+ *
+ * Usage: bench_DBCParser [file.dbc] [repetitions] [threads]
+ * Prints the best and mean time of parseFile() and parseString(), and of
+ * parseFile() with one thread when threads (default: all cores) is not 1.
+ *
+ * The same file is also parsed with DBCRegexParser, the regex parser the
+ * tokenizer replaced. The exit code is 2 when parseFile() is less than
+ * MIN_SPEEDUP times faster than it.
+ */
+
+#include "DBCParser.h"
+#include "bench_DBCRegexParser.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+using namespace DBCManager;
+
+static constexpr double MIN_SPEEDUP = 5.0;
+
+/// Returns the best time (ns)
+static qint64 measure(const char* label, int repetitions, qint64 bytes, const std::function<void()>& parse)
+{
+    qint64 best = -1, total = 0;
+    for (int i = 0; i < repetitions; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        parse();
+        const qint64 ns = timer.nsecsElapsed();
+        best = best < 0 ? ns : std::min(best, ns);
+        total += ns;
+    }
+    std::printf("%-12s best %8.2f ms  mean %8.2f ms  %7.1f MB/s\n", label, best / 1e6,
+                total / 1e6 / repetitions, bytes / (best / 1e9) / 1e6);
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    const QString path = argc > 1 ? QString::fromLocal8Bit(argv[1])
+                                  : QStringLiteral(DBC_RESOURCE_DIR "/MIBCAN.dbc");
+    const int repetitions = argc > 2 ? std::max(1, std::atoi(argv[2])) : 20;
+    const int threads = argc > 3 ? std::max(0, std::atoi(argv[3])) : 0;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "Cannot open %s\n", qPrintable(path));
+        return 1;
+    }
+    const QString content = QString::fromUtf8(file.readAll());
+    file.close();
+
+    DBCParser parser;
+    parser.setThreadCount(threads);
+    const DBCDatabase db = parser.parseFile(path);
+    std::printf("%s: %lld bytes, %d messages, %d signals, %d errors\n", qPrintable(path),
+                static_cast<long long>(file.size()), static_cast<int>(db.messages.size()),
+                db.totalSignalCount(), static_cast<int>(parser.errors().size()));
+
+    const qint64 tokenizer = measure("parseFile", repetitions, file.size(), [&] { parser.parseFile(path); });
+    measure("parseString", repetitions, file.size(), [&] { parser.parseString(content); });
+    if (threads != 1) {
+        parser.setThreadCount(1);
+        measure("1 thread", repetitions, file.size(), [&] { parser.parseFile(path); });
+    }
+
+    DBCRegexParser reference;
+    const DBCDatabase referenceDb = reference.parseFile(path);
+    std::printf("regex parser: %d messages, %d signals\n", static_cast<int>(referenceDb.messages.size()),
+                referenceDb.totalSignalCount());
+    const qint64 regex = measure("regex", repetitions, file.size(), [&] { reference.parseFile(path); });
+
+    const double speedup = static_cast<double>(regex) / static_cast<double>(std::max<qint64>(tokenizer, 1));
+    std::printf("speed-up     %.1fx (minimum %.0fx)\n", speedup, MIN_SPEEDUP);
+    if (speedup < MIN_SPEEDUP) {
+        std::fprintf(stderr, "parseFile() is only %.1fx faster than the regex parser\n", speedup);
+        return 2;
+    }
+    return 0;
+}
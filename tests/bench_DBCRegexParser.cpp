@@ -0,0 +1,492 @@
+/**
+ * @file bench_DBCRegexParser.cpp
+ * @brief The line / regular expression DBC parser replaced by the DBCParser
+ *        tokenizer, kept unchanged (apart from the class name) as the
+ *        reference bench_DBCParser times against.
+ */
+
+#include "bench_DBCRegexParser.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QRegularExpression>
+#include <QTextStream>
+
+namespace DBCManager {
+
+//=============================================================================
+// DBCRegexParser implementation
+//=============================================================================
+
+DBCDatabase DBCRegexParser::parseFile(const QString& filePath)
+{
+    m_errors.clear();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        addError(0, QString("Cannot open file: %1").arg(filePath));
+        return {};
+    }
+
+    QTextStream stream(&file);
+    QString content = stream.readAll();
+    file.close();
+
+    DBCDatabase db;
+    db.filename = filePath;
+    parse(content, db);
+    return db;
+}
+
+DBCDatabase DBCRegexParser::parseString(const QString& content)
+{
+    m_errors.clear();
+    DBCDatabase db;
+    parse(content, db);
+    return db;
+}
+
+void DBCRegexParser::addError(int line, const QString& msg)
+{
+    m_errors.append({line, msg});
+    qWarning() << "[DBCRegexParser] Line" << line << ":" << msg;
+}
+
+void DBCRegexParser::parse(const QString& content, DBCDatabase& db)
+{
+    // Split into lines
+    QStringList lines = content.split('\n');
+    QStringList attributeValues;    // BA_ lines, applied once all objects and defaults are known
+    m_attributeDefaults.clear();
+
+    for (int i = 0; i < lines.size(); ++i) {
+        QString line = lines[i].trimmed();
+
+        if (line.isEmpty() || line.startsWith("//"))
+            continue;
+
+        // VERSION
+        if (line.startsWith("VERSION")) {
+            parseVersion(line, db);
+        }
+        // NS_ (new symbols) — skip
+        else if (line.startsWith("NS_")) {
+            // Skip until next top-level keyword
+            while (i + 1 < lines.size()) {
+                QString nextLine = lines[i + 1].trimmed();
+                if (nextLine.isEmpty() || nextLine.startsWith("BS_") ||
+                    nextLine.startsWith("BU_") || nextLine.startsWith("BO_") ||
+                    nextLine.startsWith("CM_") || nextLine.startsWith("BA_") ||
+                    nextLine.startsWith("VAL_") || nextLine.startsWith("SIG_"))
+                    break;
+                ++i;
+            }
+        }
+        // BS_ (bus speed) — skip
+        else if (line.startsWith("BS_")) {
+            // nothing to parse
+        }
+        // BU_ (nodes)
+        else if (line.startsWith("BU_")) {
+            parseNodes(line, db);
+        }
+        // BO_ (message definition)
+        else if (line.startsWith("BO_ ")) {
+            parseMessage(lines, i, db);
+        }
+        // CM_ (comment)
+        else if (line.startsWith("CM_ ")) {
+            parseComment(lines, i, db);
+        }
+        // VAL_TABLE_
+        else if (line.startsWith("VAL_TABLE_ ")) {
+            parseValueTable(lines, i, db);
+        }
+        // VAL_ (value descriptions for signals)
+        else if (line.startsWith("VAL_ ")) {
+            parseValueDescriptions(lines, i, db);
+        }
+        // SIG_VALTYPE_
+        else if (line.startsWith("SIG_VALTYPE_ ")) {
+            parseSignalValueType(line, db);
+        }
+        // BA_DEF_
+        else if (line.startsWith("BA_DEF_ ") || line.startsWith("BA_DEF_DEF_ ")) {
+            parseAttributeDefinition(line, db);
+        }
+        // BA_
+        else if (line.startsWith("BA_ ")) {
+            attributeValues.append(line);
+        }
+    }
+
+    // Build the ID->index hash for O(1) lookups
+    db.buildIndex();
+
+    applyAttributeDefaults(db);
+    for (const QString& line : attributeValues)
+        parseAttributeValue(line, db);
+}
+
+void DBCRegexParser::parseVersion(const QString& line, DBCDatabase& db)
+{
+    // VERSION "1.0"
+    static QRegularExpression re(R"re(VERSION\s+"([^"]*)")re");
+    auto match = re.match(line);
+    if (match.hasMatch()) {
+        db.version = match.captured(1);
+    }
+}
+
+void DBCRegexParser::parseNodes(const QString& line, DBCDatabase& db)
+{
+    // BU_ : Node1 Node2 Node3
+    QString rest = line.mid(4).trimmed(); // after "BU_ "
+    if (rest.startsWith(':'))
+        rest = rest.mid(1).trimmed();
+
+    QStringList nodeNames = rest.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+    for (const QString& name : nodeNames) {
+        DBCNode node;
+        node.name = name;
+        db.nodes.append(node);
+    }
+}
+
+void DBCRegexParser::parseMessage(const QStringList& lines, int& index, DBCDatabase& db)
+{
+    // BO_ <CAN-ID> <MessageName>: <MessageLength> <SendingNode>
+    // e.g.: BO_ 2024 OBD2: 8 Vector__XXX
+    QString line = lines[index].trimmed();
+
+    static QRegularExpression re(R"(BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+(\w+))");
+    auto match = re.match(line);
+    if (!match.hasMatch()) {
+        addError(index + 1, "Invalid message definition: " + line);
+        return;
+    }
+
+    DBCMessage msg;
+    uint32_t rawId = match.captured(1).toUInt();
+
+    // In DBC, if bit 31 is set, it's an extended (29-bit) ID
+    if (rawId & 0x80000000u) {
+        msg.isExtended = true;
+        msg.id = rawId & 0x1FFFFFFFu;
+    } else {
+        msg.isExtended = false;
+        msg.id = rawId & 0x7FFu;  // standard 11-bit
+    }
+
+    msg.name   = match.captured(2);
+    msg.dlc    = match.captured(3).toUInt();
+    msg.sender = match.captured(4);
+
+    // Parse signal lines that follow (indented with SG_)
+    while (index + 1 < lines.size()) {
+        QString nextLine = lines[index + 1].trimmed();
+        if (nextLine.startsWith("SG_ ")) {
+            ++index;
+            parseSignal(nextLine, msg);
+        } else {
+            break;
+        }
+    }
+
+    db.messages.append(msg);
+    db.indexLastMessage();
+}
+
+void DBCRegexParser::parseSignal(const QString& line, DBCMessage& msg)
+{
+    // SG_ <SignalName> [<MuxIndicator>] : <StartBit>|<Length>@<ByteOrder><ValueType>
+    //     (<Factor>,<Offset>) [<Min>|<Max>] "<Unit>" <ReceivingNodes>
+    //
+    // Example:
+    // SG_ EngineSpeed : 24|16@1+ (0.25,0) [0|16383.75] "rpm" Vector__XXX
+    // SG_ MuxSignal M : 0|4@1+ (1,0) [0|15] "" Vector__XXX
+    // SG_ MuxedSig m2 : 8|8@1+ (1,0) [0|255] "" Vector__XXX
+
+    static QRegularExpression re(
+        R"(SG_\s+(\w+)\s*)"                           // Signal name
+        R"(([Mm]\d*\s+)?)"                              // Optional mux indicator
+        R"(:\s*(\d+)\|(\d+)@([01])([+-]))"             // start|len@byteorder±
+        R"(\s*\(\s*([^,]+)\s*,\s*([^)]+)\s*\))"        // (factor,offset)
+        R"(\s*\[\s*([^|]+)\|([^\]]+)\s*\])"            // [min|max]
+        R"re(\s*"([^"]*)")re"                             // "unit"
+        R"(\s*(.*))"                                     // receivers
+    );
+
+    auto match = re.match(line);
+    if (!match.hasMatch()) {
+        // Could be a different format, skip silently
+        return;
+    }
+
+    DBCSignal sig;
+    sig.name = match.captured(1);
+
+    // Mux indicator
+    QString muxStr = match.captured(2).trimmed();
+    if (!muxStr.isEmpty()) {
+        sig.muxIndicator = muxStr;
+        if (muxStr == "M") {
+            // This is the multiplexer signal
+        } else if (muxStr.startsWith('m') || muxStr.startsWith('M')) {
+            bool ok;
+            sig.muxValue = muxStr.mid(1).toInt(&ok);
+        }
+    }
+
+    sig.startBit  = match.captured(3).toUInt();
+    sig.bitLength = match.captured(4).toUInt();
+
+    sig.byteOrder = (match.captured(5) == "0") ? ByteOrder::BigEndian : ByteOrder::LittleEndian;
+    sig.valueType = (match.captured(6) == "-") ? ValueType::Signed : ValueType::Unsigned;
+
+    sig.factor  = match.captured(7).toDouble();
+    sig.offset  = match.captured(8).toDouble();
+    sig.minimum = match.captured(9).toDouble();
+    sig.maximum = match.captured(10).toDouble();
+    sig.unit    = match.captured(11);
+
+    // Receivers
+    QString receiversStr = match.captured(12).trimmed();
+    if (!receiversStr.isEmpty()) {
+        sig.receivers = receiversStr.split(QRegularExpression("[,\\s]+"), Qt::SkipEmptyParts);
+    }
+
+    msg.signalList.append(sig);
+}
+
+void DBCRegexParser::parseComment(const QStringList& lines, int& index, DBCDatabase& db)
+{
+    // CM_ <type> <id> "comment";
+    // Comments can span multiple lines ending with ";
+    QString fullLine = lines[index].trimmed();
+
+    // Accumulate multi-line comment
+    while (!fullLine.endsWith(';') && index + 1 < lines.size()) {
+        ++index;
+        fullLine += "\n" + lines[index];
+    }
+
+    // Remove trailing semicolon
+    if (fullLine.endsWith(';'))
+        fullLine.chop(1);
+
+    // CM_ SG_ <msgId> <sigName> "comment"
+    static QRegularExpression reSig(R"re(CM_\s+SG_\s+(\d+)\s+(\w+)\s+"(.*)")re",
+                                     QRegularExpression::DotMatchesEverythingOption);
+    auto matchSig = reSig.match(fullLine);
+    if (matchSig.hasMatch()) {
+        uint32_t msgId = matchSig.captured(1).toUInt();
+        QString sigName = matchSig.captured(2);
+        QString comment = matchSig.captured(3);
+        // Remove closing quote if present
+        if (comment.endsWith('"'))
+            comment.chop(1);
+
+        // Handle extended ID bit
+        uint32_t lookupId = (msgId & 0x80000000u) ? (msgId & 0x1FFFFFFFu) : (msgId & 0x7FFu);
+        auto* msg = db.messageById(lookupId);
+        if (msg) {
+            auto* sig = msg->signal(sigName);
+            if (sig)
+                sig->comment = comment;
+        }
+        return;
+    }
+
+    // CM_ BO_ <msgId> "comment"
+    static QRegularExpression reMsg(R"re(CM_\s+BO_\s+(\d+)\s+"(.*)")re",
+                                     QRegularExpression::DotMatchesEverythingOption);
+    auto matchMsg = reMsg.match(fullLine);
+    if (matchMsg.hasMatch()) {
+        uint32_t msgId = matchMsg.captured(1).toUInt();
+        QString comment = matchMsg.captured(2);
+        if (comment.endsWith('"'))
+            comment.chop(1);
+
+        uint32_t lookupId = (msgId & 0x80000000u) ? (msgId & 0x1FFFFFFFu) : (msgId & 0x7FFu);
+        auto* msg = db.messageById(lookupId);
+        if (msg)
+            msg->comment = comment;
+        return;
+    }
+
+    // CM_ BU_ <nodeName> "comment"
+    static QRegularExpression reNode(R"re(CM_\s+BU_\s+(\w+)\s+"(.*)")re",
+                                      QRegularExpression::DotMatchesEverythingOption);
+    auto matchNode = reNode.match(fullLine);
+    if (matchNode.hasMatch()) {
+        QString nodeName = matchNode.captured(1);
+        QString comment = matchNode.captured(2);
+        if (comment.endsWith('"'))
+            comment.chop(1);
+        for (auto& node : db.nodes) {
+            if (node.name == nodeName) {
+                node.comment = comment;
+                break;
+            }
+        }
+        return;
+    }
+}
+
+void DBCRegexParser::parseValueDescriptions(const QStringList& lines, int& index, DBCDatabase& db)
+{
+    // VAL_ <msgId> <sigName> <value> "desc" <value> "desc" ... ;
+    QString fullLine = lines[index].trimmed();
+    while (!fullLine.endsWith(';') && index + 1 < lines.size()) {
+        ++index;
+        fullLine += " " + lines[index].trimmed();
+    }
+    if (fullLine.endsWith(';'))
+        fullLine.chop(1);
+
+    static QRegularExpression reHead(R"(VAL_\s+(\d+)\s+(\w+)\s+(.*))");
+    auto match = reHead.match(fullLine);
+    if (!match.hasMatch())
+        return;
+
+    uint32_t msgId = match.captured(1).toUInt();
+    QString sigName = match.captured(2);
+    QString rest = match.captured(3).trimmed();
+
+    uint32_t lookupId = (msgId & 0x80000000u) ? (msgId & 0x1FFFFFFFu) : (msgId & 0x7FFu);
+    auto* msg = db.messageById(lookupId);
+    if (!msg)
+        return;
+    auto* sig = msg->signal(sigName);
+    if (!sig)
+        return;
+
+    // Parse value-description pairs: <integer> "string" ...
+    static QRegularExpression rePair(R"re((-?\d+)\s+"([^"]*)")re");
+    auto it = rePair.globalMatch(rest);
+    while (it.hasNext()) {
+        auto m = it.next();
+        int64_t val = m.captured(1).toLongLong();
+        QString desc = m.captured(2);
+        sig->valueDescriptions[val] = desc;
+    }
+}
+
+void DBCRegexParser::parseValueTable(const QStringList& lines, int& index, DBCDatabase& db)
+{
+    // VAL_TABLE_ <name> <value> "desc" ... ;
+    QString fullLine = lines[index].trimmed();
+    while (!fullLine.endsWith(';') && index + 1 < lines.size()) {
+        ++index;
+        fullLine += " " + lines[index].trimmed();
+    }
+    if (fullLine.endsWith(';'))
+        fullLine.chop(1);
+
+    static QRegularExpression reHead(R"(VAL_TABLE_\s+(\w+)\s+(.*))");
+    auto match = reHead.match(fullLine);
+    if (!match.hasMatch())
+        return;
+
+    QString tableName = match.captured(1);
+    QString rest = match.captured(2).trimmed();
+
+    QMap<int64_t, QString> table;
+    static QRegularExpression rePair(R"re((-?\d+)\s+"([^"]*)")re");
+    auto it = rePair.globalMatch(rest);
+    while (it.hasNext()) {
+        auto m = it.next();
+        table[m.captured(1).toLongLong()] = m.captured(2);
+    }
+
+    db.valueTables[tableName] = table;
+}
+
+void DBCRegexParser::parseSignalValueType(const QString& line, DBCDatabase& db)
+{
+    // SIG_VALTYPE_ <msgId> <sigName> : <type>;
+    // type: 1 = float32, 2 = float64
+    static QRegularExpression re(R"(SIG_VALTYPE_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s*;)");
+    auto match = re.match(line);
+    if (!match.hasMatch())
+        return;
+
+    uint32_t msgId = match.captured(1).toUInt();
+    QString sigName = match.captured(2);
+    int type = match.captured(3).toInt();
+
+    uint32_t lookupId = (msgId & 0x80000000u) ? (msgId & 0x1FFFFFFFu) : (msgId & 0x7FFu);
+    auto* msg = db.messageById(lookupId);
+    if (!msg) return;
+    auto* sig = msg->signal(sigName);
+    if (!sig) return;
+
+    if (type == 1)
+        sig->valueType = ValueType::Float32;
+    else if (type == 2)
+        sig->valueType = ValueType::Float64;
+}
+
+void DBCRegexParser::parseAttributeDefinition(const QString& line, DBCDatabase& /*db*/)
+{
+    // BA_DEF_DEF_ "GenMsgCycleTime" 100;
+    // BA_DEF_ lines (types and ranges) are not needed and skipped.
+    static QRegularExpression re(R"re(BA_DEF_DEF_\s+"(\w+)"\s+"?([^";]*)"?\s*;)re");
+    auto match = re.match(line);
+    if (match.hasMatch())
+        m_attributeDefaults.insert(match.captured(1), match.captured(2).trimmed());
+}
+
+void DBCRegexParser::applyAttributeDefaults(DBCDatabase& db)
+{
+    bool ok = false;
+    const int cycleTime = m_attributeDefaults.value("GenMsgCycleTime").toInt(&ok);
+    if (ok) {
+        for (auto& msg : db.messages)
+            msg.cycleTimeMs = cycleTime;
+    }
+
+    const double startValue = m_attributeDefaults.value("GenSigStartValue").toDouble(&ok);
+    if (ok) {
+        for (auto& msg : db.messages) {
+            for (auto& sig : msg.signalList)
+                sig.initialValue = sig.rawToPhysical(static_cast<int64_t>(startValue));
+        }
+    }
+}
+
+void DBCRegexParser::parseAttributeValue(const QString& line, DBCDatabase& db)
+{
+    // BA_ "GenMsgCycleTime" BO_ 256 100;
+    // BA_ "GenSigStartValue" SG_ 256 EngineSpeed 3200;
+    // Network (BA_ "name" value;), node and environment attributes are skipped.
+    static QRegularExpression re(R"re(BA_\s+"(\w+)"\s+(BO_|SG_)\s+(\d+)\s+(?:(\w+)\s+)?([^;]+);)re");
+    auto match = re.match(line);
+    if (!match.hasMatch())
+        return;
+
+    const QString name = match.captured(1);
+    if (name != "GenMsgCycleTime" && name != "GenSigStartValue")
+        return;
+
+    uint32_t msgId = match.captured(3).toUInt();
+    uint32_t lookupId = (msgId & 0x80000000u) ? (msgId & 0x1FFFFFFFu) : (msgId & 0x7FFu);
+    auto* msg = db.messageById(lookupId);
+    if (!msg)
+        return;
+
+    bool ok = false;
+    const double value = match.captured(5).trimmed().toDouble(&ok);
+    if (!ok)
+        return;
+
+    if (match.captured(2) == "BO_" && name == "GenMsgCycleTime") {
+        msg->cycleTimeMs = static_cast<int>(value);
+    } else if (match.captured(2) == "SG_" && name == "GenSigStartValue") {
+        if (auto* sig = msg->signal(match.captured(4)))
+            sig->initialValue = sig->rawToPhysical(static_cast<int64_t>(value));
+    }
+}
+
+} // namespace DBCManager
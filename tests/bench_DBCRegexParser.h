@@ -0,0 +1,49 @@
+#pragma once
+/**
+ * @file bench_DBCRegexParser.h
+ * @brief Bench-only copy of the former DBC parser: splits the text into
+ *        lines and matches each statement with QRegularExpression.
+ *
+ * Not part of the library; bench_DBCParser parses the same file with it and
+ * with DBCParser to report the speed-up of the tokenizer.
+ */
+
+#include "DBCParser.h"
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace DBCManager {
+
+class DBCRegexParser
+{
+public:
+    DBCDatabase parseFile(const QString& filePath);
+    DBCDatabase parseString(const QString& content);
+
+    bool hasErrors() const { return !m_errors.isEmpty(); }
+    QVector<DBCParseError> errors() const { return m_errors; }
+
+private:
+    void parse(const QString& content, DBCDatabase& db);
+    void parseVersion(const QString& line, DBCDatabase& db);
+    void parseNodes(const QString& line, DBCDatabase& db);
+    void parseMessage(const QStringList& lines, int& index, DBCDatabase& db);
+    void parseSignal(const QString& line, DBCMessage& msg);
+    void parseComment(const QStringList& lines, int& index, DBCDatabase& db);
+    void parseValueDescriptions(const QStringList& lines, int& index, DBCDatabase& db);
+    void parseValueTable(const QStringList& lines, int& index, DBCDatabase& db);
+    void parseSignalValueType(const QString& line, DBCDatabase& db);
+    void parseAttributeDefinition(const QString& line, DBCDatabase& db);
+    void parseAttributeValue(const QString& line, DBCDatabase& db);
+    void applyAttributeDefaults(DBCDatabase& db);
+
+    void addError(int line, const QString& msg);
+
+    QVector<DBCParseError> m_errors;
+    QHash<QString, QString> m_attributeDefaults;    ///< BA_DEF_DEF_ name → value
+};
+
+} // namespace DBCManager
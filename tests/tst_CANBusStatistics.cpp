@@ -0,0 +1,232 @@
+/**
+ * @file tst_CANBusStatistics.cpp
+ * @brief Unit tests for CANBusStatistics — counters, bus load, per-ID
+ *        rates, history and reset — and the per-slot statistics kept by
+ *        CANBusManager on a virtual bus.
+ */
+
+#include <gtest/gtest.h>
+#include "CANBusStatistics.h"
+#include "CANManager.h"
+#include "CANSlotFixture.h"
+#include "VirtualCANBus.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <vector>
+
+using namespace CANManager;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static CANMessage makeFrame(uint32_t id, int len = 8, bool extended = false)
+{
+    CANMessage msg;
+    msg.id = id;
+    msg.dlc = static_cast<uint8_t>(len);
+    msg.isExtended = extended;
+    return msg;
+}
+
+/// Waits for the sample period to end and closes it
+static void sampleAfterPeriod(CANBusStatistics& stats)
+{
+    QThread::msleep(CANBusStatistics::SAMPLE_INTERVAL_MS + 20);
+    stats.sampleIfDue();
+}
+
+/// Polls the manager until pred(stats) holds or the timeout expires
+template <typename Pred>
+static bool waitForStatistics(const QString& slot, Pred pred, int timeoutMs = 2000)
+{
+    QElapsedTimer timer;
+    timer.start();
+    CANBusManager::BusStatistics stats;
+    while (timer.elapsed() < timeoutMs) {
+        if (CANBusManager::instance().busStatistics(slot, stats) && pred(stats))
+            return true;
+        QThread::msleep(10);
+    }
+    return false;
+}
+
+// ============================================================================
+// Counting
+// ============================================================================
+
+TEST(CANBusStatistics, CountsDirectionsErrorsAndConfirmations)
+{
+    CANBusStatistics stats(500000, 2000000);
+
+    std::vector<CANMessage> rx{makeFrame(0x100), makeFrame(0x100, 4), makeFrame(0x200, 2)};
+    CANMessage error;
+    error.isError = true;
+    rx.push_back(error);
+    CANMessage confirm = makeFrame(0x300);
+    confirm.isTxConfirm = true;
+    rx.push_back(confirm);
+    stats.onReceived(rx.data(), static_cast<int>(rx.size()));
+
+    const CANMessage tx[] = {makeFrame(0x300), makeFrame(0x301), makeFrame(0x302)};
+    stats.onTransmitted(tx, 3, 2);
+
+    const auto snapshot = stats.snapshot();
+    EXPECT_EQ(snapshot.rxFrames, 3u);
+    EXPECT_EQ(snapshot.rxBytes, 14u);
+    EXPECT_EQ(snapshot.errorFrames, 1u);
+    EXPECT_EQ(snapshot.txConfirmations, 1u);
+    EXPECT_EQ(snapshot.txRequests, 2u);
+    EXPECT_EQ(snapshot.txBytes, 16u);
+    EXPECT_EQ(snapshot.txRejected, 1u);
+    EXPECT_EQ(snapshot.rxBatchHighWater, 5);
+
+    // Confirmations and rejected frames are not counted per ID
+    ASSERT_EQ(snapshot.ids.size(), 4);
+    EXPECT_EQ(snapshot.ids[0].id, 0x100u);
+    EXPECT_EQ(snapshot.ids[0].frames, 2u);
+    for (const auto& id : snapshot.ids)
+        EXPECT_NE(id.id, 0x302u);
+}
+
+TEST(CANBusStatistics, BusLoadMatchesFrameDuration)
+{
+    CANBusStatistics stats(500000, 2000000);
+
+    CANMessage fd = makeFrame(0x18DAF110, 15, true);
+    fd.isFD = true;
+    fd.isBRS = true;
+    const std::vector<CANMessage> frames{makeFrame(0x100), makeFrame(0x101, 0), fd};
+    uint64_t busTimeNs = 0;
+    for (int i = 0; i < 200; ++i) {
+        stats.onReceived(frames.data(), static_cast<int>(frames.size()));
+        for (const CANMessage& msg : frames)
+            busTimeNs += frameDurationNs(msg, 500000, 2000000);
+    }
+
+    sampleAfterPeriod(stats);
+    const auto snapshot = stats.snapshot();
+    const double periodS = snapshot.current.timeS;
+    ASSERT_GT(periodS, 0.0);
+    EXPECT_NEAR(snapshot.current.busLoadPercent, busTimeNs / (periodS * 1e7), 1e-6);
+    EXPECT_NEAR(snapshot.current.rxFramesPerSecond, 600 / periodS, 1e-6);
+    EXPECT_DOUBLE_EQ(snapshot.peakBusLoadPercent, snapshot.current.busLoadPercent);
+    EXPECT_GT(snapshot.meanBusLoadPercent, 0.0);
+
+    // Per-ID rates come from the same period, busiest first
+    ASSERT_EQ(snapshot.ids.size(), 3);
+    EXPECT_NEAR(snapshot.ids[0].framesPerSecond, 200 / periodS, 1e-6);
+}
+
+TEST(CANBusStatistics, IdsBeyondTableAreUntracked)
+{
+    CANBusStatistics stats(500000, 2000000);
+
+    const int ids = CANBusStatistics::ID_TABLE_SIZE + 100;
+    for (int i = 0; i < ids; ++i) {
+        const CANMessage msg = makeFrame(0x10000 + static_cast<uint32_t>(i), 8, true);
+        stats.onReceived(&msg, 1);
+    }
+
+    const auto snapshot = stats.snapshot();
+    EXPECT_EQ(snapshot.rxFrames, static_cast<uint64_t>(ids));
+    EXPECT_GE(snapshot.untrackedFrames, 100u);
+    EXPECT_EQ(static_cast<uint64_t>(snapshot.ids.size()) + snapshot.untrackedFrames,
+              static_cast<uint64_t>(ids));
+}
+
+// ============================================================================
+// History and reset
+// ============================================================================
+
+TEST(CANBusStatistics, HistoryKeepsSamplesInOrderAndResetClears)
+{
+    CANBusStatistics stats(500000, 0);
+    const CANMessage msg = makeFrame(0x123);
+
+    stats.sampleIfDue();                   // Period not over yet
+    EXPECT_TRUE(stats.history().isEmpty());
+
+    stats.onReceived(&msg, 1);
+    sampleAfterPeriod(stats);
+    sampleAfterPeriod(stats);
+
+    const auto history = stats.history();
+    ASSERT_EQ(history.size(), 2);
+    EXPECT_LT(history[0].timeS, history[1].timeS);
+    EXPECT_GT(history[0].rxFramesPerSecond, 0.0);
+    EXPECT_DOUBLE_EQ(history[1].rxFramesPerSecond, 0.0);
+
+    stats.updateQueueHighWater(12, 3);
+    stats.reset();
+    const auto snapshot = stats.snapshot();
+    EXPECT_EQ(snapshot.rxFrames, 0u);
+    EXPECT_EQ(snapshot.rxQueueHighWater, 0u);
+    EXPECT_DOUBLE_EQ(snapshot.peakBusLoadPercent, 0.0);
+    EXPECT_TRUE(snapshot.ids.isEmpty());
+    EXPECT_TRUE(stats.history().isEmpty());
+}
+
+// ============================================================================
+// CANBusManager slots
+// ============================================================================
+
+using CANBusStatisticsSlots = CANSlotFixture;
+
+TEST_F(CANBusStatisticsSlots, ManagerCountsSlotTraffic)
+{
+    auto& mgr = can();
+    CANBusConfig cfg;
+    CANBusManager::BusStatistics stats;
+    EXPECT_FALSE(mgr.busStatistics("VS 1", stats));
+
+    mgr.virtualDriver("VS 1")->setTxConfirmations(true);
+    ASSERT_NO_FATAL_FAILURE(openSlots("t_stats", {"VS 1", "VS 2"}, cfg));
+
+    for (int i = 0; i < 10; ++i)
+        ASSERT_TRUE(mgr.transmit("VS 1", makeFrame(0x7E0)).success);
+    const CANMessage batch[] = {makeFrame(0x7E1), makeFrame(0x7E2)};
+    int sent = 0;
+    ASSERT_TRUE(mgr.transmitBatch("VS 1", batch, sent).success);
+
+    EXPECT_TRUE(waitForStatistics("VS 2", [](const auto& s) { return s.rxFrames == 12; }));
+    EXPECT_TRUE(waitForStatistics("VS 1", [](const auto& s) { return s.txConfirmations == 12; }));
+
+    ASSERT_TRUE(mgr.busStatistics("VS 1", stats));
+    EXPECT_EQ(stats.txRequests, 12u);
+    EXPECT_EQ(stats.rxFrames, 0u);
+    EXPECT_EQ(stats.bitrate, cfg.bitrate);
+    ASSERT_FALSE(stats.ids.isEmpty());
+    EXPECT_EQ(stats.ids[0].id, 0x7E0u);
+    EXPECT_EQ(stats.ids[0].frames, 10u);
+
+    ASSERT_TRUE(mgr.busStatistics("VS 2", stats));
+    EXPECT_EQ(stats.txRequests, 0u);
+    EXPECT_GE(stats.rxBatchHighWater, 1);
+    EXPECT_GE(stats.rxQueueHighWater, 1u);
+
+    // The dispatcher closes sample periods even on an idle bus
+    EXPECT_TRUE(waitForStatistics("VS 2", [](const auto& s) { return s.current.timeS > 0.0; }));
+    EXPECT_FALSE(mgr.busStatisticsHistory("VS 2").isEmpty());
+
+    ASSERT_TRUE(mgr.resetBusStatistics("VS 2").success);
+    ASSERT_TRUE(mgr.busStatistics("VS 2", stats));
+    EXPECT_EQ(stats.rxFrames, 0u);
+
+    mgr.closeSlot("VS 1");
+    mgr.closeSlot("VS 2");
+    EXPECT_FALSE(mgr.resetBusStatistics("VS 1").success);
+}
+
+TEST_F(CANBusStatisticsSlots, ManagerCountsErrorFrames)
+{
+    auto bus = VirtualCANBus::bus(testBusName("t_stats"));
+    bus->setTiming(VirtualCANBus::Timing::Simulated);
+    ASSERT_NO_FATAL_FAILURE(openSlots("t_stats", {"VS 1", "VS 2"}));
+
+    bus->injectErrors(2);
+    ASSERT_TRUE(can().transmit("VS 1", makeFrame(0x222)).success);
+
+    EXPECT_TRUE(waitForStatistics("VS 2", [](const auto& s) { return s.errorFrames == 2 && s.rxFrames == 1; }));
+}
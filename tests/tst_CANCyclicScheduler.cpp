@@ -0,0 +1,228 @@
+/**
+ * @file tst_CANCyclicScheduler.cpp
+ * @brief Unit tests for CANCyclicScheduler — period accuracy, atomic payload
+ *        updates, skipped cycles, statistics and slot shutdown.
+ *
+ * The scheduler transmits on a VirtualCANDriver node; a second node on the
+ * same bus records what arrived. Timing bounds are loose so the tests stay
+ * stable on loaded CI machines.
+ */
+
+#include <gtest/gtest.h>
+#include "CANCyclicScheduler.h"
+#include "CANManager.h"
+#include "VirtualCANDriver.h"
+
+#include <QThread>
+
+#include <cstring>
+
+using namespace CANManager;
+
+// ============================================================================
+// Fixture
+// ============================================================================
+
+class CANCyclicSchedulerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_busName = QString::fromLatin1("t_cyclic_%1")
+            .arg(QString::fromLatin1(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        CANChannelInfo ch;
+        ch.name = m_busName;
+        VirtualCANBus::bus(m_busName)->setTiming(VirtualCANBus::Timing::Simulated);
+
+        ASSERT_TRUE(m_sender.openChannel(ch, m_cfg).success);
+        ASSERT_TRUE(m_listener.openChannel(ch, m_cfg).success);
+        m_scheduler = std::make_unique<CANCyclicScheduler>(&m_sender, &m_txMutex, m_busName);
+    }
+
+    void TearDown() override
+    {
+        m_scheduler->shutdown();
+        m_listener.closeChannel();
+        m_sender.closeChannel();
+    }
+
+    static CANMessage frame(uint32_t id, uint8_t fill)
+    {
+        CANMessage msg;
+        msg.id = id;
+        msg.dlc = 8;
+        std::memset(msg.data, fill, 8);
+        return msg;
+    }
+
+    /// Drain everything the listener has received (including frames still being delivered)
+    std::vector<CANMessage> received()
+    {
+        std::vector<CANMessage> frames;
+        CANMessage msg;
+        while (m_listener.receive(msg, 20).success)
+            frames.push_back(msg);
+        return frames;
+    }
+
+    QString          m_busName;
+    CANBusConfig     m_cfg;
+    VirtualCANDriver m_sender;
+    VirtualCANDriver m_listener;
+    QMutex           m_txMutex;
+    std::unique_ptr<CANCyclicScheduler> m_scheduler;
+};
+
+// ============================================================================
+// Timing
+// ============================================================================
+
+TEST_F(CANCyclicSchedulerTest, SendsAtNominalPeriod)
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+    ASSERT_TRUE(m_scheduler->start(frame(0x100, 0xAA), 5).success);
+    QThread::msleep(300);
+
+    CANCyclicScheduler::Stats stats;
+    ASSERT_TRUE(m_scheduler->stop(0x100, false, &stats).success);
+    const qint64 elapsedMs = elapsed.elapsed();
+    EXPECT_EQ(stats.periodMs, 5);
+    EXPECT_EQ(stats.errors, 0u);
+
+    // ~60 cycles; absolute deadlines keep the count from drifting low, and
+    // a loaded machine can only make it skip cycles, never add any
+    EXPECT_GE(stats.sent + stats.missed, 50u);
+    EXPECT_LE(stats.sent + stats.missed, static_cast<uint64_t>(elapsedMs / 5 + 2));
+    EXPECT_GT(stats.meanPeriodUs, 4000.0);
+    EXPECT_LE(stats.minPeriodUs, stats.meanPeriodUs);
+    EXPECT_GE(stats.maxPeriodUs, stats.meanPeriodUs);
+
+    const auto frames = received();
+    EXPECT_EQ(frames.size(), stats.sent);
+}
+
+TEST_F(CANCyclicSchedulerTest, IndependentPeriodsKeepTheirRates)
+{
+    ASSERT_TRUE(m_scheduler->start(frame(0x200, 0x01), 10).success);
+    ASSERT_TRUE(m_scheduler->start(frame(0x201, 0x02), 20).success);
+    EXPECT_EQ(m_scheduler->count(), 2);
+    QThread::msleep(205);
+
+    CANCyclicScheduler::Stats fast, slow;
+    ASSERT_TRUE(m_scheduler->stats(0x200, false, fast));
+    ASSERT_TRUE(m_scheduler->stats(0x201, false, slow));
+    EXPECT_NEAR(static_cast<double>(fast.sent + fast.missed),
+                2.0 * static_cast<double>(slow.sent + slow.missed), 2.0);
+}
+
+TEST_F(CANCyclicSchedulerTest, OffsetDelaysFirstCycle)
+{
+    ASSERT_TRUE(m_scheduler->start(frame(0x210, 0x01), 200).success);
+    ASSERT_TRUE(m_scheduler->start(frame(0x211, 0x02), 200, 60).success);
+    EXPECT_FALSE(m_scheduler->start(frame(0x212, 0x03), 100, -1).success);
+
+    QThread::msleep(30);
+    auto frames = received();
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].id, 0x210u);
+
+    QThread::msleep(60);
+    frames = received();
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].id, 0x211u);
+}
+
+TEST_F(CANCyclicSchedulerTest, LateCyclesAreSkippedNotBurst)
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+    ASSERT_TRUE(m_scheduler->start(frame(0x300, 0x33), 5).success);
+    QThread::msleep(30);
+
+    // Block the TX path for ~10 periods
+    m_txMutex.lock();
+    QThread::msleep(50);
+    m_txMutex.unlock();
+    QThread::msleep(30);
+
+    CANCyclicScheduler::Stats stats;
+    ASSERT_TRUE(m_scheduler->stats(0x300, false, stats));
+    EXPECT_GE(stats.missed, 5u);
+    // A burst would send the late cycles on top of the deadlines that passed
+    EXPECT_LE(stats.sent + stats.missed, static_cast<uint64_t>(elapsed.elapsed() / 5 + 2));
+    EXPECT_GE(stats.maxLatenessUs, 20000.0);
+}
+
+// ============================================================================
+// Payload updates and stop
+// ============================================================================
+
+TEST_F(CANCyclicSchedulerTest, UpdateReplacesWholePayload)
+{
+    ASSERT_TRUE(m_scheduler->start(frame(0x400, 0x11), 1).success);
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_TRUE(m_scheduler->update(frame(0x400, (i % 2) ? 0x11 : 0x22)).success);
+        QThread::usleep(300);
+    }
+    ASSERT_TRUE(m_scheduler->update(frame(0x400, 0x22)).success);
+    QThread::msleep(10);
+    ASSERT_TRUE(m_scheduler->stop(0x400, false).success);
+
+    const auto frames = received();
+    ASSERT_FALSE(frames.empty());
+    for (const auto& msg : frames) {
+        for (int b = 1; b < 8; ++b)
+            ASSERT_EQ(msg.data[b], msg.data[0]) << "torn payload";
+    }
+    EXPECT_EQ(frames.back().data[0], 0x22);
+}
+
+TEST_F(CANCyclicSchedulerTest, UpdateUnknownIdFails)
+{
+    EXPECT_FALSE(m_scheduler->update(frame(0x500, 0x00)).success);
+    EXPECT_FALSE(m_scheduler->stop(0x500, false).success);
+}
+
+TEST_F(CANCyclicSchedulerTest, StopReturnsStatsAndHalts)
+{
+    ASSERT_TRUE(m_scheduler->start(frame(0x600, 0x66), 2).success);
+    QThread::msleep(50);
+
+    CANCyclicScheduler::Stats stats;
+    ASSERT_TRUE(m_scheduler->stop(0x600, false, &stats).success);
+    EXPECT_GT(stats.sent, 10u);
+    EXPECT_EQ(m_scheduler->count(), 0);
+
+    received();
+    QThread::msleep(20);
+    EXPECT_TRUE(received().empty());
+}
+
+// ============================================================================
+// CANBusManager integration
+// ============================================================================
+
+TEST(CANCyclicSchedulerManager, ClosingSlotStopsCyclicFrames)
+{
+    auto& mgr = CANBusManager::instance();
+    CANChannelInfo ch;
+    ch.name = QStringLiteral("t_cyclic_manager");
+    VirtualCANBus::bus(ch.name)->setTiming(VirtualCANBus::Timing::Simulated);
+
+    ASSERT_TRUE(mgr.openSlot("CY 1", mgr.virtualDriver("CY 1"), ch, CANBusConfig{}).success);
+
+    CANMessage msg;
+    msg.id = 0x700;
+    msg.dlc = 1;
+    ASSERT_TRUE(mgr.startCyclic("CY 1", msg, 5).success);
+    QThread::msleep(30);
+
+    CANBusManager::CyclicStats stats;
+    ASSERT_TRUE(mgr.cyclicStats("CY 1", 0x700, false, stats));
+    EXPECT_GT(stats.sent, 0u);
+
+    mgr.closeSlot("CY 1");
+    EXPECT_FALSE(mgr.cyclicStats("CY 1", 0x700, false, stats));
+    EXPECT_FALSE(mgr.startCyclic("CY 1", msg, 5).success);
+}
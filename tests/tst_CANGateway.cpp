@@ -0,0 +1,328 @@
+/**
+ * @file tst_CANGateway.cpp
+ * @brief Unit tests for CANGateway — forwarding between virtual buses,
+ *        first-match rule tables, block / delay / rewrite actions, per-rule
+ *        counters and JSON rule files.
+ *
+ * Each test bridges two virtual buses: "GW A" and "GW B" share the first
+ * bus, "GW C" and "GW D" the second. The gateway forwards GW B → GW C.
+ */
+
+#include <gtest/gtest.h>
+#include "CANGateway.h"
+#include "CANManager.h"
+#include "CANSlotFixture.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+
+using namespace CANManager;
+
+// ============================================================================
+// Fixture
+// ============================================================================
+
+class CANGatewayTest : public CANSlotFixture
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(openSlots("t_gw_in", {"GW A", "GW B"}));
+        ASSERT_NO_FATAL_FAILURE(openSlots("t_gw_out", {"GW C", "GW D"}));
+    }
+
+    void TearDown() override
+    {
+        can().stopGateway("GW B", "GW C");
+        CANSlotFixture::TearDown();
+    }
+
+    static CANMessage frame(uint32_t id, bool extended = false)
+    {
+        CANMessage msg;
+        msg.id = id;
+        msg.isExtended = extended;
+        msg.dlc = 8;
+        for (int i = 0; i < 8; ++i)
+            msg.data[i] = static_cast<uint8_t>(0x10 + i);
+        return msg;
+    }
+
+    CANResult startGateway(const QList<CANGateway::Rule>& rules,
+                           CANGateway::Action defaultAction = CANGateway::Action::Forward)
+    {
+        CANBusManager::GatewayOptions options;
+        options.source = "GW B";
+        options.destination = "GW C";
+        options.rules = rules;
+        options.defaultAction = defaultAction;
+        return can().startGateway(options);
+    }
+
+    /// IDs arriving on the far side within timeoutMs
+    static QList<uint32_t> receivedIds(int timeoutMs = 200)
+    {
+        QList<uint32_t> ids;
+        CANMessage rx;
+        while (can().receive("GW D", rx, timeoutMs).success)
+            ids.append(rx.id);
+        return ids;
+    }
+};
+
+static CANGateway::Rule rule(const CANIdFilter& match,
+                             CANGateway::Action action = CANGateway::Action::Forward)
+{
+    CANGateway::Rule r;
+    r.match = match;
+    r.action = action;
+    return r;
+}
+
+// ============================================================================
+// Forwarding and rule matching
+// ============================================================================
+
+TEST_F(CANGatewayTest, ForwardsByDefaultAndBlocksByRule)
+{
+    ASSERT_TRUE(startGateway({rule(CANIdFilter::exact(0x200), CANGateway::Action::Block)}).success);
+    EXPECT_FALSE(startGateway({}).success);     // One gateway per direction
+
+    for (uint32_t id : {0x100u, 0x200u, 0x300u})
+        ASSERT_TRUE(can().transmit("GW A", frame(id)).success);
+
+    EXPECT_EQ(receivedIds(), QList<uint32_t>({0x100, 0x300}));
+
+    CANBusManager::GatewayStats stats;
+    ASSERT_TRUE(can().gatewayStats("GW B", "GW C", stats));
+    EXPECT_TRUE(stats.running);
+    EXPECT_EQ(stats.received, 3u);
+    EXPECT_EQ(stats.forwarded, 2u);
+    EXPECT_EQ(stats.blocked, 1u);
+    ASSERT_EQ(stats.rules.size(), 1);
+    EXPECT_EQ(stats.rules[0].name, "0x200");
+    EXPECT_EQ(stats.rules[0].matched, 1u);
+    EXPECT_EQ(stats.rules[0].dropped, 1u);
+    EXPECT_EQ(stats.defaultRule.forwarded, 2u);
+    EXPECT_GT(stats.maxLatencyUs, 0.0);
+}
+
+TEST_F(CANGatewayTest, FirstMatchingRuleWins)
+{
+    CANGateway::Rule rewrite = rule(CANIdFilter::exact(0x18FF1234, true));
+    rewrite.rewriteId = true;
+    rewrite.newId = 0x18FF4321;
+    ASSERT_TRUE(startGateway({rule(CANIdFilter::exact(0x7E0)),
+                              rule(CANIdFilter::masked(0x700, 0x700), CANGateway::Action::Block),
+                              rule({0x18FF0000, 0x1FFF0000, false, true}, CANGateway::Action::Block),
+                              rewrite,
+                              rule(CANIdFilter::exact(0x18AA0001, true))},
+                             CANGateway::Action::Block).success);
+
+    ASSERT_TRUE(can().transmit("GW A", frame(0x7E0)).success);                // Rule 1 before the mask
+    ASSERT_TRUE(can().transmit("GW A", frame(0x7E8)).success);                // Mask rule
+    ASSERT_TRUE(can().transmit("GW A", frame(0x18FF1234, true)).success);     // Mask rule shadows rule 4
+    ASSERT_TRUE(can().transmit("GW A", frame(0x18AA0001, true)).success);     // Exact extended
+    ASSERT_TRUE(can().transmit("GW A", frame(0x123)).success);                // Default: block
+
+    EXPECT_EQ(receivedIds(), QList<uint32_t>({0x7E0, 0x18AA0001}));
+
+    CANBusManager::GatewayStats stats;
+    ASSERT_TRUE(can().gatewayStats("GW B", "GW C", stats));
+    EXPECT_EQ(stats.rules[2].matched, 1u);
+    EXPECT_EQ(stats.rules[3].matched, 0u);
+    EXPECT_EQ(stats.defaultRule.dropped, 1u);
+}
+
+// ============================================================================
+// Actions
+// ============================================================================
+
+TEST_F(CANGatewayTest, RewritesIdAndMaskedPayloadBits)
+{
+    CANGateway::Rule rewrite = rule(CANIdFilter::exact(0x3E9));
+    rewrite.rewriteId = true;
+    rewrite.newId = 0x3EA;
+    rewrite.dataMask  = QByteArray::fromHex("00F0FF");
+    rewrite.dataValue = QByteArray::fromHex("FFA055");
+    ASSERT_TRUE(startGateway({rewrite}).success);
+
+    ASSERT_TRUE(can().transmit("GW A", frame(0x3E9)).success);
+
+    CANMessage rx;
+    ASSERT_TRUE(can().receive("GW D", rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x3EAu);
+    EXPECT_FALSE(rx.isExtended);
+    EXPECT_EQ(rx.data[0], 0x10);            // Not in the mask
+    EXPECT_EQ(rx.data[1], 0xA1);            // High nibble replaced
+    EXPECT_EQ(rx.data[2], 0x55);
+    EXPECT_EQ(rx.data[3], 0x13);            // Beyond the mask
+}
+
+TEST_F(CANGatewayTest, DelayHoldsFramesInOrder)
+{
+    CANGateway::Rule delayed = rule(CANIdFilter::exact(0x1A0));
+    delayed.delayUs = 50000;
+    ASSERT_TRUE(startGateway({delayed}).success);
+
+    QElapsedTimer timer;
+    timer.start();
+    ASSERT_TRUE(can().transmit("GW A", frame(0x1A0)).success);
+    ASSERT_TRUE(can().transmit("GW A", frame(0x1B0)).success);
+
+    CANMessage rx;
+    ASSERT_TRUE(can().receive("GW D", rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x1B0u);
+    ASSERT_TRUE(can().receive("GW D", rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x1A0u);
+    EXPECT_GE(timer.elapsed(), 45);
+
+    CANBusManager::GatewayStats stats;
+    ASSERT_TRUE(can().gatewayStats("GW B", "GW C", stats));
+    EXPECT_EQ(stats.delayed, 1u);
+    EXPECT_EQ(stats.rules[0].forwarded, 1u);
+}
+
+TEST_F(CANGatewayTest, ClosedDestinationCountsTxErrors)
+{
+    ASSERT_TRUE(startGateway({}).success);
+    can().closeSlot("GW C");
+
+    ASSERT_TRUE(can().transmit("GW A", frame(0x100)).success);
+
+    QElapsedTimer timer;
+    timer.start();
+    CANBusManager::GatewayStats stats;
+    while (timer.elapsed() < 1000) {
+        ASSERT_TRUE(can().gatewayStats("GW B", "GW C", stats));
+        if (stats.txErrors > 0)
+            break;
+        QThread::msleep(5);
+    }
+    EXPECT_EQ(stats.txErrors, 1u);
+    EXPECT_EQ(stats.defaultRule.dropped, 1u);
+    EXPECT_FALSE(stats.lastError.isEmpty());
+
+    // Closing the source ends forwarding; the statistics stay until stopped
+    can().closeSlot("GW B");
+    timer.restart();
+    while (stats.running && timer.elapsed() < 1000) {
+        QThread::msleep(5);
+        ASSERT_TRUE(can().gatewayStats("GW B", "GW C", stats));
+    }
+    EXPECT_FALSE(stats.running);
+    EXPECT_TRUE(can().stopGateway("GW B", "GW C", &stats).success);
+    EXPECT_EQ(stats.received, 1u);
+}
+
+TEST_F(CANGatewayTest, InvalidRulesAreRejected)
+{
+    CANGateway::Rule mismatched = rule(CANIdFilter::exact(0x100));
+    mismatched.dataMask = QByteArray::fromHex("FF");
+    EXPECT_FALSE(startGateway({mismatched}).success);
+
+    CANGateway::Rule unresolved = rule(CANIdFilter::exact(0x100));
+    unresolved.signalValues.insert("VehicleSpeed", 0.0);
+    EXPECT_FALSE(startGateway({unresolved}).success);
+
+    CANBusManager::GatewayOptions options;
+    options.source = options.destination = "GW B";
+    EXPECT_FALSE(can().startGateway(options).success);
+
+    CANBusManager::GatewayStats stats;
+    EXPECT_FALSE(can().gatewayStats("GW B", "GW C", stats));
+}
+
+TEST_F(CANGatewayTest, ExtendedNewIdNeedsExtendedMatch)
+{
+    // Standard frames keep their format, so a 29-bit new ID is refused...
+    CANGateway::Rule standard = rule(CANIdFilter::exact(0x100));
+    standard.rewriteId = true;
+    standard.newId = 0x18DA00F1;
+    const CANResult refused = startGateway({standard});
+    EXPECT_FALSE(refused.success);
+    EXPECT_TRUE(refused.errorMessage.contains("does not fit")) << refused.errorMessage.toStdString();
+
+    // ...unless an earlier rule takes all standard frames that match it
+    CANGateway::Rule shadowed = standard;
+    EXPECT_TRUE(startGateway({rule(CANIdFilter::masked(0x100, 0x700)), shadowed}).success);
+    can().stopGateway("GW B", "GW C");
+
+    CANGateway::Rule extended = standard;
+    extended.match = CANIdFilter::exact(0x100, true);
+    ASSERT_TRUE(startGateway({extended}).success);
+
+    ASSERT_TRUE(can().transmit("GW A", frame(0x100, true)).success);
+    CANMessage rx;
+    ASSERT_TRUE(can().receive("GW D", rx, 200).success);
+    EXPECT_EQ(rx.id, 0x18DA00F1u);
+    EXPECT_TRUE(rx.isExtended);
+}
+
+// ============================================================================
+// Rule files
+// ============================================================================
+
+TEST(CANGatewayRules, ParsesJsonRuleSet)
+{
+    const QByteArray json = R"({
+        "source": "CAN 1",
+        "destination": "CAN 2",
+        "default": "block",
+        "rules": [
+            { "name": "kill NM", "id": "0x500", "mask": "0x700", "action": "block" },
+            { "id": "0x1A0", "delay_ms": 2.5 },
+            { "id": "18FF1234", "extended": true, "new_id": "0x18FF4321", "data": "00 80", "data_mask": "00 FF" },
+            { "id": 288, "signals": { "VehicleSpeed": 12.5 } }
+        ]
+    })";
+
+    CANGateway::Options options;
+    ASSERT_TRUE(CANGateway::parseRules(json, options).success);
+    EXPECT_EQ(options.source, "CAN 1");
+    EXPECT_EQ(options.destination, "CAN 2");
+    EXPECT_EQ(options.defaultAction, CANGateway::Action::Block);
+    ASSERT_EQ(options.rules.size(), 4);
+
+    EXPECT_EQ(options.rules[0].name, "kill NM");
+    EXPECT_EQ(options.rules[0].match.mask, 0x700u);
+    EXPECT_EQ(options.rules[0].action, CANGateway::Action::Block);
+
+    EXPECT_EQ(options.rules[1].delayUs, 2500);
+    EXPECT_EQ(options.rules[1].action, CANGateway::Action::Forward);
+
+    EXPECT_EQ(options.rules[2].match.id, 0x18FF1234u);
+    EXPECT_FALSE(options.rules[2].match.anyFormat);
+    EXPECT_TRUE(options.rules[2].match.extended);
+    EXPECT_TRUE(options.rules[2].rewriteId);
+    EXPECT_EQ(options.rules[2].newId, 0x18FF4321u);
+    EXPECT_EQ(options.rules[2].dataValue, QByteArray::fromHex("0080"));
+    EXPECT_EQ(options.rules[2].dataMask, QByteArray::fromHex("00FF"));
+
+    EXPECT_EQ(options.rules[3].match.id, 0x120u);
+    EXPECT_DOUBLE_EQ(options.rules[3].signalValues.value("VehicleSpeed"), 12.5);
+}
+
+TEST(CANGatewayRules, RejectsMalformedRules)
+{
+    CANGateway::Options options;
+    EXPECT_FALSE(CANGateway::parseRules("{ \"rules\": [", options).success);
+    EXPECT_FALSE(CANGateway::parseRules(R"([{ "action": "block" }])", options).success);
+    EXPECT_FALSE(CANGateway::parseRules(R"([{ "id": "0x100", "action": "mangle" }])", options).success);
+    EXPECT_FALSE(CANGateway::parseRules(R"([{ "id": "0xZZ" }])", options).success);
+    EXPECT_FALSE(CANGateway::parseRules(R"({ "default": "drop", "rules": [] })", options).success);
+
+    EXPECT_FALSE(CANGateway::loadRules("/nonexistent/rules.json", options).success);
+
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("rules.json");
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(R"([{ "id": "0x7DF", "action": "block" }])");
+    file.close();
+    ASSERT_TRUE(CANGateway::loadRules(path, options).success);
+    ASSERT_EQ(options.rules.size(), 1);
+    EXPECT_EQ(options.rules[0].match.id, 0x7DFu);
+}
@@ -0,0 +1,324 @@
+/**
+ * @file tst_CANIsoTp.cpp
+ * @brief Unit tests for CANIsoTpChannel — segmentation, flow control,
+ *        STmin pacing, CAN FD escape sequences, padding and timeouts.
+ *
+ * A tester and an ECU channel talk over two CANBusManager slots on one
+ * virtual bus. Protocol violations are injected as raw frames from the
+ * peer slot. Timing bounds are loose so the tests stay stable on loaded
+ * CI machines.
+ */
+
+#include <gtest/gtest.h>
+#include "CANIsoTpChannel.h"
+#include "CANManager.h"
+#include "CANSlotFixture.h"
+#include "VirtualCANDriver.h"
+
+#include <QElapsedTimer>
+
+#include <thread>
+#include <vector>
+
+using namespace CANManager;
+
+namespace {
+
+QByteArray pattern(int size, int seed = 0)
+{
+    QByteArray data(size, 0);
+    for (int i = 0; i < size; ++i)
+        data[i] = static_cast<char>((i * 7 + seed) & 0xFF);
+    return data;
+}
+
+CANMessage rawFrame(uint32_t id, std::initializer_list<uint8_t> bytes)
+{
+    CANMessage msg;
+    msg.id  = id;
+    msg.dlc = 8;
+    std::memset(msg.data, 0xCC, 8);
+    std::copy(bytes.begin(), bytes.end(), msg.data);
+    return msg;
+}
+
+} // namespace
+
+TEST(CANIsoTp, DecodesStMin)
+{
+    EXPECT_EQ(CANIsoTpChannel::stMinToMicros(0x00), 0);
+    EXPECT_EQ(CANIsoTpChannel::stMinToMicros(0x14), 20000);
+    EXPECT_EQ(CANIsoTpChannel::stMinToMicros(0x7F), 127000);
+    EXPECT_EQ(CANIsoTpChannel::stMinToMicros(0xF1), 100);
+    EXPECT_EQ(CANIsoTpChannel::stMinToMicros(0xF9), 900);
+    EXPECT_EQ(CANIsoTpChannel::stMinToMicros(0x80), 127000);   // Reserved
+    EXPECT_EQ(CANIsoTpChannel::stMinToMicros(0xFA), 127000);   // Reserved
+}
+
+// ============================================================================
+// Tester ↔ ECU over two slots
+// ============================================================================
+
+class CANIsoTpTest : public CANSlotFixture
+{
+protected:
+    static constexpr const char* TESTER = "IsoTp Tester";
+    static constexpr const char* ECU    = "IsoTp ECU";
+
+    void SetUp() override
+    {
+        CANBusConfig config;
+        config.fdEnabled = true;
+        ASSERT_NO_FATAL_FAILURE(openSlots("t_isotp", {TESTER, ECU}, config));
+    }
+
+    void TearDown() override
+    {
+        m_tester.reset();
+        m_ecu.reset();
+        CANSlotFixture::TearDown();
+    }
+
+    static CANIsoTpChannel::Config testerConfig()
+    {
+        CANIsoTpChannel::Config config;
+        config.slotName = TESTER;
+        config.txId = 0x7E0;
+        config.rxId = 0x7E8;
+        config.nBsMs = config.nCrMs = 200;
+        return config;
+    }
+
+    static CANIsoTpChannel::Config ecuConfig()
+    {
+        CANIsoTpChannel::Config config = testerConfig();
+        config.slotName = ECU;
+        std::swap(config.txId, config.rxId);
+        return config;
+    }
+
+    void open(const CANIsoTpChannel::Config& tester, const CANIsoTpChannel::Config& ecu)
+    {
+        m_tester = std::make_unique<CANIsoTpChannel>(tester);
+        m_ecu    = std::make_unique<CANIsoTpChannel>(ecu);
+        ASSERT_TRUE(m_tester->open().success);
+        ASSERT_TRUE(m_ecu->open().success);
+    }
+
+    void expectTransfer(CANIsoTpChannel& from, CANIsoTpChannel& to, const QByteArray& payload)
+    {
+        const CANResult sent = from.send(payload);
+        ASSERT_TRUE(sent.success) << sent.errorMessage.toStdString();
+        QByteArray received;
+        const CANResult result = to.receive(received, 1000);
+        ASSERT_TRUE(result.success) << result.errorMessage.toStdString();
+        EXPECT_EQ(received, payload);
+    }
+
+    std::unique_ptr<CANIsoTpChannel> m_tester;
+    std::unique_ptr<CANIsoTpChannel> m_ecu;
+};
+
+TEST_F(CANIsoTpTest, SingleAndSegmentedRoundTrip)
+{
+    open(testerConfig(), ecuConfig());
+
+    expectTransfer(*m_tester, *m_ecu, QByteArray::fromHex("22F190"));
+    expectTransfer(*m_tester, *m_ecu, pattern(7));
+    expectTransfer(*m_tester, *m_ecu, pattern(8));
+    expectTransfer(*m_ecu, *m_tester, pattern(4095, 1));
+    expectTransfer(*m_ecu, *m_tester, pattern(5000, 2));     // FF_DL escape sequence
+
+    QByteArray response;
+    const CANResult result = m_tester->request(pattern(3), response, 50);
+    EXPECT_FALSE(result.success);                            // ECU never answers
+    EXPECT_TRUE(result.errorMessage.contains("timeout"));
+
+    EXPECT_EQ(m_tester->stats().messagesSent, 4u);
+    EXPECT_EQ(m_ecu->stats().messagesReceived, 4u);
+    EXPECT_EQ(m_tester->stats().messagesReceived, 2u);
+}
+
+TEST_F(CANIsoTpTest, BlockSizeAndStMinPaceTheSender)
+{
+    CANIsoTpChannel::Config ecu = ecuConfig();
+    ecu.blockSize = 4;
+    ecu.stMin     = 0xF5;                                    // 500 µs
+    open(testerConfig(), ecu);
+
+    // 300 bytes = FF + 42 CFs in blocks of 4: 10 extra flow control frames
+    // and 31 STmin gaps (none between a flow control and the next CF)
+    QElapsedTimer timer;
+    timer.start();
+    expectTransfer(*m_tester, *m_ecu, pattern(300));
+    EXPECT_GE(timer.nsecsElapsed(), 31 * 500000LL);
+
+    EXPECT_EQ(m_ecu->stats().framesSent, 11u);               // Flow control frames
+    EXPECT_EQ(m_tester->stats().framesSent, 43u);
+}
+
+TEST_F(CANIsoTpTest, CanFdFramesAndEscapeSequences)
+{
+    CANIsoTpChannel::Config tester = testerConfig();
+    tester.fd = true;
+    tester.frameSize = 64;
+    CANIsoTpChannel::Config ecu = ecuConfig();
+    ecu.fd = true;
+    ecu.frameSize = 64;
+    open(tester, ecu);
+
+    auto sniffer = CANBusManager::instance().subscribe(ECU, CANIdFilter::exact(0x7E0));
+    ASSERT_TRUE(sniffer);
+
+    expectTransfer(*m_tester, *m_ecu, pattern(62));         // SF_DL escape
+    expectTransfer(*m_tester, *m_ecu, pattern(20));
+    expectTransfer(*m_tester, *m_ecu, pattern(6000));        // FF_DL escape, 64-byte CFs
+    expectTransfer(*m_ecu, *m_tester, pattern(100, 3));
+
+    ASSERT_TRUE(sniffer->waitForFrames(500));
+    CANMessage frame;
+    ASSERT_TRUE(sniffer->take(frame));
+    EXPECT_TRUE(frame.isFD);
+    EXPECT_EQ(frame.dataLength(), 64);
+    EXPECT_EQ(frame.data[0], 0x00);
+    EXPECT_EQ(frame.data[1], 62);
+
+    // Over 8 bytes an FD single frame uses the escape form; 2 + 20 bytes
+    // are padded up to the 24-byte DLC
+    ASSERT_TRUE(sniffer->take(frame));
+    EXPECT_EQ(frame.dataLength(), 24);
+    EXPECT_EQ(frame.data[0], 0x00);
+    EXPECT_EQ(frame.data[1], 20);
+    EXPECT_EQ(frame.data[22], 0xCC);
+
+    // Two SFs, FF with 58 bytes + 95 CFs, one FC for the ECU's message
+    EXPECT_EQ(m_tester->stats().framesSent, 2u + 96u + 1u);
+    CANBusManager::instance().unsubscribe(ECU, sniffer);
+
+    CANIsoTpChannel::Config invalid = testerConfig();
+    invalid.frameSize = 20;                                  // Needs CAN FD
+    EXPECT_FALSE(CANIsoTpChannel(invalid).open().success);
+    invalid.fd = true;
+    invalid.frameSize = 10;                                  // No such FD length
+    EXPECT_FALSE(CANIsoTpChannel(invalid).open().success);
+}
+
+TEST_F(CANIsoTpTest, PaddingIsOptional)
+{
+    CANIsoTpChannel::Config tester = testerConfig();
+    tester.padding = false;
+    open(tester, ecuConfig());
+
+    auto sniffer = CANBusManager::instance().subscribe(ECU, CANIdFilter::exact(0x7E0));
+    expectTransfer(*m_tester, *m_ecu, QByteArray::fromHex("3E00"));
+
+    ASSERT_TRUE(sniffer->waitForFrames(500));
+    CANMessage frame;
+    ASSERT_TRUE(sniffer->take(frame));
+    EXPECT_EQ(frame.dlc, 3);
+    EXPECT_EQ(frame.data[0], 0x02);
+    CANBusManager::instance().unsubscribe(ECU, sniffer);
+}
+
+TEST_F(CANIsoTpTest, OverflowAndMissingFlowControlFailTheSender)
+{
+    CANIsoTpChannel::Config ecu = ecuConfig();
+    ecu.maxReceiveSize = 100;
+    open(testerConfig(), ecu);
+
+    CANResult result = m_tester->send(pattern(200));
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.errorMessage.contains("OVFLW"));
+    EXPECT_EQ(m_ecu->stats().rxErrors, 1u);
+    expectTransfer(*m_tester, *m_ecu, pattern(100));         // At the limit
+
+    // No receiver for this ID: nobody answers the first frame
+    CANIsoTpChannel::Config lonely = testerConfig();
+    lonely.txId  = 0x700;
+    lonely.nBsMs = 50;
+    CANIsoTpChannel channel(lonely);
+    ASSERT_TRUE(channel.open().success);
+
+    QElapsedTimer timer;
+    timer.start();
+    result = channel.send(pattern(20));
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.errorMessage.contains("N_Bs"));
+    EXPECT_GE(timer.elapsed(), 45);
+    EXPECT_EQ(channel.stats().txErrors, 1u);
+
+    EXPECT_TRUE(channel.send(pattern(7)).success);           // Single frames need no FC
+}
+
+TEST_F(CANIsoTpTest, ReceptionErrorsAreReported)
+{
+    CANIsoTpChannel::Config tester = testerConfig();
+    tester.nCrMs = 50;
+    open(tester, ecuConfig());
+    m_ecu->close();                                          // The ECU side is played by hand
+    auto& mgr = CANBusManager::instance();
+
+    // First frame of 20 bytes, then silence
+    ASSERT_TRUE(mgr.transmit(ECU, rawFrame(0x7E8, {0x10, 20, 1, 2, 3, 4, 5, 6})).success);
+    QByteArray payload;
+    CANResult result = m_tester->receive(payload, 1000);
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.errorMessage.contains("N_Cr"));
+
+    // Consecutive frame with the wrong sequence number
+    ASSERT_TRUE(mgr.transmit(ECU, rawFrame(0x7E8, {0x10, 20, 1, 2, 3, 4, 5, 6})).success);
+    ASSERT_TRUE(mgr.transmit(ECU, rawFrame(0x7E8, {0x22, 7, 8, 9, 10, 11, 12, 13})).success);
+    result = m_tester->receive(payload, 1000);
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.errorMessage.contains("sequence"));
+
+    // Hand-made segmented message completes
+    ASSERT_TRUE(mgr.transmit(ECU, rawFrame(0x7E8, {0x10, 10, 1, 2, 3, 4, 5, 6})).success);
+    ASSERT_TRUE(mgr.transmit(ECU, rawFrame(0x7E8, {0x21, 7, 8, 9, 10})).success);
+    ASSERT_TRUE(m_tester->receive(payload, 1000).success);
+    EXPECT_EQ(payload, QByteArray::fromHex("0102030405060708090A"));
+    EXPECT_EQ(m_tester->stats().rxErrors, 2u);
+    EXPECT_EQ(m_tester->stats().framesSent, 3u);             // One FC per first frame
+}
+
+TEST_F(CANIsoTpTest, ChannelsRunConcurrently)
+{
+    constexpr int PAIRS = 4;
+    constexpr int MESSAGES = 10;
+    std::vector<std::unique_ptr<CANIsoTpChannel>> testers, ecus;
+    for (int i = 0; i < PAIRS; ++i) {
+        CANIsoTpChannel::Config tester = testerConfig();
+        tester.txId = 0x600 + i;
+        tester.rxId = 0x680 + i;
+        CANIsoTpChannel::Config ecu = ecuConfig();
+        ecu.txId = tester.rxId;
+        ecu.rxId = tester.txId;
+        ecu.blockSize = 8;
+        testers.push_back(std::make_unique<CANIsoTpChannel>(tester));
+        ecus.push_back(std::make_unique<CANIsoTpChannel>(ecu));
+        ASSERT_TRUE(testers.back()->open().success);
+        ASSERT_TRUE(ecus.back()->open().success);
+    }
+
+    std::vector<std::thread> senders;
+    std::atomic<int> failures{0};
+    for (int i = 0; i < PAIRS; ++i) {
+        senders.emplace_back([&, i]() {
+            for (int m = 0; m < MESSAGES; ++m) {
+                if (!testers[i]->send(pattern(500, i * 100 + m)).success)
+                    ++failures;
+            }
+        });
+    }
+
+    for (int i = 0; i < PAIRS; ++i) {
+        for (int m = 0; m < MESSAGES; ++m) {
+            QByteArray payload;
+            ASSERT_TRUE(ecus[i]->receive(payload, 2000).success) << "pair " << i << " message " << m;
+            EXPECT_EQ(payload, pattern(500, i * 100 + m));
+        }
+    }
+    for (std::thread& sender : senders)
+        sender.join();
+    EXPECT_EQ(failures.load(), 0);
+}
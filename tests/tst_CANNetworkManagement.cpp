@@ -0,0 +1,317 @@
+/**
+ * @file tst_CANNetworkManagement.cpp
+ * @brief Unit tests for CANNetworkManagement — CanNm state timing, control
+ *        bit vector handling, remote node tracking, bus-sleep detection and
+ *        the CANBusManager NM API.
+ *
+ * The NM engine runs on slot "NM 1"; "NM 2" on the same virtual bus plays
+ * the DUT: it records the local NM PDUs and sends remote ones.
+ */
+
+#include <gtest/gtest.h>
+#include "CANNetworkManagement.h"
+#include "CANManager.h"
+#include "CANSlotFixture.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <atomic>
+#include <thread>
+
+using namespace CANManager;
+using State = CANNetworkManagement::State;
+
+// ============================================================================
+// Fixture
+// ============================================================================
+
+class CANNetworkManagementTest : public CANSlotFixture
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(openSlots("t_nm", {"NM 1", "NM 2"}));
+    }
+
+    /// Short CanNm times so the whole sleep sequence takes 250 ms
+    static CANBusManager::NmConfig config()
+    {
+        CANBusManager::NmConfig config;
+        config.slotName        = "NM 1";
+        config.nodes           = {0x10};
+        config.msgCycleMs      = 10;
+        config.repeatMessageMs = 100;
+        config.timeoutMs       = 150;
+        config.waitBusSleepMs  = 100;
+        return config;
+    }
+
+    static CANMessage remotePdu(uint8_t node, uint8_t cbv = 0)
+    {
+        CANMessage msg;
+        msg.id  = 0x500 + node;
+        msg.dlc = 8;
+        std::fill_n(msg.data, 8, 0xFF);
+        msg.data[0] = node;
+        msg.data[1] = cbv;
+        return msg;
+    }
+
+    static State nodeState()
+    {
+        CANBusManager::NmStatus status;
+        return can().nmStatus("NM 1", status) && !status.nodes.isEmpty() ? status.nodes.first().state
+                                                                          : State::BusSleep;
+    }
+
+    static bool waitForState(State state, int timeoutMs)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while (nodeState() != state) {
+            if (timer.elapsed() > timeoutMs)
+                return false;
+            QThread::msleep(2);
+        }
+        return true;
+    }
+
+    /// Local NM PDUs received on NM 2 within the given time
+    static QList<CANMessage> receiveFor(int ms)
+    {
+        QList<CANMessage> frames;
+        QThread::msleep(ms);
+        CANMessage msg;
+        while (can().receive("NM 2", msg, 0).success) {
+            if (msg.id == 0x510)
+                frames.append(msg);
+        }
+        return frames;
+    }
+};
+
+// ============================================================================
+// Local node timing
+// ============================================================================
+
+TEST_F(CANNetworkManagementTest, RepeatMessageThenNormalOperation)
+{
+    ASSERT_TRUE(can().startNm(config()).success);
+    EXPECT_EQ(nodeState(), State::RepeatMessage);
+
+    // 10 ms cycle: a loaded machine may send late, so only a lower bound
+    const auto frames = receiveFor(60);
+    EXPECT_GE(frames.size(), 2);
+    ASSERT_FALSE(frames.isEmpty());
+    EXPECT_EQ(frames.first().dlc, 8);
+    EXPECT_EQ(frames.first().data[0], 0x10);     // Node ID
+    EXPECT_EQ(frames.first().data[1], CANNetworkManagement::CBV_ACTIVE_WAKEUP);
+    EXPECT_EQ(frames.first().data[7], 0xFF);
+
+    ASSERT_TRUE(waitForState(State::NormalOperation, 1000));
+    receiveFor(0);
+    const auto normal = receiveFor(50);
+    EXPECT_GE(normal.size(), 2);
+    ASSERT_FALSE(normal.isEmpty());
+    EXPECT_EQ(normal.last().data[1], CANNetworkManagement::CBV_ACTIVE_WAKEUP);  // Until Network Mode ends
+}
+
+TEST_F(CANNetworkManagementTest, ReleaseSleepsAfterTimeoutAndWaitBusSleep)
+{
+    ASSERT_TRUE(can().startNm(config()).success);
+    ASSERT_TRUE(waitForState(State::NormalOperation, 1000));
+
+    ASSERT_TRUE(can().releaseNm("NM 1").success);
+    EXPECT_EQ(nodeState(), State::ReadySleep);
+    receiveFor(20);                             // PDUs queued before the release
+    EXPECT_TRUE(receiveFor(50).isEmpty());
+
+    ASSERT_TRUE(can().waitNmBusSleep("NM 1", 2000).success);
+
+    CANBusManager::NmStatus status;
+    ASSERT_TRUE(can().nmStatus("NM 1", status));
+    EXPECT_TRUE(status.busSleep);
+    EXPECT_EQ(status.nodes.first().state, State::BusSleep);
+    EXPECT_FALSE(status.nodes.first().requested);
+    // 150 + 100 ms, the timeout running from the last PDU up to one cycle
+    // before the release; late timers only make it longer
+    EXPECT_GE(status.sleepAfterReleaseMs, 240);
+}
+
+TEST_F(CANNetworkManagementTest, ReleaseDuringRepeatMessageWaitsForRepeatTime)
+{
+    ASSERT_TRUE(can().startNm(config()).success);
+    ASSERT_TRUE(can().releaseNm("NM 1").success);
+    EXPECT_EQ(nodeState(), State::RepeatMessage);
+
+    EXPECT_GE(receiveFor(60).size(), 2);        // Still sending
+    ASSERT_TRUE(waitForState(State::ReadySleep, 1000));
+    receiveFor(20);
+    EXPECT_TRUE(receiveFor(50).isEmpty());
+    ASSERT_TRUE(waitForState(State::PrepareBusSleep, 1000));
+    ASSERT_TRUE(waitForState(State::BusSleep, 1000));
+}
+
+// ============================================================================
+// Remote nodes
+// ============================================================================
+
+TEST_F(CANNetworkManagementTest, RemoteNodeKeepsNetworkAwake)
+{
+    ASSERT_TRUE(can().startCyclic("NM 2", remotePdu(0x20), 10).success);
+    ASSERT_TRUE(can().startNm(config()).success);
+    ASSERT_TRUE(can().releaseNm("NM 1").success);
+
+    const auto result = can().waitNmBusSleep("NM 1", 400);
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.errorMessage.contains("remote 0x20")) << result.errorMessage.toStdString();
+
+    CANBusManager::NmStatus status;
+    ASSERT_TRUE(can().nmStatus("NM 1", status));
+    EXPECT_EQ(status.nodes.first().state, State::ReadySleep);
+    ASSERT_EQ(status.remotes.size(), 1);
+    EXPECT_EQ(status.remotes.first().nodeId, 0x20);
+    EXPECT_EQ(status.remotes.first().canId, 0x520u);
+    EXPECT_TRUE(status.remotes.first().awake);
+    EXPECT_GE(status.remotes.first().pdus, 30u);
+
+    // The DUT goes quiet: timeout + wait bus sleep after its last PDU, which
+    // went out at most one cycle before the stop
+    ASSERT_TRUE(can().stopCyclic("NM 2", 0x520, false).success);
+    QElapsedTimer timer;
+    timer.start();
+    ASSERT_TRUE(can().waitNmBusSleep("NM 1", 2000).success);
+    EXPECT_GE(timer.elapsed(), 200);
+
+    ASSERT_TRUE(can().nmStatus("NM 1", status));
+    EXPECT_FALSE(status.remotes.first().awake);
+    EXPECT_GE(status.sleepAfterReleaseMs, 600);     // 400 ms awake, then about 250 ms
+}
+
+TEST_F(CANNetworkManagementTest, RepeatMessageRequestAndPrepareBusSleepRestart)
+{
+    ASSERT_TRUE(can().startNm(config()).success);
+    ASSERT_TRUE(waitForState(State::NormalOperation, 1000));
+
+    ASSERT_TRUE(can().transmit("NM 2", remotePdu(0x20, CANNetworkManagement::CBV_REPEAT_MESSAGE_REQUEST)).success);
+    ASSERT_TRUE(waitForState(State::RepeatMessage, 50));
+
+    ASSERT_TRUE(can().releaseNm("NM 1").success);
+    ASSERT_TRUE(waitForState(State::PrepareBusSleep, 1000));
+
+    // An NM PDU in Prepare Bus-Sleep restarts the network without Active Wakeup
+    receiveFor(0);
+    ASSERT_TRUE(can().transmit("NM 2", remotePdu(0x20)).success);
+    ASSERT_TRUE(waitForState(State::RepeatMessage, 50));
+    const auto frames = receiveFor(50);
+    ASSERT_FALSE(frames.isEmpty());
+    EXPECT_EQ(frames.first().data[1], 0);
+}
+
+TEST_F(CANNetworkManagementTest, BusSleepNodeOnlyRecordsRemotePdus)
+{
+    ASSERT_TRUE(can().startNm(config()).success);
+    ASSERT_TRUE(can().releaseNm("NM 1").success);
+    ASSERT_TRUE(can().waitNmBusSleep("NM 1", 1000).success);
+
+    receiveFor(0);
+    ASSERT_TRUE(can().transmit("NM 2", remotePdu(0x21)).success);
+    QThread::msleep(20);
+
+    CANBusManager::NmStatus status;
+    ASSERT_TRUE(can().nmStatus("NM 1", status));
+    EXPECT_EQ(status.nodes.first().state, State::BusSleep);
+    EXPECT_FALSE(status.busSleep);              // Remote 0x21 is awake
+    EXPECT_EQ(status.pdusReceived, 1u);
+    EXPECT_TRUE(receiveFor(40).isEmpty());
+    EXPECT_TRUE(can().waitNmBusSleep("NM 1", 300).success);
+}
+
+// ============================================================================
+// CANBusManager
+// ============================================================================
+
+TEST_F(CANNetworkManagementTest, ManagerValidatesWakesAndStops)
+{
+    auto bad = config();
+    bad.slotName = "NM 9";
+    EXPECT_FALSE(can().startNm(bad).success);
+    bad = config();
+    bad.nodes.clear();
+    EXPECT_FALSE(can().startNm(bad).success);
+    bad = config();
+    bad.timeoutMs = bad.msgCycleMs;
+    EXPECT_FALSE(can().startNm(bad).success);
+    bad = config();
+    bad.nodes = {0x10, 0x10};
+    EXPECT_FALSE(can().startNm(bad).success);
+    EXPECT_FALSE(can().releaseNm("NM 1").success);
+
+    ASSERT_TRUE(can().startNm(config()).success);
+    EXPECT_FALSE(can().releaseNm("NM 1", {0x33}).success);
+    ASSERT_TRUE(can().transmit("NM 2", remotePdu(0x20)).success);
+    QThread::msleep(10);
+
+    // Same configuration: the running engine is woken, its history kept
+    ASSERT_TRUE(can().releaseNm("NM 1").success);
+    ASSERT_TRUE(can().startNm(config()).success);
+    CANBusManager::NmStatus status;
+    ASSERT_TRUE(can().nmStatus("NM 1", status));
+    EXPECT_TRUE(status.nodes.first().requested);
+    EXPECT_EQ(status.pdusReceived, 1u);
+    EXPECT_EQ(status.sinceReleaseMs, -1);
+
+    // A different configuration replaces it
+    auto two = config();
+    two.nodes = {0x10, 0x11};
+    ASSERT_TRUE(can().startNm(two).success);
+    ASSERT_TRUE(can().nmStatus("NM 1", status));
+    EXPECT_EQ(status.nodes.size(), 2);
+    EXPECT_EQ(status.pdusReceived, 0u);
+
+    ASSERT_TRUE(can().stopNm("NM 1").success);
+    EXPECT_FALSE(can().nmStatus("NM 1", status));
+    receiveFor(20);
+    EXPECT_TRUE(receiveFor(50).isEmpty());
+    EXPECT_FALSE(can().stopNm("NM 1").success);
+
+    // An engine running when the slot closes is stopped with it
+    ASSERT_TRUE(can().startNm(config()).success);
+}
+
+TEST_F(CANNetworkManagementTest, EnginesStartedWhileSlotClosesStopWithIt)
+{
+    const CANChannelInfo ch = channel(testBusName("t_nm"));
+
+    std::atomic<bool> stop{false};
+    std::atomic<int>  calls{0};
+    std::thread starter([&]() {
+        while (!stop.load()) {
+            can().startNm(config());
+            calls.fetch_add(1);
+        }
+    });
+
+    for (int i = 0; i < 30; ++i) {
+        // Let the starter run between every close and reopen
+        const int before = calls.load();
+        can().closeSlot("NM 1");
+        while (calls.load() == before)
+            std::this_thread::yield();
+        EXPECT_TRUE(can().openSlot("NM 1", can().virtualDriver("NM 1"), ch, CANBusConfig{}).success);
+        const int reopened = calls.load();
+        while (calls.load() == reopened)
+            std::this_thread::yield();
+    }
+    stop = true;
+    starter.join();
+
+    // No engine outlives the slot it was started on: once the published one
+    // is stopped, nothing sends NM PDUs on the reopened slot
+    can().stopNm("NM 1");
+    receiveFor(20);
+    EXPECT_TRUE(receiveFor(200).isEmpty());
+    CANBusManager::NmStatus status;
+    EXPECT_FALSE(can().nmStatus("NM 1", status));
+}
@@ -0,0 +1,202 @@
+/**
+ * @file tst_CANRxDispatcher.cpp
+ * @brief Unit tests for CANRxDispatcher — subscription routing (exact,
+ *        extended, mask, all), batch delivery, overruns and shutdown.
+ *
+ * The dispatcher reads a VirtualCANDriver node; a second node on the same
+ * bus injects traffic. Buses run in Simulated timing so tests are fast.
+ */
+
+#include <gtest/gtest.h>
+#include "CANRxDispatcher.h"
+#include "VirtualCANDriver.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+
+using namespace CANManager;
+
+// ============================================================================
+// Fixture
+// ============================================================================
+
+class CANRxDispatcherTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        const QString busName = QString::fromLatin1("t_dispatch_%1")
+            .arg(QString::fromLatin1(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        CANChannelInfo ch;
+        ch.name = busName;
+        VirtualCANBus::bus(busName)->setTiming(VirtualCANBus::Timing::Simulated);
+
+        ASSERT_TRUE(m_sender.openChannel(ch, m_cfg).success);
+        ASSERT_TRUE(m_listener.openChannel(ch, m_cfg).success);
+        m_dispatcher = std::make_unique<CANRxDispatcher>(&m_listener, busName);
+        m_dispatcher->start();
+    }
+
+    void TearDown() override
+    {
+        m_dispatcher->requestStop();
+        m_listener.closeChannel();
+        m_dispatcher->join();
+        m_sender.closeChannel();
+    }
+
+    void send(uint32_t id, bool extended = false)
+    {
+        CANMessage msg;
+        msg.id = id;
+        msg.dlc = 8;
+        msg.isExtended = extended;
+        ASSERT_TRUE(m_sender.transmit(msg).success);
+    }
+
+    /// Wait until the slot queue holds @p count frames, i.e. all were dispatched
+    void drainSlotQueue(int count)
+    {
+        CANMessage msg;
+        for (int i = 0; i < count; ++i)
+            ASSERT_TRUE(m_dispatcher->receive(msg, 1000).success);
+    }
+
+    static std::vector<uint32_t> takeIds(CANRxDispatcher::Subscription& sub)
+    {
+        std::vector<uint32_t> ids;
+        CANMessage batch[16];
+        int n;
+        while ((n = sub.take(batch, 16)) > 0) {
+            for (int i = 0; i < n; ++i)
+                ids.push_back(batch[i].id);
+        }
+        return ids;
+    }
+
+    CANBusConfig     m_cfg;
+    VirtualCANDriver m_sender;
+    VirtualCANDriver m_listener;
+    std::unique_ptr<CANRxDispatcher> m_dispatcher;
+};
+
+// ============================================================================
+// Routing
+// ============================================================================
+
+TEST_F(CANRxDispatcherTest, RoutesByExactMaskAndAll)
+{
+    auto exactStd = m_dispatcher->subscribe(CANIdFilter::exact(0x123, false));
+    auto exactExt = m_dispatcher->subscribe(CANIdFilter::exact(0x123, true));
+    auto masked   = m_dispatcher->subscribe(CANIdFilter::masked(0x700, 0x700));
+    auto all      = m_dispatcher->subscribe(CANIdFilter::all());
+
+    send(0x123);
+    send(0x123, true);
+    send(0x7E8);
+    send(0x456);
+    drainSlotQueue(4);
+
+    EXPECT_EQ(takeIds(*exactStd), (std::vector<uint32_t>{0x123}));
+    EXPECT_EQ(takeIds(*exactExt), (std::vector<uint32_t>{0x123}));
+    EXPECT_EQ(takeIds(*masked),   (std::vector<uint32_t>{0x7E8}));
+    EXPECT_EQ(takeIds(*all),      (std::vector<uint32_t>{0x123, 0x123, 0x7E8, 0x456}));
+}
+
+TEST_F(CANRxDispatcherTest, AnyFormatExactIdMatchesBothFormats)
+{
+    auto sub = m_dispatcher->subscribe(CANIdFilter::exact(0x100));
+
+    send(0x100);
+    send(0x100, true);
+    send(0x18DAF110, true);
+    drainSlotQueue(3);
+
+    EXPECT_EQ(takeIds(*sub).size(), 2u);
+}
+
+TEST_F(CANRxDispatcherTest, SubscribersDoNotConsumeEachOthersFrames)
+{
+    auto a = m_dispatcher->subscribe(CANIdFilter::exact(0x200));
+    auto b = m_dispatcher->subscribe(CANIdFilter::exact(0x200));
+
+    for (int i = 0; i < 10; ++i)
+        send(0x200);
+    drainSlotQueue(10);
+
+    EXPECT_EQ(takeIds(*a).size(), 10u);
+    EXPECT_EQ(takeIds(*b).size(), 10u);
+}
+
+TEST_F(CANRxDispatcherTest, UnsubscribeStopsDeliveryAndCloses)
+{
+    auto sub = m_dispatcher->subscribe(CANIdFilter::all());
+    m_dispatcher->unsubscribe(sub);
+    EXPECT_TRUE(sub->isClosed());
+
+    send(0x300);
+    drainSlotQueue(1);
+    EXPECT_EQ(sub->pending(), 0u);
+}
+
+// ============================================================================
+// Delivery
+// ============================================================================
+
+TEST_F(CANRxDispatcherTest, WaitForFramesWakesConsumer)
+{
+    auto sub = m_dispatcher->subscribe(CANIdFilter::exact(0x400));
+
+    QThread* producer = QThread::create([this]() {
+        QThread::msleep(50);
+        send(0x400);
+    });
+    producer->start();
+
+    QElapsedTimer timer;
+    timer.start();
+    EXPECT_TRUE(sub->waitForFrames(2000));
+    EXPECT_LT(timer.elapsed(), 1000);
+
+    CANMessage msg;
+    EXPECT_TRUE(sub->take(msg));
+    EXPECT_EQ(msg.id, 0x400u);
+
+    producer->wait();
+    delete producer;
+}
+
+TEST_F(CANRxDispatcherTest, FullQueueCountsOverruns)
+{
+    auto sub = m_dispatcher->subscribe(CANIdFilter::all(), 4);
+
+    for (int i = 0; i < 10; ++i)
+        send(0x500 + i);
+    drainSlotQueue(10);
+
+    EXPECT_EQ(takeIds(*sub), (std::vector<uint32_t>{0x500, 0x501, 0x502, 0x503}));
+    EXPECT_EQ(sub->overruns(), 6u);
+}
+
+TEST_F(CANRxDispatcherTest, StopReleasesBlockedConsumers)
+{
+    auto sub = m_dispatcher->subscribe(CANIdFilter::exact(0x600));
+
+    bool subscriptionWoke = false;
+    CANResult receiveResult;
+    QThread* consumer = QThread::create([&]() {
+        subscriptionWoke = !sub->waitForFrames(-1);
+        CANMessage msg;
+        receiveResult = m_dispatcher->receive(msg, -1);
+    });
+    consumer->start();
+    QThread::msleep(50);
+
+    m_dispatcher->requestStop();
+    consumer->wait();
+    delete consumer;
+
+    EXPECT_TRUE(subscriptionWoke);
+    EXPECT_TRUE(sub->isClosed());
+    EXPECT_FALSE(receiveResult.success);
+}
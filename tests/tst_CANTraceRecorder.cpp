@@ -0,0 +1,384 @@
+/**
+ * @file tst_CANTraceRecorder.cpp
+ * @brief Unit tests for the ASC / BLF trace writers and CANTraceRecorder —
+ *        file formats, multi-slot capture, rotation and dropped-frame accounting.
+ *
+ * Files are written to a QTemporaryDir and parsed back directly; the BLF
+ * test walks the container/object structure with a minimal reader.
+ */
+
+#include <gtest/gtest.h>
+#include "CANManager.h"
+#include "CANTraceRecorder.h"
+#include "CANTraceWriter.h"
+#include "VirtualCANDriver.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QtEndian>
+
+#include <cstring>
+#include <thread>
+
+using namespace CANManager;
+
+namespace {
+
+CANTraceFrame traceFrame(uint32_t id, uint64_t timestampNs, uint16_t channel = 1)
+{
+    CANTraceFrame frame;
+    frame.msg.id        = id;
+    frame.msg.dlc       = 8;
+    frame.msg.timestamp = timestampNs;
+    for (int i = 0; i < 8; ++i)
+        frame.msg.data[i] = static_cast<uint8_t>(i + 1);
+    frame.channel = channel;
+    return frame;
+}
+
+QStringList readLines(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return QString::fromLatin1(file.readAll()).split('\n', Qt::SkipEmptyParts);
+}
+
+int countFrameLines(const QStringList& lines)
+{
+    int frames = 0;
+    for (const QString& line : lines) {
+        if (line.contains(" Rx ") || line.contains(" Tx ") || line.contains("ErrorFrame"))
+            ++frames;
+    }
+    return frames;
+}
+
+} // namespace
+
+// ============================================================================
+// ASC writer
+// ============================================================================
+
+TEST(CANTraceWriter, AscWritesClassicFdRemoteAndErrorFrames)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("format.asc");
+
+    std::vector<CANTraceFrame> frames;
+    frames.push_back(traceFrame(0x123, 1000000));                  // 0.001 s
+
+    CANTraceFrame ext = traceFrame(0x18DAF110, 2500000, 2);
+    ext.msg.isExtended  = true;
+    ext.msg.isTxConfirm = true;
+    frames.push_back(ext);
+
+    CANTraceFrame fd = traceFrame(0x7E0, 3000000);
+    fd.msg.isFD  = true;
+    fd.msg.isBRS = true;
+    fd.msg.dlc   = 9;                                              // 12 bytes
+    frames.push_back(fd);
+
+    CANTraceFrame rtr = traceFrame(0x55, 4000000);
+    rtr.msg.isRemote = true;
+    rtr.msg.dlc      = 2;
+    frames.push_back(rtr);
+
+    CANTraceFrame err = traceFrame(0, 5000000);
+    err.msg.isError = true;
+    frames.push_back(err);
+
+    auto writer = CANTraceWriter::create(CANTraceFormat::Asc);
+    ASSERT_TRUE(writer->open(path, QDateTime::currentDateTime()).success);
+    ASSERT_TRUE(writer->write(frames.data(), static_cast<int>(frames.size())).success);
+    ASSERT_TRUE(writer->close().success);
+
+    const QStringList lines = readLines(path);
+    ASSERT_GE(lines.size(), 11);
+    EXPECT_TRUE(lines[0].startsWith("date "));
+    EXPECT_EQ(lines[1], QString("base hex  timestamps absolute"));
+    EXPECT_TRUE(lines[4].startsWith("Begin Triggerblock"));
+    EXPECT_EQ(lines.last(), QString("End TriggerBlock"));
+
+    EXPECT_EQ(lines[6], QString("   0.001000 1  123             Rx   d 8 01 02 03 04 05 06 07 08"));
+    EXPECT_EQ(lines[7], QString("   0.002500 2  18DAF110x       Tx   d 8 01 02 03 04 05 06 07 08"));
+    EXPECT_TRUE(lines[8].startsWith("   0.003000 CANFD   1 Rx        7E0 "));
+    EXPECT_TRUE(lines[8].contains(" 1 0 9 12 01 02 03 04 05 06 07 08 00 00 00 00 "));
+    EXPECT_EQ(lines[9], QString("   0.004000 1  55              Rx   r 2"));
+    EXPECT_EQ(lines[10], QString("   0.005000 1  ErrorFrame"));
+}
+
+// ============================================================================
+// BLF writer
+// ============================================================================
+
+TEST(CANTraceWriter, BlfContainersHoldEveryObject)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("format.blf");
+
+    // Enough objects for several 128 KiB containers
+    constexpr int COUNT = 5000;
+    std::vector<CANTraceFrame> frames;
+    for (int i = 0; i < COUNT; ++i) {
+        CANTraceFrame frame = traceFrame(0x100 + (i % 16), static_cast<uint64_t>(i) * 100000);
+        if (i % 3 == 0) {
+            frame.msg.isFD = true;
+            frame.msg.dlc  = 15;
+            frame.msg.data[63] = static_cast<uint8_t>(i);
+        }
+        frames.push_back(frame);
+    }
+
+    auto writer = CANTraceWriter::create(CANTraceWriter::formatForPath(path));
+    ASSERT_TRUE(writer->open(path, QDateTime::currentDateTime()).success);
+    ASSERT_TRUE(writer->write(frames.data(), COUNT).success);
+    ASSERT_TRUE(writer->close().success);
+
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    const QByteArray blf = file.readAll();
+    const char* p = blf.constData();
+
+    ASSERT_EQ(std::memcmp(p, "LOGG", 4), 0);
+    EXPECT_EQ(qFromLittleEndian<uint32_t>(p + 4), 144u);
+    EXPECT_EQ(qFromLittleEndian<uint64_t>(p + 16), static_cast<uint64_t>(blf.size()));
+    EXPECT_EQ(qFromLittleEndian<uint32_t>(p + 32), static_cast<uint32_t>(COUNT));
+
+    // Unpack all containers into one object stream
+    QByteArray objects;
+    int containers = 0;
+    for (qsizetype pos = 144; pos + 32 <= blf.size();) {
+        ASSERT_EQ(std::memcmp(p + pos, "LOBJ", 4), 0);
+        const uint32_t objSize = qFromLittleEndian<uint32_t>(p + pos + 8);
+        ASSERT_EQ(qFromLittleEndian<uint32_t>(p + pos + 12), 10u);         // LOG_CONTAINER
+        ASSERT_EQ(qFromLittleEndian<uint16_t>(p + pos + 16), 2u);          // zlib
+        const uint32_t rawSize = qFromLittleEndian<uint32_t>(p + pos + 24);
+
+        QByteArray zipped(4, '\0');
+        qToBigEndian<uint32_t>(rawSize, zipped.data());
+        zipped.append(p + pos + 32, objSize - 32);
+        const QByteArray raw = qUncompress(zipped);
+        ASSERT_EQ(static_cast<uint32_t>(raw.size()), rawSize);
+        objects.append(raw);
+
+        ++containers;
+        pos += objSize + objSize % 4;
+    }
+    EXPECT_GT(containers, 1);
+
+    int index = 0;
+    const char* o = objects.constData();
+    for (qsizetype pos = 0; pos < objects.size(); ++index) {
+        ASSERT_EQ(std::memcmp(o + pos, "LOBJ", 4), 0);
+        const uint32_t objSize = qFromLittleEndian<uint32_t>(o + pos + 8);
+        const uint32_t type    = qFromLittleEndian<uint32_t>(o + pos + 12);
+        const uint64_t ts      = qFromLittleEndian<uint64_t>(o + pos + 24);
+        const char* data = o + pos + 32;
+
+        ASSERT_LT(index, COUNT);
+        const CANMessage& expected = frames[static_cast<size_t>(index)].msg;
+        EXPECT_EQ(ts, expected.timestamp);
+        EXPECT_EQ(qFromLittleEndian<uint16_t>(data), 1u);                  // Channel
+        EXPECT_EQ(qFromLittleEndian<uint32_t>(data + 4), expected.id);
+        if (expected.isFD) {
+            ASSERT_EQ(type, 100u);                                        // CAN_FD_MESSAGE
+            EXPECT_EQ(static_cast<uint8_t>(data[3]), 15u);
+            EXPECT_EQ(static_cast<uint8_t>(data[14]), 64u);                // Valid bytes
+            EXPECT_EQ(static_cast<uint8_t>(data[20 + 63]), expected.data[63]);
+        } else {
+            ASSERT_EQ(type, 1u);                                          // CAN_MESSAGE
+            EXPECT_EQ(std::memcmp(data + 8, expected.data, 8), 0);
+        }
+        pos += objSize;
+    }
+    EXPECT_EQ(index, COUNT);
+}
+
+// ============================================================================
+// Recorder
+// ============================================================================
+
+TEST(CANTraceRecorder, RotatesBySizeWithoutLosingFrames)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    CANTraceRecorder::Options options;
+    options.path         = dir.filePath("rotate.asc");
+    options.maxFileBytes = 16 * 1024;
+    auto recorder = std::make_shared<CANTraceRecorder>(options);
+    ASSERT_TRUE(recorder->start().success);
+
+    constexpr int COUNT = 3000;
+    for (int i = 0; i < COUNT; ++i) {
+        CANMessage msg = traceFrame(0x200, static_cast<uint64_t>(i) * 1000).msg;
+        recorder->record(1, &msg, 1);
+    }
+
+    CANTraceRecorder::Stats stats;
+    ASSERT_TRUE(recorder->stop(&stats).success);
+    EXPECT_EQ(stats.framesWritten, static_cast<uint64_t>(COUNT));
+    EXPECT_EQ(stats.framesDropped, 0u);
+    EXPECT_GT(stats.fileCount, 5);
+    EXPECT_EQ(stats.currentFile, CANTraceRecorder::rotatedPath(options.path, stats.fileCount));
+
+    int frames = 0;
+    qint64 bytes = 0;
+    for (int part = 1; part <= stats.fileCount; ++part) {
+        const QString path = CANTraceRecorder::rotatedPath(options.path, part);
+        const QStringList lines = readLines(path);
+        EXPECT_EQ(lines.last(), QString("End TriggerBlock")) << path.toStdString();
+        frames += countFrameLines(lines);
+        bytes  += QFileInfo(path).size();
+    }
+    EXPECT_EQ(frames, COUNT);
+    EXPECT_EQ(stats.bytesWritten, bytes);
+}
+
+TEST(CANTraceRecorder, FullBufferDropsAndCountsFrames)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    CANTraceRecorder::Options options;
+    options.path         = dir.filePath("drop.asc");
+    options.bufferBlocks = 2;
+    auto recorder = std::make_shared<CANTraceRecorder>(options);
+    ASSERT_TRUE(recorder->start().success);
+
+    // One call holds the buffer for its whole duration: the writer cannot
+    // free a block in between, so everything beyond two blocks is dropped
+    const int count = 3 * CANTraceRecorder::BLOCK_FRAMES;
+    std::vector<CANMessage> burst(static_cast<size_t>(count), traceFrame(0x300, 0).msg);
+    recorder->record(1, burst.data(), count);
+
+    CANTraceRecorder::Stats stats;
+    ASSERT_TRUE(recorder->stop(&stats).success);
+    EXPECT_EQ(stats.framesRecorded, 2u * CANTraceRecorder::BLOCK_FRAMES);
+    EXPECT_EQ(stats.framesDropped, static_cast<uint64_t>(CANTraceRecorder::BLOCK_FRAMES));
+    EXPECT_EQ(stats.framesWritten, stats.framesRecorded);
+    EXPECT_EQ(countFrameLines(readLines(options.path)), 2 * CANTraceRecorder::BLOCK_FRAMES);
+}
+
+TEST(CANTraceRecorder, KeepsUpWithTwoSaturatedFdChannels)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    // A loaded CAN FD bus carries < 10,000 frames/s; feed two channels at
+    // that rate in dispatcher-sized batches into a deliberately small buffer
+    CANTraceRecorder::Options options;
+    options.path         = dir.filePath("load.blf");
+    options.format       = CANTraceFormat::Blf;
+    options.bufferBlocks = 4;
+    auto recorder = std::make_shared<CANTraceRecorder>(options);
+    ASSERT_TRUE(recorder->start().success);
+
+    constexpr int BATCH = 64;
+    constexpr int BATCHES = 150;     // 9,600 frames per channel in ~1 s
+    auto feed = [&](uint16_t channel) {
+        CANMessage batch[BATCH];
+        for (int b = 0; b < BATCHES; ++b) {
+            for (int i = 0; i < BATCH; ++i) {
+                batch[i] = traceFrame(0x400 + channel, static_cast<uint64_t>(b * BATCH + i) * 100000).msg;
+                batch[i].isFD = true;
+                batch[i].dlc  = 15;
+            }
+            recorder->record(channel, batch, BATCH);
+            QThread::msleep(6);
+        }
+    };
+    std::thread first(feed, 1);
+    std::thread second(feed, 2);
+    first.join();
+    second.join();
+
+    CANTraceRecorder::Stats stats;
+    ASSERT_TRUE(recorder->stop(&stats).success);
+    EXPECT_EQ(stats.framesDropped, 0u);
+    EXPECT_EQ(stats.framesWritten, 2u * BATCH * BATCHES);
+    EXPECT_TRUE(stats.lastError.isEmpty());
+}
+
+TEST(CANTraceRecorder, StartFailsOnUnwritablePath)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    CANTraceRecorder::Options options;
+    options.path = dir.path();      // A directory, not a file
+    auto recorder = std::make_shared<CANTraceRecorder>(options);
+    EXPECT_FALSE(recorder->start().success);
+    EXPECT_FALSE(recorder->isRunning());
+}
+
+// ============================================================================
+// CANBusManager integration
+// ============================================================================
+
+TEST(CANTraceManager, RecordsSlotsAsChannelsIncludingTransmit)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    auto& mgr = CANBusManager::instance();
+
+    CANChannelInfo busA, busB;
+    busA.name = QStringLiteral("t_trace_a");
+    busB.name = QStringLiteral("t_trace_b");
+    VirtualCANBus::bus(busA.name)->setTiming(VirtualCANBus::Timing::Simulated);
+    VirtualCANBus::bus(busB.name)->setTiming(VirtualCANBus::Timing::Simulated);
+
+    ASSERT_TRUE(mgr.openSlot("TR 1", mgr.virtualDriver("TR 1"), busA, CANBusConfig{}).success);
+    ASSERT_TRUE(mgr.openSlot("TR 2", mgr.virtualDriver("TR 2"), busB, CANBusConfig{}).success);
+    mgr.virtualDriver("TR 1")->setTxConfirmations(true);
+
+    VirtualCANDriver peerA, peerB;
+    ASSERT_TRUE(peerA.openChannel(busA, CANBusConfig{}).success);
+    ASSERT_TRUE(peerB.openChannel(busB, CANBusConfig{}).success);
+
+    CANBusManager::TraceOptions options;
+    options.path = dir.filePath("slots.asc");
+    ASSERT_TRUE(mgr.startTrace({"TR 1", "TR 2"}, options).success);
+    EXPECT_FALSE(mgr.startTrace({"TR 1"}, options).success);      // Same file twice
+
+    CANMessage msg;
+    msg.dlc = 1;
+    for (int i = 0; i < 10; ++i) {
+        msg.id = 0x10;
+        ASSERT_TRUE(peerA.transmit(msg).success);
+        msg.id = 0x20;
+        ASSERT_TRUE(peerB.transmit(msg).success);
+    }
+    msg.id = 0x30;
+    ASSERT_TRUE(mgr.transmit("TR 1", msg).success);
+    QThread::msleep(100);
+
+    CANBusManager::TraceStats stats;
+    ASSERT_TRUE(mgr.traceStats(options.path, stats));
+    ASSERT_TRUE(mgr.stopTrace(options.path, &stats).success);
+    EXPECT_FALSE(mgr.traceStats(options.path, stats));
+    EXPECT_EQ(stats.framesWritten, 21u);
+    EXPECT_EQ(stats.framesDropped, 0u);
+
+    int channel1 = 0, channel2 = 0, transmitted = 0;
+    for (const QString& line : readLines(options.path)) {
+        if (line.contains(" 1  10 "))
+            ++channel1;
+        if (line.contains(" 2  20 "))
+            ++channel2;
+        if (line.contains(" 1  30 ") && line.contains(" Tx "))
+            ++transmitted;
+    }
+    EXPECT_EQ(channel1, 10);
+    EXPECT_EQ(channel2, 10);
+    EXPECT_EQ(transmitted, 1);
+
+    peerA.closeChannel();
+    peerB.closeChannel();
+    mgr.closeSlot("TR 1");
+    mgr.closeSlot("TR 2");
+}
@@ -0,0 +1,423 @@
+/**
+ * @file tst_CANTraceReplayer.cpp
+ * @brief Unit tests for CANTraceReader and CANTraceReplayer — ASC/BLF
+ *        parsing, replay timing, speed, loops, filtering, remapping and stop.
+ *
+ * Traces are written with CANTraceWriter (or by hand for foreign ASC
+ * variants) and replayed from a VirtualCANDriver node; a second node on
+ * the same bus records what arrived. Timing bounds are loose so the tests
+ * stay stable on loaded CI machines.
+ */
+
+#include <gtest/gtest.h>
+#include "CANManager.h"
+#include "CANTraceReader.h"
+#include "CANTraceReplayer.h"
+#include "CANTraceWriter.h"
+#include "VirtualCANDriver.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include <cstring>
+
+using namespace CANManager;
+
+namespace {
+
+CANTraceFrame traceFrame(uint64_t timestampNs, uint32_t id, uint8_t fill, uint16_t channel = 1)
+{
+    CANTraceFrame frame;
+    frame.msg.id        = id;
+    frame.msg.dlc       = 8;
+    frame.msg.timestamp = timestampNs;
+    std::memset(frame.msg.data, fill, 8);
+    frame.channel = channel;
+    return frame;
+}
+
+void writeTrace(const QString& path, const std::vector<CANTraceFrame>& frames)
+{
+    auto writer = CANTraceWriter::create(CANTraceWriter::formatForPath(path));
+    ASSERT_TRUE(writer->open(path, QDateTime::currentDateTime()).success);
+    ASSERT_TRUE(writer->write(frames.data(), static_cast<int>(frames.size())).success);
+    ASSERT_TRUE(writer->close().success);
+}
+
+/// count frames, `id` alternating with `id + 0x100`, one every intervalUs
+std::vector<CANTraceFrame> periodicFrames(int count, uint32_t id, int intervalUs)
+{
+    std::vector<CANTraceFrame> frames;
+    for (int i = 0; i < count; ++i)
+        frames.push_back(traceFrame(1000000u + static_cast<uint64_t>(i) * intervalUs * 1000u,
+                                    id + (i % 2) * 0x100, static_cast<uint8_t>(i)));
+    return frames;
+}
+
+} // namespace
+
+// ============================================================================
+// CANTraceReader
+// ============================================================================
+
+TEST(CANTraceReader, ReadsBackWhatTheWritersWrote)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    std::vector<CANTraceFrame> frames;
+    frames.push_back(traceFrame(5000000, 0x123, 0x11));
+
+    CANTraceFrame ext = traceFrame(5100000, 0x18DAF110, 0x22, 2);
+    ext.msg.isExtended  = true;
+    ext.msg.isTxConfirm = true;
+    frames.push_back(ext);
+
+    CANTraceFrame remote = traceFrame(5200000, 0x7FF, 0);
+    remote.msg.isRemote = true;
+    remote.msg.dlc = 4;
+    frames.push_back(remote);
+
+    CANTraceFrame error = traceFrame(5250000, 0, 0);
+    error.msg.isError = true;
+    frames.push_back(error);
+
+    CANTraceFrame fd = traceFrame(5300000, 0x456, 0);
+    fd.msg.isFD  = true;
+    fd.msg.isBRS = true;
+    fd.msg.dlc   = 15;
+    for (int i = 0; i < 64; ++i)
+        fd.msg.data[i] = static_cast<uint8_t>(i);
+    frames.push_back(fd);
+
+    for (const QString name : {QStringLiteral("t.asc"), QStringLiteral("t.blf")}) {
+        SCOPED_TRACE(name.toStdString());
+        const QString path = dir.filePath(name);
+        writeTrace(path, frames);
+
+        CANTraceReader reader;
+        ASSERT_TRUE(reader.load(path).success);
+        EXPECT_EQ(reader.format(), CANTraceWriter::formatForPath(path));
+
+        // The error frame is skipped; timestamps start at the first frame
+        const auto& loaded = reader.frames();
+        ASSERT_EQ(loaded.size(), 4u);
+        EXPECT_GE(reader.skippedRecords(), 1u);
+        EXPECT_EQ(loaded[0].timestamp, 0u);
+        EXPECT_EQ(loaded[1].timestamp, 100000u);
+        EXPECT_EQ(loaded[3].timestamp, 300000u);
+        EXPECT_EQ(reader.duration(), 300000u);
+
+        const CANMessage classic = reader.message(loaded[0]);
+        EXPECT_EQ(classic.id, 0x123u);
+        EXPECT_EQ(classic.dlc, 8);
+        EXPECT_EQ(classic.data[7], 0x11);
+        EXPECT_FALSE(classic.isExtended || classic.isFD || classic.isRemote);
+
+        EXPECT_EQ(loaded[1].id, 0x18DAF110u);
+        EXPECT_EQ(loaded[1].channel, 2);
+        EXPECT_TRUE(loaded[1].flags & CANTraceReader::Extended);
+        EXPECT_TRUE(loaded[1].flags & CANTraceReader::Tx);
+        EXPECT_FALSE(reader.message(loaded[1]).isTxConfirm);
+
+        EXPECT_TRUE(loaded[2].flags & CANTraceReader::Remote);
+        EXPECT_EQ(loaded[2].dlc, 4);
+        EXPECT_EQ(loaded[2].dataLength(), 0);
+
+        const CANMessage fdMsg = reader.message(loaded[3]);
+        EXPECT_TRUE(fdMsg.isFD);
+        EXPECT_TRUE(fdMsg.isBRS);
+        ASSERT_EQ(fdMsg.dataLength(), 64);
+        EXPECT_EQ(std::memcmp(fdMsg.data, fd.msg.data, 64), 0);
+    }
+}
+
+TEST(CANTraceReader, ReadsLargeBlfAcrossContainers)
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("large.blf");
+
+    // ~1 MB uncompressed: several 128 KiB containers
+    std::vector<CANTraceFrame> frames;
+    for (int i = 0; i < 10000; ++i) {
+        CANTraceFrame frame = traceFrame(static_cast<uint64_t>(i) * 100000u, 0x100 + (i % 64),
+                                         static_cast<uint8_t>(i));
+        frame.msg.isFD = (i % 3 == 0);
+        frame.msg.dlc  = frame.msg.isFD ? 13 : 8;
+        frames.push_back(frame);
+    }
+    writeTrace(path, frames);
+
+    CANTraceReader reader;
+    ASSERT_TRUE(reader.load(path).success);
+    ASSERT_EQ(reader.frames().size(), frames.size());
+    EXPECT_EQ(reader.skippedRecords(), 0u);
+    for (size_t i = 0; i < frames.size(); i += 997) {
+        const CANMessage msg = reader.message(reader.frames()[i]);
+        EXPECT_EQ(msg.id, frames[i].msg.id);
+        EXPECT_EQ(msg.isFD, frames[i].msg.isFD);
+        EXPECT_EQ(msg.dataLength(), frames[i].msg.dataLength());
+        EXPECT_EQ(msg.data[0], frames[i].msg.data[0]);
+        EXPECT_EQ(msg.timestamp, frames[i].msg.timestamp);
+    }
+}
+
+TEST(CANTraceReader, ParsesForeignAscVariants)
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("foreign.asc");
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("date Mon Jan 05 10:00:00.000 am 2026\n"
+               "base dec  timestamps relative\n"
+               "Begin Triggerblock Mon Jan 05 10:00:00.000 am 2026\n"
+               "   0.000000 Start of measurement\n"
+               "   0.010000 1  256             Rx   d 2 10 255\n"
+               "   0.005000 1  Statistic: D 10 R 0 XD 0 XR 0 E 0 O 0 B 1.23%\n"
+               "   0.005000 CANFD   2 Rx   512  EngineData  1 0 a 16 "
+               "0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15  1000  120  3000 0 0 0 0 0\n"
+               "   0.001000 CANFD   2 Tx   513x  0 0 3 3 1 2 3  200  100  0 0 0 0 0 0\n"
+               "   0.001000 1  ErrorFrame\n"
+               "End TriggerBlock\n");
+    file.close();
+
+    CANTraceReader reader;
+    ASSERT_TRUE(reader.load(path).success);
+    const auto& frames = reader.frames();
+    ASSERT_EQ(frames.size(), 3u);
+
+    // Decimal base; relative timestamps accumulate over every line
+    EXPECT_EQ(frames[0].id, 256u);
+    EXPECT_EQ(reader.message(frames[0]).data[1], 255);
+
+    EXPECT_EQ(frames[1].id, 512u);
+    EXPECT_EQ(frames[1].timestamp, 10000000u);
+    EXPECT_TRUE(frames[1].flags & CANTraceReader::FD);
+    EXPECT_TRUE(frames[1].flags & CANTraceReader::BRS);
+    EXPECT_EQ(frames[1].dataLength(), 16);
+    EXPECT_EQ(reader.message(frames[1]).data[15], 15);
+
+    // EDL flag clear: a classic frame logged on an FD channel
+    EXPECT_EQ(frames[2].id, 513u);
+    EXPECT_EQ(frames[2].timestamp, 11000000u);
+    EXPECT_FALSE(frames[2].flags & CANTraceReader::FD);
+    EXPECT_TRUE(frames[2].flags & CANTraceReader::Extended);
+    EXPECT_TRUE(frames[2].flags & CANTraceReader::Tx);
+    EXPECT_EQ(frames[2].dataLength(), 3);
+}
+
+TEST(CANTraceReader, FailsOnMissingOrFramelessFile)
+{
+    QTemporaryDir dir;
+    CANTraceReader reader;
+    EXPECT_FALSE(reader.load(dir.filePath("missing.asc")).success);
+
+    const QString path = dir.filePath("empty.asc");
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("date Mon Jan 05 10:00:00.000 am 2026\nbase hex  timestamps absolute\n");
+    file.close();
+    EXPECT_FALSE(reader.load(path).success);
+    EXPECT_TRUE(reader.frames().empty());
+}
+
+// ============================================================================
+// CANTraceReplayer
+// ============================================================================
+
+class CANTraceReplayerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+        m_busName = QString::fromLatin1("t_replay_%1")
+            .arg(QString::fromLatin1(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        CANChannelInfo ch;
+        ch.name = m_busName;
+        VirtualCANBus::bus(m_busName)->setTiming(VirtualCANBus::Timing::Simulated);
+
+        ASSERT_TRUE(m_sender.openChannel(ch, m_cfg).success);
+        ASSERT_TRUE(m_listener.openChannel(ch, m_cfg).success);
+        m_replayer = std::make_unique<CANTraceReplayer>(&m_sender, &m_txMutex, m_busName);
+    }
+
+    void TearDown() override
+    {
+        m_replayer->shutdown();
+        m_listener.closeChannel();
+        m_sender.closeChannel();
+    }
+
+    /// Drain everything the listener has received (including frames still being delivered)
+    std::vector<CANMessage> received()
+    {
+        std::vector<CANMessage> frames;
+        CANMessage msg;
+        while (m_listener.receive(msg, 20).success)
+            frames.push_back(msg);
+        return frames;
+    }
+
+    QTemporaryDir    m_dir;
+    QString          m_busName;
+    CANBusConfig     m_cfg;
+    VirtualCANDriver m_sender;
+    VirtualCANDriver m_listener;
+    QMutex           m_txMutex;
+    std::unique_ptr<CANTraceReplayer> m_replayer;
+};
+
+TEST_F(CANTraceReplayerTest, ReplaysWithOriginalTiming)
+{
+    const QString path = m_dir.filePath("timing.blf");
+    writeTrace(path, periodicFrames(50, 0x100, 2000));     // 98 ms
+
+    CANTraceReplayer::Options options;
+    options.path = path;
+    QElapsedTimer timer;
+    timer.start();
+    ASSERT_TRUE(m_replayer->start(options).success);
+    EXPECT_TRUE(m_replayer->isRunning());
+    ASSERT_TRUE(m_replayer->waitForFinished(5000));     // The only upper bound: machines stall
+    EXPECT_GE(timer.elapsed(), 95);
+
+    const auto frames = received();
+    ASSERT_EQ(frames.size(), 50u);
+    for (size_t i = 0; i < frames.size(); ++i) {
+        EXPECT_EQ(frames[i].id, 0x100u + (i % 2) * 0x100);
+        EXPECT_EQ(frames[i].data[0], static_cast<uint8_t>(i));
+    }
+
+    CANTraceReplayer::Stats stats;
+    ASSERT_TRUE(m_replayer->stop(&stats).success);
+    EXPECT_FALSE(stats.running);
+    EXPECT_EQ(stats.framesPerLoop, 50u);
+    EXPECT_EQ(stats.sent, 50u);
+    EXPECT_EQ(stats.errors, 0u);
+    EXPECT_EQ(stats.loopsCompleted, 1);
+    EXPECT_NEAR(stats.loopDurationS, 0.100, 1e-6);
+    EXPECT_LE(stats.p50ErrorUs, stats.p99ErrorUs);
+    EXPECT_LE(stats.p99ErrorUs, stats.maxErrorUs);
+}
+
+TEST_F(CANTraceReplayerTest, SpeedLoopsFilterAndRemap)
+{
+    const QString path = m_dir.filePath("loops.asc");
+    writeTrace(path, periodicFrames(10, 0x100, 4000));     // 0x100 / 0x200, 40 ms per pass
+
+    CANTraceReplayer::Options options;
+    options.path  = path;
+    options.speed = 4.0;
+    options.loops = 3;
+    options.exclude.append(CANIdFilter::exact(0x200));
+    options.idMap.insert(0x100, 0x123);
+
+    QElapsedTimer timer;
+    timer.start();
+    ASSERT_TRUE(m_replayer->start(options).success);
+    ASSERT_TRUE(m_replayer->waitForFinished(5000));
+    EXPECT_GE(timer.elapsed(), 25);                         // 3 x 40 ms / 4, minus the last gap
+
+    const auto frames = received();
+    ASSERT_EQ(frames.size(), 15u);
+    for (const CANMessage& msg : frames)
+        EXPECT_EQ(msg.id, 0x123u);
+
+    const CANTraceReplayer::Stats stats = m_replayer->stats();
+    EXPECT_EQ(stats.framesPerLoop, 5u);
+    EXPECT_EQ(stats.loopsCompleted, 3);
+    EXPECT_EQ(stats.sent, 15u);
+}
+
+TEST_F(CANTraceReplayerTest, IncludeFilterAndChannelSelectFrames)
+{
+    std::vector<CANTraceFrame> trace = periodicFrames(20, 0x100, 100);
+    for (size_t i = 0; i < trace.size(); i += 4)
+        trace[i].channel = 2;
+    const QString path = m_dir.filePath("select.asc");
+    writeTrace(path, trace);
+
+    CANTraceReplayer::Options options;
+    options.path    = path;
+    options.channel = 1;
+    options.include.append(CANIdFilter::exact(0x100));
+    ASSERT_TRUE(m_replayer->start(options).success);
+    ASSERT_TRUE(m_replayer->waitForFinished(5000));
+
+    // Even indices are 0x100; every other one of them is on channel 2
+    const auto frames = received();
+    ASSERT_EQ(frames.size(), 5u);
+    for (const CANMessage& msg : frames)
+        EXPECT_EQ(msg.data[0] % 4, 2);
+
+    // Nothing left after filtering is an error
+    options.include = {CANIdFilter::exact(0x555)};
+    EXPECT_FALSE(m_replayer->start(options).success);
+}
+
+TEST_F(CANTraceReplayerTest, StopEndsEndlessReplay)
+{
+    const QString path = m_dir.filePath("endless.asc");
+    writeTrace(path, periodicFrames(4, 0x100, 1000));
+
+    CANTraceReplayer::Options options;
+    options.path  = path;
+    options.loops = 0;
+    ASSERT_TRUE(m_replayer->start(options).success);
+    EXPECT_FALSE(m_replayer->start(options).success);        // One replay at a time
+    EXPECT_FALSE(m_replayer->waitForFinished(100));
+
+    CANTraceReplayer::Stats stats;
+    ASSERT_TRUE(m_replayer->stop(&stats).success);
+    EXPECT_FALSE(m_replayer->isRunning());
+    EXPECT_GE(stats.loopsCompleted, 5);
+
+    // Nothing is sent after stop() returns
+    const size_t count = received().size();
+    EXPECT_EQ(count, stats.sent);
+    QThread::msleep(30);
+    EXPECT_TRUE(received().empty());
+}
+
+TEST_F(CANTraceReplayerTest, RejectsBadOptions)
+{
+    CANTraceReplayer::Options options;
+    options.path = m_dir.filePath("missing.asc");
+    EXPECT_FALSE(m_replayer->start(options).success);
+
+    options.speed = 0.0;
+    EXPECT_FALSE(m_replayer->start(options).success);
+    EXPECT_FALSE(m_replayer->stop().success);                // Never started
+}
+
+TEST(CANTraceReplayerManager, ClosingSlotStopsReplay)
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("slot.asc");
+    writeTrace(path, periodicFrames(10, 0x100, 1000));
+
+    CANChannelInfo ch;
+    ch.name = QStringLiteral("t_replay_slot");
+    VirtualCANBus::bus(ch.name)->setTiming(VirtualCANBus::Timing::Simulated);
+
+    auto& mgr = CANBusManager::instance();
+    ASSERT_TRUE(mgr.openSlot("Replay 1", mgr.virtualDriver("Replay 1"), ch, CANBusConfig{}).success);
+
+    CANBusManager::ReplayOptions options;
+    options.path  = path;
+    options.loops = 0;
+    ASSERT_TRUE(mgr.startReplay("Replay 1", options).success);
+    EXPECT_FALSE(mgr.waitForReplay("Replay 1", 50));
+
+    CANBusManager::ReplayStats stats;
+    ASSERT_TRUE(mgr.replayStats("Replay 1", stats));
+    EXPECT_TRUE(stats.running);
+    EXPECT_GT(stats.sent, 0u);
+
+    mgr.closeSlot("Replay 1");
+    EXPECT_FALSE(mgr.replayStats("Replay 1", stats));
+    EXPECT_FALSE(mgr.startReplay("Replay 1", options).success);
+}
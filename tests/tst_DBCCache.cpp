@@ -0,0 +1,273 @@
+/**
+ * @file tst_DBCCache.cpp
+ * @brief Unit tests for DBCCache — image round trip, keys, store / load,
+ *        rejection of stale or damaged images and pruning.
+ *
+ * Images are written to a QTemporaryDir.
+ */
+
+#include <gtest/gtest.h>
+#include "DBCCache.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <cstring>
+
+using namespace DBCManager;
+
+// ============================================================================
+// Test database
+// ============================================================================
+
+static const char* CACHE_DBC = R"(
+VERSION "2.1"
+BU_: BCM ESC
+VAL_TABLE_ OnOff 1 "On" 0 "Off" ;
+
+BO_ 256 BCM_Status: 8 BCM
+ SG_ DoorState : 0|8@1+ (1,0) [0|255] "" ESC
+ SG_ Temperature : 15|12@0- (0.1,-40) [-40|100] "degC" ESC,BCM
+ SG_ Mode M : 32|4@1+ (1,0) [0|15] "" ESC
+ SG_ Level m3 : 36|20@1+ (0.5,10) [10|100] "%" ESC
+
+BO_ 2147484672 ESC_Float: 8 ESC
+ SG_ Yaw : 0|32@1- (1,0) [0|0] "deg/s" BCM
+ SG_ Wide : 7|64@0+ (1,0) [0|0] "" BCM
+
+CM_ BU_ BCM "Body control";
+CM_ BO_ 256 "Status of the body";
+CM_ SG_ 256 Temperature "Zähnezahl — outside";
+BA_DEF_ BO_ "GenMsgCycleTime" INT 0 10000;
+BA_DEF_DEF_ "GenMsgCycleTime" 0;
+BA_ "GenMsgCycleTime" BO_ 256 20;
+BA_ "GenSigStartValue" SG_ 256 DoorState 3;
+VAL_ 256 DoorState 0 "Closed" 1 "Open" ;
+SIG_VALTYPE_ 2147484672 Yaw : 1;
+)";
+
+static DBCDatabase parseCacheDbc()
+{
+    DBCParser parser;
+    DBCDatabase db = parser.parseString(CACHE_DBC);
+    EXPECT_FALSE(parser.hasErrors());
+    return db;
+}
+
+static void expectSamePlan(const DBCSignalPlan& a, const DBCSignalPlan& b)
+{
+    EXPECT_EQ(a.kind, b.kind);
+    EXPECT_EQ(a.value, b.value);
+    EXPECT_EQ(a.bigEndian, b.bigEndian);
+    EXPECT_EQ(a.shift, b.shift);
+    EXPECT_EQ(a.byteCount, b.byteCount);
+    EXPECT_EQ(a.firstByte, b.firstByte);
+    EXPECT_EQ(a.mask, b.mask);
+    EXPECT_EQ(a.signBit, b.signBit);
+    EXPECT_EQ(a.startBit, b.startBit);
+    EXPECT_EQ(a.bitLength, b.bitLength);
+    EXPECT_EQ(a.valueType, b.valueType);
+}
+
+/// Field by field, and decoding a test pattern gives the same raw values
+static void expectSameDatabase(const DBCDatabase& a, const DBCDatabase& b)
+{
+    EXPECT_EQ(a.version, b.version);
+    ASSERT_EQ(a.nodes.size(), b.nodes.size());
+    for (int i = 0; i < a.nodes.size(); ++i) {
+        EXPECT_EQ(a.nodes[i].name, b.nodes[i].name);
+        EXPECT_EQ(a.nodes[i].comment, b.nodes[i].comment);
+    }
+    EXPECT_EQ(a.valueTables, b.valueTables);
+
+    uint8_t pattern[64];
+    for (int i = 0; i < 64; ++i)
+        pattern[i] = static_cast<uint8_t>(i * 37 + 11);
+
+    ASSERT_EQ(a.messages.size(), b.messages.size());
+    for (int m = 0; m < a.messages.size(); ++m) {
+        const DBCMessage& ma = a.messages[m];
+        const DBCMessage& mb = b.messages[m];
+        EXPECT_EQ(ma.id, mb.id);
+        EXPECT_EQ(ma.name, mb.name);
+        EXPECT_EQ(ma.dlc, mb.dlc);
+        EXPECT_EQ(ma.sender, mb.sender);
+        EXPECT_EQ(ma.comment, mb.comment);
+        EXPECT_EQ(ma.isExtended, mb.isExtended);
+        EXPECT_EQ(ma.cycleTimeMs, mb.cycleTimeMs);
+        EXPECT_EQ(b.messageById(ma.id), &mb);
+        EXPECT_EQ(b.messageByName(ma.name), &mb);
+
+        ASSERT_EQ(ma.signalList.size(), mb.signalList.size()) << ma.name.toStdString();
+        for (int s = 0; s < ma.signalList.size(); ++s) {
+            const DBCSignal& sa = ma.signalList[s];
+            const DBCSignal& sb = mb.signalList[s];
+            EXPECT_EQ(sa.name, sb.name);
+            EXPECT_EQ(sa.startBit, sb.startBit);
+            EXPECT_EQ(sa.bitLength, sb.bitLength);
+            EXPECT_EQ(sa.byteOrder, sb.byteOrder);
+            EXPECT_EQ(sa.valueType, sb.valueType);
+            EXPECT_EQ(sa.factor, sb.factor);
+            EXPECT_EQ(sa.offset, sb.offset);
+            EXPECT_EQ(sa.minimum, sb.minimum);
+            EXPECT_EQ(sa.maximum, sb.maximum);
+            EXPECT_EQ(sa.unit, sb.unit);
+            EXPECT_EQ(sa.receivers, sb.receivers);
+            EXPECT_EQ(sa.comment, sb.comment);
+            EXPECT_EQ(sa.initialValue, sb.initialValue);
+            EXPECT_EQ(sa.valueDescriptions, sb.valueDescriptions);
+            EXPECT_EQ(sa.muxIndicator, sb.muxIndicator);
+            EXPECT_EQ(sa.muxValue, sb.muxValue);
+            expectSamePlan(sa.plan, sb.plan);
+            EXPECT_EQ(sa.rawValue(pattern, 64), sb.rawValue(pattern, 64)) << sa.name.toStdString();
+        }
+    }
+}
+
+// ============================================================================
+// Image format
+// ============================================================================
+
+TEST(DBCCache, RoundTripKeepsEveryField)
+{
+    const DBCDatabase db = parseCacheDbc();
+    ASSERT_EQ(db.messages.size(), 2);
+
+    const QByteArray key = DBCCache::contentKey(CACHE_DBC, static_cast<qsizetype>(std::strlen(CACHE_DBC)));
+    EXPECT_EQ(key.size(), 40);
+    const QByteArray image = DBCCache::serialize(db, key);
+
+    DBCDatabase loaded;
+    ASSERT_TRUE(DBCCache::deserialize(image.constData(), image.size(), key, loaded));
+    expectSameDatabase(db, loaded);
+
+    // Stored plans decode without a recompile
+    const DBCSignal* level = loaded.messageById(256)->signal("Level");
+    ASSERT_NE(level, nullptr);
+    EXPECT_NE(level->plan.kind, DBCSignalPlan::Kind::None);
+    uint8_t data[8] = {};
+    level->encode(42.5, data, 8);
+    EXPECT_DOUBLE_EQ(level->decode(data, 8), 42.5);
+    EXPECT_EQ(loaded.messageById(0x400)->signal("Yaw")->valueType, ValueType::Float32);
+}
+
+TEST(DBCCache, DamagedImagesAreRejected)
+{
+    const DBCDatabase db = parseCacheDbc();
+    const QByteArray key = DBCCache::contentKey("a", 1);
+    const QByteArray image = DBCCache::serialize(db, key);
+    DBCDatabase loaded;
+
+    // Every truncation
+    for (qsizetype size = 0; size < image.size(); ++size) {
+        ASSERT_FALSE(DBCCache::deserialize(image.constData(), size, key, loaded)) << size;
+        EXPECT_TRUE(loaded.isEmpty());
+    }
+
+    // Trailing byte
+    QByteArray longer = image;
+    longer.append('\0');
+    EXPECT_FALSE(DBCCache::deserialize(longer.constData(), longer.size(), key, loaded));
+
+    // Other key, other format version
+    EXPECT_FALSE(DBCCache::deserialize(image.constData(), image.size(), DBCCache::contentKey("b", 1), loaded));
+    QByteArray version = image;
+    version[8] = static_cast<char>(DBCCache::FORMAT_VERSION + 1);
+    EXPECT_FALSE(DBCCache::deserialize(version.constData(), version.size(), key, loaded));
+
+    // Huge counts and out-of-range enumerators fail without allocating
+    QByteArray counts = image;
+    const qsizetype payload = 8 + 4 + 4 + key.size() + 8;
+    const qsizetype nodeCount = payload + 4 + db.version.toUtf8().size();
+    std::memset(counts.data() + nodeCount, 0xFF, 4);
+    EXPECT_FALSE(DBCCache::deserialize(counts.constData(), counts.size(), key, loaded));
+
+    int rejected = 0;
+    for (qsizetype i = payload; i < image.size(); ++i) {
+        QByteArray flipped = image;
+        flipped[i] = static_cast<char>(flipped[i] ^ 0xFF);
+        rejected += !DBCCache::deserialize(flipped.constData(), flipped.size(), key, loaded);
+    }
+    EXPECT_GT(rejected, 0);
+}
+
+// ============================================================================
+// Files
+// ============================================================================
+
+TEST(DBCCache, StoreLoadAndContentChange)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString dbcPath = dir.filePath("net.dbc");
+    QFile file(dbcPath);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(CACHE_DBC);
+    file.close();
+
+    DBCCache cache(dir.filePath("cache"));
+    const QByteArray key = DBCCache::fileKey(dbcPath);
+    EXPECT_EQ(key, DBCCache::contentKey(CACHE_DBC, static_cast<qsizetype>(std::strlen(CACHE_DBC))));
+    EXPECT_TRUE(DBCCache::fileKey(dir.filePath("missing.dbc")).isEmpty());
+
+    DBCDatabase db;
+    EXPECT_FALSE(cache.load(key, db));
+    ASSERT_TRUE(cache.store(key, parseCacheDbc()));
+    EXPECT_FALSE(cache.store(QByteArray(), parseCacheDbc()));
+    ASSERT_TRUE(cache.load(key, db));
+    expectSameDatabase(parseCacheDbc(), db);
+
+    // Editing the DBC changes the key: a miss
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write("\nBO_ 300 Added: 1 BCM\n");
+    file.close();
+    EXPECT_NE(DBCCache::fileKey(dbcPath), key);
+    EXPECT_FALSE(cache.load(DBCCache::fileKey(dbcPath), db));
+
+    // A damaged image is a miss
+    QFile image(cache.directory() + "/" + QString::fromLatin1(key) + ".dbcimg");
+    ASSERT_TRUE(image.open(QIODevice::ReadWrite));
+    const qint64 size = image.size();
+    ASSERT_TRUE(image.resize(size / 2));
+    image.close();
+    EXPECT_FALSE(cache.load(key, db));
+    EXPECT_TRUE(db.isEmpty());
+}
+
+TEST(DBCCache, StoreKeepsAtMostMaxImages)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    DBCCache cache(dir.path());
+    const DBCDatabase db = parseCacheDbc();
+
+    QByteArray last;
+    for (int i = 0; i < DBCCache::MAX_IMAGES + 3; ++i) {
+        const char content = static_cast<char>('a' + i);
+        last = DBCCache::contentKey(&content, 1);
+        ASSERT_TRUE(cache.store(last, db));
+    }
+    EXPECT_EQ(QDir(dir.path()).entryInfoList({"*.dbcimg"}, QDir::Files, QDir::Time).size(), DBCCache::MAX_IMAGES);
+    DBCDatabase loaded;
+    EXPECT_TRUE(cache.load(last, loaded));
+}
+
+TEST(DBCCache, MIBCANRoundTrip)
+{
+    const QString path = DBC_RESOURCE_DIR "/MIBCAN.dbc";
+    DBCParser parser;
+    const DBCDatabase db = parser.parseFile(path);
+    ASSERT_FALSE(db.isEmpty());
+
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    DBCCache cache(dir.path());
+    const QByteArray key = DBCCache::fileKey(path);
+    ASSERT_TRUE(cache.store(key, db));
+
+    DBCDatabase loaded;
+    ASSERT_TRUE(cache.load(key, loaded));
+    EXPECT_EQ(loaded.totalSignalCount(), db.totalSignalCount());
+    expectSameDatabase(db, loaded);
+}
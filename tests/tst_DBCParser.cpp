@@ -7,7 +7,11 @@
 
 #include <gtest/gtest.h>
 #include "DBCParser.h"
+#include "DBCCache.h"
+#include <QFile>
+#include <cmath>
 #include <cstring>
+#include <random>
 
 using namespace DBCManager;
 
@@ -285,7 +289,7 @@ TEST(DBCParser, ExtendedId)
     const char* dbc = R"(
 VERSION ""
 BU_:
-BO_ 2147484160 ExtMsg: 8 Vector__XXX
+BO_ 2147484672 ExtMsg: 8 Vector__XXX
  SG_ Sig1 : 0|8@1+ (1,0) [0|255] "" Vector__XXX
 )";
 
@@ -293,12 +297,411 @@ BO_ 2147484160 ExtMsg: 8 Vector__XXX
     DBCDatabase db = parser.parseString(dbc);
     EXPECT_FALSE(parser.hasErrors());
 
-    // 2147484160 = 0x80000400 → extended, actual ID = 0x400
+    // 2147484672 = 0x80000400 → extended, actual ID = 0x400
     ASSERT_EQ(db.messages.size(), 1);
     EXPECT_TRUE(db.messages[0].isExtended);
     EXPECT_EQ(db.messages[0].id, 0x400u);
 }
 
+// ============================================================================
+// Attributes (cycle time, signal start values)
+// ============================================================================
+
+TEST(DBCParser, CycleTimeAndStartValueAttributes)
+{
+    const char* dbc = R"(
+VERSION ""
+BU_: ECU1
+BA_DEF_ BO_ "GenMsgCycleTime" INT 0 10000;
+BA_DEF_ SG_ "GenSigStartValue" INT 0 65535;
+BA_DEF_DEF_ "GenMsgCycleTime" 100;
+BA_DEF_DEF_ "GenSigStartValue" 0;
+BA_ "GenSigStartValue" SG_ 256 EngineSpeed 3200;
+BO_ 256 EngineData: 8 ECU1
+ SG_ EngineSpeed : 0|16@1+ (0.25,0) [0|16383.75] "rpm" Vector__XXX
+ SG_ EngineTemp : 16|8@1- (1,-40) [-40|215] "degC" Vector__XXX
+BO_ 2147484672 ExtMsg: 8 ECU1
+ SG_ Sig1 : 0|8@1+ (1,0) [0|255] "" Vector__XXX
+BA_ "GenMsgCycleTime" BO_ 2147484672 20;
+BA_ "BusType" "CAN";
+)";
+
+    DBCParser parser;
+    DBCDatabase db = parser.parseString(dbc);
+    EXPECT_FALSE(parser.hasErrors());
+
+    const DBCMessage* eng = db.messageById(256);
+    ASSERT_NE(eng, nullptr);
+    EXPECT_EQ(eng->cycleTimeMs, 100);                               // Default
+    EXPECT_DOUBLE_EQ(eng->signal("EngineSpeed")->initialValue, 800.0);  // Raw 3200 * 0.25
+    EXPECT_DOUBLE_EQ(eng->signal("EngineTemp")->initialValue, -40.0);   // Raw default 0
+
+    const DBCMessage* ext = db.messageById(0x400);
+    ASSERT_NE(ext, nullptr);
+    EXPECT_EQ(ext->cycleTimeMs, 20);
+
+    // Without the attributes messages are not cyclic
+    db = parser.parseString(MINIMAL_DBC);
+    EXPECT_EQ(db.messageById(256)->cycleTimeMs, 0);
+}
+
+// ============================================================================
+// Tokenizer
+// ============================================================================
+
+TEST(DBCParser, TokenizerEdgeCases)
+{
+    // CRLF line endings, symbol list, mux indicators, escaped quotes, a
+    // multi-line comment containing ';', value descriptions over two lines
+    std::string dbc = R"(VERSION ""
+
+NS_ :
+	BU_SG_REL_
+	BA_
+
+BU_: A B
+
+BO_ 100 Mux: 8 A
+ SG_ Selector M : 0|8@1+ (1,0) [0|255] "" B
+ SG_ Page2 m2 : 8|16@0- (0.5,-1) [-1E+003|1e3] "\"deg\"" A,B
+ SG_ Both m3M : 24|4@1+ (1,0) [0|15] ""  B
+
+CM_ SG_ 100 Page2 "Line one;
+line \"two\"";
+VAL_ 100 Selector 2 "Page 2"
+ 3 "Page 3" ;
+)";
+    for (size_t pos = 0; (pos = dbc.find('\n', pos)) != std::string::npos; pos += 2)
+        dbc.insert(pos, 1, '\r');
+
+    DBCParser parser;
+    DBCDatabase db = parser.parseString(QString::fromStdString(dbc));
+    EXPECT_FALSE(parser.hasErrors());
+
+    ASSERT_EQ(db.nodes.size(), 2);
+    EXPECT_EQ(db.nodes[1].name, "B");
+
+    const DBCMessage* msg = db.messageById(100);
+    ASSERT_NE(msg, nullptr);
+    ASSERT_EQ(msg->signalList.size(), 3);
+
+    const DBCSignal* selector = msg->signal("Selector");
+    EXPECT_EQ(selector->muxIndicator, "M");
+    EXPECT_EQ(selector->muxValue, -1);
+    ASSERT_EQ(selector->valueDescriptions.size(), 2);
+    EXPECT_EQ(selector->valueDescriptions.value(3), "Page 3");
+
+    const DBCSignal* page2 = msg->signal("Page2");
+    EXPECT_EQ(page2->muxValue, 2);
+    EXPECT_EQ(page2->byteOrder, ByteOrder::BigEndian);
+    EXPECT_EQ(page2->valueType, ValueType::Signed);
+    EXPECT_DOUBLE_EQ(page2->offset, -1.0);
+    EXPECT_DOUBLE_EQ(page2->minimum, -1000.0);
+    EXPECT_DOUBLE_EQ(page2->maximum, 1000.0);
+    EXPECT_EQ(page2->unit, "\"deg\"");
+    EXPECT_EQ(page2->receivers, QStringList({"A", "B"}));
+    EXPECT_EQ(page2->comment, "Line one;\nline \"two\"");
+
+    const DBCSignal* both = msg->signal("Both");
+    EXPECT_EQ(both->muxIndicator, "m3M");
+    EXPECT_EQ(both->muxValue, 3);
+    EXPECT_EQ(both->receivers, QStringList({"B"}));
+}
+
+TEST(DBCParser, ErrorsReportLineAndParsingContinues)
+{
+    DBCParser parser;
+    DBCDatabase db = parser.parseString(
+        "BO_ 1 Good: 8 A\n SG_ S : 0|8@1+ (1,0) [0|1] \"\" A\n\nBO_ x Bad: 8 A\n\nBO_ 2 Next: 8 A\n");
+    ASSERT_EQ(parser.errors().size(), 1);
+    EXPECT_EQ(parser.errors()[0].line, 4);
+    EXPECT_EQ(parser.errors()[0].message, "Invalid message definition: BO_ x Bad: 8 A");
+    EXPECT_EQ(db.messages.size(), 2);
+
+    parser.parseFile("/nonexistent/file.dbc");
+    ASSERT_EQ(parser.errors().size(), 1);
+    EXPECT_EQ(parser.errors()[0].line, 0);
+}
+
+TEST(DBCParser, ParseFile_MIBCAN)
+{
+    DBCParser parser;
+    DBCDatabase db = parser.parseFile(DBC_RESOURCE_DIR "/MIBCAN.dbc");
+    EXPECT_FALSE(parser.hasErrors());
+    EXPECT_EQ(db.nodes.size(), 21);
+    EXPECT_EQ(db.messages.size(), 309);
+    EXPECT_EQ(db.totalSignalCount(), 1151);
+
+    const DBCMessage* display = db.messageByName("Display_3_01");
+    ASSERT_NE(display, nullptr);
+    EXPECT_TRUE(display->isExtended);
+    EXPECT_EQ(display->cycleTimeMs, 1000);
+
+    // Windows code page comments are read as Latin-1
+    const DBCMessage* owner = nullptr;
+    for (const auto& msg : db.messages) {
+        if (msg.signal("ESP_Zaehnezahl"))
+            owner = &msg;
+    }
+    ASSERT_NE(owner, nullptr);
+    EXPECT_TRUE(owner->signal("ESP_Zaehnezahl")->comment.contains(QString::fromUtf8("Z\xC3\xA4hnezahl")));
+}
+
+// ============================================================================
+// Chunked parsing
+// ============================================================================
+
+/// Same result, errors included, as one thread
+static void expectSameAsSingleThreaded(const QByteArray& dbc, int threads, qsizetype minChunkSize)
+{
+    DBCParser single;
+    single.setThreadCount(1);
+    const DBCDatabase expected = single.parseString(QString::fromUtf8(dbc));
+
+    DBCParser chunked;
+    chunked.setThreadCount(threads);
+    chunked.setMinChunkSize(minChunkSize);
+    const DBCDatabase db = chunked.parseString(QString::fromUtf8(dbc));
+
+    EXPECT_TRUE(DBCCache::serialize(db, {}) == DBCCache::serialize(expected, {})) << threads << " threads";
+    ASSERT_EQ(chunked.errors().size(), single.errors().size());
+    for (int i = 0; i < single.errors().size(); ++i) {
+        EXPECT_EQ(chunked.errors()[i].line, single.errors()[i].line);
+        EXPECT_EQ(chunked.errors()[i].message, single.errors()[i].message);
+    }
+}
+
+TEST(DBCParser, ChunkedParseMatchesSingleThreaded)
+{
+    // Comments whose lines look like chunk starts, references before their
+    // message, a duplicate ID and invalid messages
+    QByteArray dbc = "VERSION \"1\"\nBU_: A B\nCM_ BO_ 290 \"Before its message\";\n";
+    for (int i = 0; i < 40; ++i) {
+        const QByteArray id = QString::number(256 + i).toUtf8();
+        dbc += "BO_ " + id + " M" + id + ": 8 A\n SG_ S : 0|8@1+ (1,0) [0|255] \"\" B\n";
+        dbc += "CM_ SG_ " + id + " S \"First\nBO_ 999 Fake: 8 A\nCM_ BO_ " + id + " \\\"quoted\\\"\";\n";
+        dbc += "VAL_ " + id + " S 0 \"Off\" 1 \"On\";\nBA_ \"GenSigStartValue\" SG_ " + id + " S 2;\n";
+        if (i % 10 == 0)
+            dbc += "BO_ bad\n";
+    }
+    dbc += "BO_ 256 Duplicate: 8 B\n SG_ S : 8|8@1+ (1,0) [0|255] \"\" A\nCM_ BO_ 256 \"Second\";\n";
+    dbc += "CM_ BU_ B \"Node\";\nBA_DEF_DEF_ \"GenMsgCycleTime\" 50;\n";
+
+    for (int threads : {2, 3, 16})
+        expectSameAsSingleThreaded(dbc, threads, 1);
+
+    DBCParser parser;
+    parser.setThreadCount(16);
+    parser.setMinChunkSize(1);
+    const DBCDatabase db = parser.parseString(QString::fromUtf8(dbc));
+    ASSERT_EQ(db.messages.size(), 41);
+    EXPECT_EQ(db.messageById(999), nullptr);
+    EXPECT_TRUE(db.messageById(290)->comment.isEmpty());
+    EXPECT_EQ(db.messageById(256)->name, "Duplicate");
+    EXPECT_EQ(db.messageById(256)->comment, "Second");
+    EXPECT_EQ(db.messages[0].signalList[0].comment, "First\nBO_ 999 Fake: 8 A\nCM_ BO_ 256 \"quoted\"");
+    EXPECT_EQ(db.messages[0].signalList[0].valueDescriptions.size(), 2);
+    EXPECT_EQ(db.messages[1].signalList[0].initialValue, 2.0);
+    EXPECT_EQ(db.messages[0].signalList[0].initialValue, 0.0);     // BA_ refers to the last 256
+    EXPECT_EQ(db.messages[0].cycleTimeMs, 50);
+    EXPECT_EQ(db.nodes[1].comment, "Node");
+    ASSERT_EQ(parser.errors().size(), 4);
+    EXPECT_EQ(parser.errors()[0].line, 11);
+}
+
+TEST(DBCParser, ChunkedParseMatchesSingleThreaded_MIBCAN)
+{
+    QFile file(DBC_RESOURCE_DIR "/MIBCAN.dbc");
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    const QByteArray dbc = file.readAll();
+    expectSameAsSingleThreaded(dbc, 4, DBCParser::DEFAULT_MIN_CHUNK_SIZE);
+    expectSameAsSingleThreaded(dbc, 13, 1024);
+}
+
+// ============================================================================
+// Compiled plans
+// ============================================================================
+
+TEST(DBCParser, ParsedSignalsAreCompiled)
+{
+    DBCParser parser;
+    DBCDatabase db = parser.parseString(MINIMAL_DBC);
+    const DBCSignal* temp = db.messageById(256)->signal("EngineTemp");
+    ASSERT_NE(temp, nullptr);
+    EXPECT_EQ(temp->plan.kind, DBCSignalPlan::Kind::Byte);
+    EXPECT_EQ(temp->plan.value, DBCSignalPlan::Value::Signed);
+    EXPECT_EQ(temp->plan.firstByte, 2);
+    EXPECT_TRUE(temp->hasCurrentPlan());
+}
+
+TEST(DBCParser, EditedSignalsDoNotUseAStalePlan)
+{
+    DBCParser parser;
+    DBCDatabase db = parser.parseString(MINIMAL_DBC);
+    const DBCMessage* engine = db.messageById(256);
+    ASSERT_NE(engine, nullptr);
+    const uint8_t data[8] = {0x34, 0x12, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0};
+
+    // Scaling is read from the signal, not from the plan
+    DBCSignal speed = *engine->signal("EngineSpeed");
+    speed.factor = 2.0;
+    speed.offset = 1.0;
+    EXPECT_TRUE(speed.hasCurrentPlan());
+    EXPECT_DOUBLE_EQ(speed.decode(data, 8), 0x1234 * 2.0 + 1.0);
+
+    // A moved signal decodes bit by bit until it is compiled again
+    speed.startBit = 8;
+    EXPECT_FALSE(speed.hasCurrentPlan());
+    EXPECT_EQ(speed.rawValue(data, 8), 0x5612);
+    EXPECT_DOUBLE_EQ(speed.decode(data, 8), 0x5612 * 2.0 + 1.0);
+
+    uint8_t written[8] = {};
+    speed.setRawValue(0xBEEF, written, 8);
+    EXPECT_EQ(written[0], 0x00);
+    EXPECT_EQ(written[1], 0xEF);
+    EXPECT_EQ(written[2], 0xBE);
+
+    speed.valueType = ValueType::Signed;
+    EXPECT_FALSE(speed.hasCurrentPlan());
+    speed.compile();
+    EXPECT_TRUE(speed.hasCurrentPlan());
+    EXPECT_EQ(speed.rawValue(data, 8), 0x5612);
+
+    // Batch decoding takes the same fallback
+    DBCMessage edited = *engine;
+    edited.signalList[1].startBit  = 24;
+    edited.signalList[1].bitLength = 16;
+    DBCSignalColumns columns;
+    edited.decodeBatch(data, 1, 8, 8, columns, true);
+    ASSERT_EQ(columns.frameCount, 1);
+    EXPECT_EQ(columns.raw[1][0], static_cast<int16_t>(0x9A78));
+    EXPECT_DOUBLE_EQ(columns.physical[1][0], static_cast<int16_t>(0x9A78) - 40.0);
+}
+
+TEST(DBCParser, CompiledPlanMatchesBitByBit)
+{
+    // Every layout against the uncompiled bit-by-bit path, on classic, FD
+    // and short frames (bits past the frame read as 0 and are not written)
+    std::mt19937_64 rng(0x5EED);
+    auto sameDouble = [](double a, double b) { return a == b || (std::isnan(a) && std::isnan(b)); };
+
+    for (int dataLength : {8, 64, 3}) {
+        for (ByteOrder order : {ByteOrder::LittleEndian, ByteOrder::BigEndian}) {
+            for (ValueType type : {ValueType::Unsigned, ValueType::Signed, ValueType::Float32, ValueType::Float64}) {
+                for (uint32_t length = 1; length <= 64; ++length) {
+                    if ((type == ValueType::Float32 && length != 32) || (type == ValueType::Float64 && length != 64))
+                        continue;
+                    for (uint32_t start = 0; start < static_cast<uint32_t>(dataLength) * 8 + 8; ++start) {
+                        DBCSignal reference;
+                        reference.startBit  = start;
+                        reference.bitLength = length;
+                        reference.byteOrder = order;
+                        reference.valueType = type;
+                        reference.factor    = 0.5;
+                        reference.offset    = -3.0;
+                        DBCSignal compiled = reference;
+                        compiled.compile();
+
+                        uint8_t frame[64], expected[64], actual[64];
+                        for (auto& byte : frame)
+                            byte = static_cast<uint8_t>(rng());
+                        const int64_t raw = static_cast<int64_t>(rng());
+
+                        ASSERT_EQ(compiled.rawValue(frame, dataLength), reference.rawValue(frame, dataLength))
+                            << "start " << start << " length " << length << " order " << int(order);
+                        ASSERT_TRUE(sameDouble(compiled.decode(frame, dataLength), reference.decode(frame, dataLength)))
+                            << "start " << start << " length " << length << " order " << int(order);
+
+                        std::memcpy(expected, frame, sizeof(frame));
+                        std::memcpy(actual, frame, sizeof(frame));
+                        reference.setRawValue(raw, expected, dataLength);
+                        compiled.setRawValue(raw, actual, dataLength);
+                        ASSERT_EQ(std::memcmp(expected, actual, sizeof(frame)), 0)
+                            << "start " << start << " length " << length << " order " << int(order);
+
+                        reference.encode(12.5, expected, dataLength);
+                        compiled.encode(12.5, actual, dataLength);
+                        ASSERT_EQ(std::memcmp(expected, actual, sizeof(frame)), 0)
+                            << "start " << start << " length " << length << " order " << int(order);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Batch decode
+// ============================================================================
+
+TEST(DBCParser, DecodeBatchMatchesDecode)
+{
+    // Vector-decoded (byte, window) and frame-by-frame (wide, float, 64-bit,
+    // uncompiled) signals, odd frame counts for the kernel tails
+    struct Layout { uint32_t start, length; ByteOrder order; ValueType type; };
+    const Layout layouts[] = {
+        {0, 8, ByteOrder::LittleEndian, ValueType::Signed},
+        {3, 13, ByteOrder::LittleEndian, ValueType::Unsigned},
+        {20, 51, ByteOrder::LittleEndian, ValueType::Signed},
+        {23, 12, ByteOrder::BigEndian, ValueType::Signed},
+        {63, 51, ByteOrder::BigEndian, ValueType::Unsigned},
+        {180, 16, ByteOrder::LittleEndian, ValueType::Unsigned},    // Past the window near the frame end
+        {5, 60, ByteOrder::LittleEndian, ValueType::Unsigned},
+        {32, 32, ByteOrder::LittleEndian, ValueType::Float32},
+        {64, 64, ByteOrder::BigEndian, ValueType::Signed},
+        {8, 52, ByteOrder::LittleEndian, ValueType::Signed},
+    };
+
+    DBCMessage msg;
+    for (const auto& layout : layouts) {
+        DBCSignal sig;
+        sig.name      = QString("S%1").arg(msg.signalList.size());
+        sig.startBit  = layout.start;
+        sig.bitLength = layout.length;
+        sig.byteOrder = layout.order;
+        sig.valueType = layout.type;
+        sig.factor    = 0.1;
+        sig.offset    = -7.0;
+        sig.compile();
+        msg.signalList.append(sig);
+    }
+    msg.signalList.append(msg.signalList[3]);
+    msg.signalList.last().plan = DBCSignalPlan();
+
+    struct Frame { uint8_t data[24]; uint32_t pad; };     // Stride != payload length
+    std::mt19937_64 rng(0xBA7C);
+    std::vector<Frame> frames(1037);
+    for (auto& frame : frames)
+        for (auto& byte : frame.data)
+            byte = static_cast<uint8_t>(rng());
+
+    for (DBCSimd simd : {DBCSimd::Scalar, DBCSimd::SSE41, DBCSimd::AVX2}) {
+        for (int count : {0, 1, 3, 1037}) {
+            DBCSignalColumns columns;
+            msg.decodeBatch(frames[0].data, count, sizeof(Frame), 24, columns, true, simd);
+            ASSERT_EQ(columns.frameCount, count);
+            ASSERT_EQ(columns.physical.size(), msg.signalList.size());
+            ASSERT_EQ(columns.raw.size(), msg.signalList.size());
+            for (int s = 0; s < msg.signalList.size(); ++s) {
+                ASSERT_EQ(columns.physical[s].size(), count);
+                for (int f = 0; f < count; ++f) {
+                    const DBCSignal& sig = msg.signalList[s];
+                    ASSERT_EQ(columns.raw[s][f], sig.rawValue(frames[f].data, 24))
+                        << "signal " << s << " frame " << f << " simd " << int(simd);
+                    const double expected = sig.decode(frames[f].data, 24);
+                    ASSERT_TRUE(columns.physical[s][f] == expected || (std::isnan(expected) && std::isnan(columns.physical[s][f])))
+                        << "signal " << s << " frame " << f << " simd " << int(simd);
+                }
+            }
+        }
+    }
+
+    DBCSignalColumns physicalOnly;
+    msg.decodeBatch(frames[0].data, 5, sizeof(Frame), 24, physicalOnly);
+    EXPECT_TRUE(physicalOnly.raw.isEmpty());
+    EXPECT_EQ(physicalOnly.physical.first().size(), 5);
+}
+
 // ============================================================================
 // Empty / invalid input
 // ============================================================================
@@ -0,0 +1,260 @@
+/**
+ * @file tst_FlightRecorder.cpp
+ * @brief Unit tests for FlightRing and FlightRecorder — overwrite semantics,
+ *        concurrent capture, window selection and bounded memory.
+ *
+ * CAN traffic comes from a VirtualCANDriver node on the bus of a manager
+ * slot; serial traffic is fed in directly through recordSerial().
+ */
+
+#include <gtest/gtest.h>
+#include "FlightRecorder.h"
+#include "CANManager.h"
+#include "VirtualCANDriver.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include <thread>
+
+using namespace TestExecutor;
+using namespace CANManager;
+
+namespace {
+
+QStringList readLines(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return QString::fromLatin1(file.readAll()).split('\n', Qt::SkipEmptyParts);
+}
+
+QStringList frameLines(const QString& path)
+{
+    QStringList frames;
+    for (const QString& line : readLines(path)) {
+        if (line.contains(" Rx ") || line.contains(" Tx "))
+            frames.append(line);
+    }
+    return frames;
+}
+
+} // namespace
+
+// ============================================================================
+// FlightRing
+// ============================================================================
+
+TEST(FlightRing, KeepsNewestEntries)
+{
+    FlightRing<int> ring(8);
+    ASSERT_EQ(ring.capacity(), 8u);
+
+    for (int i = 0; i < 20; ++i)
+        ring.write(1, [i](int& entry, size_t) { entry = i; });
+
+    std::vector<int> out;
+    EXPECT_EQ(ring.snapshot(out), 20u);
+    ASSERT_EQ(out.size(), 8u);
+    for (size_t i = 0; i < out.size(); ++i)
+        EXPECT_EQ(out[i], static_cast<int>(12 + i));
+
+    // A write larger than the ring keeps its tail
+    ring.write(20, [](int& entry, size_t i) { entry = 100 + static_cast<int>(i); });
+    ring.snapshot(out);
+    ASSERT_EQ(out.size(), 8u);
+    EXPECT_EQ(out.front(), 112);
+    EXPECT_EQ(out.back(), 119);
+}
+
+TEST(FlightRing, ConcurrentWritersNeverTearEntries)
+{
+    // Writers stay within one lap of the ring, as the capture paths do;
+    // the reader snapshots continuously while they write
+    struct Entry { uint64_t a = 0, b = 0, c = 0; };
+    constexpr uint64_t PER_WRITER = 30000;
+    FlightRing<Entry> ring(4 * PER_WRITER);
+    std::atomic<bool> done{false};
+
+    auto writer = [&](uint64_t base) {
+        for (uint64_t i = 0; i < PER_WRITER; ++i) {
+            const uint64_t v = base + i;
+            ring.write(1, [v](Entry& e, size_t) { e.a = v; e.b = v; e.c = v; });
+        }
+    };
+    std::thread first(writer, 0);
+    std::thread second(writer, 1000000);
+
+    std::thread reader([&]() {
+        std::vector<Entry> out;
+        while (!done.load()) {
+            ring.snapshot(out);
+            for (const Entry& e : out) {
+                ASSERT_EQ(e.a, e.b);
+                ASSERT_EQ(e.b, e.c);
+            }
+        }
+    });
+
+    first.join();
+    second.join();
+    done = true;
+    reader.join();
+
+    // Entries written during a snapshot are dropped and counted, never lost silently
+    std::vector<Entry> out;
+    EXPECT_EQ(ring.snapshot(out) + ring.missed(), 2 * PER_WRITER);
+    EXPECT_EQ(out.size() + ring.missed(), 2 * PER_WRITER);
+}
+
+// ============================================================================
+// FlightRecorder
+// ============================================================================
+
+class FlightRecorderTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+        m_bus.name = QString::fromLatin1("t_flight_%1")
+            .arg(QString::fromLatin1(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        VirtualCANBus::bus(m_bus.name)->setTiming(VirtualCANBus::Timing::Simulated);
+
+        auto& mgr = CANBusManager::instance();
+        ASSERT_TRUE(mgr.openSlot("FR 1", mgr.virtualDriver("FR 1"), m_bus, CANBusConfig{}).success);
+        ASSERT_TRUE(m_peer.openChannel(m_bus, CANBusConfig{}).success);
+    }
+
+    void TearDown() override
+    {
+        FlightRecorder::instance().stop();
+        m_peer.closeChannel();
+        CANBusManager::instance().closeSlot("FR 1");
+    }
+
+    void send(uint32_t id)
+    {
+        CANMessage msg;
+        msg.id  = id;
+        msg.dlc = 1;
+        ASSERT_TRUE(m_peer.transmit(msg).success);
+    }
+
+    QTemporaryDir     m_dir;
+    CANChannelInfo    m_bus;
+    VirtualCANDriver  m_peer;
+};
+
+TEST_F(FlightRecorderTest, DumpsOnlyTheWindowAroundTheTrigger)
+{
+    auto& recorder = FlightRecorder::instance();
+    FlightRecorder::Options options;
+    options.preTriggerMs  = 400;
+    options.postTriggerMs = 300;
+    recorder.start(options);
+
+    send(0x100);                                // Before the window
+    QThread::msleep(700);
+    send(0x200);                                // ~50 ms before the trigger
+    recorder.recordSerial("COM_T", true, QByteArray("AT\r\n"));
+    QThread::msleep(50);
+
+    const QString dir = m_dir.filePath("step1");
+    EXPECT_EQ(recorder.trigger(dir), dir);
+
+    QThread::msleep(50);
+    send(0x300);                                // Within the post-trigger window
+    recorder.recordSerial("COM_T", false, QByteArray("OK\r\n"));
+
+    ASSERT_TRUE(recorder.waitForDumps(5000));
+
+    // 0x100 is older than the window, 0x200 and 0x300 are inside it
+    const QStringList frames = frameLines(dir + "/FR_1.asc");
+    ASSERT_EQ(frames.size(), 2) << frames.join("\n").toStdString();
+    EXPECT_TRUE(frames[0].contains(" 200 "));
+    EXPECT_TRUE(frames[1].contains(" 300 "));
+
+    // Times count from the start of the window, 400 ms before the trigger
+    const double first = frames[0].trimmed().split(' ').first().toDouble();
+    EXPECT_GE(first, 0.0);
+    EXPECT_LE(first, 0.40);
+
+    const QStringList serial = readLines(dir + "/COM_T.log");
+    ASSERT_EQ(serial.size(), 4);
+    EXPECT_TRUE(serial[2].contains(" Tx  41 54 0D 0A  \"AT\\r\\n\""));
+    EXPECT_TRUE(serial[3].contains(" Rx  4F 4B 0D 0A  \"OK\\r\\n\""));
+}
+
+TEST_F(FlightRecorderTest, RingSizeBoundsTheCapture)
+{
+    auto& recorder = FlightRecorder::instance();
+    FlightRecorder::Options options;
+    options.preTriggerMs     = 5000;
+    options.postTriggerMs    = 0;
+    options.canFramesPerSlot = 16;
+    recorder.start(options);
+
+    for (uint32_t i = 0; i < 100; ++i)
+        send(0x400 + i);
+    QThread::msleep(100);
+
+    const QString dir = m_dir.filePath("bounded");
+    recorder.trigger(dir);
+    ASSERT_TRUE(recorder.waitForDumps(5000));
+
+    const QStringList frames = frameLines(dir + "/FR_1.asc");
+    ASSERT_EQ(frames.size(), 16);
+    EXPECT_TRUE(frames.first().contains(" 454 "));     // 0x400 + 84
+    EXPECT_TRUE(frames.last().contains(" 463 "));      // 0x400 + 99
+}
+
+TEST_F(FlightRecorderTest, TriggerWhileStoppedDoesNothing)
+{
+    auto& recorder = FlightRecorder::instance();
+    recorder.stop();
+    EXPECT_FALSE(recorder.isRunning());
+    EXPECT_TRUE(recorder.trigger(m_dir.filePath("none")).isEmpty());
+    EXPECT_TRUE(recorder.waitForDumps(0));
+}
+
+TEST_F(FlightRecorderTest, SessionsShareTheRecorder)
+{
+    auto& recorder = FlightRecorder::instance();
+    FlightRecorder::Options first;
+    first.preTriggerMs  = 1000;
+    first.postTriggerMs = 200;
+    FlightRecorder::Options second = first;
+    second.preTriggerMs = 3000;
+
+    // A second session keeps the first one's window and history
+    recorder.acquire(first);
+    recorder.acquire(second);
+    EXPECT_EQ(recorder.options().preTriggerMs, 1000);
+
+    // Its dump is the only one it waits for
+    const QString dir = m_dir.filePath("shared");
+    recorder.trigger(dir);
+    EXPECT_TRUE(recorder.waitForDumps({m_dir.filePath("other")}, 0));
+    EXPECT_FALSE(recorder.waitForDumps({dir}, 0));
+
+    // Stopped only once no session uses it and no dump is pending
+    recorder.release();
+    recorder.stopIfUnused();
+    EXPECT_TRUE(recorder.isRunning());
+    recorder.release();
+    recorder.stopIfUnused();
+    EXPECT_TRUE(recorder.isRunning());
+    ASSERT_TRUE(recorder.waitForDumps({dir}, 5000));
+    EXPECT_TRUE(QDir(dir).exists());
+    recorder.stopIfUnused();
+    EXPECT_FALSE(recorder.isRunning());
+
+    // The next session's window applies once it is unused
+    recorder.acquire(second);
+    EXPECT_EQ(recorder.options().preTriggerMs, 3000);
+    recorder.release();
+}
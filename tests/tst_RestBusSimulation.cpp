@@ -0,0 +1,249 @@
+/**
+ * @file tst_RestBusSimulation.cpp
+ * @brief Unit tests for RestBusSimulation — node selection, cycle times,
+ *        start values, runtime signal overrides and RestBusManager.
+ *
+ * The simulation transmits on slot "RB 1"; "RB 2" on the same virtual bus
+ * records what arrived.
+ */
+
+#include <gtest/gtest.h>
+#include "RestBusSimulation.h"
+#include "CANManager.h"
+#include "CANSlotFixture.h"
+
+#include <QThread>
+
+using namespace DBCManager;
+using CANManager::CANBusManager;
+using CANManager::CANMessage;
+
+// ============================================================================
+// Test network
+// ============================================================================
+
+static const char* NETWORK_DBC = R"(
+VERSION ""
+BU_: BCM ESC DUT
+BA_DEF_DEF_ "GenMsgCycleTime" 0;
+BA_DEF_DEF_ "GenSigStartValue" 0;
+
+BO_ 256 BCM_Status: 8 BCM
+ SG_ DoorState : 0|8@1+ (1,0) [0|255] "" DUT
+ SG_ Brightness : 8|8@1+ (0.5,0) [0|100] "%" DUT
+
+BO_ 257 BCM_Event: 2 BCM
+ SG_ Button : 0|8@1+ (1,0) [0|255] "" DUT
+
+BO_ 512 ESC_Speed: 8 ESC
+ SG_ VehicleSpeed : 0|16@1+ (0.01,0) [0|655.35] "km/h" DUT
+ SG_ Page M : 16|8@1+ (1,0) [0|255] "" DUT
+ SG_ WheelFL m1 : 24|16@1+ (1,0) [0|65535] "" DUT
+ SG_ Yaw m2 : 24|16@1- (1,0) [-32768|32767] "" DUT
+
+BO_ 768 DUT_Status: 8 DUT
+ SG_ Alive : 0|8@1+ (1,0) [0|255] "" BCM
+
+BA_ "GenMsgCycleTime" BO_ 256 20;
+BA_ "GenMsgCycleTime" BO_ 512 50;
+BA_ "GenMsgCycleTime" BO_ 768 10;
+BA_ "GenSigStartValue" SG_ 256 DoorState 3;
+BA_ "GenSigStartValue" SG_ 256 Brightness 100;
+BA_ "GenSigStartValue" SG_ 512 VehicleSpeed 5000;
+BA_ "GenSigStartValue" SG_ 512 Page 2;
+BA_ "GenSigStartValue" SG_ 512 Yaw 65535;
+)";
+
+// ============================================================================
+// Fixture
+// ============================================================================
+
+class RestBusSimulationTest : public CANSlotFixture
+{
+protected:
+    void SetUp() override
+    {
+        m_database = std::make_shared<DBCDatabase>(DBCParser().parseString(NETWORK_DBC));
+        ASSERT_EQ(m_database->messages.size(), 4);
+        ASSERT_NO_FATAL_FAILURE(openSlots("t_restbus", {"RB 1", "RB 2"}));
+    }
+
+    void TearDown() override
+    {
+        RestBusManager::instance().stopAll();
+        CANSlotFixture::TearDown();
+    }
+
+    static RestBusSimulation::Options options(const QStringList& nodes)
+    {
+        RestBusSimulation::Options options;
+        options.slot  = "RB 1";
+        options.nodes = nodes;
+        return options;
+    }
+
+    /// Frames received on RB 2 within the given time, by ID
+    static QMap<uint32_t, QList<CANMessage>> receiveFor(int ms)
+    {
+        QMap<uint32_t, QList<CANMessage>> frames;
+        QThread::msleep(ms);
+        CANMessage msg;
+        while (can().receive("RB 2", msg, 0).success)
+            frames[msg.id].append(msg);
+        return frames;
+    }
+
+    std::shared_ptr<DBCDatabase> m_database;
+};
+
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+TEST_F(RestBusSimulationTest, SendsSelectedNodesAtTheirCycleTimes)
+{
+    RestBusSimulation sim(m_database, options({"BCM", "ESC"}));
+    ASSERT_TRUE(sim.start().success);
+    EXPECT_FALSE(sim.start().success);
+    EXPECT_EQ(sim.messageNames(), QStringList({"BCM_Status", "ESC_Speed"}));
+
+    receiveFor(20);                         // Skip the staggered start
+    const auto frames = receiveFor(500);
+    EXPECT_NEAR(frames.value(0x100).size(), 25, 3);
+    EXPECT_NEAR(frames.value(0x200).size(), 10, 2);
+    EXPECT_FALSE(frames.contains(0x101));   // No cycle time
+    EXPECT_FALSE(frames.contains(0x300));   // Node not simulated
+
+    RestBusSimulation::Stats stats;
+    sim.stop(&stats);
+    EXPECT_EQ(stats.messages, 2);
+    EXPECT_EQ(stats.skipped, 1);
+    EXPECT_EQ(stats.errors, 0u);
+    ASSERT_EQ(stats.messageStats.size(), 2);
+    EXPECT_EQ(stats.messageStats[1].periodMs, 50);
+    EXPECT_EQ(stats.sent, stats.messageStats[0].sent + stats.messageStats[1].sent);
+    EXPECT_GE(stats.sent, 35u);
+
+    CANMessage rest;
+    receiveFor(60);
+    EXPECT_FALSE(can().receive("RB 2", rest, 100).success);
+}
+
+TEST_F(RestBusSimulationTest, DefaultCycleAndExclusions)
+{
+    RestBusSimulation::Options opts = options({"BCM"});
+    opts.defaultCycleMs = 10;
+    opts.excludedMessages = {"BCM_Status"};
+    RestBusSimulation sim(m_database, opts);
+    ASSERT_TRUE(sim.start().success);
+    EXPECT_EQ(sim.messageNames(), QStringList({"BCM_Event"}));
+
+    const auto frames = receiveFor(100);
+    EXPECT_GE(frames.value(0x101).size(), 5);
+    ASSERT_FALSE(frames.value(0x101).isEmpty());
+    EXPECT_EQ(frames.value(0x101).first().dlc, 2);
+}
+
+TEST_F(RestBusSimulationTest, RejectsUnknownNodesAndEmptySelections)
+{
+    EXPECT_FALSE(RestBusSimulation(m_database, options({"Gateway"})).start().success);
+
+    RestBusSimulation::Options opts = options({"BCM"});
+    opts.excludedMessages = {"BCM_Status"};
+    EXPECT_FALSE(RestBusSimulation(m_database, opts).start().success);     // Only an event message left
+
+    opts = options({"ESC"});
+    opts.slot = "RB 9";
+    EXPECT_FALSE(RestBusSimulation(m_database, opts).start().success);
+}
+
+// ============================================================================
+// Payloads
+// ============================================================================
+
+TEST_F(RestBusSimulationTest, TemplatesHoldStartValues)
+{
+    RestBusSimulation sim(m_database, options({}));    // Every named sender
+    ASSERT_TRUE(sim.start().success);
+    EXPECT_EQ(sim.messageNames(), QStringList({"BCM_Status", "ESC_Speed", "DUT_Status"}));
+
+    CANMessage frame;
+    ASSERT_TRUE(sim.frame("BCM_Status", frame));
+    EXPECT_EQ(frame.data[0], 3);
+    EXPECT_EQ(frame.data[1], 100);
+
+    // Multiplexor page 2 → Yaw is encoded, WheelFL is not
+    ASSERT_TRUE(sim.frame("ESC_Speed", frame));
+    EXPECT_EQ(frame.data[0], 0x88);         // 5000 = 0x1388
+    EXPECT_EQ(frame.data[1], 0x13);
+    EXPECT_EQ(frame.data[2], 2);
+    EXPECT_EQ(frame.data[3], 0xFF);
+    EXPECT_EQ(frame.data[4], 0xFF);
+
+    const auto frames = receiveFor(60);
+    ASSERT_FALSE(frames.value(0x100).isEmpty());
+    EXPECT_EQ(frames.value(0x100).last().data[1], 100);
+    EXPECT_FALSE(sim.frame("BCM_Event", frame));
+}
+
+TEST_F(RestBusSimulationTest, OverridesReencodeOnlyChangedSignals)
+{
+    RestBusSimulation sim(m_database, options({"BCM", "ESC"}));
+    ASSERT_TRUE(sim.start().success);
+
+    ASSERT_TRUE(sim.setSignal("BCM_Status", "Brightness", 20.0).success);
+    receiveFor(30);                         // Frames queued before the update
+    auto frames = receiveFor(60);
+    ASSERT_FALSE(frames.value(0x100).isEmpty());
+    for (const CANMessage& msg : frames.value(0x100)) {
+        EXPECT_EQ(msg.data[0], 3);          // Untouched start value
+        EXPECT_EQ(msg.data[1], 40);
+    }
+
+    // A multiplexed signal switches the multiplexor to its page
+    ASSERT_TRUE(sim.setSignals("ESC_Speed", {{"VehicleSpeed", 1.0}, {"WheelFL", 0x1234}}).success);
+    CANMessage frame;
+    ASSERT_TRUE(sim.frame("ESC_Speed", frame));
+    EXPECT_EQ(frame.data[0], 100);
+    EXPECT_EQ(frame.data[1], 0);
+    EXPECT_EQ(frame.data[2], 1);
+    EXPECT_EQ(frame.data[3], 0x34);
+    EXPECT_EQ(frame.data[4], 0x12);
+
+    // Unknown names fail without touching the payload
+    EXPECT_FALSE(sim.setSignals("ESC_Speed", {{"VehicleSpeed", 2.0}, {"Typo", 0.0}}).success);
+    EXPECT_FALSE(sim.setSignal("DUT_Status", "Alive", 1.0).success);
+    ASSERT_TRUE(sim.frame("ESC_Speed", frame));
+    EXPECT_EQ(frame.data[0], 100);
+
+    ASSERT_TRUE(sim.resetSignals().success);
+    ASSERT_TRUE(sim.frame("BCM_Status", frame));
+    EXPECT_EQ(frame.data[1], 100);
+    ASSERT_TRUE(sim.frame("ESC_Speed", frame));
+    EXPECT_EQ(frame.data[2], 2);
+    EXPECT_EQ(sim.stats().signalUpdates, 3u);
+}
+
+// ============================================================================
+// RestBusManager
+// ============================================================================
+
+TEST_F(RestBusSimulationTest, ManagerRunsOneSimulationPerSlot)
+{
+    auto& restBus = RestBusManager::instance();
+    EXPECT_FALSE(restBus.start(options({"ESC"}), nullptr).success);
+    ASSERT_TRUE(restBus.start(options({"ESC"}), m_database).success);
+    EXPECT_FALSE(restBus.start(options({"BCM"}), m_database).success);
+
+    auto sim = restBus.simulation("RB 1");
+    ASSERT_NE(sim, nullptr);
+    EXPECT_TRUE(sim->stats().running);
+    EXPECT_EQ(restBus.simulation("RB 2"), nullptr);
+
+    receiveFor(120);
+    RestBusSimulation::Stats stats;
+    ASSERT_TRUE(restBus.stop("RB 1", &stats).success);
+    EXPECT_GE(stats.sent, 2u);
+    EXPECT_FALSE(sim->stats().running);
+    EXPECT_FALSE(restBus.stop("RB 1").success);
+}
@@ -0,0 +1,198 @@
+/**
+ * @file tst_SocketCANDriver.cpp
+ * @brief Unit tests for SocketCANDriver — open / transmit / receive between
+ *        two sockets on vcan0, TX confirmation and error-frame mapping.
+ *
+ * The tests need a virtual CAN link and are skipped when none is present:
+ *
+ *     sudo modprobe vcan
+ *     sudo ip link add dev vcan0 type vcan
+ *     sudo ip link set vcan0 up
+ */
+
+#include <gtest/gtest.h>
+#include "SocketCANDriver.h"
+
+#include <cstring>
+#include <vector>
+
+#include <linux/can.h>
+#include <linux/can/error.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace CANManager;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static const char* VCAN_NAME = "vcan0";
+
+static CANChannelInfo vcanChannel()
+{
+    CANChannelInfo ch;
+    ch.name = QString::fromLatin1(VCAN_NAME);
+    return ch;
+}
+
+static CANMessage makeFrame(uint32_t id, int len = 8, bool extended = false)
+{
+    CANMessage msg;
+    msg.id = id;
+    msg.dlc = static_cast<uint8_t>(len);
+    msg.isExtended = extended;
+    for (int i = 0; i < len; ++i)
+        msg.data[i] = static_cast<uint8_t>(i + 1);
+    return msg;
+}
+
+/// Two drivers open on vcan0; skipped when the link does not exist.
+class SocketCANDriverTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        if (!a.isAvailable() || ::if_nametoindex(VCAN_NAME) == 0)
+            GTEST_SKIP() << "no " << VCAN_NAME << " link";
+
+        CANBusConfig cfg;
+        ASSERT_TRUE(a.initialize());
+        ASSERT_TRUE(b.initialize());
+        ASSERT_TRUE(a.openChannel(vcanChannel(), cfg).success);
+        ASSERT_TRUE(b.openChannel(vcanChannel(), cfg).success);
+        a.flushReceiveQueue();
+        b.flushReceiveQueue();
+    }
+
+    /// Next frame that is not our own TX confirmation
+    bool receiveForeign(SocketCANDriver& drv, CANMessage& msg)
+    {
+        while (drv.receive(msg, 1000).success) {
+            if (!msg.isTxConfirm)
+                return true;
+        }
+        return false;
+    }
+
+    SocketCANDriver a, b;
+};
+
+// ============================================================================
+// Open / transmit / receive
+// ============================================================================
+
+TEST(SocketCANDriver, OpenUnknownInterfaceFails)
+{
+    SocketCANDriver drv;
+    if (!drv.isAvailable())
+        GTEST_SKIP() << "PF_CAN sockets not supported";
+
+    CANChannelInfo ch;
+    ch.name = "nocan_if9";
+    EXPECT_FALSE(drv.openChannel(ch, CANBusConfig()).success);
+    EXPECT_FALSE(drv.isOpen());
+}
+
+TEST_F(SocketCANDriverTest, OpenTwiceFails)
+{
+    EXPECT_TRUE(a.isOpen());
+    EXPECT_FALSE(a.openChannel(vcanChannel(), CANBusConfig()).success);
+}
+
+TEST_F(SocketCANDriverTest, FrameReachesPeerAndIsConfirmedToSender)
+{
+    ASSERT_TRUE(a.transmit(makeFrame(0x123, 5)).success);
+
+    CANMessage rx;
+    ASSERT_TRUE(receiveForeign(b, rx));
+    EXPECT_EQ(rx.id, 0x123u);
+    EXPECT_FALSE(rx.isExtended);
+    EXPECT_FALSE(rx.isError);
+    EXPECT_EQ(rx.dlc, 5);
+    for (int i = 0; i < 5; ++i)
+        EXPECT_EQ(rx.data[i], i + 1);
+    EXPECT_NE(rx.timestamp, 0u);
+
+    CANMessage echo;
+    ASSERT_TRUE(a.receive(echo, 1000).success);
+    EXPECT_TRUE(echo.isTxConfirm);
+    EXPECT_EQ(echo.id, 0x123u);
+}
+
+TEST_F(SocketCANDriverTest, ExtendedAndBatchedFrames)
+{
+    std::vector<CANMessage> tx;
+    for (uint32_t i = 0; i < 10; ++i)
+        tx.push_back(makeFrame(0x18DA0000u + i, 8, true));
+    int sent = 0;
+    ASSERT_TRUE(a.transmitBatch(tx, sent).success);
+    EXPECT_EQ(sent, 10);
+
+    for (uint32_t i = 0; i < 10; ++i) {
+        CANMessage rx;
+        ASSERT_TRUE(receiveForeign(b, rx)) << i;
+        EXPECT_TRUE(rx.isExtended);
+        EXPECT_EQ(rx.id, 0x18DA0000u + i);
+    }
+}
+
+TEST_F(SocketCANDriverTest, FdFrameOnClassicChannelIsRejected)
+{
+    CANMessage fd = makeFrame(0x124, 8);
+    fd.isFD = true;
+    fd.dlc  = 15;                               // 64 bytes; would be cut to 8
+
+    const CANResult single = a.transmit(fd);
+    EXPECT_FALSE(single.success);
+    EXPECT_TRUE(single.errorMessage.contains("without FD"));
+
+    // The whole batch is refused before any frame goes out
+    const std::vector<CANMessage> tx = {makeFrame(0x123, 8), fd};
+    int sent = -1;
+    EXPECT_FALSE(a.transmitBatch(tx, sent).success);
+    EXPECT_EQ(sent, 0);
+
+    CANMessage rx;
+    EXPECT_FALSE(b.receive(rx, 50).success);
+}
+
+TEST_F(SocketCANDriverTest, ReceiveTimesOutWhenIdle)
+{
+    CANMessage rx;
+    EXPECT_FALSE(b.receive(rx, 50).success);
+}
+
+// ============================================================================
+// Error frames
+// ============================================================================
+
+TEST_F(SocketCANDriverTest, ErrorFramesAreFlaggedWithMaskedClass)
+{
+    // Controller error frames come from the kernel; on vcan we inject one
+    // through a raw socket
+    const int fd = ::socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    ASSERT_GE(fd, 0);
+    struct sockaddr_can addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.can_family  = AF_CAN;
+    addr.can_ifindex = static_cast<int>(::if_nametoindex(VCAN_NAME));
+    ASSERT_EQ(::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)), 0);
+
+    struct can_frame frame;
+    std::memset(&frame, 0, sizeof(frame));
+    frame.can_id = CAN_ERR_FLAG | CAN_ERR_BUSOFF | CAN_ERR_CRTL;
+    frame.len = CAN_ERR_DLC;
+    frame.data[1] = CAN_ERR_CRTL_TX_PASSIVE;
+    ASSERT_EQ(::write(fd, &frame, sizeof(frame)), static_cast<ssize_t>(sizeof(frame)));
+    ::close(fd);
+
+    CANMessage rx;
+    ASSERT_TRUE(receiveForeign(b, rx));
+    EXPECT_TRUE(rx.isError);
+    EXPECT_EQ(rx.id, static_cast<uint32_t>(CAN_ERR_BUSOFF | CAN_ERR_CRTL));
+    EXPECT_EQ(rx.dlc, CAN_ERR_DLC);
+    EXPECT_EQ(rx.data[1], CAN_ERR_CRTL_TX_PASSIVE);
+}
@@ -0,0 +1,339 @@
+/**
+ * @file tst_Station.cpp
+ * @brief Unit tests for test stations — per-station engine and hardware,
+ *        CAN slot namespacing, Station::current(), concurrent runs and the
+ *        shared flight recorder.
+ */
+
+#include <gtest/gtest.h>
+#include "Station.h"
+#include "FlightRecorder.h"
+#include "TestExecutorEngine.h"
+#include "TestRepository.h"
+#include "HWConfigManager.h"
+#include <SerialManager.h>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QThread>
+#include <atomic>
+#include <thread>
+
+using namespace TestExecutor;
+
+// ============================================================================
+// Fixture
+// ============================================================================
+
+class StationTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        if (!QCoreApplication::instance()) {
+            static int argc = 1;
+            static char arg0[] = "test";
+            static char* argv[] = {arg0, nullptr};
+            static QCoreApplication app(argc, argv);
+        }
+    }
+
+    void TearDown() override
+    {
+        auto& stations = StationManager::instance();
+        for (const QString& name : stations.stationNames()) {
+            if (name != Station::DEFAULT_NAME)
+                stations.removeStation(name);
+        }
+    }
+
+    StationManager& stations() { return StationManager::instance(); }
+};
+
+/// Waits until the engine's session has finished
+static bool waitIdle(TestExecutorEngine& engine, int timeoutMs = 10000)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (engine.isRunning()) {
+        if (timer.elapsed() > timeoutMs)
+            return false;
+        QThread::msleep(10);
+    }
+    return true;
+}
+
+// ============================================================================
+// Default station
+// ============================================================================
+
+TEST_F(StationTest, DefaultStationWrapsSingletons)
+{
+    Station& station = stations().defaultStation();
+    EXPECT_TRUE(station.isDefault());
+    EXPECT_EQ(station.name(), Station::DEFAULT_NAME);
+    EXPECT_EQ(&station.engine(), &TestExecutorEngine::instance());
+    EXPECT_EQ(&station.hwConfig(), &HWConfigManager::instance());
+    EXPECT_EQ(&station.serial(), &SerialManager::SerialPortManager::instance());
+    EXPECT_EQ(&TestExecutorEngine::instance().station(), &station);
+
+    // Single-station setups keep their slot names
+    EXPECT_EQ(station.canSlot("CAN 1"), "CAN 1");
+}
+
+TEST_F(StationTest, DefaultStationCannotBeRemoved)
+{
+    EXPECT_FALSE(stations().removeStation(Station::DEFAULT_NAME));
+    EXPECT_EQ(stations().stationNames().first(), Station::DEFAULT_NAME);
+}
+
+// ============================================================================
+// Additional stations
+// ============================================================================
+
+TEST_F(StationTest, AddedStationOwnsEngineAndHardware)
+{
+    Station* station = stations().addStation("Fixture B");
+    ASSERT_NE(station, nullptr);
+    Station& fallback = stations().defaultStation();
+
+    EXPECT_FALSE(station->isDefault());
+    EXPECT_NE(&station->engine(), &fallback.engine());
+    EXPECT_NE(&station->hwConfig(), &fallback.hwConfig());
+    EXPECT_NE(&station->serial(), &fallback.serial());
+    EXPECT_EQ(&station->engine().station(), station);
+    EXPECT_EQ(station->hwConfig().settingsGroup(), "Stations/Fixture B/HWConfig");
+
+    EXPECT_EQ(station->canSlot("CAN 1"), "Fixture B/CAN 1");
+    EXPECT_EQ(stations().station("Fixture B"), station);
+    EXPECT_EQ(stations().stationNames(), QStringList({Station::DEFAULT_NAME, "Fixture B"}));
+}
+
+TEST_F(StationTest, InvalidOrDuplicateNamesRejected)
+{
+    ASSERT_NE(stations().addStation("Fixture B"), nullptr);
+    EXPECT_EQ(stations().addStation("Fixture B"), nullptr);
+    EXPECT_EQ(stations().addStation(Station::DEFAULT_NAME), nullptr);
+    EXPECT_EQ(stations().addStation("  "), nullptr);
+    EXPECT_EQ(stations().addStation("Line/2"), nullptr);
+    EXPECT_EQ(stations().stationNames().size(), 2);
+}
+
+TEST_F(StationTest, ConcurrentAddsOfOneNameKeepOneStation)
+{
+    std::atomic<bool> go{false};
+    Station* added[2] = {nullptr, nullptr};
+    std::vector<std::thread> threads;
+    for (Station*& result : added) {
+        threads.emplace_back([&go, &result, this]() {
+            while (!go.load())
+                std::this_thread::yield();
+            result = stations().addStation("Fixture C");
+        });
+    }
+    go = true;
+    for (std::thread& thread : threads)
+        thread.join();
+
+    EXPECT_NE(added[0] == nullptr, added[1] == nullptr);
+    EXPECT_EQ(stations().stationNames().count("Fixture C"), 1);
+}
+
+TEST_F(StationTest, RemovingSelectedStationSelectsDefault)
+{
+    ASSERT_NE(stations().addStation("Fixture B"), nullptr);
+    stations().selectStation("Fixture B");
+    EXPECT_EQ(stations().selectedStation().name(), "Fixture B");
+
+    stations().selectStation("Unknown");
+    EXPECT_EQ(stations().selectedStation().name(), "Fixture B");
+
+    EXPECT_TRUE(stations().removeStation("Fixture B"));
+    EXPECT_EQ(stations().station("Fixture B"), nullptr);
+    EXPECT_TRUE(stations().selectedStation().isDefault());
+}
+
+// ============================================================================
+// Station::current()
+// ============================================================================
+
+TEST_F(StationTest, CurrentFollowsScopeOnThisThreadOnly)
+{
+    Station* b = stations().addStation("Fixture B");
+    Station* c = stations().addStation("Fixture C");
+    ASSERT_NE(b, nullptr);
+    ASSERT_NE(c, nullptr);
+
+    EXPECT_TRUE(Station::current().isDefault());
+    {
+        Station::Scope outer(*b);
+        EXPECT_EQ(&Station::current(), b);
+        {
+            Station::Scope inner(*c);
+            EXPECT_EQ(&Station::current(), c);
+        }
+        EXPECT_EQ(&Station::current(), b);
+
+        Station* seenElsewhere = nullptr;
+        std::thread other([&]() { seenElsewhere = &Station::current(); });
+        other.join();
+        EXPECT_EQ(seenElsewhere, &stations().defaultStation());
+    }
+    EXPECT_TRUE(Station::current().isDefault());
+}
+
+// ============================================================================
+// Concurrent execution
+// ============================================================================
+
+TEST_F(StationTest, StationsRunSessionsConcurrently)
+{
+    // Both steps must be in flight at once to pass
+    static std::atomic<int> active{0};
+    static std::atomic<int> peak{0};
+    active = 0;
+    peak = 0;
+
+    auto& registry = CommandRegistry::instance();
+    TestExecutorEngine::instance();                     // Registers the builtin commands
+    CommandDef probe;
+    probe.id = "station_probe";
+    probe.name = "Station Probe";
+    probe.description = "Reports the station the step runs for";
+    probe.category = CommandCategory::System;
+    probe.handler = [](const QVariantMap&, const QVariantMap&, const std::atomic<bool>*) {
+        const int now = ++active;
+        int seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+        QElapsedTimer timer;
+        timer.start();
+        while (peak.load() < 2 && timer.elapsed() < 2000)
+            QThread::msleep(5);
+        --active;
+        QVariantMap data;
+        data["serial"] = QVariant::fromValue(reinterpret_cast<quintptr>(&Station::current().serial()));
+        return CommandResult::Success(Station::current().name(), data);
+    };
+    registry.registerCommand(probe);
+
+    TestStep step;
+    step.id = TestStep::generateId();
+    step.category = CommandCategory::System;
+    step.command = "station_probe";
+    TestCase testCase;
+    testCase.id = "TC_STATION_PROBE";
+    testCase.name = "Station probe";
+    testCase.steps.append(step);
+    TestRepository::instance().addTestCase(testCase);
+
+    Station* b = stations().addStation("Fixture B");
+    ASSERT_NE(b, nullptr);
+    Station& a = stations().defaultStation();
+    for (Station* station : {&a, b}) {
+        TestConfiguration config = station->engine().configuration();
+        config.stepDelayMs = 0;
+        config.flightRecorderEnabled = false;
+        config.autoGenerateReport = false;
+        station->engine().setConfiguration(config);
+    }
+
+    a.engine().runTests({testCase.id});
+    b->engine().runTests({testCase.id});
+    ASSERT_TRUE(waitIdle(a.engine()));
+    ASSERT_TRUE(waitIdle(b->engine()));
+    EXPECT_EQ(peak.load(), 2);
+
+    for (Station* station : {&a, b}) {
+        const TestSession* session = station->engine().currentSession();
+        ASSERT_NE(session, nullptr);
+        ASSERT_EQ(session->results.size(), 1);
+        ASSERT_EQ(session->results[0].stepResults.size(), 1);
+        const TestStep& result = session->results[0].stepResults[0];
+        EXPECT_EQ(result.status, TestStatus::Passed) << result.resultMessage.toStdString();
+        EXPECT_EQ(result.resultMessage, station->name());
+        EXPECT_EQ(result.responseData.value("serial").value<quintptr>(),
+                  reinterpret_cast<quintptr>(&station->serial()));
+    }
+
+    TestRepository::instance().removeTestCase(testCase.id);
+}
+
+TEST_F(StationTest, StationWithoutRecorderLeavesOthersCapturing)
+{
+    // Station A's step fails only once B has run a whole session
+    static std::atomic<bool> aInStep{false};
+    static std::atomic<bool> bDone{false};
+    aInStep = false;
+    bDone = false;
+
+    auto& registry = CommandRegistry::instance();
+    TestExecutorEngine::instance();                     // Registers the builtin commands
+    CommandDef gate;
+    gate.id = "station_recorder_gate";
+    gate.name = "Station Recorder Gate";
+    gate.description = "Fails on the default station once the other station is done";
+    gate.category = CommandCategory::System;
+    gate.handler = [](const QVariantMap&, const QVariantMap&, const std::atomic<bool>*) {
+        if (!Station::current().isDefault())
+            return CommandResult::Success();
+        aInStep = true;
+        QElapsedTimer timer;
+        timer.start();
+        while (!bDone.load() && timer.elapsed() < 5000)
+            QThread::msleep(5);
+        return CommandResult::Failure("Capture wanted");
+    };
+    registry.registerCommand(gate);
+
+    TestStep step;
+    step.id = TestStep::generateId();
+    step.category = CommandCategory::System;
+    step.command = "station_recorder_gate";
+    TestCase testCase;
+    testCase.id = "TC_STATION_RECORDER";
+    testCase.name = "Station recorder";
+    testCase.steps.append(step);
+    TestRepository::instance().addTestCase(testCase);
+
+    QTemporaryDir reports;
+    ASSERT_TRUE(reports.isValid());
+    Station* b = stations().addStation("Fixture B");
+    ASSERT_NE(b, nullptr);
+    Station& a = stations().defaultStation();
+    for (Station* station : {&a, b}) {
+        TestConfiguration config = station->engine().configuration();
+        config.stepDelayMs = 0;
+        config.autoGenerateReport = false;
+        config.reportOutputPath = reports.path();
+        config.flightRecorderEnabled = station == &a;
+        config.flightRecorderPreTriggerS = 1;
+        config.flightRecorderPostTriggerS = 0;
+        station->engine().setConfiguration(config);
+    }
+
+    a.engine().runTests({testCase.id});
+    QElapsedTimer timer;
+    timer.start();
+    while (!aInStep.load() && timer.elapsed() < 5000)
+        QThread::msleep(5);
+    ASSERT_TRUE(aInStep.load());
+
+    // B neither stops nor restarts the recorder A's session is using
+    b->engine().runTests({testCase.id});
+    EXPECT_TRUE(waitIdle(b->engine()));
+    EXPECT_TRUE(FlightRecorder::instance().isRunning());
+    bDone = true;
+    ASSERT_TRUE(waitIdle(a.engine()));
+
+    const TestSession* session = a.engine().currentSession();
+    ASSERT_NE(session, nullptr);
+    ASSERT_EQ(session->results.size(), 1);
+    ASSERT_EQ(session->results[0].stepResults.size(), 1);
+    const QString dump = session->results[0].stepResults[0].flightRecordPath;
+    EXPECT_FALSE(dump.isEmpty());
+    EXPECT_TRUE(QDir(dump).exists());          // Written before A's session completed
+
+    FlightRecorder::instance().stop();
+    TestRepository::instance().removeTestCase(testCase.id);
+}
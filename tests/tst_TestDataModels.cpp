@@ -202,6 +202,7 @@ TEST(TestDataModels, TestResult_JsonRoundTrip)
     sr.resultMessage = "OK";
     sr.durationMs = 1000;
     sr.responseData = {{"key", "value"}};
+    sr.flightRecordPath = "/tmp/session/flight_recorder/TC_001_step1";
     result.stepResults.append(sr);
 
     QJsonObject json = result.toJson();
@@ -226,6 +227,7 @@ TEST(TestDataModels, TestResult_JsonRoundTrip)
     EXPECT_EQ(restored.stepResults[0].status, TestStatus::Passed);
     EXPECT_EQ(restored.stepResults[0].resultMessage, "OK");
     EXPECT_EQ(restored.stepResults[0].durationMs, 1000);
+    EXPECT_EQ(restored.stepResults[0].flightRecordPath, "/tmp/session/flight_recorder/TC_001_step1");
 }
 
 TEST(TestDataModels, TestResult_StatusStringRoundTrip)
@@ -0,0 +1,457 @@
+/**
+ * @file tst_UdsClient.cpp
+ * @brief Unit tests for UdsClient — typed services, multi-DID reads,
+ *        response pending (NRC 0x78), negative responses, session timing,
+ *        security access hooks, background tester present and the
+ *        CANBusManager client cache.
+ *
+ * The ECU is an ISO-TP channel on a second slot of the same virtual bus,
+ * answering from its own thread through a per-test handler.
+ */
+
+#include <gtest/gtest.h>
+#include "CANManager.h"
+#include "CANSlotFixture.h"
+#include "UdsClient.h"
+#include "VirtualCANDriver.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace CANManager;
+
+namespace {
+
+QByteArray hex(const char* text)
+{
+    return QByteArray::fromHex(text);
+}
+
+/// Answers requests on the ECU slot until destroyed
+class SimulatedEcu
+{
+public:
+    using Handler = std::function<void(const QByteArray& request, CANIsoTpChannel& channel)>;
+
+    SimulatedEcu(const CANIsoTpChannel::Config& config, Handler handler)
+        : m_channel(config)
+        , m_handler(std::move(handler))
+    {
+        EXPECT_TRUE(m_channel.open().success);
+        m_thread = std::thread([this]() {
+            while (!m_stop.load()) {
+                QByteArray request;
+                if (!m_channel.receive(request, 20).success)
+                    continue;
+                m_requests.fetch_add(1);
+                if (request == hex("3e80"))
+                    m_testerPresents.fetch_add(1);
+                else
+                    m_handler(request, m_channel);
+            }
+        });
+    }
+
+    ~SimulatedEcu()
+    {
+        m_stop.store(true);
+        m_thread.join();
+    }
+
+    int requests() const       { return m_requests.load(); }
+    int testerPresents() const { return m_testerPresents.load(); }
+
+private:
+    CANIsoTpChannel   m_channel;
+    Handler           m_handler;
+    std::thread       m_thread;
+    std::atomic<bool> m_stop{false};
+    std::atomic<int>  m_requests{0};
+    std::atomic<int>  m_testerPresents{0};
+};
+
+} // namespace
+
+class UdsClientTest : public CANSlotFixture
+{
+protected:
+    static constexpr const char* TESTER = "Uds Tester";
+    static constexpr const char* ECU    = "Uds ECU";
+
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(openSlots("t_uds", {TESTER, ECU}));
+    }
+
+    void TearDown() override
+    {
+        m_client.reset();
+        m_ecu.reset();
+        CANSlotFixture::TearDown();
+    }
+
+    static UdsClient::Config clientConfig()
+    {
+        UdsClient::Config config;
+        config.transport.slotName = TESTER;
+        config.transport.txId = 0x7E0;
+        config.transport.rxId = 0x7E8;
+        config.p2Ms = 100;
+        config.p2StarMs = 500;
+        return config;
+    }
+
+    void start(SimulatedEcu::Handler handler, const UdsClient::Config& config = clientConfig())
+    {
+        CANIsoTpChannel::Config ecu;
+        ecu.slotName = ECU;
+        ecu.txId = 0x7E8;
+        ecu.rxId = 0x7E0;
+        m_ecu = std::make_unique<SimulatedEcu>(ecu, std::move(handler));
+        m_client = std::make_unique<UdsClient>(config);
+        ASSERT_TRUE(m_client->open().success);
+    }
+
+    std::unique_ptr<SimulatedEcu> m_ecu;
+    std::unique_ptr<UdsClient>    m_client;
+};
+
+TEST_F(UdsClientTest, ReadsManyDidsInBatches)
+{
+    // DID n answers with n & 0xFF repeated (n % 5 + 1) times
+    const auto didValue = [](uint16_t did) { return QByteArray(did % 5 + 1, static_cast<char>(did & 0xFF)); };
+    std::atomic<int> reads{0};
+    UdsClient::Config config = clientConfig();
+    config.maxDidsPerRequest = 8;
+    start([&](const QByteArray& request, CANIsoTpChannel& channel) {
+        ++reads;
+        QByteArray response = hex("62");
+        for (qsizetype pos = 1; pos + 1 < request.size(); pos += 2) {
+            const uint16_t did = static_cast<uint16_t>((static_cast<uint8_t>(request[pos]) << 8)
+                                                       | static_cast<uint8_t>(request[pos + 1]));
+            response.append(request.mid(pos, 2));
+            response.append(didValue(did));
+        }
+        channel.send(response);
+    }, config);
+
+    QList<uint16_t> dids;
+    for (uint16_t did = 0xF100; did < 0xF100 + 30; ++did) {
+        dids.append(did);
+        m_client->setDidLength(did, static_cast<int>(didValue(did).size()));
+    }
+    // Unknown lengths end a request
+    m_client->setDidLength(0xF105, 0);
+    m_client->setDidLength(0xF10A, 0);
+
+    QMap<uint16_t, QByteArray> values;
+    const CANResult result = m_client->readDataByIdentifier(dids, values);
+    ASSERT_TRUE(result.success) << result.errorMessage.toStdString();
+    EXPECT_EQ(reads.load(), 5);                              // 6 + 5 + 8 + 8 + 3 DIDs
+    ASSERT_EQ(values.size(), 30);
+    for (uint16_t did : dids)
+        EXPECT_EQ(values.value(did), didValue(did)) << std::hex << did;
+}
+
+TEST_F(UdsClientTest, DidsOfUnknownLengthAreReadOneByOne)
+{
+    // The value of F190 contains the identifier of the next DID
+    QList<QByteArray> requests;
+    start([&](const QByteArray& request, CANIsoTpChannel& channel) {
+        requests.append(request);
+        QByteArray response = hex("62");
+        for (qsizetype pos = 1; pos + 1 < request.size(); pos += 2) {
+            response.append(request.mid(pos, 2));
+            response.append(request.mid(pos, 2) == hex("f190") ? hex("01f19102") : hex("aabb"));
+        }
+        channel.send(response);
+    });
+
+    QMap<uint16_t, QByteArray> values;
+    const CANResult result = m_client->readDataByIdentifier({0xF190, 0xF191}, values);
+    ASSERT_TRUE(result.success) << result.errorMessage.toStdString();
+    EXPECT_EQ(values.value(0xF190), hex("01f19102"));
+    EXPECT_EQ(values.value(0xF191), hex("aabb"));
+    EXPECT_EQ(requests, QList<QByteArray>({hex("22f190"), hex("22f191")}));
+
+    // With its length known both go into one request
+    requests.clear();
+    values.clear();
+    m_client->setDidLength(0xF190, 4);
+    ASSERT_TRUE(m_client->readDataByIdentifier({0xF190, 0xF191}, values).success);
+    EXPECT_EQ(values.value(0xF190), hex("01f19102"));
+    EXPECT_EQ(values.value(0xF191), hex("aabb"));
+    EXPECT_EQ(requests, QList<QByteArray>({hex("22f190f191")}));
+}
+
+TEST_F(UdsClientTest, LengthsGivenWithAReadApplyToItOnly)
+{
+    QList<QByteArray> requests;
+    start([&](const QByteArray& request, CANIsoTpChannel& channel) {
+        requests.append(request);
+        QByteArray response = hex("62");
+        for (qsizetype pos = 1; pos + 1 < request.size(); pos += 2) {
+            response.append(request.mid(pos, 2));
+            response.append(hex("aabb"));
+        }
+        channel.send(response);
+    });
+
+    QMap<uint16_t, QByteArray> values;
+    ASSERT_TRUE(m_client->readDataByIdentifier({0xF190, 0xF191}, {{0xF190, 2}}, values).success);
+    EXPECT_EQ(values.value(0xF190), hex("aabb"));
+    EXPECT_EQ(values.value(0xF191), hex("aabb"));
+    EXPECT_EQ(requests, QList<QByteArray>({hex("22f190f191")}));
+
+    // The client does not keep them
+    requests.clear();
+    ASSERT_TRUE(m_client->readDataByIdentifier({0xF190, 0xF191}, values).success);
+    EXPECT_EQ(requests, QList<QByteArray>({hex("22f190"), hex("22f191")}));
+}
+
+TEST_F(UdsClientTest, ResponsePendingExtendsTheTimeoutWithoutResending)
+{
+    start([](const QByteArray& request, CANIsoTpChannel& channel) {
+        if (request == hex("3101ff00")) {
+            // Three pending responses, each later than P2 but within P2*
+            for (int i = 0; i < 3; ++i) {
+                channel.send(hex("7f3178"));
+                QThread::msleep(150);
+            }
+            channel.send(hex("7101ff0000"));
+        } else {
+            channel.send(hex("7f3131"));
+        }
+    });
+
+    UdsClient::Response response;
+    CANResult result = m_client->routineControl(0x01, 0xFF00, {}, response);
+    ASSERT_TRUE(result.success) << result.errorMessage.toStdString();
+    EXPECT_TRUE(response.positive);
+    EXPECT_EQ(response.pendingCount, 3);
+    EXPECT_EQ(response.data, hex("7101ff0000"));
+    EXPECT_GE(response.elapsedMs, 400.0);
+    EXPECT_EQ(m_ecu->requests(), 1);
+
+    result = m_client->routineControl(0x01, 0x1234, hex("aa"), response);
+    EXPECT_FALSE(result.success);
+    EXPECT_FALSE(response.positive);
+    EXPECT_EQ(response.nrc, 0x31);
+    EXPECT_TRUE(result.errorMessage.contains("requestOutOfRange"));
+}
+
+TEST_F(UdsClientTest, TimesOutAfterP2)
+{
+    start([](const QByteArray&, CANIsoTpChannel&) {});          // Never answers
+
+    UdsClient::Response response;
+    const CANResult result = m_client->request(hex("1003"), response);
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.errorMessage.contains("No response"));
+}
+
+TEST_F(UdsClientTest, SessionControlAdoptsServerTiming)
+{
+    start([](const QByteArray& request, CANIsoTpChannel& channel) {
+        if (request == hex("1003"))
+            channel.send(hex("5003003201f4"));               // P2 50 ms, P2* 5000 ms
+    });
+
+    UdsClient::Response response;
+    ASSERT_TRUE(m_client->diagnosticSessionControl(0x03, &response).success);
+    EXPECT_EQ(m_client->p2Ms(), 50 + 50);
+    EXPECT_EQ(m_client->p2StarMs(), 5000 + 50);
+}
+
+TEST_F(UdsClientTest, SecurityAccessUsesKeyHook)
+{
+    std::atomic<bool> unlocked{false};
+    start([&](const QByteArray& request, CANIsoTpChannel& channel) {
+        if (request == hex("2701"))
+            channel.send(unlocked ? hex("670100000000") : hex("670111223344"));
+        else if (request == hex("2702eeddccbb")) {
+            unlocked = true;
+            channel.send(hex("6702"));
+        } else {
+            channel.send(hex("7f2735"));
+        }
+    });
+
+    const auto xorKey = [](uint8_t level, const QByteArray& seed) {
+        EXPECT_EQ(level, 0x01);
+        QByteArray key = seed;
+        for (char& byte : key)
+            byte = static_cast<char>(byte ^ 0xFF);
+        return key;
+    };
+    ASSERT_TRUE(m_client->securityAccess(0x01, xorKey).success);
+    EXPECT_TRUE(unlocked.load());
+    EXPECT_EQ(m_ecu->requests(), 2);
+
+    // Zero seed: already unlocked, no key sent
+    ASSERT_TRUE(m_client->securityAccess(0x01, xorKey).success);
+    EXPECT_EQ(m_ecu->requests(), 3);
+
+    // With a seed length, only a zero seed of that length means unlocked
+    ASSERT_TRUE(m_client->securityAccess(0x01, xorKey, 4).success);
+    EXPECT_FALSE(m_client->securityAccess(0x01, xorKey, 2).success);
+    EXPECT_EQ(m_ecu->requests(), 5);
+
+    EXPECT_FALSE(m_client->securityAccess(0x02, xorKey).success);
+    unlocked = false;
+    const CANResult result = m_client->securityAccess(0x01, [](uint8_t, const QByteArray&) { return hex("00"); });
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.errorMessage.contains("invalidKey"));
+}
+
+TEST_F(UdsClientTest, SecurityAccessWithoutSeedFails)
+{
+    start([](const QByteArray& request, CANIsoTpChannel& channel) {
+        if (request == hex("2701"))
+            channel.send(hex("6701"));
+        else if (request == hex("2703"))
+            channel.send(hex("67030000"));
+        else
+            channel.send(hex("6704"));
+    });
+
+    const auto key = [](uint8_t, const QByteArray&) { return hex("aa"); };
+    const CANResult result = m_client->securityAccess(0x01, key);
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.errorMessage.contains("No seed"));
+
+    // A two-byte zero seed where four are expected is not "unlocked"
+    EXPECT_FALSE(m_client->securityAccess(0x03, key, 4).success);
+    EXPECT_EQ(m_ecu->requests(), 2);
+}
+
+TEST_F(UdsClientTest, ReadsDtcsAndWritesDids)
+{
+    start([](const QByteArray& request, CANIsoTpChannel& channel) {
+        if (request == hex("19020c"))
+            channel.send(hex("5902ff" "c1230008" "9a00010c"));
+        else if (request.startsWith(hex("2ef190")))
+            channel.send(hex("6ef190"));
+    });
+
+    QList<UdsClient::Dtc> dtcs;
+    uint8_t availability = 0;
+    ASSERT_TRUE(m_client->readDtcsByStatusMask(0x0C, dtcs, &availability).success);
+    EXPECT_EQ(availability, 0xFF);
+    ASSERT_EQ(dtcs.size(), 2);
+    EXPECT_EQ(dtcs[0].code, 0xC12300u);
+    EXPECT_EQ(dtcs[0].status, 0x08);
+    EXPECT_EQ(dtcs[1].code, 0x9A0001u);
+    EXPECT_EQ(dtcs[1].status, 0x0C);
+
+    EXPECT_TRUE(m_client->writeDataByIdentifier(0xF190, QByteArray(17, 'V')).success);
+}
+
+TEST_F(UdsClientTest, TesterPresentRunsInTheBackgroundWhileIdle)
+{
+    start([](const QByteArray& request, CANIsoTpChannel& channel) {
+        if (request == hex("22f190"))
+            channel.send(hex("62f19041"));
+    });
+
+    QElapsedTimer idleTimer;
+    idleTimer.start();
+    ASSERT_TRUE(m_client->startTesterPresent(50).success);
+    EXPECT_TRUE(m_client->isTesterPresentRunning());
+    QThread::msleep(330);
+    const int idle = m_ecu->testerPresents();
+    EXPECT_GE(idle, 4);
+    EXPECT_LE(idle, idleTimer.elapsed() / 50 + 1);     // Never faster than the period
+
+    // Requests more often than the period make tester present unnecessary:
+    // only a request gap longer than the period (a stalled machine) lets
+    // one through, so fewer go out than the period alone would send
+    const int before = m_ecu->testerPresents();
+    QElapsedTimer busyTimer;
+    busyTimer.start();
+    QMap<uint16_t, QByteArray> values;
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(m_client->readDataByIdentifier({0xF190}, values).success);
+        QThread::msleep(10);
+    }
+    EXPECT_LT(m_ecu->testerPresents() - before, busyTimer.elapsed() / 50);
+
+    m_client->stopTesterPresent();
+    EXPECT_FALSE(m_client->isTesterPresentRunning());
+    const int stopped = m_ecu->testerPresents();
+    QThread::msleep(150);
+    EXPECT_EQ(m_ecu->testerPresents(), stopped);
+}
+
+TEST_F(UdsClientTest, ManagerSharesClientsPerSlotAndIds)
+{
+    auto& mgr = CANBusManager::instance();
+    const UdsClient::Config config = clientConfig();
+
+    auto first = mgr.udsClient(config);
+    ASSERT_TRUE(first);
+    EXPECT_EQ(mgr.udsClient(config), first);
+
+    UdsClient::Config other = config;
+    other.transport.txId = 0x7E1;
+    other.transport.rxId = 0x7E9;
+    EXPECT_NE(mgr.udsClient(other), first);
+
+    UdsClient::Config fd = config;
+    fd.transport.fd = true;
+    auto replaced = mgr.udsClient(fd);
+    ASSERT_TRUE(replaced);
+    EXPECT_NE(replaced, first);
+    EXPECT_FALSE(first->isOpen());
+
+    ASSERT_TRUE(replaced->startTesterPresent(20).success);
+    mgr.closeSlot(TESTER);
+    EXPECT_FALSE(replaced->isOpen());
+    EXPECT_FALSE(replaced->isTesterPresentRunning());
+
+    CANResult result;
+    EXPECT_FALSE(mgr.udsClient(config, &result));
+    EXPECT_FALSE(result.success);
+}
+
+TEST_F(UdsClientTest, ClientsCreatedWhileSlotClosesAreClosedWithIt)
+{
+    auto& mgr = CANBusManager::instance();
+    const UdsClient::Config config = clientConfig();
+    const CANChannelInfo ch = channel(testBusName("t_uds"));
+
+    std::atomic<bool> stop{false};
+    std::atomic<int>  calls{0};
+    std::vector<std::shared_ptr<UdsClient>> clients;
+    std::thread getter([&]() {
+        while (!stop.load()) {
+            if (auto client = mgr.udsClient(config))
+                clients.push_back(std::move(client));
+            calls.fetch_add(1);
+        }
+    });
+
+    for (int i = 0; i < 50; ++i) {
+        // Let the getter run between every close and reopen
+        const int before = calls.load();
+        mgr.closeSlot(TESTER);
+        while (calls.load() == before)
+            std::this_thread::yield();
+        EXPECT_TRUE(mgr.openSlot(TESTER, mgr.virtualDriver(TESTER), ch, CANBusConfig{}).success);
+        const int reopened = calls.load();
+        while (calls.load() == reopened)
+            std::this_thread::yield();
+    }
+    stop = true;
+    getter.join();
+    mgr.closeSlot(TESTER);
+
+    EXPECT_FALSE(clients.empty());
+    for (const auto& client : clients)
+        EXPECT_FALSE(client->isOpen());
+}
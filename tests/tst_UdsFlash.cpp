@@ -0,0 +1,319 @@
+/**
+ * @file tst_UdsFlash.cpp
+ * @brief Unit tests for UDS flash programming — Intel HEX / S-record / raw
+ *        image indexing, streaming decode, and end-to-end downloads into
+ *        the simulated bootloader (block length negotiation, response
+ *        pending, CRC, session checks).
+ */
+
+#include <gtest/gtest.h>
+#include "CANManager.h"
+#include "CANSlotFixture.h"
+#include "UdsBootloaderSimulator.h"
+#include "UdsFlashImage.h"
+#include "UdsFlashProgrammer.h"
+#include "VirtualCANDriver.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+using namespace CANManager;
+
+namespace {
+
+QByteArray pattern(int size, int seed)
+{
+    QByteArray bytes(size, '\0');
+    for (int i = 0; i < size; ++i)
+        bytes[i] = static_cast<char>((i * 7 + seed) & 0xFF);
+    return bytes;
+}
+
+/// One Intel HEX record line
+QByteArray hexRecord(uint8_t type, uint16_t offset, const QByteArray& data)
+{
+    QByteArray record;
+    record.append(static_cast<char>(data.size()));
+    record.append(static_cast<char>(offset >> 8));
+    record.append(static_cast<char>(offset & 0xFF));
+    record.append(static_cast<char>(type));
+    record.append(data);
+    uint8_t sum = 0;
+    for (char byte : record)
+        sum += static_cast<uint8_t>(byte);
+    record.append(static_cast<char>(-sum));
+    return ":" + record.toHex().toUpper() + "\r\n";
+}
+
+/// Intel HEX text for data at address, 32 bytes per record
+QByteArray intelHex(const QMap<uint32_t, QByteArray>& segments)
+{
+    QByteArray text;
+    for (auto it = segments.cbegin(); it != segments.cend(); ++it) {
+        uint32_t upper = 0xFFFFFFFF;
+        for (qsizetype pos = 0; pos < it.value().size(); pos += 32) {
+            const uint32_t address = it.key() + uint32_t(pos);
+            if ((address >> 16) != upper) {
+                upper = address >> 16;
+                QByteArray base;
+                base.append(static_cast<char>(upper >> 8));
+                base.append(static_cast<char>(upper & 0xFF));
+                text.append(hexRecord(0x04, 0, base));
+            }
+            text.append(hexRecord(0x00, address & 0xFFFF, it.value().mid(pos, 32)));
+        }
+    }
+    return text + hexRecord(0x01, 0, {});
+}
+
+QByteArray readAll(const UdsFlashImage& image, int segment, int chunk)
+{
+    UdsFlashImage::Reader reader(image, segment);
+    QByteArray data;
+    QByteArray buffer(chunk, '\0');
+    int n = 0;
+    while ((n = reader.read(reinterpret_cast<uint8_t*>(buffer.data()), chunk)) > 0)
+        data.append(buffer.constData(), n);
+    return data;
+}
+
+} // namespace
+
+class UdsFlashTest : public CANSlotFixture
+{
+protected:
+    static constexpr const char* TESTER = "Flash Tester";
+    static constexpr const char* ECU    = "Flash ECU";
+
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+        ASSERT_NO_FATAL_FAILURE(openSlots("t_flash", {TESTER, ECU}));
+    }
+
+    void TearDown() override
+    {
+        m_client.reset();
+        m_bootloader.reset();
+        CANSlotFixture::TearDown();
+    }
+
+    QString write(const QString& name, const QByteArray& contents)
+    {
+        const QString path = m_dir.filePath(name);
+        QFile file(path);
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(contents);
+        return path;
+    }
+
+    void start(UdsBootloaderSimulator::Config bootloader = {})
+    {
+        bootloader.transport.slotName = ECU;
+        bootloader.transport.txId = 0x7E8;
+        bootloader.transport.rxId = 0x7E0;
+        m_bootloader = std::make_unique<UdsBootloaderSimulator>(bootloader);
+        ASSERT_TRUE(m_bootloader->start().success);
+
+        UdsClient::Config client;
+        client.transport.slotName = TESTER;
+        client.transport.txId = 0x7E0;
+        client.transport.rxId = 0x7E8;
+        client.p2Ms = 200;
+        m_client = std::make_unique<UdsClient>(client);
+        ASSERT_TRUE(m_client->open().success);
+    }
+
+    QTemporaryDir m_dir;
+    std::unique_ptr<UdsBootloaderSimulator> m_bootloader;
+    std::unique_ptr<UdsClient> m_client;
+};
+
+TEST_F(UdsFlashTest, IndexesIntelHexIntoSegments)
+{
+    // Second segment crosses a 64 KiB boundary (extended linear address records)
+    const QMap<uint32_t, QByteArray> segments = {
+        {0x00008000, pattern(1000, 1)},
+        {0x0001FFF0, pattern(100, 2)}
+    };
+    UdsFlashImage image;
+    ASSERT_TRUE(image.open(write("app.hex", intelHex(segments))).success);
+    EXPECT_EQ(image.format(), UdsFlashImage::Format::IntelHex);
+    EXPECT_EQ(image.totalSize(), 1100u);
+    ASSERT_EQ(image.segments().size(), 2u);
+    EXPECT_EQ(image.segments()[0].address, 0x8000u);
+    EXPECT_EQ(image.segments()[0].size, 1000u);
+    EXPECT_EQ(image.segments()[1].address, 0x1FFF0u);
+    EXPECT_EQ(readAll(image, 0, 77), segments.value(0x8000));
+    EXPECT_EQ(readAll(image, 1, 4096), segments.value(0x1FFF0));
+
+    // Records out of address order still form one segment
+    QByteArray shuffled = hexRecord(0x00, 0x0010, pattern(16, 5)) + hexRecord(0x00, 0x0000, pattern(16, 4))
+                          + hexRecord(0x01, 0, {});
+    ASSERT_TRUE(image.open(write("shuffled.hex", shuffled)).success);
+    ASSERT_EQ(image.segments().size(), 1u);
+    EXPECT_EQ(readAll(image, 0, 8), pattern(16, 4) + pattern(16, 5));
+
+    QByteArray corrupt = intelHex(segments);
+    corrupt[corrupt.indexOf("\r\n") + 12] = 'Z';
+    CANResult result = image.open(write("corrupt.hex", corrupt));
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.errorMessage.contains("Line 2"));
+
+    QByteArray badChecksum = hexRecord(0x00, 0, pattern(4, 0));
+    badChecksum[badChecksum.size() - 3] = badChecksum[badChecksum.size() - 3] == '0' ? '1' : '0';
+    result = image.open(write("checksum.hex", badChecksum));
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.errorMessage.contains("Checksum"));
+
+    const QByteArray overlap = hexRecord(0x00, 0, pattern(16, 0)) + hexRecord(0x00, 8, pattern(16, 0));
+    EXPECT_FALSE(image.open(write("overlap.hex", overlap)).success);
+}
+
+TEST_F(UdsFlashTest, IndexesSRecordsAndRawImages)
+{
+    // S0 header, S3 data (32-bit addresses), S7 termination
+    const QByteArray srec =
+        "S00E000068656C6C6F2020202020201D\n"
+        "S30D080000000102030405060708C6\n"
+        "S30D08000008091011121314151654\n"
+        "S70508000000F2\n";
+    UdsFlashImage image;
+    const CANResult result = image.open(write("app.s19", srec));
+    ASSERT_TRUE(result.success) << result.errorMessage.toStdString();
+    EXPECT_EQ(image.format(), UdsFlashImage::Format::SRecord);
+    ASSERT_EQ(image.segments().size(), 1u);
+    EXPECT_EQ(image.segments()[0].address, 0x08000000u);
+    EXPECT_EQ(readAll(image, 0, 5), QByteArray::fromHex("01020304050607080910111213141516"));
+
+    const QByteArray raw = pattern(5000, 9);
+    ASSERT_TRUE(image.open(write("app.bin", raw), UdsFlashImage::Format::Raw, 0x10000).success);
+    ASSERT_EQ(image.segments().size(), 1u);
+    EXPECT_EQ(image.segments()[0].address, 0x10000u);
+    EXPECT_EQ(readAll(image, 0, 1024), raw);
+}
+
+TEST_F(UdsFlashTest, Crc32MatchesReferenceValue)
+{
+    const QByteArray check = "123456789";
+    const auto* data = reinterpret_cast<const uint8_t*>(check.constData());
+    EXPECT_EQ(UdsFlashProgrammer::crc32(0, data, 9), 0xCBF43926u);
+    EXPECT_EQ(UdsFlashProgrammer::crc32(UdsFlashProgrammer::crc32(0, data, 4), data + 4, 5), 0xCBF43926u);
+}
+
+TEST_F(UdsFlashTest, ProgramsImageWithNegotiatedBlockLength)
+{
+    UdsBootloaderSimulator::Config bootloader;
+    bootloader.maxBlockLength = 0x402;                       // 1024 data bytes per block
+    start(bootloader);
+
+    const QMap<uint32_t, QByteArray> segments = {
+        {0x00010000, pattern(20000, 3)},
+        {0x00040000, pattern(3000, 8)}
+    };
+    UdsFlashImage image;
+    ASSERT_TRUE(image.open(write("app.hex", intelHex(segments))).success);
+    ASSERT_TRUE(m_client->diagnosticSessionControl(0x02).success);
+
+    UdsFlashProgrammer::Options options;
+    options.eraseBeforeDownload = true;
+    UdsFlashProgrammer programmer(*m_client, options);
+    UdsFlashProgrammer::Report report;
+    const CANResult result = programmer.program(image, report);
+    ASSERT_TRUE(result.success) << result.errorMessage.toStdString();
+
+    EXPECT_EQ(m_bootloader->memory(), segments);
+    EXPECT_EQ(report.bytes, 23000u);
+    EXPECT_EQ(report.blocks, 20 + 3);
+    ASSERT_EQ(report.segments.size(), 2);
+    EXPECT_EQ(report.segments[0].maxBlockLength, 0x402);
+    EXPECT_EQ(report.segments[0].blocks, 20);
+    const QByteArray first = segments.value(0x10000);
+    EXPECT_EQ(report.segments[0].crc32,
+              UdsFlashProgrammer::crc32(0, reinterpret_cast<const uint8_t*>(first.constData()), first.size()));
+    EXPECT_GT(report.bytesPerSecond, 0.0);
+    EXPECT_LE(report.minBlockMs, report.avgBlockMs);
+    EXPECT_LE(report.avgBlockMs, report.p95BlockMs);
+    EXPECT_LE(report.p95BlockMs, report.maxBlockMs);
+    EXPECT_EQ(m_bootloader->stats().negativeResponses, 0);
+}
+
+TEST_F(UdsFlashTest, ClientLimitAndResponsePending)
+{
+    UdsBootloaderSimulator::Config bootloader;
+    bootloader.busyMs = 250;                                 // Longer than P2
+    start(bootloader);
+
+    const QByteArray raw = pattern(1000, 1);
+    UdsFlashImage image;
+    ASSERT_TRUE(image.open(write("app.bin", raw), UdsFlashImage::Format::Raw, 0x2000).success);
+    ASSERT_TRUE(m_client->diagnosticSessionControl(0x02).success);
+
+    UdsFlashProgrammer::Options options;
+    options.maxBlockLength = 258;                            // 256 data bytes per block
+    options.eraseBeforeDownload = true;
+    UdsFlashProgrammer::Report report;
+    const CANResult result = UdsFlashProgrammer(*m_client, options).program(image, report);
+    ASSERT_TRUE(result.success) << result.errorMessage.toStdString();
+    EXPECT_EQ(report.blocks, 4);
+    EXPECT_EQ(report.segments[0].maxBlockLength, 258);
+    EXPECT_EQ(m_bootloader->memory().value(0x2000), raw);
+    EXPECT_EQ(m_bootloader->stats().pendingResponses, 2);   // Erase and transfer exit
+}
+
+TEST_F(UdsFlashTest, ClampsServerBlockLength)
+{
+    UdsBootloaderSimulator::Config bootloader;
+    bootloader.maxBlockLength = 0xFFFFFFFF;
+    start(bootloader);
+    // 585 frames per block would outlast P2 at 500 kbit/s in real time
+    VirtualCANBus::bus(testBusName("t_flash"))->setTiming(VirtualCANBus::Timing::Simulated);
+
+    const QByteArray raw = pattern(10000, 4);
+    UdsFlashImage image;
+    ASSERT_TRUE(image.open(write("app.bin", raw), UdsFlashImage::Format::Raw, 0x2000).success);
+    ASSERT_TRUE(m_client->diagnosticSessionControl(0x02).success);
+
+    UdsFlashProgrammer::Report report;
+    CANResult result = UdsFlashProgrammer(*m_client).program(image, report);
+    ASSERT_TRUE(result.success) << result.errorMessage.toStdString();
+    ASSERT_EQ(report.segments.size(), 1);
+    EXPECT_EQ(report.segments[0].maxBlockLength, UdsFlashProgrammer::DEFAULT_MAX_BLOCK_LENGTH);
+    EXPECT_EQ(report.blocks, 3);                             // 4093 + 4093 + 1814 bytes
+    EXPECT_EQ(m_bootloader->memory().value(0x2000), raw);
+
+    // A limit that leaves no room for data is rejected before any transfer
+    UdsFlashProgrammer::Options options;
+    options.maxBlockLength = 2;
+    result = UdsFlashProgrammer(*m_client, options).program(image, report);
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.errorMessage.contains("no room for data"));
+    EXPECT_EQ(report.bytes, 0u);
+}
+
+TEST_F(UdsFlashTest, ReportsBootloaderRejections)
+{
+    UdsBootloaderSimulator::Config bootloader;
+    bootloader.memoryStart = 0x1000;
+    bootloader.memorySize = 0x1000;
+    start(bootloader);
+
+    UdsFlashImage image;
+    ASSERT_TRUE(image.open(write("app.bin", pattern(256, 0)), UdsFlashImage::Format::Raw, 0x1000).success);
+    UdsFlashProgrammer programmer(*m_client);
+    UdsFlashProgrammer::Report report;
+
+    // Default session
+    CANResult result = programmer.program(image, report);
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.errorMessage.contains("RequestDownload"));
+    EXPECT_TRUE(result.errorMessage.contains("serviceNotSupportedInActiveSession"));
+
+    ASSERT_TRUE(m_client->diagnosticSessionControl(0x02).success);
+    ASSERT_TRUE(image.open(write("high.bin", pattern(256, 0)), UdsFlashImage::Format::Raw, 0x1F80).success);
+    result = programmer.program(image, report);
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.errorMessage.contains("requestOutOfRange"));
+    EXPECT_EQ(report.bytes, 0u);
+    EXPECT_TRUE(m_bootloader->memory().isEmpty());
+}
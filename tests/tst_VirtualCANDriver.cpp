@@ -0,0 +1,615 @@
+/**
+ * @file tst_VirtualCANDriver.cpp
+ * @brief Unit tests for VirtualCANDriver / VirtualCANBus — delivery,
+ *        arbitration, frame timing, TX confirmation, error injection,
+ *        acceptance filters and CANBusManager slot integration
+ *        (request/response).
+ *
+ * Every test uses its own bus name so bus state never leaks between tests.
+ */
+
+#include <gtest/gtest.h>
+#include "VirtualCANDriver.h"
+#include "CANManager.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <atomic>
+#include <vector>
+
+using namespace CANManager;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static CANChannelInfo busChannel(const char* name)
+{
+    CANChannelInfo ch;
+    ch.name = QString::fromLatin1(name);
+    return ch;
+}
+
+static CANMessage makeFrame(uint32_t id, int len = 8, bool extended = false)
+{
+    CANMessage msg;
+    msg.id = id;
+    msg.dlc = static_cast<uint8_t>(len);
+    msg.isExtended = extended;
+    for (int i = 0; i < len; ++i)
+        msg.data[i] = static_cast<uint8_t>(i + 1);
+    return msg;
+}
+
+// ============================================================================
+// Delivery
+// ============================================================================
+
+TEST(VirtualCANDriver, FrameReachesOtherNodesButNotSender)
+{
+    VirtualCANDriver a, b, c;
+    CANBusConfig cfg;
+    ASSERT_TRUE(a.openChannel(busChannel("t_delivery"), cfg).success);
+    ASSERT_TRUE(b.openChannel(busChannel("t_delivery"), cfg).success);
+    ASSERT_TRUE(c.openChannel(busChannel("t_delivery"), cfg).success);
+
+    ASSERT_TRUE(a.transmit(makeFrame(0x123)).success);
+
+    CANMessage rx;
+    ASSERT_TRUE(b.receive(rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x123u);
+    EXPECT_EQ(rx.dlc, 8);
+    EXPECT_EQ(rx.data[7], 8);
+    EXPECT_FALSE(rx.isTxConfirm);
+
+    ASSERT_TRUE(c.receive(rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x123u);
+
+    EXPECT_FALSE(a.receive(rx, 50).success);
+}
+
+TEST(VirtualCANDriver, TxConfirmationEchoesToSender)
+{
+    VirtualCANDriver a, b;
+    CANBusConfig cfg;
+    a.setTxConfirmations(true);
+    ASSERT_TRUE(a.openChannel(busChannel("t_txconfirm"), cfg).success);
+    ASSERT_TRUE(b.openChannel(busChannel("t_txconfirm"), cfg).success);
+
+    ASSERT_TRUE(a.transmit(makeFrame(0x456)).success);
+
+    CANMessage echo;
+    ASSERT_TRUE(a.receive(echo, 1000).success);
+    EXPECT_EQ(echo.id, 0x456u);
+    EXPECT_TRUE(echo.isTxConfirm);
+
+    CANMessage rx;
+    ASSERT_TRUE(b.receive(rx, 1000).success);
+    EXPECT_FALSE(rx.isTxConfirm);
+    EXPECT_EQ(rx.timestamp, echo.timestamp);
+}
+
+TEST(VirtualCANDriver, ClosedChannelRejectsIO)
+{
+    VirtualCANDriver a;
+    CANMessage msg;
+    EXPECT_FALSE(a.transmit(makeFrame(0x1)).success);
+    EXPECT_FALSE(a.receive(msg, 0).success);
+    EXPECT_FALSE(a.isOpen());
+}
+
+TEST(VirtualCANDriver, BitrateMismatchIsRejected)
+{
+    VirtualCANDriver a, b;
+    CANBusConfig cfg500;
+    CANBusConfig cfg250;
+    cfg250.bitrate = 250000;
+
+    ASSERT_TRUE(a.openChannel(busChannel("t_mismatch"), cfg500).success);
+    EXPECT_FALSE(b.openChannel(busChannel("t_mismatch"), cfg250).success);
+}
+
+TEST(VirtualCANDriver, FDFrameRequiresFDChannel)
+{
+    VirtualCANDriver a;
+    CANBusConfig cfg;
+    ASSERT_TRUE(a.openChannel(busChannel("t_fdcheck"), cfg).success);
+
+    CANMessage fd = makeFrame(0x10, 8);
+    fd.isFD = true;
+    EXPECT_FALSE(a.transmit(fd).success);
+}
+
+TEST(VirtualCANDriver, LastChannelReleasesBusAndStopsThread)
+{
+    auto bus = VirtualCANBus::bus("t_release");
+    bus->setTiming(VirtualCANBus::Timing::Simulated);
+    EXPECT_FALSE(bus->isRunning());
+
+    VirtualCANDriver a, b;
+    CANBusConfig cfg;
+    ASSERT_TRUE(a.openChannel(busChannel("t_release"), cfg).success);
+    ASSERT_TRUE(b.openChannel(busChannel("t_release"), cfg).success);
+    EXPECT_EQ(a.bus(), bus);
+    EXPECT_TRUE(bus->isRunning());
+
+    a.closeChannel();
+    EXPECT_TRUE(bus->isRunning());
+    EXPECT_TRUE(VirtualCANBus::busNames().contains("t_release"));
+
+    b.closeChannel();
+    EXPECT_FALSE(bus->isRunning());
+    EXPECT_EQ(bus->nodeCount(), 0);
+    EXPECT_FALSE(VirtualCANBus::busNames().contains("t_release"));
+
+    // Reopening starts a fresh bus with default settings
+    ASSERT_TRUE(a.openChannel(busChannel("t_release"), cfg).success);
+    EXPECT_NE(a.bus(), bus);
+    EXPECT_EQ(a.bus()->timing(), VirtualCANBus::Timing::RealTime);
+    EXPECT_TRUE(a.bus()->isRunning());
+
+    // A failed open does not keep the bus alive
+    CANBusConfig cfg250;
+    cfg250.bitrate = 250000;
+    EXPECT_FALSE(b.openChannel(busChannel("t_release"), cfg250).success);
+    a.closeChannel();
+    EXPECT_FALSE(VirtualCANBus::busNames().contains("t_release"));
+}
+
+// ============================================================================
+// Batch I/O
+// ============================================================================
+
+TEST(VirtualCANDriver, BatchTransmitAndReceivePreserveOrder)
+{
+    VirtualCANDriver tx, rx;
+    CANBusConfig cfg;
+    VirtualCANBus::bus("t_batch")->setTiming(VirtualCANBus::Timing::Simulated);
+    ASSERT_TRUE(tx.openChannel(busChannel("t_batch"), cfg).success);
+    ASSERT_TRUE(rx.openChannel(busChannel("t_batch"), cfg).success);
+
+    // Same ID for all frames so arbitration keeps submission order
+    std::vector<CANMessage> frames(200, makeFrame(0x321));
+    for (int i = 0; i < 200; ++i)
+        frames[i].data[0] = static_cast<uint8_t>(i);
+
+    int sent = 0;
+    ASSERT_TRUE(tx.transmitBatch(frames, sent).success);
+    EXPECT_EQ(sent, 200);
+
+    std::vector<CANMessage> received;
+    CANMessage buffer[64];
+    while (received.size() < 200) {
+        int n = 0;
+        ASSERT_TRUE(rx.receiveBatch(buffer, n, 1000).success);
+        ASSERT_GT(n, 0);
+        EXPECT_LE(n, 64);
+        received.insert(received.end(), buffer, buffer + n);
+    }
+    for (int i = 0; i < 200; ++i)
+        EXPECT_EQ(received[i].data[0], static_cast<uint8_t>(i));
+
+    int n = 0;
+    EXPECT_FALSE(rx.receiveBatch(buffer, n, 0).success);
+    EXPECT_EQ(n, 0);
+}
+
+TEST(VirtualCANDriver, BatchTransmitReportsPartialSendWhenQueueFull)
+{
+    VirtualCANDriver tx, rx;
+    CANBusConfig cfg;
+    auto bus = VirtualCANBus::bus("t_batch_full");
+    ASSERT_TRUE(tx.openChannel(busChannel("t_batch_full"), cfg).success);
+    ASSERT_TRUE(rx.openChannel(busChannel("t_batch_full"), cfg).success);
+
+    bus->pause();
+    std::vector<CANMessage> frames(VirtualCANBus::TX_QUEUE_CAPACITY + 10, makeFrame(0x10));
+    int sent = 0;
+    EXPECT_FALSE(tx.transmitBatch(frames, sent).success);
+    EXPECT_EQ(sent, VirtualCANBus::TX_QUEUE_CAPACITY);
+    bus->resume();
+}
+
+// ============================================================================
+// Arbitration and timing (simulated clock → deterministic)
+// ============================================================================
+
+TEST(VirtualCANBus, LowestIdWinsArbitration)
+{
+    auto bus = VirtualCANBus::bus("t_arbitration");
+    bus->setTiming(VirtualCANBus::Timing::Simulated);
+
+    VirtualCANDriver n1, n2, n3, listener;
+    CANBusConfig cfg;
+    ASSERT_TRUE(n1.openChannel(busChannel("t_arbitration"), cfg).success);
+    ASSERT_TRUE(n2.openChannel(busChannel("t_arbitration"), cfg).success);
+    ASSERT_TRUE(n3.openChannel(busChannel("t_arbitration"), cfg).success);
+    ASSERT_TRUE(listener.openChannel(busChannel("t_arbitration"), cfg).success);
+
+    bus->pause();
+    ASSERT_TRUE(n1.transmit(makeFrame(0x300)).success);
+    ASSERT_TRUE(n2.transmit(makeFrame(0x100)).success);
+    ASSERT_TRUE(n3.transmit(makeFrame(0x100, 8, true)).success);    // extended: base ID 0
+    bus->resume();
+
+    CANMessage rx;
+    ASSERT_TRUE(listener.receive(rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x100u);
+    EXPECT_TRUE(rx.isExtended);
+    ASSERT_TRUE(listener.receive(rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x100u);
+    EXPECT_FALSE(rx.isExtended);
+    ASSERT_TRUE(listener.receive(rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x300u);
+}
+
+TEST(VirtualCANBus, StandardBeatsExtendedWithSameBaseId)
+{
+    auto bus = VirtualCANBus::bus("t_std_vs_ext");
+    bus->setTiming(VirtualCANBus::Timing::Simulated);
+
+    VirtualCANDriver n1, n2, listener;
+    CANBusConfig cfg;
+    ASSERT_TRUE(n1.openChannel(busChannel("t_std_vs_ext"), cfg).success);
+    ASSERT_TRUE(n2.openChannel(busChannel("t_std_vs_ext"), cfg).success);
+    ASSERT_TRUE(listener.openChannel(busChannel("t_std_vs_ext"), cfg).success);
+
+    bus->pause();
+    ASSERT_TRUE(n1.transmit(makeFrame(0x123u << 18, 8, true)).success);
+    ASSERT_TRUE(n2.transmit(makeFrame(0x123)).success);
+    bus->resume();
+
+    CANMessage rx;
+    ASSERT_TRUE(listener.receive(rx, 1000).success);
+    EXPECT_FALSE(rx.isExtended);
+    ASSERT_TRUE(listener.receive(rx, 1000).success);
+    EXPECT_TRUE(rx.isExtended);
+}
+
+TEST(VirtualCANBus, FrameDurationFollowsBitrate)
+{
+    // Standard ID, 8 data bytes: 98 stuffable bits + 24 stuff bits + 13 trailer = 135 bits
+    CANMessage classic = makeFrame(0x100, 8);
+    EXPECT_EQ(VirtualCANBus::frameDurationNs(classic, 500000, 500000), 270000u);
+    EXPECT_EQ(VirtualCANBus::frameDurationNs(classic, 1000000, 1000000), 135000u);
+
+    CANMessage fd = makeFrame(0x100, 0);
+    fd.isFD = true;
+    fd.dlc = 15;    // 64 bytes
+    const uint64_t noBrs = VirtualCANBus::frameDurationNs(fd, 500000, 2000000);
+    fd.isBRS = true;
+    const uint64_t brs = VirtualCANBus::frameDurationNs(fd, 500000, 2000000);
+    EXPECT_LT(brs, noBrs);
+    EXPECT_GT(brs, 0u);
+}
+
+TEST(VirtualCANBus, SimulatedTimestampsAreDeterministic)
+{
+    auto bus = VirtualCANBus::bus("t_timestamps");
+    bus->setTiming(VirtualCANBus::Timing::Simulated);
+
+    VirtualCANDriver a, b;
+    CANBusConfig cfg;
+    ASSERT_TRUE(a.openChannel(busChannel("t_timestamps"), cfg).success);
+    ASSERT_TRUE(b.openChannel(busChannel("t_timestamps"), cfg).success);
+
+    const uint64_t t0 = bus->busTimeNs();
+    ASSERT_TRUE(a.transmit(makeFrame(0x100)).success);
+    ASSERT_TRUE(a.transmit(makeFrame(0x101)).success);
+
+    CANMessage rx1, rx2;
+    ASSERT_TRUE(b.receive(rx1, 1000).success);
+    ASSERT_TRUE(b.receive(rx2, 1000).success);
+    EXPECT_EQ(rx1.timestamp, t0 + 270000u);
+    EXPECT_EQ(rx2.timestamp, t0 + 540000u);
+}
+
+// ============================================================================
+// Error injection
+// ============================================================================
+
+TEST(VirtualCANBus, InjectedErrorProducesErrorFrameAndRetransmission)
+{
+    auto bus = VirtualCANBus::bus("t_errors");
+    bus->setTiming(VirtualCANBus::Timing::Simulated);
+
+    VirtualCANDriver a, b;
+    CANBusConfig cfg;
+    ASSERT_TRUE(a.openChannel(busChannel("t_errors"), cfg).success);
+    ASSERT_TRUE(b.openChannel(busChannel("t_errors"), cfg).success);
+
+    bus->injectErrors(1);
+    ASSERT_TRUE(a.transmit(makeFrame(0x222)).success);
+
+    CANMessage rx;
+    ASSERT_TRUE(b.receive(rx, 1000).success);
+    EXPECT_TRUE(rx.isError);
+    ASSERT_TRUE(b.receive(rx, 1000).success);
+    EXPECT_FALSE(rx.isError);
+    EXPECT_EQ(rx.id, 0x222u);
+    EXPECT_EQ(bus->errorFrames(), 1u);
+}
+
+TEST(VirtualCANBus, PersistentErrorsDriveTransmitterBusOff)
+{
+    auto bus = VirtualCANBus::bus("t_busoff");
+    bus->setTiming(VirtualCANBus::Timing::Simulated);
+    bus->setErrorRate(1.0);
+
+    VirtualCANDriver a, b;
+    CANBusConfig cfg;
+    ASSERT_TRUE(a.openChannel(busChannel("t_busoff"), cfg).success);
+    ASSERT_TRUE(b.openChannel(busChannel("t_busoff"), cfg).success);
+
+    ASSERT_TRUE(a.transmit(makeFrame(0x333)).success);
+
+    // 32 error frames take the TX error counter from 0 to 256
+    CANMessage rx;
+    int errors = 0;
+    while (b.receive(rx, 200).success && rx.isError)
+        ++errors;
+    EXPECT_EQ(errors, 32);
+    EXPECT_FALSE(a.transmit(makeFrame(0x333)).success);
+
+    bus->setErrorRate(0.0);
+}
+
+// ============================================================================
+// Acceptance filters
+// ============================================================================
+
+TEST(VirtualCANDriver, AcceptanceFiltersDropFramesBeforeQueueing)
+{
+    auto bus = VirtualCANBus::bus("t_filter");
+    bus->setTiming(VirtualCANBus::Timing::Simulated);
+
+    VirtualCANDriver a, b, c;
+    CANBusConfig cfg;
+    ASSERT_TRUE(a.openChannel(busChannel("t_filter"), cfg).success);
+    ASSERT_TRUE(b.openChannel(busChannel("t_filter"), cfg).success);
+    ASSERT_TRUE(c.openChannel(busChannel("t_filter"), cfg).success);
+    ASSERT_TRUE(b.setAcceptanceFilters({CANIdFilter::exact(0x100), CANIdFilter::masked(0x700, 0x700)}).success);
+
+    std::vector<CANMessage> frames;
+    for (uint32_t id : {0x100u, 0x200u, 0x7E8u, 0x101u, 0x700u})
+        frames.push_back(makeFrame(id));
+    for (int i = 0; i < 300; ++i)
+        frames.push_back(makeFrame(0x300));     // More than the filtered node would ever see
+    int sent = 0;
+    ASSERT_TRUE(a.transmitBatch(frames, sent).success);
+
+    // The unfiltered node sees everything, the filtered one only its IDs
+    CANMessage rx;
+    for (int i = 0; i < static_cast<int>(frames.size()); ++i)
+        ASSERT_TRUE(c.receive(rx, 1000).success);
+    std::vector<uint32_t> ids;
+    while (b.receive(rx, 50).success)
+        ids.push_back(rx.id);
+    EXPECT_EQ(ids, std::vector<uint32_t>({0x100u, 0x7E8u, 0x700u}));
+    EXPECT_EQ(b.rxOverruns(), 0u);
+
+    // An empty list accepts everything again
+    ASSERT_TRUE(b.setAcceptanceFilters({}).success);
+    ASSERT_TRUE(a.transmit(makeFrame(0x200)).success);
+    ASSERT_TRUE(b.receive(rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x200u);
+}
+
+TEST(VirtualCANDriver, AcceptanceFiltersKeepErrorFramesAndCheckFormat)
+{
+    auto bus = VirtualCANBus::bus("t_filter_format");
+    bus->setTiming(VirtualCANBus::Timing::Simulated);
+
+    VirtualCANDriver a, b;
+    CANBusConfig cfg;
+    a.setTxConfirmations(true);
+    ASSERT_TRUE(a.openChannel(busChannel("t_filter_format"), cfg).success);
+    ASSERT_TRUE(b.openChannel(busChannel("t_filter_format"), cfg).success);
+    ASSERT_TRUE(a.setAcceptanceFilters({CANIdFilter::exact(0x18DAF110, true)}).success);
+    ASSERT_TRUE(b.setAcceptanceFilters({CANIdFilter::exact(0x18DAF110, true)}).success);
+
+    bus->injectErrors(1);
+    ASSERT_TRUE(a.transmit(makeFrame(0x110)).success);                 // Standard ID, filtered out
+    ASSERT_TRUE(a.transmit(makeFrame(0x18DAF110, 8, true)).success);
+
+    CANMessage rx;
+    ASSERT_TRUE(b.receive(rx, 1000).success);
+    EXPECT_TRUE(rx.isError);
+    ASSERT_TRUE(b.receive(rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x18DAF110u);
+    EXPECT_TRUE(rx.isExtended);
+    EXPECT_FALSE(b.receive(rx, 50).success);
+
+    // TX confirmations are filtered like received frames
+    ASSERT_TRUE(a.receive(rx, 1000).success);
+    EXPECT_TRUE(rx.isError);
+    ASSERT_TRUE(a.receive(rx, 1000).success);
+    EXPECT_TRUE(rx.isTxConfirm);
+    EXPECT_EQ(rx.id, 0x18DAF110u);
+    EXPECT_FALSE(a.receive(rx, 50).success);
+}
+
+TEST(VirtualCANDriver, AcceptanceFiltersRequireOpenChannel)
+{
+    VirtualCANDriver a;
+    EXPECT_FALSE(a.setAcceptanceFilters({CANIdFilter::exact(0x100)}).success);
+
+    // Reopening starts with everything accepted
+    CANBusConfig cfg;
+    VirtualCANDriver b;
+    ASSERT_TRUE(a.openChannel(busChannel("t_filter_reopen"), cfg).success);
+    ASSERT_TRUE(b.openChannel(busChannel("t_filter_reopen"), cfg).success);
+    ASSERT_TRUE(b.setAcceptanceFilters({CANIdFilter::exact(0x100)}).success);
+    b.closeChannel();
+    ASSERT_TRUE(b.openChannel(busChannel("t_filter_reopen"), cfg).success);
+
+    ASSERT_TRUE(a.transmit(makeFrame(0x200)).success);
+    CANMessage rx;
+    ASSERT_TRUE(b.receive(rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x200u);
+}
+
+// ============================================================================
+// CANBusManager integration
+// ============================================================================
+
+TEST(VirtualCANDriver, ManagerSlotsShareVirtualBus)
+{
+    auto& mgr = CANBusManager::instance();
+    CANBusConfig cfg;
+
+    ASSERT_TRUE(mgr.openSlot("VT 1", mgr.virtualDriver("VT 1"), busChannel("t_manager"), cfg).success);
+    ASSERT_TRUE(mgr.openSlot("VT 2", mgr.virtualDriver("VT 2"), busChannel("t_manager"), cfg).success);
+    EXPECT_NE(mgr.virtualDriver("VT 1"), mgr.virtualDriver("VT 2"));
+
+    ASSERT_TRUE(mgr.transmit("VT 1", makeFrame(0x7E0)).success);
+
+    CANMessage rx;
+    ASSERT_TRUE(mgr.receive("VT 2", rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x7E0u);
+
+    mgr.closeSlot("VT 1");
+    mgr.closeSlot("VT 2");
+}
+
+#ifdef __linux__
+TEST(VirtualCANDriver, ManagerGivesEachSlotItsOwnHardwareDriver)
+{
+    auto& mgr = CANBusManager::instance();
+
+    SocketCANDriver* first = mgr.socketCanDriver("HW 1");
+    EXPECT_EQ(mgr.socketCanDriver("HW 1"), first);
+    EXPECT_NE(mgr.socketCanDriver("HW 2"), first);
+    EXPECT_NE(mgr.socketCanDriver(), first);
+}
+#endif
+
+TEST(VirtualCANDriver, BlockingReceiveDoesNotStallOtherSlots)
+{
+    auto& mgr = CANBusManager::instance();
+    CANBusConfig cfg;
+
+    ASSERT_TRUE(mgr.openSlot("VS 1", mgr.virtualDriver("VS 1"), busChannel("t_shard_a"), cfg).success);
+    ASSERT_TRUE(mgr.openSlot("VS 2", mgr.virtualDriver("VS 2"), busChannel("t_shard_b"), cfg).success);
+    ASSERT_TRUE(mgr.openSlot("VS 3", mgr.virtualDriver("VS 3"), busChannel("t_shard_b"), cfg).success);
+
+    // Park a long receive on the otherwise silent "VS 1"
+    std::atomic<bool> receiveReturned{false};
+    QThread* blocker = QThread::create([&]() {
+        CANMessage rx;
+        mgr.receive("VS 1", rx, 5000);
+        receiveReturned = true;
+    });
+    blocker->start();
+    QThread::msleep(50);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Same slot TX, other slot TX/RX and UI-style queries all proceed
+    EXPECT_TRUE(mgr.transmit("VS 1", makeFrame(0x10)).success);
+    EXPECT_TRUE(mgr.transmit("VS 2", makeFrame(0x20)).success);
+    CANMessage rx;
+    EXPECT_TRUE(mgr.receive("VS 3", rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x20u);
+    EXPECT_TRUE(mgr.isSlotOpen("VS 1"));
+    EXPECT_LT(timer.elapsed(), 1000);
+    EXPECT_FALSE(receiveReturned.load());
+
+    // Closing the slot releases the blocked receive long before its timeout
+    mgr.closeSlot("VS 1");
+    blocker->wait();
+    delete blocker;
+    EXPECT_TRUE(receiveReturned.load());
+    EXPECT_LT(timer.elapsed(), 2000);
+    EXPECT_FALSE(mgr.isSlotOpen("VS 1"));
+
+    mgr.closeSlot("VS 2");
+    mgr.closeSlot("VS 3");
+}
+
+TEST(VirtualCANDriver, RequestCatchesImmediateResponseAndKeepsOtherFrames)
+{
+    auto& mgr = CANBusManager::instance();
+    CANBusConfig cfg;
+
+    // ECU node answers every 0x7E0 with an unrelated frame followed by 0x7E8
+    VirtualCANDriver ecu;
+    ASSERT_TRUE(ecu.openChannel(busChannel("t_request"), cfg).success);
+    std::atomic<bool> stop{false};
+    QThread* responder = QThread::create([&]() {
+        CANMessage rx;
+        while (!stop) {
+            if (ecu.receive(rx, 20).success && rx.id == 0x7E0) {
+                ecu.transmit(makeFrame(0x100));
+                ecu.transmit(makeFrame(0x7E8));
+            }
+        }
+    });
+    responder->start();
+
+    ASSERT_TRUE(mgr.openSlot("VR 1", mgr.virtualDriver("VR 1"), busChannel("t_request"), cfg).success);
+
+    for (int i = 0; i < 20; ++i) {
+        CANMessage rx;
+        auto result = mgr.request("VR 1", makeFrame(0x7E0), CANIdFilter::exact(0x7E8), 1000, rx);
+        ASSERT_TRUE(result.success) << result.errorMessage.toStdString();
+        EXPECT_EQ(rx.id, 0x7E8u);
+    }
+
+    // Neither the response nor the unrelated frame was consumed by request()
+    CANMessage rx;
+    ASSERT_TRUE(mgr.receive("VR 1", rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x100u);
+    ASSERT_TRUE(mgr.receive("VR 1", rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x7E8u);
+
+    stop = true;
+    responder->wait();
+    delete responder;
+    mgr.closeSlot("VR 1");
+}
+
+TEST(VirtualCANDriver, RequestTimesOutWithoutMatchingResponse)
+{
+    auto& mgr = CANBusManager::instance();
+    CANBusConfig cfg;
+
+    ASSERT_TRUE(mgr.openSlot("VR 2", mgr.virtualDriver("VR 2"), busChannel("t_request_timeout"), cfg).success);
+    ASSERT_TRUE(mgr.openSlot("VR 3", mgr.virtualDriver("VR 3"), busChannel("t_request_timeout"), cfg).success);
+
+    CANMessage rx;
+    auto result = mgr.request("VR 2", makeFrame(0x7E0), CANIdFilter::exact(0x7E8), 100, rx);
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.errorMessage.contains("0x7e8"));
+
+    // The request itself went out
+    ASSERT_TRUE(mgr.receive("VR 3", rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x7E0u);
+
+    mgr.closeSlot("VR 2");
+    mgr.closeSlot("VR 3");
+}
+
+TEST(VirtualCANDriver, ManagerAcceptanceFiltersApplyToSlot)
+{
+    auto& mgr = CANBusManager::instance();
+    CANBusConfig cfg;
+
+    EXPECT_FALSE(mgr.setAcceptanceFilters("VF 1", {CANIdFilter::exact(0x7E8)}).success);
+
+    ASSERT_TRUE(mgr.openSlot("VF 1", mgr.virtualDriver("VF 1"), busChannel("t_manager_filter"), cfg).success);
+    ASSERT_TRUE(mgr.openSlot("VF 2", mgr.virtualDriver("VF 2"), busChannel("t_manager_filter"), cfg).success);
+    ASSERT_TRUE(mgr.setAcceptanceFilters("VF 1", {CANIdFilter::exact(0x7E8)}).success);
+
+    ASSERT_TRUE(mgr.transmit("VF 2", makeFrame(0x100)).success);
+    ASSERT_TRUE(mgr.transmit("VF 2", makeFrame(0x7E8)).success);
+
+    CANMessage rx;
+    ASSERT_TRUE(mgr.receive("VF 1", rx, 1000).success);
+    EXPECT_EQ(rx.id, 0x7E8u);
+    EXPECT_FALSE(mgr.receive("VF 1", rx, 50).success);
+
+    mgr.closeSlot("VF 1");
+    mgr.closeSlot("VF 2");
+}